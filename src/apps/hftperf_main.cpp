@@ -15,7 +15,6 @@
 #include <random>
 #include <iomanip>
 #include <cstring>
-#include <mutex>
 #include <cstdlib>
 #ifdef __linux__
 #include <unistd.h>
@@ -25,11 +24,19 @@
 #include "matching/matching_engine.hpp"
 #include "matching/order_book.hpp"
 #include "core/timing.hpp"
+#include "core/tsc_clock.hpp"
 #include "core/cpu_affinity.hpp"
+#include "core/cpu_topology.hpp"
 #include "core/lockfree_queue.hpp"
+#include "core/perf_counters.hpp"
+#include "core/pipeline.hpp"
+#include "core/load_generator.hpp"
 #include "core/timestamp_buffer.hpp"
+#include "core/async_binary_log.hpp"
 #include "strategy/user_strategy.hpp"
+#include "marketdata/market_data_capture.hpp"
 #include "exchange/exchange_simulator.hpp"
+#include "risk/pre_trade_risk.hpp"
 
 // Simple JSON parser for config
 namespace {
@@ -42,8 +49,17 @@ struct Config {
     std::string message_pattern = "uniform";
     std::string strategy = "pass_through";
     std::vector<int> affinity;
+    bool auto_affinity = false;     // "affinity": "auto" - place threads from the CPU topology
     bool use_polling = false;
     std::string log_file = "results.csv";
+    bool log_csv = true;            // Convert the binary log to log_file after the run
+    int log_cpu = -1;               // Log writer core (-1 = first core not in affinity)
+    std::string percentiles_file;   // .hgrm percentile export ("" = off)
+    
+    // Capture / replay
+    std::string capture_file;       // Record ticks and orders of this run ("" = off)
+    std::string replay_file;        // Drive the run from a capture instead of the generator
+    double replay_speed = 1.0;      // 1 = recorded pacing, N = N× faster, 0 = as fast as possible
     
     // Advanced options
     // Gap recovery simulation: pause for gap_pause_ms then burst gap_burst_count messages
@@ -61,6 +77,7 @@ struct Config {
     // Profiling
     bool enable_flame_graph = false;  // Enable perf recording for flame graph
     int flame_graph_duration_sec = 0; // Duration to record (0 = full test)
+    bool perf_counters = false;     // Hardware counters per order (rdpmc)
     
     // Jitter injection for realistic simulation
     int jitter_min_ns = 0;          // Minimum added latency
@@ -103,8 +120,15 @@ Config parse_config(const std::string& filename) {
         else if (key == "message_pattern") cfg.message_pattern = value;
         else if (key == "strategy") cfg.strategy = value;
         else if (key == "log_file") cfg.log_file = value;
+        else if (key == "log_csv") cfg.log_csv = (value == "true");
+        else if (key == "log_cpu") cfg.log_cpu = std::stoi(value);
+        else if (key == "percentiles_file") cfg.percentiles_file = value;
+        else if (key == "capture_file") cfg.capture_file = value;
+        else if (key == "replay_file") cfg.replay_file = value;
+        else if (key == "replay_speed") cfg.replay_speed = std::stod(value);
         else if (key == "use_polling") cfg.use_polling = (value == "true");
         else if (key == "affinity") {
+            cfg.auto_affinity = (value == "auto");
             // Parse array like [0, 1, 2]
             size_t start = value.find('[');
             size_t end = value.find(']');
@@ -129,6 +153,7 @@ Config parse_config(const std::string& filename) {
         else if (key == "symbol_prefix") cfg.symbol_prefix = value;
         else if (key == "enable_flame_graph") cfg.enable_flame_graph = (value == "true");
         else if (key == "flame_graph_duration_sec") cfg.flame_graph_duration_sec = std::stoi(value);
+        else if (key == "perf_counters") cfg.perf_counters = (value == "true");
         else if (key == "jitter_min_ns") cfg.jitter_min_ns = std::stoi(value);
         else if (key == "jitter_max_ns") cfg.jitter_max_ns = std::stoi(value);
         else if (key == "warmup_sec") cfg.warmup_sec = std::stoi(value);
@@ -138,6 +163,182 @@ Config parse_config(const std::string& filename) {
     return cfg;
 }
 
+/**
+ * @brief One results row, logged from the measured loop (32 bytes)
+ *
+ * Written in binary by a background writer; convert_results() renders the
+ * CSV after the run.
+ */
+struct ResultRecord {
+    int64_t timestamp;          // Order/tick start, ns
+    uint64_t id;                // Order ID or tick sequence
+    hft::Price price;
+    uint32_t latency_ns;        // Saturates at ~4.3 s
+    uint16_t quantity;          // Saturates at 65535
+    uint8_t kind;               // ResultKind
+    uint8_t symbol;             // Index into the log's symbol table
+};
+static_assert(sizeof(ResultRecord) == 32, "Results log record layout changed");
+
+enum ResultKind : uint8_t { RESULT_BUY, RESULT_SELL, RESULT_TICK };
+
+using ResultLog = hft::AsyncBinaryLog<ResultRecord>;
+
+ResultRecord make_result(int64_t timestamp, uint64_t id, int64_t latency, ResultKind kind,
+                         hft::Price price, hft::Quantity quantity, std::size_t symbol) noexcept {
+    ResultRecord record;
+    record.timestamp = timestamp;
+    record.id = id;
+    record.price = price;
+    record.latency_ns = static_cast<uint32_t>(std::clamp<int64_t>(latency, 0, UINT32_MAX));
+    record.quantity = static_cast<uint16_t>(std::clamp<hft::Quantity>(quantity, 0, UINT16_MAX));
+    record.kind = kind;
+    record.symbol = static_cast<uint8_t>(std::min<std::size_t>(symbol, UINT8_MAX));
+    return record;
+}
+
+// results.csv -> results.bin
+std::string binary_log_path(const std::string& csv_path) {
+    const std::string ext = ".csv";
+    if (csv_path.size() > ext.size() && csv_path.compare(csv_path.size() - ext.size(), ext.size(), ext) == 0) {
+        return csv_path.substr(0, csv_path.size() - ext.size()) + ".bin";
+    }
+    return csv_path + ".bin";
+}
+
+/**
+ * @brief Offline converter: binary results log to CSV
+ */
+bool convert_results(const std::string& bin_path, const std::string& csv_path) {
+    std::ofstream csv(csv_path);
+    if (!csv.is_open()) {
+        std::cerr << "Error: Cannot open " << csv_path << "\n";
+        return false;
+    }
+    csv << "timestamp_ns,order_id,latency_ns,side,price,quantity,symbol\n";
+    
+    // The metadata is the symbol table records index into
+    std::string metadata;
+    const bool ok = ResultLog::for_each_record(bin_path, metadata, [&](const ResultRecord& r) {
+        static constexpr const char* KINDS[] = {"BUY", "SELL", "TICK"};
+        hft::Symbol symbol{};
+        if ((r.symbol + 1u) * sizeof(hft::Symbol) <= metadata.size()) {
+            std::memcpy(symbol.data(), metadata.data() + r.symbol * sizeof(hft::Symbol), sizeof(symbol));
+        }
+        csv << r.timestamp << ','
+            << r.id << ','
+            << r.latency_ns << ','
+            << (r.kind <= RESULT_TICK ? KINDS[r.kind] : "?") << ','
+            << r.price << ','
+            << r.quantity << ','
+            << hft::symbol_view(symbol) << '\n';
+    });
+    if (!ok) {
+        std::cerr << "Error: " << bin_path << " is not a complete results log\n";
+    }
+    return ok;
+}
+
+/**
+ * @brief Capture tool: record a multicast feed with receive timestamps
+ *
+ * Packets are stamped with the kernel receive time where SO_TIMESTAMPING
+ * is available, else when recvmmsg returns.
+ */
+bool capture_feed(const std::string& group, uint16_t port, const std::string& path, int seconds) {
+    hft::UDPMulticastReceiver receiver(group, port);
+    if (!receiver.init()) {
+        std::cerr << "Error: Cannot join " << group << ":" << port << "\n";
+        return false;
+    }
+    const bool stamped = receiver.enable_rx_timestamping(hft::RxTimestamping::SOFTWARE);
+    
+    hft::MarketDataCapture capture;
+    if (!capture.open(path, 1u << 20)) {
+        std::cerr << "Error: Cannot open " << path << "\n";
+        return false;
+    }
+    capture.start();
+    std::cout << "Capturing " << group << ":" << port << " to " << path << " for " << seconds
+              << " s (" << (stamped ? "kernel" : "user-space") << " receive stamps)\n";
+    
+    const auto end_time = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < end_time) {
+        const auto packets = receiver.try_receive_batch();
+        if (packets.empty()) {
+            hft::cpu_pause();
+            continue;
+        }
+        const hft::Timestamp polled = hft::fast_now();
+        for (std::size_t i = 0; i < packets.size(); ++i) {
+            const hft::Timestamp rx = receiver.rx_timestamp(i);
+            capture.log(hft::capture_packet(packets[i], rx != 0 ? rx : polled));
+        }
+    }
+    capture.close();
+    std::cout << "Captured " << capture.records_written() << " packets";
+    if (capture.records_dropped() > 0) {
+        std::cout << " (" << capture.records_dropped() << " dropped)";
+    }
+    std::cout << "\n";
+    return capture.write_errors() == 0;
+}
+
+// Threads this mode pins, in cfg.affinity order, then the log writer
+std::vector<hft::ThreadSpec> placement_specs(const Config& cfg) {
+    std::vector<hft::ThreadSpec> specs;
+    if (cfg.mode == "exchange") {
+        specs = {{"strategy"}, {"exchange", true, 0}};
+    } else if (cfg.mode == "pipeline") {
+        specs.push_back({"generator"});
+        if (cfg.pipeline_stages >= 3) specs.push_back({"risk", true, 0});
+        specs.push_back({"matcher", true, static_cast<int>(specs.size()) - 1});
+    } else if (cfg.mode == "strategy") {
+        specs = {{"strategy"}};
+    } else {
+        specs = {{"engine"}};
+    }
+    specs.push_back({"logger", false});
+    return specs;
+}
+
+// "affinity": "auto" fills affinity and log_cpu from the topology; a manual
+// list is checked against it. Either way the placement is printed.
+void place_threads(Config& cfg) {
+    if (!cfg.auto_affinity && cfg.affinity.empty()) return;
+    const auto topology = hft::CpuTopology::discover();
+    const auto specs = placement_specs(cfg);
+    hft::PlacementPlan plan;
+    if (cfg.auto_affinity) {
+        plan = hft::plan_placement(topology, specs);
+        cfg.affinity.clear();
+        for (const auto& thread : plan.threads) {
+            if (thread.critical) cfg.affinity.push_back(thread.cpu);
+        }
+        if (cfg.log_cpu < 0) cfg.log_cpu = plan.cpu_of("logger");
+    } else {
+        std::vector<int> cpus = cfg.affinity;
+        cpus.resize(specs.size() - 1, -1);
+        cpus.push_back(cfg.log_cpu);
+        plan = hft::check_placement(topology, specs, cpus);
+    }
+
+    std::cout << "\n--- Thread Placement (" << (cfg.auto_affinity ? "auto" : "manual") << ") ---\n";
+    topology.print();
+    plan.print();
+}
+
+// Log writer core: configured, else the highest core the test threads don't use
+int pick_log_cpu(const Config& cfg) {
+    if (cfg.log_cpu >= 0 || cfg.affinity.empty()) return cfg.log_cpu;
+    for (int cpu = hft::get_cpu_count() - 1; cpu >= 0; --cpu) {
+        if (std::find(cfg.affinity.begin(), cfg.affinity.end(), cpu) == cfg.affinity.end()) {
+            return cpu;
+        }
+    }
+    return -1;
+}
+
 // Helper to print test results
 void print_test(const char* name, bool condition, int& passed, int& failed) {
     if (condition) {
@@ -200,6 +401,38 @@ bool run_selftest() {
         print_test("Overhead < 100ns", timer.overhead_ns() < 100, passed, failed);
         
         std::cout << "  Measurement: " << (ts2 - ts1) << " ns for 1000 iterations\n";
+        
+        // TSC wall clock: agrees with the system clock, cheaper to read
+        auto& clock = hft::TscClock::instance();
+        clock.refresh();
+        const auto& cross_core = clock.cross_core_check();
+        std::cout << "  Invariant TSC: " << (clock.invariant_tsc() ? "yes" : "no")
+                  << ", cross-core check: " << cross_core.cores_checked << " cores, max backwards "
+                  << cross_core.max_backwards_ticks << " ticks\n";
+        
+        const int CLOCK_READS = 100000;
+        hft::Timestamp sink = 0;
+        auto c1 = hft::rdtscp();
+        for (int i = 0; i < CLOCK_READS; ++i) sink += hft::now();
+        auto c2 = hft::rdtscp();
+        for (int i = 0; i < CLOCK_READS; ++i) sink += hft::fast_now();
+        auto c3 = hft::rdtscp();
+        asm volatile("" : : "r"(sink));
+        const double now_cost = timer.ticks_to_ns(c2 - c1) / CLOCK_READS;
+        const double fast_cost = timer.ticks_to_ns(c3 - c2) / CLOCK_READS;
+        std::cout << "  Clock read: now() " << now_cost << " ns, fast_now() " << fast_cost << " ns\n";
+        
+        const hft::Timestamp offset = hft::fast_now() - hft::now();
+        std::cout << "  fast_now() - now(): " << offset << " ns\n";
+        print_test("fast_now() tracks system clock", offset > -50000 && offset < 50000, passed, failed);
+        hft::Timestamp previous = hft::fast_now();
+        bool monotonic = true;
+        for (int i = 0; i < CLOCK_READS && monotonic; ++i) {
+            const hft::Timestamp t = hft::fast_now();
+            monotonic = t >= previous;
+            previous = t;
+        }
+        print_test("fast_now() monotonic", monotonic, passed, failed);
     }
     
     // Test 3: Order Book Creation
@@ -217,7 +450,7 @@ bool run_selftest() {
         print_test("Engine creation", true, passed, failed);
         
         hft::Symbol sym = hft::make_symbol("BTC-USD");
-        bool added = engine.add_instrument(sym);
+        bool added = engine.add_instrument(sym).has_value();
         print_test("Add instrument", added, passed, failed);
         
         auto book = engine.get_book(sym);
@@ -343,6 +576,88 @@ bool run_selftest() {
         
         std::cout << "  Total threads: " << hft::TimestampBufferManager::thread_count() << "\n";
         std::cout << "  Total events aggregated: " << all_events.size() << "\n";
+
+        // Stream the rings through the collector while recording (more than a ring holds)
+        hft::TimestampBufferManager::clear_all();
+        const std::string event_file = "/tmp/hftperf_selftest_events.bin";
+        const std::uint64_t dropped_before = buffer.dropped();
+        const int STREAM_EVENTS = static_cast<int>(hft::TimestampBufferManager::BUFFER_CAPACITY) * 2;
+        bool collecting = hft::TimestampBufferManager::start_collector(event_file);
+
+        threads.clear();
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            threads.emplace_back([&, t]() {
+                auto& tbuf = hft::TimestampBufferManager::get_thread_buffer();
+                for (int i = 0; i < EVENTS_PER_THREAD; ++i) {
+                    (void)tbuf.record(hft::EventType::ORDER_SUBMITTED, static_cast<uint64_t>(t * 10000 + i));
+                }
+            });
+        }
+        for (int i = 0; i < STREAM_EVENTS; ++i) {
+            (void)buffer.record(hft::EventType::TICK_GENERATED, static_cast<uint64_t>(i));
+            if ((i & 1023) == 0) std::this_thread::yield();
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        const std::uint64_t written = hft::TimestampBufferManager::stop_collector();
+        const std::uint64_t dropped = buffer.dropped() - dropped_before;
+
+        std::string metadata;
+        std::uint64_t read = 0;
+        std::uint64_t last_sequence = 0;
+        bool in_order = true;
+        collecting = collecting && hft::TimestampBufferManager::EventFile::for_each_record(event_file, metadata,
+            [&](const hft::TimestampEvent& event) {
+                in_order = in_order && (read == 0 || event.sequence > last_sequence);
+                last_sequence = event.sequence;
+                ++read;
+            });
+        std::remove(event_file.c_str());
+
+        const std::uint64_t expected_streamed = static_cast<std::uint64_t>(STREAM_EVENTS) + NUM_THREADS * EVENTS_PER_THREAD;
+        print_test("Collector streams past ring capacity", collecting && read == written &&
+                   written + dropped == expected_streamed, passed, failed);
+        print_test("Collector merges in sequence order", in_order, passed, failed);
+        print_test("Rings drained by collector", hft::TimestampBufferManager::total_count() == 0, passed, failed);
+        std::cout << "  Streamed " << written << " events (" << dropped << " dropped)\n";
+    }
+    
+    // Test 8: Strategy stage marks
+    std::cout << "\n--- Strategy Stage Mark Tests ---\n";
+    {
+        struct MarkingStrategy : hft::UserStrategy {
+            void onTick(const hft::Tick&) override {
+                record_timestamp("signal");
+                record_timestamp("risk");
+                record_timestamp("order");
+            }
+        } strategy;
+        strategy.set_timestamp_recording(true);
+        
+        const int NUM_TICKS = 10000;
+        const int MARKS_PER_TICK = 5;               // + tick_received and tick_done
+        hft::Tick tick{};
+        auto start = hft::rdtscp();
+        for (int i = 0; i < NUM_TICKS; ++i) {
+            strategy.begin_tick_processing(static_cast<uint64_t>(i));
+            strategy.onTick(tick);
+            strategy.end_tick_processing();
+        }
+        auto end = hft::rdtscp();
+        
+        const auto& stats = strategy.get_timing_stats();
+        auto count_of = [&](const char* key) {
+            auto it = stats.find(key);
+            return it == stats.end() ? 0 : it->second.count;
+        };
+        print_test("Stage deltas computed offline", count_of("signal → risk") == NUM_TICKS, passed, failed);
+        print_test("Tick total from mark chain", count_of("total_tick_processing") == NUM_TICKS, passed, failed);
+        
+        auto& timer = hft::HighPrecisionTimer::instance();
+        double ns_per_mark = timer.ticks_to_ns(end - start) / (NUM_TICKS * MARKS_PER_TICK);
+        std::cout << "  Overhead per mark: " << std::fixed << std::setprecision(1) << ns_per_mark << " ns\n";
+        print_test("Mark overhead < 50 ns", ns_per_mark < 50, passed, failed);
     }
     
     // Summary
@@ -362,6 +677,9 @@ bool run_selftest() {
 } // anonymous namespace
 
 int main(int argc, char* argv[]) {
+    // Calibrate fast_now() before any thread is pinned (see tsc_clock.hpp)
+    hft::TscClock::instance();
+    
     std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
     std::cout << "║                    HFT Performance Tester v1.0                ║\n";
     std::cout << "╚══════════════════════════════════════════════════════════════╝\n\n";
@@ -374,6 +692,16 @@ int main(int argc, char* argv[]) {
         if (std::strcmp(argv[i], "-selftest") == 0 || 
             std::strcmp(argv[i], "--selftest") == 0) {
             selftest = true;
+        } else if ((std::strcmp(argv[i], "-convert") == 0 ||
+                    std::strcmp(argv[i], "--convert") == 0) && i + 2 < argc) {
+            if (!convert_results(argv[i + 1], argv[i + 2])) return 1;
+            std::cout << "Converted " << argv[i + 1] << " to " << argv[i + 2] << "\n";
+            return 0;
+        } else if ((std::strcmp(argv[i], "-capture") == 0 ||
+                    std::strcmp(argv[i], "--capture") == 0) && i + 3 < argc) {
+            const int seconds = i + 4 < argc ? std::atoi(argv[i + 4]) : 10;
+            return capture_feed(argv[i + 1], static_cast<uint16_t>(std::atoi(argv[i + 2])),
+                                argv[i + 3], seconds) ? 0 : 1;
         } else if ((std::strcmp(argv[i], "-config") == 0 || 
              std::strcmp(argv[i], "--config") == 0) && i + 1 < argc) {
             config_file = argv[++i];
@@ -390,12 +718,16 @@ int main(int argc, char* argv[]) {
     if (config_file.empty()) {
         std::cerr << "Usage: " << argv[0] << " -config <config.json>\n";
         std::cerr << "       " << argv[0] << " -selftest\n";
+        std::cerr << "       " << argv[0] << " -convert <results.bin> <results.csv>\n";
+        std::cerr << "       " << argv[0] << " -capture <group> <port> <file> [seconds]\n";
         std::cerr << "\nOptions:\n";
         std::cerr << "  -config <file>   Run performance test with config file\n";
         std::cerr << "  -selftest        Run self-test to verify system\n";
+        std::cerr << "  -convert <b> <c> Convert a binary results log to CSV\n";
+        std::cerr << "  -capture ...     Record a multicast feed for replay_file\n";
         std::cerr << "\nModes:\n";
         std::cerr << "  single_thread    Basic single-threaded test (default)\n";
-        std::cerr << "  pipeline         Multi-threaded with lock-free queues\n";
+        std::cerr << "  pipeline         Pinned stages joined by lock-free rings\n";
         std::cerr << "  strategy         Test with user-defined strategy\n";
         std::cerr << "  external         Connect to external trading system\n";
         std::cerr << "\nStrategies:\n";
@@ -408,17 +740,28 @@ int main(int argc, char* argv[]) {
         std::cerr << "    \"duration_sec\": 10,\n";
         std::cerr << "    \"mode\": \"single_thread\",\n";
         std::cerr << "    \"message_rate\": 100000,\n";
+        std::cerr << "    \"message_pattern\": \"uniform\",\n";
         std::cerr << "    \"strategy\": \"pass_through\",\n";
         std::cerr << "    \"log_file\": \"results.csv\"\n";
         std::cerr << "}\n";
         std::cerr << "\nAdvanced options:\n";
+        std::cerr << "  message_pattern     uniform or poisson open-loop send schedule\n";
         std::cerr << "  gap_pause_ms        Simulate market data gap (ms)\n";
         std::cerr << "  gap_burst_count     Messages in recovery burst\n";
         std::cerr << "  trade_signal_ratio  Fraction of ticks that trade (0-1)\n";
         std::cerr << "  num_symbols         Multi-symbol round-robin\n";
         std::cerr << "  jitter_min/max_ns   Inject realistic jitter\n";
         std::cerr << "  warmup_sec          Exclude from statistics\n";
+        std::cerr << "  percentiles_file    Write latency percentiles (.hgrm)\n";
+        std::cerr << "  affinity            [cores] in thread order, or \"auto\" to place from topology\n";
+        std::cerr << "  log_cpu             Core for the results log writer\n";
+        std::cerr << "  log_csv             Convert the binary log to CSV after the run\n";
+        std::cerr << "  capture_file        Record this run's ticks and orders\n";
+        std::cerr << "  replay_file         Replay a capture (strategy/exchange/pipeline)\n";
+        std::cerr << "  pipeline_stages     2 = generator, matcher; 3 = adds a risk stage\n";
+        std::cerr << "  replay_speed        1 = recorded pacing, N = N× faster, 0 = max\n";
         std::cerr << "  enable_flame_graph  CPU profiling (Linux)\n";
+        std::cerr << "  perf_counters       Cycles, cache/branch/TLB misses per order\n";
         return 1;
     }
 
@@ -430,6 +773,10 @@ int main(int argc, char* argv[]) {
     std::cout << "  Duration:        " << cfg.duration_sec << " seconds\n";
     std::cout << "  Mode:            " << cfg.mode << "\n";
     if (cfg.mode == "pipeline") {
+        if (cfg.pipeline_stages < 2 || cfg.pipeline_stages > 3) {
+            std::cerr << "Warning: pipeline_stages is 2 or 3, using " << std::clamp(cfg.pipeline_stages, 2, 3) << "\n";
+            cfg.pipeline_stages = std::clamp(cfg.pipeline_stages, 2, 3);
+        }
         std::cout << "  Pipeline stages: " << cfg.pipeline_stages << "\n";
         std::cout << "  Use polling:     " << (cfg.use_polling ? "yes" : "no") << "\n";
     }
@@ -437,7 +784,20 @@ int main(int argc, char* argv[]) {
     std::cout << "  Pattern:         " << cfg.message_pattern << "\n";
     std::cout << "  Strategy:        " << cfg.strategy << "\n";
     std::cout << "  Log file:        " << cfg.log_file << "\n";
-    if (!cfg.affinity.empty()) {
+    if (!cfg.replay_file.empty()) {
+        std::cout << "  Replay:          " << cfg.replay_file << " at ";
+        if (cfg.replay_speed > 0) {
+            std::cout << cfg.replay_speed << "× recorded pacing\n";
+        } else {
+            std::cout << "full speed\n";
+        }
+    }
+    if (!cfg.capture_file.empty()) {
+        std::cout << "  Capture:         " << cfg.capture_file << "\n";
+    }
+    if (cfg.auto_affinity) {
+        std::cout << "  CPU affinity:    auto\n";
+    } else if (!cfg.affinity.empty()) {
         std::cout << "  CPU affinity:    [";
         for (size_t i = 0; i < cfg.affinity.size(); ++i) {
             if (i > 0) std::cout << ", ";
@@ -448,7 +808,7 @@ int main(int argc, char* argv[]) {
     
     // Print advanced options if any are enabled
     bool has_advanced = (cfg.gap_pause_ms > 0 || cfg.trade_signal_ratio < 1.0 ||
-                         cfg.num_symbols > 1 || cfg.enable_flame_graph ||
+                         cfg.num_symbols > 1 || cfg.enable_flame_graph || cfg.perf_counters ||
                          cfg.jitter_max_ns > 0 || cfg.warmup_sec > 0);
     if (has_advanced) {
         std::cout << "\n--- Advanced Options ---\n";
@@ -484,11 +844,17 @@ int main(int argc, char* argv[]) {
             }
             std::cout << "\n";
         }
+        if (cfg.perf_counters) {
+            std::cout << "  Perf counters:   enabled\n";
+        }
     }
 
-    // Set CPU affinity if specified (for main thread in single_thread mode)
+    place_threads(cfg);
+
+    // Set CPU affinity if specified (main thread runs the engine / strategy)
     #ifdef __linux__
-    if (!cfg.affinity.empty() && cfg.mode == "single_thread") {
+    if (!cfg.affinity.empty() && cfg.affinity[0] >= 0 &&
+        (cfg.mode == "single_thread" || cfg.mode == "strategy")) {
         hft::set_cpu_affinity(cfg.affinity[0]);
         std::cout << "\n[INFO] CPU affinity set to core " << cfg.affinity[0] << "\n";
     }
@@ -509,14 +875,38 @@ int main(int argc, char* argv[]) {
     if (cfg.num_symbols == 1) {
         engine.add_instrument(hft::make_symbol("TEST-USD"));
     }
+    
+    // Replay: ticks and orders come from a capture at its recorded pacing
+    // (scaled by replay_speed) instead of the generators and message_rate
+    hft::CaptureReplay replay;
+    if (!cfg.replay_file.empty()) {
+        if (!replay.open(cfg.replay_file)) {
+            std::cerr << "Error: Cannot open capture " << cfg.replay_file << "\n";
+            return 1;
+        }
+        for (const auto& sym : replay.symbols()) {
+            if (!engine.get_book(sym)) {
+                engine.add_instrument(sym);
+            }
+        }
+        std::cout << "\n[INFO] Replaying " << replay.size() << " captured records\n";
+        if (cfg.mode != "strategy" && cfg.mode != "exchange" && cfg.mode != "pipeline") {
+            std::cerr << "Warning: replay_file drives strategy, exchange and pipeline modes only\n";
+        }
+    }
 
     // Statistics
     std::atomic<uint64_t> orders_sent{0};
     std::atomic<uint64_t> orders_matched{0};
     std::atomic<uint64_t> ticks_received{0};
     std::atomic<uint64_t> signals_triggered{0};
-    std::vector<int64_t> latencies;
-    latencies.reserve(cfg.message_rate * cfg.duration_sec);
+    hft::LatencyStats latencies;
+    
+    // Hardware counters over the same region as latencies, on the thread
+    // that runs it (opened there)
+    hft::PerfCounters perf;
+    hft::PerfCounterStats perf_stats;
+    bool perf_measured = false;         // Mode supports counting
 
     // Random generators
     std::random_device rd;
@@ -524,7 +914,6 @@ int main(int argc, char* argv[]) {
     std::uniform_int_distribution<> price_dist(9900, 10100);  // Around $100
     std::uniform_int_distribution<> qty_dist(1, 100);
     std::bernoulli_distribution side_dist(0.5);
-    std::exponential_distribution<> poisson_dist(cfg.message_rate);
     std::uniform_real_distribution<> signal_dist(0.0, 1.0);   // For trade signal ratio
     std::uniform_int_distribution<> jitter_dist(cfg.jitter_min_ns, 
                                                  std::max(cfg.jitter_min_ns, cfg.jitter_max_ns));
@@ -568,14 +957,38 @@ int main(int argc, char* argv[]) {
     uint64_t order_id = 1;
     auto last_report = start_time;
     
-    // Open log file
-    std::ofstream log_file(cfg.log_file);
-    if (log_file.is_open()) {
-        log_file << "timestamp_ns,order_id,latency_ns,side,price,quantity,symbol\n";
-    }
-
     hft::Symbol test_symbol = hft::make_symbol("TEST-USD");
     
+    // Results log: the loops only push 32-byte records; a writer thread on
+    // a spare core maps them to disk and the CSV is rendered after the run
+    const std::string result_log_path = binary_log_path(cfg.log_file);
+    ResultLog result_log;
+    {
+        std::string symbol_table;
+        for (const auto& sym : (cfg.num_symbols <= 1 ? std::vector<hft::Symbol>{test_symbol} : symbols)) {
+            symbol_table.append(sym.data(), sym.size());
+        }
+        const auto expected = static_cast<std::size_t>(cfg.message_rate) * static_cast<std::size_t>(cfg.duration_sec);
+        if (result_log.open(result_log_path, expected, symbol_table)) {
+            result_log.start(pick_log_cpu(cfg));
+        } else {
+            std::cerr << "Warning: Cannot open results log " << result_log_path << "\n";
+        }
+    }
+    
+    hft::MarketDataCapture capture;
+    if (!cfg.capture_file.empty()) {
+        const auto expected = static_cast<std::size_t>(cfg.message_rate) * static_cast<std::size_t>(cfg.duration_sec) * 2;
+        if (capture.open(cfg.capture_file, expected)) {
+            capture.start(pick_log_cpu(cfg));
+        } else {
+            std::cerr << "Warning: Cannot open capture " << cfg.capture_file << "\n";
+        }
+    }
+    
+    // fast_now() stamps: move the refresher instance() started to the spare core
+    hft::TscClock::instance().start_refresher(hft::TscClock::DEFAULT_REFRESH, pick_log_cpu(cfg));
+    
     // Helper lambda for gap recovery simulation
     auto check_gap_recovery = [&]() {
         auto now = std::chrono::steady_clock::now();
@@ -623,10 +1036,44 @@ int main(int argc, char* argv[]) {
     
     // Helper to get current symbol (round-robin for multi-symbol)
     uint64_t symbol_counter = 0;
+    std::size_t current_symbol_index = 0;
     auto get_current_symbol = [&]() -> hft::Symbol {
         if (cfg.num_symbols <= 1) return test_symbol;
-        return symbols[symbol_counter++ % symbols.size()];
+        current_symbol_index = symbol_counter++ % symbols.size();
+        return symbols[current_symbol_index];
     };
+    
+    // Synthetic tick around $100 with a 1 tick spread, symbols round-robin
+    auto synthetic_tick = [&]() -> hft::Tick {
+        hft::Tick tick;
+        tick.symbol = get_current_symbol();
+        tick.bid_price = price_dist(gen) * 100;
+        tick.ask_price = tick.bid_price + 100;
+        tick.bid_size = qty_dist(gen);
+        tick.ask_size = qty_dist(gen);
+        tick.last_price = (tick.bid_price + tick.ask_price) / 2;
+        tick.last_size = qty_dist(gen);
+        return tick;
+    };
+    
+    // Next captured quote once due (nullptr when not replaying or at the end)
+    auto replay_tick = [&]() -> const hft::CaptureRecord* {
+        return replay.is_open() ? replay.next({hft::CaptureKind::PACKET, hft::CaptureKind::TICK}) : nullptr;
+    };
+    
+    // Open-loop pacing: sends follow a timeline fixed in advance by
+    // message_pattern and latency is taken from the intended send time, so a
+    // stall counts against every message it held back. A replay is paced by
+    // its recorded times instead (replay.due_time()).
+    hft::OpenLoopDriver driver(cfg.message_pattern == "poisson"
+        ? hft::ArrivalSchedule::poisson(cfg.message_rate, rd())
+        : hft::ArrivalSchedule::constant(cfg.message_rate));
+    auto next_send = [&]() -> hft::Timestamp {
+        return replay.is_open() ? replay.due_time() : driver.wait_next();
+    };
+    
+    replay.start(cfg.replay_speed);
+    driver.start();
 
     // Strategy mode - test with user-defined strategy
     if (cfg.mode == "strategy") {
@@ -646,6 +1093,10 @@ int main(int argc, char* argv[]) {
             if (result_id != hft::INVALID_ORDER_ID) {
                 orders_matched.fetch_add(1, std::memory_order_relaxed);
             }
+            if (capture.is_open()) {
+                capture.log(hft::capture_order(order_id++, order.symbol, order.side, order.type,
+                                               order.price, order.quantity, hft::fast_now()));
+            }
         });
         
         // Enable timestamp recording for strategy profiling
@@ -653,45 +1104,48 @@ int main(int argc, char* argv[]) {
         
         strategy->onInit();
         
+        if (cfg.perf_counters) {
+            perf.open();
+            perf_measured = true;
+        }
+        
         uint64_t tick_seq = 0;
         while (std::chrono::steady_clock::now() < end_time) {
-            auto tick_start = hft::now();
+            const hft::CaptureRecord* replayed = replay_tick();
+            if (replay.is_open() && !replayed) break;
+            
+            const hft::Timestamp intended = next_send();
+            auto tick_start = hft::fast_now();
             
-            // Generate simulated tick
-            hft::Tick tick;
-            tick.symbol = test_symbol;
-            tick.bid_price = price_dist(gen) * 100;
-            tick.ask_price = tick.bid_price + 100;  // 1 tick spread
-            tick.bid_size = qty_dist(gen);
-            tick.ask_size = qty_dist(gen);
-            tick.last_price = (tick.bid_price + tick.ask_price) / 2;
-            tick.last_size = qty_dist(gen);
+            // Captured or simulated tick
+            hft::Tick tick = replayed ? hft::to_tick(*replayed) : synthetic_tick();
             tick.timestamp = tick_start;
             tick.sequence = tick_seq++;
+            if (capture.is_open()) {
+                capture.log(hft::capture_tick(tick, tick_start));
+            }
             
             // Begin tick processing (records t_recv)
             strategy->begin_tick_processing(tick_seq);
             
             // Call strategy (user code with record_timestamp calls)
+            const auto counters_before = perf.read();
             strategy->onTick(tick);
+            perf_stats.add(perf.read() - counters_before);
             
             // End tick processing (records t_process_done)
             strategy->end_tick_processing();
             
-            auto tick_end = hft::now();
-            int64_t latency = tick_end - tick_start;
+            auto tick_end = hft::fast_now();
+            int64_t latency = tick_end - intended;
             
             orders_sent.fetch_add(1, std::memory_order_relaxed);
-            latencies.push_back(latency);
+            driver.record(intended, tick_start, tick_end);
             
             // Log to file
-            if (log_file.is_open()) {
-                log_file << tick_start << ","
-                         << tick_seq << ","
-                         << latency << ","
-                         << "TICK" << ","
-                         << tick.last_price << ","
-                         << tick.last_size << "\n";
+            if (result_log.is_open()) {
+                result_log.log(make_result(tick_start, tick_seq, latency, RESULT_TICK,
+                                           tick.last_price, tick.last_size, current_symbol_index));
             }
             
             // Progress report
@@ -703,21 +1157,10 @@ int main(int argc, char* argv[]) {
                           << " | Rate: " << (orders_sent.load() / std::max(1L, elapsed)) << " ticks/sec\n";
                 last_report = now;
             }
-            
-            // Rate limiting
-            auto target_interval_ns = 1000000000 / cfg.message_rate;
-            auto now_tp = std::chrono::steady_clock::now();
-            auto target_tp = now_tp + std::chrono::nanoseconds(target_interval_ns);
-            while (std::chrono::steady_clock::now() < target_tp) {
-                #if defined(__x86_64__) || defined(_M_X64)
-                    __builtin_ia32_pause();
-                #elif defined(__aarch64__)
-                    asm volatile("yield" ::: "memory");
-                #endif
-            }
-        }
+                    }
         
         strategy->onShutdown();
+        latencies = driver.corrected();
         
         // Print strategy timing breakdown
         strategy->print_timing_report();
@@ -756,12 +1199,16 @@ int main(int argc, char* argv[]) {
             ex_order.order_id = exchange_order_id.fetch_add(1, std::memory_order_relaxed);
             ex_order.tick_sequence = current_tick_seq;
             ex_order.t_gen = current_tick_tgen;
-            ex_order.t_strategy_done = hft::now();  // Strategy just finished
+            ex_order.t_strategy_done = hft::fast_now();  // Strategy just finished
             ex_order.symbol = order.symbol;
             ex_order.side = order.side;
             ex_order.type = order.type;
             ex_order.price = order.price;
             ex_order.quantity = order.quantity;
+            if (capture.is_open()) {
+                capture.log(hft::capture_order(ex_order.order_id, order.symbol, order.side, order.type,
+                                               order.price, order.quantity, ex_order.t_strategy_done));
+            }
             
             // Submit to exchange (via queue)
             if (!exchange.submit_order(ex_order)) {
@@ -777,7 +1224,7 @@ int main(int argc, char* argv[]) {
         
         // Set CPU affinity for generator/strategy thread
         #ifdef __linux__
-        if (!cfg.affinity.empty()) {
+        if (!cfg.affinity.empty() && cfg.affinity[0] >= 0) {
             hft::set_cpu_affinity(cfg.affinity[0]);
             std::cout << "[INFO] Generator/Strategy on CPU " << cfg.affinity[0] << "\n";
         }
@@ -787,21 +1234,21 @@ int main(int argc, char* argv[]) {
         
         uint64_t tick_seq = 0;
         while (std::chrono::steady_clock::now() < end_time) {
-            // Generate tick and record t_gen
-            hft::Timestamp t_gen = hft::now();
+            const hft::CaptureRecord* replayed = replay_tick();
+            if (replay.is_open() && !replayed) break;
+            
+            // Generate (or release the captured) tick; t_gen is its intended
+            // send time, so tick-to-trade includes any time it was held back
+            hft::Timestamp t_gen = next_send();
             current_tick_seq = tick_seq;
             current_tick_tgen = t_gen;
             
-            hft::Tick tick;
-            tick.symbol = test_symbol;
-            tick.bid_price = price_dist(gen) * 100;
-            tick.ask_price = tick.bid_price + 100;
-            tick.bid_size = qty_dist(gen);
-            tick.ask_size = qty_dist(gen);
-            tick.last_price = (tick.bid_price + tick.ask_price) / 2;
-            tick.last_size = qty_dist(gen);
+            hft::Tick tick = replayed ? hft::to_tick(*replayed) : synthetic_tick();
             tick.timestamp = t_gen;
             tick.sequence = tick_seq++;
+            if (capture.is_open()) {
+                capture.log(hft::capture_tick(tick, t_gen));
+            }
             
             // Call strategy (this will submit orders via callback)
             strategy->onTick(tick);
@@ -813,23 +1260,11 @@ int main(int argc, char* argv[]) {
             if (now_time - last_report >= std::chrono::seconds(1)) {
                 auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now_time - start_time).count();
                 std::cout << "[" << elapsed << "s] Ticks: " << orders_sent.load()
-                          << " | Exchange orders: " << exchange.stats().orders_received.load()
+                          << " | Exchange orders: " << exchange.orders_received()
                           << " | Rate: " << (orders_sent.load() / std::max(1L, elapsed)) << " ticks/sec\n";
                 last_report = now_time;
             }
-            
-            // Rate limiting
-            auto target_interval_ns = 1000000000 / cfg.message_rate;
-            auto now_tp = std::chrono::steady_clock::now();
-            auto target_tp = now_tp + std::chrono::nanoseconds(target_interval_ns);
-            while (std::chrono::steady_clock::now() < target_tp) {
-                #if defined(__x86_64__) || defined(_M_X64)
-                    __builtin_ia32_pause();
-                #elif defined(__aarch64__)
-                    asm volatile("yield" ::: "memory");
-                #endif
-            }
-        }
+                    }
         
         strategy->onShutdown();
         exchange.stop();
@@ -838,146 +1273,108 @@ int main(int argc, char* argv[]) {
         exchange.print_stats();
         
         // Use exchange stats for main latency output
-        const auto& ex_stats = exchange.stats();
-        latencies = ex_stats.tick_to_order_latencies;
-        orders_matched.store(ex_stats.orders_accepted.load());
+        const auto ex_stats = exchange.stats();
+        latencies = ex_stats.tick_to_order;
+        orders_matched.store(ex_stats.orders_accepted);
         
     } else if (cfg.mode == "pipeline") {
-    // Pipeline mode with multiple threads
-    // 
-    // Timestamp tracking for queue delay measurement:
-    //   t_gen  = timestamp when tick/order is generated (producer)
-    //   t_recv = timestamp when message is dequeued (consumer)
-    //   t_done = timestamp when order matching completes
+    // Pipeline mode: generator (this thread) -> [risk] -> matcher, each stage
+    // on its own pinned thread (core/pipeline.hpp), cores taken from affinity
+    // in that order.
     //
-    // Queue delay = t_recv - t_gen (measures thread scheduling + transfer time)
-    // Process time = t_done - t_recv (measures matching engine latency)
-    // Total latency = t_done - t_gen (end-to-end)
+    // Each stage records, per order:
+    //   queue delay  = dequeued - handed off (thread scheduling + transfer time)
+    //   service time = time in the stage (matcher: matching engine latency)
+    // and the matcher the end-to-end latency, generated to matched.
     //
         struct OrderMessage {
             uint64_t order_id;
-            int64_t t_gen;      // Generation timestamp (producer side)
             hft::Side side;
             hft::Price price;
             hft::Quantity quantity;
         };
         
-        hft::SPSCQueue<OrderMessage, 65536> order_queue;
-        std::atomic<bool> running{true};
-        std::atomic<uint64_t> processed{0};
-        
-        // Separate latency tracking for detailed analysis
-        std::vector<int64_t> queue_latencies;    // t_recv - t_gen
-        std::vector<int64_t> process_latencies;  // t_done - t_recv
-        std::vector<int64_t> total_latencies;    // t_done - t_gen (end-to-end)
-        queue_latencies.reserve(cfg.message_rate * cfg.duration_sec);
-        process_latencies.reserve(cfg.message_rate * cfg.duration_sec);
-        total_latencies.reserve(cfg.message_rate * cfg.duration_sec);
-        std::mutex latency_mutex;
-        
-        // Track queue overload (when consumer falls behind)
-        std::atomic<uint64_t> queue_overload_count{0};
-        int64_t max_queue_delay = 0;
-        
-        // Stage 2: Order processing thread (Consumer)
-        std::thread processor([&]() {
-            #ifdef __linux__
-            if (cfg.affinity.size() > 1) {
-                hft::set_cpu_affinity(cfg.affinity[1]);
-            }
-            #endif
-            
-            while (running.load(std::memory_order_relaxed) || !order_queue.empty()) {
-                auto msg = order_queue.try_pop();
-                if (msg) {
-                    // Record receive timestamp immediately after dequeue
-                    auto t_recv = hft::now();
-                    
-                    // Calculate queue delay (cross-thread transfer time)
-                    int64_t queue_delay = t_recv - msg->t_gen;
-                    
-                    // Detect overload: queue delay > 1000ns indicates consumer falling behind
-                    if (queue_delay > 1000) {
-                        queue_overload_count.fetch_add(1, std::memory_order_relaxed);
-                    }
-                    
-                    // Process the order
-                    auto result_id = engine.submit_order(
-                        test_symbol,
-                        msg->side,
-                        hft::OrderType::LIMIT,
-                        msg->price,
-                        msg->quantity,
-                        1
-                    );
-                    
-                    // Record completion timestamp
-                    auto t_done = hft::now();
-                    
-                    // Calculate latencies
-                    int64_t process_time = t_done - t_recv;
-                    int64_t total_latency = t_done - msg->t_gen;
-                    
-                    if (result_id != hft::INVALID_ORDER_ID) {
-                        orders_matched.fetch_add(1, std::memory_order_relaxed);
-                    }
-                    
-                    {
-                        std::lock_guard<std::mutex> lock(latency_mutex);
-                        queue_latencies.push_back(queue_delay);
-                        process_latencies.push_back(process_time);
-                        total_latencies.push_back(total_latency);
-                        if (queue_delay > max_queue_delay) {
-                            max_queue_delay = queue_delay;
-                        }
+        hft::PipelineConfig pipeline_cfg;
+        pipeline_cfg.cpus = cfg.affinity;
+        pipeline_cfg.idle.mode = cfg.use_polling ? hft::PollMode::BALANCED : hft::PollMode::RELAXED;
+        hft::Pipeline pipeline(pipeline_cfg);
+        
+        auto* generator = pipeline.source<OrderMessage>("generator");
+        hft::PipelineOutput<OrderMessage>* to_matcher = generator;
+        
+        // Stage 2 (pipeline_stages >= 3): pre-trade check, rejects dropped
+        hft::PreTradeRisk risk(1);
+        uint64_t risk_rejects = 0;      // Risk thread only, read after stop()
+        if (cfg.pipeline_stages >= 3) {
+            to_matcher = pipeline.stage<OrderMessage>("risk", *generator,
+                [&](const OrderMessage& msg, hft::Emitter<OrderMessage>& out) {
+                    if (risk.check(0, 0, msg.side, msg.price, msg.quantity) == hft::RiskResult::ACCEPTED) {
+                        out.emit(msg);
+                    } else {
+                        ++risk_rejects;
                     }
-                    
-                    processed.fetch_add(1, std::memory_order_relaxed);
-                } else if (cfg.use_polling) {
-                    // Busy-wait polling
-                    #if defined(__x86_64__) || defined(_M_X64)
-                        __builtin_ia32_pause();
-                    #elif defined(__aarch64__)
-                        asm volatile("yield" ::: "memory");
-                    #endif
-                } else {
-                    std::this_thread::yield();
-                }
+                });
+        }
+        
+        // Last stage: order matching
+        perf_measured = cfg.perf_counters;
+        auto* matcher = pipeline.sink("matcher", *to_matcher, [&](const OrderMessage& msg) {
+            if (perf_measured && !perf.is_open() && perf.error().empty()) {
+                perf.open();                // First order, on the matcher thread
+            }
+            const auto counters_before = perf.read();
+            auto result_id = engine.submit_order(
+                test_symbol,
+                msg.side,
+                hft::OrderType::LIMIT,
+                msg.price,
+                msg.quantity,
+                1
+            );
+            perf_stats.add(perf.read() - counters_before);
+            if (result_id != hft::INVALID_ORDER_ID) {
+                orders_matched.fetch_add(1, std::memory_order_relaxed);
             }
         });
         
         // Stage 1: Order generation thread (main thread)
         #ifdef __linux__
-        if (!cfg.affinity.empty()) {
-            hft::set_cpu_affinity(cfg.affinity[0]);
+        if (generator->cpu() >= 0) {
+            hft::set_cpu_affinity(generator->cpu());
         }
         #endif
         
-        std::cout << "[INFO] Pipeline mode: Stage 1 (generator) on core " 
-                  << (cfg.affinity.empty() ? -1 : cfg.affinity[0]) << "\n";
-        std::cout << "[INFO] Pipeline mode: Stage 2 (processor) on core " 
-                  << (cfg.affinity.size() > 1 ? cfg.affinity[1] : -1) << "\n\n";
+        for (std::size_t i = 0; i < pipeline.size(); ++i) {
+            std::cout << "[INFO] Pipeline mode: Stage " << (i + 1) << " (" << pipeline.at(i).name()
+                      << ") on core " << pipeline.at(i).cpu() << "\n";
+        }
+        std::cout << "\n";
+        pipeline.start();
         
         while (std::chrono::steady_clock::now() < end_time) {
+            const hft::CaptureRecord* replayed = replay.is_open() ? replay.next({hft::CaptureKind::ORDER}) : nullptr;
+            if (replay.is_open() && !replayed) break;
+            
+            const hft::Timestamp intended = next_send();
             OrderMessage msg;
             msg.order_id = order_id++;
-            msg.t_gen = hft::now();  // Generation timestamp (t_gen)
-            msg.side = side_dist(gen) ? hft::Side::BUY : hft::Side::SELL;
-            msg.price = price_dist(gen) * 100;
-            msg.quantity = qty_dist(gen);
-            
-            // Try to enqueue, back-pressure if full
-            while (!order_queue.try_push(msg)) {
-                if (cfg.use_polling) {
-                    #if defined(__x86_64__) || defined(_M_X64)
-                        __builtin_ia32_pause();
-                    #elif defined(__aarch64__)
-                        asm volatile("yield" ::: "memory");
-                    #endif
-                } else {
-                    std::this_thread::yield();
-                }
+            if (replayed) {
+                msg.side = replayed->side;
+                msg.price = replayed->bid_price;
+                msg.quantity = replayed->bid_size;
+            } else {
+                msg.side = side_dist(gen) ? hft::Side::BUY : hft::Side::SELL;
+                msg.price = price_dist(gen) * 100;
+                msg.quantity = qty_dist(gen);
             }
+            if (capture.is_open()) {
+                capture.log(hft::capture_order(msg.order_id, test_symbol, msg.side, hft::OrderType::LIMIT,
+                                               msg.price, msg.quantity, hft::fast_now()));
+            }
+            
+            // Back-pressures (waits) while the next stage's ring is full;
+            // end-to-end runs from the intended send time
+            generator->publish(msg, intended);
             
             orders_sent.fetch_add(1, std::memory_order_relaxed);
             
@@ -985,57 +1382,56 @@ int main(int argc, char* argv[]) {
             auto now = std::chrono::steady_clock::now();
             if (now - last_report >= std::chrono::seconds(1)) {
                 auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start_time).count();
+                const uint64_t processed = matcher->stats().processed.load(std::memory_order_relaxed);
                 std::cout << "[" << elapsed << "s] Sent: " << orders_sent.load() 
-                          << " | Processed: " << processed.load()
-                          << " | Pending: " << (orders_sent.load() - processed.load())
+                          << " | Processed: " << processed
+                          << " | Pending: " << (orders_sent.load() - processed)
                           << " | Rate: " << (orders_sent.load() / std::max(1L, elapsed)) << " ops/sec\n";
                 last_report = now;
             }
-            
-            // Rate limiting
-            auto target_interval_ns = 1000000000 / cfg.message_rate;
-            auto now_tp = std::chrono::steady_clock::now();
-            auto target_tp = now_tp + std::chrono::nanoseconds(target_interval_ns);
-            while (std::chrono::steady_clock::now() < target_tp) {
-                #if defined(__x86_64__) || defined(_M_X64)
-                    __builtin_ia32_pause();
-                #elif defined(__aarch64__)
-                    asm volatile("yield" ::: "memory");
-                #endif
-            }
-        }
+                    }
         
-        // Stop processor thread
-        running.store(false, std::memory_order_release);
-        processor.join();
+        // Drain and stop the stages
+        pipeline.stop();
         
-        // Use total latencies for main statistics
-        latencies = std::move(total_latencies);
+        // Use end-to-end latencies for main statistics
+        const hft::StageStats& matcher_stats = matcher->stats();
+        latencies = matcher_stats.end_to_end;
         
         // Print detailed queue statistics
         std::cout << "\n--- Queue Latency Analysis (Pipeline Mode) ---\n";
+        pipeline.print_stats();
+        if (cfg.pipeline_stages >= 3) {
+            std::cout << "  Risk rejects: " << risk_rejects << "\n";
+        }
         
+        const hft::LatencyStats& queue_latencies = matcher_stats.queue_delay;
+        const hft::LatencyStats& process_latencies = matcher_stats.service;
         if (!queue_latencies.empty()) {
-            std::sort(queue_latencies.begin(), queue_latencies.end());
-            std::sort(process_latencies.begin(), process_latencies.end());
+            auto q_median = static_cast<int64_t>(queue_latencies.median());
+            auto q_p99 = static_cast<int64_t>(queue_latencies.percentile(99.0));
+            auto q_max = static_cast<int64_t>(queue_latencies.max());
             
-            auto q_median = queue_latencies[queue_latencies.size() / 2];
-            auto q_p99 = queue_latencies[static_cast<size_t>(queue_latencies.size() * 0.99)];
-            auto q_max = queue_latencies.back();
+            auto p_median = static_cast<int64_t>(process_latencies.median());
+            auto p_p99 = static_cast<int64_t>(process_latencies.percentile(99.0));
+            auto p_max = static_cast<int64_t>(process_latencies.max());
             
-            auto p_median = process_latencies[process_latencies.size() / 2];
-            auto p_p99 = process_latencies[static_cast<size_t>(process_latencies.size() * 0.99)];
-            auto p_max = process_latencies.back();
+            // Overload: queue delay > 1000ns indicates the matcher falling behind
+            uint64_t queue_overload_count = 0;
+            queue_latencies.histogram().for_each_bucket([&](int64_t value, uint64_t n) {
+                if (value > 1000) queue_overload_count += n;
+            });
             
-            std::cout << "  Queue delay (t_recv - t_gen):\n";
+            std::cout << "  Matcher queue delay (dequeued - handed off):\n";
             std::cout << "    Median: " << q_median << " ns (" << (q_median / 1000.0) << " µs)\n";
             std::cout << "    P99:    " << q_p99 << " ns (" << (q_p99 / 1000.0) << " µs)\n";
             std::cout << "    Max:    " << q_max << " ns (" << (q_max / 1000.0) << " µs)\n";
-            std::cout << "  Processing time (t_done - t_recv):\n";
+            std::cout << "  Processing time (matching):\n";
             std::cout << "    Median: " << p_median << " ns (" << (p_median / 1000.0) << " µs)\n";
             std::cout << "    P99:    " << p_p99 << " ns (" << (p_p99 / 1000.0) << " µs)\n";
             std::cout << "    Max:    " << p_max << " ns (" << (p_max / 1000.0) << " µs)\n";
-            std::cout << "  Overload events (queue delay > 1µs): " << queue_overload_count.load() << "\n";
+            std::cout << "  Overload events (queue delay > 1µs): " << queue_overload_count << "\n";
+            std::cout << "  Backpressure stalls: " << generator->stats().stalls.load() << "\n";
             
             // Check if consumer is keeping up
             if (q_median < 100) {
@@ -1049,6 +1445,10 @@ int main(int argc, char* argv[]) {
         
     } else {
     // Single-thread mode (original) with advanced features
+    if (cfg.perf_counters) {
+        perf.open();
+        perf_measured = true;
+    }
     while (std::chrono::steady_clock::now() < end_time) {
         // Check warmup period
         if (!warmup_complete && std::chrono::steady_clock::now() >= warmup_end) {
@@ -1056,8 +1456,8 @@ int main(int argc, char* argv[]) {
             // Reset statistics after warmup
             orders_sent.store(0);
             orders_matched.store(0);
-            latencies.clear();
-            latencies.reserve(cfg.message_rate * cfg.duration_sec);
+            driver.clear();
+            perf_stats.clear();
             std::cout << "[INFO] Warmup complete, starting measurement\n";
         }
         
@@ -1065,6 +1465,10 @@ int main(int argc, char* argv[]) {
         bool is_burst = check_gap_recovery();
         if (is_burst) burst_remaining--;
         
+        // Burst messages are extra, sent unscheduled; a gap keeps the
+        // schedule running, so the messages it held back are charged for it
+        const hft::Timestamp intended = is_burst ? hft::fast_now() : driver.wait_next();
+        
         // Inject jitter if configured
         inject_jitter();
         
@@ -1076,7 +1480,7 @@ int main(int argc, char* argv[]) {
         }
         signals_triggered.fetch_add(1, std::memory_order_relaxed);
         
-        auto order_start = hft::now();
+        auto order_start = hft::fast_now();
         
         // Create order parameters with multi-symbol support
         hft::Symbol current_symbol = get_current_symbol();
@@ -1085,6 +1489,7 @@ int main(int argc, char* argv[]) {
         hft::Quantity quantity = qty_dist(gen);
 
         // Submit order
+        const auto counters_before = perf.read();
         auto result_id = engine.submit_order(
             current_symbol,
             side,
@@ -1093,31 +1498,30 @@ int main(int argc, char* argv[]) {
             quantity,
             1  // client_id
         );
+        if (warmup_complete) {
+            perf_stats.add(perf.read() - counters_before);
+        }
         
         if (result_id != hft::INVALID_ORDER_ID) {
             orders_matched.fetch_add(1, std::memory_order_relaxed);
         }
 
-        auto order_end = hft::now();
-        int64_t latency = order_end - order_start;
+        auto order_end = hft::fast_now();
+        int64_t latency = order_end - intended;
         
         order_id++;
         
         // Only record stats if warmup is complete
         if (warmup_complete) {
             orders_sent.fetch_add(1, std::memory_order_relaxed);
-            latencies.push_back(latency);
+            driver.record(intended, order_start, order_end);
         }
         
         // Log to file
-        if (log_file.is_open()) {
-            log_file << order_start << ","
-                     << order_id << ","
-                     << latency << ","
-                     << (side == hft::Side::BUY ? "BUY" : "SELL") << ","
-                     << price << ","
-                     << quantity << ","
-                     << hft::symbol_view(current_symbol) << "\n";
+        if (result_log.is_open()) {
+            result_log.log(make_result(order_start, order_id, latency,
+                                       side == hft::Side::BUY ? RESULT_BUY : RESULT_SELL,
+                                       price, quantity, current_symbol_index));
         }
 
         // Progress report every second
@@ -1131,37 +1535,8 @@ int main(int argc, char* argv[]) {
                       << " | Rate: " << (orders_sent.load() / std::max(1L, elapsed)) << " ops/sec\n";
             last_report = now;
         }
-
-        // Skip rate limiting during burst recovery
-        if (is_burst) continue;
-
-        // Rate limiting based on pattern
-        if (cfg.message_pattern == "poisson") {
-            auto delay_ns = static_cast<int64_t>(poisson_dist(gen) * 1e9);
-            if (delay_ns < 1000000) {  // Only busy-wait if < 1ms
-                auto wait_until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(delay_ns);
-                while (std::chrono::steady_clock::now() < wait_until) {
-                    #if defined(__x86_64__) || defined(_M_X64)
-                        __builtin_ia32_pause();
-                    #elif defined(__aarch64__)
-                        asm volatile("yield" ::: "memory");
-                    #endif
-                }
-            }
-        } else {
-            // Uniform rate
-            auto target_interval_ns = 1000000000 / cfg.message_rate;
-            auto now_tp = std::chrono::steady_clock::now();
-            auto target_tp = now_tp + std::chrono::nanoseconds(target_interval_ns);
-            while (std::chrono::steady_clock::now() < target_tp) {
-                #if defined(__x86_64__) || defined(_M_X64)
-                    __builtin_ia32_pause();
-                #elif defined(__aarch64__)
-                    asm volatile("yield" ::: "memory");
-                #endif
-            }
-        }
     }
+    latencies = driver.corrected();
     } // end else single-thread mode
 
     auto total_time = std::chrono::steady_clock::now() - start_time;
@@ -1169,16 +1544,14 @@ int main(int argc, char* argv[]) {
 
     // Calculate statistics
     if (!latencies.empty()) {
-        std::sort(latencies.begin(), latencies.end());
-        
-        int64_t sum = 0;
-        for (auto l : latencies) sum += l;
-        double avg = static_cast<double>(sum) / latencies.size();
-        
-        size_t p50_idx = latencies.size() * 50 / 100;
-        size_t p90_idx = latencies.size() * 90 / 100;
-        size_t p99_idx = latencies.size() * 99 / 100;
-        size_t p999_idx = latencies.size() * 999 / 1000;
+        const double avg = latencies.mean();
+        const auto min_ns = static_cast<int64_t>(latencies.min());
+        const auto max_ns = static_cast<int64_t>(latencies.max());
+        const auto p = latencies.get_percentiles();
+        const auto p50 = static_cast<int64_t>(p.p50);
+        const auto p90 = static_cast<int64_t>(p.p90);
+        const auto p99 = static_cast<int64_t>(p.p99);
+        const auto p999 = static_cast<int64_t>(p.p999);
 
         std::cout << "\n╔══════════════════════════════════════════════════════════════╗\n";
         std::cout << "║                         RESULTS                              ║\n";
@@ -1192,43 +1565,84 @@ int main(int argc, char* argv[]) {
                   << (orders_sent.load() * 1000.0 / total_ms) << " orders/sec\n";
 
         std::cout << "\n--- Latency (nanoseconds) ---\n";
-        std::cout << "  Min:             " << latencies.front() << " ns\n";
-        std::cout << "  Max:             " << latencies.back() << " ns\n";
+        std::cout << "  Min:             " << min_ns << " ns\n";
+        std::cout << "  Max:             " << max_ns << " ns\n";
         std::cout << "  Average:         " << std::fixed << std::setprecision(0) << avg << " ns\n";
-        std::cout << "  P50:             " << latencies[p50_idx] << " ns\n";
-        std::cout << "  P90:             " << latencies[p90_idx] << " ns\n";
-        std::cout << "  P99:             " << latencies[p99_idx] << " ns\n";
-        std::cout << "  P99.9:           " << latencies[p999_idx] << " ns\n";
+        std::cout << "  P50:             " << p50 << " ns\n";
+        std::cout << "  P90:             " << p90 << " ns\n";
+        std::cout << "  P99:             " << p99 << " ns\n";
+        std::cout << "  P99.9:           " << p999 << " ns\n";
 
         std::cout << "\n--- Latency (microseconds) ---\n";
-        std::cout << "  Min:             " << std::fixed << std::setprecision(2) << latencies.front() / 1000.0 << " µs\n";
-        std::cout << "  Max:             " << std::fixed << std::setprecision(2) << latencies.back() / 1000.0 << " µs\n";
+        std::cout << "  Min:             " << std::fixed << std::setprecision(2) << min_ns / 1000.0 << " µs\n";
+        std::cout << "  Max:             " << std::fixed << std::setprecision(2) << max_ns / 1000.0 << " µs\n";
         std::cout << "  Average:         " << std::fixed << std::setprecision(2) << avg / 1000.0 << " µs\n";
-        std::cout << "  P50:             " << std::fixed << std::setprecision(2) << latencies[p50_idx] / 1000.0 << " µs\n";
-        std::cout << "  P99:             " << std::fixed << std::setprecision(2) << latencies[p99_idx] / 1000.0 << " µs\n";
+        std::cout << "  P50:             " << std::fixed << std::setprecision(2) << p50 / 1000.0 << " µs\n";
+        std::cout << "  P99:             " << std::fixed << std::setprecision(2) << p99 / 1000.0 << " µs\n";
+        
+        std::cout << "\n--- Open-Loop Pacing (latency from intended send time) ---\n" << std::flush;
+        if (replay.is_open()) {
+            std::cout << "  Paced by the capture's recorded times\n";
+        } else {
+            driver.print("  ");
+        }
+        
+        if (cfg.perf_counters) {
+            std::cout << "\n--- Hardware Counters (per order) ---\n" << std::flush;
+            if (perf_measured) {
+                perf_stats.print(perf, "  Hardware");
+            } else {
+                std::cout << "  Not measured in " << cfg.mode << " mode\n";
+            }
+        }
     }
 
-    if (log_file.is_open()) {
-        log_file.close();
-        std::cout << "\nDetailed results written to: " << cfg.log_file << "\n";
+    hft::TscClock::instance().stop_refresher();
+    
+    if (replay.is_open()) {
+        std::cout << "\nReplayed " << replay.position() << " of " << replay.size() << " records";
+        if (replay.speed() > 0) {
+            std::cout << " (" << replay.late() << " released late, max lag "
+                      << std::fixed << std::setprecision(2) << replay.max_lag_ns() / 1000.0 << " µs)";
+        }
+        std::cout << "\n";
+    }
+    if (capture.is_open()) {
+        capture.close();
+        std::cout << "\nCapture written to: " << cfg.capture_file << " (" << capture.records_written() << " records";
+        if (capture.records_dropped() > 0) {
+            std::cout << ", " << capture.records_dropped() << " dropped";
+        }
+        std::cout << ")\n";
+    }
+    
+    if (result_log.is_open()) {
+        result_log.close();
+        std::cout << "\nBinary results written to: " << result_log_path
+                  << " (" << result_log.records_written() << " records";
+        if (result_log.records_dropped() > 0) {
+            std::cout << ", " << result_log.records_dropped() << " dropped";
+        }
+        std::cout << ")\n";
+        if (cfg.log_csv && convert_results(result_log_path, cfg.log_file)) {
+            std::cout << "Detailed results written to: " << cfg.log_file << "\n";
+        }
+    }
+    
+    // Percentile distribution export (HdrHistogram .hgrm, microseconds)
+    if (!cfg.percentiles_file.empty() && !latencies.empty()) {
+        if (std::FILE* out = std::fopen(cfg.percentiles_file.c_str(), "w")) {
+            latencies.write_percentiles(out, 1000.0);
+            std::fclose(out);
+            std::cout << "Latency percentiles written to: " << cfg.percentiles_file << "\n";
+        } else {
+            std::cerr << "Error: Cannot open percentiles file: " << cfg.percentiles_file << "\n";
+        }
     }
 
     // Print concise summary line
     if (!latencies.empty()) {
-        std::sort(latencies.begin(), latencies.end());
-        
-        int64_t sum = 0;
-        int64_t sum_sq = 0;
-        for (auto l : latencies) {
-            sum += l;
-            sum_sq += l * l;
-        }
-        double mean = static_cast<double>(sum) / latencies.size();
-        double variance = static_cast<double>(sum_sq) / latencies.size() - mean * mean;
-        double stddev = std::sqrt(variance);
-        
-        size_t p50_idx = latencies.size() * 50 / 100;
-        size_t p99_idx = latencies.size() * 99 / 100;
+        const double stddev = latencies.stddev();
         
         auto format_count = [](uint64_t n) -> std::string {
             if (n >= 1000000) return std::to_string(n / 1000000) + "M";
@@ -1242,11 +1656,11 @@ int main(int argc, char* argv[]) {
                   << format_count(orders_sent.load()) << " ticks, "
                   << format_count(orders_sent.load()) << " orders. "
                   << "End-to-end latency: median " << std::setprecision(1) 
-                  << (latencies[p50_idx] / 1000.0) << " µs, "
+                  << (latencies.median() / 1000.0) << " µs, "
                   << "99th percentile " << std::setprecision(1) 
-                  << (latencies[p99_idx] / 1000.0) << " µs, "
+                  << (latencies.percentile(99.0) / 1000.0) << " µs, "
                   << "max " << std::setprecision(1) 
-                  << (latencies.back() / 1000.0) << " µs. "
+                  << (latencies.max() / 1000.0) << " µs. "
                   << "No packet loss. "
                   << "Jitter (stddev) ~ " << std::setprecision(1) 
                   << (stddev / 1000.0) << " µs.\"\n";
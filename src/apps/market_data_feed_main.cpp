@@ -6,6 +6,13 @@
  * - Quote updates
  * - Trade events
  * - Order book snapshots
+ * 
+ * Usage: market_data_feed [--sbe <group> <port>] [--conflate]
+ *   --sbe       Also publish every update as an sbe::BookUpdate datagram
+ *               on the given UDP multicast group
+ *   --conflate  Publish from a separate thread through a conflated
+ *               MarketDataChannel: when publishing falls behind, quotes
+ *               for a symbol collapse to the latest one (trades do not)
  */
 
 #include <iostream>
@@ -15,10 +22,18 @@
 #include <thread>
 #include <chrono>
 #include <random>
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
 
 #include "marketdata/market_data_handler.hpp"
+#include "core/busy_poll.hpp"
 #include "core/cpu_affinity.hpp"
 #include "core/types.hpp"
+#include "core/tsc_clock.hpp"
+#include "protocol/binary_codec.hpp"
+#include "transport/udp_multicast.hpp"
 
 using namespace hft;
 
@@ -147,9 +162,62 @@ private:
     std::atomic<std::uint64_t> updates_generated_{0};
 };
 
+/**
+ * @brief Encode a feed update as an sbe::BookUpdate
+ */
+std::size_t encode_book_update(std::span<char> buffer, const MarketDataUpdate& update,
+                               std::uint64_t sequence) {
+    using F = sbe::BookUpdateField;
+    sbe::Encoder<sbe::BookUpdate> enc(buffer);
+    if (!enc.ok()) return 0;
+    
+    enc.set<F::SEQUENCE>(sequence)
+       .set<F::TIMESTAMP>(update.timestamp)
+       .set<F::SYMBOL>(update.symbol);
+    if (update.type == MarketDataType::TRADE) {
+        enc.set<F::UPDATE_TYPE>(sbe::BookUpdateType::TRADE)
+           .set<F::TRADE_PRICE>(update.data.trade.price)
+           .set<F::TRADE_QUANTITY>(update.data.trade.quantity)
+           .set<F::TRADE_SIDE>(update.data.trade.side)
+           .set<F::BID_PRICE>(0).set<F::BID_QUANTITY>(0)
+           .set<F::ASK_PRICE>(0).set<F::ASK_QUANTITY>(0);
+    } else {
+        enc.set<F::UPDATE_TYPE>(sbe::BookUpdateType::QUOTE)
+           .set<F::BID_PRICE>(update.data.quote.bid_price)
+           .set<F::BID_QUANTITY>(update.data.quote.bid_quantity)
+           .set<F::ASK_PRICE>(update.data.quote.ask_price)
+           .set<F::ASK_QUANTITY>(update.data.quote.ask_quantity)
+           .set<F::TRADE_PRICE>(0).set<F::TRADE_QUANTITY>(0)
+           .set<F::TRADE_SIDE>(Side::BUY);
+    }
+    return enc.size();
+}
+
 int main(int argc, char* argv[]) {
-    (void)argc;
-    (void)argv;
+    // Calibrate fast_now() before any thread is pinned (see tsc_clock.hpp)
+    hft::TscClock::instance();
+    
+    // Optional binary multicast publisher
+    std::unique_ptr<UDPMulticastSender> sbe_sender;
+    bool conflate = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--sbe" && i + 2 < argc) {
+            sbe_sender = std::make_unique<UDPMulticastSender>(
+                argv[i + 1], static_cast<uint16_t>(std::stoi(argv[i + 2])));
+            if (!sbe_sender->init()) {
+                std::cerr << "Failed to open multicast socket for " << argv[i + 1] << ":" << argv[i + 2] << "\n";
+                return 1;
+            }
+            std::cout << "Publishing binary book updates to " << argv[i + 1] << ":" << argv[i + 2] << "\n\n";
+            i += 2;
+        } else if (arg == "--conflate") {
+            conflate = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--sbe <group> <port>] [--conflate]\n";
+            return 1;
+        }
+    }
     
     std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
     std::cout << "║              HFT Market Data Feed Simulator v1.0              ║\n";
@@ -159,6 +227,7 @@ int main(int argc, char* argv[]) {
     std::signal(SIGTERM, signal_handler);
     
     MarketDataFeedServer server;
+    MarketDataHandler handler;      // Interns symbols for the conflated channel
     
     // Add instruments
     std::cout << "Configuring instruments:\n";
@@ -172,12 +241,23 @@ int main(int argc, char* argv[]) {
     std::cout << "  + AVAX-USD (base: $35)\n";
     server.add_instrument(make_symbol("MATIC-USD"), 0.90, 0.0003);
     std::cout << "  + MATIC-USD (base: $0.90)\n";
+    for (const char* name : {"BTC-USD", "ETH-USD", "SOL-USD", "AVAX-USD", "MATIC-USD"}) {
+        handler.subscribe(make_symbol(name));
+    }
     
     // Set up callback to print some updates
     std::atomic<std::uint64_t> quote_count{0};
     std::atomic<std::uint64_t> trade_count{0};
     
-    server.set_update_callback([&](const MarketDataUpdate& update) {
+    std::array<char, sbe::Encoder<sbe::BookUpdate>::ENCODED_LENGTH> sbe_buffer;
+    std::uint64_t sbe_sequence = 0;
+    
+    auto publish = [&](const MarketDataUpdate& update) {
+        if (sbe_sender) {
+            const auto len = encode_book_update(sbe_buffer, update, ++sbe_sequence);
+            sbe_sender->send_bytes(std::span<const char>(sbe_buffer.data(), len));
+        }
+        
         if (update.type == MarketDataType::QUOTE_UPDATE) {
             ++quote_count;
             // Print occasional quote
@@ -196,7 +276,27 @@ int main(int argc, char* argv[]) {
                       << " " << update.data.trade.quantity
                       << " @ " << to_double_price(update.data.trade.price) << "\n";
         }
-    });
+    };
+    
+    // Conflated: the generator only overwrites slots, a publisher thread drains them
+    MarketDataChannel* channel = nullptr;
+    std::thread publisher;
+    std::atomic<bool> publishing{true};
+    if (conflate) {
+        channel = &handler.add_channel(MarketDataChannel::Mode::CONFLATED);
+        server.set_update_callback([&handler](const MarketDataUpdate& update) {
+            handler.on_update(update);
+        });
+        publisher = std::thread([&] {
+            IdleStrategy idle;
+            while (publishing.load(std::memory_order_acquire)) {
+                idle.idle(channel->poll(publish));
+            }
+            channel->poll(publish);
+        });
+    } else {
+        server.set_update_callback(publish);
+    }
     
     std::cout << "\nStarting market data feed...\n";
     std::cout << "Press Ctrl+C to stop.\n\n";
@@ -218,9 +318,17 @@ int main(int argc, char* argv[]) {
         std::cout << "  Trades:         " << trade_count.load() << "\n";
         std::cout << "  Update rate:    " << std::setprecision(0) 
                   << (server.updates_generated() / seconds) << " updates/sec\n";
+        if (channel) {
+            std::cout << "  Conflated:      " << channel->conflated() << " quotes\n";
+            std::cout << "  Dropped:        " << channel->dropped() << " trades\n";
+        }
     }
     
     server.stop();
+    if (publisher.joinable()) {
+        publishing.store(false, std::memory_order_release);
+        publisher.join();
+    }
     
     std::cout << "\nMarket data feed stopped.\n";
     std::cout << "Total updates generated: " << server.updates_generated() << "\n";
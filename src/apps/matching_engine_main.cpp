@@ -6,15 +6,39 @@
  * - Accepts orders via REST API
  * - Maintains order books for multiple instruments
  * - Publishes execution reports
+ * - Optionally serves as one shard behind the order gateway:
+ *   `matching_engine --ipc /tmp/engine0.sock --symbols BTC-USD,ETH-USD`
+ *   answers every OrderPacket on the socket with exactly one
+ *   OrderResponsePacket, in arrival order
+ * - With `--journal DIR`, journals every request and snapshots the books
+ *   every minute under DIR, and recovers from them on startup
+ * - With `--l2 GROUP PORT`, multicasts every price-level change of every
+ *   book as an sbe::LevelUpdate; a receiver seeds from /api/v1/depth,
+ *   whose "sequence" is the last delta already reflected in it
+ * - With `--exec-bus NAME`, publishes every execution report into the
+ *   shared-memory ring NAME (ExecReportBus) for drop-copy, risk and audit
+ *   processes, which read it without slowing the engine
  */
 
-#include <iostream>
-#include <csignal>
+#include <array>
 #include <atomic>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
+#include "matching/engine_journal.hpp"
 #include "matching/matching_engine.hpp"
+#include "protocol/binary_codec.hpp"
 #include "protocol/rest_handler.hpp"
 #include "core/cpu_affinity.hpp"
+#include "core/reactor.hpp"
+#include "core/tsc_clock.hpp"
+#include "transport/exec_report_bus.hpp"
+#include "transport/ipc_socket.hpp"
+#include "transport/udp_multicast.hpp"
 
 using namespace hft;
 
@@ -26,9 +50,153 @@ void signal_handler(int signum) {
     g_running.store(false, std::memory_order_release);
 }
 
+namespace {
+
+/**
+ * @brief Bridges OrderPackets from the gateway to the engine
+ *
+ * One response per packet: NEW reports the aggressor's fills from the
+ * matching pass it triggered, CANCEL reports the outcome. Client order ids
+ * are the gateway's shard ids, unique across its sessions.
+ */
+class ShardService {
+public:
+    /**
+     * @param journal Journals every request first when set
+     */
+    ShardService(MatchingEngine& engine, EngineJournal* journal)
+        : engine_(engine), journal_(journal)
+    {
+        // Orders restored by recovery carry the gateway's ids
+        for (InstrumentId id = 0; id < engine_.instrument_count(); ++id) {
+            engine_.get_book(id)->for_each_order([this](const Order& order) {
+                if (order.client_id == 0) return;       // Entered over REST
+                by_client_[order.client_id] = order.order_id;
+                by_order_[order.order_id] = order.client_id;
+            });
+        }
+    }
+
+    OrderResponsePacket handle(const OrderPacket& packet) {
+        OrderResponsePacket response{};
+        response.client_order_id = packet.client_order_id;
+        response.status = STATUS_REJECTED;
+
+        Symbol symbol{};
+        std::memcpy(symbol.data(), packet.symbol, std::min(sizeof(packet.symbol), symbol.size()));
+
+        if (packet.action == 0) {
+            submit(symbol, packet, response);
+        } else if (packet.action == 1) {
+            cancel(symbol, packet, response);
+        }
+        response.timestamp = now();
+        return response;
+    }
+
+private:
+    static constexpr std::uint8_t STATUS_NEW = 0;
+    static constexpr std::uint8_t STATUS_PARTIAL = 1;
+    static constexpr std::uint8_t STATUS_FILLED = 2;
+    static constexpr std::uint8_t STATUS_CANCELLED = 3;
+    static constexpr std::uint8_t STATUS_REJECTED = 4;
+
+    void submit(const Symbol& symbol, const OrderPacket& packet, OrderResponsePacket& response) {
+        const auto instrument = engine_.find_instrument(symbol);
+        if (!instrument || packet.quantity <= 0) return;
+
+        OrderId aggressor = INVALID_ORDER_ID;
+        Quantity filled = 0;
+        Quantity leaves = packet.quantity;
+        auto sink = [&](const ExecutionReport& report) {
+            if (report.exec_type == ExecutionType::NEW) {
+                aggressor = report.order_id;
+            } else if (report.order_id == aggressor) {
+                if (report.exec_type == ExecutionType::TRADE) {
+                    filled += report.execution_quantity;
+                    response.fill_price = report.execution_price;
+                }
+                leaves = report.leaves_quantity;
+            } else if (report.exec_type == ExecutionType::TRADE && report.leaves_quantity == 0) {
+                forget(report.order_id);    // Resting order filled completely
+            }
+        };
+
+        const Side side = packet.side == 0 ? Side::BUY : Side::SELL;
+        const OrderType type = packet.order_type == 0 ? OrderType::MARKET : OrderType::LIMIT;
+        const OrderId order_id = process(OrderRequest::make_new(*instrument, side, type, packet.price,
+                                                                packet.quantity, packet.client_order_id),
+                                         sink);
+        if (order_id == INVALID_ORDER_ID) return;
+
+        response.exchange_order_id = order_id;
+        response.fill_quantity = filled;
+        response.leaves_quantity = leaves;
+        response.status = filled == 0 ? STATUS_NEW
+                        : leaves == 0 ? STATUS_FILLED : STATUS_PARTIAL;
+        if (leaves > 0) {
+            by_client_[packet.client_order_id] = order_id;
+            by_order_[order_id] = packet.client_order_id;
+        }
+    }
+
+    void cancel(const Symbol& symbol, const OrderPacket& packet, OrderResponsePacket& response) {
+        auto it = by_client_.find(packet.client_order_id);
+        if (it == by_client_.end()) return;
+        const OrderId order_id = it->second;
+        response.exchange_order_id = order_id;
+        if (process(OrderRequest::make_cancel(symbol, order_id), NullExecutionSink{}) == order_id) {
+            response.status = STATUS_CANCELLED;
+        }
+        forget(order_id);
+    }
+
+    template<typename Sink>
+    OrderId process(const OrderRequest& request, Sink&& sink) {
+        return journal_ ? journal_->process(engine_, request, sink)
+                        : engine_.process_request(request, sink);
+    }
+
+    void forget(OrderId order_id) {
+        auto it = by_order_.find(order_id);
+        if (it == by_order_.end()) return;
+        by_client_.erase(it->second);
+        by_order_.erase(it);
+    }
+
+    MatchingEngine& engine_;
+    EngineJournal* journal_;
+    std::unordered_map<std::uint64_t, OrderId> by_client_;
+    std::unordered_map<OrderId, std::uint64_t> by_order_;
+};
+
+} // namespace
+
 int main(int argc, char* argv[]) {
-    (void)argc;
-    (void)argv;
+    // Calibrate fast_now() before any thread is pinned (see tsc_clock.hpp)
+    hft::TscClock::instance();
+    
+    std::string ipc_path;
+    std::string symbol_list;
+    std::string journal_dir;
+    std::string l2_group;
+    std::uint16_t l2_port = 0;
+    std::string exec_bus_name;
+    for (int i = 1; i + 1 < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--ipc") {
+            ipc_path = argv[++i];
+        } else if (arg == "--symbols") {
+            symbol_list = argv[++i];
+        } else if (arg == "--journal") {
+            journal_dir = argv[++i];
+        } else if (arg == "--exec-bus") {
+            exec_bus_name = argv[++i];
+        } else if (arg == "--l2" && i + 2 < argc) {
+            l2_group = argv[++i];
+            l2_port = static_cast<std::uint16_t>(std::stoi(argv[++i]));
+        }
+    }
     
     std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
     std::cout << "║              HFT Matching Engine Server v1.0                  ║\n";
@@ -45,10 +213,15 @@ int main(int argc, char* argv[]) {
     config.name = "matching-main";
     apply_thread_config(config);
     
+    // Order pools on huge pages from this node; lock_memory above already
+    // keeps them resident once touched
+    default_memory_policy().page_size = PageSize::HUGE_2MB;
+    default_memory_policy().numa_node = MemoryPolicy::NUMA_LOCAL;
+    
     // Create matching engine
     MatchingEngine engine;
     
-    // Add default instruments
+    // Add default instruments, or the shard's own set
     std::vector<Symbol> instruments = {
         make_symbol("BTC-USD"),
         make_symbol("ETH-USD"),
@@ -56,6 +229,15 @@ int main(int argc, char* argv[]) {
         make_symbol("AVAX-USD"),
         make_symbol("MATIC-USD")
     };
+    if (!symbol_list.empty()) {
+        instruments.clear();
+        std::string_view rest = symbol_list;
+        while (!rest.empty()) {
+            const auto comma = rest.find(',');
+            instruments.push_back(make_symbol(rest.substr(0, comma)));
+            rest = comma == std::string_view::npos ? std::string_view{} : rest.substr(comma + 1);
+        }
+    }
     
     std::cout << "Initializing instruments:\n";
     for (const auto& sym : instruments) {
@@ -63,9 +245,12 @@ int main(int argc, char* argv[]) {
         std::cout << "  + " << symbol_view(sym) << "\n";
     }
     
-    // Set up execution callback
-    engine.set_execution_callback([](const ExecutionReport& report) {
-        // In production, this would publish to message queue
+    // Set up execution callback; the bus is attached after recovery so the
+    // replay is not published
+    ExecReportBus exec_bus(exec_bus_name);
+    ExecReportBus* exec_out = nullptr;
+    engine.set_execution_callback([&exec_out](const ExecutionReport& report) {
+        if (exec_out) exec_out->publish(report);
         if (report.exec_type == ExecutionType::TRADE) {
             std::cout << "[TRADE] OrderID=" << report.order_id
                       << " Price=" << to_double_price(report.execution_price)
@@ -73,9 +258,75 @@ int main(int argc, char* argv[]) {
         }
     });
     
+    // Rebuild state from the last snapshot and the journal tail, then keep
+    // journaling; every state change below goes through process()
+    EngineJournal journal;
+    const bool journaling = !journal_dir.empty();
+    const std::string snapshot_path = journal_dir + "/engine.snapshot";
+    if (journaling) {
+        JournalConfig journal_config;
+        journal_config.path = journal_dir + "/engine.journal";
+        const auto start = now();
+        std::optional<RecoveryResult> recovered;
+        if (!journal.open(journal_config) || !(recovered = journal.recover(engine, snapshot_path))) {
+            std::cerr << "Failed to recover from journal in " << journal_dir << "\n";
+            return 1;
+        }
+        std::cout << "\nRecovered " << recovered->orders_restored << " resting orders"
+                  << (recovered->snapshot_loaded ? " from snapshot" : "") << " and replayed "
+                  << recovered->records_replayed << " journal records in "
+                  << (now() - start) / 1'000'000 << " ms\n";
+        journal.start();
+    }
+    
+    if (!exec_bus_name.empty()) {
+        if (!exec_bus.init()) {
+            std::cerr << "Failed to create execution report bus " << exec_bus_name << "\n";
+            return 1;
+        }
+        exec_out = &exec_bus;
+        std::cout << "\nPublishing execution reports to " << exec_bus_name << "\n";
+    }
+    
+    // L2 deltas, attached after recovery so the replay is not published;
+    // drained on this thread between polls
+    struct L2Feed {
+        Symbol symbol;
+        RegionPtr<BookDeltaRing> ring;
+    };
+    std::vector<L2Feed> l2_feeds;
+    UDPMulticastSender l2_sender(l2_group, l2_port);
+    if (!l2_group.empty()) {
+        if (!l2_sender.init()) {
+            std::cerr << "Failed to open L2 multicast " << l2_group << ":" << l2_port << "\n";
+            return 1;
+        }
+        for (const auto& sym : instruments) {
+            l2_feeds.push_back({sym, RegionPtr<BookDeltaRing>::make(default_memory_policy())});
+            engine.get_book(sym)->set_delta_ring(l2_feeds.back().ring.get());
+        }
+        std::cout << "\nPublishing L2 deltas to " << l2_group << ":" << l2_port << "\n";
+    }
+    auto publish_l2 = [&] {
+        std::array<BookDelta, 64> batch;
+        std::array<char, 128> datagram;
+        for (auto& feed : l2_feeds) {
+            const std::size_t n = feed.ring->try_pop_bulk(batch);
+            const Timestamp timestamp = now();
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::size_t size = sbe::encode_level_update(datagram, feed.symbol, batch[i], timestamp);
+                l2_sender.send_bytes(std::span<const char>(datagram.data(), size));
+            }
+        }
+    };
+    
+    auto process = [&](const OrderRequest& request) {
+        return journaling ? journal.process(engine, request) : engine.process_request(request);
+    };
+    
     // Create HTTP server
     constexpr std::uint16_t PORT = 8080;
-    HttpServer server(PORT);
+    HttpServer server(ipc_path.empty() ? PORT : 0);
     
     // Set up REST routes
     auto& router = server.router();
@@ -100,18 +351,22 @@ int main(int argc, char* argv[]) {
                 .json(json_response::error("Symbol not found", "SYMBOL_NOT_FOUND"));
         }
         
-        auto depth = book->get_depth(20);
-        
-        std::vector<std::pair<Price, Quantity>> bids, asks;
-        for (const auto& level : depth.bids) {
-            bids.emplace_back(level.price, level.quantity);
+        constexpr std::size_t DEPTH_LEVELS = 20;
+        std::array<OrderBook::Level, DEPTH_LEVELS> levels;
+        std::array<std::pair<Price, Quantity>, DEPTH_LEVELS> bids, asks;
+        const std::size_t bid_count = book->copy_depth(Side::BUY, levels);
+        for (std::size_t i = 0; i < bid_count; ++i) {
+            bids[i] = {levels[i].price, levels[i].quantity};
         }
-        for (const auto& level : depth.asks) {
-            asks.emplace_back(level.price, level.quantity);
+        const std::size_t ask_count = book->copy_depth(Side::SELL, levels);
+        for (std::size_t i = 0; i < ask_count; ++i) {
+            asks[i] = {levels[i].price, levels[i].quantity};
         }
         
         return HttpResponse(HttpStatus::OK)
-            .json(json_response::depth(bids, asks, *symbol_param));
+            .json(json_response::depth(std::span(bids).first(bid_count),
+                                       std::span(asks).first(ask_count),
+                                       *symbol_param, book->delta_sequence()));
     });
     
     // Get quote
@@ -134,7 +389,7 @@ int main(int argc, char* argv[]) {
     });
     
     // Submit order
-    router.post("/api/v1/order", [&engine](const HttpRequest& req) {
+    router.post("/api/v1/order", [&process](const HttpRequest& req) {
         auto order_req = parse_order_request(req.body);
         if (!order_req) {
             return HttpResponse(HttpStatus::BAD_REQUEST)
@@ -142,13 +397,13 @@ int main(int argc, char* argv[]) {
         }
         
         Symbol symbol = make_symbol(order_req->symbol);
-        OrderId order_id = engine.submit_order(
+        OrderId order_id = process(OrderRequest::make_new(
             symbol,
             order_req->side,
             order_req->type,
             to_fixed_price(order_req->price),
             static_cast<Quantity>(order_req->quantity)
-        );
+        ));
         
         if (order_id == INVALID_ORDER_ID) {
             return HttpResponse(HttpStatus::BAD_REQUEST)
@@ -160,7 +415,7 @@ int main(int argc, char* argv[]) {
     });
     
     // Cancel order
-    router.del("/api/v1/order/:symbol/:orderId", [&engine](const HttpRequest& req) {
+    router.del("/api/v1/order/:symbol/:orderId", [&process](const HttpRequest& req) {
         auto symbol_param = req.get_path_param("symbol");
         auto order_id_param = req.get_path_param("orderId");
         
@@ -172,7 +427,7 @@ int main(int argc, char* argv[]) {
         Symbol symbol = make_symbol(*symbol_param);
         OrderId order_id = std::stoull(std::string(*order_id_param));
         
-        if (engine.cancel_order(symbol, order_id)) {
+        if (process(OrderRequest::make_cancel(symbol, order_id)) == order_id) {
             return HttpResponse(HttpStatus::OK)
                 .json(json_response::order_cancelled(order_id));
         } else {
@@ -200,7 +455,22 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    std::cout << "\nMatching engine started on port " << PORT << "\n";
+    // Shard mode: gateway connections share a reactor on this thread
+    Reactor io;
+    ShardService shard(engine, journaling ? &journal : nullptr);
+    IPCSocketServer ipc(ipc_path);
+    if (!ipc_path.empty()) {
+        if (!io.init() || !ipc.init() ||
+            !ipc.attach(io, [&](const OrderPacket& packet, int client_fd) {
+                ipc.send_response(client_fd, shard.handle(packet));
+            })) {
+            std::cerr << "Failed to serve orders on " << ipc_path << "\n";
+            return 1;
+        }
+        std::cout << "\nServing gateway orders on " << ipc_path << "\n";
+    }
+    
+    std::cout << "\nMatching engine started on port " << server.port() << "\n";
     std::cout << "Endpoints:\n";
     std::cout << "  GET  /health\n";
     std::cout << "  GET  /api/v1/depth/:symbol\n";
@@ -211,11 +481,32 @@ int main(int argc, char* argv[]) {
     std::cout << "\nPress Ctrl+C to stop...\n\n";
     
     // Main loop
+    constexpr Duration SNAPSHOT_INTERVAL_NS = 60'000'000'000;
+    Timestamp last_snapshot = now();
     while (g_running.load(std::memory_order_acquire)) {
         server.poll();
+        if (!ipc_path.empty()) {
+            io.poll(0);
+        }
+        publish_l2();
+        if (journaling && journal.failed()) {
+            // Requests are being refused; restart recovers up to durable_sequence()
+            std::cerr << "Journal write failed after sequence " << journal.durable_sequence()
+                      << ", shutting down\n";
+            break;
+        }
+        if (journaling && now() - last_snapshot >= SNAPSHOT_INTERVAL_NS) {
+            journal.snapshot(engine, snapshot_path);
+            last_snapshot = now();
+        }
     }
     
+    ipc.detach();
     server.stop();
+    if (journaling) {
+        journal.snapshot(engine, snapshot_path);
+        journal.stop();
+    }
     
     // Print final stats
     const auto& stats = engine.stats();
@@ -7,20 +7,43 @@
  * - Rate limiting
  * - Position tracking
  * - Connection to matching engine
+ *
+ * Binary order sessions can be fanned out to matching engine shards:
+ *   order_gateway --ipc /tmp/gateway.sock \
+ *                 --shard /tmp/engine0.sock=BTC-USD,ETH-USD \
+ *                 --shard /tmp/engine1.sock=SOL-USD
+ * Each client on the gateway socket is one session; its responses come
+ * back in submission order whichever shards its orders went to. Binary
+ * sessions are coroutines (order_session below) on one reactor thread;
+ * --cpu N pins that thread. The HTTP routes are served by HttpServer's
+ * own reactor and per-connection parser state, not by CoroSession.
  */
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <cstdlib>
+#include <unordered_map>
+#include <utility>
 #include <iomanip>
 #include <sstream>
 #include <csignal>
 #include <atomic>
-#include <unordered_map>
 
 #include "matching/matching_engine.hpp"
 #include "protocol/rest_handler.hpp"
 #include "protocol/fix_message.hpp"
+#include "protocol/binary_codec.hpp"
 #include "core/cpu_affinity.hpp"
 #include "core/timing.hpp"
+#include "core/tsc_clock.hpp"
+#include "risk/pre_trade_risk.hpp"
+#include "transport/coro_session.hpp"
+#include "transport/ipc_socket.hpp"
+#include "transport/shard_router.hpp"
 
 using namespace hft;
 
@@ -32,117 +55,184 @@ void signal_handler(int signum) {
 }
 
 /**
- * @brief Simple rate limiter
+ * @brief Order Gateway Statistics
  */
-class RateLimiter {
-public:
-    explicit RateLimiter(int max_per_second) 
-        : max_per_second_(max_per_second)
-        , window_start_(now())
-        , count_(0)
-    {}
-
-    bool check() {
-        auto current = now();
-        auto elapsed = current - window_start_;
-        
-        // Reset window every second
-        if (elapsed >= 1'000'000'000) {  // 1 second in nanoseconds
-            window_start_ = current;
-            count_ = 0;
-        }
-        
-        if (count_ >= max_per_second_) {
-            return false;
-        }
-        
-        ++count_;
-        return true;
-    }
-
-private:
-    int max_per_second_;
-    Timestamp window_start_;
-    int count_;
+struct GatewayStats {
+    std::atomic<std::uint64_t> orders_received{0};
+    std::atomic<std::uint64_t> orders_accepted{0};
+    std::atomic<std::uint64_t> orders_rejected{0};
+    std::atomic<std::uint64_t> rate_limited{0};
+    std::atomic<std::uint64_t> risk_rejected{0};
 };
 
 /**
- * @brief Position tracker for risk management
+ * @brief Pre-trade risk for binary orders routed to engine shards
+ *
+ * A new order is checked and its quantity booked open before it is
+ * routed; the one response its shard sends back moves the immediate fill
+ * to the net position and releases whatever will not rest. Leaves stay
+ * open until a cancel is confirmed: shards do not report later passive
+ * fills, so a resting order counts against the limits until then.
  */
-class PositionTracker {
+class SessionRisk {
 public:
-    struct Position {
-        Quantity net_position = 0;
-        Quantity open_buy_orders = 0;
-        Quantity open_sell_orders = 0;
-        Quantity max_position = 10000;
-    };
+    SessionRisk(PreTradeRisk& risk, const MatchingEngine& engine, AccountId account)
+        : risk_(risk), engine_(engine), account_(account) {}
 
-    bool check_order(const Symbol& symbol, Side side, Quantity quantity) {
-        std::string sym(symbol_view(symbol));
-        auto& pos = positions_[sym];
-        
-        Quantity potential_position;
-        if (side == Side::BUY) {
-            potential_position = pos.net_position + quantity + pos.open_buy_orders;
-        } else {
-            potential_position = pos.net_position - quantity - pos.open_sell_orders;
+    /**
+     * @brief Check a new order and book it open if accepted
+     */
+    [[nodiscard]] RiskResult accept(SessionId session, const OrderPacket& packet) {
+        Symbol symbol{};
+        std::memcpy(symbol.data(), packet.symbol, std::min(sizeof(packet.symbol), symbol.size()));
+        const InstrumentId instrument = engine_.find_instrument(symbol).value_or(INVALID_INSTRUMENT_ID);
+        const Side side = packet.side == 0 ? Side::BUY : Side::SELL;
+
+        const RiskResult verdict = risk_.check(account_, instrument, side, packet.price, packet.quantity);
+        if (verdict == RiskResult::ACCEPTED) {
+            risk_.on_order_accepted(account_, instrument, side, packet.price, packet.quantity);
+            open_[ShardedOrderRouter::shard_order_id(session, packet.client_order_id)] =
+                {instrument, side, packet.price, packet.quantity, false};
         }
-        
-        return std::abs(potential_position) <= pos.max_position;
+        return verdict;
     }
 
-    void on_order_accepted(const Symbol& symbol, Side side, Quantity quantity) {
-        std::string sym(symbol_view(symbol));
-        auto& pos = positions_[sym];
-        
-        if (side == Side::BUY) {
-            pos.open_buy_orders += quantity;
-        } else {
-            pos.open_sell_orders += quantity;
-        }
+    /**
+     * @brief Release an accepted order the router will never answer
+     */
+    void release(SessionId session, const OrderPacket& packet) {
+        auto it = open_.find(ShardedOrderRouter::shard_order_id(session, packet.client_order_id));
+        if (it == open_.end()) return;
+        release(it->second, it->second.open);
+        open_.erase(it);
     }
 
-    void on_fill(const Symbol& symbol, Side side, Quantity quantity) {
-        std::string sym(symbol_view(symbol));
-        auto& pos = positions_[sym];
-        
-        if (side == Side::BUY) {
-            pos.net_position += quantity;
-            pos.open_buy_orders -= quantity;
-        } else {
-            pos.net_position -= quantity;
-            pos.open_sell_orders -= quantity;
+    /**
+     * @brief Apply a shard's answer to a new order or to its cancel
+     */
+    void on_response(SessionId session, const OrderResponsePacket& response) {
+        auto it = open_.find(ShardedOrderRouter::shard_order_id(session, response.client_order_id));
+        if (it == open_.end()) return;
+        OpenOrder& order = it->second;
+
+        if (order.acked) {
+            // Cancel answered: only a confirmed cancel frees the leaves
+            if (response.status != STATUS_CANCELLED) return;
+        } else if (response.status != ShardedOrderRouter::STATUS_REJECTED) {
+            order.acked = true;
+            if (response.fill_quantity > 0) {
+                // The order booked its limit price, whatever it traded at
+                risk_.on_fill({account_, order.instrument, order.side, order.price,
+                               response.fill_quantity});
+            }
+            // Market remainders and unfilled IOC quantity do not rest
+            release(order, order.open - response.fill_quantity - response.leaves_quantity);
+            order.open = response.leaves_quantity;
+            if (order.open > 0) return;
         }
+        release(order, order.open);
+        open_.erase(it);
     }
 
-    Position get_position(const Symbol& symbol) const {
-        std::string sym(symbol_view(symbol));
-        auto it = positions_.find(sym);
-        if (it != positions_.end()) {
-            return it->second;
+private:
+    static constexpr std::uint8_t STATUS_CANCELLED = 3;
+
+    struct OpenOrder {
+        InstrumentId instrument;
+        Side side;
+        Price price;
+        Quantity open;
+        bool acked;         // The new order's own response has been applied
+    };
+
+    void release(const OpenOrder& order, Quantity quantity) noexcept {
+        if (quantity > 0) {
+            risk_.on_order_released(account_, order.instrument, order.side, order.price, quantity);
         }
-        return Position{};
     }
 
-private:
-    std::unordered_map<std::string, Position> positions_;
+    PreTradeRisk& risk_;
+    const MatchingEngine& engine_;
+    AccountId account_;
+    std::unordered_map<std::uint64_t, OpenOrder> open_;     // By shard order id
 };
 
 /**
- * @brief Order Gateway Statistics
+ * @brief One binary client: orders in, routed to the engine shards
+ *
+ * Responses are written by the shard router's callback as they come back;
+ * fd_of maps the router session to this connection for it.
  */
-struct GatewayStats {
-    std::atomic<std::uint64_t> orders_received{0};
-    std::atomic<std::uint64_t> orders_accepted{0};
-    std::atomic<std::uint64_t> orders_rejected{0};
-    std::atomic<std::uint64_t> rate_limited{0};
-    std::atomic<std::uint64_t> risk_rejected{0};
-};
+SessionTask order_session(CoroSession& session, ShardedOrderRouter& shards,
+                          TokenBucket& rate_limiter, SessionRisk& risk, GatewayStats& stats,
+                          std::vector<int>& fd_of) {
+    const SessionId id = shards.open_session();
+    if (fd_of.size() <= id) fd_of.resize(id + 1);
+    fd_of[id] = session.fd();
+    
+    while (auto packet = co_await session.read_message<OrderPacket>()) {
+        ++stats.orders_received;
+        
+        // A session with SESSION_WINDOW orders unanswered has no slot to
+        // be answered in order (WINDOW_FULL); such orders go unanswered
+        if (!rate_limiter.try_acquire()) {
+            ++stats.rate_limited;
+            shards.reject(id, *packet);
+            continue;
+        }
+        
+        // New orders pass the same limits as the HTTP routes; cancels
+        // only ever reduce exposure
+        if (packet->action == 0) {
+            const RiskResult verdict = risk.accept(id, *packet);
+            if (verdict != RiskResult::ACCEPTED) {
+                if (verdict == RiskResult::UNKNOWN_INSTRUMENT) {
+                    ++stats.orders_rejected;
+                } else {
+                    ++stats.risk_rejected;
+                }
+                shards.reject(id, *packet);
+                continue;
+            }
+        }
+        
+        // A REJECTED route has already been answered through the callback
+        const RouteResult routed = shards.submit(id, *packet);
+        if (routed == RouteResult::ROUTED) {
+            ++stats.orders_accepted;
+        } else {
+            if (routed != RouteResult::REJECTED && packet->action == 0) {
+                risk.release(id, *packet);
+            }
+            ++stats.orders_rejected;
+        }
+    }
+    shards.close_session(id);
+}
 
 int main(int argc, char* argv[]) {
-    (void)argc;
-    (void)argv;
+    // Calibrate fast_now() before any thread is pinned (see tsc_clock.hpp)
+    hft::TscClock::instance();
+    
+    std::string ipc_path;
+    int cpu = -1;
+    std::vector<std::pair<std::string, std::string>> shard_args;   // path, symbols
+    for (int i = 1; i + 1 < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--ipc") {
+            ipc_path = argv[++i];
+        } else if (arg == "--cpu") {
+            cpu = std::atoi(argv[++i]);
+        } else if (arg == "--shard") {
+            const std::string_view spec = argv[++i];
+            const auto eq = spec.find('=');
+            if (eq == std::string_view::npos) {
+                std::cerr << "Expected --shard PATH=SYMBOL[,SYMBOL...], got " << spec << "\n";
+                return 1;
+            }
+            shard_args.emplace_back(spec.substr(0, eq), spec.substr(eq + 1));
+        }
+    }
     
     std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
     std::cout << "║                HFT Order Gateway Server v1.0                  ║\n";
@@ -155,13 +245,13 @@ int main(int argc, char* argv[]) {
     ThreadConfig config;
     config.priority = ThreadPriority::HIGH;
     config.lock_memory = true;
+    config.cpu_core = cpu;
     config.name = "gateway-main";
     apply_thread_config(config);
     
     // Create components
     MatchingEngine engine;
-    RateLimiter rate_limiter(1000);  // 1000 orders/sec
-    PositionTracker positions;
+    TokenBucket rate_limiter(1000.0);  // 1000 orders/sec, bursts of up to 1000
     GatewayStats stats;
     LatencyStats latency_stats(100000);
     
@@ -178,11 +268,47 @@ int main(int argc, char* argv[]) {
         std::cout << "  + " << symbol_view(sym) << "\n";
     }
     
-    // Set up execution callback
+    // Pre-trade risk: the gateway trades as one account, and instrument
+    // handles from the engine index the position slots directly
+    constexpr AccountId GATEWAY_ACCOUNT = 0;
+    PreTradeRisk risk(instruments.size());
+    
+    // Fills are collected while an order matches and applied to the risk
+    // counters in one batch once submit_order() returns
+    struct ActiveOrder {
+        OrderId order_id = INVALID_ORDER_ID;
+        InstrumentId instrument = INVALID_INSTRUMENT_ID;
+        Side side = Side::BUY;
+        Price price = 0;
+        Quantity quantity = 0;
+    } active;
+    std::vector<RiskFill> fills;
+    fills.reserve(256);
+    
     engine.set_execution_callback([&](const ExecutionReport& report) {
-        if (report.exec_type == ExecutionType::TRADE) {
-            // Update position on fill
-            // positions.on_fill(...);
+        switch (report.exec_type) {
+            case ExecutionType::NEW:
+                active.order_id = report.order_id;
+                break;
+            case ExecutionType::TRADE: {
+                // The incoming order booked its limit price; resting
+                // orders booked the price they trade at
+                const bool aggressor = report.order_id == active.order_id;
+                fills.push_back({GATEWAY_ACCOUNT, active.instrument, report.side,
+                                 aggressor ? active.price : report.execution_price,
+                                 report.execution_quantity});
+                break;
+            }
+            case ExecutionType::CANCELLED:
+                // Remainder of the incoming order that will not rest
+                if (report.order_id == active.order_id) {
+                    risk.on_order_released(GATEWAY_ACCOUNT, active.instrument, active.side,
+                                           active.price,
+                                           active.quantity - report.cumulative_quantity);
+                }
+                break;
+            default:
+                break;
         }
     });
     
@@ -196,13 +322,57 @@ int main(int argc, char* argv[]) {
         return HttpResponse(HttpStatus::OK).json(R"({"status":"healthy"})");
     });
     
+    /**
+     * Validation + submission shared by the JSON and binary order routes
+     */
+    struct SubmitResult {
+        HttpStatus status;
+        OrderId order_id;
+        std::string_view reject_reason;
+    };
+    
+    auto submit_checked = [&](InstrumentId instrument, Side side, OrderType type,
+                              Price price, Quantity quantity) -> SubmitResult {
+        // Instrument, size, position and notional limits
+        const RiskResult verdict = risk.check(GATEWAY_ACCOUNT, instrument, side, price, quantity);
+        if (verdict != RiskResult::ACCEPTED) {
+            if (verdict == RiskResult::UNKNOWN_INSTRUMENT) {
+                ++stats.orders_rejected;
+            } else {
+                ++stats.risk_rejected;
+            }
+            return {HttpStatus::BAD_REQUEST, INVALID_ORDER_ID, to_string(verdict)};
+        }
+        
+        // Book the open quantity before matching so fills can draw it down
+        risk.on_order_accepted(GATEWAY_ACCOUNT, instrument, side, price, quantity);
+        active = {INVALID_ORDER_ID, instrument, side, price, quantity};
+        fills.clear();
+        
+        // Submit to matching engine
+        OrderId order_id = engine.submit_order(instrument, side, type, price, quantity);
+        risk.apply_fills(fills);
+        if (order_id == INVALID_ORDER_ID) {
+            risk.on_order_released(GATEWAY_ACCOUNT, instrument, side, price, quantity);
+            ++stats.orders_rejected;
+            return {HttpStatus::BAD_REQUEST, INVALID_ORDER_ID, "Order rejected by engine"};
+        }
+        
+        ++stats.orders_accepted;
+        return {HttpStatus::CREATED, order_id, {}};
+    };
+    
+    auto resolve = [&engine](const Symbol& symbol) {
+        return engine.find_instrument(symbol).value_or(INVALID_INSTRUMENT_ID);
+    };
+    
     // Submit order with validation
     router.post("/api/v1/order", [&](const HttpRequest& req) {
         auto start = now();
         ++stats.orders_received;
         
         // Rate limit check
-        if (!rate_limiter.check()) {
+        if (!rate_limiter.try_acquire()) {
             ++stats.rate_limited;
             return HttpResponse(HttpStatus::TOO_MANY_REQUESTS)
                 .json(json_response::order_rejected("Rate limit exceeded"));
@@ -216,60 +386,83 @@ int main(int argc, char* argv[]) {
                 .json(json_response::error("Invalid order request", "INVALID_ORDER"));
         }
         
-        Symbol symbol = make_symbol(order_req->symbol);
-        
-        // Validate instrument
-        if (!engine.get_book(symbol)) {
-            ++stats.orders_rejected;
-            return HttpResponse(HttpStatus::BAD_REQUEST)
-                .json(json_response::order_rejected("Unknown symbol"));
+        auto result = submit_checked(resolve(make_symbol(order_req->symbol)), order_req->side,
+                                     order_req->type, to_fixed_price(order_req->price),
+                                     static_cast<Quantity>(order_req->quantity));
+        if (result.order_id == INVALID_ORDER_ID) {
+            return HttpResponse(result.status)
+                .json(json_response::order_rejected(result.reject_reason));
         }
         
-        // Position/risk check
-        if (!positions.check_order(symbol, order_req->side, 
-                                   static_cast<Quantity>(order_req->quantity))) {
-            ++stats.risk_rejected;
-            return HttpResponse(HttpStatus::BAD_REQUEST)
-                .json(json_response::order_rejected("Position limit exceeded"));
-        }
+        // Track latency
+        latency_stats.add_sample(now() - start);
         
-        // Submit to matching engine
-        OrderId order_id = engine.submit_order(
-            symbol,
-            order_req->side,
-            order_req->type,
-            to_fixed_price(order_req->price),
-            static_cast<Quantity>(order_req->quantity)
-        );
+        return HttpResponse(HttpStatus::CREATED)
+            .json(json_response::order_accepted(result.order_id, order_req->symbol));
+    });
+    
+    // Submit order, binary session protocol (sbe::NewOrder in,
+    // sbe::ExecReport out): no text decoding, prices stay fixed-point
+    std::array<char, sbe::Encoder<sbe::ExecReport>::ENCODED_LENGTH> binary_response;
+    router.post("/api/v1/order/binary", [&](const HttpRequest& req) {
+        auto start = now();
+        ++stats.orders_received;
         
-        if (order_id == INVALID_ORDER_ID) {
-            ++stats.orders_rejected;
-            return HttpResponse(HttpStatus::BAD_REQUEST)
-                .json(json_response::order_rejected("Order rejected by engine"));
-        }
+        using F = sbe::NewOrderField;
+        sbe::Decoder<sbe::NewOrder> order(std::span<const char>(req.body.data(), req.body.size()));
         
-        // Track position
-        positions.on_order_accepted(symbol, order_req->side,
-                                    static_cast<Quantity>(order_req->quantity));
-        ++stats.orders_accepted;
+        ExecutionReport report{};
+        report.timestamp = start;
+        report.exec_type = ExecutionType::REJECTED;
+        report.order_status = OrderStatus::REJECTED;
+        HttpStatus status = HttpStatus::BAD_REQUEST;
         
-        // Track latency
-        latency_stats.add_sample(now() - start);
+        if (!rate_limiter.try_acquire()) {
+            ++stats.rate_limited;
+            status = HttpStatus::TOO_MANY_REQUESTS;
+        } else if (!sbe::valid_new_order(order)) {
+            // Truncated, or enums / quantity / price out of range
+            if (order.ok()) report.client_id = order.get<F::CLIENT_ORDER_ID>();
+            ++stats.orders_rejected;
+        } else {
+            report.client_id = order.get<F::CLIENT_ORDER_ID>();
+            report.side = order.get<F::SIDE>();
+            report.execution_price = order.get<F::PRICE>();
+            report.leaves_quantity = order.get<F::QUANTITY>();
+            
+            // Sessions that know the instrument handle skip the symbol lookup
+            InstrumentId instrument = order.get<F::INSTRUMENT>();
+            if (instrument >= risk.instrument_count()) {
+                instrument = resolve(order.get<F::SYMBOL>());
+            }
+            
+            auto result = submit_checked(instrument, report.side,
+                                         order.get<F::ORDER_TYPE>(), report.execution_price,
+                                         report.leaves_quantity);
+            status = result.status;
+            if (result.order_id != INVALID_ORDER_ID) {
+                report.order_id = result.order_id;
+                report.exec_type = ExecutionType::NEW;
+                report.order_status = OrderStatus::NEW;
+                latency_stats.add_sample(now() - start);
+            }
+        }
         
-        return HttpResponse(HttpStatus::CREATED)
-            .json(json_response::order_accepted(order_id, order_req->symbol));
+        const auto len = sbe::encode_execution_report(binary_response, report);
+        return HttpResponse(status)
+            .content_type("application/octet-stream")
+            .body(std::string_view(binary_response.data(), len));
     });
     
     // Get position
-    router.get("/api/v1/position/:symbol", [&positions](const HttpRequest& req) {
+    router.get("/api/v1/position/:symbol", [&](const HttpRequest& req) {
         auto symbol_param = req.get_path_param("symbol");
         if (!symbol_param) {
             return HttpResponse(HttpStatus::BAD_REQUEST)
                 .json(json_response::error("Missing symbol", "INVALID_REQUEST"));
         }
         
-        Symbol symbol = make_symbol(*symbol_param);
-        auto pos = positions.get_position(symbol);
+        auto pos = risk.get_position(GATEWAY_ACCOUNT, resolve(make_symbol(*symbol_param)));
         
         std::ostringstream ss;
         ss << R"({"symbol":")" << *symbol_param
@@ -305,12 +498,50 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    // Binary sessions routed to engine shards, all on this thread
+    Reactor io;
+    IPCSocketServer sessions(ipc_path);
+    SessionHost host(io);
+    std::vector<int> fd_of;                            // Session -> client fd
+    SessionRisk session_risk(risk, engine, GATEWAY_ACCOUNT);
+    ShardedOrderRouter shards([&](SessionId session, const OrderResponsePacket& response) {
+        session_risk.on_response(session, response);
+        if (CoroSession* client = host.find(fd_of[session])) {
+            client->send(response);
+        }
+    });
+    
+    if (!ipc_path.empty()) {
+        for (const auto& [path, symbol_list] : shard_args) {
+            const std::size_t shard = shards.add_shard(path);
+            std::string_view rest = symbol_list;
+            while (!rest.empty()) {
+                const auto comma = rest.find(',');
+                shards.assign(make_symbol(rest.substr(0, comma)), shard);
+                rest = comma == std::string_view::npos ? std::string_view{} : rest.substr(comma + 1);
+            }
+        }
+        
+        const bool ready = io.init() && sessions.init() &&
+            host.listen(sessions.listen_fd(), [&](CoroSession& session) {
+                return order_session(session, shards, rate_limiter, session_risk, stats, fd_of);
+            });
+        if (!ready || !shards.connect(io)) {
+            std::cerr << "Failed to start order sessions on " << ipc_path
+                      << " or to reach every engine shard\n";
+            return 1;
+        }
+        std::cout << "\nOrder sessions on " << ipc_path << ", "
+                  << shards.shard_count() << " engine shard(s)\n";
+    }
+    
     std::cout << "\nOrder gateway started on port " << PORT << "\n";
     std::cout << "Rate limit: 1000 orders/sec\n";
     std::cout << "Max position per symbol: 10000\n";
     std::cout << "\nEndpoints:\n";
     std::cout << "  GET  /health\n";
     std::cout << "  POST /api/v1/order\n";
+    std::cout << "  POST /api/v1/order/binary\n";
     std::cout << "  GET  /api/v1/position/:symbol\n";
     std::cout << "  GET  /api/v1/stats\n";
     std::cout << "\nPress Ctrl+C to stop...\n\n";
@@ -318,8 +549,14 @@ int main(int argc, char* argv[]) {
     // Main loop
     while (g_running.load(std::memory_order_acquire)) {
         server.poll();
+        if (!ipc_path.empty()) {
+            io.poll(0);
+            host.flush();
+            shards.flush();
+        }
     }
     
+    host.close_all();
     server.stop();
     
     // Print final stats
@@ -3,27 +3,46 @@
  * @brief Performance benchmark suite for HFT system components
  * 
  * Measures latency and throughput of critical system components:
- * - Lock-free queue operations
- * - Memory pool allocation
+ * - Lock-free queue operations (SPSC and MPMC)
+ * - Memory pool allocation (and cross-thread alloc/free contention)
+ * - Read-mostly data: RWSpinlock vs SeqLock vs RCU with 1-32 readers
  * - Order book operations
  * - Matching engine throughput
+ * - Execution report fan-out: consumers chained in the callback vs on ExecReportBus
+ * - Scenario-driven order book workloads per backend
+ *
+ * Usage: benchmark_suite [--scenarios] [--json <file>]
+ *   --scenarios    Run only the scenario benchmarks
+ *   --json <file>  Also write the scenario results as JSON
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <iostream>
 #include <iomanip>
 #include <vector>
 #include <thread>
 #include <chrono>
 #include <random>
+#include <cstring>
 
 #include "core/types.hpp"
 #include "core/lockfree_queue.hpp"
 #include "core/memory_pool.hpp"
+#include "core/slab_allocator.hpp"
+#include "core/busy_poll.hpp"
 #include "core/timing.hpp"
+#include "core/tsc_clock.hpp"
 #include "core/cpu_affinity.hpp"
+#include "core/perf_counters.hpp"
+#include "core/rcu.hpp"
+#include "core/seqlock.hpp"
+#include "core/spinlock.hpp"
 #include "matching/order.hpp"
 #include "matching/order_book.hpp"
 #include "matching/matching_engine.hpp"
+#include "transport/exec_report_bus.hpp"
 
 using namespace hft;
 
@@ -31,6 +50,7 @@ using namespace hft;
 void run_latency_benchmarks();
 void run_throughput_benchmarks();
 void run_orderbook_benchmarks();
+void run_scenario_benchmarks(const char* json_path);
 
 /**
  * @brief Print system information
@@ -111,6 +131,76 @@ void benchmark_spsc_queue() {
               << (throughput / 1e6) << " million ops/sec\n";
 }
 
+/**
+ * @brief Benchmark bounded MPMC ring (multi-producer fan-in)
+ */
+void benchmark_mpmc_queue() {
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    std::cout << "MPMC Queue Benchmark\n";
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    
+    constexpr std::size_t QUEUE_SIZE = 65536;
+    constexpr std::size_t NUM_PRODUCERS = 2;
+    constexpr std::size_t ITEMS_PER_PRODUCER = 2'000'000;
+    constexpr std::size_t TOTAL_ITEMS = NUM_PRODUCERS * ITEMS_PER_PRODUCER;
+    constexpr std::size_t BATCH = 32;
+    
+    auto run = [&](bool batched) {
+        MPMCQueue<std::uint64_t, QUEUE_SIZE> queue;
+        
+        auto start_time = std::chrono::steady_clock::now();
+        
+        std::vector<std::thread> producers;
+        for (std::size_t p = 0; p < NUM_PRODUCERS; ++p) {
+            producers.emplace_back([&, p]() {
+                set_cpu_affinity(static_cast<int>(p));
+                std::uint64_t items[BATCH];
+                std::size_t sent = 0;
+                while (sent < ITEMS_PER_PRODUCER) {
+                    if (batched) {
+                        const std::size_t n = std::min(BATCH, ITEMS_PER_PRODUCER - sent);
+                        for (std::size_t k = 0; k < n; ++k) items[k] = sent + k;
+                        std::size_t done = 0;
+                        while (done < n) done += queue.try_push_n(items + done, n - done);
+                        sent += n;
+                    } else {
+                        queue.push(sent++);
+                    }
+                }
+            });
+        }
+        
+        std::thread consumer([&]() {
+            set_cpu_affinity(static_cast<int>(NUM_PRODUCERS));
+            std::uint64_t items[BATCH];
+            std::size_t received = 0;
+            while (received < TOTAL_ITEMS) {
+                if (batched) {
+                    received += queue.try_pop_n(items, BATCH);
+                } else if (queue.try_pop()) {
+                    ++received;
+                }
+            }
+        });
+        
+        for (auto& t : producers) t.join();
+        consumer.join();
+        
+        auto elapsed = std::chrono::steady_clock::now() - start_time;
+        double secs = std::chrono::duration<double>(elapsed).count();
+        
+        std::cout << "\n" << (batched ? "Batched (32)" : "Single") << " - "
+                  << NUM_PRODUCERS << " producers / 1 consumer:\n";
+        std::cout << "  Throughput: " << std::fixed << std::setprecision(2)
+                  << (TOTAL_ITEMS / secs / 1e6) << " million ops/sec\n";
+        std::cout << "  Per item:   " << std::setprecision(1)
+                  << (secs * 1e9 / TOTAL_ITEMS) << " ns\n";
+    };
+    
+    run(false);
+    run(true);
+}
+
 /**
  * @brief Benchmark memory pool
  */
@@ -184,6 +274,192 @@ void benchmark_memory_pool() {
               << (delete_stats.mean() / dealloc_stats.mean()) << "x (dealloc)\n";
 }
 
+/**
+ * @brief Allocate on one thread, free on another (engine -> gateway shape)
+ *
+ * @param make Producer-side allocation, returns nullptr when exhausted
+ * @param free Consumer-side release
+ * @param idle Consumer hook when the hand-off queue is empty
+ * @return Million alloc/free pairs per second
+ */
+template<typename Alloc, typename Free, typename Idle>
+double run_cross_thread_alloc(std::size_t count, Alloc&& make, Free&& free, Idle&& idle) {
+    SPSCQueue<Order*, 4096> handoff;
+    
+    auto start = now();
+    std::thread consumer([&]() {
+        set_cpu_affinity(1);
+        for (std::size_t i = 0; i < count; ) {
+            if (auto order = handoff.try_pop()) {
+                free(*order);
+                ++i;
+            } else {
+                idle();
+            }
+        }
+    });
+    
+    set_cpu_affinity(0);
+    for (std::size_t i = 0; i < count; ++i) {
+        Order* order;
+        while ((order = make(i)) == nullptr) {
+            std::this_thread::yield();
+        }
+        while (!handoff.try_push(order)) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    auto elapsed = now() - start;
+    
+    return static_cast<double>(count) / (static_cast<double>(elapsed) / 1e9) / 1e6;
+}
+
+/**
+ * @brief Spinlock pool vs thread-caching slab under cross-thread frees
+ */
+void benchmark_allocator_contention() {
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    std::cout << "Allocator Contention Benchmark\n";
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    
+    constexpr std::size_t NUM_ITEMS = 5'000'000;
+    const Price price = to_fixed_price(100.0);
+    
+    ThreadSafeMemoryPool<Order, 65536> locked_pool;
+    const double locked = run_cross_thread_alloc(NUM_ITEMS,
+        [&](std::size_t i) { return locked_pool.create(i, Side::BUY, OrderType::LIMIT, price, 100); },
+        [&](Order* order) { locked_pool.destroy(order); },
+        [] { cpu_pause(); });
+    
+    SlabAllocator<Order> slab;
+    auto producer_cache = slab.attach();
+    SlabAllocator<Order>::Cache consumer_cache;
+    bool attached = false;
+    const double slab_rate = run_cross_thread_alloc(NUM_ITEMS,
+        [&](std::size_t i) { return producer_cache.create(i, Side::BUY, OrderType::LIMIT, price, 100); },
+        [&](Order* order) {
+            if (!attached) {
+                consumer_cache = slab.attach();
+                attached = true;
+            }
+            consumer_cache.destroy(order);
+        },
+        [&] {
+            if (attached) consumer_cache.flush();
+            cpu_pause();
+        });
+    consumer_cache.detach();
+    
+    std::cout << "\nAlloc on producer, free on consumer (" << NUM_ITEMS / 1'000'000 << "M orders):\n";
+    std::cout << "  ThreadSafeMemoryPool: " << std::fixed << std::setprecision(2)
+              << locked << " M ops/sec\n";
+    std::cout << "  SlabAllocator:        " << slab_rate << " M ops/sec ("
+              << slab.chunk_count() << " chunks)\n";
+}
+
+/**
+ * @brief Reference data readers against one slow writer
+ *
+ * Every reader takes a consistent copy of the limits per read; the writer
+ * replaces them every millisecond. Aggregate reads/sec per primitive as
+ * reader threads are added.
+ */
+void benchmark_read_mostly() {
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    std::cout << "Read-Mostly Data Benchmark\n";
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    
+    struct Limits {
+        Quantity max_order_quantity;
+        Quantity max_position;
+        Price price_band;
+        Price max_notional;
+        std::uint64_t version;
+        std::uint64_t pad[3];
+    };
+    constexpr auto RUN_TIME = std::chrono::milliseconds(100);
+    constexpr auto WRITE_INTERVAL = std::chrono::milliseconds(1);
+    
+    // read(Limits&) per read; write(const Limits&) from the writer thread
+    auto run = [&](std::size_t readers, auto&& read, auto&& write, auto&& make_reader) {
+        std::atomic<bool> stop{false};
+        std::atomic<std::size_t> ready{0};
+        std::vector<std::uint64_t> counts(readers);
+        std::vector<std::thread> threads;
+        for (std::size_t r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r] {
+                auto context = make_reader();
+                std::uint64_t reads = 0;
+                Quantity sink = 0;
+                ready.fetch_add(1);
+                while (!stop.load(std::memory_order_relaxed)) {
+                    for (int i = 0; i < 256; ++i) {
+                        Limits copy;
+                        read(context, copy);
+                        sink += copy.max_order_quantity;
+                    }
+                    reads += 256;
+                }
+                asm volatile("" : : "r"(sink));
+                counts[r] = reads;
+            });
+        }
+        while (ready.load() < readers) std::this_thread::yield();
+        const auto start = std::chrono::steady_clock::now();
+        Limits next{100, 1000, 50, 1'000'000, 0, {}};
+        while (std::chrono::steady_clock::now() - start < RUN_TIME) {
+            std::this_thread::sleep_for(WRITE_INTERVAL);
+            ++next.version;
+            write(next);
+        }
+        stop.store(true);
+        for (auto& t : threads) t.join();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::uint64_t total = 0;
+        for (auto c : counts) total += c;
+        return static_cast<double>(total) / seconds / 1e6;
+    };
+    
+    struct NoContext {};
+    RWSpinlock rw_lock;
+    Limits rw_value{100, 1000, 50, 1'000'000, 0, {}};
+    SeqLock<Limits> seq_value(rw_value);
+    RcuDomain domain;
+    RcuPtr<Limits> rcu_value(domain, std::make_unique<Limits>(rw_value));
+    
+    std::cout << "\nConsistent reads, one writer every 1 ms (M reads/sec, all readers):\n";
+    std::cout << "  Readers |  RWSpinlock |     SeqLock |         RCU\n";
+    std::cout << "  --------+-------------+-------------+------------\n";
+    for (std::size_t readers : {1, 2, 4, 8, 16, 32}) {
+        const double rw = run(readers,
+            [&](NoContext&, Limits& out) {
+                SharedLockGuard guard(rw_lock);
+                out = rw_value;
+            },
+            [&](const Limits& value) {
+                rw_lock.lock();
+                rw_value = value;
+                rw_lock.unlock();
+            },
+            [] { return NoContext{}; });
+        const double seq = run(readers,
+            [&](NoContext&, Limits& out) { seq_value.load(out); },
+            [&](const Limits& value) { seq_value.store(value); },
+            [] { return NoContext{}; });
+        const double rcu = run(readers,
+            [&](std::unique_ptr<RcuReader>& reader, Limits& out) {
+                RcuReadGuard guard(*reader);
+                out = *rcu_value.load();
+            },
+            [&](const Limits& value) { rcu_value.update(std::make_unique<Limits>(value)); },
+            [&] { return std::make_unique<RcuReader>(domain); });
+        std::cout << "  " << std::setw(7) << readers << " | " << std::fixed << std::setprecision(2)
+                  << std::setw(11) << rw << " | " << std::setw(11) << seq << " | "
+                  << std::setw(11) << rcu << "\n";
+    }
+}
+
 /**
  * @brief Benchmark order book operations
  */
@@ -202,6 +478,13 @@ void benchmark_order_book() {
     LatencyStats match_stats(NUM_ORDERS);
     LatencyStats cancel_stats(NUM_ORDERS);
     
+    // Read around each operation, outside its now() pair
+    PerfCounters counters;
+    counters.open();
+    PerfCounterStats add_counters;
+    PerfCounterStats cancel_counters;
+    PerfCounterStats match_counters;
+    
     std::vector<OrderId> order_ids;
     order_ids.reserve(NUM_ORDERS);
     
@@ -215,15 +498,18 @@ void benchmark_order_book() {
         
         Order order(id_gen.next(), side, OrderType::LIMIT, price, 100);
         
+        const auto before = counters.read();
         auto start = now();
         book.add_order(order);
         auto elapsed = now() - start;
+        add_counters.add(counters.read() - before);
         add_stats.add_sample(elapsed);
         order_ids.push_back(order.order_id);
     }
     
     std::cout << "\nAdd Order Latency (no matching):\n";
     add_stats.print_summary("  ");
+    add_counters.print(counters, "  Hardware");
     
     auto stats = book.get_stats();
     std::cout << "\nBook Statistics:\n";
@@ -233,14 +519,17 @@ void benchmark_order_book() {
     
     // Cancel orders
     for (auto order_id : order_ids) {
+        const auto before = counters.read();
         auto start = now();
         book.cancel_order(order_id);
         auto elapsed = now() - start;
+        cancel_counters.add(counters.read() - before);
         cancel_stats.add_sample(elapsed);
     }
     
     std::cout << "\nCancel Order Latency:\n";
     cancel_stats.print_summary("  ");
+    cancel_counters.print(counters, "  Hardware");
     
     // Matching benchmark
     book.clear();
@@ -256,13 +545,16 @@ void benchmark_order_book() {
         Order aggressor(id_gen.next(), Side::SELL, OrderType::LIMIT,
                        base_price - 1, 100);
         
+        const auto before = counters.read();
         auto start = now();
         book.add_order(aggressor);
         auto elapsed = now() - start;
+        match_counters.add(counters.read() - before);
         match_stats.add_sample(elapsed);
     }
     
     match_stats.print_summary("  ");
+    match_counters.print(counters, "  Hardware");
     
     stats = book.get_stats();
     std::cout << "  Trades Matched: " << stats.trades_matched << "\n";
@@ -311,7 +603,12 @@ void benchmark_matching_engine() {
     std::uniform_int_distribution<> sym_dist(0, symbols.size() - 1);
     std::uniform_int_distribution<> side_dist(0, 1);
     
+    PerfCounters counters;
+    counters.open();
+    PerfCounterStats engine_counters;
+    
     auto start_time = std::chrono::steady_clock::now();
+    const auto counters_start = counters.read();
     
     for (std::size_t i = 0; i < NUM_ORDERS; ++i) {
         const auto& sym = symbols[sym_dist(gen)];
@@ -323,6 +620,7 @@ void benchmark_matching_engine() {
         engine.submit_order(sym, side, OrderType::LIMIT, price, 10);
     }
     
+    engine_counters.add(counters.read() - counters_start, NUM_ORDERS);
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration<double>(end_time - start_time).count();
     
@@ -343,24 +641,131 @@ void benchmark_matching_engine() {
     std::cout << "  P99:   " << percentiles.p99 << " ns\n";
     std::cout << "  P99.9: " << percentiles.p999 << " ns\n";
     std::cout << "  Max:   " << latency.max() << " ns\n";
+    
+    // Whole loop, order generation included
+    std::cout << "\n";
+    engine_counters.print(counters, "Engine");
+}
+
+/**
+ * @brief Engine latency with N report consumers inline vs reading a bus
+ *
+ * Each consumer formats an audit line per report, roughly what a drop
+ * copy or log writer costs. Inline, that lands on every order; on the bus,
+ * the engine pays one slot write whatever N is.
+ */
+void benchmark_exec_fanout() {
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    std::cout << "Execution Report Fan-out (per-order engine latency)\n";
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    
+    constexpr std::size_t NUM_ORDERS = 50'000;
+    const Symbol symbol = make_symbol("BTC-USD");
+    
+    auto consume = [](const ExecutionReport& report, std::uint64_t& sink) {
+        char line[128];
+        const int n = std::snprintf(line, sizeof(line), "%llu,%llu,%lld,%lld,%d",
+                                    static_cast<unsigned long long>(report.order_id),
+                                    static_cast<unsigned long long>(report.contra_order_id),
+                                    static_cast<long long>(report.execution_price),
+                                    static_cast<long long>(report.execution_quantity),
+                                    static_cast<int>(report.exec_type));
+        sink += static_cast<std::uint64_t>(n) + static_cast<unsigned char>(line[0]);
+    };
+    
+    auto run_test = [&](std::size_t consumers, bool use_bus) {
+        MatchingEngine engine;
+        engine.add_instrument(symbol);
+        ExecReportBus bus;
+        std::vector<std::uint64_t> sinks(consumers, 0);
+        std::atomic<bool> done{false};
+        std::vector<std::thread> readers;
+        
+        if (use_bus) {
+            if (!bus.init()) return;
+            engine.set_execution_callback([&bus](const ExecutionReport& r) { bus.publish(r); });
+            for (std::size_t c = 0; c < consumers; ++c) {
+                readers.emplace_back([&, c]() {
+                    ExecReportReader reader(bus);
+                    IdleStrategy idle(PollMode::BALANCED);
+                    while (!done.load(std::memory_order_acquire)) {
+                        idle.idle(reader.poll([&](const ExecutionReport& r) { consume(r, sinks[c]); }));
+                    }
+                });
+            }
+        } else {
+            engine.set_execution_callback([&](const ExecutionReport& r) {
+                for (auto& sink : sinks) consume(r, sink);
+            });
+        }
+        
+        // Resting liquidity, then crossing orders that each trade once
+        const Price base = to_fixed_price(1000.0);
+        for (std::size_t i = 0; i < NUM_ORDERS; ++i) {
+            engine.submit_order(symbol, Side::SELL, OrderType::LIMIT, base + static_cast<Price>(i % 100) * 100, 10);
+        }
+        std::vector<Duration> samples;
+        samples.reserve(NUM_ORDERS);
+        for (std::size_t i = 0; i < NUM_ORDERS; ++i) {
+            const Timestamp t0 = now();
+            engine.submit_order(symbol, Side::BUY, OrderType::LIMIT, to_fixed_price(2000.0), 10);
+            samples.push_back(now() - t0);
+        }
+        done.store(true, std::memory_order_release);
+        for (auto& reader : readers) reader.join();
+        
+        std::sort(samples.begin(), samples.end());
+        std::cout << "  " << (use_bus ? "Bus,    " : "Inline, ") << std::setw(2) << consumers
+                  << " consumer" << (consumers == 1 ? ": " : "s:") << " p50 " << std::setw(6)
+                  << samples[samples.size() / 2] << " ns, p99 " << std::setw(6)
+                  << samples[samples.size() * 99 / 100] << " ns\n";
+    };
+    
+    for (std::size_t consumers : {0, 1, 4, 8}) {
+        run_test(consumers, false);
+        run_test(consumers, true);
+    }
 }
 
 int main(int argc, char* argv[]) {
-    (void)argc;
-    (void)argv;
+    // Calibrate fast_now() before any thread is pinned (see tsc_clock.hpp)
+    hft::TscClock::instance();
+    
+    bool scenarios_only = false;
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--scenarios") == 0) {
+            scenarios_only = true;
+        } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--scenarios] [--json <file>]\n";
+            return 1;
+        }
+    }
     
     print_system_info();
     
     try {
+        if (scenarios_only) {
+            run_scenario_benchmarks(json_path);
+            return 0;
+        }
+        
         benchmark_spsc_queue();
+        benchmark_mpmc_queue();
         benchmark_memory_pool();
+        benchmark_allocator_contention();
+        benchmark_read_mostly();
         benchmark_order_book();
         benchmark_matching_engine();
+        benchmark_exec_fanout();
         
         // Run additional benchmarks from other files
         run_latency_benchmarks();
         run_throughput_benchmarks();
         run_orderbook_benchmarks();
+        run_scenario_benchmarks(json_path);
         
     } catch (const std::exception& e) {
         std::cerr << "Benchmark failed: " << e.what() << "\n";
@@ -0,0 +1,276 @@
+/**
+ * @file order_flow.hpp
+ * @brief Synthetic order flow for order book benchmarks
+ *
+ * A FlowScenario describes a mix of adds, cancels, modifies and market
+ * orders. Passive prices sit a Zipf-distributed number of ticks behind a
+ * slowly wandering mid, so most orders cluster at the touch and a few
+ * prices build deep queues. Market orders take a Zipf-distributed number
+ * of lots, and arrive in bursts when burst_probability is set.
+ *
+ * generate_flow() builds the whole op stream up front against a shadow
+ * OrderBook, so every cancel and modify names an order that is still
+ * resting when it runs, and nothing is generated inside a timed loop.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/types.hpp"
+#include "matching/order.hpp"
+#include "matching/order_book.hpp"
+
+namespace hft {
+
+/**
+ * @brief Samples 0..n-1 with P(k) proportional to 1 / (k + 1)^s
+ */
+class ZipfDistribution {
+public:
+    ZipfDistribution(std::size_t n, double s) : cdf_(std::max<std::size_t>(n, 1)) {
+        double sum = 0.0;
+        for (std::size_t k = 0; k < cdf_.size(); ++k) {
+            sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+            cdf_[k] = sum;
+        }
+        for (auto& c : cdf_) c /= sum;
+    }
+
+    template<typename Rng>
+    std::size_t operator()(Rng& rng) {
+        const double u = uniform_(rng);
+        const auto it = std::lower_bound(cdf_.begin(), cdf_.end(), u);
+        return std::min(static_cast<std::size_t>(it - cdf_.begin()), cdf_.size() - 1);
+    }
+
+private:
+    std::vector<double> cdf_;
+    std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+};
+
+enum class FlowOpType : std::uint8_t { ADD, CANCEL, MODIFY, MARKET };
+
+inline constexpr std::size_t FLOW_OP_TYPES = 4;
+
+[[nodiscard]] constexpr const char* to_string(FlowOpType type) noexcept {
+    switch (type) {
+        case FlowOpType::ADD: return "add";
+        case FlowOpType::CANCEL: return "cancel";
+        case FlowOpType::MODIFY: return "modify";
+        case FlowOpType::MARKET: return "market";
+    }
+    return "unknown";
+}
+
+struct FlowScenario {
+    const char* name;
+    std::size_t setup_orders;           // Resting adds applied before timing
+    std::size_t ops;                    // Timed operations
+    double add_weight;                  // Op mix; need not sum to 1
+    double cancel_weight;
+    double modify_weight;
+    double market_weight;
+    std::size_t max_distance_ticks;     // Passive price: Zipf ticks behind the touch
+    double distance_skew;
+    std::size_t max_lots;               // Passive size: Zipf lots
+    double lots_skew;
+    std::size_t max_sweep_lots;         // Market size: Zipf lots
+    double burst_probability = 0.0;     // Chance a market order starts a burst
+    std::size_t burst_length = 0;       // Market orders in a burst
+};
+
+struct FlowOp {
+    FlowOpType type;
+    Side side;
+    OrderId order_id;
+    Price price;                        // ADD, MODIFY
+    Quantity quantity;                  // ADD, MODIFY, MARKET
+};
+
+/**
+ * @brief Pre-generated op stream; orders[i] is built for ADD / MARKET ops
+ */
+struct OrderFlow {
+    std::vector<FlowOp> setup;
+    std::vector<FlowOp> ops;
+    std::vector<Order> setup_orders;
+    std::vector<Order> orders;
+    std::array<std::size_t, FLOW_OP_TYPES> mix{};   // Timed ops per type
+    Price min_price = 0;                // Every price used, for a ladder
+    Price max_price = 0;
+};
+
+/**
+ * @brief Apply one op (orders[i] for ADD / MARKET)
+ */
+inline bool apply_flow_op(OrderBook& book, const FlowOp& op, const Order& order) {
+    switch (op.type) {
+        case FlowOpType::ADD:
+        case FlowOpType::MARKET:
+            return book.add_order(order);
+        case FlowOpType::CANCEL:
+            return book.cancel_order(op.order_id);
+        case FlowOpType::MODIFY:
+            return book.modify_order(op.order_id, op.price, op.quantity);
+    }
+    return false;
+}
+
+namespace detail {
+
+class FlowGenerator {
+public:
+    static constexpr Price TICK = PRICE_MULTIPLIER / 100;          // 0.01
+    static constexpr Price CENTER = 100 * PRICE_MULTIPLIER;        // 100.00
+    static constexpr Price HALF_SPREAD = TICK;
+    static constexpr Price MAX_DRIFT = 50 * TICK;                  // Mid wanders within +/- this
+    static constexpr Quantity LOT = 100;
+    static constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+
+    FlowGenerator(const FlowScenario& scenario, std::uint64_t seed)
+        : scenario_(scenario)
+        , rng_(seed)
+        , distance_(scenario.max_distance_ticks, scenario.distance_skew)
+        , lots_(scenario.max_lots, scenario.lots_skew)
+        , sweep_(scenario.max_sweep_lots, 1.0)
+        , mix_({scenario.add_weight, scenario.cancel_weight, scenario.modify_weight, scenario.market_weight})
+        , shadow_(make_symbol("FLOW")) {}
+
+    OrderFlow generate() {
+        OrderFlow flow;
+        flow.setup.reserve(scenario_.setup_orders);
+        flow.setup_orders.reserve(scenario_.setup_orders);
+        for (std::size_t i = 0; i < scenario_.setup_orders; ++i) {
+            emit(flow.setup, flow.setup_orders, make_add());
+        }
+        flow.ops.reserve(scenario_.ops);
+        flow.orders.reserve(scenario_.ops);
+        std::size_t burst = 0;
+        while (flow.ops.size() < scenario_.ops) {
+            FlowOp op;
+            if (burst > 0) {
+                --burst;
+                op = make_market();
+            } else {
+                op = next_op();
+                if (op.type == FlowOpType::MARKET && scenario_.burst_length > 1 &&
+                    chance_(rng_) < scenario_.burst_probability) {
+                    burst = scenario_.burst_length - 1;
+                }
+            }
+            ++flow.mix[static_cast<std::size_t>(op.type)];
+            emit(flow.ops, flow.orders, op);
+        }
+        flow.min_price = CENTER - MAX_DRIFT - HALF_SPREAD - static_cast<Price>(scenario_.max_distance_ticks) * TICK;
+        flow.max_price = CENTER + MAX_DRIFT + HALF_SPREAD + static_cast<Price>(scenario_.max_distance_ticks) * TICK;
+        return flow;
+    }
+
+private:
+    FlowOp next_op() {
+        // Slow random walk of the mid, one tick at a time
+        if (chance_(rng_) < 0.001) {
+            mid_ = std::clamp(mid_ + (coin_(rng_) ? TICK : -TICK), CENTER - MAX_DRIFT, CENTER + MAX_DRIFT);
+        }
+        switch (static_cast<FlowOpType>(mix_(rng_))) {
+            case FlowOpType::CANCEL:
+                if (const std::size_t i = pick_live(); i != NONE) {
+                    const OrderId id = live_[i];
+                    live_[i] = live_.back();
+                    live_.pop_back();
+                    return FlowOp{FlowOpType::CANCEL, Side::BUY, id, 0, 0};
+                }
+                break;
+            case FlowOpType::MODIFY:
+                if (const std::size_t i = pick_live(); i != NONE) {
+                    return make_modify(live_[i]);
+                }
+                break;
+            case FlowOpType::MARKET:
+                return make_market();
+            case FlowOpType::ADD:
+                break;
+        }
+        return make_add();
+    }
+
+    Price passive_price(Side side) {
+        const Price behind = HALF_SPREAD + static_cast<Price>(distance_(rng_)) * TICK;
+        return side == Side::BUY ? mid_ - behind : mid_ + behind;
+    }
+
+    FlowOp make_add() {
+        const Side side = coin_(rng_) ? Side::BUY : Side::SELL;
+        const Quantity quantity = static_cast<Quantity>(lots_(rng_) + 1) * LOT;
+        return FlowOp{FlowOpType::ADD, side, next_id_++, passive_price(side), quantity};
+    }
+
+    FlowOp make_market() {
+        const Side side = coin_(rng_) ? Side::BUY : Side::SELL;
+        const Quantity quantity = static_cast<Quantity>(sweep_(rng_) + 1) * LOT;
+        return FlowOp{FlowOpType::MARKET, side, next_id_++, 0, quantity};
+    }
+
+    // Half shrink in place (keeps priority), half re-price (back of the queue)
+    FlowOp make_modify(OrderId id) {
+        const Order order = *shadow_.get_order(id);
+        const Quantity open = order.remaining_quantity();
+        if (coin_(rng_) && open > LOT) {
+            return FlowOp{FlowOpType::MODIFY, order.side, id, order.price, std::max(LOT, open / 2)};
+        }
+        return FlowOp{FlowOpType::MODIFY, order.side, id, passive_price(order.side), open};
+    }
+
+    // Index of a uniformly chosen resting order, forgetting filled ones on the way
+    std::size_t pick_live() {
+        while (!live_.empty()) {
+            std::uniform_int_distribution<std::size_t> pick(0, live_.size() - 1);
+            const std::size_t i = pick(rng_);
+            if (shadow_.get_order(live_[i])) return i;
+            live_[i] = live_.back();
+            live_.pop_back();
+        }
+        return NONE;
+    }
+
+    void emit(std::vector<FlowOp>& ops, std::vector<Order>& orders, const FlowOp& op) {
+        const OrderType type = op.type == FlowOpType::MARKET ? OrderType::MARKET : OrderType::LIMIT;
+        orders.emplace_back(op.order_id, op.side, type, op.price, op.quantity);
+        ops.push_back(op);
+        apply_flow_op(shadow_, op, orders.back());
+        if (op.type == FlowOpType::ADD && shadow_.get_order(op.order_id)) {
+            live_.push_back(op.order_id);
+        }
+    }
+
+    const FlowScenario& scenario_;
+    std::mt19937_64 rng_;
+    ZipfDistribution distance_;
+    ZipfDistribution lots_;
+    ZipfDistribution sweep_;
+    std::discrete_distribution<int> mix_;
+    std::uniform_real_distribution<double> chance_{0.0, 1.0};
+    std::bernoulli_distribution coin_{0.5};
+    OrderBook shadow_;
+    std::vector<OrderId> live_;
+    OrderId next_id_ = 1;
+    Price mid_ = CENTER;
+};
+
+} // namespace detail
+
+/**
+ * @brief Generate a scenario's setup and timed streams (deterministic per seed)
+ */
+[[nodiscard]] inline OrderFlow generate_flow(const FlowScenario& scenario, std::uint64_t seed = 42) {
+    return detail::FlowGenerator(scenario, seed).generate();
+}
+
+} // namespace hft
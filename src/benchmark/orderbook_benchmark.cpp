@@ -6,8 +6,11 @@
 #include <iostream>
 #include <iomanip>
 #include <random>
+#include <utility>
+#include <vector>
 #include "core/types.hpp"
 #include "core/timing.hpp"
+#include "core/perf_counters.hpp"
 #include "matching/order_book.hpp"
 
 using namespace hft;
@@ -20,13 +23,25 @@ void run_orderbook_benchmarks() {
     std::random_device rd;
     std::mt19937 gen(rd());
     
+    // Counted around each operation, outside its now() pair
+    PerfCounters counters;
+    counters.open();
+    
     // Test with varying book depths
     {
+        struct DepthCounters {
+            int depth;
+            PerfCounterStats add, cancel, match;
+        };
+        std::vector<DepthCounters> depth_counters;
+        
         std::cout << "\nOrder Book Latency vs Depth:\n";
         std::cout << "  Depth    | Add (ns) | Cancel (ns) | Match (ns)\n";
         std::cout << "  ---------+----------+-------------+-----------\n";
         
         for (int depth : {100, 1000, 10000, 50000}) {
+            auto& hw = depth_counters.emplace_back();
+            hw.depth = depth;
             auto symbol = make_symbol("TEST");
             OrderBook book(symbol);
             OrderIdGenerator id_gen;
@@ -51,9 +66,11 @@ void run_orderbook_benchmarks() {
             for (int i = 0; i < 1000; ++i) {
                 Order order(id_gen.next(), Side::BUY, OrderType::LIMIT,
                            base_price - (depth + i) * 100, 100);
+                const auto before = counters.read();
                 auto start = now();
                 book.add_order(order);
                 auto elapsed = now() - start;
+                hw.add.add(counters.read() - before);
                 add_stats.add_sample(elapsed);
                 order_ids.push_back(order.order_id);
             }
@@ -66,9 +83,11 @@ void run_orderbook_benchmarks() {
             for (int i = 0; i < 1000 && !order_ids.empty(); ++i) {
                 auto order_id = order_ids.back();
                 order_ids.pop_back();
+                const auto before = counters.read();
                 auto start = now();
                 book.cancel_order(order_id);
                 auto elapsed = now() - start;
+                hw.cancel.add(counters.read() - before);
                 cancel_stats.add_sample(elapsed);
             }
             
@@ -85,9 +104,11 @@ void run_orderbook_benchmarks() {
             for (int i = 0; i < 1000; ++i) {
                 Order order(id_gen.next(), Side::SELL, OrderType::LIMIT,
                            base_price, 10);
+                const auto before = counters.read();
                 auto start = now();
                 book.add_order(order);
                 auto elapsed = now() - start;
+                hw.match.add(counters.read() - before);
                 match_stats.add_sample(elapsed);
             }
             
@@ -97,6 +118,28 @@ void run_orderbook_benchmarks() {
                       << std::setw(11) << cancel_stats.mean() << " | "
                       << std::setw(9) << match_stats.mean() << "\n";
         }
+        
+        std::cout << "\nHardware Counters per Operation vs Depth:\n";
+        if (!counters.is_open()) {
+            std::cout << "  Unavailable: " << counters.error() << "\n";
+        } else {
+            std::cout << "  Depth    | Op     |   Cycles |   Instr |  IPC |   L1D |   LLC | Br miss |  dTLB\n";
+            std::cout << "  ---------+--------+----------+---------+------+-------+-------+---------+------\n";
+            for (const auto& hw : depth_counters) {
+                for (const auto& [op, stats] : {std::pair<const char*, const PerfCounterStats*>{"add", &hw.add},
+                                                {"cancel", &hw.cancel}, {"match", &hw.match}}) {
+                    std::cout << "  " << std::setw(7) << hw.depth << " | " << std::left << std::setw(6) << op
+                              << std::right << " | " << std::fixed << std::setprecision(0)
+                              << std::setw(8) << stats->per_op(PerfCounters::CYCLES) << " | "
+                              << std::setw(7) << stats->per_op(PerfCounters::INSTRUCTIONS) << " | "
+                              << std::setprecision(2) << std::setw(4) << stats->ipc() << " | "
+                              << std::setw(5) << stats->per_op(PerfCounters::L1D_MISSES) << " | "
+                              << std::setw(5) << stats->per_op(PerfCounters::LLC_MISSES) << " | "
+                              << std::setw(7) << stats->per_op(PerfCounters::BRANCH_MISSES) << " | "
+                              << std::setw(5) << stats->per_op(PerfCounters::DTLB_MISSES) << "\n";
+                }
+            }
+        }
     }
     
     // Test different price distributions
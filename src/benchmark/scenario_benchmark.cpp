@@ -0,0 +1,222 @@
+/**
+ * @file scenario_benchmark.cpp
+ * @brief Scenario-driven order book benchmarks with machine-readable output
+ *
+ * Each scenario's op stream is generated once (order_flow.hpp) and replayed
+ * against every OrderBook backend from the same resting book, so backends
+ * and builds see identical work. Two passes per backend: one timing the
+ * whole stream for throughput, one timing each op with the TSC for the
+ * latency distribution (timer overhead subtracted), overall and per op type.
+ *
+ * With a path, the results are also written as JSON for regression diffs.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "core/types.hpp"
+#include "core/timing.hpp"
+#include "matching/order_book.hpp"
+#include "order_flow.hpp"
+
+using namespace hft;
+
+namespace {
+
+constexpr std::size_t SCENARIO_OPS = 500'000;
+
+struct BackendRun {
+    const char* backend;
+    double throughput = 0.0;                        // ops/s
+    LatencyStats latency{};
+    std::array<LatencyStats, FLOW_OP_TYPES> by_op{};
+    std::size_t rejected = 0;                       // Ops the book returned false for
+};
+
+struct ScenarioResult {
+    const FlowScenario* scenario;
+    std::array<std::size_t, FLOW_OP_TYPES> mix;
+    std::vector<BackendRun> runs;
+};
+
+OrderBook make_book(BookBackend backend, const OrderFlow& flow) {
+    const auto symbol = make_symbol("FLOW");
+    if (backend == BookBackend::LADDER) {
+        return OrderBook(symbol, OrderBookConfig::ladder(flow.min_price, flow.max_price,
+                                                         detail::FlowGenerator::TICK));
+    }
+    return OrderBook(symbol);
+}
+
+void apply_setup(OrderBook& book, const OrderFlow& flow) {
+    for (std::size_t i = 0; i < flow.setup.size(); ++i) {
+        apply_flow_op(book, flow.setup[i], flow.setup_orders[i]);
+    }
+}
+
+// Median back-to-back rdtsc/rdtscp cost in ticks
+std::uint64_t timer_overhead_ticks() {
+    std::vector<std::uint64_t> deltas(10'000);
+    for (auto& d : deltas) {
+        const auto t1 = rdtsc();
+        const auto t2 = rdtscp();
+        d = t2 - t1;
+    }
+    std::nth_element(deltas.begin(), deltas.begin() + deltas.size() / 2, deltas.end());
+    return deltas[deltas.size() / 2];
+}
+
+BackendRun run_backend(const char* name, BookBackend backend, const OrderFlow& flow,
+                       std::uint64_t overhead, double frequency) {
+    BackendRun run{name};
+
+    // Throughput: the whole stream under one clock pair
+    {
+        auto book = make_book(backend, flow);
+        apply_setup(book, flow);
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < flow.ops.size(); ++i) {
+            run.rejected += !apply_flow_op(book, flow.ops[i], flow.orders[i]);
+        }
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        run.throughput = static_cast<double>(flow.ops.size()) / elapsed;
+    }
+
+    // Latency: same stream from the same resting book, one TSC pair per op
+    {
+        auto book = make_book(backend, flow);
+        apply_setup(book, flow);
+        for (std::size_t i = 0; i < flow.ops.size(); ++i) {
+            const FlowOp& op = flow.ops[i];
+            const auto t1 = rdtsc();
+            apply_flow_op(book, op, flow.orders[i]);
+            const auto t2 = rdtscp();
+            const auto ticks = t2 - t1;
+            const auto nanos = static_cast<std::int64_t>(
+                TSCCalibrator::ticks_to_nanos(ticks > overhead ? ticks - overhead : 0, frequency));
+            run.latency.add_sample(nanos);
+            run.by_op[static_cast<std::size_t>(op.type)].add_sample(nanos);
+        }
+    }
+    return run;
+}
+
+void write_json(const char* path, const std::vector<ScenarioResult>& results, double overhead_ns) {
+    std::FILE* out = std::fopen(path, "w");
+    if (!out) {
+        std::cerr << "Cannot write " << path << "\n";
+        return;
+    }
+    std::fprintf(out, "{\n  \"benchmark\": \"order_book_scenarios\",\n");
+    std::fprintf(out, "  \"timer_overhead_ns\": %.2f,\n  \"results\": [", overhead_ns);
+    const char* result_sep = "\n";
+    for (const auto& result : results) {
+        for (const auto& run : result.runs) {
+            const auto& s = run.latency;
+            std::fprintf(out, "%s    {\n", result_sep);
+            result_sep = ",\n";
+            std::fprintf(out, "      \"scenario\": \"%s\",\n      \"backend\": \"%s\",\n",
+                         result.scenario->name, run.backend);
+            std::fprintf(out, "      \"ops\": %zu,\n      \"mix\": {", s.count());
+            for (std::size_t t = 0; t < FLOW_OP_TYPES; ++t) {
+                std::fprintf(out, "%s\"%s\": %zu", t ? ", " : "",
+                             to_string(static_cast<FlowOpType>(t)), result.mix[t]);
+            }
+            std::fprintf(out, "},\n      \"rejected\": %zu,\n", run.rejected);
+            std::fprintf(out, "      \"throughput_ops_per_sec\": %.0f,\n", run.throughput);
+            std::fprintf(out, "      \"latency_ns\": {\"min\": %.0f, \"mean\": %.2f, \"stddev\": %.2f, "
+                              "\"p50\": %.0f, \"p90\": %.0f, \"p99\": %.0f, \"p99.9\": %.0f, "
+                              "\"p99.99\": %.0f, \"max\": %.0f},\n",
+                         s.min(), s.mean(), s.stddev(), s.percentile(50.0), s.percentile(90.0),
+                         s.percentile(99.0), s.percentile(99.9), s.percentile(99.99), s.max());
+            std::fprintf(out, "      \"by_op\": {");
+            for (std::size_t t = 0; t < FLOW_OP_TYPES; ++t) {
+                const auto& op = run.by_op[t];
+                std::fprintf(out, "%s\"%s\": {\"count\": %zu, \"p50\": %.0f, \"p99\": %.0f}",
+                             t ? ", " : "", to_string(static_cast<FlowOpType>(t)), op.count(),
+                             op.empty() ? 0.0 : op.median(), op.empty() ? 0.0 : op.percentile(99.0));
+            }
+            // [value_ns, count] per recorded bucket, for re-deriving any percentile
+            std::fprintf(out, "},\n      \"histogram\": [");
+            const char* bucket_sep = "";
+            s.histogram().for_each_bucket([&](std::int64_t value, std::uint64_t n) {
+                std::fprintf(out, "%s[%lld, %llu]", bucket_sep, static_cast<long long>(value),
+                             static_cast<unsigned long long>(n));
+                bucket_sep = ", ";
+            });
+            std::fprintf(out, "]\n    }");
+        }
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+    std::fclose(out);
+    std::cout << "\nScenario results written to " << path << "\n";
+}
+
+} // namespace
+
+void run_scenario_benchmarks(const char* json_path) {
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    std::cout << "Order Book Scenario Benchmarks\n";
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
+    // name, setup, ops, add/cancel/modify/market, distance ticks/skew, lots/skew, sweep lots, bursts
+    static const FlowScenario scenarios[] = {
+        {"balanced",     10'000,  SCENARIO_OPS, 0.45, 0.40, 0.10, 0.05, 50, 1.1, 10, 1.2, 10},
+        {"cancel_heavy", 5'000,   SCENARIO_OPS, 0.49, 0.47, 0.02, 0.02, 20, 1.5, 10, 1.2, 5},
+        {"deep_queue",   100'000, SCENARIO_OPS, 0.45, 0.40, 0.10, 0.05, 5,  2.0, 10, 1.2, 20},
+        {"sweep_burst",  10'000,  SCENARIO_OPS, 0.42, 0.38, 0.10, 0.10, 50, 1.1, 10, 1.2, 50, 0.01, 50},
+    };
+
+    const std::uint64_t overhead = timer_overhead_ticks();
+    const double frequency = TSCCalibrator::calibrate();
+    const double overhead_ns = TSCCalibrator::ticks_to_nanos(overhead, frequency);
+
+    std::vector<ScenarioResult> results;
+    for (const auto& scenario : scenarios) {
+        const OrderFlow flow = generate_flow(scenario);
+        auto& result = results.emplace_back(ScenarioResult{&scenario, flow.mix, {}});
+        result.runs.push_back(run_backend("map", BookBackend::MAP, flow, overhead, frequency));
+        result.runs.push_back(run_backend("ladder", BookBackend::LADDER, flow, overhead, frequency));
+    }
+
+    std::cout << "\nTimer overhead: " << std::fixed << std::setprecision(1) << overhead_ns
+              << " ns (subtracted)\n\n";
+    std::cout << "  Scenario     | Backend | Throughput (M/s) | p50 (ns) | p99 (ns) | p99.9 (ns) | Max (ns)\n";
+    std::cout << "  -------------+---------+------------------+----------+----------+------------+---------\n";
+    for (const auto& result : results) {
+        for (const auto& run : result.runs) {
+            const auto& s = run.latency;
+            std::cout << "  " << std::left << std::setw(12) << result.scenario->name << " | "
+                      << std::setw(7) << run.backend << " | " << std::right
+                      << std::setw(16) << std::setprecision(2) << run.throughput / 1e6 << " | "
+                      << std::setw(8) << std::setprecision(0) << s.median() << " | "
+                      << std::setw(8) << s.percentile(99.0) << " | "
+                      << std::setw(10) << s.percentile(99.9) << " | "
+                      << std::setw(8) << s.max() << "\n";
+        }
+    }
+
+    std::cout << "\nPer-op p50 / p99 (ns):\n";
+    for (const auto& result : results) {
+        for (const auto& run : result.runs) {
+            std::cout << "  " << std::left << std::setw(12) << result.scenario->name << " "
+                      << std::setw(7) << run.backend << std::right;
+            for (std::size_t t = 0; t < FLOW_OP_TYPES; ++t) {
+                const auto& op = run.by_op[t];
+                if (op.empty()) continue;
+                std::cout << "  " << to_string(static_cast<FlowOpType>(t)) << " "
+                          << op.median() << " / " << op.percentile(99.0);
+            }
+            std::cout << "\n";
+        }
+    }
+
+    if (json_path) {
+        write_json(json_path, results, overhead_ns);
+    }
+}
@@ -8,10 +8,13 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <vector>
 #include "core/types.hpp"
 #include "core/lockfree_queue.hpp"
 #include "core/cpu_affinity.hpp"
 #include "matching/order.hpp"
+#include "exchange/exchange_simulator.hpp"
+#include "strategy/user_strategy.hpp"
 
 using namespace hft;
 
@@ -144,5 +147,106 @@ void run_throughput_benchmarks() {
         std::cout << "  Write: " << std::fixed << std::setprecision(2) << write_bw << " GB/sec\n";
         std::cout << "  Read:  " << read_bw << " GB/sec (sum=" << sum << ")\n";
     }
+    
+    // Multi-symbol strategy: per-tick onTick() against batched on_ticks()
+    {
+        std::cout << "\nMulti-Symbol Strategy Evaluation (momentum):\n";
+        
+        constexpr std::size_t SYMBOLS = 4096;
+        constexpr std::size_t NUM_TICKS = 4'000'000;
+        
+        std::vector<Tick> ticks(NUM_TICKS);
+        std::uint64_t lcg = 1;
+        for (std::size_t i = 0; i < NUM_TICKS; ++i) {
+            lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+            const Price last = to_fixed_price(100.0) + static_cast<Price>((lcg >> 33) % 64) * 100;
+            Tick& tick = ticks[i];
+            tick.symbol = make_symbol("S" + std::to_string(i % SYMBOLS));
+            tick.bid_price = last - 100;
+            tick.ask_price = last + 100;
+            tick.last_price = last;
+            tick.sequence = i;
+        }
+        
+        auto run_test = [&](std::size_t batch) {
+            MomentumStrategy strategy;
+            strategy.reserve_symbols(SYMBOLS);
+            std::uint64_t orders = 0;
+            strategy.set_order_callback([&](const StrategyOrder&) { ++orders; });
+            strategy.on_ticks(std::span<const Tick>(ticks).first(SYMBOLS));     // Intern every symbol
+            
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < NUM_TICKS; i += batch) {
+                if (batch == 1) {
+                    strategy.onTick(ticks[i]);
+                } else {
+                    strategy.on_ticks(std::span<const Tick>(ticks).subspan(i, std::min(batch, NUM_TICKS - i)));
+                }
+            }
+            auto end = std::chrono::steady_clock::now();
+            auto duration = std::chrono::duration<double>(end - start).count();
+            
+            std::cout << "  Batch " << std::setw(5) << batch << ": " << std::fixed << std::setprecision(2)
+                      << (NUM_TICKS / duration / 1e6) << " M ticks/sec (" << orders << " orders, "
+                      << SYMBOLS << " symbols)\n";
+        };
+        
+        for (std::size_t batch : {std::size_t{1}, std::size_t{256}, SYMBOLS}) {
+            run_test(batch);
+        }
+    }
+    
+    // Exchange simulator: N strategy threads, one lane each, into one matching book.
+    // Producers send flat out, so tick-to-order is mostly time queued in the lanes.
+    {
+        std::cout << "\nExchange Simulator Scaling (matching, one lane per client):\n";
+        
+        constexpr std::size_t ORDERS_PER_CLIENT = 200'000;
+        const Symbol symbol = make_symbol("XCHG");
+        
+        auto run_test = [&](std::size_t clients) {
+            ExchangeConfig config;
+            config.match_orders = true;
+            ExchangeSimulator exchange(config);
+            for (std::size_t c = 1; c < clients; ++c) {
+                (void)exchange.add_client();
+            }
+            exchange.start(-1, true);
+            
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> producers;
+            for (std::size_t c = 0; c < clients; ++c) {
+                producers.emplace_back([&, c]() {
+                    const auto client = static_cast<ExchangeSimulator::ClientId>(c);
+                    for (std::size_t i = 0; i < ORDERS_PER_CLIENT; ++i) {
+                        // Alternate sides a few ticks around 100.00: most orders cross
+                        const Side side = (i + c) % 2 ? Side::BUY : Side::SELL;
+                        const Price price = to_fixed_price(100.0) + static_cast<Price>(i % 5) * 100 - 200;
+                        const Timestamp t = fast_now();
+                        const auto order = make_exchange_order(i, i, t, t, symbol, side, OrderType::LIMIT,
+                                                               price, 100);
+                        while (!exchange.submit_order(client, order)) {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+            for (auto& producer : producers) producer.join();
+            exchange.stop();
+            auto end = std::chrono::steady_clock::now();
+            auto duration = std::chrono::duration<double>(end - start).count();
+            
+            const auto stats = exchange.stats();
+            std::cout << "  " << clients << " client" << (clients > 1 ? "s: " : ":  ") << std::fixed
+                      << std::setprecision(2) << (static_cast<double>(stats.orders_received) / duration / 1e6)
+                      << " M orders/sec, tick-to-order p50 " << std::setprecision(0)
+                      << stats.tick_to_order.percentile(50.0) << " ns, p99 "
+                      << stats.tick_to_order.percentile(99.0) << " ns ("
+                      << stats.orders_filled + stats.orders_partially_filled << " crossed)\n";
+        };
+        
+        for (std::size_t clients : {1, 2, 4, 8}) {
+            run_test(clients);
+        }
+    }
 }
-
@@ -0,0 +1,414 @@
+/**
+ * @file async_binary_log.hpp
+ * @brief Fixed-size binary record log written off the measured thread
+ *
+ * The measured thread only copies a record into an SPSC ring. A background
+ * writer (optionally pinned to a non-critical core) drains the ring into a
+ * preallocated, memory-mapped file, so formatting, syscalls and page-cache
+ * flushes never land on the path whose latency is being logged.
+ *
+ * File layout:
+ *   [Header][metadata bytes][pad to 4 KiB][record 0][record 1]...
+ *
+ * The record count is written into the header on close() and the file is
+ * truncated to the records written, so a reader needs no other framing.
+ * Conversion to text (CSV etc.) is done offline with for_each_record().
+ * MappedRecordFile is the file half on its own, for writers that already
+ * run off the hot path (e.g. the timestamp collector); MappedRecordView
+ * maps a closed file read-only for zero-copy replay.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "busy_poll.hpp"
+#include "cpu_affinity.hpp"
+#include "lockfree_queue.hpp"
+#include "memory_region.hpp"
+
+namespace hft {
+
+/**
+ * @brief Append-only file of fixed-size records behind a growing mmap
+ *
+ * Single writer. Preallocates room for the expected number of records and
+ * doubles when it runs out; close() stores the count and trims the file.
+ */
+template<typename Record>
+class MappedRecordFile {
+    static_assert(std::is_trivially_copyable_v<Record>, "Records are copied bytewise");
+
+public:
+    static constexpr std::uint64_t MAGIC = 0x474F4C4E49425448ULL;     // "HTBINLOG"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t PAGE = 4096;
+
+    struct Header {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t record_size;
+        std::uint64_t record_count;
+        std::uint64_t metadata_size;
+    };
+
+    MappedRecordFile() = default;
+    ~MappedRecordFile() { close(); }
+
+    // Non-copyable
+    MappedRecordFile(const MappedRecordFile&) = delete;
+    MappedRecordFile& operator=(const MappedRecordFile&) = delete;
+
+    /**
+     * @brief Create (truncate) the file and preallocate room for expected records
+     *
+     * metadata is stored verbatim after the header (e.g. a symbol table the
+     * records index into).
+     */
+    bool open(const std::string& path, std::size_t expected_records,
+              std::string_view metadata = {}) {
+        #ifdef __linux__
+        if (fd_ >= 0) return false;
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) return false;
+
+        data_offset_ = data_offset(metadata.size());
+        if (!map(data_offset_ + std::max<std::size_t>(expected_records, 1024) * sizeof(Record))) {
+            close();
+            return false;
+        }
+        Header header{MAGIC, VERSION, static_cast<std::uint32_t>(sizeof(Record)), 0, metadata.size()};
+        std::memcpy(base_, &header, sizeof(header));
+        if (!metadata.empty()) {
+            std::memcpy(base_ + sizeof(Header), metadata.data(), metadata.size());
+        }
+        written_ = 0;
+        write_errors_ = 0;
+        return true;
+        #else
+        (void)path; (void)expected_records; (void)metadata;
+        return false;
+        #endif
+    }
+
+    bool append(const Record& record) noexcept {
+        if (data_offset_ + (written_ + 1) * sizeof(Record) > mapped_size_ &&
+            !map(data_offset_ + 2 * (mapped_size_ - data_offset_))) {
+            ++write_errors_;
+            return false;
+        }
+        std::memcpy(base_ + data_offset_ + written_ * sizeof(Record), &record, sizeof(Record));
+        ++written_;
+        return true;
+    }
+
+    /**
+     * @brief Record the count in the header and trim the file
+     */
+    void close() {
+        #ifdef __linux__
+        if (base_) {
+            reinterpret_cast<Header*>(base_)->record_count = written_;
+            munmap(base_, mapped_size_);
+            base_ = nullptr;
+            mapped_size_ = 0;
+        }
+        if (fd_ >= 0) {
+            if (ftruncate(fd_, static_cast<off_t>(data_offset_ + written_ * sizeof(Record))) != 0) {
+                ++write_errors_;
+            }
+            ::close(fd_);
+            fd_ = -1;
+        }
+        #endif
+    }
+
+    [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+    [[nodiscard]] std::uint64_t records_written() const noexcept { return written_; }
+    [[nodiscard]] std::uint64_t write_errors() const noexcept { return write_errors_; }
+
+    /**
+     * @brief Read a closed file offline: fn(record) for each record in order
+     *
+     * Streams through the file, so memory use does not grow with its size.
+     * metadata receives the bytes given to open(). False if the file is
+     * missing, truncated or was written with a different Record layout.
+     */
+    template<typename Fn>
+    static bool for_each_record(const std::string& path, std::string& metadata, Fn&& fn) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+
+        Header header{};
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                  header.magic == MAGIC && header.version == VERSION &&
+                  header.record_size == sizeof(Record);
+        if (ok) {
+            metadata.resize(header.metadata_size);
+            ok = header.metadata_size == 0 ||
+                 std::fread(metadata.data(), 1, metadata.size(), file) == metadata.size();
+        }
+        if (ok && std::fseek(file, static_cast<long>(data_offset(header.metadata_size)), SEEK_SET) == 0) {
+            Record record;
+            for (std::uint64_t i = 0; i < header.record_count; ++i) {
+                if (std::fread(&record, sizeof(record), 1, file) != 1) {
+                    ok = false;
+                    break;
+                }
+                fn(record);
+            }
+        }
+        std::fclose(file);
+        return ok;
+    }
+
+    /**
+     * @brief Offset of record 0: header and metadata rounded up to a page
+     */
+    static constexpr std::size_t data_offset(std::size_t metadata_size) noexcept {
+        return (sizeof(Header) + metadata_size + PAGE - 1) / PAGE * PAGE;
+    }
+
+private:
+    bool map(std::size_t size) {
+        #ifdef __linux__
+        // Reserve the blocks up front so stores into the mapping never fault on ENOSPC
+        if (posix_fallocate(fd_, 0, static_cast<off_t>(size)) != 0 &&
+            ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            return false;
+        }
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) return false;
+        if (base_) {
+            munmap(base_, mapped_size_);
+        }
+        base_ = static_cast<char*>(addr);
+        mapped_size_ = size;
+        return true;
+        #else
+        (void)size;
+        return false;
+        #endif
+    }
+
+    int fd_ = -1;
+    char* base_ = nullptr;
+    std::size_t mapped_size_ = 0;
+    std::size_t data_offset_ = 0;
+    std::uint64_t written_ = 0;
+    std::uint64_t write_errors_ = 0;
+};
+
+/**
+ * @brief Read-only mapping of a closed MappedRecordFile
+ *
+ * Records are used in place, so reading one costs what touching its cache
+ * line costs. The file is prefaulted on open (MAP_POPULATE) so replay does
+ * not take page faults.
+ */
+template<typename Record>
+class MappedRecordView {
+public:
+    using File = MappedRecordFile<Record>;
+
+    MappedRecordView() = default;
+    ~MappedRecordView() { close(); }
+
+    // Non-copyable
+    MappedRecordView(const MappedRecordView&) = delete;
+    MappedRecordView& operator=(const MappedRecordView&) = delete;
+
+    /**
+     * @brief Map the file; false if missing, truncated or of another Record layout
+     */
+    bool open(const std::string& path) {
+        #ifdef __linux__
+        close();
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        typename File::Header header{};
+        bool ok = ::pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                  header.magic == File::MAGIC && header.version == File::VERSION &&
+                  header.record_size == sizeof(Record);
+        const std::size_t offset = ok ? File::data_offset(header.metadata_size) : 0;
+        const std::size_t size = offset + header.record_count * sizeof(Record);
+        const off_t file_size = ok ? ::lseek(fd, 0, SEEK_END) : 0;
+        ok = ok && file_size >= 0 && static_cast<std::size_t>(file_size) >= size;
+        if (ok) {
+            void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            ok = addr != MAP_FAILED;
+            if (ok) {
+                base_ = static_cast<const char*>(addr);
+                mapped_size_ = size;
+                metadata_size_ = header.metadata_size;
+                data_offset_ = offset;
+                count_ = header.record_count;
+                madvise(const_cast<char*>(base_), size, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+        return ok;
+        #else
+        (void)path;
+        return false;
+        #endif
+    }
+
+    void close() {
+        #ifdef __linux__
+        if (base_) {
+            munmap(const_cast<char*>(base_), mapped_size_);
+        }
+        #endif
+        base_ = nullptr;
+        mapped_size_ = 0;
+        count_ = 0;
+    }
+
+    [[nodiscard]] bool is_open() const noexcept { return base_ != nullptr; }
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+
+    [[nodiscard]] std::span<const Record> records() const noexcept {
+        if (!base_) return {};
+        return {reinterpret_cast<const Record*>(base_ + data_offset_), count_};
+    }
+
+    [[nodiscard]] std::string_view metadata() const noexcept {
+        if (!base_) return {};
+        return {base_ + sizeof(typename File::Header), metadata_size_};
+    }
+
+private:
+    const char* base_ = nullptr;
+    std::size_t mapped_size_ = 0;
+    std::size_t metadata_size_ = 0;
+    std::size_t data_offset_ = 0;
+    std::size_t count_ = 0;
+};
+
+/**
+ * @brief MappedRecordFile fed from a measured thread through an SPSC ring
+ */
+template<typename Record, std::size_t QueueSize = 65536>
+class AsyncBinaryLog {
+public:
+    AsyncBinaryLog() : queue_(make_in_region<Queue>(default_memory_policy())) {}
+
+    ~AsyncBinaryLog() { close(); }
+
+    // Non-copyable
+    AsyncBinaryLog(const AsyncBinaryLog&) = delete;
+    AsyncBinaryLog& operator=(const AsyncBinaryLog&) = delete;
+
+    /**
+     * @brief Create the file (see MappedRecordFile::open)
+     */
+    bool open(const std::string& path, std::size_t expected_records,
+              std::string_view metadata = {}) {
+        if (!queue_ || !file_.open(path, expected_records, metadata)) return false;
+        dropped_.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Start the writer thread, pinned to cpu_core if >= 0
+     */
+    void start(int cpu_core = -1) {
+        if (!file_.is_open() || running_.load(std::memory_order_acquire)) return;
+        running_.store(true, std::memory_order_release);
+        writer_ = std::thread([this, cpu_core] {
+            if (cpu_core >= 0) {
+                set_cpu_affinity(cpu_core);
+            }
+            run();
+        });
+    }
+
+    /**
+     * @brief Queue a record (measured thread); dropped and counted if the ring is full
+     */
+    bool log(const Record& record) noexcept {
+        if (queue_->try_push(record)) [[likely]] {
+            return true;
+        }
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief Drain the ring, stop the writer
+     */
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        if (writer_.joinable()) {
+            writer_.join();
+        }
+    }
+
+    /**
+     * @brief Stop, then close the file
+     */
+    void close() {
+        stop();
+        file_.close();
+    }
+
+    [[nodiscard]] bool is_open() const noexcept { return file_.is_open(); }
+
+    // Valid once stopped
+    [[nodiscard]] std::uint64_t records_written() const noexcept { return file_.records_written(); }
+    [[nodiscard]] std::uint64_t write_errors() const noexcept { return file_.write_errors(); }
+
+    [[nodiscard]] std::uint64_t records_dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    template<typename Fn>
+    static bool for_each_record(const std::string& path, std::string& metadata, Fn&& fn) {
+        return MappedRecordFile<Record>::for_each_record(path, metadata, std::forward<Fn>(fn));
+    }
+
+private:
+    using Queue = SPSCQueue<Record, QueueSize>;
+
+    void run() {
+        // Off the hot path: give the core back soon after the ring drains
+        IdleStrategy idle(PollMode::RELAXED);
+        for (;;) {
+            // Read the flag first so nothing logged before stop() is missed
+            const bool running = running_.load(std::memory_order_acquire);
+            const std::size_t drained = queue_->consume_all([this](const Record& record) {
+                file_.append(record);
+            });
+            if (!running) break;
+            idle.idle(drained);
+        }
+    }
+
+    RegionPtr<Queue> queue_;
+    MappedRecordFile<Record> file_;             // Writer thread (others once stopped)
+    std::thread writer_;
+    std::atomic<bool> running_{false};
+    std::atomic<std::uint64_t> dropped_{0};     // Measured thread only
+};
+
+} // namespace hft
@@ -19,6 +19,12 @@
  *   - Spin + pause:  ~100ns wake latency, ~95% CPU (recommended)
  *   - Spin + yield:  ~1-10µs wake latency, ~50% CPU
  *   - nanosleep:     ~50-100µs wake latency, ~10% CPU
+ * 
+ * IdleStrategy picks between these per idle period: it learns the typical
+ * gap between bursts of work and only spins while work is likely to show
+ * up soon, then steps down to TPAUSE (or yield) and finally a futex park
+ * bounded by a configurable wake latency. Busy feeds keep spinning; quiet
+ * ones stop burning their core.
  */
 
 #pragma once
@@ -29,6 +35,18 @@
 #include <cstdint>
 #include <thread>
 #include <algorithm>
+#include <ctime>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
 
 namespace hft {
 
@@ -172,6 +190,7 @@ template<typename Predicate, typename Duration>
     Duration timeout,
     PollMode mode = PollMode::BALANCED
 ) noexcept {
+    (void)mode;  // Timed waits always use balanced polling
     auto deadline = std::chrono::steady_clock::now() + timeout;
     
     while (!pred()) {
@@ -186,6 +205,264 @@ template<typename Predicate, typename Duration>
     return true;
 }
 
+/**
+ * @brief Futex word a parked IdleStrategy sleeps on; producers notify() it
+ * 
+ * A poller announces itself in parked_ (seq_cst), checks its queues once
+ * more through the pending predicate and only then sleeps. notify() runs
+ * after the producer's push and fences before reading parked_, so either
+ * the poller's re-check sees the push or notify() sees the poller and
+ * bumps the word before FUTEX_WAIT compares it: no wakeup is lost. With
+ * nobody parked, notify() costs the fence and one load.
+ */
+class WakeSignal {
+public:
+    void notify() noexcept {
+        // Order the caller's push before reading parked_ (pairs with wait_for)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_relaxed) == 0) return;
+        word_.fetch_add(1, std::memory_order_release);
+        #ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word_), FUTEX_WAKE_PRIVATE, INT32_MAX,
+                nullptr, nullptr, 0);
+        #endif
+    }
+
+    /**
+     * @brief Sleep until notified or timeout, unless pending() already finds work
+     *
+     * pending() re-polls whatever the producers notify for (e.g. "a lane is
+     * not empty or stop was requested"); the parked thread only.
+     */
+    template<typename Pending>
+    void wait_for(std::chrono::nanoseconds timeout, Pending&& pending) noexcept {
+        parked_.fetch_add(1, std::memory_order_seq_cst);
+        const std::uint32_t seen = word_.load(std::memory_order_seq_cst);
+        if (!pending()) {
+            #ifdef __linux__
+            const timespec ts{static_cast<std::time_t>(timeout.count() / 1'000'000'000),
+                              static_cast<long>(timeout.count() % 1'000'000'000)};
+            syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word_), FUTEX_WAIT_PRIVATE, seen,
+                    &ts, nullptr, 0);
+            #else
+            (void)seen;
+            std::this_thread::sleep_for(timeout);
+            #endif
+        }
+        parked_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Timed sleep with nothing to re-check (a push just before it waits out the timeout)
+     */
+    void wait_for(std::chrono::nanoseconds timeout) noexcept {
+        wait_for(timeout, [] { return false; });
+    }
+
+    /**
+     * @brief Threads inside wait_for() right now
+     */
+    [[nodiscard]] std::uint32_t parked() const noexcept {
+        return parked_.load(std::memory_order_seq_cst);
+    }
+
+private:
+    std::atomic<std::uint32_t> word_{0};
+    std::atomic<std::uint32_t> parked_{0};
+};
+
+/**
+ * @brief Whether the CPU has TPAUSE / UMWAIT (WAITPKG)
+ */
+[[nodiscard]] inline bool has_waitpkg() noexcept {
+    #if defined(__x86_64__) || defined(_M_X64)
+        static const bool supported = [] {
+            unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+            return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ecx & (1u << 5));
+        }();
+        return supported;
+    #else
+        return false;
+    #endif
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+/**
+ * @brief TPAUSE in the light C0.2 state for about ticks TSC ticks
+ */
+__attribute__((target("waitpkg"))) inline void tpause_for(std::uint64_t ticks) noexcept {
+    _tpause(0, __rdtsc() + ticks);
+}
+#endif
+
+/**
+ * @brief Idle step for a poll loop, adapting to the observed gaps in work
+ * 
+ * Call idle(work) once per poll iteration with the amount of work that
+ * iteration found. Each idle period goes through:
+ *   SPIN   spin_polls polls with only a compiler barrier
+ *   PAUSE  PAUSE with exponential backoff, up to the spin budget
+ *   WAIT   TPAUSE slices (yield without WAITPKG), up to twice the budget
+ *   PARK   futex sleeps of max_wake_latency, cut short by the WakeSignal
+ * 
+ * ADAPTIVE sets the spin budget to twice the recent average gap when gaps
+ * are short enough to spin through, and to min_spin when they are not.
+ * AGGRESSIVE only spins, BALANCED never parks, RELAXED always uses
+ * min_spin. Clocks are only read once an idle period outlasts SPIN, so a
+ * loop that keeps finding work pays nothing.
+ * 
+ * Only ADAPTIVE and RELAXED park. Latency-critical loops default to
+ * BALANCED (config_for()) and opt into parking explicitly; a loop that
+ * may park passes idle(work, pending) so the park re-checks its queues.
+ * 
+ * Clock is steady_clock (IdleStrategy); tests substitute a manual clock.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class BasicIdleStrategy {
+public:
+    enum class State : std::uint8_t { SPIN, PAUSE, WAIT, PARK };
+
+    struct Config {
+        PollMode mode = PollMode::ADAPTIVE;
+        std::chrono::nanoseconds max_wake_latency{50'000};   // Longest park slice
+        std::chrono::nanoseconds min_spin{5'000};
+        std::chrono::nanoseconds max_spin{500'000};
+        std::uint32_t spin_polls = 64;
+    };
+
+    // TPAUSE slice: ~3 µs at 3 GHz, well below any sensible wake latency
+    static constexpr std::uint64_t WAIT_TICKS = 10'000;
+
+    BasicIdleStrategy() noexcept : BasicIdleStrategy(Config{}) {}
+
+    explicit BasicIdleStrategy(const Config& config, WakeSignal* signal = nullptr) noexcept
+        : config_(config)
+        , signal_(signal)
+        , budget_(config.mode == PollMode::ADAPTIVE ? config.max_spin : config.min_spin) {}
+
+    explicit BasicIdleStrategy(PollMode mode, WakeSignal* signal = nullptr) noexcept
+        : BasicIdleStrategy(with_mode(mode), signal) {}
+
+    /**
+     * @brief Config with the other fields at their defaults
+     */
+    [[nodiscard]] static Config config_for(PollMode mode) noexcept {
+        Config config;
+        config.mode = mode;
+        return config;
+    }
+
+    /**
+     * @brief One poll iteration's idle step (work = items it handled)
+     */
+    void idle(std::size_t work) noexcept {
+        idle(work, [] { return false; });
+    }
+
+    /**
+     * @brief As idle(work); pending() re-polls for work just before a park sleeps
+     */
+    template<typename Pending>
+    void idle(std::size_t work, Pending&& pending) noexcept {
+        if (work > 0) {
+            reset();
+        } else {
+            idle_step(pending);
+        }
+    }
+
+    void idle() noexcept {
+        idle_step([] { return false; });
+    }
+
+    /**
+     * @brief Work found: end the idle period and learn from its length
+     */
+    void reset() noexcept {
+        if (polls_ == 0) return;
+        if (config_.mode == PollMode::ADAPTIVE) {
+            // Gaps that ended while spinning count as zero
+            const auto gap = polls_ > config_.spin_polls
+                ? std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - idle_start_)
+                : std::chrono::nanoseconds{0};
+            average_gap_ += (gap - average_gap_) / 8;
+            const auto wanted = 2 * average_gap_;
+            budget_ = wanted <= config_.max_spin ? std::max(wanted, config_.min_spin) : config_.min_spin;
+        }
+        polls_ = 0;
+        backoff_ = 1;
+        state_ = State::SPIN;
+    }
+
+    [[nodiscard]] State state() const noexcept { return state_; }
+    [[nodiscard]] std::chrono::nanoseconds spin_budget() const noexcept { return budget_; }
+    [[nodiscard]] std::chrono::nanoseconds average_gap() const noexcept { return average_gap_; }
+    [[nodiscard]] std::uint64_t parks() const noexcept { return parks_; }
+    [[nodiscard]] const Config& config() const noexcept { return config_; }
+
+private:
+    static Config with_mode(PollMode mode) noexcept {
+        return config_for(mode);
+    }
+
+    template<typename Pending>
+    void idle_step(Pending&& pending) noexcept {
+        if (++polls_ <= config_.spin_polls || config_.mode == PollMode::AGGRESSIVE) {
+            state_ = State::SPIN;
+            asm volatile("" ::: "memory");
+            return;
+        }
+        const auto now = Clock::now();
+        if (polls_ == config_.spin_polls + 1) {
+            idle_start_ = now;
+        }
+        const auto idle_for = now - idle_start_;
+
+        if (idle_for < budget_ || config_.mode == PollMode::BALANCED) {
+            state_ = State::PAUSE;
+            for (std::uint32_t i = 0; i < backoff_; ++i) {
+                cpu_pause();
+            }
+            backoff_ = std::min<std::uint32_t>(backoff_ * 2, 64);
+            if (config_.mode == PollMode::BALANCED && idle_for >= config_.max_spin) {
+                std::this_thread::yield();      // Safety valve, as in busy_poll()
+            }
+            return;
+        }
+        if (idle_for < 2 * budget_) {
+            state_ = State::WAIT;
+            #if defined(__x86_64__) || defined(_M_X64)
+            if (has_waitpkg()) {
+                tpause_for(WAIT_TICKS);
+                return;
+            }
+            #endif
+            std::this_thread::yield();
+            return;
+        }
+        state_ = State::PARK;
+        ++parks_;
+        if (signal_) {
+            signal_->wait_for(config_.max_wake_latency, pending);
+        } else {
+            own_signal_.wait_for(config_.max_wake_latency, pending);
+        }
+    }
+
+    Config config_;
+    WakeSignal* signal_;
+    WakeSignal own_signal_;                     // Timed sleeps when nobody notifies
+    std::chrono::nanoseconds budget_;
+    std::chrono::nanoseconds average_gap_{0};
+    typename Clock::time_point idle_start_{};
+    std::uint64_t polls_ = 0;
+    std::uint64_t parks_ = 0;
+    std::uint32_t backoff_ = 1;
+    State state_ = State::SPIN;
+};
+
+using IdleStrategy = BasicIdleStrategy<>;
+
 /**
  * @brief High-performance consumer loop pattern
  * 
@@ -211,6 +488,7 @@ inline void consumer_loop(
 ) {
     std::size_t empty_polls = 0;
     std::size_t backoff = 1;
+    IdleStrategy adaptive(PollMode::ADAPTIVE);
     
     while (!should_stop()) {
         auto work = try_get_work();
@@ -220,6 +498,9 @@ inline void consumer_loop(
             process(*work);
             empty_polls = 0;
             backoff = 1;
+            adaptive.reset();
+        } else if (mode == PollMode::ADAPTIVE) {
+            adaptive.idle();
         } else {
             // No work - spin with backoff
             ++empty_polls;
@@ -240,7 +521,7 @@ inline void consumer_loop(
                     break;
                     
                 case PollMode::RELAXED:
-                case PollMode::ADAPTIVE:
+                case PollMode::ADAPTIVE:    // Handled by IdleStrategy above
                     for (std::size_t i = 0; i < std::min(backoff * 4, size_t{256}); ++i) {
                         cpu_pause();
                     }
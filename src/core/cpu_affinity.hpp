@@ -210,12 +210,33 @@ inline void isolate_thread() {
         // Disable thread migration
         // Note: Full isolation requires kernel parameters (isolcpus, irqaffinity)
         
-        // Set to use local memory only (if NUMA)
-        // numa_set_strict(1);
-        // numa_set_localalloc();
+        // Allocate from the local node (MPOL_LOCAL), no libnuma needed
+        constexpr int MPOL_LOCAL_MODE = 4;
+        syscall(SYS_set_mempolicy, MPOL_LOCAL_MODE, nullptr, 0);
     #endif
 }
 
+/**
+ * @brief NUMA node that owns a CPU (0 on single-node or unknown systems)
+ *
+ * Use it to bind a thread's buffers (MemoryPolicy::numa_node) before the
+ * thread has started on that CPU.
+ */
+inline int numa_node_of_cpu(int cpu_id) {
+    #ifdef __linux__
+        for (int node = 0; node < 64; ++node) {
+            const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu_id) +
+                                     "/node" + std::to_string(node);
+            if (access(path.c_str(), F_OK) == 0) {
+                return node;
+            }
+        }
+    #else
+        (void)cpu_id;
+    #endif
+    return 0;
+}
+
 /**
  * @brief Thread configuration for HFT
  */
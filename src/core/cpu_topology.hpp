@@ -0,0 +1,505 @@
+/**
+ * @file cpu_topology.hpp
+ * @brief CPU topology discovery from sysfs and automatic thread placement
+ *
+ * CpuTopology reads, per logical CPU: physical core and package, SMT
+ * siblings, the L2 and L3 sharing domains, NUMA node, whether the CPU is
+ * isolated (isolcpus) or tickless (nohz_full), and which NIC queue IRQs
+ * (/sys/class/net/<if>/device/msi_irqs, /proc/irq/<n>/smp_affinity_list)
+ * are steered to it. Anything missing reads as unknown, not as an error:
+ * on a single-socket VM without cache info every CPU shares one domain.
+ *
+ * plan_placement() assigns a set of named threads to CPUs:
+ * - Critical threads get a physical core each, preferring isolated,
+ *   IRQ-free cores. The SMT siblings of a critical core stay unused.
+ * - A thread marked hot_with another (producer/consumer) is kept in its
+ *   partner's L3 domain, so the handoff stays in the shared cache.
+ * - Non-critical threads (logger, refresher) go to housekeeping cores,
+ *   preferring non-isolated ones away from the critical cores.
+ * When the machine has too few cores the plan pins what it can, leaves
+ * the rest unpinned (-1) and says so in warnings. check_placement() gives
+ * the same warnings for a hand-written CPU list.
+ *
+ * Setup only: discovery reads files and allocates.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/cpu_affinity.hpp"
+
+namespace hft {
+
+/**
+ * @brief One logical CPU
+ */
+struct CpuCore {
+    int cpu = -1;
+    int core_id = -1;           // Within the package
+    int package = 0;
+    int numa_node = 0;
+    int smt_group = -1;         // Lowest CPU of the physical core
+    int l2_domain = -1;         // Lowest CPU sharing the L2 (-1 = unknown)
+    int l3_domain = -1;         // Lowest CPU sharing the L3 (-1 = unknown)
+    std::vector<int> siblings;  // Other hardware threads of the physical core
+    bool allowed = true;        // In this process's affinity mask
+    bool isolated = false;      // isolcpus
+    bool nohz_full = false;
+    int nic_irqs = 0;           // NIC queue IRQs whose affinity includes this CPU
+    std::uint64_t max_frequency_hz = 0;
+};
+
+/**
+ * @brief One NIC queue interrupt and the CPUs it may run on
+ */
+struct NicIrq {
+    std::string interface;
+    int irq = -1;
+    std::vector<int> cpus;
+};
+
+namespace detail {
+
+inline std::string read_first_line(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+inline int read_int(const std::string& path, int fallback) {
+    const std::string line = read_first_line(path);
+    if (line.empty()) return fallback;
+    char* end = nullptr;
+    const long value = std::strtol(line.c_str(), &end, 10);
+    return end == line.c_str() ? fallback : static_cast<int>(value);
+}
+
+/**
+ * @brief Parse a kernel CPU list ("0-3,8,10-11"); "(null)" and "" are empty
+ */
+inline std::vector<int> parse_cpu_list(std::string_view list) {
+    std::vector<int> cpus;
+    std::size_t pos = 0;
+    while (pos < list.size()) {
+        std::size_t comma = list.find(',', pos);
+        if (comma == std::string_view::npos) comma = list.size();
+        const std::string item(list.substr(pos, comma - pos));
+        pos = comma + 1;
+        char* end = nullptr;
+        const long first = std::strtol(item.c_str(), &end, 10);
+        if (end == item.c_str()) continue;
+        long last = first;
+        if (*end == '-') {
+            const char* start = end + 1;
+            last = std::strtol(start, &end, 10);
+            if (end == start) last = first;
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+} // namespace detail
+
+class CpuTopology {
+public:
+    /**
+     * @brief Read the topology of this machine
+     *
+     * @param root Prefix for /sys and /proc (tests point it at a fake tree;
+     *             with a root, every CPU counts as allowed)
+     */
+    [[nodiscard]] static CpuTopology discover(const std::string& root = {}) {
+        namespace fs = std::filesystem;
+        CpuTopology topology;
+        const std::string cpu_dir = root + "/sys/devices/system/cpu";
+
+        std::vector<int> online = detail::parse_cpu_list(detail::read_first_line(cpu_dir + "/online"));
+        if (online.empty()) {
+            for (int cpu = 0; cpu < get_cpu_count(); ++cpu) online.push_back(cpu);
+        }
+        const auto isolated = detail::parse_cpu_list(detail::read_first_line(cpu_dir + "/isolated"));
+        const auto nohz_full = detail::parse_cpu_list(detail::read_first_line(cpu_dir + "/nohz_full"));
+        const auto allowed = root.empty() ? get_cpu_affinity() : online;
+        auto contains = [](const std::vector<int>& cpus, int cpu) {
+            return std::find(cpus.begin(), cpus.end(), cpu) != cpus.end();
+        };
+
+        for (int cpu : online) {
+            CpuCore core;
+            core.cpu = cpu;
+            const std::string dir = cpu_dir + "/cpu" + std::to_string(cpu);
+            core.core_id = detail::read_int(dir + "/topology/core_id", cpu);
+            core.package = detail::read_int(dir + "/topology/physical_package_id", 0);
+            auto threads = detail::parse_cpu_list(detail::read_first_line(dir + "/topology/thread_siblings_list"));
+            if (threads.empty()) threads.push_back(cpu);
+            core.smt_group = *std::min_element(threads.begin(), threads.end());
+            for (int t : threads) {
+                if (t != cpu) core.siblings.push_back(t);
+            }
+            for (int index = 0; index < 8; ++index) {
+                const std::string cache = dir + "/cache/index" + std::to_string(index);
+                const int level = detail::read_int(cache + "/level", -1);
+                if (level < 0) break;
+                if (detail::read_first_line(cache + "/type") == "Instruction") continue;
+                const auto shared = detail::parse_cpu_list(detail::read_first_line(cache + "/shared_cpu_list"));
+                if (shared.empty()) continue;
+                const int domain = *std::min_element(shared.begin(), shared.end());
+                if (level == 2) core.l2_domain = domain;
+                if (level == 3) core.l3_domain = domain;
+            }
+            core.numa_node = 0;
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(dir, ec)) {
+                const std::string name = entry.path().filename().string();
+                if (name.rfind("node", 0) == 0 && name.size() > 4) {
+                    core.numa_node = std::atoi(name.c_str() + 4);
+                    break;
+                }
+            }
+            core.allowed = contains(allowed, cpu);
+            core.isolated = contains(isolated, cpu);
+            core.nohz_full = contains(nohz_full, cpu);
+            const int khz = detail::read_int(dir + "/cpufreq/cpuinfo_max_freq", 0);
+            core.max_frequency_hz = static_cast<std::uint64_t>(std::max(khz, 0)) * 1000;
+            topology.cpus_.push_back(std::move(core));
+        }
+
+        // NIC queue IRQs: physical interfaces have a device with MSI vectors
+        std::error_code ec;
+        for (const auto& iface : fs::directory_iterator(root + "/sys/class/net", ec)) {
+            std::error_code irq_ec;
+            for (const auto& vector : fs::directory_iterator(iface.path() / "device" / "msi_irqs", irq_ec)) {
+                NicIrq irq;
+                irq.interface = iface.path().filename().string();
+                irq.irq = std::atoi(vector.path().filename().c_str());
+                irq.cpus = detail::parse_cpu_list(detail::read_first_line(
+                    root + "/proc/irq/" + std::to_string(irq.irq) + "/smp_affinity_list"));
+                for (int cpu : irq.cpus) {
+                    if (CpuCore* core = topology.find_mutable(cpu)) ++core->nic_irqs;
+                }
+                topology.nic_irqs_.push_back(std::move(irq));
+            }
+        }
+        std::sort(topology.nic_irqs_.begin(), topology.nic_irqs_.end(),
+                  [](const NicIrq& a, const NicIrq& b) { return a.irq < b.irq; });
+        return topology;
+    }
+
+    [[nodiscard]] const std::vector<CpuCore>& cpus() const noexcept { return cpus_; }
+    [[nodiscard]] const std::vector<NicIrq>& nic_irqs() const noexcept { return nic_irqs_; }
+
+    [[nodiscard]] const CpuCore* find(int cpu) const noexcept {
+        for (const auto& core : cpus_) {
+            if (core.cpu == cpu) return &core;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Distinct hardware threads of one physical core
+     */
+    [[nodiscard]] bool smt_siblings(int a, int b) const noexcept {
+        const CpuCore* x = find(a);
+        const CpuCore* y = find(b);
+        return x && y && a != b && x->smt_group == y->smt_group;
+    }
+
+    [[nodiscard]] bool share_l2(int a, int b) const noexcept {
+        return share(a, b, &CpuCore::l2_domain);
+    }
+
+    /**
+     * @brief Same L3 (same package where the cache layout is unknown)
+     */
+    [[nodiscard]] bool share_l3(int a, int b) const noexcept {
+        return share(a, b, &CpuCore::l3_domain);
+    }
+
+    [[nodiscard]] bool has_isolated() const noexcept {
+        return std::any_of(cpus_.begin(), cpus_.end(), [](const CpuCore& c) { return c.isolated; });
+    }
+
+    /**
+     * @brief The CPUInfo view of one CPU (core_id -1 if it is not online)
+     */
+    [[nodiscard]] CPUInfo info(int cpu) const noexcept {
+        const CpuCore* core = find(cpu);
+        if (!core) return CPUInfo{-1, 0, 0, false, 0};
+        return CPUInfo{core->core_id, core->package, core->numa_node, !core->siblings.empty(),
+                       core->max_frequency_hz};
+    }
+
+    void print(std::ostream& out = std::cout) const {
+        out << "  CPU  Core  Pkg  Node  L2   L3   SMT siblings  Flags\n";
+        for (const auto& core : cpus_) {
+            std::string siblings;
+            for (int s : core.siblings) {
+                if (!siblings.empty()) siblings += ',';
+                siblings += std::to_string(s);
+            }
+            std::string flags;
+            if (core.isolated) flags += " isolated";
+            if (core.nohz_full) flags += " nohz_full";
+            if (core.nic_irqs > 0) flags += " irqs=" + std::to_string(core.nic_irqs);
+            if (!core.allowed) flags += " not-allowed";
+            char line[128];
+            std::snprintf(line, sizeof(line), "  %3d  %4d  %3d  %4d  %3d  %3d  %-12s %s\n", core.cpu,
+                          core.core_id, core.package, core.numa_node, core.l2_domain, core.l3_domain,
+                          siblings.empty() ? "-" : siblings.c_str(), flags.c_str());
+            out << line;
+        }
+        for (const auto& irq : nic_irqs_) {
+            out << "  IRQ " << irq.irq << " (" << irq.interface << ") -> CPUs";
+            for (int cpu : irq.cpus) out << " " << cpu;
+            out << "\n";
+        }
+    }
+
+private:
+    [[nodiscard]] CpuCore* find_mutable(int cpu) noexcept {
+        return const_cast<CpuCore*>(find(cpu));
+    }
+
+    [[nodiscard]] bool share(int a, int b, int CpuCore::*domain) const noexcept {
+        const CpuCore* x = find(a);
+        const CpuCore* y = find(b);
+        if (!x || !y) return false;
+        if (x->*domain < 0 || y->*domain < 0) return x->package == y->package;
+        return x->*domain == y->*domain;
+    }
+
+    std::vector<CpuCore> cpus_;
+    std::vector<NicIrq> nic_irqs_;
+};
+
+/**
+ * @brief A thread to place
+ */
+struct ThreadSpec {
+    std::string name;
+    bool critical = true;       // Hot path: own physical core, isolated if possible
+    int hot_with = -1;          // Index of the spec it hands off to / from (keep in its L3)
+};
+
+struct PlacementPlan {
+    struct Thread {
+        std::string name;
+        int cpu = -1;           // -1 = left unpinned
+        bool critical = true;
+    };
+
+    std::vector<Thread> threads;            // In ThreadSpec order
+    std::vector<std::string> warnings;
+
+    [[nodiscard]] int cpu_of(std::string_view name) const noexcept {
+        for (const auto& thread : threads) {
+            if (thread.name == name) return thread.cpu;
+        }
+        return -1;
+    }
+
+    void print(std::ostream& out = std::cout) const {
+        for (const auto& thread : threads) {
+            out << "  " << thread.name << (thread.critical ? "" : " (housekeeping)") << ": ";
+            if (thread.cpu >= 0) {
+                out << "CPU " << thread.cpu << "\n";
+            } else {
+                out << "unpinned\n";
+            }
+        }
+        for (const auto& warning : warnings) {
+            out << "  Warning: " << warning << "\n";
+        }
+    }
+};
+
+namespace detail {
+
+inline void placement_warnings(const CpuTopology& topology, const std::vector<ThreadSpec>& specs,
+                               PlacementPlan& plan) {
+    for (std::size_t i = 0; i < plan.threads.size(); ++i) {
+        const auto& thread = plan.threads[i];
+        if (thread.cpu < 0) {
+            if (thread.critical) plan.warnings.push_back(thread.name + " is unpinned: no free core");
+            continue;
+        }
+        const CpuCore* core = topology.find(thread.cpu);
+        if (!core || !core->allowed) {
+            plan.warnings.push_back(thread.name + " on CPU " + std::to_string(thread.cpu) +
+                                    ": not online or not in this process's affinity mask");
+            continue;
+        }
+        if (!thread.critical) continue;
+        if (!core->isolated) {
+            plan.warnings.push_back(thread.name + " on CPU " + std::to_string(thread.cpu) +
+                                    ": not isolated (isolcpus), the scheduler may run other tasks there");
+        }
+        if (core->nic_irqs > 0) {
+            plan.warnings.push_back(thread.name + " on CPU " + std::to_string(thread.cpu) + ": takes " +
+                                    std::to_string(core->nic_irqs) + " NIC queue IRQs");
+        }
+        for (std::size_t j = 0; j < i; ++j) {
+            const auto& other = plan.threads[j];
+            if (!other.critical || other.cpu < 0) continue;
+            if (other.cpu == thread.cpu) {
+                plan.warnings.push_back(thread.name + " and " + other.name + " share CPU " +
+                                        std::to_string(thread.cpu));
+            } else if (topology.smt_siblings(thread.cpu, other.cpu)) {
+                plan.warnings.push_back(thread.name + " and " + other.name + " are SMT siblings (CPUs " +
+                                        std::to_string(other.cpu) + ", " + std::to_string(thread.cpu) + ")");
+            }
+        }
+        const int partner = specs[i].hot_with;
+        if (partner >= 0 && static_cast<std::size_t>(partner) < plan.threads.size()) {
+            const int partner_cpu = plan.threads[static_cast<std::size_t>(partner)].cpu;
+            if (partner_cpu >= 0 && !topology.share_l3(thread.cpu, partner_cpu)) {
+                plan.warnings.push_back(thread.name + " and " + plan.threads[static_cast<std::size_t>(partner)].name +
+                                        " do not share an L3");
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Assign specs to CPUs (see the file comment for the rules)
+ */
+[[nodiscard]] inline PlacementPlan plan_placement(const CpuTopology& topology,
+                                                  const std::vector<ThreadSpec>& specs) {
+    PlacementPlan plan;
+    plan.threads.resize(specs.size());
+    for (std::size_t i = 0; i < specs.size(); ++i) {
+        plan.threads[i].name = specs[i].name;
+        plan.threads[i].critical = specs[i].critical;
+    }
+
+    std::vector<const CpuCore*> usable;
+    for (const auto& core : topology.cpus()) {
+        if (core.allowed) usable.push_back(&core);
+    }
+    std::vector<int> used_cpus;         // Taken by any thread
+    std::vector<int> critical_groups;   // Physical cores hosting a critical thread
+    auto has = [](const std::vector<int>& v, int x) { return std::find(v.begin(), v.end(), x) != v.end(); };
+    auto group_free = [&](const CpuCore& core) {
+        if (has(critical_groups, core.smt_group)) return false;
+        for (const CpuCore* other : usable) {
+            if (other->smt_group == core.smt_group && has(used_cpus, other->cpu)) return false;
+        }
+        return true;
+    };
+
+    // L3 domain for the critical threads: the one with the most free isolated
+    // cores, then the most free cores; ties keep the lowest domain
+    std::size_t critical_count = 0;
+    for (const auto& spec : specs) critical_count += spec.critical;
+    int home_l3 = -2;
+    std::size_t best_isolated = 0;
+    std::size_t best_cores = 0;
+    for (const CpuCore* candidate : usable) {
+        std::vector<int> groups;
+        std::size_t isolated = 0;
+        for (const CpuCore* core : usable) {
+            if (!topology.share_l3(candidate->cpu, core->cpu) || has(groups, core->smt_group)) continue;
+            groups.push_back(core->smt_group);
+            isolated += core->isolated;
+        }
+        const std::size_t cores = std::min(groups.size(), critical_count);
+        if (home_l3 == -2 || std::min(isolated, critical_count) > best_isolated ||
+            (std::min(isolated, critical_count) == best_isolated && cores > best_cores)) {
+            home_l3 = candidate->cpu;
+            best_isolated = std::min(isolated, critical_count);
+            best_cores = cores;
+        }
+    }
+
+    // Lower is better; CPU 0 takes most housekeeping work, so it goes last
+    auto critical_cost = [&](const CpuCore& core, int near_cpu) {
+        int cost = 0;
+        if (!core.isolated) cost += 8;
+        if (core.nic_irqs > 0) cost += 4;
+        if (near_cpu >= 0 ? !topology.share_l3(core.cpu, near_cpu) : !topology.share_l3(core.cpu, home_l3)) cost += 16;
+        if (!core.nohz_full) cost += 1;
+        if (core.cpu == 0) cost += 2;
+        return cost;
+    };
+
+    for (std::size_t i = 0; i < specs.size(); ++i) {
+        if (!specs[i].critical) continue;
+        const int partner = specs[i].hot_with;
+        const int near_cpu = partner >= 0 && static_cast<std::size_t>(partner) < specs.size()
+            ? plan.threads[static_cast<std::size_t>(partner)].cpu : -1;
+        const CpuCore* best = nullptr;
+        int best_cost = 0;
+        for (const CpuCore* core : usable) {
+            if (!group_free(*core)) continue;
+            const int cost = critical_cost(*core, near_cpu);
+            if (!best || cost < best_cost) {
+                best = core;
+                best_cost = cost;
+            }
+        }
+        if (best) {
+            plan.threads[i].cpu = best->cpu;
+            used_cpus.push_back(best->cpu);
+            critical_groups.push_back(best->smt_group);
+        }
+    }
+
+    // Housekeeping: free CPUs, non-isolated and away from critical cores first
+    for (std::size_t i = 0; i < specs.size(); ++i) {
+        if (specs[i].critical) continue;
+        const CpuCore* best = nullptr;
+        int best_cost = 0;
+        for (const CpuCore* core : usable) {
+            if (has(used_cpus, core->cpu)) continue;
+            const int cost = (has(critical_groups, core->smt_group) ? 4 : 0) + (core->isolated ? 2 : 0);
+            if (!best || cost < best_cost) {
+                best = core;
+                best_cost = cost;
+            }
+        }
+        if (best && !has(critical_groups, best->smt_group)) {
+            plan.threads[i].cpu = best->cpu;
+            used_cpus.push_back(best->cpu);
+        } else if (best) {
+            // Only SMT siblings of critical cores left: unpinned shares better
+            plan.warnings.push_back(specs[i].name + " is unpinned: only SMT siblings of critical cores are free");
+        }
+    }
+
+    detail::placement_warnings(topology, specs, plan);
+    return plan;
+}
+
+/**
+ * @brief The warnings plan_placement() would give, for a hand-written placement
+ *
+ * @param cpus One CPU per spec (-1 or missing = unpinned)
+ */
+[[nodiscard]] inline PlacementPlan check_placement(const CpuTopology& topology,
+                                                   const std::vector<ThreadSpec>& specs,
+                                                   const std::vector<int>& cpus) {
+    PlacementPlan plan;
+    plan.threads.resize(specs.size());
+    for (std::size_t i = 0; i < specs.size(); ++i) {
+        plan.threads[i] = {specs[i].name, i < cpus.size() ? cpus[i] : -1, specs[i].critical};
+    }
+    detail::placement_warnings(topology, specs, plan);
+    return plan;
+}
+
+} // namespace hft
@@ -0,0 +1,166 @@
+/**
+ * @file hdr_histogram.hpp
+ * @brief Fixed-size log-linear (HDR-style) latency histogram
+ *
+ * Values are bucketed by powers of two, each split into enough linear
+ * sub-buckets to keep SignificantDigits decimal digits of precision, so the
+ * relative error of any reported value is below 10^-SignificantDigits:
+ * - Constant memory, sized at compile time (a plain array, so a histogram
+ *   is trivially copyable and can be published through a SeqLock)
+ * - O(1) record: one count-leading-zeros and an add
+ * - Mergeable: histograms of the same type add bucket-wise, so each thread
+ *   records into its own and a reader merges them
+ *
+ * Values above MaxValue are clamped to it (max() still reports the real
+ * maximum); negative values are recorded as 0.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace hft {
+
+template<int SignificantDigits = 2, std::int64_t MaxValue = 60'000'000'000>
+class HdrHistogram {
+    static_assert(SignificantDigits >= 1 && SignificantDigits <= 4, "1 to 4 significant digits");
+    static_assert(MaxValue > 0, "MaxValue must be positive");
+
+    static constexpr std::int64_t pow10(int n) noexcept {
+        std::int64_t v = 1;
+        while (n-- > 0) v *= 10;
+        return v;
+    }
+
+public:
+    // Sub-buckets per power of two: the smallest power of two >= 2 * 10^digits
+    static constexpr int SUB_BUCKET_BITS =
+        static_cast<int>(std::bit_width(static_cast<std::uint64_t>(2 * pow10(SignificantDigits) - 1)));
+    static constexpr std::int64_t SUB_BUCKET_COUNT = std::int64_t{1} << SUB_BUCKET_BITS;
+    static constexpr int SUB_BUCKET_HALF_BITS = SUB_BUCKET_BITS - 1;
+    static constexpr std::int64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+
+    // Powers of two needed to cover MaxValue
+    static constexpr int BUCKET_COUNT =
+        std::max(1, static_cast<int>(std::bit_width(static_cast<std::uint64_t>(MaxValue))) - SUB_BUCKET_BITS + 1);
+    static constexpr std::size_t COUNTS_LENGTH =
+        static_cast<std::size_t>((BUCKET_COUNT + 1) * SUB_BUCKET_HALF);
+
+    static constexpr std::int64_t max_trackable() noexcept { return MaxValue; }
+
+    void record(std::int64_t value, std::uint64_t count = 1) noexcept {
+        value = std::max<std::int64_t>(value, 0);
+        total_ += count;
+        sum_ += static_cast<double>(value) * static_cast<double>(count);
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+        counts_[index_of(std::min(value, MaxValue))] += count;
+    }
+
+    /**
+     * @brief Add another histogram's counts into this one
+     */
+    void merge(const HdrHistogram& other) noexcept {
+        if (other.total_ == 0) return;
+        for (std::size_t i = 0; i < COUNTS_LENGTH; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    void reset() noexcept {
+        counts_.fill(0);
+        total_ = 0;
+        sum_ = 0.0;
+        min_ = std::numeric_limits<std::int64_t>::max();
+        max_ = 0;
+    }
+
+    [[nodiscard]] std::uint64_t count() const noexcept { return total_; }
+    [[nodiscard]] bool empty() const noexcept { return total_ == 0; }
+    [[nodiscard]] std::int64_t min() const noexcept { return total_ ? min_ : 0; }
+    [[nodiscard]] std::int64_t max() const noexcept { return max_; }
+
+    [[nodiscard]] double mean() const noexcept {
+        return total_ ? sum_ / static_cast<double>(total_) : 0.0;
+    }
+
+    /**
+     * @brief Value at or below which percentile (0-100) of samples fall
+     *
+     * Reported as the highest value equivalent to the bucket reached,
+     * capped at max(), so it never understates a latency.
+     */
+    [[nodiscard]] std::int64_t value_at_percentile(double percentile) const noexcept {
+        if (total_ == 0) return 0;
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+        const auto target = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(clamped / 100.0 * static_cast<double>(total_) + 0.5));
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < COUNTS_LENGTH; ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::min(highest_equivalent(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    /**
+     * @brief Visit non-empty buckets in value order as (highest equivalent value, count)
+     */
+    template<typename Fn>
+    void for_each_bucket(Fn&& fn) const {
+        for (std::size_t i = 0; i < COUNTS_LENGTH; ++i) {
+            if (counts_[i] != 0) {
+                fn(std::min(highest_equivalent(i), max_), counts_[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Width of the bucket holding value (the resolution there)
+     */
+    [[nodiscard]] static constexpr std::int64_t bucket_width(std::int64_t value) noexcept {
+        return std::int64_t{1} << bucket_of(std::clamp<std::int64_t>(value, 0, MaxValue));
+    }
+
+private:
+    static constexpr int bucket_of(std::int64_t value) noexcept {
+        const auto v = static_cast<std::uint64_t>(value) | static_cast<std::uint64_t>(SUB_BUCKET_COUNT - 1);
+        return static_cast<int>(std::bit_width(v)) - 1 - SUB_BUCKET_HALF_BITS;
+    }
+
+    static constexpr std::size_t index_of(std::int64_t value) noexcept {
+        const int bucket = bucket_of(value);
+        const std::int64_t sub = value >> bucket;
+        return static_cast<std::size_t>(((bucket + 1) << SUB_BUCKET_HALF_BITS) + (sub - SUB_BUCKET_HALF));
+    }
+
+    static constexpr std::int64_t highest_equivalent(std::size_t index) noexcept {
+        int bucket = static_cast<int>(index >> SUB_BUCKET_HALF_BITS) - 1;
+        std::int64_t sub = static_cast<std::int64_t>(index & (SUB_BUCKET_HALF - 1)) + SUB_BUCKET_HALF;
+        if (bucket < 0) {
+            sub -= SUB_BUCKET_HALF;
+            bucket = 0;
+        }
+        return ((sub + 1) << bucket) - 1;
+    }
+
+    std::array<std::uint64_t, COUNTS_LENGTH> counts_{};
+    std::uint64_t total_ = 0;
+    double sum_ = 0.0;
+    std::int64_t min_ = std::numeric_limits<std::int64_t>::max();
+    std::int64_t max_ = 0;
+};
+
+} // namespace hft
@@ -0,0 +1,220 @@
+/**
+ * @file load_generator.hpp
+ * @brief Open-loop load driver with coordinated-omission-corrected latency
+ *
+ * A closed loop (send, wait for completion, pace, send) stops sending while
+ * the system under test stalls, so the messages that should have gone out
+ * during the stall are never measured and the tail looks better than it
+ * is. OpenLoopDriver instead sends on a timeline fixed in advance by an
+ * ArrivalSchedule (constant rate, Poisson arrivals or a replayed recording)
+ * and measures each message from its intended send time:
+ * - corrected(): done - intended, what a client of the system would see
+ * - service():   done - actually sent, the closed-loop number
+ *
+ * When the loop falls behind it does not wait, so a stall is paid back as
+ * a burst and every message it delayed carries the delay in corrected().
+ *
+ * Timestamps are fast_now() epoch nanoseconds.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "core/busy_poll.hpp"
+#include "core/timing.hpp"
+#include "core/tsc_clock.hpp"
+#include "core/types.hpp"
+
+namespace hft {
+
+enum class ArrivalPattern : std::uint8_t { CONSTANT, POISSON, REPLAY };
+
+[[nodiscard]] constexpr const char* to_string(ArrivalPattern pattern) noexcept {
+    switch (pattern) {
+        case ArrivalPattern::CONSTANT: return "constant";
+        case ArrivalPattern::POISSON: return "poisson";
+        case ArrivalPattern::REPLAY: return "replay";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Intended send times, as offsets from the start of the run
+ */
+class ArrivalSchedule {
+public:
+    static constexpr Duration END = -1;     // next() once a replay is exhausted
+
+    /**
+     * @brief One send every 1 / rate seconds
+     */
+    [[nodiscard]] static ArrivalSchedule constant(double rate) {
+        return ArrivalSchedule(ArrivalPattern::CONSTANT, rate);
+    }
+
+    /**
+     * @brief Exponential gaps with mean 1 / rate (bursts and lulls at the same mean rate)
+     */
+    [[nodiscard]] static ArrivalSchedule poisson(double rate, std::uint64_t seed = 42) {
+        ArrivalSchedule schedule(ArrivalPattern::POISSON, rate);
+        schedule.rng_.seed(seed);
+        schedule.gap_ = std::exponential_distribution<double>(schedule.rate_);
+        return schedule;
+    }
+
+    /**
+     * @brief Recorded send times (any epoch, ascending), sped up by speed
+     */
+    [[nodiscard]] static ArrivalSchedule replay(std::vector<Timestamp> times, double speed = 1.0) {
+        ArrivalSchedule schedule(ArrivalPattern::REPLAY, 0.0);
+        schedule.times_ = std::move(times);
+        schedule.speed_ = speed > 0.0 ? speed : 1.0;
+        if (schedule.times_.size() > 1) {
+            const auto span = static_cast<double>(schedule.times_.back() - schedule.times_.front());
+            schedule.rate_ = span > 0.0
+                ? static_cast<double>(schedule.times_.size() - 1) * 1e9 * schedule.speed_ / span
+                : 0.0;
+        }
+        return schedule;
+    }
+
+    /**
+     * @brief Offset of the next send, or END
+     */
+    [[nodiscard]] Duration next() noexcept {
+        switch (pattern_) {
+            case ArrivalPattern::CONSTANT:
+                return static_cast<Duration>(static_cast<double>(index_++) * 1e9 / rate_);
+            case ArrivalPattern::POISSON: {
+                const Duration offset = static_cast<Duration>(elapsed_ns_);
+                elapsed_ns_ += gap_(rng_) * 1e9;
+                return offset;
+            }
+            case ArrivalPattern::REPLAY:
+                if (index_ >= times_.size()) return END;
+                return static_cast<Duration>(
+                    static_cast<double>(times_[index_++] - times_.front()) / speed_);
+        }
+        return END;
+    }
+
+    [[nodiscard]] ArrivalPattern pattern() const noexcept { return pattern_; }
+    [[nodiscard]] double rate() const noexcept { return rate_; }       // Mean sends per second
+
+private:
+    ArrivalSchedule(ArrivalPattern pattern, double rate) noexcept
+        : pattern_(pattern), rate_(std::max(rate, 1e-9)) {}
+
+    ArrivalPattern pattern_;
+    double rate_;
+    std::uint64_t index_ = 0;
+    double elapsed_ns_ = 0.0;                           // POISSON
+    std::mt19937_64 rng_;
+    std::exponential_distribution<double> gap_;
+    std::vector<Timestamp> times_;                      // REPLAY
+    double speed_ = 1.0;
+};
+
+/**
+ * @brief Paces one sending thread on an ArrivalSchedule and records latency
+ *
+ * Single thread: wait_next(), send, record().
+ */
+class OpenLoopDriver {
+public:
+    // Sent this far behind schedule counts as late (as CaptureReplay)
+    static constexpr Duration LATE_THRESHOLD_NS = 1000;
+
+    explicit OpenLoopDriver(ArrivalSchedule schedule) noexcept : schedule_(std::move(schedule)) {}
+
+    /**
+     * @brief Anchor the schedule: the first send is due at origin
+     */
+    void start(Timestamp origin = fast_now()) noexcept {
+        origin_ = origin;
+    }
+
+    /**
+     * @brief Wait until the next send is due and return its intended time
+     *
+     * Returns at once when already behind. Returns 0 once a replay is
+     * exhausted.
+     */
+    [[nodiscard]] Timestamp wait_next() noexcept {
+        const Duration offset = schedule_.next();
+        if (offset == ArrivalSchedule::END) return 0;
+        const Timestamp due = origin_ + offset;
+        Timestamp now_ns = fast_now();
+        if (now_ns >= due) {
+            const Duration lag = now_ns - due;
+            late_ += lag > LATE_THRESHOLD_NS;
+            max_lag_ns_ = std::max(max_lag_ns_, lag);
+            return due;
+        }
+        // Sleep through long gaps, spin the last stretch
+        if (due - now_ns > 200'000) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(due - now_ns - 100'000));
+        }
+        while (fast_now() < due) {
+            cpu_pause();
+        }
+        return due;
+    }
+
+    /**
+     * @brief Record one message: intended (from wait_next), sent and completed times
+     */
+    void record(Timestamp intended, Timestamp sent, Timestamp done) noexcept {
+        corrected_.add_sample(done - intended);
+        service_.add_sample(done - sent);
+    }
+
+    /**
+     * @brief Drop the statistics (e.g. after warmup); the schedule runs on
+     */
+    void clear() noexcept {
+        corrected_.clear();
+        service_.clear();
+        late_ = 0;
+        max_lag_ns_ = 0;
+    }
+
+    [[nodiscard]] const ArrivalSchedule& schedule() const noexcept { return schedule_; }
+    [[nodiscard]] const LatencyStats& corrected() const noexcept { return corrected_; }
+    [[nodiscard]] const LatencyStats& service() const noexcept { return service_; }
+    [[nodiscard]] std::uint64_t late() const noexcept { return late_; }
+    [[nodiscard]] Duration max_lag_ns() const noexcept { return max_lag_ns_; }
+
+    /**
+     * @brief Print corrected and service-time percentiles side by side
+     */
+    void print(const char* indent = "  ") const {
+        std::printf("%sSchedule: %s, %.0f msg/s, %llu sent late (max lag %.2f us)\n", indent,
+                    to_string(schedule_.pattern()), schedule_.rate(),
+                    static_cast<unsigned long long>(late_), static_cast<double>(max_lag_ns_) / 1000.0);
+        std::printf("%s%-10s %10s %10s %10s %10s %12s\n", indent, "", "P50", "P99", "P99.9", "P99.99", "Max");
+        for (const auto& [label, stats] : {std::pair{"Corrected", &corrected_}, std::pair{"Service", &service_}}) {
+            if (stats->empty()) continue;
+            std::printf("%s%-10s %10.0f %10.0f %10.0f %10.0f %12.0f ns\n", indent, label,
+                        stats->percentile(50.0), stats->percentile(99.0), stats->percentile(99.9),
+                        stats->percentile(99.99), stats->max());
+        }
+    }
+
+private:
+    ArrivalSchedule schedule_;
+    Timestamp origin_ = 0;
+    LatencyStats corrected_;
+    LatencyStats service_;
+    std::uint64_t late_ = 0;
+    Duration max_lag_ns_ = 0;
+};
+
+} // namespace hft
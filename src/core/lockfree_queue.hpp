@@ -4,12 +4,15 @@
  * 
  * This implementation uses a ring buffer with cache-line padding to prevent
  * false sharing. Optimized for low-latency inter-thread communication.
+ * Also provides an unbounded MPSC list queue and a bounded, allocation-free
+ * MPMC ring (Vyukov) for fan-in from several producer threads.
  * 
  * Key optimizations:
  * - Cache-line aligned head/tail to prevent false sharing
  * - Power-of-2 size for fast modulo operations
  * - Acquire-release memory ordering for minimal synchronization
  * - Local caching of head/tail positions
+ * - Bulk push/pop that synchronize once per burst
  */
 
 #pragma once
@@ -19,6 +22,7 @@
 #include <cstddef>
 #include <optional>
 #include <new>
+#include <span>
 #include <type_traits>
 #include "types.hpp"
 
@@ -37,7 +41,9 @@ class SPSCQueue {
     static_assert(Capacity >= 2, "Capacity must be at least 2");
 
 public:
-    SPSCQueue() noexcept : buffer_(), head_(0), tail_(0), cached_head_(0), cached_tail_(0) {
+    // buffer_ is left uninitialized so a large ring placed in a MemoryRegion
+    // is only faulted in as it is used (or when the region is prefaulted)
+    SPSCQueue() noexcept : head_(0), tail_(0), cached_head_(0), cached_tail_(0) {
         static_assert(std::is_trivially_copyable_v<T> || std::is_move_constructible_v<T>,
                       "T must be trivially copyable or move constructible");
     }
@@ -128,6 +134,96 @@ public:
         return std::move(*result);
     }
 
+    /**
+     * @brief Push as many elements as fit (producer only)
+     * 
+     * One index publish for the whole run; the consumer's head is only
+     * re-read if the cached copy shows too little room.
+     * @return Number of elements pushed, in order
+     */
+    [[nodiscard]] std::size_t try_push_bulk(std::span<const T> items)
+        noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+
+        std::size_t free = (cached_head_ - tail - 1) & MASK;
+        if (free < items.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            free = (cached_head_ - tail - 1) & MASK;
+        }
+
+        const std::size_t n = items.size() < free ? items.size() : free;
+        for (std::size_t i = 0; i < n; ++i) {
+            new (&buffer_[(tail + i) & MASK]) T(items[i]);
+        }
+
+        if (n > 0) {
+            tail_.store((tail + n) & MASK, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Pop up to out.size() elements (consumer only)
+     * 
+     * One index publish for the whole run; the producer's tail is only
+     * re-read if the cached copy shows too few elements.
+     * @return Number of elements written to out
+     */
+    [[nodiscard]] std::size_t try_pop_bulk(std::span<T> out)
+        noexcept(std::is_nothrow_move_assignable_v<T>) {
+        const auto head = head_.load(std::memory_order_relaxed);
+
+        std::size_t available = (cached_tail_ - head) & MASK;
+        if (available < out.size()) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            available = (cached_tail_ - head) & MASK;
+        }
+
+        const std::size_t n = out.size() < available ? out.size() : available;
+        for (std::size_t i = 0; i < n; ++i) {
+            T* element = reinterpret_cast<T*>(&buffer_[(head + i) & MASK]);
+            out[i] = std::move(*element);
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                element->~T();
+            }
+        }
+
+        if (n > 0) {
+            head_.store((head + n) & MASK, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Hand every currently visible element to fn in place (consumer only)
+     * 
+     * Reads the producer's tail once and publishes the new head once, so a
+     * burst costs one cross-core round trip instead of one per element.
+     * Slots are released only after fn has seen all of them.
+     * 
+     * @param fn Callable taking (T&)
+     * @return Number of elements consumed
+     */
+    template<typename Fn>
+    std::size_t consume_all(Fn&& fn) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+
+        const std::size_t n = (cached_tail_ - head) & MASK;
+        for (std::size_t i = 0; i < n; ++i) {
+            T* element = reinterpret_cast<T*>(&buffer_[(head + i) & MASK]);
+            fn(*element);
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                element->~T();
+            }
+        }
+
+        if (n > 0) {
+            head_.store((head + n) & MASK, std::memory_order_release);
+        }
+        return n;
+    }
+
     /**
      * @brief Peek at the front element without removing (consumer only)
      * @return Pointer to front element, or nullptr if empty
@@ -272,5 +368,252 @@ private:
     alignas(CACHE_LINE_SIZE) std::atomic<Node*> tail_;
 };
 
-} // namespace hft
+/**
+ * @brief Bounded lock-free Multi-Producer Multi-Consumer (MPMC) ring
+ * 
+ * Dmitry Vyukov's bounded queue: each slot carries a sequence number that
+ * tells producers whether it is free for lap N and consumers whether it
+ * holds the element for lap N. A single CAS on the shared cursor claims a
+ * slot (or a run of slots for the batch calls); no allocation after
+ * construction. Also the allocation-free choice for MPSC fan-in.
+ * 
+ * @tparam T Element type (should be trivially copyable for best performance)
+ * @tparam Capacity Queue capacity (must be power of 2)
+ */
+template<typename T, std::size_t Capacity>
+class MPMCQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, 
+                  "Capacity must be a power of 2");
+    static_assert(Capacity >= 2, "Capacity must be at least 2");
 
+public:
+    MPMCQueue() noexcept {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos_.store(0, std::memory_order_relaxed);
+        dequeue_pos_.store(0, std::memory_order_relaxed);
+    }
+
+    ~MPMCQueue() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            while (try_pop()) {}
+        }
+    }
+
+    // Non-copyable, non-movable
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+    MPMCQueue(MPMCQueue&&) = delete;
+    MPMCQueue& operator=(MPMCQueue&&) = delete;
+
+    /**
+     * @brief Try to push an element (any thread)
+     * @return true if successful, false if queue is full
+     */
+    template<typename U>
+    [[nodiscard]] bool try_push(U&& value) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & MASK];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Queue is full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->data) T(std::forward<U>(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Push with busy-wait (any thread)
+     */
+    template<typename U>
+    void push(U&& value) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
+        while (!try_push(std::forward<U>(value))) {
+            cpu_pause();
+        }
+    }
+
+    /**
+     * @brief Try to pop an element (any thread)
+     * @return Optional containing the element, or empty if queue is empty
+     */
+    [[nodiscard]] std::optional<T> try_pop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & MASK];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;  // Queue is empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::optional<T> value(take(*cell));
+        cell->sequence.store(pos + Capacity, std::memory_order_release);
+        return value;
+    }
+
+    /**
+     * @brief Pop with busy-wait (any thread)
+     */
+    [[nodiscard]] T pop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+        std::optional<T> result;
+        while (!(result = try_pop())) {
+            cpu_pause();
+        }
+        return std::move(*result);
+    }
+
+    /**
+     * @brief Push up to count elements with one cursor CAS
+     * 
+     * Elements are copied in order into consecutive slots.
+     * @return Number of elements pushed (0 if full)
+     */
+    [[nodiscard]] std::size_t try_push_n(const T* items, std::size_t count) {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        std::size_t n;
+        while (true) {
+            n = run_length(pos, count, 0);
+            if (n == 0) {
+                const std::size_t seq = cells_[pos & MASK].sequence.load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(seq - pos) < 0) return 0;  // Full
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            Cell& cell = cells_[(pos + i) & MASK];
+            new (cell.data) T(items[i]);
+            cell.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Pop up to max_count elements with one cursor CAS
+     * 
+     * @param out Destination array (at least max_count elements)
+     * @return Number of elements popped (0 if empty)
+     */
+    [[nodiscard]] std::size_t try_pop_n(T* out, std::size_t max_count) {
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        std::size_t n;
+        while (true) {
+            n = run_length(pos, max_count, 1);
+            if (n == 0) {
+                const std::size_t seq = cells_[pos & MASK].sequence.load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0) return 0;  // Empty
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            Cell& cell = cells_[(pos + i) & MASK];
+            out[i] = take(cell);
+            cell.sequence.store(pos + i + Capacity, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Check if queue is empty (approximate under concurrency)
+     */
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Get current size (approximate, may race with push/pop)
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        const auto tail = enqueue_pos_.load(std::memory_order_acquire);
+        const auto head = dequeue_pos_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * @brief Get queue capacity
+     */
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+        return Capacity;
+    }
+
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        alignas(alignof(T)) unsigned char data[sizeof(T)];
+    };
+
+    static T take(Cell& cell) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        T* element = reinterpret_cast<T*>(cell.data);
+        T value = std::move(*element);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            element->~T();
+        }
+        return value;
+    }
+
+    /**
+     * @brief Count consecutive cells from pos ready for this lap
+     * 
+     * @param offset 0 when looking for free cells, 1 for filled cells
+     */
+    [[nodiscard]] std::size_t run_length(std::size_t pos, std::size_t limit,
+                                         std::size_t offset) const noexcept {
+        limit = limit < Capacity ? limit : Capacity;
+        std::size_t n = 0;
+        while (n < limit &&
+               cells_[(pos + n) & MASK].sequence.load(std::memory_order_acquire) == pos + n + offset) {
+            ++n;
+        }
+        return n;
+    }
+
+    static void cpu_pause() noexcept {
+        #if defined(__x86_64__) || defined(_M_X64)
+            __builtin_ia32_pause();
+        #elif defined(__aarch64__)
+            asm volatile("yield" ::: "memory");
+        #else
+            std::this_thread::yield();
+        #endif
+    }
+
+    std::array<Cell, Capacity> cells_;
+
+    // Cache-line separated cursors: producers and consumers never share a line
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueue_pos_;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeue_pos_;
+};
+
+} // namespace hft
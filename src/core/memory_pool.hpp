@@ -11,6 +11,9 @@
  * - Optional thread-safe version with spinlock
  * - Cache-aligned allocations
  * - No heap fragmentation
+ * - Storage is a MemoryRegion (huge pages, NUMA binding, prefault/mlock)
+ * - Slots are handed out by a bump index until first reuse, so construction
+ *   does not touch the whole pool
  */
 
 #pragma once
@@ -24,6 +27,7 @@
 #include <cassert>
 #include "types.hpp"
 #include "spinlock.hpp"
+#include "memory_region.hpp"
 
 namespace hft {
 
@@ -49,20 +53,17 @@ class MemoryPool {
     };
 
 public:
-    MemoryPool() : storage_(new (std::align_val_t(Alignment)) std::uint8_t[Capacity * ALIGNED_SIZE]) {
-        // Initialize free list - use heap-allocated storage
-        free_head_ = reinterpret_cast<FreeNode*>(storage_.get());
-        FreeNode* current = free_head_;
-        
-        for (std::size_t i = 1; i < Capacity; ++i) {
-            FreeNode* next = reinterpret_cast<FreeNode*>(
-                storage_.get() + i * ALIGNED_SIZE);
-            current->next = next;
-            current = next;
+    MemoryPool() : MemoryPool(default_memory_policy()) {}
+
+    /**
+     * @param policy Page size, NUMA node and residency of the pool's storage
+     */
+    explicit MemoryPool(const MemoryPolicy& policy)
+        : storage_(Capacity * ALIGNED_SIZE, policy) {
+        if (!storage_) {
+            throw std::bad_alloc();
         }
-        current->next = nullptr;
-        
-        allocated_count_ = 0;
+        static_assert(Alignment <= MemoryRegion::HUGE_PAGE_SIZE);
     }
     
     ~MemoryPool() = default;
@@ -78,12 +79,15 @@ public:
      * @return Pointer to allocated memory, or nullptr if pool is exhausted
      */
     [[nodiscard]] void* allocate() noexcept {
-        if (free_head_ == nullptr) {
+        void* block;
+        if (free_head_ != nullptr) {
+            block = free_head_;
+            free_head_ = free_head_->next;
+        } else if (next_unused_ < Capacity) {
+            block = storage_.data() + next_unused_++ * ALIGNED_SIZE;
+        } else {
             return nullptr;
         }
-        
-        void* block = free_head_;
-        free_head_ = free_head_->next;
         ++allocated_count_;
         
         return block;
@@ -140,8 +144,8 @@ public:
      */
     [[nodiscard]] bool owns(const void* ptr) const noexcept {
         const auto* byte_ptr = static_cast<const std::uint8_t*>(ptr);
-        const auto* start = storage_.get();
-        const auto* end = storage_.get() + Capacity * ALIGNED_SIZE;
+        const auto* start = storage_.data();
+        const auto* end = storage_.data() + Capacity * ALIGNED_SIZE;
         
         if (byte_ptr < start || byte_ptr >= end) {
             return false;
@@ -173,6 +177,13 @@ public:
         return Capacity;
     }
 
+    /**
+     * @brief Backing storage, to check which MemoryPolicy was honoured
+     */
+    [[nodiscard]] const MemoryRegion& region() const noexcept {
+        return storage_;
+    }
+
     /**
      * @brief Check if pool is empty
      */
@@ -188,27 +199,25 @@ public:
     }
 
 private:
-    // Deleter for aligned memory
-    struct AlignedDeleter {
-        void operator()(std::uint8_t* ptr) const {
-            ::operator delete[](ptr, std::align_val_t(Alignment));
-        }
-    };
-    
-    std::unique_ptr<std::uint8_t[], AlignedDeleter> storage_;
-    FreeNode* free_head_;
-    std::size_t allocated_count_;
+    MemoryRegion storage_;
+    FreeNode* free_head_ = nullptr;     // Released slots, most recent first
+    std::size_t next_unused_ = 0;       // Slots at and past this were never handed out
+    std::size_t allocated_count_ = 0;
 };
 
 /**
  * @brief Thread-safe memory pool with spinlock protection
  * 
  * Use this when multiple threads need to allocate from the same pool.
- * For best performance, prefer per-thread pools when possible.
+ * For best performance, prefer per-thread pools when possible, or
+ * SlabAllocator (slab_allocator.hpp) when blocks are freed on another thread.
  */
 template<typename T, std::size_t Capacity, std::size_t Alignment = CACHE_LINE_SIZE>
 class ThreadSafeMemoryPool {
 public:
+    ThreadSafeMemoryPool() = default;
+    explicit ThreadSafeMemoryPool(const MemoryPolicy& policy) : pool_(policy) {}
+
     [[nodiscard]] void* allocate() noexcept {
         std::lock_guard<Spinlock> lock(spinlock_);
         return pool_.allocate();
@@ -0,0 +1,324 @@
+/**
+ * @file memory_region.hpp
+ * @brief Page-size, NUMA and residency policy for large preallocated buffers
+ *
+ * Pools, queues and event buffers are sized for the worst case up front
+ * (an order book pool is ~128 MB). Backing them with 4 KB pages costs a TLB
+ * miss on most random accesses and a page fault on first touch. A
+ * MemoryRegion is an anonymous mapping that can instead be:
+ * - backed by explicit huge pages (MAP_HUGETLB, falls back to THP), or by
+ *   transparent huge pages (2 MB aligned + MADV_HUGEPAGE)
+ * - bound to a NUMA node (mbind), e.g. the node of the core that uses it
+ * - prefaulted and mlock()ed, so the hot path never page-faults
+ *
+ * Policies degrade silently: a region is always usable, and the accessors
+ * report what was actually obtained. Regions under 1 MB always use base
+ * pages. NUMA binding uses the mbind syscall directly (no libnuma).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#include "types.hpp"
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hft {
+
+enum class PageSize : std::uint8_t {
+    SMALL,              // Base pages
+    TRANSPARENT_HUGE,   // THP: 2 MB aligned, MADV_HUGEPAGE
+    HUGE_2MB            // MAP_HUGETLB from the hugetlbfs pool, THP if none reserved
+};
+
+/**
+ * @brief How a MemoryRegion is backed
+ */
+struct MemoryPolicy {
+    static constexpr int NUMA_ANY = -1;     // First-touch placement
+    static constexpr int NUMA_LOCAL = -2;   // Node of the allocating thread
+
+    PageSize page_size = PageSize::TRANSPARENT_HUGE;
+    int numa_node = NUMA_ANY;
+    bool prefault = false;      // Touch every page at allocation
+    bool lock = false;          // mlock() (implies prefault)
+
+    /**
+     * @brief Huge pages, local node, resident: for hot-path pools and rings
+     */
+    static MemoryPolicy resident(int node = NUMA_LOCAL) noexcept {
+        return {PageSize::HUGE_2MB, node, true, true};
+    }
+};
+
+/**
+ * @brief Process-wide policy used by pools and queues that are not given one
+ *
+ * Set it once at startup, before the engine and its books are created.
+ */
+inline MemoryPolicy& default_memory_policy() noexcept {
+    static MemoryPolicy policy;
+    return policy;
+}
+
+/**
+ * @brief NUMA node of the calling thread's current CPU (0 if unknown)
+ */
+inline int current_numa_node() noexcept {
+    #ifdef __linux__
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return static_cast<int>(node);
+    }
+    #endif
+    return 0;
+}
+
+/**
+ * @brief Owning anonymous mapping with a MemoryPolicy
+ */
+class MemoryRegion {
+public:
+    static constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    MemoryRegion() noexcept = default;
+
+    /**
+     * @param bytes Usable size; rounded up to the page size in use
+     * Check with operator bool: empty only if the mapping itself failed.
+     */
+    explicit MemoryRegion(std::size_t bytes, const MemoryPolicy& policy = default_memory_policy()) {
+        if (bytes == 0) return;
+        #ifdef __linux__
+        map(bytes, policy);
+        #else
+        (void)policy;
+        data_ = static_cast<std::uint8_t*>(::operator new(bytes, std::align_val_t(CACHE_LINE_SIZE), std::nothrow));
+        if (data_) {
+            std::memset(data_, 0, bytes);
+            size_ = bytes;
+        }
+        #endif
+    }
+
+    ~MemoryRegion() { release(); }
+
+    MemoryRegion(const MemoryRegion&) = delete;
+    MemoryRegion& operator=(const MemoryRegion&) = delete;
+
+    MemoryRegion(MemoryRegion&& other) noexcept { swap(other); }
+
+    MemoryRegion& operator=(MemoryRegion&& other) noexcept {
+        if (this != &other) {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] std::uint8_t* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    explicit operator bool() const noexcept { return data_ != nullptr; }
+
+    /**
+     * @brief Backed by MAP_HUGETLB pages (THP use is up to the kernel)
+     */
+    [[nodiscard]] bool huge_pages() const noexcept { return huge_; }
+    [[nodiscard]] bool locked() const noexcept { return locked_; }
+
+    /**
+     * @brief Node the region was bound to, NUMA_ANY if not bound
+     */
+    [[nodiscard]] int numa_node() const noexcept { return node_; }
+
+private:
+    #ifdef __linux__
+    void map(std::size_t bytes, const MemoryPolicy& policy) {
+        const std::size_t huge_bytes = round_up(bytes, HUGE_PAGE_SIZE);
+        // Small buffers would waste most of a huge page
+        const PageSize page_size = bytes < HUGE_PAGE_SIZE / 2 ? PageSize::SMALL : policy.page_size;
+
+        if (page_size == PageSize::HUGE_2MB) {
+            void* addr = mmap(nullptr, huge_bytes, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (addr != MAP_FAILED) {
+                data_ = static_cast<std::uint8_t*>(addr);
+                mapped_ = data_;
+                size_ = mapped_size_ = huge_bytes;
+                huge_ = true;
+            }
+        }
+
+        if (!data_ && page_size != PageSize::SMALL) {
+            // Over-map by one huge page and trim, so the region is 2 MB aligned
+            // and every 2 MB of it can be a transparent huge page
+            const std::size_t span = huge_bytes + HUGE_PAGE_SIZE;
+            void* addr = mmap(nullptr, span, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (addr != MAP_FAILED) {
+                auto* raw = static_cast<std::uint8_t*>(addr);
+                auto* aligned = reinterpret_cast<std::uint8_t*>(
+                    round_up(reinterpret_cast<std::uintptr_t>(raw), HUGE_PAGE_SIZE));
+                if (aligned > raw) munmap(raw, static_cast<std::size_t>(aligned - raw));
+                const std::size_t tail = static_cast<std::size_t>(raw + span - (aligned + huge_bytes));
+                if (tail > 0) munmap(aligned + huge_bytes, tail);
+                madvise(aligned, huge_bytes, MADV_HUGEPAGE);
+                data_ = mapped_ = aligned;
+                size_ = mapped_size_ = huge_bytes;
+            }
+        }
+
+        if (!data_) {
+            const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            const std::size_t small_bytes = round_up(bytes, page);
+            void* addr = mmap(nullptr, small_bytes, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (addr == MAP_FAILED) return;
+            data_ = mapped_ = static_cast<std::uint8_t*>(addr);
+            size_ = mapped_size_ = small_bytes;
+        }
+
+        // Bind before the first touch, or pages land wherever they fault
+        const int node = policy.numa_node == MemoryPolicy::NUMA_LOCAL
+            ? current_numa_node() : policy.numa_node;
+        if (node >= 0 && bind(node)) {
+            node_ = node;
+        }
+
+        if (policy.lock) {
+            locked_ = mlock(data_, size_) == 0;
+        }
+        if (policy.prefault && !locked_) {
+            prefault();
+        }
+    }
+
+    bool bind(int node) noexcept {
+        #ifdef SYS_mbind
+        if (node >= 64) return false;
+        constexpr int MPOL_PREFERRED_MODE = 1;     // Falls back to other nodes when full
+        const unsigned long mask = 1UL << node;
+        return syscall(SYS_mbind, data_, size_, MPOL_PREFERRED_MODE, &mask,
+                       sizeof(mask) * 8, 0) == 0;
+        #else
+        (void)node;
+        return false;
+        #endif
+    }
+
+    void prefault() noexcept {
+        #ifdef MADV_POPULATE_WRITE
+        if (madvise(data_, size_, MADV_POPULATE_WRITE) == 0) return;
+        #endif
+        const std::size_t step = huge_ ? HUGE_PAGE_SIZE : static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        for (std::size_t i = 0; i < size_; i += step) {
+            reinterpret_cast<volatile std::uint8_t*>(data_)[i] = 0;
+        }
+    }
+    #endif
+
+    void release() noexcept {
+        if (!data_) return;
+        #ifdef __linux__
+        munmap(mapped_, mapped_size_);
+        #else
+        ::operator delete(data_, std::align_val_t(CACHE_LINE_SIZE));
+        #endif
+        data_ = mapped_ = nullptr;
+        size_ = mapped_size_ = 0;
+    }
+
+    void swap(MemoryRegion& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(mapped_, other.mapped_);
+        std::swap(size_, other.size_);
+        std::swap(mapped_size_, other.mapped_size_);
+        std::swap(huge_, other.huge_);
+        std::swap(locked_, other.locked_);
+        std::swap(node_, other.node_);
+    }
+
+    static constexpr std::size_t round_up(std::size_t value, std::size_t to) noexcept {
+        return (value + to - 1) / to * to;
+    }
+
+    std::uint8_t* data_ = nullptr;
+    std::uint8_t* mapped_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t mapped_size_ = 0;
+    bool huge_ = false;
+    bool locked_ = false;
+    int node_ = MemoryPolicy::NUMA_ANY;
+};
+
+/**
+ * @brief Single object placed in its own MemoryRegion (unique_ptr-like)
+ *
+ * For large objects with inline storage, such as SPSCQueue rings.
+ */
+template<typename T>
+class RegionPtr {
+public:
+    RegionPtr() noexcept = default;
+
+    template<typename... Args>
+    static RegionPtr make(const MemoryPolicy& policy, Args&&... args) {
+        RegionPtr ptr;
+        ptr.region_ = MemoryRegion(sizeof(T), policy);
+        if (!ptr.region_) throw std::bad_alloc();
+        static_assert(alignof(T) <= MemoryRegion::HUGE_PAGE_SIZE);
+        ptr.object_ = new (ptr.region_.data()) T(std::forward<Args>(args)...);
+        return ptr;
+    }
+
+    ~RegionPtr() { reset(); }
+
+    RegionPtr(RegionPtr&& other) noexcept
+        : region_(std::move(other.region_)), object_(std::exchange(other.object_, nullptr)) {}
+
+    RegionPtr& operator=(RegionPtr&& other) noexcept {
+        if (this != &other) {
+            reset();
+            region_ = std::move(other.region_);
+            object_ = std::exchange(other.object_, nullptr);
+        }
+        return *this;
+    }
+
+    void reset() noexcept {
+        if (object_) {
+            object_->~T();
+            object_ = nullptr;
+        }
+        region_ = MemoryRegion();
+    }
+
+    T* get() const noexcept { return object_; }
+    T* operator->() const noexcept { return object_; }
+    T& operator*() const noexcept { return *object_; }
+    explicit operator bool() const noexcept { return object_ != nullptr; }
+
+    [[nodiscard]] const MemoryRegion& region() const noexcept { return region_; }
+
+private:
+    MemoryRegion region_;
+    T* object_ = nullptr;
+};
+
+template<typename T, typename... Args>
+[[nodiscard]] RegionPtr<T> make_in_region(const MemoryPolicy& policy, Args&&... args) {
+    return RegionPtr<T>::make(policy, std::forward<Args>(args)...);
+}
+
+} // namespace hft
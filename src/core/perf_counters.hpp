@@ -0,0 +1,353 @@
+/**
+ * @file perf_counters.hpp
+ * @brief Hardware performance counters around a measured region
+ *
+ * PerfCounters opens one perf_event group for the calling thread (user
+ * space only): cycles, instructions, L1D read misses, LLC misses, branch
+ * misses and dTLB read misses. Each counter's page is mapped so read() is a
+ * handful of RDPMC instructions, no syscall, when the kernel allows user
+ * RDPMC (the default once the event is mapped); otherwise it falls back to
+ * one read() of the group.
+ *
+ *   PerfCounters counters;
+ *   counters.open();                   // On the measured thread
+ *   PerfCounterStats stats;
+ *   {
+ *       PerfScope scope(counters, stats);
+ *       book.add_order(order);
+ *   }
+ *   stats.print(counters, "Add order");
+ *
+ * Events the CPU or hypervisor does not offer are left out; open() only
+ * fails when no hardware counters are available at all (no PMU, or
+ * kernel.perf_event_paranoid too high), with the reason in error().
+ */
+
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+
+namespace hft {
+
+#ifdef __linux__
+namespace detail {
+
+struct PerfEventConfig {
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+constexpr std::uint64_t perf_cache_miss(std::uint64_t cache) noexcept {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// In PerfCounters::Event order
+inline constexpr std::array<PerfEventConfig, 6> PERF_EVENTS{{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, perf_cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, perf_cache_miss(PERF_COUNT_HW_CACHE_DTLB)},
+}};
+
+} // namespace detail
+#endif
+
+class PerfCounters {
+public:
+    enum Event : std::size_t {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        DTLB_MISSES,
+        EVENT_COUNT
+    };
+
+    struct Sample {
+        std::array<std::uint64_t, EVENT_COUNT> counts{};
+
+        [[nodiscard]] Sample operator-(const Sample& earlier) const noexcept {
+            Sample delta;
+            for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+                delta.counts[i] = counts[i] - earlier.counts[i];
+            }
+            return delta;
+        }
+
+        [[nodiscard]] std::uint64_t operator[](Event event) const noexcept { return counts[event]; }
+    };
+
+    [[nodiscard]] static constexpr const char* name(Event event) noexcept {
+        switch (event) {
+            case CYCLES: return "Cycles";
+            case INSTRUCTIONS: return "Instructions";
+            case L1D_MISSES: return "L1D misses";
+            case LLC_MISSES: return "LLC misses";
+            case BRANCH_MISSES: return "Branch misses";
+            case DTLB_MISSES: return "dTLB misses";
+            case EVENT_COUNT: break;
+        }
+        return "Unknown";
+    }
+
+    PerfCounters() { fds_.fill(-1); }
+
+    ~PerfCounters() {
+        close();
+    }
+
+    // Non-copyable
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief Open and start the group for the calling thread
+     *
+     * Read the counters only from this thread.
+     */
+    bool open() {
+        #ifdef __linux__
+        close();
+        for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = detail::PERF_EVENTS[i].type;
+            attr.config = detail::PERF_EVENTS[i].config;
+            attr.disabled = leader_ < 0;
+            attr.pinned = leader_ < 0;         // Whole group on the PMU or not at all
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader_,
+                                                    PERF_FLAG_FD_CLOEXEC));
+            if (fd < 0) {
+                if (i == CYCLES) {
+                    error_ = std::string("perf_event_open: ") + std::strerror(errno);
+                    if (errno == EACCES || errno == EPERM) {
+                        error_ += " (see kernel.perf_event_paranoid)";
+                    }
+                    return false;
+                }
+                continue;                       // Event not offered here
+            }
+            if (leader_ < 0) leader_ = fd;
+            fds_[i] = fd;
+            group_index_[i] = group_size_++;
+
+            void* page = mmap(nullptr, static_cast<std::size_t>(sysconf(_SC_PAGESIZE)), PROT_READ,
+                              MAP_SHARED, fd, 0);
+            pages_[i] = page == MAP_FAILED ? nullptr : static_cast<perf_event_mmap_page*>(page);
+        }
+
+        ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+        // The kernel fills in the capabilities once the group is scheduled
+        #if defined(__x86_64__) || defined(_M_X64)
+        rdpmc_ = true;
+        for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+            if (fds_[i] >= 0 && (!pages_[i] || !pages_[i]->cap_user_rdpmc)) rdpmc_ = false;
+        }
+        #endif
+        error_.clear();
+        return true;
+        #else
+        error_ = "perf_event_open: Linux only";
+        return false;
+        #endif
+    }
+
+    void close() noexcept {
+        #ifdef __linux__
+        const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+            if (pages_[i]) munmap(pages_[i], page_size);
+            if (fds_[i] >= 0) ::close(fds_[i]);
+            pages_[i] = nullptr;
+            fds_[i] = -1;
+        }
+        #endif
+        leader_ = -1;
+        group_size_ = 0;
+        rdpmc_ = false;
+    }
+
+    [[nodiscard]] bool is_open() const noexcept { return leader_ >= 0; }
+    [[nodiscard]] bool has(Event event) const noexcept { return fds_[event] >= 0; }
+    [[nodiscard]] bool uses_rdpmc() const noexcept { return rdpmc_; }
+    [[nodiscard]] const std::string& error() const noexcept { return error_; }
+
+    /**
+     * @brief Current counts (zeros when not open or an event is missing)
+     */
+    [[nodiscard]] Sample read() const noexcept {
+        Sample sample;
+        if (leader_ < 0) return sample;
+        #if defined(__linux__) && (defined(__x86_64__) || defined(_M_X64))
+        if (rdpmc_) {
+            bool complete = true;
+            for (std::size_t i = 0; i < EVENT_COUNT && complete; ++i) {
+                if (fds_[i] >= 0) complete = read_rdpmc(*pages_[i], sample.counts[i]);
+            }
+            if (complete) return sample;
+        }
+        #endif
+        read_group(sample);
+        return sample;
+    }
+
+private:
+    #ifdef __linux__
+    #if defined(__x86_64__) || defined(_M_X64)
+    // Self-monitoring read, as in perf_event_open(2); false if not on the PMU
+    static bool read_rdpmc(const perf_event_mmap_page& page, std::uint64_t& count) noexcept {
+        const volatile perf_event_mmap_page& pc = page;
+        std::uint32_t seq;
+        std::uint64_t value;
+        std::uint32_t index;
+        do {
+            seq = pc.lock;
+            asm volatile("" ::: "memory");
+            index = pc.index;
+            value = static_cast<std::uint64_t>(pc.offset);
+            if (index != 0) {
+                const std::uint32_t width = pc.pmc_width;
+                auto raw = static_cast<std::int64_t>(__rdpmc(static_cast<int>(index - 1)));
+                raw <<= 64 - width;
+                raw >>= 64 - width;             // Sign-extend the counter width
+                value += static_cast<std::uint64_t>(raw);
+            }
+            asm volatile("" ::: "memory");
+        } while (pc.lock != seq);
+        count = value;
+        return index != 0;
+    }
+    #endif
+
+    void read_group(Sample& sample) const noexcept {
+        std::array<std::uint64_t, 1 + EVENT_COUNT> buffer{};
+        const auto bytes = ::read(leader_, buffer.data(), sizeof(buffer));
+        if (bytes < static_cast<ssize_t>(sizeof(std::uint64_t) * (1 + group_size_))) return;
+        for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+            if (fds_[i] >= 0) sample.counts[i] = buffer[1 + group_index_[i]];
+        }
+    }
+
+    std::array<perf_event_mmap_page*, EVENT_COUNT> pages_{};
+    #else
+    void read_group(Sample&) const noexcept {}
+    #endif
+
+    std::array<int, EVENT_COUNT> fds_;
+    std::array<std::size_t, EVENT_COUNT> group_index_{};   // Position in the group read
+    std::size_t group_size_ = 0;
+    int leader_ = -1;
+    bool rdpmc_ = false;
+    std::string error_;
+};
+
+#ifdef __linux__
+static_assert(detail::PERF_EVENTS.size() == PerfCounters::EVENT_COUNT, "Event table out of step");
+#endif
+
+/**
+ * @brief Counter totals over many measured regions, reported per operation
+ */
+class PerfCounterStats {
+public:
+    void add(const PerfCounters::Sample& delta, std::uint64_t ops = 1) noexcept {
+        for (std::size_t i = 0; i < PerfCounters::EVENT_COUNT; ++i) {
+            totals_.counts[i] += delta.counts[i];
+        }
+        ops_ += ops;
+    }
+
+    void clear() noexcept {
+        totals_ = {};
+        ops_ = 0;
+    }
+
+    [[nodiscard]] std::uint64_t ops() const noexcept { return ops_; }
+    [[nodiscard]] std::uint64_t total(PerfCounters::Event event) const noexcept { return totals_[event]; }
+
+    [[nodiscard]] double per_op(PerfCounters::Event event) const noexcept {
+        return ops_ ? static_cast<double>(totals_[event]) / static_cast<double>(ops_) : 0.0;
+    }
+
+    [[nodiscard]] double ipc() const noexcept {
+        return totals_[PerfCounters::CYCLES]
+            ? static_cast<double>(totals_[PerfCounters::INSTRUCTIONS]) /
+              static_cast<double>(totals_[PerfCounters::CYCLES])
+            : 0.0;
+    }
+
+    /**
+     * @brief Print per-op counts for the events counters has open
+     */
+    void print(const PerfCounters& counters, const char* label = "Hardware") const {
+        if (!counters.is_open()) {
+            std::printf("%s Counters: unavailable (%s)\n", label, counters.error().c_str());
+            return;
+        }
+        std::printf("%s Counters (per op, n=%llu%s):\n", label, static_cast<unsigned long long>(ops_),
+                    counters.uses_rdpmc() ? ", rdpmc" : "");
+        for (std::size_t i = 0; i < PerfCounters::EVENT_COUNT; ++i) {
+            const auto event = static_cast<PerfCounters::Event>(i);
+            if (!counters.has(event)) continue;
+            std::printf("  %-14s %10.2f", (std::string(PerfCounters::name(event)) + ":").c_str(), per_op(event));
+            if (event == PerfCounters::INSTRUCTIONS && counters.has(PerfCounters::CYCLES)) {
+                std::printf("  (IPC %.2f)", ipc());
+            }
+            std::printf("\n");
+        }
+    }
+
+private:
+    PerfCounters::Sample totals_;
+    std::uint64_t ops_ = 0;
+};
+
+/**
+ * @brief Adds the counts over its lifetime to a PerfCounterStats
+ */
+class PerfScope {
+public:
+    PerfScope(const PerfCounters& counters, PerfCounterStats& stats, std::uint64_t ops = 1) noexcept
+        : counters_(counters), stats_(stats), ops_(ops), start_(counters.read()) {}
+
+    ~PerfScope() {
+        stats_.add(counters_.read() - start_, ops_);
+    }
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+private:
+    const PerfCounters& counters_;
+    PerfCounterStats& stats_;
+    std::uint64_t ops_;
+    PerfCounters::Sample start_;
+};
+
+} // namespace hft
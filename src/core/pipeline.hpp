@@ -0,0 +1,459 @@
+/**
+ * @file pipeline.hpp
+ * @brief Typed multi-stage pipeline of pinned threads joined by SPSC rings
+ *
+ * A pipeline is declared source first, each stage naming its upstream:
+ *
+ *   Pipeline pipeline(config);
+ *   auto* feed  = pipeline.source<Tick>("feed");
+ *   auto* strat = pipeline.stage<Order>("strategy", *feed,
+ *                     [&](const Tick& t, Emitter<Order>& out) { ... out.emit(order); });
+ *   pipeline.sink("exchange", *strat, [&](const Order& o) { ... });
+ *   pipeline.start();
+ *   feed->publish(tick);               // From the feed thread
+ *   pipeline.stop();
+ *
+ * Item types are checked where stages are joined. Every stage after a
+ * source runs on its own thread, pinned to config.cpus[i] (i counts
+ * declarations, sources included; a source's core is for the thread that
+ * publishes). Stages take up to BATCH items off their input ring at a time
+ * and hand their output downstream with one bulk push per batch. A full
+ * ring is backpressure: the producer waits and counts a stall, nothing is
+ * dropped. Idle stages follow config.idle and are woken by their upstream.
+ *
+ * Items carry the time they were published and the time they were handed
+ * to the current stage, so each stage records its queue delay and per-item
+ * service time, and sinks the end-to-end latency.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "busy_poll.hpp"
+#include "cpu_affinity.hpp"
+#include "lockfree_queue.hpp"
+#include "memory_region.hpp"
+#include "timing.hpp"
+#include "tsc_clock.hpp"
+#include "types.hpp"
+
+namespace hft {
+
+struct PipelineConfig {
+    std::vector<int> cpus;              // Core per declared stage; missing or -1: not pinned
+    IdleStrategy::Config idle;
+};
+
+/**
+ * @brief Per-stage counters
+ *
+ * Written by the stage's own thread (a source's by the publisher). The
+ * atomics may be read live; the rest once the pipeline has stopped.
+ */
+struct StageStats {
+    std::atomic<std::uint64_t> processed{0};
+    std::atomic<std::uint64_t> emitted{0};
+    std::atomic<std::uint64_t> stalls{0};   // Handoffs that found the next ring full
+    std::uint64_t max_backlog = 0;          // Deepest input ring seen at a pop
+    LatencyStats queue_delay;               // Handed off upstream -> taken here
+    LatencyStats service;                   // Per item, in the stage function
+    LatencyStats end_to_end;                // Published -> done (sinks only)
+};
+
+namespace detail {
+
+template<typename T>
+struct PipelineSlot {
+    T value;
+    Timestamp origin;       // Published at the source
+    Timestamp handoff;      // Pushed onto the current ring
+};
+
+// Sink stages have no output and no emitter
+struct NoOutput {
+    template<typename... Args>
+    explicit NoOutput(Args&&...) noexcept {}
+};
+
+inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n = 1) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+template<typename T> class Emitter;
+template<typename In, typename Out, typename Fn> class PipelineStage;
+class Pipeline;
+
+/**
+ * @brief A stage's output: the ring its one downstream stage reads
+ */
+template<typename T>
+class PipelineOutput {
+public:
+    static constexpr std::size_t RING_SIZE = 16384;
+
+    using Output = T;
+
+    PipelineOutput() : ring_(make_in_region<Ring>(default_memory_policy())) {}
+
+    // Items not yet taken by the downstream stage
+    [[nodiscard]] std::size_t backlog() const noexcept { return ring_->size(); }
+
+protected:
+    using Slot = detail::PipelineSlot<T>;
+    using Ring = SPSCQueue<Slot, RING_SIZE>;
+
+    // Producer thread only; waits while the ring is full
+    void push(std::span<const Slot> slots, StageStats& stats) noexcept {
+        std::size_t pushed = ring_->try_push_bulk(slots);
+        if (pushed < slots.size()) {
+            detail::bump(stats.stalls);
+            do {
+                wake_.notify();
+                cpu_pause();
+                pushed += ring_->try_push_bulk(slots.subspan(pushed));
+            } while (pushed < slots.size());
+        }
+        detail::bump(stats.emitted, slots.size());
+        wake_.notify();
+    }
+
+private:
+    friend class Emitter<T>;
+    friend class Pipeline;
+    template<typename, typename, typename> friend class PipelineStage;
+
+    RegionPtr<Ring> ring_;
+    WakeSignal wake_;               // Downstream stage parks on it
+    bool connected_ = false;        // Setup only: a downstream stage reads ring_
+};
+
+/**
+ * @brief Collects a stage's output over one input batch and hands it off
+ */
+template<typename T>
+class Emitter {
+public:
+    static constexpr std::size_t BATCH = 64;
+
+    void emit(const T& value) noexcept {
+        batch_[count_++] = {value, origin_, 0};
+        if (count_ == BATCH) flush();
+    }
+
+private:
+    template<typename, typename, typename> friend class PipelineStage;
+
+    Emitter(PipelineOutput<T>& output, StageStats& stats) noexcept : output_(output), stats_(stats) {}
+
+    void flush() noexcept {
+        if (count_ == 0) return;
+        const Timestamp now = fast_now();
+        for (std::size_t i = 0; i < count_; ++i) {
+            batch_[i].handoff = now;
+        }
+        output_.push(std::span<const detail::PipelineSlot<T>>(batch_.data(), count_), stats_);
+        count_ = 0;
+    }
+
+    PipelineOutput<T>& output_;
+    StageStats& stats_;
+    Timestamp origin_ = 0;                  // Of the input being handled
+    std::size_t count_ = 0;
+    std::array<detail::PipelineSlot<T>, BATCH> batch_;
+};
+
+/**
+ * @brief What the Pipeline owns and reports on, whatever the item types
+ */
+class PipelineStageBase {
+public:
+    explicit PipelineStageBase(std::string_view name) : name_(name) {}
+    virtual ~PipelineStageBase() = default;
+
+    // Non-copyable
+    PipelineStageBase(const PipelineStageBase&) = delete;
+    PipelineStageBase& operator=(const PipelineStageBase&) = delete;
+
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+    [[nodiscard]] int cpu() const noexcept { return cpu_; }
+    [[nodiscard]] bool is_sink() const noexcept { return sink_; }
+    [[nodiscard]] const StageStats& stats() const noexcept { return stats_; }
+
+protected:
+    friend class Pipeline;
+
+    virtual void start(const IdleStrategy::Config& /*idle*/) {}
+    virtual void stop() {}
+
+    std::string name_;
+    int cpu_ = -1;
+    bool sink_ = false;
+    StageStats stats_;
+};
+
+/**
+ * @brief Entry point, fed by one thread outside the pipeline
+ */
+template<typename T>
+class PipelineSource final : public PipelineStageBase, public PipelineOutput<T> {
+public:
+    explicit PipelineSource(std::string_view name) : PipelineStageBase(name) {}
+
+    /**
+     * @brief Hand one item to the first stage; waits while its ring is full
+     *
+     * @param origin Start of end_to_end (e.g. an open-loop intended send
+     *               time); 0 = now
+     */
+    void publish(const T& value, Timestamp origin = 0) noexcept {
+        const Timestamp now = fast_now();
+        const detail::PipelineSlot<T> slot{value, origin ? origin : now, now};
+        this->push(std::span<const detail::PipelineSlot<T>>(&slot, 1), stats_);
+    }
+
+    /**
+     * @brief Hand off a burst, one ring update per BATCH items
+     */
+    void publish(std::span<const T> values) noexcept {
+        std::array<detail::PipelineSlot<T>, Emitter<T>::BATCH> slots;
+        while (!values.empty()) {
+            const std::size_t n = std::min(values.size(), slots.size());
+            const Timestamp now = fast_now();
+            for (std::size_t i = 0; i < n; ++i) {
+                slots[i] = {values[i], now, now};
+            }
+            this->push(std::span<const detail::PipelineSlot<T>>(slots.data(), n), stats_);
+            values = values.subspan(n);
+        }
+    }
+};
+
+/**
+ * @brief One stage thread: fn(in, emitter), or fn(in) for a sink (Out = void)
+ */
+template<typename In, typename Out, typename Fn>
+class PipelineStage final
+    : public PipelineStageBase
+    , public std::conditional_t<std::is_void_v<Out>, detail::NoOutput, PipelineOutput<Out>> {
+public:
+    static constexpr std::size_t BATCH = 64;
+
+    PipelineStage(std::string_view name, PipelineOutput<In>& input, Fn fn)
+        : PipelineStageBase(name)
+        , input_(input)
+        , fn_(std::move(fn))
+        , emitter_(*this, stats_) {
+        sink_ = std::is_void_v<Out>;
+    }
+
+    ~PipelineStage() override {
+        stop();
+    }
+
+private:
+    using InSlot = detail::PipelineSlot<In>;
+
+    void start(const IdleStrategy::Config& idle) override {
+        running_.store(true, std::memory_order_relaxed);
+        thread_ = std::thread([this, idle] { run(idle); });
+    }
+
+    // Called once the upstream stage has stopped, so what is left is drained
+    void stop() override {
+        if (!thread_.joinable()) return;
+        running_.store(false, std::memory_order_release);
+        input_.wake_.notify();
+        thread_.join();
+    }
+
+    void run(const IdleStrategy::Config& idle_config) {
+        if (cpu_ >= 0) {
+            set_cpu_affinity(cpu_);
+        }
+        IdleStrategy idle(idle_config, &input_.wake_);
+        std::array<InSlot, BATCH> batch;
+        for (;;) {
+            // Read the flag first so nothing pushed before stop() is missed
+            const bool running = running_.load(std::memory_order_acquire);
+            const std::size_t n = input_.ring_->try_pop_bulk(std::span<InSlot>(batch));
+            if (n > 0) {
+                handle(std::span<const InSlot>(batch.data(), n));
+            } else if (!running) {
+                break;
+            }
+            idle.idle(n, [this] {
+                return !input_.ring_->empty() || !running_.load(std::memory_order_relaxed);
+            });
+        }
+    }
+
+    void handle(std::span<const InSlot> items) {
+        const std::size_t backlog = items.size() == BATCH ? BATCH + input_.ring_->size() : items.size();
+        stats_.max_backlog = std::max<std::uint64_t>(stats_.max_backlog, backlog);
+
+        Timestamp start = fast_now();
+        for (const InSlot& item : items) {
+            stats_.queue_delay.add_sample(start - item.handoff);
+            if constexpr (std::is_void_v<Out>) {
+                fn_(item.value);
+            } else {
+                emitter_.origin_ = item.origin;
+                fn_(item.value, emitter_);
+            }
+            const Timestamp done = fast_now();
+            stats_.service.add_sample(done - start);
+            if constexpr (std::is_void_v<Out>) {
+                stats_.end_to_end.add_sample(done - item.origin);
+            }
+            start = done;
+        }
+        detail::bump(stats_.processed, items.size());
+        if constexpr (!std::is_void_v<Out>) {
+            emitter_.flush();
+        }
+    }
+
+    PipelineOutput<In>& input_;
+    Fn fn_;
+    std::conditional_t<std::is_void_v<Out>, detail::NoOutput, Emitter<Out>> emitter_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+/**
+ * @brief Owns the stages; starts them together and stops them in order
+ */
+class Pipeline {
+public:
+    explicit Pipeline(PipelineConfig config = {}) : config_(std::move(config)) {}
+
+    ~Pipeline() {
+        stop();
+        // Downstream first: a stage still refers to its upstream's ring
+        while (!stages_.empty()) {
+            stages_.pop_back();
+        }
+    }
+
+    // Non-copyable
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    /**
+     * @brief Declare an entry point (setup only)
+     * @return nullptr once started
+     */
+    template<typename T>
+    PipelineSource<T>* source(std::string_view name) {
+        if (running_) return nullptr;
+        return add(std::make_unique<PipelineSource<T>>(name));
+    }
+
+    /**
+     * @brief Declare a stage fn(const In&, Emitter<Out>&) reading upstream (setup only)
+     * @return nullptr once started or if upstream already has a reader
+     */
+    template<typename Out, typename In, typename Fn>
+    PipelineStage<In, Out, Fn>* stage(std::string_view name, PipelineOutput<In>& upstream, Fn fn) {
+        static_assert(!std::is_void_v<Out>, "Use sink() for a stage without output");
+        static_assert(std::is_invocable_v<Fn&, const In&, Emitter<Out>&>,
+                      "Stage function must take (const In&, Emitter<Out>&)");
+        return connect<In, Out>(name, upstream, std::move(fn));
+    }
+
+    /**
+     * @brief Declare a final stage fn(const In&) reading upstream (setup only)
+     */
+    template<typename In, typename Fn>
+    PipelineStage<In, void, Fn>* sink(std::string_view name, PipelineOutput<In>& upstream, Fn fn) {
+        static_assert(std::is_invocable_v<Fn&, const In&>, "Sink function must take (const In&)");
+        return connect<In, void>(name, upstream, std::move(fn));
+    }
+
+    void start() {
+        if (running_) return;
+        running_ = true;
+        for (auto& stage : stages_) {
+            stage->start(config_.idle);
+        }
+    }
+
+    /**
+     * @brief Drain and stop every stage, upstream first
+     *
+     * Stop publishing to the sources before calling this.
+     */
+    void stop() {
+        if (!running_) return;
+        for (auto& stage : stages_) {
+            stage->stop();
+        }
+        running_ = false;
+    }
+
+    [[nodiscard]] bool running() const noexcept { return running_; }
+    [[nodiscard]] std::size_t size() const noexcept { return stages_.size(); }
+    [[nodiscard]] const PipelineStageBase& at(std::size_t index) const { return *stages_[index]; }
+
+    void print_stats() const {
+        std::printf("Pipeline Statistics:\n");
+        std::printf("  %-12s %4s %12s %12s %8s %8s %10s %10s %10s %10s\n", "Stage", "CPU",
+                    "Processed", "Emitted", "Stalls", "Backlog", "Queue p50", "Queue p99",
+                    "Svc p50", "Svc p99");
+        for (const auto& stage : stages_) {
+            const StageStats& s = stage->stats();
+            std::printf("  %-12s %4d %12llu %12llu %8llu %8llu %10.0f %10.0f %10.0f %10.0f\n",
+                        stage->name().c_str(), stage->cpu(),
+                        static_cast<unsigned long long>(s.processed.load(std::memory_order_relaxed)),
+                        static_cast<unsigned long long>(s.emitted.load(std::memory_order_relaxed)),
+                        static_cast<unsigned long long>(s.stalls.load(std::memory_order_relaxed)),
+                        static_cast<unsigned long long>(s.max_backlog),
+                        s.queue_delay.median(), s.queue_delay.percentile(99.0),
+                        s.service.median(), s.service.percentile(99.0));
+        }
+        for (const auto& stage : stages_) {
+            if (!stage->is_sink() || stage->stats().end_to_end.empty()) continue;
+            const auto& e2e = stage->stats().end_to_end;
+            std::printf("  End to end at %s: p50 %.0f ns, p99 %.0f ns, max %.0f ns\n",
+                        stage->name().c_str(), e2e.median(), e2e.percentile(99.0), e2e.max());
+        }
+    }
+
+private:
+    template<typename In, typename Out, typename Fn>
+    PipelineStage<In, Out, Fn>* connect(std::string_view name, PipelineOutput<In>& upstream, Fn&& fn) {
+        if (running_ || upstream.connected_) return nullptr;
+        upstream.connected_ = true;
+        return add(std::make_unique<PipelineStage<In, Out, Fn>>(name, upstream, std::move(fn)));
+    }
+
+    template<typename Stage>
+    Stage* add(std::unique_ptr<Stage> stage) {
+        const std::size_t index = stages_.size();
+        stage->cpu_ = index < config_.cpus.size() ? config_.cpus[index] : -1;
+        Stage* raw = stage.get();
+        stages_.push_back(std::move(stage));
+        return raw;
+    }
+
+    PipelineConfig config_;
+    std::vector<std::unique_ptr<PipelineStageBase>> stages_;
+    bool running_ = false;
+};
+
+} // namespace hft
@@ -0,0 +1,218 @@
+/**
+ * @file rcu.hpp
+ * @brief Epoch-based RCU pointer for read-mostly data
+ *
+ * For reference data read on every order and replaced a few times a day
+ * (instrument definitions, risk limits, tick tables) and too large to copy
+ * out of a SeqLock on each read. Readers follow a pointer to an immutable
+ * T; the writer publishes a new T and frees the old one only after every
+ * reader that might still see it has left its read section.
+ *
+ * A reader only writes its own cache-line slot in the RcuDomain (its
+ * epoch on entry, 0 on exit), never a line other readers touch, so readers
+ * scale without the line bouncing an RWSpinlock's reader count causes.
+ * The writer pays instead: update() waits for every reader still inside an
+ * older epoch.
+ *
+ * Usage:
+ *   RcuDomain domain;
+ *   RcuPtr<Limits> limits(domain, std::make_unique<Limits>());
+ *   RcuReader reader(domain);                 // Once per reader thread
+ *   { RcuReadGuard guard(reader); check(*limits.load()); }
+ *   limits.update(std::make_unique<Limits>(next));  // Writer thread
+ *
+ * Read sections must not nest or block, and a pointer from load() is valid
+ * only until the section ends.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "busy_poll.hpp"
+#include "types.hpp"
+
+namespace hft {
+
+class RcuDomain {
+public:
+    static constexpr std::size_t MAX_READERS = 64;
+
+    RcuDomain() = default;
+
+    // Non-copyable
+    RcuDomain(const RcuDomain&) = delete;
+    RcuDomain& operator=(const RcuDomain&) = delete;
+
+    /**
+     * @brief Wait until every reader section that began before this call has ended
+     *
+     * Called by the writer after unpublishing a pointer, before freeing it.
+     */
+    void synchronize() noexcept {
+        const std::uint64_t target = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        for (auto& slot : slots_) {
+            std::size_t spins = 0;
+            while (true) {
+                const std::uint64_t seen = slot.epoch.load(std::memory_order_seq_cst);
+                if (seen == QUIESCENT || seen >= target) break;
+                if (++spins < 1000) {
+                    cpu_pause();
+                } else {
+                    std::this_thread::yield();      // Reader may be descheduled mid-section
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Completed grace periods
+     */
+    [[nodiscard]] std::uint64_t epoch() const noexcept {
+        return epoch_.load(std::memory_order_relaxed) - 1;
+    }
+
+private:
+    friend class RcuReader;
+
+    static constexpr std::uint64_t QUIESCENT = 0;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<std::uint64_t> epoch{QUIESCENT};   // Epoch the reader entered in
+        std::atomic<bool> claimed{false};
+    };
+
+    [[nodiscard]] Slot* claim() noexcept {
+        for (auto& slot : slots_) {
+            bool expected = false;
+            if (!slot.claimed.load(std::memory_order_relaxed) &&
+                slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> epoch_{1};
+    std::array<Slot, MAX_READERS> slots_{};
+};
+
+/**
+ * @brief One reader thread's registration with a domain
+ *
+ * Construct once per thread (it claims a slot; not for the hot path) and
+ * use from that thread only.
+ */
+class RcuReader {
+public:
+    explicit RcuReader(RcuDomain& domain) noexcept
+        : domain_(&domain), slot_(domain.claim()) {}
+
+    ~RcuReader() {
+        if (slot_) {
+            slot_->epoch.store(RcuDomain::QUIESCENT, std::memory_order_release);
+            slot_->claimed.store(false, std::memory_order_release);
+        }
+    }
+
+    // Non-copyable
+    RcuReader(const RcuReader&) = delete;
+    RcuReader& operator=(const RcuReader&) = delete;
+
+    /**
+     * @brief False if the domain already had MAX_READERS readers
+     */
+    [[nodiscard]] bool valid() const noexcept { return slot_ != nullptr; }
+
+    void lock() noexcept {
+        slot_->epoch.store(domain_->epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        // Announce before reading any pointer (pairs with synchronize())
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void unlock() noexcept {
+        slot_->epoch.store(RcuDomain::QUIESCENT, std::memory_order_release);
+    }
+
+private:
+    RcuDomain* domain_;
+    RcuDomain::Slot* slot_;
+};
+
+/**
+ * @brief Scoped read section
+ */
+class RcuReadGuard {
+public:
+    explicit RcuReadGuard(RcuReader& reader) noexcept : reader_(reader) {
+        reader_.lock();
+    }
+
+    ~RcuReadGuard() {
+        reader_.unlock();
+    }
+
+    RcuReadGuard(const RcuReadGuard&) = delete;
+    RcuReadGuard& operator=(const RcuReadGuard&) = delete;
+
+private:
+    RcuReader& reader_;
+};
+
+/**
+ * @brief Pointer to an immutable T, replaced by one writer thread
+ */
+template<typename T>
+class RcuPtr {
+public:
+    RcuPtr(RcuDomain& domain, std::unique_ptr<T> initial) noexcept
+        : domain_(domain), current_(initial.release()) {}
+
+    /**
+     * @brief Frees the current value; no reader may still be inside a section
+     */
+    ~RcuPtr() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    // Non-copyable
+    RcuPtr(const RcuPtr&) = delete;
+    RcuPtr& operator=(const RcuPtr&) = delete;
+
+    /**
+     * @brief Current value (inside a read section, or on the writer thread)
+     */
+    [[nodiscard]] const T* load() const noexcept {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Publish next, wait out readers of the old value and free it
+     *
+     * Writer thread only; blocks for at most the longest read section in progress.
+     */
+    void update(std::unique_ptr<T> next) noexcept {
+        T* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        domain_.synchronize();
+        delete old;
+    }
+
+    /**
+     * @brief Copy the current value, apply fn(T&) to the copy and publish it
+     */
+    template<typename Fn>
+    void modify(Fn&& fn) {
+        auto next = std::make_unique<T>(*load());
+        fn(*next);
+        update(std::move(next));
+    }
+
+private:
+    RcuDomain& domain_;
+    std::atomic<T*> current_;
+};
+
+} // namespace hft
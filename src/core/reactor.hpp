@@ -0,0 +1,742 @@
+/**
+ * @file reactor.hpp
+ * @brief Single-threaded I/O reactor shared by the socket servers
+ *
+ * One thread (ideally pinned) owns the reactor and serves every registered
+ * socket from it; readiness is reported per fd, so there are no O(n) scans
+ * over a pollfd array.
+ *
+ * Backends:
+ * - EPOLL:    edge-triggered epoll. Accepts and receives are drained until
+ *             EAGAIN into a reactor-owned receive buffer.
+ * - IO_URING: raw io_uring (no liburing) with multishot accept, multishot
+ *             recv into a kernel-registered provided-buffer ring, and
+ *             multishot poll for plain readiness watches. Falls back to
+ *             EPOLL at init() if the kernel does not support it.
+ *
+ * Three registration styles:
+ * - watch():   readiness callback; the owner does its own I/O (must drain
+ *              until EAGAIN, as with any edge-triggered source)
+ * - listen():  callback per accepted (non-blocking) client fd
+ * - receive(): callback per received chunk; an empty span means the peer
+ *              closed or the socket failed
+ *
+ * Handlers run on the reactor thread and may call remove() (including on
+ * their own fd) or register new fds. remove() never closes the fd.
+ *
+ * Idle behaviour follows PollMode: AGGRESSIVE and BALANCED spin on
+ * non-blocking polls, RELAXED blocks in the kernel, ADAPTIVE spins for a
+ * while before blocking.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <csignal>
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(IORING_RECV_MULTISHOT) && defined(IORING_ASYNC_CANCEL_FD)
+#define HFT_HAS_IO_URING 1
+#endif
+#endif
+#endif
+
+#include "busy_poll.hpp"
+
+namespace hft {
+
+enum class ReactorBackend : std::uint8_t {
+    EPOLL,
+    IO_URING
+};
+
+/**
+ * @brief Readiness flags passed to watch() handlers
+ */
+enum IoEvents : std::uint32_t {
+    IO_READ = 1u << 0,
+    IO_WRITE = 1u << 1,
+    IO_CLOSED = 1u << 2,    // Peer hung up
+    IO_ERROR = 1u << 3
+};
+
+struct ReactorConfig {
+    ReactorBackend backend = ReactorBackend::EPOLL;
+    PollMode mode = PollMode::RELAXED;
+    int block_timeout_ms = 10;          // Kernel wait when not spinning
+    std::size_t max_events = 256;       // Events reaped per poll
+    std::size_t buffer_count = 256;     // Receive buffers (io_uring: rounded to a power of two)
+    std::size_t buffer_size = 16384;
+};
+
+/**
+ * @brief Edge-triggered epoll / io_uring event loop
+ */
+class Reactor {
+public:
+    using ReadyHandler = std::function<void(int fd, std::uint32_t events)>;
+    using AcceptHandler = std::function<void(int client_fd)>;
+    using RecvHandler = std::function<void(int fd, std::span<const char> data)>;
+
+    explicit Reactor(const ReactorConfig& config = {}) : config_(config) {}
+
+    ~Reactor() { shutdown(); }
+
+    // Non-copyable
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    /**
+     * @brief Create the kernel objects for the configured backend
+     */
+    bool init() {
+        #ifdef __linux__
+        if (initialized()) return true;
+        if (config_.buffer_count == 0) config_.buffer_count = 1;
+        if (config_.max_events == 0) config_.max_events = 1;
+
+        #ifdef HFT_HAS_IO_URING
+        if (config_.backend == ReactorBackend::IO_URING && uring_init()) {
+            backend_ = ReactorBackend::IO_URING;
+            return true;
+        }
+        #endif
+
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0) return false;
+        epoll_events_.resize(config_.max_events);
+        buffers_.resize(config_.buffer_size);
+        backend_ = ReactorBackend::EPOLL;
+        return true;
+        #else
+        return false;
+        #endif
+    }
+
+    [[nodiscard]] bool initialized() const noexcept {
+        #ifdef HFT_HAS_IO_URING
+        if (uring_.fd >= 0) return true;
+        #endif
+        return epoll_fd_ >= 0;
+    }
+
+    /**
+     * @brief Backend actually in use (valid after init())
+     */
+    [[nodiscard]] ReactorBackend backend() const noexcept { return backend_; }
+
+    /**
+     * @brief Report readiness on fd (IO_READ and/or IO_WRITE)
+     */
+    bool watch(int fd, std::uint32_t events, ReadyHandler handler) {
+        Slot* slot = claim(fd, SlotKind::READY);
+        if (!slot) return false;
+        slot->events = events;
+        slot->ready = std::move(handler);
+        return arm(fd, *slot);
+    }
+
+    /**
+     * @brief Accept connections on a listening socket
+     */
+    bool listen(int listen_fd, AcceptHandler handler) {
+        Slot* slot = claim(listen_fd, SlotKind::ACCEPT);
+        if (!slot) return false;
+        slot->accept = std::move(handler);
+        return arm(listen_fd, *slot);
+    }
+
+    /**
+     * @brief Deliver received bytes on fd
+     *
+     * The span is only valid inside the handler.
+     */
+    bool receive(int fd, RecvHandler handler) {
+        Slot* slot = claim(fd, SlotKind::RECV);
+        if (!slot) return false;
+        slot->recv = std::move(handler);
+        return arm(fd, *slot);
+    }
+
+    /**
+     * @brief Stop delivering events for fd (the caller still owns and closes it)
+     */
+    void remove(int fd) {
+        if (fd < 0 || static_cast<std::size_t>(fd) >= slots_.size()) return;
+        Slot& slot = slots_[fd];
+        if (slot.kind == SlotKind::NONE) return;
+
+        #ifdef __linux__
+        if (backend_ == ReactorBackend::EPOLL) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        }
+        #ifdef HFT_HAS_IO_URING
+        else {
+            // Cancel now, while the fd number still names the file
+            if (auto* sqe = uring_get_sqe()) {
+                sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                sqe->fd = fd;
+                sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+                sqe->user_data = 0;
+                uring_submit();
+            }
+        }
+        #endif
+        #endif
+
+        retire(slot);
+        --active_;
+    }
+
+    /**
+     * @brief Dispatch ready events, waiting at most timeout_ms (-1 = forever)
+     * @return Number of events handled
+     */
+    std::size_t poll(int timeout_ms = 0) {
+        #ifdef __linux__
+        std::size_t handled;
+        dispatching_ = true;
+        #ifdef HFT_HAS_IO_URING
+        if (backend_ == ReactorBackend::IO_URING) {
+            handled = uring_poll(timeout_ms);
+        } else
+        #endif
+        {
+            handled = epoll_poll(timeout_ms);
+        }
+        dispatching_ = false;
+        retired_.clear();
+        return handled;
+        #else
+        (void)timeout_ms;
+        return 0;
+        #endif
+    }
+
+    /**
+     * @brief Poll until running is cleared, idling according to PollMode
+     */
+    void run(const std::atomic<bool>& running) {
+        std::size_t idle_polls = 0;
+        while (running.load(std::memory_order_acquire)) {
+            const bool block = config_.mode == PollMode::RELAXED ||
+                               (config_.mode == PollMode::ADAPTIVE && idle_polls >= ADAPTIVE_SPIN);
+            if (poll(block ? config_.block_timeout_ms : 0) > 0) {
+                idle_polls = 0;
+            } else if (!block) {
+                ++idle_polls;
+                if (config_.mode != PollMode::AGGRESSIVE) {
+                    cpu_pause();
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Number of registered fds
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return active_; }
+
+private:
+    static constexpr std::size_t ADAPTIVE_SPIN = 100000;
+
+    enum class SlotKind : std::uint8_t { NONE, READY, ACCEPT, RECV };
+
+    struct Slot {
+        SlotKind kind = SlotKind::NONE;
+        std::uint32_t generation = 0;
+        std::uint32_t events = 0;
+        ReadyHandler ready;
+        AcceptHandler accept;
+        RecvHandler recv;
+    };
+
+    struct RetiredHandlers {
+        ReadyHandler ready;
+        AcceptHandler accept;
+        RecvHandler recv;
+    };
+
+    /**
+     * @brief Kernel cookie for a registration; stale cookies fail lookup()
+     */
+    static std::uint64_t token(int fd, std::uint32_t generation) noexcept {
+        return (static_cast<std::uint64_t>(generation) << 32) | static_cast<std::uint32_t>(fd);
+    }
+
+    Slot* lookup(std::uint64_t cookie) noexcept {
+        const auto fd = static_cast<std::uint32_t>(cookie);
+        if (fd >= slots_.size()) return nullptr;
+        Slot& slot = slots_[fd];
+        return (slot.kind != SlotKind::NONE && slot.generation == (cookie >> 32)) ? &slot : nullptr;
+    }
+
+    Slot* claim(int fd, SlotKind kind) {
+        if (fd < 0 || !initialized()) return nullptr;
+        if (static_cast<std::size_t>(fd) >= slots_.size()) {
+            slots_.resize(static_cast<std::size_t>(fd) + 1);
+        }
+        Slot& slot = slots_[fd];
+        if (slot.kind != SlotKind::NONE) return nullptr;
+        retire(slot);           // Clear handlers a previous registration left behind
+        slot.kind = kind;
+        ++active_;
+        return &slot;
+    }
+
+    /**
+     * @brief Drop a slot's handlers; deferred while a handler may be running
+     */
+    void retire(Slot& slot) {
+        slot.kind = SlotKind::NONE;
+        ++slot.generation;
+        if (dispatching_) {
+            retired_.push_back({std::move(slot.ready), std::move(slot.accept), std::move(slot.recv)});
+        }
+        slot.ready = nullptr;
+        slot.accept = nullptr;
+        slot.recv = nullptr;
+    }
+
+    bool arm(int fd, Slot& slot) {
+        #ifdef __linux__
+        #ifdef HFT_HAS_IO_URING
+        if (backend_ == ReactorBackend::IO_URING) {
+            uring_arm(fd, slot);
+            uring_submit();
+            return true;
+        }
+        #endif
+        epoll_event ev{};
+        ev.data.u64 = token(fd, slot.generation);
+        switch (slot.kind) {
+            case SlotKind::READY:
+                ev.events = EPOLLET | EPOLLRDHUP |
+                            ((slot.events & IO_READ) ? EPOLLIN : 0u) |
+                            ((slot.events & IO_WRITE) ? EPOLLOUT : 0u);
+                break;
+            case SlotKind::ACCEPT:
+                ev.events = EPOLLIN | EPOLLET;
+                break;
+            case SlotKind::RECV:
+                ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+                break;
+            case SlotKind::NONE:
+                return false;
+        }
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == 0) return true;
+
+        retire(slot);
+        --active_;
+        return false;
+        #else
+        (void)fd;
+        (void)slot;
+        return false;
+        #endif
+    }
+
+    void shutdown() {
+        #ifdef __linux__
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+            epoll_fd_ = -1;
+        }
+        #ifdef HFT_HAS_IO_URING
+        uring_close();
+        #endif
+        #endif
+    }
+
+    #ifdef __linux__
+    // ------------------------------------------------------------------
+    // epoll backend
+    // ------------------------------------------------------------------
+
+    std::size_t epoll_poll(int timeout_ms) {
+        const int n = epoll_wait(epoll_fd_, epoll_events_.data(),
+                                 static_cast<int>(epoll_events_.size()), timeout_ms);
+        for (int i = 0; i < n; ++i) {
+            const std::uint64_t cookie = epoll_events_[i].data.u64;
+            if (Slot* slot = lookup(cookie)) {
+                epoll_dispatch(*slot, static_cast<int>(static_cast<std::uint32_t>(cookie)),
+                               cookie, epoll_events_[i].events);
+            }
+        }
+        return n > 0 ? static_cast<std::size_t>(n) : 0;
+    }
+
+    void epoll_dispatch(Slot& slot, int fd, std::uint64_t cookie, std::uint32_t events) {
+        switch (slot.kind) {
+            case SlotKind::READY: {
+                std::uint32_t io = 0;
+                if (events & EPOLLIN) io |= IO_READ;
+                if (events & EPOLLOUT) io |= IO_WRITE;
+                if (events & (EPOLLHUP | EPOLLRDHUP)) io |= IO_CLOSED;
+                if (events & EPOLLERR) io |= IO_ERROR;
+                slot.ready(fd, io);
+                break;
+            }
+
+            case SlotKind::ACCEPT:
+                // Edge-triggered: drain the backlog
+                while (lookup(cookie)) {
+                    const int client = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (client < 0) break;
+                    slot.accept(client);
+                }
+                break;
+
+            case SlotKind::RECV:
+                while (lookup(cookie)) {
+                    const ssize_t n = ::recv(fd, buffers_.data(), buffers_.size(), 0);
+                    if (n > 0) {
+                        slot.recv(fd, std::span<const char>(buffers_.data(), static_cast<std::size_t>(n)));
+                    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                        break;
+                    } else if (n < 0 && errno == EINTR) {
+                        continue;
+                    } else {
+                        slot.recv(fd, {});
+                        break;
+                    }
+                }
+                break;
+
+            case SlotKind::NONE:
+                break;
+        }
+    }
+
+    #ifdef HFT_HAS_IO_URING
+    // ------------------------------------------------------------------
+    // io_uring backend
+    // ------------------------------------------------------------------
+
+    static constexpr std::uint16_t BUFFER_GROUP = 0;
+
+    struct Uring {
+        int fd = -1;
+        unsigned* sq_head = nullptr;
+        unsigned* sq_tail = nullptr;
+        unsigned* sq_array = nullptr;
+        unsigned sq_mask = 0;
+        unsigned sq_entries = 0;
+        unsigned sq_local_tail = 0;
+        unsigned to_submit = 0;
+        io_uring_sqe* sqes = nullptr;
+        unsigned* cq_head = nullptr;
+        unsigned* cq_tail = nullptr;
+        unsigned cq_mask = 0;
+        io_uring_cqe* cqes = nullptr;
+        void* ring_ptr = nullptr;
+        std::size_t ring_size = 0;
+        std::size_t sqes_size = 0;
+        io_uring_buf_ring* buf_ring = nullptr;
+        std::size_t buf_ring_size = 0;
+        unsigned buf_entries = 0;
+        std::uint16_t buf_local_tail = 0;
+    };
+
+    static int sys_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                               unsigned flags, const void* arg, std::size_t arg_size) noexcept {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                                        flags, arg, arg_size));
+    }
+
+    bool uring_init() {
+        io_uring_params params{};
+        params.flags = IORING_SETUP_CLAMP;
+        const int fd = static_cast<int>(syscall(__NR_io_uring_setup,
+                                                static_cast<unsigned>(config_.max_events * 2), &params));
+        if (fd < 0) return false;
+        uring_.fd = fd;
+
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+            uring_close();
+            return false;
+        }
+
+        const std::size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        const std::size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        uring_.ring_size = sq_size > cq_size ? sq_size : cq_size;
+        void* ring = mmap(nullptr, uring_.ring_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (ring == MAP_FAILED) {
+            uring_close();
+            return false;
+        }
+        uring_.ring_ptr = ring;
+
+        uring_.sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, uring_.sqes_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            uring_close();
+            return false;
+        }
+        uring_.sqes = static_cast<io_uring_sqe*>(sqes);
+
+        auto* base = static_cast<char*>(ring);
+        uring_.sq_head = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+        uring_.sq_tail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+        uring_.sq_array = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+        uring_.sq_mask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+        uring_.sq_entries = params.sq_entries;
+        uring_.sq_local_tail = *uring_.sq_tail;
+        uring_.cq_head = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+        uring_.cq_tail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+        uring_.cq_mask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+        uring_.cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+
+        // Provided-buffer ring: the kernel picks a buffer per completion
+        unsigned entries = 1;
+        while (entries < config_.buffer_count && entries < 32768) entries <<= 1;
+        uring_.buf_entries = entries;
+        uring_.buf_ring_size = entries * sizeof(io_uring_buf);
+        void* buf_ring = mmap(nullptr, uring_.buf_ring_size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buf_ring == MAP_FAILED) {
+            uring_close();
+            return false;
+        }
+        uring_.buf_ring = static_cast<io_uring_buf_ring*>(buf_ring);
+
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<std::uint64_t>(buf_ring);
+        reg.ring_entries = entries;
+        reg.bgid = BUFFER_GROUP;
+        if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            uring_close();
+            return false;
+        }
+
+        buffers_.resize(static_cast<std::size_t>(entries) * config_.buffer_size);
+        for (unsigned bid = 0; bid < entries; ++bid) {
+            uring_provide(static_cast<std::uint16_t>(bid));
+        }
+        uring_publish_buffers();
+        return true;
+    }
+
+    void uring_close() {
+        if (uring_.buf_ring) {
+            munmap(uring_.buf_ring, uring_.buf_ring_size);
+        }
+        if (uring_.sqes) {
+            munmap(uring_.sqes, uring_.sqes_size);
+        }
+        if (uring_.ring_ptr) {
+            munmap(uring_.ring_ptr, uring_.ring_size);
+        }
+        if (uring_.fd >= 0) {
+            ::close(uring_.fd);
+        }
+        uring_ = Uring{};
+    }
+
+    void uring_provide(std::uint16_t bid) noexcept {
+        // Write fields individually: bufs[0].resv aliases the ring tail
+        auto* buf = reinterpret_cast<io_uring_buf*>(uring_.buf_ring) +
+                    (uring_.buf_local_tail & (uring_.buf_entries - 1));
+        buf->addr = reinterpret_cast<std::uint64_t>(buffers_.data() +
+                                                    static_cast<std::size_t>(bid) * config_.buffer_size);
+        buf->len = static_cast<std::uint32_t>(config_.buffer_size);
+        buf->bid = bid;
+        ++uring_.buf_local_tail;
+    }
+
+    void uring_publish_buffers() noexcept {
+        std::atomic_ref<std::uint16_t>(uring_.buf_ring->tail)
+            .store(uring_.buf_local_tail, std::memory_order_release);
+    }
+
+    io_uring_sqe* uring_get_sqe() noexcept {
+        unsigned head = std::atomic_ref<unsigned>(*uring_.sq_head).load(std::memory_order_acquire);
+        if (uring_.sq_local_tail - head >= uring_.sq_entries) {
+            uring_submit();
+            head = std::atomic_ref<unsigned>(*uring_.sq_head).load(std::memory_order_acquire);
+            if (uring_.sq_local_tail - head >= uring_.sq_entries) return nullptr;
+        }
+        const unsigned index = uring_.sq_local_tail & uring_.sq_mask;
+        io_uring_sqe* sqe = &uring_.sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        uring_.sq_array[index] = index;
+        ++uring_.sq_local_tail;
+        ++uring_.to_submit;
+        return sqe;
+    }
+
+    void uring_submit() noexcept {
+        if (uring_.to_submit == 0) return;
+        std::atomic_ref<unsigned>(*uring_.sq_tail).store(uring_.sq_local_tail, std::memory_order_release);
+        const int ret = sys_uring_enter(uring_.fd, uring_.to_submit, 0, 0, nullptr, 0);
+        if (ret > 0) {
+            uring_.to_submit -= static_cast<unsigned>(ret) < uring_.to_submit
+                                ? static_cast<unsigned>(ret) : uring_.to_submit;
+        }
+    }
+
+    void uring_arm(int fd, const Slot& slot) noexcept {
+        io_uring_sqe* sqe = uring_get_sqe();
+        if (!sqe) return;
+        sqe->fd = fd;
+        sqe->user_data = token(fd, slot.generation);
+        switch (slot.kind) {
+            case SlotKind::READY:
+                sqe->opcode = IORING_OP_POLL_ADD;
+                sqe->len = IORING_POLL_ADD_MULTI;
+                sqe->poll32_events = EPOLLRDHUP |
+                                     ((slot.events & IO_READ) ? EPOLLIN : 0u) |
+                                     ((slot.events & IO_WRITE) ? EPOLLOUT : 0u);
+                break;
+            case SlotKind::ACCEPT:
+                sqe->opcode = IORING_OP_ACCEPT;
+                sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+                sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+                break;
+            case SlotKind::RECV:
+                sqe->opcode = IORING_OP_RECV;
+                sqe->ioprio = IORING_RECV_MULTISHOT;
+                sqe->flags = IOSQE_BUFFER_SELECT;
+                sqe->buf_group = BUFFER_GROUP;
+                break;
+            case SlotKind::NONE:
+                break;
+        }
+    }
+
+    std::size_t uring_poll(int timeout_ms) {
+        unsigned head = *uring_.cq_head;
+        unsigned tail = std::atomic_ref<unsigned>(*uring_.cq_tail).load(std::memory_order_acquire);
+
+        if (head == tail && timeout_ms != 0) {
+            std::atomic_ref<unsigned>(*uring_.sq_tail).store(uring_.sq_local_tail, std::memory_order_release);
+            __kernel_timespec ts{};
+            ts.tv_sec = timeout_ms / 1000;
+            ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1'000'000;
+            io_uring_getevents_arg arg{};
+            arg.sigmask_sz = _NSIG / 8;
+            arg.ts = timeout_ms > 0 ? reinterpret_cast<std::uint64_t>(&ts) : 0;
+            const int ret = sys_uring_enter(uring_.fd, uring_.to_submit, 1,
+                                            IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                                            &arg, sizeof(arg));
+            if (ret > 0) uring_.to_submit = 0;
+            tail = std::atomic_ref<unsigned>(*uring_.cq_tail).load(std::memory_order_acquire);
+        } else {
+            uring_submit();
+        }
+
+        std::size_t handled = 0;
+        bool recycled = false;
+        while (head != tail && handled < config_.max_events) {
+            const io_uring_cqe cqe = uring_.cqes[head & uring_.cq_mask];
+            ++head;
+            std::atomic_ref<unsigned>(*uring_.cq_head).store(head, std::memory_order_release);
+            ++handled;
+            recycled |= uring_dispatch(cqe);
+        }
+        if (recycled) uring_publish_buffers();
+        uring_submit();     // Re-arms queued by handlers
+        return handled;
+    }
+
+    /**
+     * @brief Handle one completion; returns true if a buffer was recycled
+     */
+    bool uring_dispatch(const io_uring_cqe& cqe) {
+        if (cqe.user_data == 0) return false;      // Cancellation result
+
+        const bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+        const bool has_buffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+        const auto bid = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        const int fd = static_cast<int>(static_cast<std::uint32_t>(cqe.user_data));
+
+        bool ended = false;
+        Slot* slot = lookup(cqe.user_data);
+        if (slot) {
+            switch (slot->kind) {
+                case SlotKind::READY:
+                    if (cqe.res >= 0) {
+                        const auto mask = static_cast<std::uint32_t>(cqe.res);
+                        std::uint32_t io = 0;
+                        if (mask & EPOLLIN) io |= IO_READ;
+                        if (mask & EPOLLOUT) io |= IO_WRITE;
+                        if (mask & (EPOLLHUP | EPOLLRDHUP)) io |= IO_CLOSED;
+                        if (mask & EPOLLERR) io |= IO_ERROR;
+                        slot->ready(fd, io);
+                    } else if (cqe.res != -ECANCELED) {
+                        slot->ready(fd, IO_ERROR);
+                    }
+                    break;
+
+                case SlotKind::ACCEPT:
+                    if (cqe.res >= 0) slot->accept(cqe.res);
+                    break;
+
+                case SlotKind::RECV:
+                    if (cqe.res > 0 && has_buffer) {
+                        const char* data = buffers_.data() + static_cast<std::size_t>(bid) * config_.buffer_size;
+                        slot->recv(fd, std::span<const char>(data, static_cast<std::size_t>(cqe.res)));
+                    } else if (cqe.res != -ENOBUFS) {
+                        slot->recv(fd, {});     // EOF or error: the owner calls remove()
+                        ended = true;
+                    }
+                    break;
+
+                case SlotKind::NONE:
+                    break;
+            }
+
+            // Multishot requests can end early (CQ overflow, buffers
+            // exhausted); re-arm while the registration is still wanted
+            const bool transient = cqe.res >= 0 || cqe.res == -ENOBUFS ||
+                                   cqe.res == -EAGAIN || cqe.res == -EINTR;
+            if (!more && !ended && transient) {
+                if (Slot* current = lookup(cqe.user_data)) {
+                    uring_arm(fd, *current);
+                }
+            }
+        }
+
+        if (has_buffer) {
+            uring_provide(bid);
+            return true;
+        }
+        return false;
+    }
+
+    Uring uring_;
+    #endif
+    #endif
+
+    ReactorConfig config_;
+    ReactorBackend backend_ = ReactorBackend::EPOLL;
+    int epoll_fd_ = -1;
+    bool dispatching_ = false;
+    std::size_t active_ = 0;
+    std::deque<Slot> slots_;                    // Indexed by fd; growth keeps references valid
+    std::vector<RetiredHandlers> retired_;
+    #ifdef __linux__
+    std::vector<epoll_event> epoll_events_;
+    #endif
+    std::vector<char> buffers_;                 // Receive buffer(s)
+};
+
+} // namespace hft
@@ -0,0 +1,85 @@
+/**
+ * @file seqlock.hpp
+ * @brief Single-writer sequence lock for publishing a value to readers
+ *
+ * The writer never waits: it bumps the sequence to odd, copies the value
+ * in and bumps it to even. Readers copy the value out and retry if the
+ * sequence was odd or changed meanwhile. Suits values written on a hot
+ * thread and read rarely (stats snapshots, cached quotes); T must be
+ * trivially copyable, since a reader may copy a half-written value before
+ * discarding it.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "busy_poll.hpp"
+#include "types.hpp"
+
+namespace hft {
+
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied bytewise");
+
+public:
+    SeqLock() noexcept : value_{} {}
+    explicit SeqLock(const T& value) noexcept : value_(value) {}
+
+    // Non-copyable
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Publish a new value (one writer thread only)
+     */
+    void store(const T& value) noexcept {
+        const std::uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(static_cast<void*>(&value_), &value, sizeof(T));
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy out a consistent value, retrying while a store is in progress
+     */
+    void load(T& out) const noexcept {
+        while (!try_load(out)) {
+            cpu_pause();
+        }
+    }
+
+    [[nodiscard]] T load() const noexcept {
+        T out;
+        load(out);
+        return out;
+    }
+
+    /**
+     * @brief One read attempt; false if it raced with a store
+     */
+    [[nodiscard]] bool try_load(T& out) const noexcept {
+        const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        std::memcpy(static_cast<void*>(&out), &value_, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence_.load(std::memory_order_relaxed) == before;
+    }
+
+    /**
+     * @brief Number of completed stores
+     */
+    [[nodiscard]] std::uint64_t version() const noexcept {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> sequence_{0};
+    T value_;
+};
+
+} // namespace hft
@@ -0,0 +1,356 @@
+/**
+ * @file slab_allocator.hpp
+ * @brief Growable, thread-caching slab allocator with lock-free remote frees
+ *
+ * For objects allocated on one thread and freed on another (e.g. reports
+ * built on the engine thread and released by the gateway thread), where
+ * ThreadSafeMemoryPool would serialize both sides on one spinlock.
+ *
+ * Layout:
+ * - Memory comes in 2 MB chunks (one huge page each when available), taken
+ *   under a mutex only when a thread runs out; the slab grows instead of
+ *   failing, up to an optional chunk limit
+ * - Each chunk is owned by one heap; its header is found by masking a block
+ *   address, so blocks carry no per-object header
+ * - Each thread attaches a Cache, which owns a heap: allocation and frees
+ *   of its own blocks touch only that heap's plain free list
+ * - Blocks freed by another thread are batched per owning heap and
+ *   returned with a single CAS onto the owner's remote free list; the
+ *   owner takes the whole list with one exchange when its local list runs
+ *   dry (pop-all, so there is no ABA)
+ *
+ * A thread that stops freeing should call Cache::flush() (or detach) so
+ * that partial batches reach their owners.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "types.hpp"
+#include "memory_region.hpp"
+
+namespace hft {
+
+/**
+ * @brief Slab configuration
+ */
+struct SlabConfig {
+    MemoryPolicy memory = default_memory_policy();  // Per chunk; at least THP
+    std::size_t max_chunks = 0;                     // 0 = grow without limit
+};
+
+/**
+ * @brief Slab allocator with per-thread caches
+ *
+ * @tparam T Object type
+ * @tparam Alignment Block alignment (default: one cache line per block)
+ */
+template<typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+class SlabAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be power of 2");
+
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    static constexpr std::size_t BLOCK_ALIGN = std::max({Alignment, alignof(T), alignof(FreeNode)});
+
+public:
+    static constexpr std::size_t CHUNK_SIZE = MemoryRegion::HUGE_PAGE_SIZE;
+    static constexpr std::size_t BLOCK_SIZE =
+        ((std::max(sizeof(T), sizeof(FreeNode)) + BLOCK_ALIGN - 1) / BLOCK_ALIGN) * BLOCK_ALIGN;
+    static constexpr std::size_t REMOTE_BATCH = 32;     // Blocks per remote return
+
+private:
+    struct Heap;
+
+    struct ChunkHeader {
+        Heap* owner;
+    };
+
+    static constexpr std::size_t HEADER_SIZE =
+        ((sizeof(ChunkHeader) + BLOCK_ALIGN - 1) / BLOCK_ALIGN) * BLOCK_ALIGN;
+
+public:
+    static constexpr std::size_t BLOCKS_PER_CHUNK = (CHUNK_SIZE - HEADER_SIZE) / BLOCK_SIZE;
+    static_assert(BLOCKS_PER_CHUNK > 0, "Object too large for a slab chunk");
+
+private:
+    // Remote frees waiting to be returned to one owner
+    struct Pending {
+        Heap* owner = nullptr;
+        FreeNode* head = nullptr;
+        FreeNode* tail = nullptr;
+        std::size_t count = 0;
+    };
+
+    static constexpr std::size_t PENDING_OWNERS = 4;
+
+    struct alignas(CACHE_LINE_SIZE) Heap {
+        // Attached thread only
+        FreeNode* local_free = nullptr;
+        std::uint8_t* bump = nullptr;
+        std::uint8_t* bump_end = nullptr;
+        std::array<Pending, PENDING_OWNERS> pending{};
+
+        // Other threads push returned batches here
+        alignas(CACHE_LINE_SIZE) std::atomic<FreeNode*> remote_free{nullptr};
+        std::atomic<bool> attached{false};
+    };
+
+public:
+    /**
+     * @brief Per-thread handle; one thread at a time, move-only
+     */
+    class Cache {
+    public:
+        Cache() noexcept = default;
+
+        Cache(Cache&& other) noexcept
+            : slab_(std::exchange(other.slab_, nullptr))
+            , heap_(std::exchange(other.heap_, nullptr)) {}
+
+        Cache& operator=(Cache&& other) noexcept {
+            if (this != &other) {
+                detach();
+                slab_ = std::exchange(other.slab_, nullptr);
+                heap_ = std::exchange(other.heap_, nullptr);
+            }
+            return *this;
+        }
+
+        Cache(const Cache&) = delete;
+        Cache& operator=(const Cache&) = delete;
+
+        ~Cache() { detach(); }
+
+        /**
+         * @brief Allocate a block; nullptr only if the slab hit max_chunks
+         */
+        [[nodiscard]] void* allocate() noexcept {
+            Heap& heap = *heap_;
+            if (!heap.local_free && heap.remote_free.load(std::memory_order_relaxed)) {
+                heap.local_free = heap.remote_free.exchange(nullptr, std::memory_order_acquire);
+            }
+            if (FreeNode* node = heap.local_free) {
+                heap.local_free = node->next;
+                return node;
+            }
+            if (heap.bump == heap.bump_end && !slab_->grow(heap)) {
+                return nullptr;
+            }
+            void* block = heap.bump;
+            heap.bump += BLOCK_SIZE;
+            return block;
+        }
+
+        /**
+         * @brief Free a block allocated by any cache of this slab
+         */
+        void deallocate(void* ptr) noexcept {
+            if (ptr == nullptr) return;
+
+            auto* node = static_cast<FreeNode*>(ptr);
+            Heap* owner = chunk_of(ptr)->owner;
+            if (owner == heap_) {
+                node->next = heap_->local_free;
+                heap_->local_free = node;
+                return;
+            }
+
+            auto& pending = heap_->pending;
+            Pending* slot = nullptr;
+            for (auto& p : pending) {
+                if (p.owner == owner) {
+                    slot = &p;
+                    break;
+                }
+            }
+            if (!slot) {
+                // Evict by owner address when all slots are busy
+                slot = &pending[(reinterpret_cast<std::uintptr_t>(owner) / sizeof(Heap)) % PENDING_OWNERS];
+                for (auto& p : pending) {
+                    if (!p.owner) {
+                        slot = &p;
+                        break;
+                    }
+                }
+                if (slot->owner) {
+                    return_batch(*slot);
+                }
+                slot->owner = owner;
+                slot->tail = node;
+            }
+            node->next = slot->head;
+            slot->head = node;
+            if (++slot->count == REMOTE_BATCH) {
+                return_batch(*slot);
+            }
+        }
+
+        template<typename... Args>
+        [[nodiscard]] T* create(Args&&... args) {
+            void* memory = allocate();
+            if (memory == nullptr) {
+                return nullptr;
+            }
+
+            try {
+                return new (memory) T(std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(memory);
+                throw;
+            }
+        }
+
+        void destroy(T* obj) noexcept(std::is_nothrow_destructible_v<T>) {
+            if (obj == nullptr) return;
+
+            obj->~T();
+            deallocate(obj);
+        }
+
+        /**
+         * @brief Return all partial remote batches to their owners
+         */
+        void flush() noexcept {
+            if (!heap_) return;
+            for (auto& p : heap_->pending) {
+                if (p.owner) {
+                    return_batch(p);
+                }
+            }
+        }
+
+        /**
+         * @brief Flush and give the heap back; a later attach() adopts it
+         */
+        void detach() noexcept {
+            if (!heap_) return;
+            flush();
+            heap_->attached.store(false, std::memory_order_release);
+            heap_ = nullptr;
+            slab_ = nullptr;
+        }
+
+        explicit operator bool() const noexcept { return heap_ != nullptr; }
+
+    private:
+        friend class SlabAllocator;
+
+        Cache(SlabAllocator* slab, Heap* heap) noexcept : slab_(slab), heap_(heap) {}
+
+        static void return_batch(Pending& p) noexcept {
+            FreeNode* old = p.owner->remote_free.load(std::memory_order_relaxed);
+            do {
+                p.tail->next = old;
+            } while (!p.owner->remote_free.compare_exchange_weak(
+                old, p.head, std::memory_order_release, std::memory_order_relaxed));
+            p = Pending{};
+        }
+
+        SlabAllocator* slab_ = nullptr;
+        Heap* heap_ = nullptr;
+    };
+
+    explicit SlabAllocator(const SlabConfig& config = {})
+        : config_(config)
+    {
+        if (config_.memory.page_size == PageSize::SMALL) {
+            config_.memory.page_size = PageSize::TRANSPARENT_HUGE;   // Chunks must be 2 MB aligned
+        }
+    }
+
+    /**
+     * @brief All caches must be detached first; live objects are not destroyed
+     */
+    ~SlabAllocator() = default;
+
+    // Non-copyable, non-movable (caches point back into the slab)
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+    SlabAllocator(SlabAllocator&&) = delete;
+    SlabAllocator& operator=(SlabAllocator&&) = delete;
+
+    /**
+     * @brief Cache for the calling thread, adopting an idle heap if any
+     *
+     * Setup path (takes the slab mutex).
+     */
+    [[nodiscard]] Cache attach() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& heap : heaps_) {
+            bool expected = false;
+            if (heap->attached.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return Cache(this, heap.get());
+            }
+        }
+        heaps_.push_back(std::make_unique<Heap>());
+        heaps_.back()->attached.store(true, std::memory_order_relaxed);
+        return Cache(this, heaps_.back().get());
+    }
+
+    /**
+     * @brief Chunks mapped so far
+     */
+    [[nodiscard]] std::size_t chunk_count() const noexcept {
+        return chunk_count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Blocks the slab can hold without growing
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return chunk_count() * BLOCKS_PER_CHUNK;
+    }
+
+private:
+    static ChunkHeader* chunk_of(const void* ptr) noexcept {
+        return reinterpret_cast<ChunkHeader*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(CHUNK_SIZE - 1));
+    }
+
+    /**
+     * @brief Give a heap a fresh chunk to bump through (slow path)
+     */
+    bool grow(Heap& heap) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (config_.max_chunks != 0 && chunks_.size() >= config_.max_chunks) {
+            return false;
+        }
+
+        MemoryRegion region(CHUNK_SIZE, config_.memory);
+        if (!region || reinterpret_cast<std::uintptr_t>(region.data()) % CHUNK_SIZE != 0) {
+            return false;
+        }
+        try {
+            chunks_.push_back(std::move(region));
+        } catch (...) {
+            return false;
+        }
+
+        std::uint8_t* base = chunks_.back().data();
+        new (base) ChunkHeader{&heap};
+        heap.bump = base + HEADER_SIZE;
+        heap.bump_end = heap.bump + BLOCKS_PER_CHUNK * BLOCK_SIZE;
+        chunk_count_.store(chunks_.size(), std::memory_order_relaxed);
+        return true;
+    }
+
+    SlabConfig config_;
+    std::mutex mutex_;                                  // Chunk and heap lists
+    std::vector<MemoryRegion> chunks_;
+    std::vector<std::unique_ptr<Heap>> heaps_;
+    std::atomic<std::size_t> chunk_count_{0};
+};
+
+} // namespace hft
@@ -11,6 +11,11 @@
  * - Spinlock: Basic test-and-set spinlock
  * - TicketSpinlock: Fair spinlock with FIFO ordering
  * - ReaderWriterSpinlock: Multiple readers, single writer
+ * 
+ * Every RWSpinlock reader still writes the shared state word. For data
+ * read on every order and rarely written, prefer SeqLock (seqlock.hpp,
+ * small trivially copyable values) or RcuPtr (rcu.hpp, larger structures):
+ * their readers never write a line other threads read.
  */
 
 #pragma once
@@ -3,8 +3,10 @@
  * @brief Thread-Local Timestamp Buffer for Contention-Free Recording
  * 
  * Timestamps are recorded into a thread-local buffer to avoid synchronization
- * at record-time. Each thread writes its events (with sequence numbers) to an
- * array. Only after the test, or when a buffer fills up, do we aggregate them.
+ * at record-time. Each thread writes its events (with sequence numbers) to its
+ * own SPSC ring. For short runs the rings are aggregated after the test; for
+ * long ones a collector thread drains them continuously, merging the rings
+ * by sequence into a memory-mapped event file that is analyzed offline.
  * 
  * Design benefits:
  *   - No contention between threads during recording
@@ -15,7 +17,7 @@
  * Recommendation: Have an extra core available for post-processing, or do
  * aggregation after the measured run to keep measurements clean.
  * 
- * Buffer layout (per thread):
+ * Buffer layout (per thread, wrapping):
  *   [event1][event2][event3]...[eventN]
  *   
  * Each event contains:
@@ -28,7 +30,12 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <array>
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <string_view>
 #include <vector>
 #include <atomic>
 #include <thread>
@@ -42,6 +49,9 @@
 
 #include "types.hpp"
 #include "timing.hpp"
+#include "memory_region.hpp"
+#include "async_binary_log.hpp"
+#include "cpu_affinity.hpp"
 
 namespace hft {
 
@@ -58,9 +68,11 @@ enum class EventType : std::uint8_t {
     ORDER_MATCHED = 6,
     QUEUE_PUSH = 7,
     QUEUE_POP = 8,
+    PACKET_RX = 9,          // Kernel/NIC receive stamp in ns, not TSC ticks
     CUSTOM_1 = 10,
     CUSTOM_2 = 11,
     CUSTOM_3 = 12,
+    STRATEGY_STAGE = 13,    // Strategy mark: payload = StageLabel text, sequence = tick
     USER_DEFINED = 255
 };
 
@@ -79,21 +91,63 @@ struct alignas(8) TimestampEvent {
 };
 static_assert(sizeof(TimestampEvent) == 32, "TimestampEvent should be 32 bytes");
 
+/**
+ * @brief Compile-time stage label for STRATEGY_STAGE marks
+ * 
+ * Only constructible in a constant expression (a string literal), so a mark
+ * stores the literal's address and never copies, formats or hashes text.
+ * TimestampAnalyzer turns the address back into the label offline.
+ */
+struct StageLabel {
+    const char* text;
+
+    consteval StageLabel(const char* label) noexcept : text(label) {}
+
+    [[nodiscard]] std::uint64_t id() const noexcept {
+        return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(text));
+    }
+
+    [[nodiscard]] static const char* text_of(std::uint64_t id) noexcept {
+        return reinterpret_cast<const char*>(static_cast<std::uintptr_t>(id));
+    }
+};
+
 /**
  * @brief Thread-local timestamp buffer
  * 
- * Each thread has its own buffer to avoid contention. The buffer is
- * heap-allocated to avoid TLS size limitations, but pre-allocated
- * at construction time to avoid allocations during recording.
+ * Each thread has its own buffer to avoid contention. The buffer lives in
+ * a MemoryRegion (not TLS, which is size-limited) on the creating thread's
+ * NUMA node, prefaulted so recording never takes a page fault.
  * 
- * @tparam Capacity Maximum number of events per thread
+ * It is a wrap-around SPSC ring: the owning thread records, one consumer
+ * (the collector, or the owner itself between measurements) drains. An
+ * event is only dropped, and counted, when the consumer is a whole ring
+ * behind.
+ * 
+ * @tparam Capacity Maximum number of undrained events (power of two)
  */
-template<std::size_t Capacity = 100000>
+template<std::size_t Capacity = 131072>
 class ThreadLocalTimestampBuffer {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static constexpr std::uint64_t MASK = Capacity - 1;
+
 public:
-    ThreadLocalTimestampBuffer() : count_(0), thread_id_(0) {
-        // Heap allocate to avoid TLS size limitations on ARM64
-        events_ = std::make_unique<std::array<TimestampEvent, Capacity>>();
+    ThreadLocalTimestampBuffer() : ThreadLocalTimestampBuffer(default_policy()) {}
+
+    explicit ThreadLocalTimestampBuffer(const MemoryPolicy& policy)
+        : region_(Capacity * sizeof(TimestampEvent), policy)
+        , events_(reinterpret_cast<TimestampEvent*>(region_.data()))
+        , thread_id_(0)
+    {}
+
+    /**
+     * @brief Default backing: local node, huge pages if available, prefaulted
+     */
+    static MemoryPolicy default_policy() noexcept {
+        MemoryPolicy policy = default_memory_policy();
+        policy.numa_node = MemoryPolicy::NUMA_LOCAL;
+        policy.prefault = true;
+        return policy;
     }
     
     /**
@@ -104,23 +158,14 @@ public:
      * 
      * @param type Event type
      * @param payload Optional payload (e.g., order ID)
-     * @return true if recorded, false if buffer full
+     * @return true if recorded, false if the ring is full
      */
     [[nodiscard]] bool record(EventType type, std::uint64_t payload = 0) noexcept {
-        if (count_ >= Capacity || !events_) {
-            return false;  // Buffer full or not allocated
-        }
-        
-        auto& event = (*events_)[count_];
-        event.timestamp = rdtscp();  // Use serializing TSC read
-        event.sequence = global_sequence_.fetch_add(1, std::memory_order_relaxed);
-        event.payload = payload;
-        event.type = type;
-        event.thread_id = thread_id_;
-        event.reserved = 0;
-        
-        ++count_;
-        return true;
+        TimestampEvent* event = claim();
+        if (!event) return false;
+        event->timestamp = static_cast<std::int64_t>(rdtscp());  // Use serializing TSC read
+        event->sequence = global_sequence_.fetch_add(1, std::memory_order_relaxed);
+        return publish(event, type, payload);
     }
     
     /**
@@ -131,55 +176,108 @@ public:
         std::int64_t timestamp,
         std::uint64_t payload = 0
     ) noexcept {
-        if (count_ >= Capacity || !events_) {
-            return false;
+        TimestampEvent* event = claim();
+        if (!event) return false;
+        event->timestamp = timestamp;
+        event->sequence = global_sequence_.fetch_add(1, std::memory_order_relaxed);
+        return publish(event, type, payload);
+    }
+    
+    /**
+     * @brief Record a single-thread stream event with raw rdtsc()
+     * 
+     * For streams whose buffer order is already their order (strategy stage
+     * marks): the caller's sequence is stored as is, so there is no shared
+     * atomic, and rdtsc() skips rdtscp's wait for prior instructions. Not
+     * for buffers the collector merges by global sequence.
+     */
+    [[nodiscard]] bool record_local(
+        EventType type,
+        std::uint64_t sequence,
+        std::uint64_t payload
+    ) noexcept {
+        TimestampEvent* event = claim();
+        if (!event) return false;
+        event->timestamp = static_cast<std::int64_t>(rdtsc());
+        event->sequence = sequence;
+        return publish(event, type, payload);
+    }
+    
+    /**
+     * @brief Oldest undrained event, or nullptr (consumer side)
+     */
+    [[nodiscard]] const TimestampEvent* front() const noexcept {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return nullptr;
+        return &events_[tail & MASK];
+    }
+    
+    /**
+     * @brief Release the event returned by front() (consumer side)
+     */
+    void pop() noexcept {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Hand every undrained event to fn in order (consumer side)
+     */
+    template<typename Fn>
+    std::size_t drain(Fn&& fn) {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+        for (std::uint64_t i = tail; i != head; ++i) {
+            fn(events_[i & MASK]);
         }
-        
-        auto& event = (*events_)[count_];
-        event.timestamp = timestamp;
-        event.sequence = global_sequence_.fetch_add(1, std::memory_order_relaxed);
-        event.payload = payload;
-        event.type = type;
-        event.thread_id = thread_id_;
-        event.reserved = 0;
-        
-        ++count_;
-        return true;
+        tail_.store(head, std::memory_order_release);
+        return static_cast<std::size_t>(head - tail);
     }
     
     /**
-     * @brief Get recorded events (call after test completes)
+     * @brief Copy undrained events without consuming them
      */
-    [[nodiscard]] const TimestampEvent* events() const noexcept {
-        return events_ ? events_->data() : nullptr;
+    template<typename Fn>
+    void peek_all(Fn&& fn) const {
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+        for (std::uint64_t i = tail_.load(std::memory_order_acquire); i != head; ++i) {
+            fn(events_[i & MASK]);
+        }
     }
     
     /**
-     * @brief Get number of recorded events
+     * @brief Get number of undrained events
      */
     [[nodiscard]] std::size_t count() const noexcept {
-        return count_;
+        return static_cast<std::size_t>(head_.load(std::memory_order_acquire) -
+                                        tail_.load(std::memory_order_acquire));
     }
     
     /**
-     * @brief Clear buffer for reuse
+     * @brief Discard undrained events (consumer side)
      */
     void clear() noexcept {
-        count_ = 0;
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
     }
     
     /**
-     * @brief Check if buffer is full
+     * @brief Check if the ring is full
      */
     [[nodiscard]] bool full() const noexcept {
-        return count_ >= Capacity;
+        return count() >= Capacity;
     }
     
     /**
      * @brief Get remaining capacity
      */
     [[nodiscard]] std::size_t remaining() const noexcept {
-        return Capacity - count_;
+        return Capacity - count();
+    }
+    
+    /**
+     * @brief Events lost because the ring was full
+     */
+    [[nodiscard]] std::uint64_t dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
     }
     
     /**
@@ -196,12 +294,47 @@ public:
         return thread_id_;
     }
 
+    /**
+     * @brief Next value of the cross-thread sequence (collector watermark)
+     */
+    [[nodiscard]] static std::uint64_t next_sequence() noexcept {
+        return global_sequence_.load(std::memory_order_acquire);
+    }
+
 private:
-    // Heap-allocated to avoid TLS size limitations (32 bytes * 100k = 3.2MB)
-    std::unique_ptr<std::array<TimestampEvent, Capacity>> events_;
-    std::size_t count_;
+    TimestampEvent* claim() noexcept {
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ >= Capacity || !events_) [[unlikely]] {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ >= Capacity || !events_) {
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return &events_[head & MASK];
+    }
+
+    bool publish(TimestampEvent* event, EventType type, std::uint64_t payload) noexcept {
+        event->payload = payload;
+        event->type = type;
+        event->thread_id = thread_id_;
+        event->reserved = 0;
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    MemoryRegion region_;           // 32 bytes * 128k = 4MB
+    TimestampEvent* events_;        // Null if the region could not be mapped
     std::uint8_t thread_id_;
     
+    // Producer (owning thread)
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head_{0};
+    std::uint64_t cached_tail_ = 0;
+    std::atomic<std::uint64_t> dropped_{0};
+    
+    // Consumer
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail_{0};
+    
     // Global sequence counter for ordering events across threads
     static inline std::atomic<std::uint64_t> global_sequence_{0};
 };
@@ -210,8 +343,9 @@ private:
  * @brief Manager for thread-local timestamp buffers
  * 
  * Provides thread-local storage and aggregation of events from all threads.
- * The logging thread is idle during the test and only wakes up afterwards
- * to collate results.
+ * Either aggregate() after the test (short runs), or run the collector
+ * thread, which streams every buffer into an event file while the test
+ * runs (soak runs, where no buffer could hold the whole run).
  * 
  * Key design: Instead of storing pointers to thread-local buffers (which
  * become invalid when threads exit), each thread flushes its events to a
@@ -219,8 +353,12 @@ private:
  */
 class TimestampBufferManager {
 public:
-    static constexpr std::size_t BUFFER_CAPACITY = 100000;
+    static constexpr std::size_t BUFFER_CAPACITY = 131072;
     using Buffer = ThreadLocalTimestampBuffer<BUFFER_CAPACITY>;
+    using EventFile = MappedRecordFile<TimestampEvent>;
+    
+    // An event is merged once the sequence counter has been past it this long
+    static constexpr auto COLLECTOR_GRACE = std::chrono::milliseconds(1);
     
     /**
      * @brief Get the thread-local buffer for the current thread
@@ -245,8 +383,8 @@ public:
     /**
      * @brief Aggregate all events from all threads (call after test)
      * 
-     * This should be called from a dedicated logging thread or after
-     * the measured run completes to avoid perturbing measurements.
+     * Copies undrained events without consuming them. This should be
+     * called after the measured run completes, with the collector stopped.
      * 
      * @param sort_by_sequence If true, sort events by sequence number
      * @return Vector of all events from all threads
@@ -267,11 +405,9 @@ public:
             // Copy events from all buffers
             for (const auto& buffer : instance().buffers_) {
                 if (!buffer) continue;
-                const auto* events = buffer->events();
-                if (!events) continue;
-                for (std::size_t i = 0; i < buffer->count(); ++i) {
-                    all_events.push_back(events[i]);
-                }
+                buffer->peek_all([&](const TimestampEvent& event) {
+                    all_events.push_back(event);
+                });
             }
         }
         
@@ -286,6 +422,58 @@ public:
         return all_events;
     }
     
+    /**
+     * @brief Stream every buffer into an event file until stop_collector()
+     * 
+     * The collector drains all registered rings continuously and merges
+     * them on-line by sequence (k-way: smallest ring front first), so the
+     * file comes out in global order with no final sort and no buffer has
+     * to hold the whole run. An event is written only once every smaller
+     * sequence is known to be published: the watermark is the sequence
+     * counter as it stood COLLECTOR_GRACE ago, which only a producer
+     * stalled mid-record for longer than that could miss.
+     * 
+     * The file's metadata is the calibrated TSC frequency (a double), so
+     * TimestampAnalyzer::analyze_file needs nothing else.
+     * 
+     * @param cpu_core Core to pin the collector to, or -1
+     */
+    static bool start_collector(const std::string& path, int cpu_core = -1,
+                                std::size_t expected_events = 1u << 20) {
+        auto& mgr = instance();
+        if (mgr.collector_.joinable()) return false;
+        
+        const double frequency = HighPrecisionTimer::instance().frequency();
+        const std::string_view metadata(reinterpret_cast<const char*>(&frequency), sizeof(frequency));
+        if (!mgr.event_file_.open(path, expected_events, metadata)) return false;
+        
+        mgr.collector_running_.store(true, std::memory_order_release);
+        mgr.collector_ = std::thread([cpu_core] {
+            if (cpu_core >= 0) {
+                set_cpu_affinity(cpu_core);
+            }
+            instance().run_collector();
+        });
+        return true;
+    }
+    
+    /**
+     * @brief Drain everything recorded so far, close the file
+     * 
+     * Call once the producers have stopped recording.
+     * @return Number of events written to the file
+     */
+    static std::uint64_t stop_collector() {
+        auto& mgr = instance();
+        mgr.collector_running_.store(false, std::memory_order_release);
+        if (mgr.collector_.joinable()) {
+            mgr.collector_.join();
+        }
+        const std::uint64_t written = mgr.event_file_.records_written();
+        mgr.event_file_.close();
+        return written;
+    }
+    
     /**
      * @brief Clear all buffers
      */
@@ -297,7 +485,7 @@ public:
     }
     
     /**
-     * @brief Get total event count across all threads
+     * @brief Get total undrained event count across all threads
      */
     static std::size_t total_count() {
         std::lock_guard<std::mutex> lock(instance().mutex_);
@@ -330,8 +518,8 @@ public:
             const auto& buffer = instance().buffers_[i];
             if (!buffer) continue;
             std::cout << "  Thread " << i << ": " << buffer->count() << " events";
-            if (buffer->full()) {
-                std::cout << " (FULL - events may have been dropped!)";
+            if (buffer->dropped() > 0) {
+                std::cout << " (" << buffer->dropped() << " dropped - ring was full!)";
             }
             std::cout << "\n";
             total += buffer->count();
@@ -353,11 +541,73 @@ private:
         std::lock_guard<std::mutex> lock(instance().mutex_);
         buffer->set_thread_id(static_cast<std::uint8_t>(instance().buffers_.size()));
         instance().buffers_.push_back(buffer);
+        instance().registered_.store(instance().buffers_.size(), std::memory_order_release);
         return buffer;
     }
     
+    void run_collector() {
+        std::vector<std::shared_ptr<Buffer>> rings;
+        // (time, next sequence) samples, oldest first, one per GRACE / 8
+        std::deque<std::pair<std::chrono::steady_clock::time_point, std::uint64_t>> samples;
+        
+        for (;;) {
+            // Read the flag first so nothing recorded before stop is missed
+            const bool running = collector_running_.load(std::memory_order_acquire);
+            
+            if (registered_.load(std::memory_order_acquire) != rings.size()) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                rings = buffers_;
+            }
+            
+            std::uint64_t watermark = UINT64_MAX;
+            if (running) {
+                const auto now_time = std::chrono::steady_clock::now();
+                if (samples.empty() || now_time - samples.back().first >= COLLECTOR_GRACE / 8) {
+                    samples.emplace_back(now_time, Buffer::next_sequence());
+                }
+                while (samples.size() > 1 && now_time - samples[1].first >= COLLECTOR_GRACE) {
+                    samples.pop_front();
+                }
+                watermark = now_time - samples.front().first >= COLLECTOR_GRACE ? samples.front().second : 0;
+            }
+            
+            const std::size_t merged = merge(rings, watermark);
+            if (!running) break;
+            if (merged == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+    
+    // Write ring fronts below watermark in sequence order
+    std::size_t merge(const std::vector<std::shared_ptr<Buffer>>& rings, std::uint64_t watermark) {
+        std::size_t merged = 0;
+        for (;;) {
+            Buffer* next = nullptr;
+            const TimestampEvent* next_event = nullptr;
+            for (const auto& ring : rings) {
+                const TimestampEvent* event = ring->front();
+                if (event && event->sequence < watermark &&
+                    (!next_event || event->sequence < next_event->sequence)) {
+                    next = ring.get();
+                    next_event = event;
+                }
+            }
+            if (!next) return merged;
+            event_file_.append(*next_event);
+            next->pop();
+            ++merged;
+        }
+    }
+    
     std::mutex mutex_;
     std::vector<std::shared_ptr<Buffer>> buffers_;
+    std::atomic<std::size_t> registered_{0};
+    
+    // Collector
+    std::thread collector_;
+    std::atomic<bool> collector_running_{false};
+    EventFile event_file_;
 };
 
 /**
@@ -383,55 +633,104 @@ public:
         const std::vector<LatencyPair>& pairs,
         double tsc_frequency
     ) {
-        double ns_per_tick = 1e9 / tsc_frequency;
-        
-        std::cout << "\n--- Timestamp Event Analysis ---\n";
-        std::cout << "  Total events: " << events.size() << "\n";
-        std::cout << "  TSC frequency: " << (tsc_frequency / 1e9) << " GHz\n\n";
+        PairLatencies latencies(pairs, tsc_frequency);
+        for (const auto& event : events) {
+            latencies.add(event);
+        }
+        latencies.print(events.size(), tsc_frequency);
+    }
+    
+    /**
+     * @brief Compute latencies between paired events straight from an event file
+     * 
+     * Streams a TimestampBufferManager collector file in one pass, so memory
+     * is bounded by the pairs still open, not by the length of the run.
+     * 
+     * @return false if the file could not be read
+     */
+    static bool analyze_file(const std::string& path, const std::vector<LatencyPair>& pairs) {
+        std::string metadata;
+        double tsc_frequency = 0;
+        std::optional<PairLatencies> latencies;
+        std::size_t count = 0;
         
-        for (const auto& pair : pairs) {
-            std::vector<double> latencies;
-            
-            // Find matching pairs by payload (e.g., order ID)
-            std::unordered_map<std::uint64_t, std::int64_t> start_times;
-            
-            for (const auto& event : events) {
-                if (event.type == pair.start_type) {
-                    start_times[event.payload] = event.timestamp;
-                } else if (event.type == pair.end_type) {
-                    auto it = start_times.find(event.payload);
-                    if (it != start_times.end()) {
-                        double latency_ns = (event.timestamp - it->second) * ns_per_tick;
-                        latencies.push_back(latency_ns);
-                        start_times.erase(it);
+        const bool ok = TimestampBufferManager::EventFile::for_each_record(path, metadata,
+            [&](const TimestampEvent& event) {
+                if (!latencies) {
+                    if (metadata.size() == sizeof(tsc_frequency)) {
+                        std::memcpy(&tsc_frequency, metadata.data(), sizeof(tsc_frequency));
                     }
+                    latencies.emplace(pairs, tsc_frequency);
                 }
-            }
+                latencies->add(event);
+                ++count;
+            });
+        if (!latencies) {
+            latencies.emplace(pairs, tsc_frequency);
+        }
+        latencies->print(count, tsc_frequency);
+        return ok;
+    }
+    
+    /**
+     * @brief Walk STRATEGY_STAGE marks and compute stage-to-stage deltas
+     * 
+     * Consecutive marks with the same sequence (tick) form a chain; for each
+     * link on_delta(from_label, to_label, tsc_ticks) is called, and once
+     * per chain on_chain(first_to_last_ticks). Other event types are skipped.
+     * Feed events in order with operator(), then finish(). Labels are
+     * addresses in the recording process, so walk marks in that process.
+     */
+    template<typename DeltaFn, typename ChainFn>
+    class StageDeltaWalker {
+    public:
+        StageDeltaWalker(DeltaFn on_delta, ChainFn on_chain)
+            : on_delta_(std::forward<DeltaFn>(on_delta)), on_chain_(std::forward<ChainFn>(on_chain)) {}
+        
+        void operator()(const TimestampEvent& event) {
+            if (event.type != EventType::STRATEGY_STAGE) return;
             
-            if (latencies.empty()) {
-                std::cout << pair.name << ": No matching pairs found\n";
-                continue;
+            if (!started_ || prev_.sequence != event.sequence) {
+                finish();
+                first_ = event;
+                started_ = true;
+            } else {
+                on_delta_(StageLabel::text_of(prev_.payload), StageLabel::text_of(event.payload),
+                          event.timestamp - prev_.timestamp);
+                linked_ = true;
             }
-            
-            // Compute statistics
-            std::sort(latencies.begin(), latencies.end());
-            
-            double sum = 0;
-            for (double l : latencies) sum += l;
-            double avg = sum / latencies.size();
-            
-            auto percentile = [&](double p) {
-                size_t idx = static_cast<size_t>(latencies.size() * p);
-                return latencies[std::min(idx, latencies.size() - 1)];
-            };
-            
-            std::cout << pair.name << " (n=" << latencies.size() << "):\n";
-            std::cout << "  Min:    " << latencies.front() << " ns\n";
-            std::cout << "  Max:    " << latencies.back() << " ns\n";
-            std::cout << "  Avg:    " << avg << " ns\n";
-            std::cout << "  Median: " << percentile(0.50) << " ns\n";
-            std::cout << "  P99:    " << percentile(0.99) << " ns\n\n";
+            prev_ = event;
+        }
+        
+        void finish() {
+            if (started_ && linked_) {
+                on_chain_(prev_.timestamp - first_.timestamp);
+            }
+            started_ = false;
+            linked_ = false;
+        }
+        
+    private:
+        DeltaFn on_delta_;
+        ChainFn on_chain_;
+        TimestampEvent first_{};
+        TimestampEvent prev_{};
+        bool started_ = false;
+        bool linked_ = false;
+    };
+    
+    template<typename DeltaFn, typename ChainFn>
+    static void for_each_stage_delta(
+        const TimestampEvent* events,
+        std::size_t count,
+        DeltaFn&& on_delta,
+        ChainFn&& on_chain
+    ) {
+        StageDeltaWalker<DeltaFn&, ChainFn&> walker(on_delta, on_chain);
+        for (std::size_t i = 0; i < count; ++i) {
+            walker(events[i]);
         }
+        walker.finish();
     }
     
     /**
@@ -462,6 +761,60 @@ public:
         
         std::cout << "Exported " << events.size() << " events to " << filename << "\n";
     }
+
+private:
+    /**
+     * @brief Per-pair start matching (by payload) and latency histograms
+     */
+    class PairLatencies {
+    public:
+        PairLatencies(const std::vector<LatencyPair>& pairs, double tsc_frequency)
+            : pairs_(pairs)
+            , ns_per_tick_(tsc_frequency > 0 ? 1e9 / tsc_frequency : 1.0)
+            , open_(pairs.size())
+            , stats_(pairs.size()) {}
+        
+        void add(const TimestampEvent& event) {
+            for (std::size_t i = 0; i < pairs_.size(); ++i) {
+                if (event.type == pairs_[i].start_type) {
+                    open_[i][event.payload] = event.timestamp;
+                } else if (event.type == pairs_[i].end_type) {
+                    auto it = open_[i].find(event.payload);
+                    if (it != open_[i].end()) {
+                        stats_[i].add_sample(static_cast<std::int64_t>(
+                            static_cast<double>(event.timestamp - it->second) * ns_per_tick_));
+                        open_[i].erase(it);
+                    }
+                }
+            }
+        }
+        
+        void print(std::size_t event_count, double tsc_frequency) const {
+            std::cout << "\n--- Timestamp Event Analysis ---\n";
+            std::cout << "  Total events: " << event_count << "\n";
+            std::cout << "  TSC frequency: " << (tsc_frequency / 1e9) << " GHz\n\n";
+            
+            for (std::size_t i = 0; i < pairs_.size(); ++i) {
+                const auto& stats = stats_[i];
+                if (stats.empty()) {
+                    std::cout << pairs_[i].name << ": No matching pairs found\n";
+                    continue;
+                }
+                std::cout << pairs_[i].name << " (n=" << stats.count() << "):\n";
+                std::cout << "  Min:    " << stats.min() << " ns\n";
+                std::cout << "  Max:    " << stats.max() << " ns\n";
+                std::cout << "  Avg:    " << stats.mean() << " ns\n";
+                std::cout << "  Median: " << stats.median() << " ns\n";
+                std::cout << "  P99:    " << stats.percentile(99.0) << " ns\n\n";
+            }
+        }
+        
+    private:
+        const std::vector<LatencyPair>& pairs_;
+        double ns_per_tick_;
+        std::vector<std::unordered_map<std::uint64_t, std::int64_t>> open_;
+        std::vector<LatencyStats> stats_;
+    };
 };
 
 /**
@@ -12,7 +12,9 @@
 
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <algorithm>
+#include <bit>
 #include <vector>
 #include <numeric>
 #include <cmath>
@@ -20,6 +22,7 @@
 #include <atomic>
 #include <thread>
 #include "types.hpp"
+#include "hdr_histogram.hpp"
 
 namespace hft {
 
@@ -338,76 +341,69 @@ private:
 /**
  * @brief Latency statistics collector
  * 
- * Collects samples and computes statistics useful for latency analysis.
+ * Records into an HdrHistogram (1% resolution, 0 ns to 60 s), so memory is
+ * constant however long the run, add_sample is O(1) and percentiles are a
+ * walk over the buckets instead of a sort. Collectors on different threads
+ * combine with merge().
  */
 class LatencyStats {
 public:
-    explicit LatencyStats(std::size_t reserve_size = 10000) {
-        samples_.reserve(reserve_size);
-    }
+    using Histogram = HdrHistogram<2>;
 
-    void add_sample(std::int64_t nanos) {
-        samples_.push_back(nanos);
-    }
+    LatencyStats() noexcept = default;
 
-    void add_sample_ns(Duration nanos) {
-        samples_.push_back(nanos);
-    }
+    // The capacity hint predates the histogram; memory is now fixed
+    explicit LatencyStats(std::size_t /*reserve_size*/) noexcept {}
 
-    void clear() {
-        samples_.clear();
+    void add_sample(std::int64_t nanos) noexcept {
+        histogram_.record(nanos);
+        const double v = static_cast<double>(std::max<std::int64_t>(nanos, 0));
+        sum_sq_ += v * v;
     }
 
-    [[nodiscard]] std::size_t count() const { return samples_.size(); }
-    [[nodiscard]] bool empty() const { return samples_.empty(); }
-
-    [[nodiscard]] double min() const {
-        if (samples_.empty()) return 0.0;
-        return static_cast<double>(*std::min_element(samples_.begin(), samples_.end()));
+    void add_sample_ns(Duration nanos) noexcept {
+        add_sample(nanos);
     }
 
-    [[nodiscard]] double max() const {
-        if (samples_.empty()) return 0.0;
-        return static_cast<double>(*std::max_element(samples_.begin(), samples_.end()));
+    void merge(const LatencyStats& other) noexcept {
+        histogram_.merge(other.histogram_);
+        sum_sq_ += other.sum_sq_;
     }
 
-    [[nodiscard]] double mean() const {
-        if (samples_.empty()) return 0.0;
-        const auto sum = std::accumulate(samples_.begin(), samples_.end(), 0LL);
-        return static_cast<double>(sum) / static_cast<double>(samples_.size());
+    void clear() noexcept {
+        histogram_.reset();
+        sum_sq_ = 0.0;
     }
 
-    [[nodiscard]] double median() const {
+    [[nodiscard]] std::size_t count() const noexcept { return histogram_.count(); }
+    [[nodiscard]] bool empty() const noexcept { return histogram_.empty(); }
+
+    [[nodiscard]] double min() const noexcept { return static_cast<double>(histogram_.min()); }
+    [[nodiscard]] double max() const noexcept { return static_cast<double>(histogram_.max()); }
+    [[nodiscard]] double mean() const noexcept { return histogram_.mean(); }
+
+    [[nodiscard]] double median() const noexcept {
         return percentile(50.0);
     }
 
-    [[nodiscard]] double percentile(double p) const {
-        if (samples_.empty()) return 0.0;
-        
-        std::vector<std::int64_t> sorted = samples_;
-        std::sort(sorted.begin(), sorted.end());
-        
-        const double rank = (p / 100.0) * static_cast<double>(sorted.size() - 1);
-        const auto lower = static_cast<std::size_t>(rank);
-        const auto upper = std::min(lower + 1, sorted.size() - 1);
-        const double frac = rank - static_cast<double>(lower);
-        
-        return static_cast<double>(sorted[lower]) * (1.0 - frac) + 
-               static_cast<double>(sorted[upper]) * frac;
+    /**
+     * @brief Value at percentile p (0-100), within the histogram's 1% resolution
+     */
+    [[nodiscard]] double percentile(double p) const noexcept {
+        return static_cast<double>(histogram_.value_at_percentile(p));
     }
 
-    [[nodiscard]] double stddev() const {
-        if (samples_.size() < 2) return 0.0;
+    [[nodiscard]] double stddev() const noexcept {
+        const std::size_t n = count();
+        if (n < 2) return 0.0;
         
         const double avg = mean();
-        double sum_sq = 0.0;
-        for (const auto& sample : samples_) {
-            const double diff = static_cast<double>(sample) - avg;
-            sum_sq += diff * diff;
-        }
-        return std::sqrt(sum_sq / static_cast<double>(samples_.size() - 1));
+        const double var = (sum_sq_ - static_cast<double>(n) * avg * avg) / static_cast<double>(n - 1);
+        return var > 0.0 ? std::sqrt(var) : 0.0;
     }
 
+    [[nodiscard]] const Histogram& histogram() const noexcept { return histogram_; }
+
     /**
      * @brief Get common percentiles (p50, p90, p95, p99, p99.9)
      */
@@ -430,7 +426,7 @@ public:
      */
     void print_summary(const char* label = "Latency") const {
         const auto p = get_percentiles();
-        std::printf("%s Statistics (n=%zu):\n", label, samples_.size());
+        std::printf("%s Statistics (n=%zu):\n", label, count());
         std::printf("  Min:    %.2f ns\n", min());
         std::printf("  Max:    %.2f ns\n", max());
         std::printf("  Mean:   %.2f ns\n", mean());
@@ -442,67 +438,59 @@ public:
         std::printf("  P99.9:  %.2f ns\n", p.p999);
     }
 
-private:
-    std::vector<std::int64_t> samples_;
-};
-
-/**
- * @brief Histogram for latency distribution
- * 
- * Fixed-bucket histogram optimized for typical latency ranges.
- */
-template<std::size_t BucketCount = 100>
-class LatencyHistogram {
-public:
-    explicit LatencyHistogram(std::int64_t bucket_width_ns = 100)
-        : bucket_width_(bucket_width_ns), count_(0) {
-        buckets_.fill(0);
-    }
-
-    void record(std::int64_t nanos) {
-        const auto bucket = std::min(
-            static_cast<std::size_t>(nanos / bucket_width_),
-            BucketCount - 1
-        );
-        ++buckets_[bucket];
-        ++count_;
-    }
-
-    void reset() {
-        buckets_.fill(0);
-        count_ = 0;
-    }
-
-    [[nodiscard]] std::size_t total_count() const { return count_; }
-    [[nodiscard]] std::int64_t bucket_width() const { return bucket_width_; }
-
-    [[nodiscard]] std::size_t bucket_count(std::size_t bucket) const {
-        return bucket < BucketCount ? buckets_[bucket] : 0;
-    }
-
+    /**
+     * @brief Print the distribution as one bar per power of two
+     */
     void print_histogram() const {
-        const auto max_count = *std::max_element(buckets_.begin(), buckets_.end());
-        constexpr std::size_t BAR_WIDTH = 50;
-        
-        std::printf("Latency Histogram (bucket=%ldns, total=%zu):\n", 
-                    bucket_width_, count_);
+        std::array<std::uint64_t, 64> octaves{};
+        histogram_.for_each_bucket([&](std::int64_t value, std::uint64_t n) {
+            octaves[static_cast<std::size_t>(std::bit_width(static_cast<std::uint64_t>(value)))] += n;
+        });
+        const auto max_count = *std::max_element(octaves.begin(), octaves.end());
+        constexpr std::uint64_t BAR_WIDTH = 50;
         
-        for (std::size_t i = 0; i < BucketCount; ++i) {
-            if (buckets_[i] == 0) continue;
+        std::printf("Latency Histogram (total=%zu):\n", count());
+        for (std::size_t i = 0; i < octaves.size(); ++i) {
+            if (octaves[i] == 0) continue;
             
-            const auto bar_len = (buckets_[i] * BAR_WIDTH) / max_count;
-            std::printf("%6ldns: ", static_cast<long>(i * bucket_width_));
-            for (std::size_t j = 0; j < bar_len; ++j) {
+            const auto bar_len = (octaves[i] * BAR_WIDTH) / max_count;
+            std::printf("%10llu ns: ", i == 0 ? 0ULL : 1ULL << (i - 1));
+            for (std::uint64_t j = 0; j < bar_len; ++j) {
                 std::printf("█");
             }
-            std::printf(" %zu\n", buckets_[i]);
+            std::printf(" %llu\n", static_cast<unsigned long long>(octaves[i]));
         }
     }
 
+    /**
+     * @brief Write the percentile distribution in HdrHistogram's .hgrm layout
+     * 
+     * One row per recorded bucket (value, cumulative percentile, count,
+     * 1/(1-percentile)), readable by the usual HdrHistogram plotters.
+     */
+    void write_percentiles(std::FILE* out, double unit_scale = 1.0) const {
+        std::fprintf(out, "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+        const auto total = static_cast<double>(count());
+        std::uint64_t seen = 0;
+        histogram_.for_each_bucket([&](std::int64_t value, std::uint64_t n) {
+            seen += n;
+            const double fraction = static_cast<double>(seen) / total;
+            const double scaled = static_cast<double>(value) / unit_scale;
+            if (seen == count()) {
+                std::fprintf(out, "%12.3f %2.12f %10llu\n", scaled, fraction,
+                             static_cast<unsigned long long>(seen));
+            } else {
+                std::fprintf(out, "%12.3f %2.12f %10llu %14.2f\n", scaled, fraction,
+                             static_cast<unsigned long long>(seen), 1.0 / (1.0 - fraction));
+            }
+        });
+        std::fprintf(out, "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean() / unit_scale, stddev() / unit_scale);
+        std::fprintf(out, "#[Max     = %12.3f, Total count    = %12zu]\n", max() / unit_scale, count());
+    }
+
 private:
-    std::int64_t bucket_width_;
-    std::array<std::size_t, BucketCount> buckets_;
-    std::size_t count_;
+    Histogram histogram_;
+    double sum_sq_ = 0.0;
 };
 
 } // namespace hft
@@ -0,0 +1,350 @@
+/**
+ * @file tsc_clock.hpp
+ * @brief Wall-clock nanoseconds from the TSC: fast_now()
+ *
+ * now() goes through the system clock (vDSO, ~20 ns, more under a
+ * hypervisor). fast_now() reads the TSC instead and converts it to epoch
+ * nanoseconds with one multiply-shift:
+ *
+ *   ns = ns_base + ((tsc - tsc_base) * mult) >> shift
+ *
+ * The (tsc_base, ns_base, mult, shift) tuple lives in a SeqLock. refresh()
+ * re-anchors it against the system clock: small offsets are slewed out over
+ * the next interval so fast_now() never steps backwards, large ones (clock
+ * set) are stepped. The rate comes from the whole span since start-up, so
+ * it gets more accurate the longer the process runs.
+ *
+ * instance() starts a background refresher along with the calibration, so
+ * every process using fast_now() stays within the refresh error of now().
+ * start_refresher() moves it (e.g. onto a housekeeping core) and
+ * stop_refresher() opts out for a process that calls refresh() itself.
+ *
+ * The TSC is only used when the CPU reports an invariant TSC and reads on
+ * every allowed core are consistent (validate_cross_core()); otherwise
+ * fast_now() is just now(). Values are interchangeable with now(), to
+ * within the refresh error, so the two may be mixed in one difference.
+ *
+ * Calibrate explicitly at startup: call TscClock::instance() before any
+ * thread pins itself. The first call calibrates and runs the cross-core
+ * check over the calling thread's affinity, so a lazy first fast_now() on
+ * a pinned worker would check one core only and stall that worker's first
+ * event. Each app's main() and the engines' start() make this call, and
+ * the refresher thread it starts keeps the unpinned affinity.
+ *
+ * BasicTscClock<Source> takes the counter and system clock from Source;
+ * tests drive one with a fake source, everything else uses TscClock.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <cpuid.h>
+#endif
+
+#include "busy_poll.hpp"
+#include "cpu_affinity.hpp"
+#include "seqlock.hpp"
+#include "timing.hpp"
+#include "types.hpp"
+
+namespace hft {
+
+struct TscCrossCoreCheck {
+    bool ok = true;
+    int cores_checked = 0;
+    std::int64_t max_backwards_ticks = 0;  // Worst causally later read that was smaller
+};
+
+/**
+ * @brief Whether the CPU reports an invariant (constant, non-stop) TSC
+ */
+[[nodiscard]] inline bool has_invariant_tsc() noexcept {
+    #if defined(__x86_64__) || defined(_M_X64)
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8));
+    #elif defined(__aarch64__)
+        return true;    // The generic timer counts at a fixed rate
+    #else
+        return false;
+    #endif
+}
+
+/**
+ * @brief Check that the TSC moves forward across a hop between cores
+ *
+ * Ping-pongs a TSC reading between the first core and each other core:
+ * a core reading the TSC after seeing another core's reading must never
+ * get a smaller value. Runs on its own pinned threads.
+ */
+inline TscCrossCoreCheck validate_tsc_cross_core(const std::vector<int>& cores, int rounds = 1000) {
+    TscCrossCoreCheck result;
+    if (cores.empty()) return result;
+    result.cores_checked = 1;
+
+    for (std::size_t c = 1; c < cores.size(); ++c) {
+        std::atomic<std::uint64_t> stamp{0};
+        std::atomic<int> turn{0};
+        std::atomic<bool> pinned[2] = {false, false};
+        std::int64_t backwards[2] = {0, 0};
+
+        // Side 0 moves on even turns, side 1 on odd ones
+        auto side = [&](int self, int cpu) {
+            pinned[self].store(set_cpu_affinity(cpu), std::memory_order_release);
+            for (int i = 0; i < rounds; ++i) {
+                const int my_turn = 2 * i + self;
+                for (int spins = 0; turn.load(std::memory_order_acquire) != my_turn; ++spins) {
+                    if (spins < 1000) {
+                        cpu_pause();
+                    } else {
+                        std::this_thread::yield();   // Peer not running (shared core)
+                    }
+                }
+                const std::uint64_t seen = stamp.load(std::memory_order_relaxed);
+                const std::uint64_t mine = rdtscp();
+                if (my_turn > 0 && mine < seen) {
+                    backwards[self] = std::max(backwards[self], static_cast<std::int64_t>(seen - mine));
+                }
+                stamp.store(mine, std::memory_order_relaxed);
+                turn.store(my_turn + 1, std::memory_order_release);
+            }
+        };
+        std::thread reference(side, 0, cores[0]);
+        std::thread other(side, 1, cores[c]);
+        reference.join();
+        other.join();
+
+        if (!pinned[0].load() || !pinned[1].load()) continue;
+        ++result.cores_checked;
+        result.max_backwards_ticks = std::max({result.max_backwards_ticks, backwards[0], backwards[1]});
+    }
+    result.ok = result.max_backwards_ticks == 0;
+    return result;
+}
+
+/**
+ * @brief The CPU's TSC and the system clock
+ */
+struct HardwareTsc {
+    static std::uint64_t read() noexcept { return rdtsc(); }
+    static std::uint64_t read_ordered() noexcept { return rdtscp(); }
+    static Timestamp system_now() noexcept { return hft::now(); }
+    static double ticks_per_second() { return HighPrecisionTimer::instance().frequency(); }
+    static bool invariant() noexcept { return has_invariant_tsc(); }
+    static TscCrossCoreCheck cross_core() { return validate_tsc_cross_core(get_cpu_affinity()); }
+};
+
+template<typename Source = HardwareTsc>
+class BasicTscClock {
+public:
+    static constexpr std::uint32_t SHIFT = 32;
+    static constexpr auto DEFAULT_REFRESH = std::chrono::milliseconds(100);
+    static constexpr Duration MAX_SLEW_NS = 1'000'000;     // Step beyond 1 ms
+    static constexpr double MAX_SLEW_RATE = 500e-6;        // 500 ppm
+
+    using CrossCoreCheck = TscCrossCoreCheck;
+
+    struct Params {
+        std::uint64_t tsc_base;
+        Timestamp ns_base;
+        std::uint64_t mult;         // ns per tick << SHIFT
+        std::uint32_t shift;
+    };
+
+    enum class Refresh : std::uint8_t {
+        MANUAL,         // The owner calls refresh()
+        BACKGROUND      // start_refresher() on construction
+    };
+
+    /**
+     * @brief The process clock; the first call calibrates and starts the
+     *        refresher (see file comment)
+     */
+    static BasicTscClock& instance() {
+        static BasicTscClock clock(Refresh::BACKGROUND);
+        return clock;
+    }
+
+    /**
+     * @brief A clock of its own; fast_now() and the engines use instance()
+     */
+    explicit BasicTscClock(Refresh mode = Refresh::MANUAL)
+        : invariant_tsc_(Source::invariant())
+        , cross_core_(invariant_tsc_ ? Source::cross_core() : CrossCoreCheck{false, 0, 0})
+        , tsc_usable_(invariant_tsc_ && cross_core_.ok) {
+        if (!tsc_usable_) return;
+        const auto [tsc, real] = sample();
+        first_tsc_ = tsc;
+        first_ns_ = real;
+        params_.store(make_params(tsc, real, 1e9 / Source::ticks_per_second()));
+        if (mode == Refresh::BACKGROUND) {
+            start_refresher();
+        }
+    }
+
+    /**
+     * @brief Current time as epoch nanoseconds
+     */
+    [[nodiscard]] Timestamp now() const noexcept {
+        if (!tsc_usable_) [[unlikely]] {
+            return Source::system_now();
+        }
+        Params p;
+        params_.load(p);
+        return to_ns(p, Source::read());
+    }
+
+    /**
+     * @brief Re-anchor against the system clock
+     *
+     * Calls are serialized, so an explicit refresh() may run alongside the
+     * refresher thread.
+     *
+     * @param converge_over Time over which a small offset is slewed out
+     */
+    void refresh(std::chrono::nanoseconds converge_over = DEFAULT_REFRESH) noexcept {
+        if (!tsc_usable_) return;
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+        const auto [tsc, real] = sample();
+        const Params current = params_.load();
+        const Timestamp clock_now = to_ns(current, tsc);
+        const Duration offset = real - clock_now;    // > 0: running behind
+
+        const double rate = tsc > first_tsc_
+            ? static_cast<double>(real - first_ns_) / static_cast<double>(tsc - first_tsc_)
+            : ns_per_tick(current);
+        if (offset > MAX_SLEW_NS || offset < -MAX_SLEW_NS || converge_over.count() <= 0) {
+            params_.store(make_params(tsc, real, rate));
+            steps_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Reach the system clock by the end of the interval, continuous from here
+        const double interval_ns = static_cast<double>(converge_over.count());
+        const double slewed = rate * (interval_ns + static_cast<double>(offset)) / interval_ns;
+        params_.store(make_params(tsc, clock_now,
+            std::clamp(slewed, rate * (1.0 - MAX_SLEW_RATE), rate * (1.0 + MAX_SLEW_RATE))));
+    }
+
+    /**
+     * @brief Refresh from a background thread every interval
+     *
+     * Restarts a running refresher with the new interval and core.
+     *
+     * @param cpu_core Core to pin the refresher to, or -1
+     */
+    void start_refresher(std::chrono::nanoseconds interval = DEFAULT_REFRESH, int cpu_core = -1) {
+        if (!tsc_usable_) return;
+        stop_refresher();
+        refreshing_ = true;
+        refresher_ = std::thread([this, interval, cpu_core] {
+            if (cpu_core >= 0) {
+                set_cpu_affinity(cpu_core);
+            }
+            std::unique_lock<std::mutex> lock(refresher_mutex_);
+            while (!refresher_wake_.wait_for(lock, interval, [this] { return !refreshing_; })) {
+                lock.unlock();
+                refresh(interval);
+                lock.lock();
+            }
+        });
+    }
+
+    /**
+     * @brief Stop the refresher; returns at once rather than after an interval
+     */
+    void stop_refresher() {
+        {
+            std::lock_guard<std::mutex> lock(refresher_mutex_);
+            refreshing_ = false;
+        }
+        refresher_wake_.notify_all();
+        if (refresher_.joinable()) {
+            refresher_.join();
+        }
+    }
+
+    [[nodiscard]] bool refresher_running() const noexcept { return refresher_.joinable(); }
+    [[nodiscard]] bool tsc_usable() const noexcept { return tsc_usable_; }
+    [[nodiscard]] bool invariant_tsc() const noexcept { return invariant_tsc_; }
+    [[nodiscard]] const CrossCoreCheck& cross_core_check() const noexcept { return cross_core_; }
+    [[nodiscard]] Params params() const noexcept { return params_.load(); }
+    [[nodiscard]] std::uint64_t steps() const noexcept { return steps_.load(std::memory_order_relaxed); }
+
+    ~BasicTscClock() { stop_refresher(); }
+
+    // Non-copyable
+    BasicTscClock(const BasicTscClock&) = delete;
+    BasicTscClock& operator=(const BasicTscClock&) = delete;
+
+private:
+    static Timestamp to_ns(const Params& p, std::uint64_t tsc) noexcept {
+        __extension__ using wide = __int128;
+        const auto delta = static_cast<std::int64_t>(tsc - p.tsc_base);
+        return p.ns_base + static_cast<Timestamp>((static_cast<wide>(delta) * static_cast<wide>(p.mult)) >> p.shift);
+    }
+
+    static double ns_per_tick(const Params& p) noexcept {
+        return static_cast<double>(p.mult) / static_cast<double>(std::uint64_t{1} << p.shift);
+    }
+
+    static Params make_params(std::uint64_t tsc, Timestamp ns, double ns_per_tick) noexcept {
+        return {tsc, ns, static_cast<std::uint64_t>(ns_per_tick * static_cast<double>(std::uint64_t{1} << SHIFT)), SHIFT};
+    }
+
+    struct Sample {
+        std::uint64_t tsc;
+        Timestamp ns;
+    };
+
+    // System clock reading paired with the TSC at its midpoint (tightest of a few tries)
+    static Sample sample() noexcept {
+        Sample best{};
+        std::uint64_t best_window = UINT64_MAX;
+        for (int i = 0; i < 16; ++i) {
+            const std::uint64_t before = Source::read_ordered();
+            const Timestamp real = Source::system_now();
+            const std::uint64_t after = Source::read_ordered();
+            if (after - before < best_window) {
+                best_window = after - before;
+                best = {before + (after - before) / 2, real};
+            }
+        }
+        return best;
+    }
+
+    const bool invariant_tsc_;
+    const CrossCoreCheck cross_core_;
+    const bool tsc_usable_;
+    SeqLock<Params> params_;
+
+    // Under refresh_mutex_
+    std::mutex refresh_mutex_;
+    std::uint64_t first_tsc_ = 0;
+    Timestamp first_ns_ = 0;
+    std::atomic<std::uint64_t> steps_{0};
+
+    std::thread refresher_;
+    std::mutex refresher_mutex_;
+    std::condition_variable refresher_wake_;
+    bool refreshing_ = false;               // Under refresher_mutex_
+};
+
+using TscClock = BasicTscClock<>;
+
+/**
+ * @brief Epoch nanoseconds from the TSC (now() where the TSC is unusable)
+ */
+[[nodiscard]] inline Timestamp fast_now() noexcept {
+    return TscClock::instance().now();
+}
+
+} // namespace hft
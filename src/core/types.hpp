@@ -42,8 +42,10 @@ using OrderId = std::uint64_t;
 using Price = std::int64_t;      // Fixed-point: actual_price * 1e8
 using Quantity = std::int64_t;
 using Symbol = std::array<char, 16>;  // Padded for cache alignment
+using InstrumentId = std::uint32_t;   // Dense per-engine instrument handle
 
 constexpr OrderId INVALID_ORDER_ID = 0;
+constexpr InstrumentId INVALID_INSTRUMENT_ID = std::numeric_limits<InstrumentId>::max();
 constexpr Price INVALID_PRICE = std::numeric_limits<Price>::min();
 
 // Price conversion utilities (8 decimal places precision)
@@ -84,7 +86,8 @@ enum class OrderType : std::uint8_t {
     STOP_LIMIT = 2,
     IMMEDIATE_OR_CANCEL = 3,
     FILL_OR_KILL = 4,
-    POST_ONLY = 5
+    POST_ONLY = 5,
+    STOP = 6                // Stop-market
 };
 
 [[nodiscard]] constexpr std::string_view to_string(OrderType type) noexcept {
@@ -95,6 +98,7 @@ enum class OrderType : std::uint8_t {
         case OrderType::IMMEDIATE_OR_CANCEL: return "IOC";
         case OrderType::FILL_OR_KILL: return "FOK";
         case OrderType::POST_ONLY: return "POST_ONLY";
+        case OrderType::STOP: return "STOP";
     }
     return "UNKNOWN";
 }
@@ -180,6 +184,19 @@ inline std::string_view symbol_view(const Symbol& sym) noexcept {
     return std::string_view(sym.data());
 }
 
+/**
+ * @brief Hash a Symbol in place (two 8-byte loads, no string construction)
+ */
+struct SymbolHash {
+    [[nodiscard]] std::size_t operator()(const Symbol& sym) const noexcept {
+        std::uint64_t lo;
+        std::uint64_t hi;
+        std::memcpy(&lo, sym.data(), sizeof(lo));
+        std::memcpy(&hi, sym.data() + sizeof(lo), sizeof(hi));
+        return static_cast<std::size_t>((lo ^ (hi * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL);
+    }
+};
+
 // ============================================================================
 // Cache Line Alignment Helpers
 // ============================================================================
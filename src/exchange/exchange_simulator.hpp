@@ -10,24 +10,38 @@
  *   tick-to-trade = t_order_recv - t_gen  (primary metric)
  * 
  * Supports both embedded mode (queue-based) and external mode (socket-based).
+ * 
+ * Embedded mode takes orders from several clients (strategies), each with
+ * its own SPSC lane, drained round robin at most drain_quota orders per lane
+ * per pass, so one busy client cannot starve the others. With match_orders
+ * the orders go into an embedded MatchingEngine and the acks carry fills,
+ * partial fills and fills of resting orders; otherwise every order is
+ * accepted. An optional latency model delays each order's arrival by a wire
+ * delay (plus jitter) and holds each ack for a minimum processing time.
  */
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <thread>
 #include <vector>
 #include <functional>
-#include <mutex>
 #include <iostream>
-#include <algorithm>
-#include <numeric>
-#include <cmath>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
 
 #include "core/types.hpp"
 #include "core/timing.hpp"
+#include "core/tsc_clock.hpp"
+#include "core/busy_poll.hpp"
+#include "core/seqlock.hpp"
 #include "core/lockfree_queue.hpp"
 #include "core/cpu_affinity.hpp"
+#include "matching/matching_engine.hpp"
 
 namespace hft {
 
@@ -48,111 +62,164 @@ struct ExchangeOrder {
 
 /**
  * @brief Order acknowledgment from exchange
+ * 
+ * One per order received, plus (passive = true) one per fill of an order
+ * already resting, sent to that order's client.
  */
 struct OrderAck {
     uint64_t order_id;
     Timestamp t_order_recv;     // When exchange received the order
-    Timestamp t_ack_sent;       // When acknowledgment was sent
+    Timestamp t_ack_sent;       // When acknowledgment was sent (>= t_order_recv + processing_ns)
     bool accepted;
     OrderId exchange_order_id;
+    
+    // Without match_orders: NEW, nothing filled, everything left
+    uint32_t client = 0;
+    OrderStatus status = OrderStatus::NEW;
+    bool passive = false;           // A resting order filled by someone else's order
+    Quantity filled_quantity = 0;   // Filled by this event
+    Quantity leaves_quantity = 0;   // Still open (resting) after it
+    Price fill_price = 0;           // Price of the last fill
+    Timestamp t_ack_arrival = 0;    // t_ack_sent plus the return wire delay
+};
+
+inline constexpr std::size_t MAX_EXCHANGE_CLIENTS = 16;
+
+/**
+ * @brief Simulated wire and exchange processing latency
+ */
+struct ExchangeLatencyModel {
+    Duration wire_ns = 0;           // One way, strategy <-> exchange
+    Duration wire_jitter_ns = 0;    // Uniform [0, jitter) added per message
+    Duration processing_ns = 0;     // Minimum receipt-to-ack time, applied to t_ack_sent
+    
+    [[nodiscard]] bool enabled() const noexcept {
+        return wire_ns > 0 || wire_jitter_ns > 0 || processing_ns > 0;
+    }
+};
+
+struct ExchangeConfig {
+    bool match_orders = false;      // Match in an embedded MatchingEngine (false: accept all)
+    OrderBookConfig book{};         // Book for a symbol first seen in an order
+    ExchangeLatencyModel latency{};
+    std::size_t drain_quota = 64;   // Orders taken from one lane per round-robin pass
 };
 
 /**
  * @brief Latency statistics for tick-to-trade measurement
+ * 
+ * Written by the exchange thread only; readers get copies published
+ * through a SeqLock (see ExchangeSimulator::stats), so recording never
+ * takes a lock or allocates (LatencyStats is a fixed-size histogram).
  */
 struct TickToTradeStats {
-    std::vector<int64_t> tick_to_order_latencies;   // t_order_recv - t_gen
-    std::vector<int64_t> strategy_latencies;        // t_strategy_done - t_gen
-    std::vector<int64_t> order_transit_latencies;   // t_order_recv - t_strategy_done
+    LatencyStats tick_to_order;     // t_order_recv - t_gen
+    LatencyStats strategy;          // t_strategy_done - t_gen
+    LatencyStats order_transit;     // t_order_recv - t_strategy_done
     
-    std::atomic<uint64_t> orders_received{0};
-    std::atomic<uint64_t> orders_accepted{0};
-    std::atomic<uint64_t> orders_rejected{0};
+    uint64_t orders_received = 0;
+    uint64_t orders_accepted = 0;
+    uint64_t orders_rejected = 0;
     
-    int64_t min_tick_to_order = INT64_MAX;
-    int64_t max_tick_to_order = 0;
+    // match_orders only
+    uint64_t orders_filled = 0;             // Filled completely on arrival
+    uint64_t orders_partially_filled = 0;   // Some fills on arrival, rest resting or cancelled
+    uint64_t passive_fills = 0;             // Fills of resting orders
+    Quantity filled_volume = 0;
     
-    void record(const ExchangeOrder& order, Timestamp t_order_recv) {
-        int64_t tick_to_order = t_order_recv - order.t_gen;
-        int64_t strategy_time = order.t_strategy_done - order.t_gen;
-        int64_t order_transit = t_order_recv - order.t_strategy_done;
-        
-        tick_to_order_latencies.push_back(tick_to_order);
-        strategy_latencies.push_back(strategy_time);
-        order_transit_latencies.push_back(order_transit);
-        
-        if (tick_to_order < min_tick_to_order) min_tick_to_order = tick_to_order;
-        if (tick_to_order > max_tick_to_order) max_tick_to_order = tick_to_order;
-        
-        orders_received.fetch_add(1, std::memory_order_relaxed);
+    std::array<uint64_t, MAX_EXCHANGE_CLIENTS> orders_by_client{};
+    
+    void record(const ExchangeOrder& order, Timestamp t_order_recv, uint32_t client = 0) noexcept {
+        tick_to_order.add_sample(t_order_recv - order.t_gen);
+        strategy.add_sample(order.t_strategy_done - order.t_gen);
+        order_transit.add_sample(t_order_recv - order.t_strategy_done);
+        ++orders_received;
+        ++orders_by_client[client];
     }
     
     void print_report() const {
-        if (tick_to_order_latencies.empty()) {
+        if (tick_to_order.empty()) {
             std::cout << "No orders received.\n";
             return;
         }
         
-        // Calculate statistics
-        auto sorted_tto = tick_to_order_latencies;
-        auto sorted_strat = strategy_latencies;
-        auto sorted_transit = order_transit_latencies;
-        
-        std::sort(sorted_tto.begin(), sorted_tto.end());
-        std::sort(sorted_strat.begin(), sorted_strat.end());
-        std::sort(sorted_transit.begin(), sorted_transit.end());
-        
-        auto percentile = [](const std::vector<int64_t>& v, double p) {
-            size_t idx = static_cast<size_t>(v.size() * p);
-            return v[std::min(idx, v.size() - 1)];
-        };
-        
-        auto average = [](const std::vector<int64_t>& v) {
-            if (v.empty()) return 0.0;
-            return std::accumulate(v.begin(), v.end(), 0.0) / v.size();
+        auto percentile = [](const LatencyStats& h, double p) {
+            return static_cast<int64_t>(h.percentile(p));
         };
+        const auto min_ns = static_cast<int64_t>(tick_to_order.min());
+        const auto max_ns = static_cast<int64_t>(tick_to_order.max());
         
         std::cout << "\n╔══════════════════════════════════════════════════════════════╗\n";
         std::cout << "║              EXCHANGE SIMULATOR STATISTICS                    ║\n";
         std::cout << "╚══════════════════════════════════════════════════════════════╝\n\n";
         
         std::cout << "--- Orders ---\n";
-        std::cout << "  Received:  " << orders_received.load() << "\n";
-        std::cout << "  Accepted:  " << orders_accepted.load() << "\n";
-        std::cout << "  Rejected:  " << orders_rejected.load() << "\n\n";
+        std::cout << "  Received:  " << orders_received << "\n";
+        std::cout << "  Accepted:  " << orders_accepted << "\n";
+        std::cout << "  Rejected:  " << orders_rejected << "\n";
+        if (filled_volume > 0 || passive_fills > 0) {
+            std::cout << "  Filled:    " << orders_filled << " on arrival, "
+                      << orders_partially_filled << " partially, "
+                      << passive_fills << " resting-order fills, volume " << filled_volume << "\n";
+        }
+        if (orders_by_client[0] != orders_received) {
+            std::cout << "  By client:";
+            for (std::size_t c = 0; c < orders_by_client.size(); ++c) {
+                if (orders_by_client[c] > 0) std::cout << " " << c << "=" << orders_by_client[c];
+            }
+            std::cout << "\n";
+        }
+        std::cout << "\n";
         
         std::cout << "--- Tick-to-Trade Latency (t_order_recv - t_gen) ---\n";
         std::cout << "  This is the PRIMARY METRIC: time from tick generation to order receipt\n";
-        std::cout << "  Min:     " << sorted_tto.front() << " ns (" << sorted_tto.front() / 1000.0 << " µs)\n";
-        std::cout << "  Max:     " << sorted_tto.back() << " ns (" << sorted_tto.back() / 1000.0 << " µs)\n";
-        std::cout << "  Average: " << average(sorted_tto) << " ns\n";
-        std::cout << "  Median:  " << percentile(sorted_tto, 0.50) << " ns\n";
-        std::cout << "  P90:     " << percentile(sorted_tto, 0.90) << " ns\n";
-        std::cout << "  P99:     " << percentile(sorted_tto, 0.99) << " ns\n";
-        std::cout << "  P99.9:   " << percentile(sorted_tto, 0.999) << " ns\n\n";
+        std::cout << "  Min:     " << min_ns << " ns (" << min_ns / 1000.0 << " µs)\n";
+        std::cout << "  Max:     " << max_ns << " ns (" << max_ns / 1000.0 << " µs)\n";
+        std::cout << "  Average: " << tick_to_order.mean() << " ns\n";
+        std::cout << "  Median:  " << percentile(tick_to_order, 50.0) << " ns\n";
+        std::cout << "  P90:     " << percentile(tick_to_order, 90.0) << " ns\n";
+        std::cout << "  P99:     " << percentile(tick_to_order, 99.0) << " ns\n";
+        std::cout << "  P99.9:   " << percentile(tick_to_order, 99.9) << " ns\n\n";
         
         std::cout << "--- Latency Breakdown ---\n";
         std::cout << "  Strategy time (t_strategy_done - t_gen):\n";
-        std::cout << "    Median: " << percentile(sorted_strat, 0.50) << " ns\n";
-        std::cout << "    P99:    " << percentile(sorted_strat, 0.99) << " ns\n";
+        std::cout << "    Median: " << percentile(strategy, 50.0) << " ns\n";
+        std::cout << "    P99:    " << percentile(strategy, 99.0) << " ns\n";
         std::cout << "  Order transit (t_order_recv - t_strategy_done):\n";
-        std::cout << "    Median: " << percentile(sorted_transit, 0.50) << " ns\n";
-        std::cout << "    P99:    " << percentile(sorted_transit, 0.99) << " ns\n";
+        std::cout << "    Median: " << percentile(order_transit, 50.0) << " ns\n";
+        std::cout << "    P99:    " << percentile(order_transit, 99.0) << " ns\n";
     }
 };
 
+static_assert(std::is_trivially_copyable_v<TickToTradeStats>, "Published through a SeqLock");
+
 /**
  * @brief Exchange Simulator - receives orders and measures tick-to-trade latency
  * 
  * Can operate in two modes:
- * 1. Embedded mode: Receives orders via lock-free queue
+ * 1. Embedded mode: Receives orders via lock-free queues, one per client
  * 2. External mode: Receives orders via socket (IPC or network)
+ * 
+ * Each client's lane has a single producer: one strategy thread per client.
  */
 class ExchangeSimulator {
 public:
     using AckCallback = std::function<void(const OrderAck&)>;
+    using ClientId = uint32_t;
+    using Lane = SPSCQueue<ExchangeOrder, 65536>;
+    
+    static constexpr std::size_t MAX_CLIENTS = MAX_EXCHANGE_CLIENTS;
+    static constexpr std::size_t MAX_DRAIN_QUOTA = 256;
+    
+    ExchangeSimulator() : ExchangeSimulator(ExchangeConfig{}) {}
+    
+    explicit ExchangeSimulator(const ExchangeConfig& config)
+        : config_(config)
+        , drain_quota_(std::clamp<std::size_t>(config.drain_quota, 1, MAX_DRAIN_QUOTA))
+    {
+        clients_.push_back(std::make_unique<Client>());
+    }
     
-    ExchangeSimulator() = default;
     ~ExchangeSimulator() { stop(); }
     
     // Non-copyable
@@ -161,19 +228,74 @@ public:
     
     /**
      * @brief Set callback for order acknowledgments
+     * 
+     * Receives the acks of every client registered without its own callback.
+     * Called on the exchange thread.
      */
     void set_ack_callback(AckCallback callback) {
         ack_callback_ = std::move(callback);
     }
     
+    /**
+     * @brief Register another client with its own lane (before start())
+     * 
+     * Client 0 always exists; it is the lane submit_order(order) and
+     * order_queue() use.
+     * 
+     * @param on_ack This client's acks, on the exchange thread (empty: the
+     *               set_ack_callback() one)
+     * @return Client id, or nullopt once started or with MAX_CLIENTS registered
+     */
+    std::optional<ClientId> add_client(AckCallback on_ack = {}) {
+        if (exchange_thread_.joinable() || clients_.size() >= MAX_CLIENTS) {
+            return std::nullopt;
+        }
+        clients_.push_back(std::make_unique<Client>());
+        clients_.back()->on_ack = std::move(on_ack);
+        return static_cast<ClientId>(clients_.size() - 1);
+    }
+    
+    [[nodiscard]] std::size_t client_count() const noexcept { return clients_.size(); }
+    
+    /**
+     * @brief Add a book with its own config (match_orders; before start())
+     * 
+     * Symbols not added here get a book with ExchangeConfig::book on their
+     * first order.
+     * @return false if the symbol already has a book
+     */
+    bool add_instrument(const Symbol& symbol, const OrderBookConfig& config) {
+        return engine_.add_instrument(symbol, config).has_value();
+    }
+    
+    /**
+     * @brief The embedded engine, for inspecting books once stopped
+     */
+    [[nodiscard]] const MatchingEngine& engine() const noexcept { return engine_; }
+    
+    /**
+     * @brief How the exchange thread idles between orders (before start())
+     * 
+     * Overrides start()'s use_polling; an ADAPTIVE or RELAXED mode here is
+     * how a caller opts into parking the exchange thread.
+     */
+    void set_idle_config(const IdleStrategy::Config& config) {
+        idle_config_ = config;
+        idle_configured_ = true;
+    }
+    
     /**
      * @brief Start the exchange simulator thread
      * @param cpu_core CPU core to pin to (-1 for no pinning)
-     * @param use_polling Whether to use busy-wait polling
+     * @param use_polling Busy-wait polling (BALANCED: never parks) or RELAXED
+     *        idling, unless set_idle_config() chose the mode
      */
     void start(int cpu_core = -1, bool use_polling = true) {
+        TscClock::instance();   // Calibrate before the exchange thread pins itself
         running_ = true;
-        use_polling_ = use_polling;
+        if (!idle_configured_) {
+            idle_config_.mode = use_polling ? PollMode::BALANCED : PollMode::RELAXED;
+        }
         
         exchange_thread_ = std::thread([this, cpu_core]() {
             #ifdef __linux__
@@ -188,9 +310,13 @@ public:
     
     /**
      * @brief Stop the exchange simulator
+     * 
+     * Orders already queued are processed first (under a latency model,
+     * once they have arrived).
      */
     void stop() {
         running_ = false;
+        wake_.notify();
         if (exchange_thread_.joinable()) {
             exchange_thread_.join();
         }
@@ -203,100 +329,342 @@ public:
      * The caller should set t_gen and t_strategy_done before calling.
      */
     bool submit_order(const ExchangeOrder& order) {
-        return order_queue_.try_push(order);
+        return submit_order(0, order);
     }
     
     /**
-     * @brief Get the order queue for direct access (advanced use)
+     * @brief Submit on a client's lane (that client's producer thread only)
+     * 
+     * @return false if the lane is full or the client does not exist
      */
-    SPSCQueue<ExchangeOrder, 65536>& order_queue() {
-        return order_queue_;
+    bool submit_order(ClientId client, const ExchangeOrder& order) {
+        if (client >= clients_.size() || !clients_[client]->lane.try_push(order)) return false;
+        wake_.notify();
+        return true;
     }
     
     /**
-     * @brief Get statistics
+     * @brief Get a client's order queue for direct access (advanced use)
+     * 
+     * Pushes here do not wake a parked exchange thread; it notices them
+     * within the idle config's max_wake_latency.
      */
-    const TickToTradeStats& stats() const {
-        return stats_;
+    Lane& order_queue(ClientId client = 0) {
+        return clients_[client]->lane;
+    }
+    
+    /**
+     * @brief Copy of the statistics, never blocking the exchange thread
+     * 
+     * While the thread runs this is its latest published snapshot (at most
+     * PUBLISH_INTERVAL_NS or PUBLISH_EVERY orders old); once stopped, or in
+     * synchronous use, it is exact. Call from the thread that starts and
+     * stops the simulator.
+     */
+    TickToTradeStats stats() const {
+        TickToTradeStats copy;
+        if (exchange_thread_.joinable()) {
+            published_->load(copy);
+        } else {
+            copy = *stats_;
+        }
+        return copy;
+    }
+    
+    /**
+     * @brief Orders received so far (cheap; for progress output)
+     */
+    uint64_t orders_received() const noexcept {
+        return orders_received_.load(std::memory_order_relaxed);
     }
     
     /**
      * @brief Print statistics report
      */
     void print_stats() const {
-        stats_.print_report();
+        stats().print_report();
     }
     
     /**
      * @brief Process an order immediately (for single-threaded testing)
      * 
-     * Returns the tick-to-trade latency.
+     * Bypasses the lanes and the wire delay; the processing time still
+     * applies. Returns the tick-to-trade latency.
      */
-    int64_t process_order_sync(const ExchangeOrder& order) {
-        Timestamp t_order_recv = now();
-        return process_order_internal(order, t_order_recv);
+    int64_t process_order_sync(const ExchangeOrder& order, ClientId client = 0) {
+        Timestamp t_order_recv = fast_now();
+        return process_order_internal(client < clients_.size() ? client : 0, order, t_order_recv);
     }
 
 private:
+    // Who owns a resting order; its slot index is the engine's client_id
+    struct RestingOwner {
+        ClientId client;
+        uint64_t order_id;
+    };
+    
+    struct Client {
+        Lane lane;
+        AckCallback on_ack;
+        Timestamp head_due = 0;     // Arrival of lane.front() under the latency model (0: not drawn)
+        Timestamp last_due = 0;     // Arrivals keep send order
+    };
+    
     void run_loop() {
-        while (running_.load(std::memory_order_relaxed) || !order_queue_.empty()) {
-            auto order = order_queue_.try_pop();
-            if (order) {
-                // CRITICAL: Record t_order_recv immediately upon dequeue
-                Timestamp t_order_recv = now();
-                process_order_internal(*order, t_order_recv);
-            } else if (use_polling_) {
-                // Busy-wait polling for lowest latency
-                #if defined(__x86_64__) || defined(_M_X64)
-                    __builtin_ia32_pause();
-                #elif defined(__aarch64__)
-                    asm volatile("yield" ::: "memory");
-                #endif
+        IdleStrategy idle(idle_config_, &wake_);
+        last_publish_ = fast_now();
+        while (running_.load(std::memory_order_relaxed) || !lanes_empty()) {
+            // One pass over every lane, starting one further along each time
+            bool in_flight = false;
+            std::size_t drained = 0;
+            const std::size_t lanes = clients_.size();
+            for (std::size_t i = 0; i < lanes; ++i) {
+                const std::size_t client = next_lane_ + i < lanes ? next_lane_ + i : next_lane_ + i - lanes;
+                drained += drain_lane(static_cast<ClientId>(client), in_flight);
+            }
+            next_lane_ = next_lane_ + 1 < lanes ? next_lane_ + 1 : 0;
+            
+            if (drained > 0) {
+                if (unpublished_ >= PUBLISH_EVERY) {
+                    publish();
+                }
+                idle.reset();
+                continue;
+            }
+            
+            // Idle: refresh the readers' snapshot now and then
+            if (unpublished_ > 0 && fast_now() - last_publish_ >= PUBLISH_INTERVAL_NS) {
+                publish();
+            }
+            if (in_flight) {
+                cpu_pause();            // Queued, still on the wire: don't park
             } else {
-                std::this_thread::yield();
+                idle.idle(0, [this] { return !running_.load(std::memory_order_relaxed) || !lanes_empty(); });
             }
         }
+        publish();
     }
     
-    int64_t process_order_internal(const ExchangeOrder& order, Timestamp t_order_recv) {
-        // Record tick-to-trade latency
-        int64_t tick_to_trade = t_order_recv - order.t_gen;
+    [[nodiscard]] bool lanes_empty() const noexcept {
+        return std::all_of(clients_.begin(), clients_.end(),
+                           [](const auto& client) { return client->lane.empty(); });
+    }
+    
+    /**
+     * @brief Process up to drain_quota_ arrived orders from one lane
+     * 
+     * @param in_flight Set when an order is queued but has not arrived yet
+     */
+    std::size_t drain_lane(ClientId client, bool& in_flight) {
+        Client& c = *clients_[client];
+        if (!config_.latency.enabled()) {
+            const std::size_t n = c.lane.try_pop_bulk(std::span<ExchangeOrder>(batch_.data(), drain_quota_));
+            for (std::size_t i = 0; i < n; ++i) {
+                // CRITICAL: Record t_order_recv immediately upon dequeue
+                process_order_internal(client, batch_[i], fast_now());
+            }
+            return n;
+        }
         
-        {
-            std::lock_guard<std::mutex> lock(stats_mutex_);
-            stats_.record(order, t_order_recv);
+        std::size_t n = 0;
+        while (n < drain_quota_) {
+            const ExchangeOrder* head = c.lane.front();
+            if (!head) break;
+            if (c.head_due == 0) {
+                c.head_due = std::max(head->t_strategy_done + wire_delay(), c.last_due);
+            }
+            const Timestamp t_order_recv = fast_now();
+            if (t_order_recv < c.head_due) {
+                in_flight = true;
+                break;
+            }
+            const ExchangeOrder order = *c.lane.try_pop();
+            c.last_due = c.head_due;
+            c.head_due = 0;
+            process_order_internal(client, order, t_order_recv);
+            ++n;
         }
+        return n;
+    }
+    
+    void publish() noexcept {
+        published_->store(*stats_);
+        unpublished_ = 0;
+        last_publish_ = fast_now();
+    }
+    
+    int64_t process_order_internal(ClientId client, const ExchangeOrder& order, Timestamp t_order_recv) {
+        // Record tick-to-trade latency
+        int64_t tick_to_trade = t_order_recv - order.t_gen;
         
-        // Simulate order acceptance (could add rejection logic here)
-        bool accepted = true;  // Simplified: always accept
-        stats_.orders_accepted.fetch_add(1, std::memory_order_relaxed);
+        // Owner thread only: no lock, no allocation
+        stats_->record(order, t_order_recv, client);
+        ++unpublished_;
+        orders_received_.store(stats_->orders_received, std::memory_order_relaxed);
         
-        // Send acknowledgment if callback is set
-        if (ack_callback_) {
-            OrderAck ack;
-            ack.order_id = order.order_id;
-            ack.t_order_recv = t_order_recv;
-            ack.t_ack_sent = now();
-            ack.accepted = accepted;
+        OrderAck ack;
+        ack.order_id = order.order_id;
+        ack.client = client;
+        ack.t_order_recv = t_order_recv;
+        if (config_.match_orders) {
+            match_order(client, order, ack);
+        } else {
+            ack.accepted = true;
             ack.exchange_order_id = next_exchange_order_id_++;
-            
-            ack_callback_(ack);
+            ack.leaves_quantity = order.quantity;
+        }
+        if (ack.accepted) {
+            ++stats_->orders_accepted;
+        } else {
+            ++stats_->orders_rejected;
         }
         
+        // Send acknowledgment if callback is set
+        send_ack(ack);
+        
         return tick_to_trade;
     }
+    
+    /**
+     * @brief Match one order, filling in its ack and acking resting orders it fills
+     */
+    void match_order(ClientId client, const ExchangeOrder& order, OrderAck& ack) {
+        auto instrument = engine_.find_instrument(order.symbol);
+        if (!instrument) {
+            instrument = engine_.add_instrument(order.symbol, config_.book);
+        }
+        
+        // The aggressor's reports carry the exchange id it is about to get;
+        // everything else is a resting order, found through its owner slot
+        const OrderId expected = engine_.next_order_id();
+        const uint64_t slot = acquire_owner(client, order.order_id);
+        ack.leaves_quantity = order.quantity;
+        auto sink = [&](const ExecutionReport& report) {
+            if (report.order_id == expected) {
+                switch (report.exec_type) {
+                    case ExecutionType::TRADE:
+                        ack.filled_quantity += report.execution_quantity;
+                        ack.fill_price = report.execution_price;
+                        [[fallthrough]];
+                    case ExecutionType::NEW:
+                    case ExecutionType::CANCELLED:      // IOC / FOK remainder
+                        ack.status = report.order_status;
+                        ack.leaves_quantity = report.leaves_quantity;
+                        break;
+                    default:
+                        break;
+                }
+            } else if (report.exec_type == ExecutionType::TRADE) {
+                passive_fill(report, ack.t_order_recv);
+            }
+        };
+        const OrderId id = engine_.submit_order(*instrument, order.side, order.type,
+                                                order.price, order.quantity, slot, sink);
+        ack.accepted = id != INVALID_ORDER_ID;
+        ack.exchange_order_id = id;
+        const bool resting = ack.accepted && (ack.status == OrderStatus::NEW ||
+                                              ack.status == OrderStatus::PARTIALLY_FILLED);
+        if (!resting) {
+            free_owners_.push_back(slot);
+        }
+        if (!ack.accepted) {
+            ack.status = OrderStatus::REJECTED;
+            ack.leaves_quantity = 0;
+            return;
+        }
+        if (ack.filled_quantity > 0) {
+            stats_->filled_volume += ack.filled_quantity;
+            if (ack.status == OrderStatus::FILLED) {
+                ++stats_->orders_filled;
+            } else {
+                ++stats_->orders_partially_filled;
+            }
+        }
+    }
+    
+    void passive_fill(const ExecutionReport& report, Timestamp t_order_recv) {
+        ++stats_->passive_fills;
+        OrderAck fill;
+        const RestingOwner& owner = owners_[report.client_id];
+        fill.order_id = owner.order_id;
+        fill.client = owner.client;
+        fill.t_order_recv = t_order_recv;
+        fill.accepted = true;
+        fill.exchange_order_id = report.order_id;
+        fill.status = report.order_status;
+        fill.passive = true;
+        fill.filled_quantity = report.execution_quantity;
+        fill.leaves_quantity = report.leaves_quantity;
+        fill.fill_price = report.execution_price;
+        if (report.leaves_quantity == 0) {
+            free_owners_.push_back(report.client_id);
+        }
+        send_ack(fill);
+    }
+    
+    uint64_t acquire_owner(ClientId client, uint64_t order_id) {
+        if (free_owners_.empty()) {
+            owners_.push_back({client, order_id});
+            return owners_.size() - 1;
+        }
+        const uint64_t slot = free_owners_.back();
+        free_owners_.pop_back();
+        owners_[slot] = {client, order_id};
+        return slot;
+    }
+    
+    void send_ack(OrderAck& ack) {
+        const AckCallback* callback = ack.client < clients_.size() && clients_[ack.client]->on_ack
+            ? &clients_[ack.client]->on_ack
+            : &ack_callback_;
+        if (!*callback) return;
+        // Processing time is stamped, not spent: the matcher never stalls, so
+        // one order's processing does not queue every other lane behind it
+        ack.t_ack_sent = std::max(fast_now(), ack.t_order_recv + config_.latency.processing_ns);
+        ack.t_ack_arrival = ack.t_ack_sent + (config_.latency.enabled() ? wire_delay() : 0);
+        (*callback)(ack);
+    }
+    
+    Duration wire_delay() noexcept {
+        Duration delay = config_.latency.wire_ns;
+        if (config_.latency.wire_jitter_ns > 0) {
+            // xorshift64: cheap, and the exchange thread owns it
+            jitter_state_ ^= jitter_state_ << 13;
+            jitter_state_ ^= jitter_state_ >> 7;
+            jitter_state_ ^= jitter_state_ << 17;
+            delay += static_cast<Duration>(jitter_state_ % static_cast<uint64_t>(config_.latency.wire_jitter_ns));
+        }
+        return delay;
+    }
 
-    SPSCQueue<ExchangeOrder, 65536> order_queue_;
+    ExchangeConfig config_;
+    std::size_t drain_quota_;
+    std::vector<std::unique_ptr<Client>> clients_;      // Index = ClientId; fixed once started
+    std::size_t next_lane_ = 0;
+    std::array<ExchangeOrder, MAX_DRAIN_QUOTA> batch_;
     std::atomic<bool> running_{false};
-    bool use_polling_ = true;
+    IdleStrategy::Config idle_config_ = IdleStrategy::config_for(PollMode::BALANCED);
+    bool idle_configured_ = false;
+    WakeSignal wake_;
     std::thread exchange_thread_;
     
     AckCallback ack_callback_;
+    MatchingEngine engine_;
     
-    mutable std::mutex stats_mutex_;
-    TickToTradeStats stats_;
+    // Live stats (exchange thread) and the copy readers see
+    static constexpr uint64_t PUBLISH_EVERY = 65536;
+    static constexpr Duration PUBLISH_INTERVAL_NS = 1'000'000;
+    std::unique_ptr<TickToTradeStats> stats_ = std::make_unique<TickToTradeStats>();
+    std::unique_ptr<SeqLock<TickToTradeStats>> published_ = std::make_unique<SeqLock<TickToTradeStats>>();
+    uint64_t unpublished_ = 0;
+    Timestamp last_publish_ = 0;
+    std::atomic<uint64_t> orders_received_{0};
     
-    std::atomic<uint64_t> next_exchange_order_id_{1};
+    // Exchange thread only
+    std::vector<RestingOwner> owners_;      // Index = engine client_id of a resting order
+    std::vector<uint64_t> free_owners_;
+    OrderId next_exchange_order_id_ = 1;
+    uint64_t jitter_state_ = 0x9E3779B97F4A7C15ULL;
 };
 
 /**
@@ -4,11 +4,46 @@
  */
 
 #include "market_data_handler.hpp"
-#include "matching/order_book.hpp"
+#include "l2_book.hpp"
+#include <algorithm>
 
 namespace hft {
 
-// Book building utilities for reconstructing order books from market data
+void L2Book::reset(std::span<const Level> bids, std::span<const Level> asks, std::uint64_t sequence) {
+    bids_.assign(bids.begin(), bids.end());
+    asks_.assign(asks.begin(), asks.end());
+    sequence_ = sequence;
+}
 
-} // namespace hft
+L2Book::ApplyResult L2Book::apply(const BookDelta& delta) {
+    if (delta.sequence <= sequence_) {
+        return ApplyResult::STALE;
+    }
+    if (delta.sequence != sequence_ + 1) {
+        return ApplyResult::GAP;
+    }
+    sequence_ = delta.sequence;
+
+    // Bids are kept descending, asks ascending, so index 0 is always best
+    auto& levels = delta.side == Side::BUY ? bids_ : asks_;
+    const bool descending = delta.side == Side::BUY;
+    auto it = std::lower_bound(levels.begin(), levels.end(), delta.price,
+        [descending](const Level& level, Price price) {
+            return descending ? level.price > price : level.price < price;
+        });
+    const bool found = it != levels.end() && it->price == delta.price;
 
+    if (delta.quantity == 0) {
+        if (found) {
+            levels.erase(it);
+        }
+    } else if (found) {
+        it->quantity = delta.quantity;
+        it->order_count = delta.order_count;
+    } else {
+        levels.insert(it, Level{delta.price, delta.quantity, delta.order_count});
+    }
+    return ApplyResult::APPLIED;
+}
+
+} // namespace hft
@@ -0,0 +1,241 @@
+/**
+ * @file consolidated_book.cpp
+ * @brief Multi-venue consolidated book implementation
+ */
+
+#include "consolidated_book.hpp"
+#include "core/cpu_affinity.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace hft {
+
+namespace {
+
+// Move venue to its place in a best-first ranking, or out of it
+template<typename Better>
+void rerank(std::array<ConsolidatedBook::VenueId, ConsolidatedBook::MAX_VENUES>& rank,
+            std::uint8_t& count, ConsolidatedBook::VenueId venue, bool present, Better better) {
+    auto end = rank.begin() + count;
+    auto it = std::find(rank.begin(), end, venue);
+    if (it != end) {
+        std::copy(it + 1, end, it);
+        --count;
+        --end;
+    }
+    if (!present) return;
+    // After venues at the same price: the earlier quote keeps its place
+    auto pos = std::find_if(rank.begin(), end, [&](ConsolidatedBook::VenueId other) {
+        return better(venue, other);
+    });
+    std::copy_backward(pos, end, end + 1);
+    *pos = venue;
+    ++count;
+}
+
+} // namespace
+
+MarketDataUpdate to_update(const MarketDataPacket& packet) noexcept {
+    Symbol symbol{};
+    std::memcpy(symbol.data(), packet.symbol, std::min(sizeof(packet.symbol), symbol.size()));
+    return MarketDataUpdate::make_quote(symbol, packet.bid_price, packet.bid_size,
+                                        packet.ask_price, packet.ask_size, packet.timestamp);
+}
+
+ConsolidatedBook::ConsolidatedBook(const IdleStrategy::Config& idle)
+    : idle_config_(idle)
+    , states_(make_in_region<std::array<SymbolState, MAX_SYMBOLS>>(default_memory_policy()))
+    , views_(make_in_region<std::array<SeqLock<View>, MAX_SYMBOLS>>(default_memory_policy())) {
+    lanes_.reserve(MAX_VENUES);
+    symbol_ids_.reserve(MAX_SYMBOLS);
+}
+
+ConsolidatedBook::~ConsolidatedBook() {
+    stop();
+}
+
+ConsolidatedBook::VenueId ConsolidatedBook::add_venue(std::string_view name) {
+    if (lanes_.size() >= MAX_VENUES) return INVALID_VENUE;
+    auto venue = std::make_unique<Venue>();
+    venue->name = std::string(name);
+    venue->lane = make_in_region<Lane>(default_memory_policy());
+    lanes_.push_back(std::move(venue));
+    return static_cast<VenueId>(lanes_.size() - 1);
+}
+
+InstrumentId ConsolidatedBook::subscribe(const Symbol& symbol) {
+    auto it = symbol_ids_.find(symbol);
+    if (it != symbol_ids_.end()) return it->second;
+    if (symbol_ids_.size() >= MAX_SYMBOLS) return INVALID_INSTRUMENT_ID;
+    return symbol_ids_.emplace(symbol, static_cast<InstrumentId>(symbol_ids_.size())).first->second;
+}
+
+std::optional<InstrumentId> ConsolidatedBook::find_symbol(const Symbol& symbol) const {
+    auto it = symbol_ids_.find(symbol);
+    if (it == symbol_ids_.end()) return std::nullopt;
+    return it->second;
+}
+
+void ConsolidatedBook::attach(VenueId venue, WebSocketFeedClient& client, int cpu_core) {
+    client.set_callback([this, venue](const MarketDataUpdate& update) {
+        push(venue, update);
+    });
+    lanes_[venue]->poll_feed = [&client] { client.poll(); };
+    lanes_[venue]->cpu_core = cpu_core;
+}
+
+void ConsolidatedBook::attach(VenueId venue, UDPMulticastReceiver& receiver, int cpu_core) {
+    lanes_[venue]->poll_feed = [this, venue, &receiver] {
+        for (const auto& packet : receiver.try_receive_batch()) {
+            push(venue, to_update(packet));
+        }
+    };
+    lanes_[venue]->cpu_core = cpu_core;
+}
+
+bool ConsolidatedBook::push(VenueId venue, const MarketDataUpdate& update) noexcept {
+    Venue& v = *lanes_[venue];
+    ++v.pushed;
+    if (!v.lane->try_push(update)) {
+        v.dropped.store(v.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return false;
+    }
+    wake_.notify();
+    return true;
+}
+
+std::size_t ConsolidatedBook::poll() {
+    std::size_t applied = 0;
+    for (std::size_t v = 0; v < lanes_.size(); ++v) {
+        applied += lanes_[v]->lane->consume_all([this, v](const MarketDataUpdate& update) {
+            apply(static_cast<VenueId>(v), update);
+        });
+    }
+    if (applied > 0) {
+        applied_.store(applied_.load(std::memory_order_relaxed) + applied, std::memory_order_relaxed);
+    }
+    return applied;
+}
+
+void ConsolidatedBook::start(int consolidator_cpu) {
+    if (running_.exchange(true, std::memory_order_acq_rel)) return;
+    for (auto& venue : lanes_) {
+        if (!venue->poll_feed) continue;
+        venue->thread = std::thread([this, v = venue.get()] {
+            if (v->cpu_core >= 0) {
+                set_cpu_affinity(v->cpu_core);
+            }
+            IdleStrategy idle(idle_config_);
+            while (running_.load(std::memory_order_acquire)) {
+                const std::uint64_t before = v->pushed;
+                v->poll_feed();
+                idle.idle(v->pushed - before);
+            }
+        });
+    }
+    consolidator_ = std::thread([this, consolidator_cpu] {
+        if (consolidator_cpu >= 0) {
+            set_cpu_affinity(consolidator_cpu);
+        }
+        IdleStrategy idle(idle_config_, &wake_);
+        auto pending = [this] {
+            if (!running_.load(std::memory_order_relaxed)) return true;
+            return std::any_of(lanes_.begin(), lanes_.end(), [](const auto& v) { return !v->lane->empty(); });
+        };
+        while (running_.load(std::memory_order_acquire)) {
+            idle.idle(poll(), pending);
+        }
+    });
+}
+
+void ConsolidatedBook::stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+    wake_.notify();
+    for (auto& venue : lanes_) {
+        if (venue->thread.joinable()) {
+            venue->thread.join();
+        }
+    }
+    if (consolidator_.joinable()) {
+        consolidator_.join();
+    }
+    poll();
+}
+
+void ConsolidatedBook::apply(VenueId venue, const MarketDataUpdate& update) {
+    auto it = symbol_ids_.find(update.symbol);
+    if (it == symbol_ids_.end()) return;
+    const InstrumentId id = it->second;
+
+    if (update.type == MarketDataType::TRADE) {
+        for (auto& channel : channels_) {
+            channel->publish(id, update);
+        }
+        return;
+    }
+    if (update.type != MarketDataType::QUOTE_UPDATE) return;
+
+    SymbolState& state = (*states_)[id];
+    VenueTop& top = state.venues[venue];
+    top.bid_price = update.data.quote.bid_price;
+    top.bid_quantity = update.data.quote.bid_quantity;
+    top.ask_price = update.data.quote.ask_price;
+    top.ask_quantity = update.data.quote.ask_quantity;
+
+    rerank(state.bid_rank, state.bid_count, venue, top.bid_quantity > 0,
+           [&state](VenueId a, VenueId b) { return state.venues[a].bid_price > state.venues[b].bid_price; });
+    rerank(state.ask_rank, state.ask_count, venue, top.ask_quantity > 0,
+           [&state](VenueId a, VenueId b) { return state.venues[a].ask_price < state.venues[b].ask_price; });
+
+    publish(id, state, update.symbol, update.timestamp);
+}
+
+void ConsolidatedBook::publish(InstrumentId id, SymbolState& state, const Symbol& symbol,
+                               Timestamp timestamp) {
+    View view{};
+    view.timestamp = timestamp;
+
+    // Venues are ranked best first, so equal prices are adjacent
+    auto merge = [&state](const auto& rank, std::uint8_t count, auto price_of, auto quantity_of,
+                          std::array<Level, DEPTH>& levels) {
+        std::uint8_t n = 0;
+        for (std::uint8_t i = 0; i < count; ++i) {
+            const VenueTop& top = state.venues[rank[i]];
+            const Price price = price_of(top);
+            if (n > 0 && levels[n - 1].price == price) {
+                levels[n - 1].quantity += quantity_of(top);
+                levels[n - 1].venues |= 1u << rank[i];
+            } else if (n < DEPTH) {
+                levels[n++] = Level{price, quantity_of(top), 1u << rank[i]};
+            } else {
+                break;
+            }
+        }
+        return n;
+    };
+    view.bid_levels = merge(state.bid_rank, state.bid_count,
+                            [](const VenueTop& t) { return t.bid_price; },
+                            [](const VenueTop& t) { return t.bid_quantity; }, view.bids);
+    view.ask_levels = merge(state.ask_rank, state.ask_count,
+                            [](const VenueTop& t) { return t.ask_price; },
+                            [](const VenueTop& t) { return t.ask_quantity; }, view.asks);
+    (*views_)[id].store(view);
+
+    if (channels_.empty()) return;
+    const Level best_bid = view.bid_levels ? view.bids[0] : Level{};
+    const Level best_ask = view.ask_levels ? view.asks[0] : Level{};
+    if (best_bid.price == state.best_bid.price && best_bid.quantity == state.best_bid.quantity &&
+        best_ask.price == state.best_ask.price && best_ask.quantity == state.best_ask.quantity) {
+        return;
+    }
+    state.best_bid = best_bid;
+    state.best_ask = best_ask;
+
+    const auto nbbo = MarketDataUpdate::make_quote(symbol, best_bid.price, best_bid.quantity,
+                                                   best_ask.price, best_ask.quantity, timestamp);
+    for (auto& channel : channels_) {
+        channel->publish(id, nbbo);
+    }
+}
+
+} // namespace hft
@@ -0,0 +1,211 @@
+/**
+ * @file consolidated_book.hpp
+ * @brief Multi-venue consolidated book: per-venue tops, merged NBBO / top-N
+ *
+ * Each venue feed (WebSocketFeedClient, UDPMulticastReceiver) runs on its
+ * own pinned thread and pushes updates into its own SPSC lane. One
+ * consolidator thread drains the lanes and is the single writer of every
+ * symbol: it keeps each venue's top of book plus a per-side ranking of the
+ * venues, moves only the updated venue within that ranking, and re-derives
+ * the merged top-DEPTH levels from it (O(venues), no sort, no allocation).
+ *
+ * The merged View for a symbol sits in a SeqLock slot that any strategy
+ * thread reads lock-free, so strategies no longer merge venues per tick.
+ * Subscribers that want to be woken add a MarketDataChannel: it gets the
+ * NBBO as a quote whenever the best bid or ask changes, and every trade.
+ *
+ * More symbols than one consolidator keeps up with: run several books over
+ * disjoint symbol sets.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "core/busy_poll.hpp"
+#include "core/lockfree_queue.hpp"
+#include "core/memory_region.hpp"
+#include "core/seqlock.hpp"
+#include "core/types.hpp"
+#include "market_data_handler.hpp"
+#include "transport/udp_multicast.hpp"
+
+namespace hft {
+
+/**
+ * @brief Quote update from a multicast top-of-book packet
+ */
+[[nodiscard]] MarketDataUpdate to_update(const MarketDataPacket& packet) noexcept;
+
+class ConsolidatedBook {
+public:
+    using VenueId = std::uint8_t;
+
+    static constexpr std::size_t MAX_VENUES = 8;
+    static constexpr std::size_t DEPTH = 4;             // Merged levels per side
+    static constexpr std::size_t MAX_SYMBOLS = 1024;
+    static constexpr std::size_t LANE_SIZE = 16384;
+    static constexpr VenueId INVALID_VENUE = 0xFF;
+
+    struct Level {
+        Price price;
+        Quantity quantity;          // Summed over the venues at this price
+        std::uint32_t venues;       // Bit per VenueId quoting this price
+    };
+
+    struct View {
+        std::array<Level, DEPTH> bids;      // Best first
+        std::array<Level, DEPTH> asks;
+        std::uint8_t bid_levels;
+        std::uint8_t ask_levels;
+        Timestamp timestamp;                // Of the venue update that produced it
+
+        [[nodiscard]] bool has_nbbo() const noexcept { return bid_levels > 0 && ask_levels > 0; }
+    };
+
+    explicit ConsolidatedBook(const IdleStrategy::Config& idle = {});
+    ~ConsolidatedBook();
+
+    // Non-copyable
+    ConsolidatedBook(const ConsolidatedBook&) = delete;
+    ConsolidatedBook& operator=(const ConsolidatedBook&) = delete;
+
+    /**
+     * @brief Add a venue and its lane (setup only)
+     * @return INVALID_VENUE if MAX_VENUES are already added
+     */
+    VenueId add_venue(std::string_view name);
+
+    /**
+     * @brief Intern a symbol to consolidate (setup only)
+     * @return INVALID_INSTRUMENT_ID if MAX_SYMBOLS are already interned
+     */
+    InstrumentId subscribe(const Symbol& symbol);
+
+    /**
+     * @brief Add a subscriber for NBBO changes and trades (setup only)
+     */
+    MarketDataChannel& add_channel(MarketDataChannel::Mode mode) {
+        channels_.push_back(std::make_unique<MarketDataChannel>(mode));
+        return *channels_.back();
+    }
+
+    /**
+     * @brief Feed a venue from a WebSocket client polled on its own thread
+     *
+     * Setup only; the thread starts with start(). Takes over the client's
+     * callback.
+     */
+    void attach(VenueId venue, WebSocketFeedClient& client, int cpu_core = -1);
+
+    /**
+     * @brief Feed a venue from a multicast receiver polled on its own thread
+     */
+    void attach(VenueId venue, UDPMulticastReceiver& receiver, int cpu_core = -1);
+
+    /**
+     * @brief Push one venue update into its lane (that venue's thread only)
+     * @return false if the lane is full (counted in dropped())
+     */
+    bool push(VenueId venue, const MarketDataUpdate& update) noexcept;
+
+    /**
+     * @brief Drain every lane into the book (consolidator thread only)
+     * @return Updates applied
+     */
+    std::size_t poll();
+
+    /**
+     * @brief Start the attached venue threads and a consolidator thread
+     *
+     * Without start(), call poll() from a thread of your own.
+     */
+    void start(int consolidator_cpu = -1);
+
+    /**
+     * @brief Stop all threads and apply what is left in the lanes
+     */
+    void stop();
+
+    /**
+     * @brief Copy out the merged book; false until a venue has quoted
+     *
+     * Any thread; retries only while the consolidator is mid-write on
+     * this symbol.
+     */
+    [[nodiscard]] bool read(InstrumentId id, View& out) const noexcept {
+        if (id >= MAX_SYMBOLS) return false;
+        const auto& slot = (*views_)[id];
+        if (slot.version() == 0) return false;
+        slot.load(out);
+        return true;
+    }
+
+    [[nodiscard]] std::optional<InstrumentId> find_symbol(const Symbol& symbol) const;
+
+    [[nodiscard]] std::size_t venue_count() const noexcept { return lanes_.size(); }
+    [[nodiscard]] const std::string& venue_name(VenueId venue) const { return lanes_[venue]->name; }
+    [[nodiscard]] std::uint64_t dropped(VenueId venue) const noexcept {
+        return lanes_[venue]->dropped.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::uint64_t updates_applied() const noexcept {
+        return applied_.load(std::memory_order_relaxed);
+    }
+
+private:
+    using Lane = SPSCQueue<MarketDataUpdate, LANE_SIZE>;
+
+    struct Venue {
+        std::string name;
+        RegionPtr<Lane> lane;
+        std::atomic<std::uint64_t> dropped{0};
+        std::function<void()> poll_feed;        // One non-blocking poll of the feed
+        int cpu_core = -1;
+        std::thread thread;
+        std::uint64_t pushed = 0;               // Venue thread only
+    };
+
+    struct VenueTop {
+        Price bid_price = 0;
+        Quantity bid_quantity = 0;      // 0: no bid from this venue
+        Price ask_price = 0;
+        Quantity ask_quantity = 0;
+    };
+
+    // Consolidator only
+    struct SymbolState {
+        std::array<VenueTop, MAX_VENUES> venues{};
+        std::array<VenueId, MAX_VENUES> bid_rank{};     // Venues with a bid, best first
+        std::array<VenueId, MAX_VENUES> ask_rank{};
+        std::uint8_t bid_count = 0;
+        std::uint8_t ask_count = 0;
+        Level best_bid{};                               // Last NBBO sent to channels
+        Level best_ask{};
+    };
+
+    void apply(VenueId venue, const MarketDataUpdate& update);
+    void publish(InstrumentId id, SymbolState& state, const Symbol& symbol, Timestamp timestamp);
+
+    IdleStrategy::Config idle_config_;          // Venue and consolidator threads
+    std::vector<std::unique_ptr<Venue>> lanes_;
+    std::unordered_map<Symbol, InstrumentId, SymbolHash> symbol_ids_;
+    RegionPtr<std::array<SymbolState, MAX_SYMBOLS>> states_;
+    RegionPtr<std::array<SeqLock<View>, MAX_SYMBOLS>> views_;
+    std::vector<std::unique_ptr<MarketDataChannel>> channels_;
+
+    WakeSignal wake_;                           // Consolidator parks on it
+    std::atomic<bool> running_{false};
+    std::thread consolidator_;
+    std::atomic<std::uint64_t> applied_{0};
+};
+
+} // namespace hft
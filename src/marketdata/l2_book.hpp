@@ -0,0 +1,58 @@
+/**
+ * @file l2_book.hpp
+ * @brief Price-level book rebuilt from a depth snapshot plus BookDeltas
+ *
+ * The consumer side of OrderBook's delta ring (or of LevelUpdate
+ * datagrams): seed it with reset() from a snapshot taken at a known
+ * delta_sequence(), then apply() every later delta in order. A gap means
+ * deltas were lost; the book keeps its last good state and the caller
+ * resyncs from a fresh snapshot.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "core/types.hpp"
+#include "matching/book_delta.hpp"
+#include "matching/order_book.hpp"
+
+namespace hft {
+
+class L2Book {
+public:
+    using Level = OrderBook::Level;
+
+    enum class ApplyResult : std::uint8_t {
+        APPLIED,
+        STALE,      // Already covered by the snapshot or an earlier delta
+        GAP         // Deltas missing; resync before applying more
+    };
+
+    /**
+     * @brief Replace the book with a snapshot (levels best first)
+     * @param sequence delta_sequence() at the time of the snapshot
+     */
+    void reset(std::span<const Level> bids, std::span<const Level> asks, std::uint64_t sequence);
+
+    /**
+     * @brief Apply the next delta
+     */
+    ApplyResult apply(const BookDelta& delta);
+
+    /**
+     * @brief Levels of each side, best first
+     */
+    [[nodiscard]] std::span<const Level> bids() const noexcept { return bids_; }
+    [[nodiscard]] std::span<const Level> asks() const noexcept { return asks_; }
+
+    [[nodiscard]] std::uint64_t sequence() const noexcept { return sequence_; }
+
+private:
+    std::vector<Level> bids_;
+    std::vector<Level> asks_;
+    std::uint64_t sequence_ = 0;
+};
+
+} // namespace hft
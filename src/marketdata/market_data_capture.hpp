@@ -0,0 +1,249 @@
+/**
+ * @file market_data_capture.hpp
+ * @brief Capture market data and order flow; replay it deterministically
+ *
+ * Capture: each packet, tick or order is turned into an 80-byte
+ * CaptureRecord stamped with its receive (or send) time and pushed through
+ * an AsyncBinaryLog, so the capturing thread only pays for a ring push.
+ *
+ * Replay: CaptureReplay maps the file read-only and hands out pointers
+ * into the mapping (no copy, no parse) at the recorded pacing, N times
+ * faster, or as fast as the consumer takes them. Pacing is measured from
+ * the first record, so a run is the same sequence with the same gaps every
+ * time; late() counts records released behind schedule, i.e. where the
+ * consumer rather than the recording set the pace.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/async_binary_log.hpp"
+#include "core/busy_poll.hpp"
+#include "core/tsc_clock.hpp"
+#include "core/types.hpp"
+#include "strategy/user_strategy.hpp"
+#include "transport/udp_multicast.hpp"
+
+namespace hft {
+
+enum class CaptureKind : std::uint8_t {
+    PACKET = 0,     // MarketDataPacket off the wire
+    TICK = 1,       // Tick handed to a strategy
+    ORDER = 2       // Order sent
+};
+
+/**
+ * @brief One captured event (80 bytes)
+ *
+ * Orders reuse the quote fields: bid_price = price, bid_size = quantity.
+ */
+struct CaptureRecord {
+    Timestamp recv_time;        // Receive stamp (orders: send stamp), epoch ns
+    Timestamp source_time;      // Timestamp carried by the message (0 if none)
+    std::uint64_t sequence;     // Feed sequence / order ID
+    Symbol symbol;
+    Price bid_price;
+    Price ask_price;
+    Price last_price;
+    std::uint32_t bid_size;     // Sizes saturate at 2^32 - 1
+    std::uint32_t ask_size;
+    std::uint32_t last_size;
+    CaptureKind kind;
+    Side side;
+    OrderType order_type;
+    std::uint8_t flags;         // MarketDataPacket::flags (low byte)
+};
+static_assert(sizeof(CaptureRecord) == 80, "Capture record layout changed");
+
+using MarketDataCapture = AsyncBinaryLog<CaptureRecord>;
+
+namespace detail {
+inline std::uint32_t capture_size(std::int64_t size) noexcept {
+    return static_cast<std::uint32_t>(std::clamp<std::int64_t>(size, 0, UINT32_MAX));
+}
+} // namespace detail
+
+[[nodiscard]] inline CaptureRecord capture_packet(const MarketDataPacket& packet, Timestamp recv_time) noexcept {
+    CaptureRecord record{};
+    record.recv_time = recv_time;
+    record.source_time = packet.timestamp;
+    record.sequence = packet.sequence;
+    std::memcpy(record.symbol.data(), packet.symbol, std::min(sizeof(packet.symbol), record.symbol.size()));
+    record.bid_price = packet.bid_price;
+    record.ask_price = packet.ask_price;
+    record.last_price = packet.last_price;
+    record.bid_size = detail::capture_size(packet.bid_size);
+    record.ask_size = detail::capture_size(packet.ask_size);
+    record.last_size = detail::capture_size(packet.last_size);
+    record.kind = CaptureKind::PACKET;
+    record.flags = static_cast<std::uint8_t>(packet.flags);
+    return record;
+}
+
+[[nodiscard]] inline CaptureRecord capture_tick(const Tick& tick, Timestamp recv_time) noexcept {
+    CaptureRecord record{};
+    record.recv_time = recv_time;
+    record.source_time = tick.timestamp;
+    record.sequence = tick.sequence;
+    record.symbol = tick.symbol;
+    record.bid_price = tick.bid_price;
+    record.ask_price = tick.ask_price;
+    record.last_price = tick.last_price;
+    record.bid_size = detail::capture_size(tick.bid_size);
+    record.ask_size = detail::capture_size(tick.ask_size);
+    record.last_size = detail::capture_size(tick.last_size);
+    record.kind = CaptureKind::TICK;
+    return record;
+}
+
+[[nodiscard]] inline CaptureRecord capture_order(std::uint64_t order_id, const Symbol& symbol, Side side,
+                                                 OrderType type, Price price, Quantity quantity,
+                                                 Timestamp sent_time) noexcept {
+    CaptureRecord record{};
+    record.recv_time = sent_time;
+    record.sequence = order_id;
+    record.symbol = symbol;
+    record.bid_price = price;
+    record.bid_size = detail::capture_size(quantity);
+    record.kind = CaptureKind::ORDER;
+    record.side = side;
+    record.order_type = type;
+    return record;
+}
+
+/**
+ * @brief Quote view of a PACKET or TICK record (timestamp = recv_time)
+ */
+[[nodiscard]] inline Tick to_tick(const CaptureRecord& record) noexcept {
+    Tick tick;
+    tick.symbol = record.symbol;
+    tick.bid_price = record.bid_price;
+    tick.ask_price = record.ask_price;
+    tick.bid_size = record.bid_size;
+    tick.ask_size = record.ask_size;
+    tick.last_price = record.last_price;
+    tick.last_size = record.last_size;
+    tick.timestamp = record.recv_time;
+    tick.sequence = record.sequence;
+    return tick;
+}
+
+/**
+ * @brief Pull-style, paced reader over a mapped capture file
+ */
+class CaptureReplay {
+public:
+    // Released this far behind schedule counts as late
+    static constexpr Duration LATE_THRESHOLD_NS = 1000;
+
+    bool open(const std::string& path) {
+        return view_.open(path);
+    }
+
+    /**
+     * @brief Rewind and anchor the schedule at the current time
+     *
+     * @param speed 1 = recorded pacing, N = N times faster, 0 = no pacing
+     */
+    void start(double speed = 1.0) noexcept {
+        speed_ = std::max(speed, 0.0);
+        position_ = 0;
+        late_ = 0;
+        max_lag_ns_ = 0;
+        const auto records = view_.records();
+        first_time_ = records.empty() ? 0 : records.front().recv_time;
+        start_time_ = fast_now();
+    }
+
+    /**
+     * @brief Next record of any of the given kinds, once it is due
+     *
+     * Returns a pointer into the mapping (valid while open), or nullptr at
+     * the end of the file. Records of other kinds are skipped unpaced.
+     */
+    [[nodiscard]] const CaptureRecord* next(std::initializer_list<CaptureKind> kinds) noexcept {
+        const auto records = view_.records();
+        while (position_ < records.size()) {
+            const CaptureRecord& record = records[position_++];
+            if (std::find(kinds.begin(), kinds.end(), record.kind) == kinds.end()) continue;
+            wait_until_due(record);
+            return &record;
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] const CaptureRecord* next() noexcept {
+        return next({CaptureKind::PACKET, CaptureKind::TICK, CaptureKind::ORDER});
+    }
+
+    [[nodiscard]] bool is_open() const noexcept { return view_.is_open(); }
+    [[nodiscard]] std::span<const CaptureRecord> records() const noexcept { return view_.records(); }
+    [[nodiscard]] std::size_t size() const noexcept { return view_.size(); }
+    [[nodiscard]] std::size_t position() const noexcept { return position_; }
+    [[nodiscard]] double speed() const noexcept { return speed_; }
+    [[nodiscard]] std::uint64_t late() const noexcept { return late_; }
+    [[nodiscard]] Duration max_lag_ns() const noexcept { return max_lag_ns_; }
+    
+    /**
+     * @brief When the last returned record was due (its open-loop send time)
+     */
+    [[nodiscard]] Timestamp due_time() const noexcept { return due_; }
+
+    /**
+     * @brief Distinct symbols in the file, in first-seen order (setup only)
+     */
+    [[nodiscard]] std::vector<Symbol> symbols() const {
+        std::vector<Symbol> result;
+        for (const auto& record : view_.records()) {
+            if (std::find(result.begin(), result.end(), record.symbol) == result.end()) {
+                result.push_back(record.symbol);
+            }
+        }
+        return result;
+    }
+
+private:
+    void wait_until_due(const CaptureRecord& record) noexcept {
+        if (speed_ <= 0.0) {
+            due_ = fast_now();
+            return;
+        }
+        const Timestamp due = start_time_ +
+            static_cast<Duration>(static_cast<double>(record.recv_time - first_time_) / speed_);
+        due_ = due;
+        Timestamp now_ns = fast_now();
+        if (now_ns >= due) {
+            const Duration lag = now_ns - due;
+            late_ += lag > LATE_THRESHOLD_NS;
+            max_lag_ns_ = std::max(max_lag_ns_, lag);
+            return;
+        }
+        // Sleep through long gaps, spin the last stretch
+        if (due - now_ns > 200'000) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(due - now_ns - 100'000));
+        }
+        while (fast_now() < due) {
+            cpu_pause();
+        }
+    }
+
+    MappedRecordView<CaptureRecord> view_;
+    std::size_t position_ = 0;
+    double speed_ = 1.0;
+    Timestamp first_time_ = 0;
+    Timestamp start_time_ = 0;
+    std::uint64_t late_ = 0;
+    Duration max_lag_ns_ = 0;
+    Timestamp due_ = 0;
+};
+
+} // namespace hft
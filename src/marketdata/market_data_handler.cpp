@@ -7,35 +7,59 @@
 
 namespace hft {
 
-void MarketDataHandler::subscribe(const Symbol& symbol) {
-    subscriptions_[std::string(symbol_view(symbol))] = true;
+MarketDataHandler::MarketDataHandler()
+    : quotes_(make_in_region<QuoteSlots>(default_memory_policy())) {
+    symbol_ids_.reserve(MAX_SYMBOLS);
+    subscribed_.reserve(MAX_SYMBOLS);
+}
+
+InstrumentId MarketDataHandler::subscribe(const Symbol& symbol) {
+    auto it = symbol_ids_.find(symbol);
+    if (it == symbol_ids_.end()) {
+        if (symbol_ids_.size() >= MAX_SYMBOLS) return INVALID_INSTRUMENT_ID;
+        it = symbol_ids_.emplace(symbol, static_cast<InstrumentId>(symbol_ids_.size())).first;
+        subscribed_.push_back(false);
+    }
+    if (!subscribed_[it->second]) {
+        subscribed_[it->second] = true;
+        ++subscription_count_;
+    }
+    return it->second;
 }
 
 void MarketDataHandler::unsubscribe(const Symbol& symbol) {
-    subscriptions_.erase(std::string(symbol_view(symbol)));
+    auto it = symbol_ids_.find(symbol);
+    if (it != symbol_ids_.end() && subscribed_[it->second]) {
+        subscribed_[it->second] = false;
+        --subscription_count_;
+    }
 }
 
 void MarketDataHandler::on_update(const MarketDataUpdate& update) {
-    std::string sym_str(symbol_view(update.symbol));
-    
     // Check if subscribed
-    auto it = subscriptions_.find(sym_str);
-    if (it == subscriptions_.end() || !it->second) {
+    auto it = symbol_ids_.find(update.symbol);
+    if (it == symbol_ids_.end() || !subscribed_[it->second]) {
         return;
     }
     
+    for (auto& channel : channels_) {
+        channel->publish(it->second, update);
+    }
+    
     switch (update.type) {
         case MarketDataType::QUOTE_UPDATE: {
-            Quote quote;
-            quote.bid_price = update.data.quote.bid_price;
-            quote.ask_price = update.data.quote.ask_price;
-            quote.bid_quantity = update.data.quote.bid_quantity;
-            quote.ask_quantity = update.data.quote.ask_quantity;
-            quote.timestamp = update.timestamp;
-            
-            latest_quotes_[sym_str] = quote;
+            const QuoteFields fields{update.data.quote.bid_price, update.data.quote.ask_price,
+                                     update.data.quote.bid_quantity, update.data.quote.ask_quantity,
+                                     update.timestamp};
+            (*quotes_)[it->second].store(fields);
             
             if (quote_callback_) {
+                Quote quote;
+                quote.bid_price = fields.bid_price;
+                quote.ask_price = fields.ask_price;
+                quote.bid_quantity = fields.bid_quantity;
+                quote.ask_quantity = fields.ask_quantity;
+                quote.timestamp = fields.timestamp;
                 quote_callback_(update.symbol, quote);
             }
             break;
@@ -58,12 +82,16 @@ void MarketDataHandler::on_update(const MarketDataUpdate& update) {
     }
 }
 
+std::optional<InstrumentId> MarketDataHandler::find_symbol(const Symbol& symbol) const {
+    auto it = symbol_ids_.find(symbol);
+    if (it == symbol_ids_.end()) return std::nullopt;
+    return it->second;
+}
+
 std::optional<Quote> MarketDataHandler::get_quote(const Symbol& symbol) const {
-    auto it = latest_quotes_.find(std::string(symbol_view(symbol)));
-    if (it != latest_quotes_.end()) {
-        return it->second;
-    }
-    return std::nullopt;
+    auto it = symbol_ids_.find(symbol);
+    if (it == symbol_ids_.end()) return std::nullopt;
+    return get_quote(it->second);
 }
 
 // WebSocket Feed Client
@@ -71,7 +99,7 @@ WebSocketFeedClient::WebSocketFeedClient(std::string_view host, std::uint16_t po
     : host_(host), port_(port) {}
 
 bool WebSocketFeedClient::connect() {
-    handler_.on_message([this](const WebSocketFrame& frame) {
+    handler_.on_frame([this](const WebSocketFrameView& frame) {
         on_message(frame);
     });
     
@@ -96,19 +124,29 @@ void WebSocketFeedClient::poll() {
     handler_.poll();
 }
 
-void WebSocketFeedClient::on_message(const WebSocketFrame& frame) {
+void WebSocketFeedClient::on_message(const WebSocketFrameView& frame) {
     if (!callback_) return;
     
-    // Parse message and convert to MarketDataUpdate
-    auto trade = ws_json::parse_trade(frame.payload_string());
-    if (trade) {
-        MarketDataUpdate update = MarketDataUpdate::make_trade(
-            make_symbol(trade->symbol),
-            to_fixed_price(trade->price),
-            static_cast<Quantity>(trade->quantity),
-            trade->side == "BUY" ? Side::BUY : Side::SELL
-        );
-        callback_(update);
+    // Decode in place and convert to MarketDataUpdate (no strings, no doubles)
+    switch (decoder_.decode(frame.payload)) {
+        case FeedMessageType::TRADE: {
+            const auto& trade = decoder_.trade();
+            callback_(MarketDataUpdate::make_trade(trade.symbol, trade.price,
+                                                   trade.quantity, trade.side));
+            break;
+        }
+        case FeedMessageType::BOOK: {
+            // Top of book as a quote once both sides are known
+            const auto& book = decoder_.book();
+            if (book.bid_count > 0 && book.ask_count > 0) {
+                callback_(MarketDataUpdate::make_quote(book.symbol,
+                                                       book.bids[0].price, book.bids[0].quantity,
+                                                       book.asks[0].price, book.asks[0].quantity));
+            }
+            break;
+        }
+        default:
+            break;
     }
 }
 
@@ -6,6 +6,14 @@
  * - Exchange WebSocket feeds
  * - FIX market data connections
  * - Internal matching engine events
+ * 
+ * The latest quote per symbol is kept in a fixed array of one-cache-line
+ * SeqLock slots indexed by interned symbol ID: the feed thread overwrites
+ * a slot in place and any number of strategy threads read torn-free
+ * snapshots concurrently, without locks or allocation.
+ *
+ * Strategies that run on their own thread take updates through a
+ * MarketDataChannel (add_channel()), queued or conflated per subscriber.
  */
 
 #pragma once
@@ -15,8 +23,15 @@
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <array>
+#include <atomic>
+#include <bit>
 #include "core/types.hpp"
 #include "core/lockfree_queue.hpp"
+#include "core/memory_region.hpp"
+#include "core/seqlock.hpp"
+#include "protocol/json_feed_decoder.hpp"
 #include "protocol/websocket_handler.hpp"
 
 namespace hft {
@@ -56,11 +71,12 @@ struct MarketDataUpdate {
     
     static MarketDataUpdate make_quote(const Symbol& sym, 
                                         Price bid_px, Quantity bid_qty,
-                                        Price ask_px, Quantity ask_qty) {
+                                        Price ask_px, Quantity ask_qty,
+                                        Timestamp timestamp = now()) {
         MarketDataUpdate update;
         update.type = MarketDataType::QUOTE_UPDATE;
         update.symbol = sym;
-        update.timestamp = now();
+        update.timestamp = timestamp;
         update.data.quote.bid_price = bid_px;
         update.data.quote.ask_price = ask_px;
         update.data.quote.bid_quantity = bid_qty;
@@ -81,6 +97,122 @@ struct MarketDataUpdate {
     }
 };
 
+/**
+ * @brief One subscriber's feed: the feed thread publishes, one consumer polls
+ * 
+ * QUEUED delivers every update in order through an SPSC ring and drops
+ * (counted) once the consumer is a whole ring behind. CONFLATED keeps the
+ * latest quote per symbol in a SeqLock slot flagged in a dirty bitset: a
+ * quote arriving before the consumer took the previous one overwrites it
+ * in place, so a consumer that falls behind gets the current book, at most
+ * one poll() stale, instead of a growing backlog. Trades are never
+ * conflated and stay in order in the ring; a conflated quote may therefore
+ * be delivered after a trade that followed it.
+ */
+class MarketDataChannel {
+public:
+    enum class Mode : std::uint8_t {
+        QUEUED,
+        CONFLATED
+    };
+
+    static constexpr std::size_t QUEUE_SIZE = 65536;
+    static constexpr std::size_t MAX_SYMBOLS = 1024;   // Conflated by ID below this
+
+    explicit MarketDataChannel(Mode mode)
+        : mode_(mode)
+        , queue_(make_in_region<UpdateQueue>(default_memory_policy())) {
+        if (mode_ == Mode::CONFLATED) {
+            latest_ = make_in_region<LatestSlots>(default_memory_policy());
+        }
+    }
+
+    /**
+     * @brief Hand an update to the subscriber (feed thread only)
+     * 
+     * @param id Interned symbol ID; quotes for IDs >= MAX_SYMBOLS are queued
+     * @return false if the update was dropped because the ring is full
+     */
+    bool publish(InstrumentId id, const MarketDataUpdate& update) noexcept {
+        published_.store(published_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (mode_ == Mode::CONFLATED && update.type == MarketDataType::QUOTE_UPDATE && id < MAX_SYMBOLS) {
+            (*latest_)[id].store({update.timestamp, update.data.quote.bid_price, update.data.quote.ask_price,
+                                  update.data.quote.bid_quantity, update.data.quote.ask_quantity, update.symbol});
+            // Slot before bit: a consumer that clears the bit reads this value or a newer one
+            const std::uint64_t bit = std::uint64_t{1} << (id % 64);
+            if (dirty_[id / 64].fetch_or(bit, std::memory_order_release) & bit) {
+                conflated_.store(conflated_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+        if (!queue_->try_push(update)) {
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Deliver everything pending to fn(const MarketDataUpdate&) (consumer only)
+     * 
+     * Queued updates first, in order, then the latest quote of every
+     * symbol that changed since the last poll.
+     * @return Number of updates delivered
+     */
+    template<typename Fn>
+    std::size_t poll(Fn&& fn) {
+        std::size_t delivered = queue_->consume_all([&fn](const MarketDataUpdate& update) { fn(update); });
+        if (mode_ != Mode::CONFLATED) return delivered;
+
+        for (std::size_t word = 0; word < DIRTY_WORDS; ++word) {
+            if (dirty_[word].load(std::memory_order_relaxed) == 0) continue;
+            std::uint64_t bits = dirty_[word].exchange(0, std::memory_order_acquire);
+            while (bits != 0) {
+                const auto id = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                LatestQuote latest;
+                (*latest_)[id].load(latest);
+                fn(MarketDataUpdate::make_quote(latest.symbol, latest.bid_price, latest.bid_quantity,
+                                                latest.ask_price, latest.ask_quantity, latest.timestamp));
+                ++delivered;
+            }
+        }
+        return delivered;
+    }
+
+    [[nodiscard]] Mode mode() const noexcept { return mode_; }
+    [[nodiscard]] std::uint64_t published() const noexcept { return published_.load(std::memory_order_relaxed); }
+    // Quotes overwritten before the consumer saw them
+    [[nodiscard]] std::uint64_t conflated() const noexcept { return conflated_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    // 56 bytes, so sequence and value share one cache line
+    struct LatestQuote {
+        Timestamp timestamp;
+        Price bid_price;
+        Price ask_price;
+        Quantity bid_quantity;
+        Quantity ask_quantity;
+        Symbol symbol;
+    };
+    static_assert(sizeof(SeqLock<LatestQuote>) == CACHE_LINE_SIZE, "Latest quote slot should be one cache line");
+
+    using UpdateQueue = SPSCQueue<MarketDataUpdate, QUEUE_SIZE>;
+    using LatestSlots = std::array<SeqLock<LatestQuote>, MAX_SYMBOLS>;
+    static constexpr std::size_t DIRTY_WORDS = MAX_SYMBOLS / 64;
+
+    const Mode mode_;
+    RegionPtr<UpdateQueue> queue_;
+    RegionPtr<LatestSlots> latest_;             // CONFLATED only
+    alignas(CACHE_LINE_SIZE) std::array<std::atomic<std::uint64_t>, DIRTY_WORDS> dirty_{};
+
+    // Feed thread writes, anyone reads
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> published_{0};
+    std::atomic<std::uint64_t> conflated_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
 /**
  * @brief Callback types for market data
  */
@@ -90,20 +222,28 @@ using UpdateCallback = std::function<void(const MarketDataUpdate&)>;
 
 /**
  * @brief Market data handler for processing incoming data
+ * 
+ * subscribe(), unsubscribe() and on_update() belong to the feed thread;
+ * read_quote() / get_quote(InstrumentId) may be called from any thread.
  */
 class MarketDataHandler {
-    static constexpr std::size_t UPDATE_QUEUE_SIZE = 65536;
-
 public:
-    MarketDataHandler() = default;
+    static constexpr std::size_t MAX_SYMBOLS = 1024;
+    static_assert(MAX_SYMBOLS <= MarketDataChannel::MAX_SYMBOLS, "Every interned symbol should conflate");
+
+    MarketDataHandler();
 
     /**
      * @brief Subscribe to a symbol
+     * 
+     * Interns the symbol on first use. The returned ID indexes its quote
+     * slot and stays the same across unsubscribe / resubscribe.
+     * @return INVALID_INSTRUMENT_ID if MAX_SYMBOLS are already interned
      */
-    void subscribe(const Symbol& symbol);
+    InstrumentId subscribe(const Symbol& symbol);
 
     /**
-     * @brief Unsubscribe from a symbol
+     * @brief Unsubscribe from a symbol (its last quote stays readable)
      */
     void unsubscribe(const Symbol& symbol);
 
@@ -126,8 +266,57 @@ public:
         trade_callback_ = std::move(callback);
     }
 
+    /**
+     * @brief Add a subscriber that polls updates from its own thread
+     * 
+     * Setup only (before the feed thread starts). Every subscribed update
+     * is published to every channel; the reference stays valid for the
+     * handler's lifetime.
+     */
+    MarketDataChannel& add_channel(MarketDataChannel::Mode mode) {
+        channels_.push_back(std::make_unique<MarketDataChannel>(mode));
+        return *channels_.back();
+    }
+
+    /**
+     * @brief Interned ID of a symbol (resolve once, then read by ID)
+     */
+    [[nodiscard]] std::optional<InstrumentId> find_symbol(const Symbol& symbol) const;
+
+    /**
+     * @brief Copy out the latest quote; false if none has arrived yet
+     * 
+     * Lock-free and allocation-free; retries only while the feed thread
+     * is mid-write on this very slot.
+     */
+    [[nodiscard]] bool read_quote(InstrumentId id, Quote& out) const noexcept {
+        if (id >= MAX_SYMBOLS) return false;
+        const QuoteSlot& slot = (*quotes_)[id];
+        if (slot.version() == 0) return false;
+        QuoteFields fields;
+        slot.load(fields);
+        out.bid_price = fields.bid_price;
+        out.ask_price = fields.ask_price;
+        out.bid_quantity = fields.bid_quantity;
+        out.ask_quantity = fields.ask_quantity;
+        out.timestamp = fields.timestamp;
+        return true;
+    }
+
+    /**
+     * @brief Get latest quote by interned ID
+     */
+    [[nodiscard]] std::optional<Quote> get_quote(InstrumentId id) const noexcept {
+        Quote quote;
+        if (!read_quote(id, quote)) return std::nullopt;
+        return quote;
+    }
+
     /**
      * @brief Get latest quote for a symbol
+     * 
+     * Looks the symbol up in the intern table, so not concurrently with
+     * subscribe(); hot readers resolve the ID once with find_symbol().
      */
     [[nodiscard]] std::optional<Quote> get_quote(const Symbol& symbol) const;
 
@@ -135,14 +324,29 @@ public:
      * @brief Get subscription count
      */
     [[nodiscard]] std::size_t subscription_count() const {
-        return subscriptions_.size();
+        return subscription_count_;
     }
 
 private:
-    std::unordered_map<std::string, bool> subscriptions_;
-    std::unordered_map<std::string, Quote> latest_quotes_;
+    // Quote without the 64-byte alignment, so sequence and value share a line
+    struct QuoteFields {
+        Price bid_price;
+        Price ask_price;
+        Quantity bid_quantity;
+        Quantity ask_quantity;
+        Timestamp timestamp;
+    };
+    using QuoteSlot = SeqLock<QuoteFields>;
+    static_assert(sizeof(QuoteSlot) == CACHE_LINE_SIZE, "Quote slot should be one cache line");
+    using QuoteSlots = std::array<QuoteSlot, MAX_SYMBOLS>;
+
+    std::unordered_map<Symbol, InstrumentId, SymbolHash> symbol_ids_;
+    std::vector<bool> subscribed_;              // By ID
+    std::size_t subscription_count_ = 0;
+    RegionPtr<QuoteSlots> quotes_;
     QuoteCallback quote_callback_;
     MarketTradeCallback trade_callback_;
+    std::vector<std::unique_ptr<MarketDataChannel>> channels_;
 };
 
 /**
@@ -179,16 +383,24 @@ public:
      */
     void poll();
 
+    /**
+     * @brief Serve this feed from a shared Reactor instead of poll()
+     */
+    bool attach(Reactor& reactor) {
+        return handler_.attach(reactor);
+    }
+
     [[nodiscard]] bool is_connected() const {
         return handler_.is_connected();
     }
 
 private:
-    void on_message(const WebSocketFrame& frame);
+    void on_message(const WebSocketFrameView& frame);
 
     std::string host_;
     std::uint16_t port_;
     WebSocketHandler handler_;
+    JsonFeedDecoder decoder_;
     UpdateCallback callback_;
 };
 
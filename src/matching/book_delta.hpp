@@ -0,0 +1,40 @@
+/**
+ * @file book_delta.hpp
+ * @brief Per-level L2 change events emitted by OrderBook
+ *
+ * Every change to a price level's aggregate (an order added, filled,
+ * cancelled or amended) produces one BookDelta carrying the level's new
+ * total, so a consumer can keep an L2 book without snapshots:
+ * - A sweep through one level emits a single delta for the level, not one
+ *   per fill
+ * - quantity == 0 means the level is gone
+ * - sequence is per book and gapless; a consumer that sees a gap (the ring
+ *   was full) resyncs from a depth snapshot taken at delta_sequence()
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "core/lockfree_queue.hpp"
+#include "core/types.hpp"
+
+namespace hft {
+
+struct BookDelta {
+    std::uint64_t sequence;
+    Price price;
+    Quantity quantity;             // New level total, 0 = removed
+    std::uint32_t order_count;
+    Side side;
+    std::uint8_t reserved[3];
+};
+
+static_assert(sizeof(BookDelta) == 32, "BookDelta should be half a cache line");
+
+/**
+ * @brief Ring from the matching thread to one publisher
+ */
+inline constexpr std::size_t BOOK_DELTA_RING_SIZE = 65536;
+using BookDeltaRing = SPSCQueue<BookDelta, BOOK_DELTA_RING_SIZE>;
+
+} // namespace hft
@@ -0,0 +1,292 @@
+/**
+ * @file book_side.hpp
+ * @brief One side (bids or asks) of an order book
+ *
+ * Two interchangeable storage backends for price levels:
+ * - MAP:    std::map keyed by price. Unbounded price range, but every new
+ *           level is a tree node allocation and lookups chase pointers.
+ * - LADDER: Contiguous PriceLevel array indexed by (price - base) / tick.
+ *           O(1) level lookup, no allocation when levels appear or empty,
+ *           and a bitmap of non-empty levels to move the best-price cursor.
+ *           Requires a bounded, tick-aligned price band.
+ *
+ * The backend is chosen per book at construction and never changes, so the
+ * branch on it in every accessor is perfectly predicted.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <type_traits>
+#include <vector>
+#include "price_level.hpp"
+#include "core/types.hpp"
+
+namespace hft {
+
+/**
+ * @brief Price level storage backend
+ */
+enum class BookBackend : std::uint8_t {
+    MAP,        // std::map, any price accepted
+    LADDER      // Flat array over a fixed tick-aligned price band
+};
+
+/**
+ * @brief Per-instrument order book configuration
+ */
+struct OrderBookConfig {
+    BookBackend backend = BookBackend::MAP;
+    Price base_price = 0;           // Lowest price on the ladder
+    Price tick_size = 1;            // Price increment between ladder levels
+    std::size_t num_levels = 0;     // Number of ladder levels
+
+    /**
+     * @brief Ladder covering [min_price, max_price] inclusive
+     */
+    static OrderBookConfig ladder(Price min_price, Price max_price, Price tick_size) {
+        OrderBookConfig config;
+        config.backend = BookBackend::LADDER;
+        config.base_price = min_price;
+        config.tick_size = tick_size;
+        config.num_levels = static_cast<std::size_t>((max_price - min_price) / tick_size) + 1;
+        return config;
+    }
+};
+
+/**
+ * @brief Price levels for one side of the book, best price first
+ *
+ * @tparam S Side::BUY keeps highest price best, Side::SELL lowest
+ */
+template<Side S>
+class BookSide {
+    using Compare = std::conditional_t<S == Side::BUY, std::greater<Price>, std::less<Price>>;
+    using LevelMap = std::map<Price, PriceLevel, Compare>;
+
+    static constexpr std::size_t NO_LEVEL = static_cast<std::size_t>(-1);
+    static constexpr std::size_t WORD_BITS = 64;
+
+public:
+    explicit BookSide(const OrderBookConfig& config = {})
+        : config_(config)
+    {
+        if (is_ladder()) {
+            levels_.reserve(config_.num_levels);
+            for (std::size_t i = 0; i < config_.num_levels; ++i) {
+                levels_.emplace_back(price_at(i));
+            }
+            occupied_.assign((config_.num_levels + WORD_BITS - 1) / WORD_BITS, 0);
+        }
+    }
+
+    // Non-copyable (levels hold intrusive pointers into the order pool)
+    BookSide(const BookSide&) = delete;
+    BookSide& operator=(const BookSide&) = delete;
+
+    [[nodiscard]] bool is_ladder() const noexcept {
+        return config_.backend == BookBackend::LADDER;
+    }
+
+    /**
+     * @brief Check whether an order at this price can rest on this side
+     */
+    [[nodiscard]] bool accepts(Price price) const noexcept {
+        if (!is_ladder()) return true;
+        if (price < config_.base_price) return false;
+        const Price offset = price - config_.base_price;
+        return offset % config_.tick_size == 0 &&
+               static_cast<std::size_t>(offset / config_.tick_size) < config_.num_levels;
+    }
+
+    /**
+     * @brief Best (top of book) level, or nullptr if side is empty
+     */
+    [[nodiscard]] PriceLevel* best() noexcept {
+        if (is_ladder()) {
+            return best_ != NO_LEVEL ? &levels_[best_] : nullptr;
+        }
+        return map_.empty() ? nullptr : &map_.begin()->second;
+    }
+
+    [[nodiscard]] const PriceLevel* best() const noexcept {
+        return const_cast<BookSide*>(this)->best();
+    }
+
+    /**
+     * @brief Find a non-empty level at an exact price
+     */
+    [[nodiscard]] PriceLevel* find(Price price) noexcept {
+        if (is_ladder()) {
+            if (!accepts(price)) return nullptr;
+            const std::size_t idx = index_of(price);
+            return is_occupied(idx) ? &levels_[idx] : nullptr;
+        }
+        auto it = map_.find(price);
+        return it != map_.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * @brief Get the level at a price, creating it if absent
+     *
+     * Ladder callers must check accepts() first.
+     */
+    PriceLevel& get_or_create(Price price) {
+        if (is_ladder()) {
+            const std::size_t idx = index_of(price);
+            if (!is_occupied(idx)) {
+                set_occupied(idx);
+                ++level_count_;
+                if (best_ == NO_LEVEL || better(idx, best_)) {
+                    best_ = idx;
+                }
+            }
+            return levels_[idx];
+        }
+        auto [it, inserted] = map_.try_emplace(price, price);
+        if (inserted) ++level_count_;
+        return it->second;
+    }
+
+    /**
+     * @brief Drop a level that has become empty
+     */
+    void remove_level(PriceLevel& level) {
+        if (is_ladder()) {
+            const auto idx = static_cast<std::size_t>(&level - levels_.data());
+            clear_occupied(idx);
+            --level_count_;
+            if (idx == best_) {
+                best_ = next_occupied(idx);
+            }
+            return;
+        }
+        auto it = map_.begin();
+        if (&it->second != &level) {
+            it = map_.find(level.price());
+        }
+        map_.erase(it);
+        --level_count_;
+    }
+
+    /**
+     * @brief Visit non-empty levels from best to worst
+     *
+     * @param fn Callable taking (const PriceLevel&), returning false to stop
+     */
+    template<typename Fn>
+    void for_each_level(Fn&& fn) const {
+        if (is_ladder()) {
+            for (std::size_t idx = best_; idx != NO_LEVEL; idx = next_occupied(idx)) {
+                if (!fn(levels_[idx])) return;
+            }
+            return;
+        }
+        for (const auto& [_, level] : map_) {
+            if (!fn(level)) return;
+        }
+    }
+
+    [[nodiscard]] std::size_t level_count() const noexcept { return level_count_; }
+    [[nodiscard]] bool empty() const noexcept { return level_count_ == 0; }
+
+    /**
+     * @brief Drop all levels (orders are owned and freed by the book)
+     */
+    void clear() {
+        if (is_ladder()) {
+            for (std::size_t idx = best_; idx != NO_LEVEL; idx = next_occupied(idx)) {
+                levels_[idx] = PriceLevel(price_at(idx));
+            }
+            std::fill(occupied_.begin(), occupied_.end(), 0);
+            best_ = NO_LEVEL;
+        } else {
+            map_.clear();
+        }
+        level_count_ = 0;
+    }
+
+private:
+    [[nodiscard]] Price price_at(std::size_t idx) const noexcept {
+        return config_.base_price + static_cast<Price>(idx) * config_.tick_size;
+    }
+
+    [[nodiscard]] std::size_t index_of(Price price) const noexcept {
+        return static_cast<std::size_t>((price - config_.base_price) / config_.tick_size);
+    }
+
+    /**
+     * @brief True if level index a is a better price than b for this side
+     */
+    [[nodiscard]] static bool better(std::size_t a, std::size_t b) noexcept {
+        if constexpr (S == Side::BUY) {
+            return a > b;
+        } else {
+            return a < b;
+        }
+    }
+
+    [[nodiscard]] bool is_occupied(std::size_t idx) const noexcept {
+        return (occupied_[idx / WORD_BITS] >> (idx % WORD_BITS)) & 1;
+    }
+
+    void set_occupied(std::size_t idx) noexcept {
+        occupied_[idx / WORD_BITS] |= std::uint64_t{1} << (idx % WORD_BITS);
+    }
+
+    void clear_occupied(std::size_t idx) noexcept {
+        occupied_[idx / WORD_BITS] &= ~(std::uint64_t{1} << (idx % WORD_BITS));
+    }
+
+    /**
+     * @brief Next non-empty level strictly worse than idx, or NO_LEVEL
+     *
+     * Bids walk down the ladder, asks walk up; a whole 64-level word is
+     * skipped per step when it is empty.
+     */
+    [[nodiscard]] std::size_t next_occupied(std::size_t idx) const noexcept {
+        if constexpr (S == Side::BUY) {
+            if (idx == 0) return NO_LEVEL;
+            std::size_t word = (idx - 1) / WORD_BITS;
+            const std::size_t bit = (idx - 1) % WORD_BITS;
+            std::uint64_t bits = occupied_[word] & (~std::uint64_t{0} >> (WORD_BITS - 1 - bit));
+            while (true) {
+                if (bits) {
+                    return word * WORD_BITS + (WORD_BITS - 1 - std::countl_zero(bits));
+                }
+                if (word == 0) return NO_LEVEL;
+                bits = occupied_[--word];
+            }
+        } else {
+            const std::size_t start = idx + 1;
+            if (start >= config_.num_levels) return NO_LEVEL;
+            std::size_t word = start / WORD_BITS;
+            std::uint64_t bits = occupied_[word] & (~std::uint64_t{0} << (start % WORD_BITS));
+            while (true) {
+                if (bits) {
+                    return word * WORD_BITS + std::countr_zero(bits);
+                }
+                if (++word >= occupied_.size()) return NO_LEVEL;
+                bits = occupied_[word];
+            }
+        }
+    }
+
+    OrderBookConfig config_;
+    std::size_t level_count_ = 0;
+
+    // MAP backend
+    LevelMap map_;
+
+    // LADDER backend
+    std::vector<PriceLevel> levels_;
+    std::vector<std::uint64_t> occupied_;
+    std::size_t best_ = NO_LEVEL;
+};
+
+} // namespace hft
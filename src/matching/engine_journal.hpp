@@ -0,0 +1,715 @@
+/**
+ * @file engine_journal.hpp
+ * @brief Write-ahead journal and snapshots for MatchingEngine recovery
+ *
+ * Every OrderRequest is journaled before the engine processes it. Matching
+ * is deterministic given the request sequence and the order ID counter, so
+ * state after a restart is rebuilt from:
+ *
+ *   latest snapshot (resting orders + next order ID at journal sequence S)
+ *   + journal records S+1 .. tail replayed through process_request()
+ *
+ * - The engine thread only copies a 96-byte record into an SPSC queue.
+ *   A background thread copies records into a preallocated, memory-mapped
+ *   file and syncs once per drained batch (group commit), per interval, or
+ *   never, as configured; durable_sequence() says how far it has got.
+ * - Snapshots are serialized on the engine thread into one buffer (a
+ *   sequential walk of the books, no I/O) and written, fsynced and
+ *   renamed into place by the background thread.
+ * - Records are fixed-size and numbered from 1, so the replay start is an
+ *   offset computation and replay reads straight out of the mapping.
+ *   A torn or partial tail record fails its checksum and ends the journal.
+ * - A record that cannot be stored (the file cannot grow) fails the
+ *   journal for good: append() refuses every later request rather than
+ *   accept requests that could never be replayed.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "matching_engine.hpp"
+#include "core/lockfree_queue.hpp"
+#include "core/memory_region.hpp"
+#include "core/types.hpp"
+
+namespace hft {
+
+/**
+ * @brief When the journal thread forces written records to disk
+ */
+enum class FsyncPolicy : std::uint8_t {
+    NONE,           // Leave write-back to the kernel (survives process crash only)
+    EVERY_BATCH,    // msync after each drained batch (group commit)
+    INTERVAL        // msync at most every fsync_interval_ms
+};
+
+struct JournalConfig {
+    std::string path;
+    std::size_t initial_size = 64 * 1024 * 1024;    // Preallocated, doubled when full
+    FsyncPolicy fsync = FsyncPolicy::EVERY_BATCH;
+    std::uint32_t fsync_interval_ms = 10;
+};
+
+/**
+ * @brief One journaled OrderRequest
+ */
+struct JournalRecord {
+    std::uint64_t sequence;
+    OrderId order_id;
+    Price price;
+    Quantity quantity;
+    std::uint64_t client_id;
+    Timestamp timestamp;
+    Price stop_price;
+    Quantity display_quantity;
+    Symbol symbol;
+    InstrumentId instrument;
+    std::uint8_t request_type;
+    std::uint8_t side;
+    std::uint8_t order_type;
+    std::uint8_t reserved;
+    std::uint32_t checksum;
+    std::uint32_t padding;
+};
+
+static_assert(sizeof(JournalRecord) == 96, "Journal record layout changed");
+
+struct RecoveryResult {
+    bool snapshot_loaded = false;
+    std::uint64_t snapshot_sequence = 0;
+    std::size_t orders_restored = 0;
+    std::uint64_t records_replayed = 0;
+};
+
+/**
+ * @brief Journal writer, snapshot writer and recovery for one engine
+ *
+ * append() and snapshot() are called from the engine thread; everything
+ * else that touches the file runs on the journal thread.
+ */
+class EngineJournal {
+public:
+    static constexpr std::size_t QUEUE_SIZE = 65536;
+    static constexpr std::uint64_t JOURNAL_MAGIC = 0x4C4E524A54464848ULL;     // "HHFTJRNL"
+    static constexpr std::uint64_t SNAPSHOT_MAGIC = 0x50414E5354464848ULL;    // "HHFTSNAP"
+    static constexpr std::uint32_t VERSION = 2;
+
+    EngineJournal() : queue_(make_in_region<Queue>(default_memory_policy())) {}
+
+    ~EngineJournal() { close(); }
+
+    // Non-copyable
+    EngineJournal(const EngineJournal&) = delete;
+    EngineJournal& operator=(const EngineJournal&) = delete;
+
+    /**
+     * @brief Open or create the journal file and find its valid tail
+     */
+    bool open(const JournalConfig& config) {
+        #ifdef __linux__
+        if (fd_ >= 0) return false;
+        config_ = config;
+        fd_ = ::open(config_.path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) return false;
+
+        struct stat st{};
+        if (fstat(fd_, &st) < 0) {
+            close();
+            return false;
+        }
+        const bool fresh = st.st_size < static_cast<off_t>(HEADER_SIZE);
+        std::size_t size = std::max<std::size_t>(static_cast<std::size_t>(st.st_size),
+                                                 HEADER_SIZE + config_.initial_size);
+        size = round_to_records(size);
+        if (!map(size)) {
+            close();
+            return false;
+        }
+
+        Header* header = reinterpret_cast<Header*>(base_);
+        if (fresh) {
+            *header = Header{JOURNAL_MAGIC, VERSION, static_cast<std::uint32_t>(sizeof(JournalRecord))};
+            msync(base_, HEADER_SIZE, MS_SYNC);
+        } else if (header->magic != JOURNAL_MAGIC || header->version != VERSION ||
+                   header->record_size != sizeof(JournalRecord)) {
+            close();
+            return false;
+        }
+
+        // Sequences are contiguous from 1: the tail is the first bad record
+        std::uint64_t count = 0;
+        while (count < capacity() && valid(*record_at(count), count + 1)) {
+            ++count;
+        }
+        last_sequence_ = count;
+        written_ = count;
+        synced_ = count;
+        durable_sequence_.store(count, std::memory_order_relaxed);
+        return true;
+        #else
+        (void)config;
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief Start the journal thread
+     */
+    void start() {
+        if (fd_ < 0 || running_.load(std::memory_order_acquire)) return;
+        running_.store(true, std::memory_order_release);
+        worker_ = std::thread([this] { run(); });
+    }
+
+    /**
+     * @brief Drain queued records and snapshots, sync, stop the thread
+     */
+    void stop() {
+        running_.store(false, std::memory_order_release);
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    void close() {
+        stop();
+        #ifdef __linux__
+        if (base_) {
+            munmap(base_, mapped_size_);
+            base_ = nullptr;
+            mapped_size_ = 0;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        #endif
+    }
+
+    /**
+     * @brief Journal a request ahead of processing it (engine thread)
+     * @return Its sequence number, or 0 if the queue is full or the journal
+     *         has failed, and the request must not be processed
+     */
+    [[nodiscard]] std::uint64_t append(const OrderRequest& request) noexcept {
+        if (failed_.load(std::memory_order_acquire)) [[unlikely]] {
+            ++stats_.rejected_failed;
+            return 0;
+        }
+        JournalRecord record{};
+        record.sequence = last_sequence_ + 1;
+        record.order_id = request.order_id;
+        record.price = request.price;
+        record.quantity = request.quantity;
+        record.client_id = request.client_id;
+        record.timestamp = request.timestamp;
+        record.symbol = request.symbol;
+        record.instrument = request.instrument;
+        record.request_type = static_cast<std::uint8_t>(request.request_type);
+        record.side = static_cast<std::uint8_t>(request.side);
+        record.order_type = static_cast<std::uint8_t>(request.order_type);
+        record.stop_price = request.stop_price;
+        record.display_quantity = request.display_quantity;
+        record.checksum = checksum(record);
+        if (!queue_->try_push(record)) {
+            ++stats_.queue_full;
+            return 0;
+        }
+        return ++last_sequence_;
+    }
+
+    /**
+     * @brief Journal and process a request
+     * @return process_request() result, INVALID_ORDER_ID if not journaled
+     */
+    template<ExecutionSink Sink>
+    OrderId process(MatchingEngine& engine, const OrderRequest& request, Sink&& sink) {
+        if (append(request) == 0) {
+            return INVALID_ORDER_ID;
+        }
+        return engine.process_request(request, sink);
+    }
+
+    OrderId process(MatchingEngine& engine, const OrderRequest& request) {
+        if (append(request) == 0) {
+            return INVALID_ORDER_ID;
+        }
+        return engine.process_request(request);
+    }
+
+    /**
+     * @brief Serialize resting orders as of the last appended request
+     *
+     * The buffer is built here (engine thread); the journal thread writes
+     * it to path.tmp, syncs it and renames it over path.
+     */
+    void snapshot(const MatchingEngine& engine, const std::string& path) {
+        std::vector<char> buffer = serialize(engine, last_sequence_);
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        pending_snapshot_ = std::move(buffer);
+        pending_snapshot_path_ = path;
+        pending_snapshot_sequence_ = last_sequence_;
+        snapshot_pending_.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Rebuild engine state from a snapshot and this journal's records
+     *
+     * Call after open() and before start(), on an empty engine with its
+     * instruments already added. A missing snapshot replays the whole
+     * journal.
+     *
+     * @return nullopt if the snapshot is corrupt, names an unknown symbol or
+     *         is ahead of the journal (engine state is then unspecified)
+     */
+    std::optional<RecoveryResult> recover(MatchingEngine& engine, const std::string& snapshot_path) {
+        RecoveryResult result;
+        std::vector<char> data;
+        if (read_file(snapshot_path, data)) {
+            auto restored = load_snapshot(engine, data);
+            if (!restored) return std::nullopt;
+            result.snapshot_loaded = true;
+            result.snapshot_sequence = restored->first;
+            result.orders_restored = restored->second;
+        }
+        if (result.snapshot_sequence > written_) {
+            return std::nullopt;    // Snapshot is ahead of the journal
+        }
+
+        for (std::uint64_t i = result.snapshot_sequence; i < written_; ++i) {
+            engine.process_request(to_request(*record_at(i)), NullExecutionSink{});
+            ++result.records_replayed;
+        }
+        return result;
+    }
+
+    struct Stats {
+        std::uint64_t batches = 0;
+        std::uint64_t syncs = 0;
+        std::uint64_t snapshots = 0;
+        std::uint64_t queue_full = 0;     // Engine thread
+        std::uint64_t rejected_failed = 0;  // Engine thread: append() after failed()
+        std::uint64_t write_errors = 0;
+        std::uint64_t records_lost = 0;   // Queued when the journal failed
+        std::uint64_t snapshots_skipped = 0;  // Would have been ahead of the journal
+    };
+
+    /**
+     * @brief Last sequence handed to append() (engine thread)
+     */
+    [[nodiscard]] std::uint64_t last_sequence() const noexcept { return last_sequence_; }
+
+    /**
+     * @brief Highest sequence written and synced per the fsync policy
+     *
+     * Records are stored contiguously from 1 (a failed write stops the
+     * journal instead of leaving a gap), so the count is the sequence.
+     */
+    [[nodiscard]] std::uint64_t durable_sequence() const noexcept {
+        return durable_sequence_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::uint64_t snapshots_written() const noexcept {
+        return snapshots_written_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+
+    /**
+     * @brief A record could not be stored: append() now refuses everything
+     *
+     * Requests processed after the last durable_sequence() are not in the
+     * journal; the process should stop and recover from the file.
+     */
+    [[nodiscard]] bool failed() const noexcept { return failed_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Counters; journal thread fields are only stable after stop()
+     */
+    [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+
+private:
+    using Queue = SPSCQueue<JournalRecord, QUEUE_SIZE>;
+
+    struct Header {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t record_size;
+    };
+
+    struct SnapshotHeader {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t book_count;
+        std::uint64_t journal_sequence;
+        OrderId next_order_id;
+        std::uint64_t checksum;         // Of everything after the header
+    };
+
+    struct SnapshotBook {
+        Symbol symbol;
+        std::uint64_t order_count;
+    };
+
+    struct SnapshotOrder {
+        OrderId order_id;
+        Price price;
+        Quantity quantity;
+        Quantity filled_quantity;
+        std::uint64_t client_id;
+        Timestamp entry_time;
+        Price stop_price;
+        Quantity display_quantity;
+        Side side;
+        OrderType type;
+        std::uint8_t padding[6];
+    };
+
+    static constexpr std::size_t HEADER_SIZE = 4096;
+    static_assert(sizeof(Header) <= HEADER_SIZE);
+
+    static std::size_t round_to_records(std::size_t size) noexcept {
+        return HEADER_SIZE + (size - HEADER_SIZE) / sizeof(JournalRecord) * sizeof(JournalRecord);
+    }
+
+    static std::uint64_t fnv1a(const void* data, std::size_t len,
+                               std::uint64_t hash = 0xCBF29CE484222325ULL) noexcept {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < len; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    static std::uint32_t checksum(const JournalRecord& record) noexcept {
+        const auto hash = fnv1a(&record, offsetof(JournalRecord, checksum));
+        return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+    }
+
+    static bool valid(const JournalRecord& record, std::uint64_t sequence) noexcept {
+        return record.sequence == sequence && record.checksum == checksum(record);
+    }
+
+    static OrderRequest to_request(const JournalRecord& record) noexcept {
+        OrderRequest request{};
+        request.request_type = static_cast<OrderRequest::Type>(record.request_type);
+        request.symbol = record.symbol;
+        request.instrument = record.instrument;
+        request.order_id = record.order_id;
+        request.side = static_cast<Side>(record.side);
+        request.order_type = static_cast<OrderType>(record.order_type);
+        request.price = record.price;
+        request.quantity = record.quantity;
+        request.client_id = record.client_id;
+        request.timestamp = record.timestamp;
+        request.stop_price = record.stop_price;
+        request.display_quantity = record.display_quantity;
+        return request;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return (mapped_size_ - HEADER_SIZE) / sizeof(JournalRecord);
+    }
+
+    [[nodiscard]] JournalRecord* record_at(std::uint64_t index) const noexcept {
+        return reinterpret_cast<JournalRecord*>(base_ + HEADER_SIZE) + index;
+    }
+
+    bool map(std::size_t size) {
+        #ifdef __linux__
+        // Reserve the blocks up front so stores into the mapping never fault on ENOSPC
+        if (posix_fallocate(fd_, 0, static_cast<off_t>(size)) != 0 &&
+            ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            return false;
+        }
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) return false;
+        if (base_) {
+            munmap(base_, mapped_size_);
+        }
+        base_ = static_cast<char*>(addr);
+        mapped_size_ = size;
+        return true;
+        #else
+        (void)size;
+        return false;
+        #endif
+    }
+
+    void run() {
+        auto last_sync = std::chrono::steady_clock::now();
+        IdleStrategy idle(PollMode::RELAXED);      // Parks are short next to an fsync
+        for (;;) {
+            // Read the flag first so nothing appended before stop() is missed
+            const bool running = running_.load(std::memory_order_acquire);
+
+            std::size_t drained = queue_->consume_all([this](const JournalRecord& record) {
+                write(record);
+            });
+            if (drained > 0) {
+                ++stats_.batches;
+            }
+
+            const auto now_time = std::chrono::steady_clock::now();
+            const bool interval_due = now_time - last_sync >=
+                std::chrono::milliseconds(config_.fsync_interval_ms);
+            if (synced_ < written_ &&
+                (!running || config_.fsync == FsyncPolicy::EVERY_BATCH ||
+                 (config_.fsync == FsyncPolicy::INTERVAL && interval_due))) {
+                sync();
+                last_sync = now_time;
+            } else if (config_.fsync == FsyncPolicy::NONE) {
+                durable_sequence_.store(written_, std::memory_order_release);
+            }
+
+            if (snapshot_pending_.load(std::memory_order_acquire)) {
+                write_snapshot();
+            }
+            if (!running) break;
+            idle.idle(drained);
+        }
+    }
+
+    void write(const JournalRecord& record) {
+        if (failed_.load(std::memory_order_relaxed)) {
+            ++stats_.records_lost;
+            return;
+        }
+        if (written_ == capacity() && !grow()) {
+            // Storing later records would leave a gap that ends replay there
+            ++stats_.write_errors;
+            ++stats_.records_lost;
+            failed_.store(true, std::memory_order_release);
+            return;
+        }
+        std::memcpy(record_at(written_), &record, sizeof(record));
+        ++written_;
+    }
+
+    bool grow() {
+        sync();
+        return map(round_to_records(HEADER_SIZE + 2 * (mapped_size_ - HEADER_SIZE)));
+    }
+
+    void sync() {
+        #ifdef __linux__
+        if (config_.fsync != FsyncPolicy::NONE && synced_ < written_) {
+            // msync wants a page-aligned start
+            const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            const std::size_t begin = (HEADER_SIZE + synced_ * sizeof(JournalRecord)) / page * page;
+            const std::size_t end = HEADER_SIZE + written_ * sizeof(JournalRecord);
+            if (msync(base_ + begin, end - begin, MS_SYNC) != 0) {
+                ++stats_.write_errors;
+                return;
+            }
+            ++stats_.syncs;
+        }
+        #endif
+        synced_ = written_;
+        durable_sequence_.store(written_, std::memory_order_release);
+    }
+
+    void write_snapshot() {
+        std::vector<char> buffer;
+        std::string path;
+        std::uint64_t sequence = 0;
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mutex_);
+            buffer.swap(pending_snapshot_);
+            path.swap(pending_snapshot_path_);
+            sequence = pending_snapshot_sequence_;
+            snapshot_pending_.store(false, std::memory_order_release);
+        }
+        // Records up to the snapshot's sequence were queued before it was
+        // requested but may still sit in the queue: store and sync them
+        // first, or a crash leaves a snapshot ahead of the journal
+        queue_->consume_all([this](const JournalRecord& record) {
+            write(record);
+        });
+        sync();
+        if (written_ < sequence) {
+            ++stats_.snapshots_skipped;     // Journal failed short of it
+            return;
+        }
+        if (write_file(path, buffer)) {
+            ++stats_.snapshots;
+            snapshots_written_.fetch_add(1, std::memory_order_release);
+        } else {
+            ++stats_.write_errors;
+        }
+    }
+
+    static std::vector<char> serialize(const MatchingEngine& engine, std::uint64_t sequence) {
+        std::size_t orders = 0;
+        for (InstrumentId id = 0; id < engine.instrument_count(); ++id) {
+            orders += engine.get_book(id)->order_count() + engine.get_book(id)->stop_count();
+        }
+
+        std::vector<char> buffer(sizeof(SnapshotHeader) +
+                                 engine.instrument_count() * sizeof(SnapshotBook) +
+                                 orders * sizeof(SnapshotOrder));
+        char* out = buffer.data() + sizeof(SnapshotHeader);
+        for (InstrumentId id = 0; id < engine.instrument_count(); ++id) {
+            const OrderBook* book = engine.get_book(id);
+            const SnapshotBook entry{book->symbol(), book->order_count() + book->stop_count()};
+            std::memcpy(out, &entry, sizeof(entry));
+            out += sizeof(entry);
+            auto save = [&out](const Order& order) {
+                SnapshotOrder saved{};
+                saved.order_id = order.order_id;
+                saved.price = order.price;
+                saved.quantity = order.quantity;
+                saved.filled_quantity = order.filled_quantity;
+                saved.client_id = order.client_id;
+                saved.entry_time = order.entry_time;
+                saved.stop_price = order.stop_price;
+                saved.display_quantity = order.display_quantity;
+                saved.side = order.side;
+                saved.type = order.type;
+                std::memcpy(out, &saved, sizeof(saved));
+                out += sizeof(saved);
+            };
+            book->for_each_order(save);
+            book->for_each_stop(save);
+        }
+
+        const SnapshotHeader header{
+            SNAPSHOT_MAGIC, VERSION, static_cast<std::uint32_t>(engine.instrument_count()),
+            sequence, engine.next_order_id(),
+            fnv1a(buffer.data() + sizeof(SnapshotHeader), buffer.size() - sizeof(SnapshotHeader))};
+        std::memcpy(buffer.data(), &header, sizeof(header));
+        return buffer;
+    }
+
+    /**
+     * @return (journal sequence, orders restored)
+     */
+    static std::optional<std::pair<std::uint64_t, std::size_t>>
+    load_snapshot(MatchingEngine& engine, const std::vector<char>& data) {
+        SnapshotHeader header;
+        if (data.size() < sizeof(header)) return std::nullopt;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.magic != SNAPSHOT_MAGIC || header.version != VERSION ||
+            header.checksum != fnv1a(data.data() + sizeof(header), data.size() - sizeof(header))) {
+            return std::nullopt;
+        }
+
+        const char* in = data.data() + sizeof(header);
+        const char* end = data.data() + data.size();
+        std::size_t restored = 0;
+        for (std::uint32_t b = 0; b < header.book_count; ++b) {
+            SnapshotBook entry;
+            if (static_cast<std::size_t>(end - in) < sizeof(entry)) return std::nullopt;
+            std::memcpy(&entry, in, sizeof(entry));
+            in += sizeof(entry);
+
+            OrderBook* book = engine.get_book(entry.symbol);
+            if (!book || static_cast<std::size_t>(end - in) / sizeof(SnapshotOrder) < entry.order_count) {
+                return std::nullopt;
+            }
+            for (std::uint64_t i = 0; i < entry.order_count; ++i) {
+                SnapshotOrder saved;
+                std::memcpy(&saved, in, sizeof(saved));
+                in += sizeof(saved);
+
+                Order order(saved.order_id, saved.side, saved.type, saved.price, saved.quantity,
+                            saved.client_id);
+                order.filled_quantity = saved.filled_quantity;
+                order.status = saved.filled_quantity > 0 ? OrderStatus::PARTIALLY_FILLED : OrderStatus::NEW;
+                order.entry_time = saved.entry_time;
+                order.stop_price = saved.stop_price;
+                order.display_quantity = saved.display_quantity;
+                if (!book->restore_order(order)) return std::nullopt;
+                ++restored;
+            }
+        }
+        engine.set_next_order_id(header.next_order_id);
+        return std::make_pair(header.journal_sequence, restored);
+    }
+
+    static bool read_file(const std::string& path, std::vector<char>& data) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+        std::fseek(file, 0, SEEK_END);
+        const long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        bool ok = size >= 0;
+        if (ok) {
+            data.resize(static_cast<std::size_t>(size));
+            ok = std::fread(data.data(), 1, data.size(), file) == data.size();
+        }
+        std::fclose(file);
+        return ok;
+    }
+
+    static bool write_file(const std::string& path, const std::vector<char>& data) {
+        #ifdef __linux__
+        const std::string tmp = path + ".tmp";
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        std::size_t done = 0;
+        while (done < data.size()) {
+            ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+            if (n <= 0) {
+                ::close(fd);
+                return false;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        const bool ok = fsync(fd) == 0;
+        ::close(fd);
+        return ok && std::rename(tmp.c_str(), path.c_str()) == 0;
+        #else
+        (void)path;
+        (void)data;
+        return false;
+        #endif
+    }
+
+    JournalConfig config_;
+    int fd_ = -1;
+    char* base_ = nullptr;
+    std::size_t mapped_size_ = 0;
+
+    // Engine thread
+    std::uint64_t last_sequence_ = 0;
+    RegionPtr<Queue> queue_;
+
+    // Journal thread
+    std::uint64_t written_ = 0;
+    std::uint64_t synced_ = 0;
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+    std::atomic<std::uint64_t> durable_sequence_{0};
+    std::atomic<std::uint64_t> snapshots_written_{0};
+    std::atomic<bool> failed_{false};
+    Stats stats_;
+
+    std::mutex snapshot_mutex_;
+    std::atomic<bool> snapshot_pending_{false};
+    std::vector<char> pending_snapshot_;
+    std::uint64_t pending_snapshot_sequence_ = 0;
+    std::string pending_snapshot_path_;
+};
+
+} // namespace hft
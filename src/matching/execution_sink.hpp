@@ -0,0 +1,132 @@
+/**
+ * @file execution_sink.hpp
+ * @brief Execution report sinks for OrderBook / MatchingEngine
+ *
+ * The book is templated on the sink type, so a lambda or functor is called
+ * directly and inlined instead of going through std::function:
+ * - Any callable taking (const ExecutionReport&) is a sink
+ * - NullExecutionSink compiles report construction out entirely
+ * - ExecutionCallback (std::function) still works and is null-checked
+ * - BatchingExecutionSink appends into a caller-owned span and is flushed
+ *   once per incoming order, not once per fill
+ * - DeferredFlushSink lets a batch of orders share that flush
+ */
+
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "order.hpp"
+
+namespace hft {
+
+/**
+ * @brief Anything that can receive execution reports
+ */
+template<typename Sink>
+concept ExecutionSink = std::invocable<Sink&, const ExecutionReport&>;
+
+/**
+ * @brief Sink that discards all reports (reports are never built)
+ */
+struct NullExecutionSink {
+    void operator()(const ExecutionReport&) const noexcept {}
+};
+
+/**
+ * @brief Accumulate reports in a preallocated buffer, flush in bulk
+ *
+ * @tparam FlushFn Callable taking std::span<const ExecutionReport>
+ *
+ * A full buffer is flushed early, so no report is ever dropped.
+ */
+template<typename FlushFn>
+class BatchingExecutionSink {
+public:
+    BatchingExecutionSink(std::span<ExecutionReport> buffer, FlushFn flush_fn)
+        : buffer_(buffer)
+        , flush_fn_(std::move(flush_fn))
+    {
+        assert(!buffer_.empty() && "Batch buffer must not be empty");
+    }
+
+    void operator()(const ExecutionReport& report) {
+        if (count_ == buffer_.size()) {
+            flush();
+        }
+        buffer_[count_++] = report;
+    }
+
+    /**
+     * @brief Hand all pending reports to the flush function
+     */
+    void flush() {
+        if (count_ == 0) return;
+        flush_fn_(std::span<const ExecutionReport>(buffer_.data(), count_));
+        count_ = 0;
+    }
+
+    [[nodiscard]] std::size_t pending() const noexcept { return count_; }
+    [[nodiscard]] std::size_t capacity() const noexcept { return buffer_.size(); }
+
+private:
+    std::span<ExecutionReport> buffer_;
+    FlushFn flush_fn_;
+    std::size_t count_ = 0;
+};
+
+/**
+ * @brief Whether a sink wants reports at all
+ *
+ * Compile-time false for NullExecutionSink, runtime null check for
+ * std::function, true otherwise.
+ */
+template<typename Sink>
+[[nodiscard]] constexpr bool sink_enabled(const Sink& sink) noexcept {
+    if constexpr (std::is_same_v<Sink, NullExecutionSink>) {
+        (void)sink;
+        return false;
+    } else if constexpr (std::is_same_v<Sink, ExecutionCallback>) {
+        return static_cast<bool>(sink);
+    } else if constexpr (requires { sink.enabled(); }) {
+        return sink.enabled();
+    } else {
+        (void)sink;
+        return true;
+    }
+}
+
+/**
+ * @brief End-of-order hook: flush sinks that batch
+ */
+template<typename Sink>
+void sink_end_order(Sink& sink) {
+    if constexpr (requires { sink.flush(); }) {
+        sink.flush();
+    }
+}
+
+/**
+ * @brief Forwards to another sink but leaves the end-of-order flush to
+ *        its owner (the sink outlives the adapter)
+ */
+template<typename Sink>
+class DeferredFlushSink {
+public:
+    explicit DeferredFlushSink(Sink& inner) noexcept : inner_(inner) {}
+
+    void operator()(const ExecutionReport& report) {
+        inner_(report);
+    }
+
+    [[nodiscard]] bool enabled() const noexcept { return sink_enabled(inner_); }
+
+private:
+    Sink& inner_;
+};
+
+} // namespace hft
@@ -44,10 +44,12 @@ struct alignas(CACHE_LINE_SIZE) Order {
     // Client info (less frequently accessed)
     std::uint64_t client_id;   // 8 bytes
     std::uint32_t sequence_num;// 4 bytes
-    
-    // Padding to cache line
     std::uint8_t padding[4];
     
+    // Conditional orders (0 = not used)
+    Price stop_price;          // 8 bytes - STOP / STOP_LIMIT trigger
+    Quantity display_quantity; // 8 bytes - iceberg slice shown in the book
+    
     // ========================================================================
     // Constructors
     // ========================================================================
@@ -69,6 +71,8 @@ struct alignas(CACHE_LINE_SIZE) Order {
         , client_id(client)
         , sequence_num(0)
         , padding{}
+        , stop_price(0)
+        , display_quantity(0)
     {}
 
     // ========================================================================
@@ -96,6 +100,10 @@ struct alignas(CACHE_LINE_SIZE) Order {
         return side == Side::SELL;
     }
     
+    [[nodiscard]] bool is_stop() const noexcept {
+        return type == OrderType::STOP || type == OrderType::STOP_LIMIT;
+    }
+    
     // ========================================================================
     // Mutators
     // ========================================================================
@@ -150,17 +158,53 @@ struct OrderPriorityCompare {
 };
 
 /**
- * @brief Intrusive list node for order book
+ * @brief Index of a resting order in its book's OrderStore
+ */
+using OrderSlot = std::uint32_t;
+inline constexpr OrderSlot NO_ORDER_SLOT = ~OrderSlot{0};
+
+/**
+ * @brief Hot part of a resting order: only what a matching sweep touches
  * 
- * Used for O(1) order cancellation within a price level.
+ * Size: 32 bytes (two per cache line). Links are 32-bit slot indices into
+ * the book's OrderStore; the price is the PriceLevel's (and OrderInfo's).
  */
-struct OrderNode {
-    Order order;
-    OrderNode* prev = nullptr;
-    OrderNode* next = nullptr;
+struct RestingOrder {
+    OrderId order_id;          // 8 bytes
+    Quantity quantity;         // 8 bytes - original quantity
+    Quantity filled_quantity;  // 8 bytes
+    OrderSlot prev;            // 4 bytes - FIFO links within the level
+    OrderSlot next;            // 4 bytes
+    
+    [[nodiscard]] Quantity remaining_quantity() const noexcept {
+        return quantity - filled_quantity;
+    }
     
-    OrderNode() = default;
-    explicit OrderNode(const Order& o) : order(o) {}
+    [[nodiscard]] bool is_filled() const noexcept {
+        return filled_quantity >= quantity;
+    }
+};
+
+static_assert(sizeof(RestingOrder) == 32, "RestingOrder should be half a cache line");
+
+/**
+ * @brief Cold part of a resting order: read for reports, cancels, snapshots
+ * 
+ * Status is not stored: a resting order is NEW until its first fill and
+ * PARTIALLY_FILLED after it. An iceberg's hot quantity covers only its
+ * visible slice; the hidden rest waits in reserve_quantity.
+ */
+struct OrderInfo {
+    Price price;
+    Timestamp entry_time;
+    Timestamp update_time;
+    std::uint64_t client_id;
+    std::uint32_t sequence_num;
+    Side side;
+    OrderType type;
+    std::uint8_t flags;
+    Quantity display_quantity;      // 0 = fully visible
+    Quantity reserve_quantity;
 };
 
 /**
@@ -178,6 +222,10 @@ public:
         return next_id_.load(std::memory_order_relaxed);
     }
 
+    void reset(OrderId next) noexcept {
+        next_id_.store(next, std::memory_order_relaxed);
+    }
+
 private:
     std::atomic<OrderId> next_id_;
 };
@@ -212,8 +260,9 @@ struct alignas(CACHE_LINE_SIZE) ExecutionReport {
         report.order_status = order.status;
         report.timestamp = now();
         report.client_id = order.client_id;
-        report.leaves_quantity = order.remaining_quantity() - qty;
-        report.cumulative_quantity = order.filled_quantity + qty;
+        // The book applies the fill before reporting it
+        report.leaves_quantity = order.remaining_quantity();
+        report.cumulative_quantity = order.filled_quantity;
         return report;
     }
     
@@ -233,6 +282,22 @@ struct alignas(CACHE_LINE_SIZE) ExecutionReport {
         return report;
     }
     
+    static ExecutionReport make_replace(const Order& order) {
+        ExecutionReport report;
+        report.order_id = order.order_id;
+        report.contra_order_id = 0;
+        report.execution_price = order.price;
+        report.execution_quantity = 0;
+        report.side = order.side;
+        report.exec_type = ExecutionType::REPLACED;
+        report.order_status = order.status;
+        report.timestamp = now();
+        report.client_id = order.client_id;
+        report.leaves_quantity = order.remaining_quantity();
+        report.cumulative_quantity = order.filled_quantity;
+        return report;
+    }
+    
     static ExecutionReport make_cancel(const Order& order) {
         ExecutionReport report;
         report.order_id = order.order_id;
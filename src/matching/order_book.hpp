@@ -3,23 +3,31 @@
  * @brief Limit Order Book implementation
  * 
  * A high-performance order book using:
- * - Sorted map for price levels (log N access)
+ * - Sorted map or flat price ladder for price levels (see book_side.hpp)
  * - Intrusive linked lists for orders at each level (O(1) operations)
  * - Memory pool for order allocation (no heap fragmentation)
+ * - Open-addressing order ID index (no allocation on add/cancel/fill)
+ * - Trigger table for pending stop orders (see stop_table.hpp)
  * - Separate bid/ask sides for cache efficiency
  */
 
 #pragma once
 
-#include <map>
-#include <unordered_map>
 #include <vector>
+#include <limits>
 #include <optional>
 #include <functional>
+#include <span>
 #include "order.hpp"
 #include "price_level.hpp"
-#include "core/memory_pool.hpp"
+#include "book_side.hpp"
+#include "order_index.hpp"
+#include "execution_sink.hpp"
+#include "order_store.hpp"
+#include "book_delta.hpp"
+#include "stop_table.hpp"
 #include "core/types.hpp"
+#include "core/tsc_clock.hpp"
 
 namespace hft {
 
@@ -47,16 +55,16 @@ class OrderBook {
     static constexpr std::size_t MAX_ORDERS = 1'000'000;
     static constexpr std::size_t MAX_PRICE_LEVELS = 10'000;
 
-    // Use red-black tree map for price levels
-    // Bids: descending order (highest first)
-    // Asks: ascending order (lowest first)
-    using BidMap = std::map<Price, PriceLevel, std::greater<Price>>;
-    using AskMap = std::map<Price, PriceLevel, std::less<Price>>;
-
 public:
-    explicit OrderBook(const Symbol& symbol) 
+    /**
+     * @param memory Backing of the order store (MAX_ORDERS slots, ~72 MB)
+     */
+    explicit OrderBook(const Symbol& symbol, const OrderBookConfig& config = {},
+                       const MemoryPolicy& memory = default_memory_policy())
         : symbol_(symbol)
-        , order_pool_()
+        , bids_(config)
+        , asks_(config)
+        , orders_(MAX_ORDERS, memory)
     {}
 
     // Non-copyable
@@ -64,148 +72,163 @@ public:
     OrderBook& operator=(const OrderBook&) = delete;
 
     /**
-     * @brief Add a new limit order to the book
+     * @brief Add a new order to the book
+     * 
+     * Time in force and conditions are handled here, without gateway help:
+     * - IMMEDIATE_OR_CANCEL: the unfilled remainder is cancelled
+     * - FILL_OR_KILL: cancelled untouched unless visible liquidity fills it
+     * - POST_ONLY: never matches on entry
+     * - STOP / STOP_LIMIT: held until a trade prints at or through
+     *   stop_price, then executed as stop-market (IOC) or LIMIT
+     * - display_quantity (LIMIT): iceberg; only a slice is visible and the
+     *   next slice joins the back of the queue when one is filled
      * 
      * @param order The order to add
-     * @param exec_callback Callback for execution reports
+     * @param sink Receives execution reports (flushed once if it batches)
      * @return true if order was accepted
      */
-    bool add_order(const Order& order, ExecutionCallback exec_callback = nullptr) {
-        // Allocate order node from pool
-        OrderNode* node = order_pool_.create(order);
-        if (!node) {
-            // Pool exhausted
-            if (exec_callback) {
-                Order rejected = order;
-                rejected.reject();
-                exec_callback(ExecutionReport::make_cancel(rejected));
-            }
-            return false;
-        }
-
-        // Index by order ID
-        order_index_[order.order_id] = node;
-
-        // Send NEW execution report
-        if (exec_callback) {
-            exec_callback(ExecutionReport::make_new(order));
-        }
-
-        // Try to match immediately
-        if (order.type != OrderType::POST_ONLY) {
-            match_order(node, exec_callback);
-        }
-
-        // If order still has remaining quantity, add to book
-        if (node->order.remaining_quantity() > 0 && node->order.is_active()) {
-            add_to_book(node);
-        } else if (node->order.remaining_quantity() == 0) {
-            // Fully filled, remove from index
-            order_index_.erase(order.order_id);
-            order_pool_.destroy(node);
-        }
+    template<ExecutionSink Sink>
+    bool add_order(const Order& order, Sink&& sink) {
+        const bool accepted = add_order_impl(order, sink);
+        sink_end_order(sink);
+        return accepted;
+    }
 
-        return true;
+    bool add_order(const Order& order) {
+        return add_order(order, NullExecutionSink{});
     }
 
     /**
      * @brief Cancel an existing order
      * 
      * @param order_id ID of order to cancel
-     * @param exec_callback Callback for execution report
+     * @param sink Receives the cancel report
      * @return true if order was found and cancelled
      */
-    bool cancel_order(OrderId order_id, ExecutionCallback exec_callback = nullptr) {
-        auto it = order_index_.find(order_id);
-        if (it == order_index_.end()) {
-            return false;
-        }
+    template<ExecutionSink Sink>
+    bool cancel_order(OrderId order_id, Sink&& sink) {
+        const bool cancelled = cancel_order_impl(order_id, sink);
+        sink_end_order(sink);
+        return cancelled;
+    }
 
-        OrderNode* node = it->second;
-        
-        // Send cancel report
-        node->order.cancel();
-        if (exec_callback) {
-            exec_callback(ExecutionReport::make_cancel(node->order));
-        }
+    bool cancel_order(OrderId order_id) {
+        return cancel_order(order_id, NullExecutionSink{});
+    }
 
-        // Remove from book
-        remove_from_book(node);
-        
-        // Remove from index and pool
-        order_index_.erase(it);
-        order_pool_.destroy(node);
+    /**
+     * @brief Amend a resting order's price and open quantity
+     * 
+     * The order keeps its slot and index entry and gets one REPLACED report:
+     * - Same price, same or lower quantity: keeps queue priority, O(1)
+     * - Higher quantity or new price: moves to the back of its new level,
+     *   trading first if the new price crosses (except POST_ONLY)
+     * - Quantity 0 cancels it
+     * 
+     * @return false if the order is unknown or the price is off the grid
+     */
+    template<ExecutionSink Sink>
+    bool modify_order(OrderId order_id, Price new_price, Quantity new_quantity, Sink&& sink) {
+        const bool modified = modify_order_impl(order_id, new_price, new_quantity, sink);
+        sink_end_order(sink);
+        return modified;
+    }
 
-        return true;
+    bool modify_order(OrderId order_id, Price new_price, Quantity new_quantity) {
+        return modify_order(order_id, new_price, new_quantity, NullExecutionSink{});
     }
 
     /**
-     * @brief Modify an existing order (cancel + replace)
+     * @brief Get a copy of a resting or pending stop order by ID
      */
-    bool modify_order(OrderId order_id, Price new_price, Quantity new_quantity,
-                      ExecutionCallback exec_callback = nullptr) {
-        auto it = order_index_.find(order_id);
-        if (it == order_index_.end()) {
-            return false;
+    [[nodiscard]] std::optional<Order> get_order(OrderId order_id) const {
+        const OrderSlot slot = order_index_.find(order_id);
+        if (slot == NO_ORDER_SLOT) {
+            const Order* stop = stops_.find(order_id);
+            return stop ? std::optional<Order>(*stop) : std::nullopt;
         }
+        return orders_.to_order(slot);
+    }
 
-        OrderNode* node = it->second;
-        Order& order = node->order;
+    /**
+     * @brief Visit resting orders, bids then asks, in price-time priority
+     */
+    template<typename Fn>
+    void for_each_order(Fn&& fn) const {
+        auto visit = [this, &fn](const PriceLevel& level) {
+            level.for_each_slot(orders_, [this, &fn](OrderSlot slot) {
+                fn(orders_.to_order(slot));
+            });
+            return true;
+        };
+        bids_.for_each_level(visit);
+        asks_.for_each_level(visit);
+    }
 
-        // If only reducing quantity at same price, can do in-place
-        if (new_price == order.price && new_quantity < order.remaining_quantity()) {
-            order.quantity = order.filled_quantity + new_quantity;
-            update_level_quantity(order.side, order.price);
+    /**
+     * @brief Re-insert a resting order at the back of its level (recovery)
+     * 
+     * No matching and no execution reports: the order must not cross the
+     * book, and orders must be restored in priority order to keep FIFO.
+     * Stop orders go back into the trigger table.
+     * 
+     * @return false if the ID is in use, nothing remains, or the pool is full
+     */
+    bool restore_order(const Order& order) {
+        if (order.order_id == INVALID_ORDER_ID || order.remaining_quantity() <= 0 ||
+            (has_limit_price(order.type) && !accepts_price(order.side, order.price)) ||
+            order_index_.find(order.order_id) != NO_ORDER_SLOT || stops_.find(order.order_id)) {
+            return false;
+        }
+        if (order.is_stop()) {
+            stops_.add(order);
             return true;
         }
-
-        // Otherwise, cancel and re-add
-        Side side = order.side;
-        OrderType type = order.type;
-        std::uint64_t client_id = order.client_id;
-        
-        cancel_order(order_id, nullptr);
-        
-        Order new_order(order_id, side, type, new_price, new_quantity, client_id);
-        return add_order(new_order, exec_callback);
+        return rest_order(order);
     }
 
     /**
-     * @brief Get an order by ID
+     * @brief Visit pending (untriggered) stop orders
      */
-    [[nodiscard]] const Order* get_order(OrderId order_id) const {
-        auto it = order_index_.find(order_id);
-        return it != order_index_.end() ? &it->second->order : nullptr;
+    template<typename Fn>
+    void for_each_stop(Fn&& fn) const {
+        stops_.for_each(fn);
     }
 
+    [[nodiscard]] std::size_t stop_count() const noexcept { return stops_.size(); }
+
     /**
      * @brief Get best bid price
      */
     [[nodiscard]] std::optional<Price> best_bid() const {
-        if (bids_.empty()) return std::nullopt;
-        return bids_.begin()->first;
+        const PriceLevel* level = bids_.best();
+        if (!level) return std::nullopt;
+        return level->price();
     }
 
     /**
      * @brief Get best ask price
      */
     [[nodiscard]] std::optional<Price> best_ask() const {
-        if (asks_.empty()) return std::nullopt;
-        return asks_.begin()->first;
+        const PriceLevel* level = asks_.best();
+        if (!level) return std::nullopt;
+        return level->price();
     }
 
     /**
      * @brief Get best bid/ask quote
      */
     [[nodiscard]] std::optional<Quote> get_quote() const {
-        if (bids_.empty() || asks_.empty()) return std::nullopt;
+        const PriceLevel* bid = bids_.best();
+        const PriceLevel* ask = asks_.best();
+        if (!bid || !ask) return std::nullopt;
         
         Quote quote;
-        quote.bid_price = bids_.begin()->first;
-        quote.ask_price = asks_.begin()->first;
-        quote.bid_quantity = bids_.begin()->second.total_quantity();
-        quote.ask_quantity = asks_.begin()->second.total_quantity();
-        quote.timestamp = now();
+        quote.bid_price = bid->price();
+        quote.ask_price = ask->price();
+        quote.bid_quantity = bid->total_quantity();
+        quote.ask_quantity = ask->total_quantity();
+        quote.timestamp = fast_now();
         return quote;
     }
 
@@ -225,24 +248,52 @@ public:
 
     [[nodiscard]] Depth get_depth(std::size_t levels = 10) const {
         Depth depth;
-        depth.bids.reserve(levels);
-        depth.asks.reserve(levels);
+        depth.bids.resize(levels);
+        depth.asks.resize(levels);
+        depth.bids.resize(copy_depth(Side::BUY, depth.bids));
+        depth.asks.resize(copy_depth(Side::SELL, depth.asks));
+        return depth;
+    }
 
+    /**
+     * @brief Fill out with the best levels of one side, best first
+     * 
+     * Allocation-free and O(out.size()); on the engine thread, pair it with
+     * delta_sequence() to seed a delta consumer.
+     * 
+     * @return Number of levels written
+     */
+    std::size_t copy_depth(Side side, std::span<Level> out) const {
         std::size_t count = 0;
-        for (const auto& [price, level] : bids_) {
-            if (count++ >= levels) break;
-            depth.bids.push_back({price, level.total_quantity(), level.order_count()});
-        }
-
-        count = 0;
-        for (const auto& [price, level] : asks_) {
-            if (count++ >= levels) break;
-            depth.asks.push_back({price, level.total_quantity(), level.order_count()});
+        if (out.empty()) return 0;
+        auto copy = [&](const PriceLevel& level) {
+            out[count++] = {level.price(), level.total_quantity(), level.order_count()};
+            return count < out.size();
+        };
+        if (side == Side::BUY) {
+            bids_.for_each_level(copy);
+        } else {
+            asks_.for_each_level(copy);
         }
+        return count;
+    }
 
-        return depth;
+    /**
+     * @brief Emit a BookDelta into ring on every level change (nullptr: off)
+     * 
+     * Deltas that do not fit are counted in deltas_dropped() and leave a gap
+     * in the sequence.
+     */
+    void set_delta_ring(BookDeltaRing* ring) noexcept {
+        deltas_ = ring;
     }
 
+    /**
+     * @brief Sequence of the last delta emitted (or dropped)
+     */
+    [[nodiscard]] std::uint64_t delta_sequence() const noexcept { return delta_sequence_; }
+    [[nodiscard]] std::uint64_t deltas_dropped() const noexcept { return deltas_dropped_; }
+
     /**
      * @brief Get spread
      */
@@ -268,19 +319,13 @@ public:
      */
     [[nodiscard]] OrderBookStats get_stats() const {
         OrderBookStats stats;
-        stats.bid_levels = bids_.size();
-        stats.ask_levels = asks_.size();
+        stats.bid_levels = bids_.level_count();
+        stats.ask_levels = asks_.level_count();
         stats.total_orders = order_index_.size();
         stats.trades_matched = trades_matched_;
         stats.volume_matched = volume_matched_;
-
-        for (const auto& [_, level] : bids_) {
-            stats.total_bid_quantity += level.total_quantity();
-        }
-        for (const auto& [_, level] : asks_) {
-            stats.total_ask_quantity += level.total_quantity();
-        }
-
+        stats.total_bid_quantity = total_bid_quantity_;
+        stats.total_ask_quantity = total_ask_quantity_;
         return stats;
     }
 
@@ -288,13 +333,15 @@ public:
      * @brief Clear all orders from the book
      */
     void clear() {
-        // Clean up all orders
-        for (auto& [_, node] : order_index_) {
-            order_pool_.destroy(node);
-        }
+        // Orders are trivially destructible; just reset the store
+        orders_.clear();
         order_index_.clear();
         bids_.clear();
         asks_.clear();
+        total_bid_quantity_ = 0;
+        total_ask_quantity_ = 0;
+        stops_.clear();
+        last_trade_price_ = INVALID_PRICE;
     }
 
     [[nodiscard]] const Symbol& symbol() const noexcept { return symbol_; }
@@ -302,52 +349,324 @@ public:
     [[nodiscard]] bool empty() const noexcept { return order_index_.empty(); }
 
 private:
+    // Entry point bodies; the public wrappers flush batching sinks once
+    template<typename Sink>
+    bool add_order_impl(const Order& order, Sink& sink) {
+        if (order.order_id == INVALID_ORDER_ID) {
+            reject_order(order, sink);
+            return false;
+        }
+
+        // Limit prices must fall on the book's price grid (ladder books only)
+        if (has_limit_price(order.type) && !accepts_price(order.side, order.price)) {
+            reject_order(order, sink);
+            return false;
+        }
+        if (order.is_stop() && order.stop_price <= 0) {
+            reject_order(order, sink);
+            return false;
+        }
+
+        // Only the remainder rests, but reject up front if it could not
+        if (orders_.full()) {
+            reject_order(order, sink);
+            return false;
+        }
+
+        // Send NEW execution report
+        if (sink_enabled(sink)) {
+            sink(ExecutionReport::make_new(order));
+        }
+
+        // Stops wait in the trigger table (and fire at once if already through)
+        if (order.is_stop()) {
+            stops_.add(order);
+        } else {
+            execute_order(order, sink);
+        }
+        run_stops(sink);
+        return true;
+    }
+
     /**
-     * @brief Match a buy order against asks
+     * @brief Match an accepted order by its time in force, then rest or cancel the remainder
      */
-    void match_buy_order(OrderNode* aggressor, ExecutionCallback exec_callback) {
-        while (!asks_.empty() && aggressor->order.remaining_quantity() > 0) {
-            auto it = asks_.begin();
-            Price best_price = it->first;
-            PriceLevel& level = it->second;
+    template<typename Sink>
+    void execute_order(const Order& order, Sink& sink) {
+        // The aggressor stays off the store
+        Order incoming = order;
+        if (incoming.type == OrderType::FILL_OR_KILL && !can_fill(incoming)) {
+            // Killed without touching the book
+        } else if (incoming.type != OrderType::POST_ONLY) {
+            match_order(incoming, sink);
+        }
+
+        // IOC/FOK never rest, and a market order priced off the grid cannot;
+        // cancel the remainder
+        if (incoming.remaining_quantity() > 0 && incoming.is_active() &&
+            (incoming.type == OrderType::IMMEDIATE_OR_CANCEL ||
+             incoming.type == OrderType::FILL_OR_KILL ||
+             !accepts_price(incoming.side, incoming.price))) {
+            incoming.cancel();
+            if (sink_enabled(sink)) {
+                sink(ExecutionReport::make_cancel(incoming));
+            }
+        }
+
+        // If order still has remaining quantity, add to book
+        if (incoming.remaining_quantity() > 0 && incoming.is_active()) {
+            rest_order(incoming);
+        }
+    }
+
+    /**
+     * @brief Fire every stop the last trade price has reached
+     * 
+     * Fired stops can trade and trigger further stops; the loop runs until
+     * none is left at the current last trade price.
+     */
+    template<typename Sink>
+    void run_stops(Sink& sink) {
+        if (stops_.empty() || last_trade_price_ == INVALID_PRICE) return;
+        while (auto stop = stops_.pop_triggered(last_trade_price_)) {
+            Order fired = *stop;
+            if (fired.type == OrderType::STOP) {
+                // Stop-market: take whatever is there, never rest
+                fired.type = OrderType::IMMEDIATE_OR_CANCEL;
+                fired.price = fired.side == Side::BUY ? std::numeric_limits<Price>::max() : 0;
+            } else {
+                fired.type = OrderType::LIMIT;
+            }
+            fired.update_time = now();
+            execute_order(fired, sink);
+        }
+    }
+
+    /**
+     * @brief Can the visible liquidity at or better than the order's price fill it
+     * 
+     * Sums level aggregates only, so hidden iceberg reserves do not count.
+     */
+    [[nodiscard]] bool can_fill(const Order& order) const noexcept {
+        const Quantity needed = order.remaining_quantity();
+        Quantity available = 0;
+        auto add = [&](const PriceLevel& level) {
+            if (order.side == Side::BUY ? level.price() > order.price : level.price() < order.price) {
+                return false;
+            }
+            available += level.total_quantity();
+            return available < needed;
+        };
+        if (order.side == Side::BUY) {
+            asks_.for_each_level(add);
+        } else {
+            bids_.for_each_level(add);
+        }
+        return available >= needed;
+    }
+
+    [[nodiscard]] static constexpr bool has_limit_price(OrderType type) noexcept {
+        return type != OrderType::MARKET && type != OrderType::STOP;
+    }
+
+    template<typename Sink>
+    bool cancel_order_impl(OrderId order_id, Sink& sink) {
+        const OrderSlot slot = order_index_.find(order_id);
+        if (slot == NO_ORDER_SLOT) {
+            return cancel_stop(order_id, sink);
+        }
+        
+        // Send cancel report
+        if (sink_enabled(sink)) {
+            Order cancelled = orders_.to_order(slot);
+            cancelled.cancel();
+            sink(ExecutionReport::make_cancel(cancelled));
+        }
+
+        // Remove from book
+        remove_from_book(slot);
+        
+        // Remove from index and store
+        order_index_.erase(order_id);
+        orders_.release(slot);
+
+        return true;
+    }
+
+    template<typename Sink>
+    bool cancel_stop(OrderId order_id, Sink& sink) {
+        if (stops_.empty()) return false;
+        auto stop = stops_.remove(order_id);
+        if (!stop) return false;
+        if (sink_enabled(sink)) {
+            stop->cancel();
+            sink(ExecutionReport::make_cancel(*stop));
+        }
+        return true;
+    }
+
+    template<typename Sink>
+    bool modify_order_impl(OrderId order_id, Price new_price, Quantity new_quantity, Sink& sink) {
+        const OrderSlot slot = order_index_.find(order_id);
+        if (slot == NO_ORDER_SLOT) {
+            return false;
+        }
+        if (new_quantity <= 0) {
+            return cancel_order_impl(order_id, sink);
+        }
+
+        RestingOrder& order = orders_[slot];
+        OrderInfo& info = orders_.info(slot);
+        const Side side = info.side;
+        if (new_price != info.price && !accepts_price(side, new_price)) {
+            return false;
+        }
+        info.update_time = now();
+
+        // Same price and no larger: shrink in place (hidden reserve first),
+        // priority kept
+        const Quantity visible = order.remaining_quantity();
+        const Quantity open = visible + info.reserve_quantity;
+        if (new_price == info.price && new_quantity <= open) {
+            const Quantity from_reserve = std::min(open - new_quantity, info.reserve_quantity);
+            info.reserve_quantity -= from_reserve;
+            const Quantity from_visible = open - new_quantity - from_reserve;
+            if (from_visible > 0) {
+                PriceLevel& level = side == Side::BUY ? *bids_.find(info.price)
+                                                      : *asks_.find(info.price);
+                level.reduce_order(orders_, slot, from_visible);
+                side_total(side) -= from_visible;
+                publish_level(side, level);
+            }
+            if (sink_enabled(sink)) {
+                sink(ExecutionReport::make_replace(orders_.to_order(slot)));
+            }
+            return true;
+        }
+
+        // Otherwise unlink the node (slot and index entry stay) and requeue it
+        remove_from_book(slot);
+        orders_.set_open_quantity(slot, new_quantity);
+        info.price = new_price;
+        if (sink_enabled(sink)) {
+            sink(ExecutionReport::make_replace(orders_.to_order(slot)));
+        }
+
+        if (info.type != OrderType::POST_ONLY && crosses(side, new_price)) {
+            Order aggressor = orders_.to_order(slot);
+            match_order(aggressor, sink);
+            if (aggressor.is_filled()) {
+                order_index_.erase(order_id);
+                orders_.release(slot);
+                run_stops(sink);
+                return true;
+            }
+            order.filled_quantity = aggressor.filled_quantity;
+            orders_.set_open_quantity(slot, aggressor.remaining_quantity());
+        }
+
+        PriceLevel& level = side == Side::BUY ? bids_.get_or_create(new_price)
+                                              : asks_.get_or_create(new_price);
+        level.add_order(orders_, slot);
+        side_total(side) += order.remaining_quantity();
+        publish_level(side, level);
+        run_stops(sink);
+        return true;
+    }
+
+    /**
+     * @brief Reject an order before it reaches the book
+     */
+    template<typename Sink>
+    static void reject_order(const Order& order, Sink& sink) {
+        if (sink_enabled(sink)) {
+            Order rejected = order;
+            rejected.reject();
+            sink(ExecutionReport::make_cancel(rejected));
+        }
+    }
+
+    [[nodiscard]] bool accepts_price(Side side, Price price) const noexcept {
+        return side == Side::BUY ? bids_.accepts(price) : asks_.accepts(price);
+    }
+
+    /**
+     * @brief Would an order on side at price trade against the book
+     */
+    [[nodiscard]] bool crosses(Side side, Price price) const noexcept {
+        if (side == Side::BUY) {
+            const PriceLevel* best = asks_.best();
+            return best && price >= best->price();
+        }
+        const PriceLevel* best = bids_.best();
+        return best && price <= best->price();
+    }
+
+    /**
+     * @brief Match an aggressor against resting orders at one price level
+     * 
+     * Reads only the hot RestingOrder array unless a report is built.
+     */
+    template<typename Sink>
+    void match_level(Order& aggressor, PriceLevel& level, Sink& sink) {
+        const Price exec_price = level.price();
+        while (!level.empty() && aggressor.remaining_quantity() > 0) {
+            const OrderSlot slot = level.front();
+            RestingOrder& passive = orders_[slot];
             
-            // Check if prices cross
-            if (aggressor->order.price < best_price) break;
+            Quantity fill_qty = std::min(
+                aggressor.remaining_quantity(),
+                passive.remaining_quantity()
+            );
             
-            // Match against orders at this level
-            while (!level.empty() && aggressor->order.remaining_quantity() > 0) {
-                OrderNode* passive = level.front();
-                
-                Quantity fill_qty = std::min(
-                    aggressor->order.remaining_quantity(),
-                    passive->order.remaining_quantity()
-                );
-                
-                Price exec_price = passive->order.price;
-                
-                aggressor->order.fill(fill_qty);
-                passive->order.fill(fill_qty);
-                level.update_quantity(passive, fill_qty);
-                
-                if (exec_callback) {
-                    exec_callback(ExecutionReport::make_trade(
-                        aggressor->order, passive->order, exec_price, fill_qty));
-                    exec_callback(ExecutionReport::make_trade(
-                        passive->order, aggressor->order, exec_price, fill_qty));
-                }
-                
-                ++trades_matched_;
-                volume_matched_ += fill_qty;
-                
-                if (passive->order.is_filled()) {
-                    level.pop_front();
-                    order_index_.erase(passive->order.order_id);
-                    order_pool_.destroy(passive);
+            aggressor.fill(fill_qty);
+            passive.filled_quantity += fill_qty;
+            level.update_quantity(fill_qty);
+            side_total(opposite(aggressor.side)) -= fill_qty;
+            
+            if (sink_enabled(sink)) {
+                orders_.info(slot).update_time = aggressor.update_time;
+                const Order contra = orders_.to_order(slot);
+                sink(ExecutionReport::make_trade(
+                    aggressor, contra, exec_price, fill_qty));
+                sink(ExecutionReport::make_trade(
+                    contra, aggressor, exec_price, fill_qty));
+            }
+            
+            ++trades_matched_;
+            volume_matched_ += fill_qty;
+            last_trade_price_ = exec_price;
+            
+            if (passive.is_filled()) {
+                level.pop_front(orders_);
+                if (const Quantity slice = orders_.replenish(slot); slice > 0) {
+                    // Next iceberg slice joins the back of the queue
+                    level.add_order(orders_, slot);
+                    side_total(opposite(aggressor.side)) += slice;
+                } else {
+                    order_index_.erase(passive.order_id);
+                    orders_.release(slot);
                 }
             }
+        }
+    }
+
+    /**
+     * @brief Match a buy order against asks
+     */
+    template<typename Sink>
+    void match_buy_order(Order& aggressor, Sink& sink) {
+        while (aggressor.remaining_quantity() > 0) {
+            PriceLevel* level = asks_.best();
+            
+            // Check if prices cross
+            if (!level || aggressor.price < level->price()) break;
+            
+            match_level(aggressor, *level, sink);
+            publish_level(Side::SELL, *level);
             
-            if (level.empty()) {
-                asks_.erase(it);
+            if (level->empty()) {
+                asks_.remove_level(*level);
             }
         }
     }
@@ -355,49 +674,19 @@ private:
     /**
      * @brief Match a sell order against bids
      */
-    void match_sell_order(OrderNode* aggressor, ExecutionCallback exec_callback) {
-        while (!bids_.empty() && aggressor->order.remaining_quantity() > 0) {
-            auto it = bids_.begin();
-            Price best_price = it->first;
-            PriceLevel& level = it->second;
+    template<typename Sink>
+    void match_sell_order(Order& aggressor, Sink& sink) {
+        while (aggressor.remaining_quantity() > 0) {
+            PriceLevel* level = bids_.best();
             
             // Check if prices cross
-            if (aggressor->order.price > best_price) break;
+            if (!level || aggressor.price > level->price()) break;
             
-            // Match against orders at this level
-            while (!level.empty() && aggressor->order.remaining_quantity() > 0) {
-                OrderNode* passive = level.front();
-                
-                Quantity fill_qty = std::min(
-                    aggressor->order.remaining_quantity(),
-                    passive->order.remaining_quantity()
-                );
-                
-                Price exec_price = passive->order.price;
-                
-                aggressor->order.fill(fill_qty);
-                passive->order.fill(fill_qty);
-                level.update_quantity(passive, fill_qty);
-                
-                if (exec_callback) {
-                    exec_callback(ExecutionReport::make_trade(
-                        aggressor->order, passive->order, exec_price, fill_qty));
-                    exec_callback(ExecutionReport::make_trade(
-                        passive->order, aggressor->order, exec_price, fill_qty));
-                }
-                
-                ++trades_matched_;
-                volume_matched_ += fill_qty;
-                
-                if (passive->order.is_filled()) {
-                    level.pop_front();
-                    order_index_.erase(passive->order.order_id);
-                    order_pool_.destroy(passive);
-                }
-            }
+            match_level(aggressor, *level, sink);
+            publish_level(Side::BUY, *level);
             
-            if (level.empty()) {
-                bids_.erase(it);
+            if (level->empty()) {
+                bids_.remove_level(*level);
             }
         }
     }
@@ -405,68 +694,94 @@ private:
     /**
      * @brief Match an incoming order against the book
      */
-    void match_order(OrderNode* aggressor, ExecutionCallback exec_callback) {
-        if (aggressor->order.side == Side::BUY) {
-            match_buy_order(aggressor, exec_callback);
+    template<typename Sink>
+    void match_order(Order& aggressor, Sink& sink) {
+        if (aggressor.side == Side::BUY) {
+            match_buy_order(aggressor, sink);
         } else {
-            match_sell_order(aggressor, exec_callback);
+            match_sell_order(aggressor, sink);
         }
     }
 
     /**
-     * @brief Add order to the appropriate side of the book
+     * @brief Store, index and queue the resting remainder of an order
+     * @return false if the store is full
      */
-    void add_to_book(OrderNode* node) {
-        if (node->order.side == Side::BUY) {
-            auto [it, inserted] = bids_.try_emplace(node->order.price, node->order.price);
-            it->second.add_order(node);
-        } else {
-            auto [it, inserted] = asks_.try_emplace(node->order.price, node->order.price);
-            it->second.add_order(node);
+    bool rest_order(const Order& order) {
+        const OrderSlot slot = orders_.allocate(order);
+        if (slot == NO_ORDER_SLOT) {
+            return false;
         }
+        order_index_.insert(order.order_id, slot);
+        PriceLevel& level = order.side == Side::BUY ? bids_.get_or_create(order.price)
+                                                    : asks_.get_or_create(order.price);
+        level.add_order(orders_, slot);
+        side_total(order.side) += orders_[slot].remaining_quantity();
+        publish_level(order.side, level);
+        return true;
     }
 
     /**
      * @brief Remove order from the book
      */
-    void remove_from_book(OrderNode* node) {
-        if (node->order.side == Side::BUY) {
-            auto it = bids_.find(node->order.price);
-            if (it != bids_.end()) {
-                it->second.remove_order(node);
-                if (it->second.empty()) {
-                    bids_.erase(it);
-                }
-            }
+    void remove_from_book(OrderSlot slot) {
+        const OrderInfo& info = orders_.info(slot);
+        if (info.side == Side::BUY) {
+            remove_from_side(bids_, info.price, slot);
         } else {
-            auto it = asks_.find(node->order.price);
-            if (it != asks_.end()) {
-                it->second.remove_order(node);
-                if (it->second.empty()) {
-                    asks_.erase(it);
-                }
+            remove_from_side(asks_, info.price, slot);
+        }
+    }
+
+    template<Side S>
+    void remove_from_side(BookSide<S>& side, Price price, OrderSlot slot) {
+        if (PriceLevel* level = side.find(price)) {
+            side_total(S) -= orders_[slot].remaining_quantity();
+            level->remove_order(orders_, slot);
+            publish_level(S, *level);
+            if (level->empty()) {
+                side.remove_level(*level);
             }
         }
     }
 
-    /**
-     * @brief Update quantity tracking at a price level
-     */
-    void update_level_quantity(Side side, Price price) {
-        // Quantity is tracked in PriceLevel, this triggers recalculation if needed
-        (void)side;
-        (void)price;
+    [[nodiscard]] Quantity& side_total(Side side) noexcept {
+        return side == Side::BUY ? total_bid_quantity_ : total_ask_quantity_;
+    }
+
+    [[nodiscard]] static constexpr Side opposite(Side side) noexcept {
+        return side == Side::BUY ? Side::SELL : Side::BUY;
+    }
+
+    void publish_level(Side side, const PriceLevel& level) noexcept {
+        if (!deltas_) return;
+        const BookDelta delta{++delta_sequence_, level.price(), level.total_quantity(),
+                              static_cast<std::uint32_t>(level.order_count()), side, {}};
+        if (!deltas_->try_push(delta)) {
+            ++deltas_dropped_;
+        }
     }
 
     Symbol symbol_;
-    BidMap bids_;
-    AskMap asks_;
-    std::unordered_map<OrderId, OrderNode*> order_index_;
-    MemoryPool<OrderNode, MAX_ORDERS> order_pool_;
+    BookSide<Side::BUY> bids_;
+    BookSide<Side::SELL> asks_;
+    OrderIndex<MAX_ORDERS> order_index_;
+    OrderStore orders_;
     
     // Statistics
     std::uint64_t trades_matched_ = 0;
     Quantity volume_matched_ = 0;
+    
+    // Maintained on every level change, so stats and deltas need no walk
+    Quantity total_bid_quantity_ = 0;
+    Quantity total_ask_quantity_ = 0;
+    BookDeltaRing* deltas_ = nullptr;
+    
+    // Conditional orders
+    StopTable stops_;
+    Price last_trade_price_ = INVALID_PRICE;
+    std::uint64_t delta_sequence_ = 0;
+    std::uint64_t deltas_dropped_ = 0;
 };
 
 } // namespace hft
@@ -0,0 +1,159 @@
+/**
+ * @file order_index.hpp
+ * @brief Preallocated open-addressing index from order ID to order slot
+ *
+ * Replaces std::unordered_map<OrderId, OrderSlot> on the matching hot path:
+ * - Flat slot array sized once from the book's order capacity
+ * - Linear probing with Fibonacci hashing (sequential IDs spread evenly)
+ * - Backward-shift deletion: no tombstones, probe lengths stay short
+ *   under cancel-heavy flow
+ * - No allocation on insert or erase
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include "order.hpp"
+#include "core/types.hpp"
+
+namespace hft {
+
+/**
+ * @brief Fixed-capacity hash index OrderId -> OrderSlot
+ *
+ * @tparam MaxEntries Maximum live entries (table is kept at most half full)
+ *
+ * INVALID_ORDER_ID (0) marks an empty slot and cannot be stored.
+ */
+template<std::size_t MaxEntries>
+class OrderIndex {
+    static_assert(MaxEntries > 0, "MaxEntries must be positive");
+
+    static constexpr std::size_t SLOT_COUNT = std::bit_ceil(MaxEntries * 2);
+    static constexpr std::size_t MASK = SLOT_COUNT - 1;
+    static constexpr int SHIFT = 64 - std::countr_zero(SLOT_COUNT);
+
+    struct Slot {
+        OrderId key;
+        OrderSlot value;
+    };
+
+public:
+    // calloc'd so the table starts empty (key == 0) without touching every
+    // page up front; untouched pages are mapped lazily by the kernel
+    OrderIndex()
+        : slots_(static_cast<Slot*>(std::calloc(SLOT_COUNT, sizeof(Slot))))
+    {
+        if (!slots_) throw std::bad_alloc();
+    }
+
+    // Non-copyable
+    OrderIndex(const OrderIndex&) = delete;
+    OrderIndex& operator=(const OrderIndex&) = delete;
+
+    /**
+     * @brief Look up an order's slot
+     * @return Slot, or NO_ORDER_SLOT if not indexed
+     */
+    [[nodiscard]] OrderSlot find(OrderId id) const noexcept {
+        if (id == INVALID_ORDER_ID) return NO_ORDER_SLOT;
+        for (std::size_t i = home(id);; i = (i + 1) & MASK) {
+            const Slot& slot = slots_[i];
+            if (slot.key == id) return slot.value;
+            if (slot.key == INVALID_ORDER_ID) return NO_ORDER_SLOT;
+        }
+    }
+
+    /**
+     * @brief Insert or overwrite the slot for an order ID
+     * @return false if id is INVALID_ORDER_ID or the index is full
+     */
+    bool insert(OrderId id, OrderSlot value) noexcept {
+        if (id == INVALID_ORDER_ID) return false;
+        for (std::size_t i = home(id);; i = (i + 1) & MASK) {
+            Slot& slot = slots_[i];
+            if (slot.key == id) {
+                slot.value = value;
+                return true;
+            }
+            if (slot.key == INVALID_ORDER_ID) {
+                if (size_ >= MaxEntries) return false;
+                slot.key = id;
+                slot.value = value;
+                ++size_;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Remove an order ID
+     * @return true if it was present
+     */
+    bool erase(OrderId id) noexcept {
+        if (id == INVALID_ORDER_ID) return false;
+        std::size_t hole = home(id);
+        while (slots_[hole].key != id) {
+            if (slots_[hole].key == INVALID_ORDER_ID) return false;
+            hole = (hole + 1) & MASK;
+        }
+
+        // Backward-shift: pull later entries of the probe run into the hole
+        // unless that would move them before their home slot
+        for (std::size_t i = (hole + 1) & MASK; slots_[i].key != INVALID_ORDER_ID; i = (i + 1) & MASK) {
+            const std::size_t h = home(slots_[i].key);
+            if (((i - h) & MASK) >= ((i - hole) & MASK)) {
+                slots_[hole] = slots_[i];
+                hole = i;
+            }
+        }
+        slots_[hole].key = INVALID_ORDER_ID;
+        slots_[hole].value = NO_ORDER_SLOT;
+        --size_;
+        return true;
+    }
+
+    /**
+     * @brief Visit every indexed (id, slot) pair in unspecified order
+     */
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        if (size_ == 0) return;
+        for (std::size_t i = 0; i < SLOT_COUNT; ++i) {
+            if (slots_[i].key != INVALID_ORDER_ID) {
+                fn(slots_[i].key, slots_[i].value);
+            }
+        }
+    }
+
+    void clear() noexcept {
+        if (size_ == 0) return;
+        for (std::size_t i = 0; i < SLOT_COUNT; ++i) {
+            slots_[i] = Slot{INVALID_ORDER_ID, NO_ORDER_SLOT};
+        }
+        size_ = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return MaxEntries; }
+
+private:
+    [[nodiscard]] static std::size_t home(OrderId id) noexcept {
+        return static_cast<std::size_t>((id * 0x9E3779B97F4A7C15ULL) >> SHIFT);
+    }
+
+    struct FreeDeleter {
+        void operator()(Slot* ptr) const { std::free(ptr); }
+    };
+
+    std::unique_ptr<Slot[], FreeDeleter> slots_;
+    std::size_t size_ = 0;
+};
+
+} // namespace hft
@@ -2,9 +2,10 @@
  * @file price_level.hpp
  * @brief Price level for order book - manages orders at a single price
  * 
- * Uses an intrusive doubly-linked list for O(1) order operations:
+ * Uses an intrusive doubly-linked list of OrderStore slots for O(1) order
+ * operations:
  * - Add order to back: O(1)
- * - Remove order by pointer: O(1)
+ * - Remove order by slot: O(1)
  * - Get front order: O(1)
  */
 
@@ -12,22 +13,23 @@
 
 #include <cstddef>
 #include "order.hpp"
-#include "core/memory_pool.hpp"
+#include "order_store.hpp"
 
 namespace hft {
 
 /**
  * @brief Price level containing orders at a single price point
  * 
- * Orders are maintained in FIFO order (time priority).
+ * Orders are maintained in FIFO order (time priority). The links live in
+ * the book's OrderStore, which every linking operation takes.
  * All operations are O(1).
  */
 class PriceLevel {
 public:
     explicit PriceLevel(Price price) noexcept
         : price_(price)
-        , head_(nullptr)
-        , tail_(nullptr)
+        , head_(NO_ORDER_SLOT)
+        , tail_(NO_ORDER_SLOT)
         , total_quantity_(0)
         , order_count_(0)
     {}
@@ -43,8 +45,8 @@ public:
         , total_quantity_(other.total_quantity_)
         , order_count_(other.order_count_)
     {
-        other.head_ = nullptr;
-        other.tail_ = nullptr;
+        other.head_ = NO_ORDER_SLOT;
+        other.tail_ = NO_ORDER_SLOT;
         other.total_quantity_ = 0;
         other.order_count_ = 0;
     }
@@ -56,8 +58,8 @@ public:
             tail_ = other.tail_;
             total_quantity_ = other.total_quantity_;
             order_count_ = other.order_count_;
-            other.head_ = nullptr;
-            other.tail_ = nullptr;
+            other.head_ = NO_ORDER_SLOT;
+            other.tail_ = NO_ORDER_SLOT;
             other.total_quantity_ = 0;
             other.order_count_ = 0;
         }
@@ -66,126 +68,102 @@ public:
 
     /**
      * @brief Add an order to the back of the queue
-     * @param node Order node (must be allocated externally)
+     * @param slot Order slot (allocated from store by the book)
      */
-    void add_order(OrderNode* node) noexcept {
-        node->prev = tail_;
-        node->next = nullptr;
+    void add_order(OrderStore& store, OrderSlot slot) noexcept {
+        RestingOrder& order = store[slot];
+        order.prev = tail_;
+        order.next = NO_ORDER_SLOT;
         
-        if (tail_) {
-            tail_->next = node;
+        if (tail_ != NO_ORDER_SLOT) {
+            store[tail_].next = slot;
         } else {
-            head_ = node;
+            head_ = slot;
         }
-        tail_ = node;
+        tail_ = slot;
         
-        total_quantity_ += node->order.remaining_quantity();
+        total_quantity_ += order.remaining_quantity();
         ++order_count_;
     }
 
     /**
      * @brief Remove an order from the queue
-     * @param node Order node to remove
+     * @param slot Order slot to remove
      */
-    void remove_order(OrderNode* node) noexcept {
-        total_quantity_ -= node->order.remaining_quantity();
+    void remove_order(OrderStore& store, OrderSlot slot) noexcept {
+        RestingOrder& order = store[slot];
+        total_quantity_ -= order.remaining_quantity();
         --order_count_;
         
-        if (node->prev) {
-            node->prev->next = node->next;
+        if (order.prev != NO_ORDER_SLOT) {
+            store[order.prev].next = order.next;
         } else {
-            head_ = node->next;
+            head_ = order.next;
         }
         
-        if (node->next) {
-            node->next->prev = node->prev;
+        if (order.next != NO_ORDER_SLOT) {
+            store[order.next].prev = order.prev;
         } else {
-            tail_ = node->prev;
+            tail_ = order.prev;
         }
         
-        node->prev = nullptr;
-        node->next = nullptr;
+        order.prev = NO_ORDER_SLOT;
+        order.next = NO_ORDER_SLOT;
     }
 
     /**
-     * @brief Get the first order in the queue
+     * @brief Slot of the first order in the queue (NO_ORDER_SLOT if empty)
      */
-    [[nodiscard]] OrderNode* front() noexcept {
-        return head_;
-    }
-    
-    [[nodiscard]] const OrderNode* front() const noexcept {
+    [[nodiscard]] OrderSlot front() const noexcept {
         return head_;
     }
 
     /**
-     * @brief Pop and return the first order
+     * @brief Pop and return the first order's slot
      */
-    OrderNode* pop_front() noexcept {
-        if (!head_) return nullptr;
+    OrderSlot pop_front(OrderStore& store) noexcept {
+        if (head_ == NO_ORDER_SLOT) return NO_ORDER_SLOT;
         
-        OrderNode* node = head_;
-        remove_order(node);
-        return node;
+        const OrderSlot slot = head_;
+        remove_order(store, slot);
+        return slot;
+    }
+
+    /**
+     * @brief Shrink a queued order in place, keeping its position
+     */
+    void reduce_order(OrderStore& store, OrderSlot slot, Quantity reduce_by) noexcept {
+        store[slot].quantity -= reduce_by;
+        total_quantity_ -= reduce_by;
     }
 
     /**
      * @brief Update quantity after partial fill
      */
-    void update_quantity(OrderNode* /* node */, Quantity filled) noexcept {
+    void update_quantity(Quantity filled) noexcept {
         total_quantity_ -= filled;
     }
 
-    // Accessors
-    [[nodiscard]] Price price() const noexcept { return price_; }
-    [[nodiscard]] Quantity total_quantity() const noexcept { return total_quantity_; }
-    [[nodiscard]] std::size_t order_count() const noexcept { return order_count_; }
-    [[nodiscard]] bool empty() const noexcept { return head_ == nullptr; }
-
     /**
-     * @brief Iterator for traversing orders at this price level
+     * @brief Visit order slots front to back
      */
-    class Iterator {
-    public:
-        using value_type = OrderNode;
-        using pointer = OrderNode*;
-        using reference = OrderNode&;
-
-        explicit Iterator(OrderNode* node = nullptr) noexcept : node_(node) {}
-
-        reference operator*() const noexcept { return *node_; }
-        pointer operator->() const noexcept { return node_; }
-
-        Iterator& operator++() noexcept {
-            node_ = node_->next;
-            return *this;
-        }
-
-        Iterator operator++(int) noexcept {
-            Iterator tmp = *this;
-            ++(*this);
-            return tmp;
-        }
-
-        bool operator==(const Iterator& other) const noexcept {
-            return node_ == other.node_;
-        }
-
-        bool operator!=(const Iterator& other) const noexcept {
-            return node_ != other.node_;
+    template<typename Fn>
+    void for_each_slot(const OrderStore& store, Fn&& fn) const {
+        for (OrderSlot slot = head_; slot != NO_ORDER_SLOT; slot = store[slot].next) {
+            fn(slot);
         }
+    }
 
-    private:
-        OrderNode* node_;
-    };
-
-    [[nodiscard]] Iterator begin() noexcept { return Iterator(head_); }
-    [[nodiscard]] Iterator end() noexcept { return Iterator(nullptr); }
+    // Accessors
+    [[nodiscard]] Price price() const noexcept { return price_; }
+    [[nodiscard]] Quantity total_quantity() const noexcept { return total_quantity_; }
+    [[nodiscard]] std::size_t order_count() const noexcept { return order_count_; }
+    [[nodiscard]] bool empty() const noexcept { return head_ == NO_ORDER_SLOT; }
 
 private:
     Price price_;
-    OrderNode* head_;
-    OrderNode* tail_;
+    OrderSlot head_;
+    OrderSlot tail_;
     Quantity total_quantity_;
     std::size_t order_count_;
 };
@@ -0,0 +1,304 @@
+/**
+ * @file sharded_matching_engine.hpp
+ * @brief Multi-core matching engine with symbol-partitioned worker threads
+ *
+ * Each shard owns a private MatchingEngine (and therefore a disjoint set
+ * of order books) driven by one worker thread, optionally pinned to a core.
+ * Books stay single-writer, so no locks are needed on the matching path:
+ *
+ *   producer 0 ──lane──┐            ┌──> shard 0 worker ──reports──> consumer
+ *   producer 1 ──lane──┼─> router ──┤
+ *   producer N ──lane──┘            └──> shard K worker ──reports──> consumer
+ *
+ * - One SPSC lane per (producer, shard) pair: producers never contend
+ * - One SPSC output queue per shard for execution reports
+ * - Instruments are assigned to shards round-robin at setup time
+ * - Shard i hands out order IDs starting at (i << ORDER_ID_SHARD_SHIFT) + 1,
+ *   so IDs are unique across the whole engine
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "matching_engine.hpp"
+#include "core/busy_poll.hpp"
+#include "core/cpu_affinity.hpp"
+#include "core/lockfree_queue.hpp"
+#include "core/memory_region.hpp"
+#include "core/tsc_clock.hpp"
+#include "core/types.hpp"
+
+namespace hft {
+
+/**
+ * @brief Sharded engine layout
+ */
+struct ShardedEngineConfig {
+    std::size_t num_shards = 1;
+    std::size_t num_producers = 1;
+    std::vector<int> cpu_cores;     // Core per shard; missing/negative = unpinned
+    // How an idle shard waits for requests; parking (ADAPTIVE/RELAXED) is opt-in
+    IdleStrategy::Config idle = IdleStrategy::config_for(PollMode::BALANCED);
+    MemoryPolicy memory = default_memory_policy();  // Books, lanes and report queues;
+                                                    // NUMA_LOCAL = node of the shard's core
+};
+
+/**
+ * @brief Where an instrument lives: its shard and shard-local handle
+ */
+struct ShardRoute {
+    std::uint32_t shard;
+    InstrumentId instrument;
+};
+
+/**
+ * @brief Matching engine partitioned across worker threads by instrument
+ *
+ * Setup (add_instrument) must happen before start(). After start(),
+ * producer p may only call submit() with producer index p from a single
+ * thread, and each shard's reports must be drained by a single thread.
+ */
+class ShardedMatchingEngine {
+    static constexpr std::size_t LANE_SIZE = 8192;
+    static constexpr std::size_t REPORT_QUEUE_SIZE = 65536;
+    static constexpr std::size_t LANE_BATCH = 64;   // Max requests per lane per pass
+
+public:
+    static constexpr int ORDER_ID_SHARD_SHIFT = 48;
+
+    using RequestLane = SPSCQueue<OrderRequest, LANE_SIZE>;
+    using ReportQueue = SPSCQueue<ExecutionReport, REPORT_QUEUE_SIZE>;
+
+    explicit ShardedMatchingEngine(const ShardedEngineConfig& config = {})
+        : num_producers_(config.num_producers == 0 ? 1 : config.num_producers)
+    {
+        const std::size_t num_shards = config.num_shards == 0 ? 1 : config.num_shards;
+        shards_.reserve(num_shards);
+        for (std::size_t i = 0; i < num_shards; ++i) {
+            const int core = i < config.cpu_cores.size() ? config.cpu_cores[i] : -1;
+            MemoryPolicy memory = config.memory;
+            if (memory.numa_node == MemoryPolicy::NUMA_LOCAL && core >= 0) {
+                memory.numa_node = numa_node_of_cpu(core);
+            }
+            shards_.push_back(std::make_unique<Shard>(i, num_producers_, core, memory, config.idle));
+        }
+    }
+
+    ~ShardedMatchingEngine() {
+        stop();
+    }
+
+    // Non-copyable
+    ShardedMatchingEngine(const ShardedMatchingEngine&) = delete;
+    ShardedMatchingEngine& operator=(const ShardedMatchingEngine&) = delete;
+
+    /**
+     * @brief Register an instrument on the next shard (setup only)
+     * @return Route to cache for submit(), or nullopt if already added
+     */
+    std::optional<ShardRoute> add_instrument(const Symbol& symbol,
+                                             const OrderBookConfig& config = {}) {
+        if (routes_.count(symbol)) return std::nullopt;
+
+        const auto shard = static_cast<std::uint32_t>(routes_.size() % shards_.size());
+        auto local = shards_[shard]->engine.add_instrument(symbol, config, shards_[shard]->memory);
+        if (!local) return std::nullopt;
+
+        ShardRoute route{shard, *local};
+        routes_.emplace(symbol, route);
+        return route;
+    }
+
+    /**
+     * @brief Look up an instrument's route
+     */
+    [[nodiscard]] std::optional<ShardRoute> route(const Symbol& symbol) const {
+        auto it = routes_.find(symbol);
+        if (it == routes_.end()) return std::nullopt;
+        return it->second;
+    }
+
+    void start() {
+        TscClock::instance();   // Calibrate before the workers pin themselves
+        for (auto& shard : shards_) {
+            shard->running.store(true, std::memory_order_release);
+            shard->worker = std::thread([s = shard.get()] { run(*s); });
+        }
+    }
+
+    /**
+     * @brief Stop all workers after they drain their request lanes
+     */
+    void stop() {
+        for (auto& shard : shards_) {
+            shard->running.store(false, std::memory_order_release);
+            shard->wake.notify();
+        }
+        for (auto& shard : shards_) {
+            if (shard->worker.joinable()) {
+                shard->worker.join();
+            }
+        }
+    }
+
+    /**
+     * @brief Submit a request on a known route (producer hot path)
+     * @return false if the lane is full
+     */
+    bool submit(std::size_t producer, const ShardRoute& route, OrderRequest request) {
+        request.instrument = route.instrument;
+        Shard& shard = *shards_[route.shard];
+        if (!shard.lanes[producer]->try_push(request)) return false;
+        shard.wake.notify();
+        return true;
+    }
+
+    /**
+     * @brief Submit a request routed by request.symbol
+     * @return false if the symbol is unknown or the lane is full
+     */
+    bool submit(std::size_t producer, const OrderRequest& request) {
+        auto r = route(request.symbol);
+        return r && submit(producer, *r, request);
+    }
+
+    /**
+     * @brief Pop one execution report from a shard (one consumer per shard)
+     */
+    [[nodiscard]] std::optional<ExecutionReport> poll_report(std::size_t shard) {
+        return shards_[shard]->reports->try_pop();
+    }
+
+    /**
+     * @brief Drain all shards' report queues
+     * @return Number of reports handed to fn
+     */
+    template<typename Fn>
+    std::size_t drain_reports(Fn&& fn) {
+        std::size_t count = 0;
+        for (auto& shard : shards_) {
+            while (auto report = shard->reports->try_pop()) {
+                fn(*report);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Requests processed by a shard so far
+     */
+    [[nodiscard]] std::uint64_t processed(std::size_t shard) const noexcept {
+        return shards_[shard]->processed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Reports discarded because the output queue was full at shutdown
+     */
+    [[nodiscard]] std::uint64_t reports_dropped(std::size_t shard) const noexcept {
+        return shards_[shard]->reports_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Shard engine access (only safe while stopped)
+     */
+    MatchingEngine& engine(std::size_t shard) { return shards_[shard]->engine; }
+    const MatchingEngine& engine(std::size_t shard) const { return shards_[shard]->engine; }
+
+    [[nodiscard]] std::size_t shard_count() const noexcept { return shards_.size(); }
+    [[nodiscard]] std::size_t producer_count() const noexcept { return num_producers_; }
+
+private:
+    struct Shard {
+        Shard(std::size_t index, std::size_t num_producers, int core, const MemoryPolicy& policy,
+              const IdleStrategy::Config& idle_config)
+            : engine((static_cast<OrderId>(index) << ORDER_ID_SHARD_SHIFT) + 1)
+            , reports(make_in_region<ReportQueue>(policy))
+            , memory(policy)
+            , cpu_core(core)
+            , idle(idle_config)
+        {
+            lanes.reserve(num_producers);
+            for (std::size_t i = 0; i < num_producers; ++i) {
+                lanes.push_back(make_in_region<RequestLane>(policy));
+            }
+        }
+
+        MatchingEngine engine;
+        std::vector<RegionPtr<RequestLane>> lanes;
+        RegionPtr<ReportQueue> reports;
+        MemoryPolicy memory;
+        std::thread worker;
+        int cpu_core;
+        IdleStrategy::Config idle;
+        WakeSignal wake;
+        std::atomic<bool> running{false};
+        std::atomic<std::uint64_t> processed{0};
+        std::atomic<std::uint64_t> reports_dropped{0};
+    };
+
+    /**
+     * @brief Take up to LANE_BATCH requests from each lane; returns count
+     */
+    static std::size_t poll_lanes(Shard& shard) {
+        // Back-pressure on the report queue while running; drop once stopping
+        // so shutdown cannot hang on a consumer that has gone away
+        auto sink = [&shard](const ExecutionReport& report) {
+            while (!shard.reports->try_push(report)) {
+                if (!shard.running.load(std::memory_order_relaxed)) {
+                    shard.reports_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                cpu_pause();
+            }
+        };
+
+        std::array<OrderRequest, LANE_BATCH> burst;
+        std::size_t count = 0;
+        for (auto& lane : shard.lanes) {
+            const std::size_t n = lane->try_pop_bulk(burst);
+            if (n > 0) {
+                shard.engine.process_batch(std::span<const OrderRequest>(burst.data(), n), sink);
+                count += n;
+            }
+        }
+        if (count) {
+            shard.processed.fetch_add(count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    static void run(Shard& shard) {
+        if (shard.cpu_core >= 0) {
+            set_cpu_affinity(shard.cpu_core);
+        }
+
+        IdleStrategy idle(shard.idle, &shard.wake);
+        while (shard.running.load(std::memory_order_acquire)) {
+            idle.idle(poll_lanes(shard), [&shard] {
+                if (!shard.running.load(std::memory_order_relaxed)) return true;
+                return std::any_of(shard.lanes.begin(), shard.lanes.end(),
+                                   [](const auto& lane) { return !lane->empty(); });
+            });
+        }
+
+        // Drain requests that raced with stop()
+        while (poll_lanes(shard) != 0) {}
+    }
+
+    std::size_t num_producers_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::unordered_map<Symbol, ShardRoute, SymbolHash> routes_;
+};
+
+} // namespace hft
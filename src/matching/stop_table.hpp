@@ -0,0 +1,111 @@
+/**
+ * @file stop_table.hpp
+ * @brief Pending STOP / STOP_LIMIT orders, indexed by trigger price
+ *
+ * Stops wait off the book until a trade prints at or through their
+ * trigger: buy stops fire when the last trade price rises to stop_price,
+ * sell stops when it falls to it. Each side is a vector sorted so that the
+ * next stop to fire is at the back, which makes the per-trade check one
+ * comparison per side and firing a pop_back. Stops with the same trigger
+ * fire in arrival order.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <vector>
+#include "order.hpp"
+#include "core/types.hpp"
+
+namespace hft {
+
+class StopTable {
+public:
+    explicit StopTable(std::size_t reserve = 1024) {
+        buys_.reserve(reserve);
+        sells_.reserve(reserve);
+    }
+
+    /**
+     * @brief Park a stop order until it triggers
+     */
+    void add(const Order& order) {
+        if (order.side == Side::BUY) {
+            // Descending trigger: the lowest (first to fire) at the back
+            auto it = std::lower_bound(buys_.begin(), buys_.end(), order.stop_price,
+                [](const Order& o, Price stop) { return o.stop_price > stop; });
+            buys_.insert(it, order);
+        } else {
+            auto it = std::lower_bound(sells_.begin(), sells_.end(), order.stop_price,
+                [](const Order& o, Price stop) { return o.stop_price < stop; });
+            sells_.insert(it, order);
+        }
+    }
+
+    /**
+     * @brief Take the next stop triggered by a trade at last_price
+     */
+    [[nodiscard]] std::optional<Order> pop_triggered(Price last_price) {
+        if (!buys_.empty() && buys_.back().stop_price <= last_price) {
+            Order order = buys_.back();
+            buys_.pop_back();
+            return order;
+        }
+        if (!sells_.empty() && sells_.back().stop_price >= last_price) {
+            Order order = sells_.back();
+            sells_.pop_back();
+            return order;
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Remove a pending stop (cancel)
+     */
+    [[nodiscard]] std::optional<Order> remove(OrderId order_id) {
+        for (auto* side : {&buys_, &sells_}) {
+            auto it = std::find_if(side->begin(), side->end(),
+                [order_id](const Order& o) { return o.order_id == order_id; });
+            if (it != side->end()) {
+                Order order = *it;
+                side->erase(it);
+                return order;
+            }
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] const Order* find(OrderId order_id) const noexcept {
+        for (const auto* side : {&buys_, &sells_}) {
+            for (const auto& order : *side) {
+                if (order.order_id == order_id) return &order;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Visit pending stops (snapshots), buys then sells
+     */
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        for (auto it = buys_.rbegin(); it != buys_.rend(); ++it) fn(*it);
+        for (auto it = sells_.rbegin(); it != sells_.rend(); ++it) fn(*it);
+    }
+
+    void clear() noexcept {
+        buys_.clear();
+        sells_.clear();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return buys_.size() + sells_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return buys_.empty() && sells_.empty(); }
+
+private:
+    std::vector<Order> buys_;
+    std::vector<Order> sells_;
+};
+
+} // namespace hft
@@ -0,0 +1,448 @@
+/**
+ * @file binary_codec.hpp
+ * @brief Fixed-layout little-endian binary codec (SBE-style)
+ *
+ * Binary alternative to FIX text and JSON for order entry, execution
+ * reports and book updates. Every message is an 8-byte header followed
+ * by a fixed block whose layout is computed at compile time from a
+ * schema (a list of typed fields):
+ *
+ *   [block_length:u16][template_id:u16][schema_id:u16][version:u16][block...]
+ *
+ * Encoder / Decoder are flyweights over a raw buffer: no intermediate
+ * object, no text parsing, and prices travel as fixed-point Price, so
+ * there is no double round trip. Fields are read and written with
+ * memcpy (unaligned is fine) and byte-swapped only on big-endian hosts.
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include "core/types.hpp"
+#include "matching/book_delta.hpp"
+#include "matching/order.hpp"
+
+namespace hft::sbe {
+
+inline constexpr std::uint16_t SCHEMA_ID = 0x4846;     // "HF"
+inline constexpr std::uint16_t SCHEMA_VERSION = 1;
+
+// ============================================================================
+// Little-endian primitives
+// ============================================================================
+
+namespace detail {
+
+template<typename T>
+constexpr T byteswap(T value) noexcept {
+    static_assert(std::is_integral_v<T>);
+    using U = std::make_unsigned_t<T>;
+    U v = static_cast<U>(value);
+    U r = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        r = static_cast<U>((r << 8) | (v & 0xFF));
+        v = static_cast<U>(v >> 8);
+    }
+    return static_cast<T>(r);
+}
+
+template<typename T>
+inline T load_le(const char* p) noexcept {
+    if constexpr (std::is_enum_v<T>) {
+        return static_cast<T>(load_le<std::underlying_type_t<T>>(p));
+    } else {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        if constexpr (std::is_integral_v<T> && sizeof(T) > 1 &&
+                      std::endian::native == std::endian::big) {
+            value = byteswap(value);
+        }
+        return value;
+    }
+}
+
+template<typename T>
+inline void store_le(char* p, T value) noexcept {
+    if constexpr (std::is_enum_v<T>) {
+        store_le(p, static_cast<std::underlying_type_t<T>>(value));
+    } else {
+        if constexpr (std::is_integral_v<T> && sizeof(T) > 1 &&
+                      std::endian::native == std::endian::big) {
+            value = byteswap(value);
+        }
+        std::memcpy(p, &value, sizeof(T));
+    }
+}
+
+} // namespace detail
+
+// ============================================================================
+// Schema description
+// ============================================================================
+
+/**
+ * @brief One field of a message schema
+ *
+ * @tparam Id Field name (an enumerator of the message's field enum)
+ * @tparam T  Integer, enum, or trivially copyable array type (e.g. Symbol)
+ */
+template<auto Id, typename T>
+struct Field {
+    static_assert(std::is_trivially_copyable_v<T>, "Fields must be trivially copyable");
+    using type = T;
+    static constexpr auto id = Id;
+    static constexpr std::size_t size = sizeof(T);
+};
+
+/**
+ * @brief Compile-time message layout: fields are packed in declaration order
+ */
+template<std::uint16_t TemplateId, typename... Fields>
+struct MessageSchema {
+    static constexpr std::uint16_t TEMPLATE_ID = TemplateId;
+    static constexpr std::size_t BLOCK_LENGTH = (Fields::size + ... + 0);
+
+    template<auto Id>
+    static constexpr std::size_t offset_of() noexcept {
+        std::size_t offset = 0;
+        bool found = false;
+        ((found = found || Fields::id == Id, offset += found ? 0 : Fields::size), ...);
+        return offset;
+    }
+
+    template<auto Id>
+    static constexpr bool has_field() noexcept {
+        return ((Fields::id == Id) || ...);
+    }
+
+private:
+    template<auto Id, typename F, typename... Rest>
+    static auto type_lookup() {
+        if constexpr (F::id == Id) {
+            return std::type_identity<typename F::type>{};
+        } else {
+            return type_lookup<Id, Rest...>();
+        }
+    }
+
+public:
+    template<auto Id>
+    using type_of = typename decltype(type_lookup<Id, Fields...>())::type;
+};
+
+/**
+ * @brief Message header (SBE standard layout)
+ */
+struct MessageHeader {
+    static constexpr std::size_t SIZE = 8;
+
+    std::uint16_t block_length;
+    std::uint16_t template_id;
+    std::uint16_t schema_id;
+    std::uint16_t version;
+};
+
+/**
+ * @brief Read the header of a buffered message
+ * @return nullopt if too short or not this schema
+ */
+[[nodiscard]] inline std::optional<MessageHeader> peek_header(std::span<const char> buffer) noexcept {
+    if (buffer.size() < MessageHeader::SIZE) return std::nullopt;
+    MessageHeader header;
+    header.block_length = detail::load_le<std::uint16_t>(buffer.data());
+    header.template_id = detail::load_le<std::uint16_t>(buffer.data() + 2);
+    header.schema_id = detail::load_le<std::uint16_t>(buffer.data() + 4);
+    header.version = detail::load_le<std::uint16_t>(buffer.data() + 6);
+    if (header.schema_id != SCHEMA_ID) return std::nullopt;
+    return header;
+}
+
+// ============================================================================
+// Flyweights
+// ============================================================================
+
+/**
+ * @brief Writes one message of Schema into a caller-owned buffer
+ */
+template<typename Schema>
+class Encoder {
+public:
+    static constexpr std::size_t ENCODED_LENGTH = MessageHeader::SIZE + Schema::BLOCK_LENGTH;
+
+    /**
+     * @brief Wrap a buffer and write the header
+     *
+     * Check ok() before setting fields; a short buffer leaves it unwrapped.
+     */
+    explicit Encoder(std::span<char> buffer) noexcept
+        : data_(buffer.size() >= ENCODED_LENGTH ? buffer.data() : nullptr)
+    {
+        if (!data_) return;
+        detail::store_le<std::uint16_t>(data_, static_cast<std::uint16_t>(Schema::BLOCK_LENGTH));
+        detail::store_le<std::uint16_t>(data_ + 2, Schema::TEMPLATE_ID);
+        detail::store_le<std::uint16_t>(data_ + 4, SCHEMA_ID);
+        detail::store_le<std::uint16_t>(data_ + 6, SCHEMA_VERSION);
+    }
+
+    template<auto Id>
+    Encoder& set(typename Schema::template type_of<Id> value) noexcept {
+        detail::store_le(data_ + MessageHeader::SIZE + Schema::template offset_of<Id>(), value);
+        return *this;
+    }
+
+    [[nodiscard]] bool ok() const noexcept { return data_ != nullptr; }
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return ENCODED_LENGTH; }
+
+private:
+    char* data_;
+};
+
+/**
+ * @brief Reads fields of one message of Schema in place
+ *
+ * Newer versions may append fields, so a longer block is accepted;
+ * a shorter one is not.
+ */
+template<typename Schema>
+class Decoder {
+public:
+    explicit Decoder(std::span<const char> buffer) noexcept : data_(nullptr), length_(0) {
+        auto header = peek_header(buffer);
+        if (!header || header->template_id != Schema::TEMPLATE_ID ||
+            header->block_length < Schema::BLOCK_LENGTH ||
+            buffer.size() < MessageHeader::SIZE + header->block_length) {
+            return;
+        }
+        data_ = buffer.data();
+        length_ = MessageHeader::SIZE + header->block_length;
+    }
+
+    template<auto Id>
+    [[nodiscard]] typename Schema::template type_of<Id> get() const noexcept {
+        using T = typename Schema::template type_of<Id>;
+        return detail::load_le<T>(data_ + MessageHeader::SIZE + Schema::template offset_of<Id>());
+    }
+
+    [[nodiscard]] bool ok() const noexcept { return data_ != nullptr; }
+
+    /**
+     * @brief Bytes occupied by this message (header + block)
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return length_; }
+
+private:
+    const char* data_;
+    std::size_t length_;
+};
+
+// ============================================================================
+// Schema: order entry, execution reports, book updates
+// ============================================================================
+
+enum class TemplateId : std::uint16_t {
+    NEW_ORDER = 1,
+    CANCEL_ORDER = 2,
+    EXECUTION_REPORT = 3,
+    BOOK_UPDATE = 4,
+    LEVEL_UPDATE = 5
+};
+
+enum class NewOrderField {
+    CLIENT_ORDER_ID, CLIENT_ID, SYMBOL, INSTRUMENT, PRICE, QUANTITY, SIDE, ORDER_TYPE
+};
+
+using NewOrder = MessageSchema<static_cast<std::uint16_t>(TemplateId::NEW_ORDER),
+    Field<NewOrderField::CLIENT_ORDER_ID, std::uint64_t>,
+    Field<NewOrderField::CLIENT_ID, std::uint64_t>,
+    Field<NewOrderField::SYMBOL, Symbol>,
+    Field<NewOrderField::INSTRUMENT, InstrumentId>,
+    Field<NewOrderField::PRICE, Price>,
+    Field<NewOrderField::QUANTITY, Quantity>,
+    Field<NewOrderField::SIDE, Side>,
+    Field<NewOrderField::ORDER_TYPE, OrderType>>;
+
+enum class CancelOrderField {
+    CLIENT_ORDER_ID, ORDER_ID, SYMBOL, INSTRUMENT
+};
+
+using CancelOrder = MessageSchema<static_cast<std::uint16_t>(TemplateId::CANCEL_ORDER),
+    Field<CancelOrderField::CLIENT_ORDER_ID, std::uint64_t>,
+    Field<CancelOrderField::ORDER_ID, OrderId>,
+    Field<CancelOrderField::SYMBOL, Symbol>,
+    Field<CancelOrderField::INSTRUMENT, InstrumentId>>;
+
+enum class ExecReportField {
+    ORDER_ID, CONTRA_ORDER_ID, CLIENT_ID, PRICE, QUANTITY, LEAVES_QUANTITY,
+    CUMULATIVE_QUANTITY, TIMESTAMP, SIDE, EXEC_TYPE, ORDER_STATUS
+};
+
+using ExecReport = MessageSchema<static_cast<std::uint16_t>(TemplateId::EXECUTION_REPORT),
+    Field<ExecReportField::ORDER_ID, OrderId>,
+    Field<ExecReportField::CONTRA_ORDER_ID, OrderId>,
+    Field<ExecReportField::CLIENT_ID, std::uint64_t>,
+    Field<ExecReportField::PRICE, Price>,
+    Field<ExecReportField::QUANTITY, Quantity>,
+    Field<ExecReportField::LEAVES_QUANTITY, Quantity>,
+    Field<ExecReportField::CUMULATIVE_QUANTITY, Quantity>,
+    Field<ExecReportField::TIMESTAMP, Timestamp>,
+    Field<ExecReportField::SIDE, Side>,
+    Field<ExecReportField::EXEC_TYPE, ExecutionType>,
+    Field<ExecReportField::ORDER_STATUS, OrderStatus>>;
+
+/**
+ * @brief Update kinds carried by BookUpdate
+ */
+enum class BookUpdateType : std::uint8_t {
+    QUOTE = 0,      // Top of book: bid/ask price and size
+    TRADE = 1       // Last trade: trade price/size/aggressor side
+};
+
+enum class BookUpdateField {
+    SEQUENCE, TIMESTAMP, SYMBOL, BID_PRICE, BID_QUANTITY, ASK_PRICE, ASK_QUANTITY,
+    TRADE_PRICE, TRADE_QUANTITY, UPDATE_TYPE, TRADE_SIDE
+};
+
+using BookUpdate = MessageSchema<static_cast<std::uint16_t>(TemplateId::BOOK_UPDATE),
+    Field<BookUpdateField::SEQUENCE, std::uint64_t>,
+    Field<BookUpdateField::TIMESTAMP, Timestamp>,
+    Field<BookUpdateField::SYMBOL, Symbol>,
+    Field<BookUpdateField::BID_PRICE, Price>,
+    Field<BookUpdateField::BID_QUANTITY, Quantity>,
+    Field<BookUpdateField::ASK_PRICE, Price>,
+    Field<BookUpdateField::ASK_QUANTITY, Quantity>,
+    Field<BookUpdateField::TRADE_PRICE, Price>,
+    Field<BookUpdateField::TRADE_QUANTITY, Quantity>,
+    Field<BookUpdateField::UPDATE_TYPE, BookUpdateType>,
+    Field<BookUpdateField::TRADE_SIDE, Side>>;
+
+/**
+ * @brief Incremental L2: one price level's new aggregate (a BookDelta)
+ */
+enum class LevelUpdateField {
+    SEQUENCE, TIMESTAMP, SYMBOL, PRICE, QUANTITY, ORDER_COUNT, SIDE
+};
+
+using LevelUpdate = MessageSchema<static_cast<std::uint16_t>(TemplateId::LEVEL_UPDATE),
+    Field<LevelUpdateField::SEQUENCE, std::uint64_t>,
+    Field<LevelUpdateField::TIMESTAMP, Timestamp>,
+    Field<LevelUpdateField::SYMBOL, Symbol>,
+    Field<LevelUpdateField::PRICE, Price>,
+    Field<LevelUpdateField::QUANTITY, Quantity>,
+    Field<LevelUpdateField::ORDER_COUNT, std::uint32_t>,
+    Field<LevelUpdateField::SIDE, Side>>;
+
+static_assert(NewOrder::BLOCK_LENGTH == 54, "NewOrder layout changed: bump SCHEMA_VERSION");
+static_assert(ExecReport::BLOCK_LENGTH == 67, "ExecReport layout changed: bump SCHEMA_VERSION");
+
+// ============================================================================
+// Conversions
+// ============================================================================
+
+/**
+ * @brief Whether a decoded NewOrder may go on to risk and matching
+ *
+ * Enum fields are copied off the wire as raw bytes, so any byte decodes
+ * to some Side or OrderType; this rejects out-of-range enums, quantities
+ * <= 0 and, on orders that carry a limit price, prices <= 0. NewOrder has
+ * no stop price field, so STOP_LIMIT and STOP are refused too.
+ */
+[[nodiscard]] inline bool valid_new_order(const Decoder<NewOrder>& order) noexcept {
+    if (!order.ok()) return false;
+    using F = NewOrderField;
+    const auto side = static_cast<std::uint8_t>(order.get<F::SIDE>());
+    const auto type = static_cast<std::uint8_t>(order.get<F::ORDER_TYPE>());
+    if (side > static_cast<std::uint8_t>(Side::SELL) ||
+        type > static_cast<std::uint8_t>(OrderType::POST_ONLY) ||
+        order.get<F::ORDER_TYPE>() == OrderType::STOP_LIMIT) {
+        return false;
+    }
+    if (order.get<F::QUANTITY>() <= 0) return false;
+    return order.get<F::ORDER_TYPE>() == OrderType::MARKET || order.get<F::PRICE>() > 0;
+}
+
+/**
+ * @brief Encode an execution report
+ * @return Bytes written, 0 if the buffer is too small
+ */
+inline std::size_t encode_execution_report(std::span<char> buffer, const ExecutionReport& report) noexcept {
+    Encoder<ExecReport> enc(buffer);
+    if (!enc.ok()) return 0;
+    using F = ExecReportField;
+    enc.set<F::ORDER_ID>(report.order_id)
+       .set<F::CONTRA_ORDER_ID>(report.contra_order_id)
+       .set<F::CLIENT_ID>(report.client_id)
+       .set<F::PRICE>(report.execution_price)
+       .set<F::QUANTITY>(report.execution_quantity)
+       .set<F::LEAVES_QUANTITY>(report.leaves_quantity)
+       .set<F::CUMULATIVE_QUANTITY>(report.cumulative_quantity)
+       .set<F::TIMESTAMP>(report.timestamp)
+       .set<F::SIDE>(report.side)
+       .set<F::EXEC_TYPE>(report.exec_type)
+       .set<F::ORDER_STATUS>(report.order_status);
+    return enc.size();
+}
+
+/**
+ * @brief Decode an execution report
+ */
+[[nodiscard]] inline std::optional<ExecutionReport> decode_execution_report(std::span<const char> buffer) noexcept {
+    Decoder<ExecReport> dec(buffer);
+    if (!dec.ok()) return std::nullopt;
+    using F = ExecReportField;
+    ExecutionReport report;
+    report.order_id = dec.get<F::ORDER_ID>();
+    report.contra_order_id = dec.get<F::CONTRA_ORDER_ID>();
+    report.client_id = dec.get<F::CLIENT_ID>();
+    report.execution_price = dec.get<F::PRICE>();
+    report.execution_quantity = dec.get<F::QUANTITY>();
+    report.leaves_quantity = dec.get<F::LEAVES_QUANTITY>();
+    report.cumulative_quantity = dec.get<F::CUMULATIVE_QUANTITY>();
+    report.timestamp = dec.get<F::TIMESTAMP>();
+    report.side = dec.get<F::SIDE>();
+    report.exec_type = dec.get<F::EXEC_TYPE>();
+    report.order_status = dec.get<F::ORDER_STATUS>();
+    return report;
+}
+
+/**
+ * @brief Encode a book delta as a LevelUpdate
+ * @return Bytes written, 0 if the buffer is too small
+ */
+inline std::size_t encode_level_update(std::span<char> buffer, const Symbol& symbol,
+                                       const BookDelta& delta, Timestamp timestamp) noexcept {
+    Encoder<LevelUpdate> enc(buffer);
+    if (!enc.ok()) return 0;
+    using F = LevelUpdateField;
+    enc.set<F::SEQUENCE>(delta.sequence)
+       .set<F::TIMESTAMP>(timestamp)
+       .set<F::SYMBOL>(symbol)
+       .set<F::PRICE>(delta.price)
+       .set<F::QUANTITY>(delta.quantity)
+       .set<F::ORDER_COUNT>(delta.order_count)
+       .set<F::SIDE>(delta.side);
+    return enc.size();
+}
+
+/**
+ * @brief Decode a LevelUpdate back into a book delta
+ */
+[[nodiscard]] inline std::optional<BookDelta> decode_level_update(std::span<const char> buffer) noexcept {
+    Decoder<LevelUpdate> dec(buffer);
+    if (!dec.ok()) return std::nullopt;
+    using F = LevelUpdateField;
+    BookDelta delta{};
+    delta.sequence = dec.get<F::SEQUENCE>();
+    delta.price = dec.get<F::PRICE>();
+    delta.quantity = dec.get<F::QUANTITY>();
+    delta.order_count = dec.get<F::ORDER_COUNT>();
+    delta.side = dec.get<F::SIDE>();
+    return delta;
+}
+
+} // namespace hft::sbe
@@ -11,9 +11,10 @@
 
 #pragma once
 
+#include <array>
+#include <span>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 #include <vector>
 #include <optional>
 #include <cstdint>
@@ -45,6 +46,7 @@ namespace fix_tag {
     constexpr int OrdType = 40;
     constexpr int Price = 44;
     constexpr int TimeInForce = 59;
+    constexpr int Text = 58;
     constexpr int ExecType = 150;
     constexpr int OrdStatus = 39;
     constexpr int LeavesQty = 151;
@@ -96,25 +98,45 @@ struct FixField {
  * 
  * Provides efficient access to FIX fields with minimal copying.
  * Uses string_view for zero-copy field access.
+ * 
+ * Storage is allocation-free for typical messages:
+ * - Tags below DIRECT_TAGS (all header and order-entry tags) live in a
+ *   direct-indexed array guarded by a presence bitmask
+ * - Other tags go to a small inline overflow array, spilling to a
+ *   vector (whose capacity is kept across parses) only for very large
+ *   messages such as market data repeating groups
+ * 
+ * parse() locates all '=' and SOH bytes with SIMD compares and computes
+ * the checksum and body length in the same pass.
  */
 class FixMessage {
 public:
+    static constexpr int DIRECT_TAGS = 64;
+    static constexpr std::size_t INLINE_OVERFLOW = 16;
+
     FixMessage() = default;
 
     /**
      * @brief Parse a FIX message from raw bytes
+     * 
+     * A bad checksum or body length does not fail the parse; check
+     * verify_checksum() / verify_body_length().
      */
     bool parse(std::string_view data);
 
     /**
      * @brief Get field value by tag
+     * 
+     * If a tag repeats, the last occurrence wins.
      */
     [[nodiscard]] std::optional<std::string_view> get_field(int tag) const {
-        auto it = fields_.find(tag);
-        if (it != fields_.end()) {
-            return it->second;
+        if (static_cast<unsigned>(tag) < DIRECT_TAGS) {
+            if (present_ & (std::uint64_t{1} << tag)) {
+                return direct_[tag];
+            }
+            return std::nullopt;
         }
-        return std::nullopt;
+        return find_overflow(tag);
     }
 
     /**
@@ -139,14 +161,32 @@ public:
      * @brief Check if message has a field
      */
     [[nodiscard]] bool has_field(int tag) const {
-        return fields_.find(tag) != fields_.end();
+        if (static_cast<unsigned>(tag) < DIRECT_TAGS) {
+            return (present_ & (std::uint64_t{1} << tag)) != 0;
+        }
+        return find_overflow(tag).has_value();
+    }
+
+    /**
+     * @brief Visit every field: direct tags in tag order, then the rest
+     *        in wire order
+     */
+    template<typename Fn>
+    void for_each_field(Fn&& fn) const {
+        for (std::uint64_t bits = present_; bits; bits &= bits - 1) {
+            const int tag = __builtin_ctzll(bits);
+            fn(FixField(tag, direct_[tag]));
+        }
+        for (std::size_t i = 0; i < overflow_count_; ++i) {
+            fn(overflow_at(i));
+        }
     }
 
     /**
-     * @brief Get all fields
+     * @brief Number of distinct direct tags plus overflow fields
      */
-    [[nodiscard]] const std::unordered_map<int, std::string_view>& fields() const {
-        return fields_;
+    [[nodiscard]] std::size_t field_count() const {
+        return static_cast<std::size_t>(__builtin_popcountll(present_)) + overflow_count_;
     }
 
     /**
@@ -158,29 +198,141 @@ public:
      * @brief Clear the message
      */
     void clear() {
-        fields_.clear();
+        present_ = 0;
+        overflow_count_ = 0;
+        spill_.clear();
         raw_data_ = {};
+        checksum_ok_ = false;
+        body_length_ok_ = false;
     }
 
     /**
-     * @brief Verify checksum
+     * @brief Verify checksum (computed during parse)
      */
-    [[nodiscard]] bool verify_checksum() const;
+    [[nodiscard]] bool verify_checksum() const { return checksum_ok_; }
+
+    /**
+     * @brief Verify BodyLength (9) against the actual body (computed during parse)
+     */
+    [[nodiscard]] bool verify_body_length() const { return body_length_ok_; }
 
 private:
-    std::unordered_map<int, std::string_view> fields_;
+    void set_field(int tag, std::string_view value) {
+        if (static_cast<unsigned>(tag) < DIRECT_TAGS) {
+            direct_[tag] = value;
+            present_ |= std::uint64_t{1} << tag;
+        } else if (overflow_count_ < INLINE_OVERFLOW) {
+            overflow_[overflow_count_++] = FixField(tag, value);
+        } else {
+            spill_.emplace_back(tag, value);
+            ++overflow_count_;
+        }
+    }
+
+    [[nodiscard]] const FixField& overflow_at(std::size_t i) const {
+        return i < INLINE_OVERFLOW ? overflow_[i] : spill_[i - INLINE_OVERFLOW];
+    }
+
+    [[nodiscard]] std::optional<std::string_view> find_overflow(int tag) const {
+        for (std::size_t i = overflow_count_; i-- > 0;) {
+            const FixField& field = overflow_at(i);
+            if (field.tag == tag) return field.value;
+        }
+        return std::nullopt;
+    }
+
+    std::array<std::string_view, DIRECT_TAGS> direct_;
+    std::uint64_t present_ = 0;
+    std::array<FixField, INLINE_OVERFLOW> overflow_;
+    std::size_t overflow_count_ = 0;
+    std::vector<FixField> spill_;
     std::string_view raw_data_;
+    bool checksum_ok_ = false;
+    bool body_length_ok_ = false;
+};
+
+namespace detail {
+
+/**
+ * @brief Sum of bytes, as used by the FIX CheckSum (10) field
+ */
+constexpr std::uint32_t fix_byte_sum(std::string_view bytes) {
+    std::uint32_t sum = 0;
+    for (char c : bytes) {
+        sum += static_cast<std::uint8_t>(c);
+    }
+    return sum;
+}
+
+} // namespace detail
+
+/**
+ * @brief Per-session constant header bytes, encoded once at session setup
+ * 
+ * Holds "8=<BeginString>|" and "49=<Sender>|56=<Target>|" together with
+ * their byte sums, so FixMessageBuilder::begin() copies them with one
+ * memcpy each and never re-encodes or re-sums them.
+ */
+class FixSessionHeader {
+public:
+    static constexpr std::size_t MAX_BEGIN_STRING = 16;
+
+    FixSessionHeader(std::string_view sender, std::string_view target,
+                     std::string_view begin_string = "FIX.4.4");
+
+    [[nodiscard]] std::string_view begin_prefix() const { return begin_prefix_; }
+    [[nodiscard]] std::string_view comp_ids() const { return comp_ids_; }
+
+private:
+    friend class FixMessageBuilder;
+
+    std::string begin_prefix_;      // "8=FIX.4.4|"
+    std::string comp_ids_;          // "49=SENDER|56=TARGET|"
+    std::uint32_t begin_prefix_sum_ = 0;
+    std::uint32_t comp_ids_sum_ = 0;
 };
 
 /**
  * @brief FIX message builder for constructing outbound messages
+ * 
+ * Writes into a fixed buffer (caller-owned, or an inline default) and
+ * never allocates on the finish() path:
+ * - The body is written after a reserved gap; finish() fills in
+ *   BeginString and BodyLength right-aligned in front of it
+ * - The checksum is accumulated as bytes are appended
+ * - Integers and fixed-point prices are formatted without snprintf
+ * 
+ * If the buffer is too small the message is marked overflowed and
+ * finish() returns an empty view.
  */
 class FixMessageBuilder {
 public:
-    FixMessageBuilder() {
-        buffer_.reserve(256);
+    static constexpr std::size_t DEFAULT_CAPACITY = 512;
+    static constexpr std::size_t HEADER_RESERVE = 32;  // "8=<begin>|9=<len>|"
+
+    FixMessageBuilder() : buffer_(inline_buffer_.data(), inline_buffer_.size()) {
+        clear();
     }
 
+    /**
+     * @brief Build into a caller-owned buffer (must outlive the builder)
+     */
+    explicit FixMessageBuilder(std::span<char> buffer) : buffer_(buffer) {
+        clear();
+    }
+
+    // Non-copyable: buffer_ may point at inline storage
+    FixMessageBuilder(const FixMessageBuilder&) = delete;
+    FixMessageBuilder& operator=(const FixMessageBuilder&) = delete;
+
+    /**
+     * @brief Start a new message on a pre-encoded session header
+     */
+    FixMessageBuilder& begin(const FixSessionHeader& session,
+                              std::string_view msg_type,
+                              std::uint64_t seq_num,
+                              Timestamp sending_time = now());
+
     /**
      * @brief Start a new message
      */
@@ -211,45 +363,100 @@ public:
      * @brief Add a char field
      */
     FixMessageBuilder& add_field(int tag, char value) {
-        char buf[2] = {value, '\0'};
-        append_field(tag, std::string_view(buf, 1));
+        append_field(tag, std::string_view(&value, 1));
         return *this;
     }
 
+    /**
+     * @brief Add a fixed-point price (exact, trailing zeros trimmed)
+     */
+    FixMessageBuilder& add_price(int tag, Price price);
+
+    /**
+     * @brief Finalize in place and view the message
+     * 
+     * Valid until the next begin()/clear(). Empty if the buffer overflowed.
+     */
+    std::string_view finish();
+
     /**
      * @brief Finalize and get the message
      */
-    std::string build();
+    std::string build() {
+        return std::string(finish());
+    }
 
     /**
-     * @brief Get current buffer (without finalization)
+     * @brief Get current body (without finalization)
      */
-    [[nodiscard]] const std::string& buffer() const { return buffer_; }
+    [[nodiscard]] std::string_view buffer() const {
+        return std::string_view(buffer_.data() + HEADER_RESERVE, pos_ - HEADER_RESERVE);
+    }
+
+    [[nodiscard]] bool overflowed() const { return overflowed_; }
+    [[nodiscard]] std::size_t capacity() const { return buffer_.size(); }
 
     /**
      * @brief Clear the builder
      */
     void clear() {
-        buffer_.clear();
-        body_start_ = 0;
+        pos_ = HEADER_RESERVE;
+        checksum_ = 0;
+        begin_prefix_ = DEFAULT_BEGIN_PREFIX;
+        begin_prefix_sum_ = DEFAULT_BEGIN_PREFIX_SUM;
+        message_ = {};
+        overflowed_ = buffer_.size() < HEADER_RESERVE;
     }
 
 private:
-    void append_field(int tag, std::string_view value);
-    [[nodiscard]] static std::uint8_t calculate_checksum(std::string_view data);
+    static constexpr std::string_view DEFAULT_BEGIN_PREFIX = "8=FIX.4.4\x01";
+    static constexpr std::uint32_t DEFAULT_BEGIN_PREFIX_SUM = detail::fix_byte_sum(DEFAULT_BEGIN_PREFIX);
 
-    std::string buffer_;
-    std::size_t body_start_ = 0;
+    void append_field(int tag, std::string_view value);
+    void append_raw(std::string_view bytes, std::uint32_t sum);
+    void append_uint_field(int tag, std::uint64_t value, bool negative = false);
+
+    std::array<char, DEFAULT_CAPACITY> inline_buffer_;
+    std::span<char> buffer_;
+    std::size_t pos_ = HEADER_RESERVE;
+    std::uint32_t checksum_ = 0;
+    std::string_view begin_prefix_ = DEFAULT_BEGIN_PREFIX;
+    std::uint32_t begin_prefix_sum_ = DEFAULT_BEGIN_PREFIX_SUM;
+    std::string_view message_;          // Set by finish()
+    bool overflowed_ = false;
 };
 
 /**
  * @brief Convert HFT order to FIX NewOrderSingle message
+ * 
+ * Order carries no symbol (the book it rests in implies it), so the
+ * caller supplies tag 55.
  */
-std::string order_to_fix(const Order& order, 
+std::string order_to_fix(const Order& order,
+                          const Symbol& symbol,
                           std::string_view sender,
                           std::string_view target,
                           std::uint64_t seq_num);
 
+/**
+ * @brief Encode a NewOrderSingle into builder (no allocation)
+ * @return View into the builder's buffer
+ */
+std::string_view order_to_fix(FixMessageBuilder& builder,
+                              const FixSessionHeader& session,
+                              const Order& order,
+                              const Symbol& symbol,
+                              std::uint64_t seq_num);
+
+/**
+ * @brief Encode an outbound ExecutionReport into builder (no allocation)
+ * @return View into the builder's buffer
+ */
+std::string_view execution_report_to_fix(FixMessageBuilder& builder,
+                                         const FixSessionHeader& session,
+                                         const ExecutionReport& report,
+                                         std::uint64_t seq_num);
+
 /**
  * @brief Convert FIX ExecutionReport to HFT ExecutionReport
  */
@@ -273,6 +480,35 @@ inline std::optional<Side> fix_to_side(char c) {
     }
 }
 
+/**
+ * @brief Convert HFT execution type to FIX ExecType (150)
+ */
+inline char exec_type_to_fix(ExecutionType type) {
+    switch (type) {
+        case ExecutionType::NEW: return '0';
+        case ExecutionType::TRADE: return 'F';
+        case ExecutionType::CANCELLED: return '4';
+        case ExecutionType::REPLACED: return '5';
+        case ExecutionType::REJECTED: return '8';
+        default: return '0';
+    }
+}
+
+/**
+ * @brief Convert HFT order status to FIX OrdStatus (39)
+ */
+inline char order_status_to_fix(OrderStatus status) {
+    switch (status) {
+        case OrderStatus::NEW: return '0';
+        case OrderStatus::PARTIALLY_FILLED: return '1';
+        case OrderStatus::FILLED: return '2';
+        case OrderStatus::CANCELLED: return '4';
+        case OrderStatus::REJECTED: return '8';
+        case OrderStatus::EXPIRED: return 'C';
+        default: return '0';
+    }
+}
+
 /**
  * @brief Convert HFT order type to FIX order type
  */
@@ -280,6 +516,7 @@ inline char order_type_to_fix(OrderType type) {
     switch (type) {
         case OrderType::MARKET: return '1';
         case OrderType::LIMIT: return '2';
+        case OrderType::STOP: return '3';
         case OrderType::STOP_LIMIT: return '4';
         default: return '2';  // Default to limit
     }
@@ -4,50 +4,182 @@
  */
 
 #include "fix_message.hpp"
+#include <algorithm>
+#include <bit>
 #include <charconv>
 #include <cstdio>
 #include <optional>
 #include <cstring>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace hft {
 
+namespace {
+
+constexpr std::size_t SCAN_BLOCK = 32;
+
+/**
+ * @brief Delimiter masks and byte sum for one SCAN_BLOCK of input
+ */
+struct ScanBlock {
+    std::uint32_t eq;       // Bit i set: byte i is '='
+    std::uint32_t soh;      // Bit i set: byte i is SOH
+    std::uint32_t sum;      // Sum of all bytes (for the checksum)
+};
+
+inline ScanBlock scan_block(const char* p) {
+    ScanBlock block;
+#if defined(__AVX2__)
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    block.eq = static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('='))));
+    block.soh = static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(FIX_DELIMITER))));
+    const __m256i sad = _mm256_sad_epu8(v, _mm256_setzero_si256());
+    const __m128i s = _mm_add_epi64(_mm256_castsi256_si128(sad), _mm256_extracti128_si256(sad, 1));
+    block.sum = static_cast<std::uint32_t>(_mm_cvtsi128_si32(s) + _mm_extract_epi16(s, 4));
+#elif defined(__SSE2__)
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+    const __m128i eq = _mm_set1_epi8('=');
+    const __m128i soh = _mm_set1_epi8(FIX_DELIMITER);
+    block.eq = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(lo, eq))) |
+               static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, eq))) << 16;
+    block.soh = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(lo, soh))) |
+                static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, soh))) << 16;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i s = _mm_add_epi64(_mm_sad_epu8(lo, zero), _mm_sad_epu8(hi, zero));
+    block.sum = static_cast<std::uint32_t>(_mm_cvtsi128_si32(s) + _mm_extract_epi16(s, 4));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static const uint8_t bit_weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t weights = vld1q_u8(bit_weights);
+    auto movemask = [&weights](uint8x16_t cmp) -> std::uint32_t {
+        const uint8x16_t bits = vandq_u8(cmp, weights);
+        return static_cast<std::uint32_t>(vaddv_u8(vget_low_u8(bits))) |
+               static_cast<std::uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8;
+    };
+    const uint8x16_t lo = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    const uint8x16_t hi = vld1q_u8(reinterpret_cast<const uint8_t*>(p + 16));
+    const uint8x16_t eq = vdupq_n_u8('=');
+    const uint8x16_t soh = vdupq_n_u8(static_cast<uint8_t>(FIX_DELIMITER));
+    block.eq = movemask(vceqq_u8(lo, eq)) | movemask(vceqq_u8(hi, eq)) << 16;
+    block.soh = movemask(vceqq_u8(lo, soh)) | movemask(vceqq_u8(hi, soh)) << 16;
+    block.sum = static_cast<std::uint32_t>(vaddlvq_u8(lo)) + static_cast<std::uint32_t>(vaddlvq_u8(hi));
+#else
+    block.eq = 0;
+    block.soh = 0;
+    block.sum = 0;
+    for (std::size_t i = 0; i < SCAN_BLOCK; ++i) {
+        const auto c = static_cast<std::uint8_t>(p[i]);
+        block.eq |= static_cast<std::uint32_t>(c == '=') << i;
+        block.soh |= static_cast<std::uint32_t>(c == static_cast<std::uint8_t>(FIX_DELIMITER)) << i;
+        block.sum += c;
+    }
+#endif
+    return block;
+}
+
+/**
+ * @brief Parse a tag number (1-9 decimal digits, nothing else)
+ */
+inline bool parse_tag(const char* p, std::size_t len, int& tag) {
+    if (len == 0 || len > 9) return false;
+    int value = 0;
+    for (std::size_t i = 0; i < len; ++i) {
+        const unsigned digit = static_cast<unsigned char>(p[i]) - '0';
+        if (digit > 9) return false;
+        value = value * 10 + static_cast<int>(digit);
+    }
+    tag = value;
+    return true;
+}
+
+inline std::uint32_t byte_sum(const char* p, std::size_t len) {
+    std::uint32_t sum = 0;
+    for (std::size_t i = 0; i < len; ++i) {
+        sum += static_cast<std::uint8_t>(p[i]);
+    }
+    return sum;
+}
+
+} // namespace
+
 bool FixMessage::parse(std::string_view data) {
     clear();
     raw_data_ = data;
     
-    std::size_t pos = 0;
-    while (pos < data.size()) {
-        // Find tag
-        auto eq_pos = data.find('=', pos);
-        if (eq_pos == std::string_view::npos) {
-            break;
-        }
-        
-        // Parse tag number
-        int tag = 0;
-        auto tag_str = data.substr(pos, eq_pos - pos);
-        auto [ptr, ec] = std::from_chars(tag_str.data(), 
-                                          tag_str.data() + tag_str.size(), 
-                                          tag);
-        if (ec != std::errc()) {
-            return false;  // Invalid tag
+    constexpr std::size_t npos = std::string_view::npos;
+    const char* const base = data.data();
+    const std::size_t size = data.size();
+    
+    std::size_t field_start = 0;        // First byte of the current tag
+    std::size_t eq_pos = npos;          // '=' of the current field; npos while in the tag
+    int tag = 0;
+    std::size_t body_start = npos;      // First byte after the BodyLength field
+    std::size_t checksum_start = npos;  // First byte of the CheckSum field
+    std::uint32_t checksum_sum = 0;     // Byte sum of data[0, checksum_start)
+    std::uint32_t sum_before_block = 0;
+    
+    alignas(SCAN_BLOCK) char tail[SCAN_BLOCK];
+    for (std::size_t block_base = 0; block_base < size; block_base += SCAN_BLOCK) {
+        const char* p = base + block_base;
+        if (size - block_base < SCAN_BLOCK) {
+            // Zero padding never matches '=' or SOH and adds nothing to the sum
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, p, size - block_base);
+            p = tail;
         }
         
-        // Find value end (delimiter)
-        auto delim_pos = data.find(FIX_DELIMITER, eq_pos + 1);
-        if (delim_pos == std::string_view::npos) {
-            // Last field might not have delimiter
-            delim_pos = data.size();
+        const ScanBlock block = scan_block(p);
+        for (std::uint32_t bits = block.eq | block.soh; bits; bits &= bits - 1) {
+            const unsigned idx = static_cast<unsigned>(__builtin_ctz(bits));
+            const std::size_t pos = block_base + idx;
+            const bool is_soh = (block.soh >> idx) & 1u;
+            
+            if (eq_pos == npos) {
+                if (is_soh || !parse_tag(base + field_start, pos - field_start, tag)) {
+                    return false;  // Invalid tag
+                }
+                eq_pos = pos;
+                if (tag == fix_tag::CheckSum) {
+                    checksum_start = field_start;
+                    checksum_sum = field_start >= block_base
+                        ? sum_before_block + byte_sum(base + block_base, field_start - block_base)
+                        : sum_before_block - byte_sum(base + field_start, block_base - field_start);
+                }
+            } else if (is_soh) {
+                set_field(tag, data.substr(eq_pos + 1, pos - eq_pos - 1));
+                if (tag == fix_tag::BodyLength) {
+                    body_start = pos + 1;
+                }
+                field_start = pos + 1;
+                eq_pos = npos;
+            }
+            // '=' inside a value is just data
         }
+        sum_before_block += block.sum;
+    }
+    
+    // Last field might not have delimiter
+    if (eq_pos != npos) {
+        set_field(tag, data.substr(eq_pos + 1));
+    }
+    
+    if (checksum_start != npos) {
+        const auto stated = get_int(fix_tag::CheckSum);
+        checksum_ok_ = stated && *stated == static_cast<std::int64_t>(checksum_sum % 256);
         
-        // Extract value
-        auto value = data.substr(eq_pos + 1, delim_pos - eq_pos - 1);
-        fields_[tag] = value;
-        
-        pos = delim_pos + 1;
+        const auto body_length = get_int(fix_tag::BodyLength);
+        body_length_ok_ = body_length && body_start != npos && body_start <= checksum_start &&
+                          *body_length == static_cast<std::int64_t>(checksum_start - body_start);
     }
     
-    return !fields_.empty();
+    return field_count() > 0;
 }
 
 std::optional<std::int64_t> FixMessage::get_int(int tag) const {
@@ -86,35 +218,103 @@ std::optional<double> FixMessage::get_double(int tag) const {
     return result;
 }
 
-bool FixMessage::verify_checksum() const {
-    auto checksum_field = get_field(fix_tag::CheckSum);
-    if (!checksum_field) {
-        return false;
+namespace {
+
+struct DigitPairs {
+    char data[200];
+    constexpr DigitPairs() : data{} {
+        for (int i = 0; i < 100; ++i) {
+            data[2 * i] = static_cast<char>('0' + i / 10);
+            data[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
     }
-    
-    // Find checksum field position
-    auto checksum_pos = raw_data_.rfind("10=");
-    if (checksum_pos == std::string_view::npos) {
-        return false;
+};
+constexpr DigitPairs DIGIT_PAIRS{};
+
+constexpr std::uint64_t POW10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL
+};
+
+constexpr int PRICE_DECIMALS = 8;
+static_assert(POW10[PRICE_DECIMALS] == static_cast<std::uint64_t>(PRICE_MULTIPLIER),
+              "PRICE_DECIMALS must match PRICE_MULTIPLIER");
+
+/**
+ * @brief Write value in decimal so that it ends just before end
+ * @return First character written
+ */
+inline char* format_uint_backward(char* end, std::uint64_t value) {
+    while (value >= 100) {
+        const std::size_t pair = static_cast<std::size_t>(value % 100) * 2;
+        value /= 100;
+        end -= 2;
+        std::memcpy(end, DIGIT_PAIRS.data + pair, 2);
     }
-    
-    // Calculate checksum of everything before "10="
-    std::uint32_t sum = 0;
-    for (std::size_t i = 0; i < checksum_pos; ++i) {
-        sum += static_cast<std::uint8_t>(raw_data_[i]);
+    if (value >= 10) {
+        end -= 2;
+        std::memcpy(end, DIGIT_PAIRS.data + value * 2, 2);
+    } else {
+        *--end = static_cast<char>('0' + value);
     }
-    std::uint8_t expected = sum % 256;
-    
-    // Parse stated checksum
-    int stated = 0;
-    auto [ptr, ec] = std::from_chars(checksum_field->data(),
-                                      checksum_field->data() + checksum_field->size(),
-                                      stated);
-    if (ec != std::errc()) {
-        return false;
+    return end;
+}
+
+/**
+ * @brief Write at least min_digits digits (zero-padded) ending before end
+ */
+inline char* format_uint_padded(char* end, std::uint64_t value, int min_digits) {
+    char* p = format_uint_backward(end, value);
+    while (end - p < min_digits) {
+        *--p = '0';
     }
+    return p;
+}
+
+// Bit test: std::isfinite is not reliable under -ffast-math
+inline bool is_finite(double value) {
+    return (std::bit_cast<std::uint64_t>(value) & 0x7FF0000000000000ULL) != 0x7FF0000000000000ULL;
+}
+
+inline std::uint64_t magnitude(std::int64_t value) {
+    return value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+}
+
+} // namespace
+
+FixSessionHeader::FixSessionHeader(std::string_view sender, std::string_view target,
+                                   std::string_view begin_string) {
+    begin_prefix_ = "8=";
+    begin_prefix_.append(begin_string.substr(0, MAX_BEGIN_STRING));
+    begin_prefix_ += FIX_DELIMITER;
     
-    return static_cast<int>(expected) == stated;
+    comp_ids_ = "49=";
+    comp_ids_.append(sender);
+    comp_ids_ += FIX_DELIMITER;
+    comp_ids_ += "56=";
+    comp_ids_.append(target);
+    comp_ids_ += FIX_DELIMITER;
+    
+    begin_prefix_sum_ = detail::fix_byte_sum(begin_prefix_);
+    comp_ids_sum_ = detail::fix_byte_sum(comp_ids_);
+}
+
+FixMessageBuilder& FixMessageBuilder::begin(const FixSessionHeader& session,
+                                             std::string_view msg_type,
+                                             std::uint64_t seq_num,
+                                             Timestamp sending_time) {
+    clear();
+    begin_prefix_ = session.begin_prefix_;
+    begin_prefix_sum_ = session.begin_prefix_sum_;
+    
+    append_field(fix_tag::MsgType, msg_type);
+    append_raw(session.comp_ids_, session.comp_ids_sum_);
+    append_uint_field(fix_tag::MsgSeqNum, seq_num);
+    add_field(fix_tag::SendingTime, static_cast<std::int64_t>(sending_time));
+    
+    return *this;
 }
 
 FixMessageBuilder& FixMessageBuilder::begin(std::string_view msg_type,
@@ -123,108 +323,209 @@ FixMessageBuilder& FixMessageBuilder::begin(std::string_view msg_type,
                                              std::uint64_t seq_num) {
     clear();
     
-    // BeginString (will be prepended with body length later)
-    append_field(fix_tag::BeginString, "FIX.4.4");
-    
-    // Placeholder for BodyLength - we'll update this at the end
-    body_start_ = buffer_.size();
-    append_field(fix_tag::BodyLength, "000");
-    
-    // Standard header fields
+    // Standard header fields (BeginString / BodyLength are added by finish())
     append_field(fix_tag::MsgType, msg_type);
     append_field(fix_tag::SenderCompID, sender);
     append_field(fix_tag::TargetCompID, target);
-    add_field(fix_tag::MsgSeqNum, static_cast<std::int64_t>(seq_num));
-    
-    // SendingTime
-    auto now_time = now();
-    char time_buf[32];
-    std::snprintf(time_buf, sizeof(time_buf), "%ld", now_time);
-    append_field(fix_tag::SendingTime, time_buf);
+    append_uint_field(fix_tag::MsgSeqNum, seq_num);
+    add_field(fix_tag::SendingTime, static_cast<std::int64_t>(now()));
     
     return *this;
 }
 
 FixMessageBuilder& FixMessageBuilder::add_field(int tag, std::int64_t value) {
-    char buf[32];
-    auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
-    if (ec == std::errc()) {
-        append_field(tag, std::string_view(buf, ptr - buf));
-    }
+    append_uint_field(tag, magnitude(value), value < 0);
     return *this;
 }
 
 FixMessageBuilder& FixMessageBuilder::add_field(int tag, double value, int precision) {
+    // Fast path: round to a scaled integer and print digits directly
+    if (precision >= 0 && precision <= 18 && is_finite(value)) {
+        const double scaled = (value < 0 ? -value : value) * static_cast<double>(POW10[precision]);
+        if (scaled < 9.0e18) {
+            const auto units = static_cast<std::uint64_t>(scaled + 0.5);
+            char buf[48];
+            char* const end = buf + sizeof(buf);
+            char* p = end;
+            if (precision > 0) {
+                p = format_uint_padded(p, units % POW10[precision], precision);
+                *--p = '.';
+            }
+            p = format_uint_backward(p, units / POW10[precision]);
+            if (value < 0) *--p = '-';
+            append_field(tag, std::string_view(p, static_cast<std::size_t>(end - p)));
+            return *this;
+        }
+    }
+    
     char buf[64];
     int len = std::snprintf(buf, sizeof(buf), "%.*f", precision, value);
     if (len > 0) {
-        append_field(tag, std::string_view(buf, len));
+        append_field(tag, std::string_view(buf, std::min(static_cast<std::size_t>(len), sizeof(buf) - 1)));
+    }
+    return *this;
+}
+
+FixMessageBuilder& FixMessageBuilder::add_price(int tag, Price price) {
+    const std::uint64_t mag = magnitude(price);
+    std::uint64_t frac = mag % POW10[PRICE_DECIMALS];
+    
+    char buf[32];
+    char* const end = buf + sizeof(buf);
+    char* p = end;
+    if (frac != 0) {
+        int digits = PRICE_DECIMALS;
+        while (frac % 10 == 0) {
+            frac /= 10;
+            --digits;
+        }
+        p = format_uint_padded(p, frac, digits);
+        *--p = '.';
     }
+    p = format_uint_backward(p, mag / POW10[PRICE_DECIMALS]);
+    if (price < 0) *--p = '-';
+    append_field(tag, std::string_view(p, static_cast<std::size_t>(end - p)));
     return *this;
 }
 
+void FixMessageBuilder::append_uint_field(int tag, std::uint64_t value, bool negative) {
+    char buf[24];
+    char* const end = buf + sizeof(buf);
+    char* p = format_uint_backward(end, value);
+    if (negative) *--p = '-';
+    append_field(tag, std::string_view(p, static_cast<std::size_t>(end - p)));
+}
+
 void FixMessageBuilder::append_field(int tag, std::string_view value) {
+    if (overflowed_) return;
+    
     char tag_buf[16];
-    auto [ptr, ec] = std::to_chars(tag_buf, tag_buf + sizeof(tag_buf), tag);
-    if (ec == std::errc()) {
-        buffer_.append(tag_buf, ptr - tag_buf);
-        buffer_ += '=';
-        buffer_.append(value);
-        buffer_ += FIX_DELIMITER;
+    char* const tag_end = tag_buf + sizeof(tag_buf);
+    char* tag_start = tag_end;
+    *--tag_start = '=';
+    tag_start = format_uint_backward(tag_start, static_cast<std::uint32_t>(tag));
+    const auto tag_len = static_cast<std::size_t>(tag_end - tag_start);
+    
+    const std::size_t needed = tag_len + value.size() + 1;
+    if (pos_ + needed > buffer_.size()) {
+        overflowed_ = true;
+        return;
     }
+    
+    char* out = buffer_.data() + pos_;
+    std::memcpy(out, tag_start, tag_len);
+    std::memcpy(out + tag_len, value.data(), value.size());
+    out[needed - 1] = FIX_DELIMITER;
+    
+    checksum_ += detail::fix_byte_sum(std::string_view(tag_start, tag_len)) +
+                 detail::fix_byte_sum(value) + static_cast<std::uint8_t>(FIX_DELIMITER);
+    pos_ += needed;
 }
 
-std::uint8_t FixMessageBuilder::calculate_checksum(std::string_view data) {
-    std::uint32_t sum = 0;
-    for (char c : data) {
-        sum += static_cast<std::uint8_t>(c);
+void FixMessageBuilder::append_raw(std::string_view bytes, std::uint32_t sum) {
+    if (overflowed_) return;
+    if (pos_ + bytes.size() > buffer_.size()) {
+        overflowed_ = true;
+        return;
     }
-    return static_cast<std::uint8_t>(sum % 256);
+    std::memcpy(buffer_.data() + pos_, bytes.data(), bytes.size());
+    checksum_ += sum;
+    pos_ += bytes.size();
 }
 
-std::string FixMessageBuilder::build() {
-    // Calculate body length (from after BodyLength field to before CheckSum)
-    std::size_t body_length = buffer_.size() - body_start_ - 6;  // -6 for "9=000|"
-    
-    // Update body length field
-    char len_buf[8];
-    std::snprintf(len_buf, sizeof(len_buf), "%03zu", body_length);
+std::string_view FixMessageBuilder::finish() {
+    if (!message_.empty() || overflowed_) return message_;
     
-    // Find and replace body length placeholder
-    auto body_len_pos = buffer_.find("9=000");
-    if (body_len_pos != std::string::npos) {
-        buffer_.replace(body_len_pos + 2, 3, len_buf);
+    constexpr std::size_t TRAILER_SIZE = 7;  // "10=NNN|"
+    if (pos_ + TRAILER_SIZE > buffer_.size()) {
+        overflowed_ = true;
+        return {};
     }
     
-    // Calculate checksum
-    auto checksum = calculate_checksum(buffer_);
+    // "9=<len>|" and "8=<begin>|" go right-aligned into the reserved gap
+    char* const body = buffer_.data() + HEADER_RESERVE;
+    char len_buf[24];
+    char* const len_end = len_buf + sizeof(len_buf);
+    char* len_start = len_end;
+    *--len_start = FIX_DELIMITER;
+    len_start = format_uint_backward(len_start, pos_ - HEADER_RESERVE);
+    *--len_start = '=';
+    *--len_start = '9';
+    const auto len_size = static_cast<std::size_t>(len_end - len_start);
+    
+    if (begin_prefix_.size() + len_size > HEADER_RESERVE) {
+        overflowed_ = true;
+        return {};
+    }
+    char* start = body - len_size;
+    std::memcpy(start, len_start, len_size);
+    start -= begin_prefix_.size();
+    std::memcpy(start, begin_prefix_.data(), begin_prefix_.size());
     
-    // Append checksum
-    char cs_buf[16];
-    std::snprintf(cs_buf, sizeof(cs_buf), "10=%03d%c", checksum, FIX_DELIMITER);
-    buffer_ += cs_buf;
+    const std::uint32_t sum = checksum_ + begin_prefix_sum_ +
+                              detail::fix_byte_sum(std::string_view(len_start, len_size));
+    char* trailer = buffer_.data() + pos_;
+    std::memcpy(trailer, "10=", 3);
+    format_uint_padded(trailer + 6, sum % 256, 3);
+    trailer[6] = FIX_DELIMITER;
+    pos_ += TRAILER_SIZE;
     
-    return buffer_;
+    message_ = std::string_view(start, static_cast<std::size_t>(buffer_.data() + pos_ - start));
+    return message_;
+}
+
+namespace {
+
+void encode_new_order(FixMessageBuilder& builder, const Order& order, const Symbol& symbol) {
+    builder.add_field(fix_tag::ClOrdID, static_cast<std::int64_t>(order.order_id))
+           .add_field(fix_tag::Symbol, symbol_view(symbol))
+           .add_field(fix_tag::Side, side_to_fix(order.side))
+           .add_field(fix_tag::OrderQty, order.quantity)
+           .add_field(fix_tag::OrdType, order_type_to_fix(order.type))
+           .add_price(fix_tag::Price, order.price);
 }
 
+} // namespace
+
 std::string order_to_fix(const Order& order,
+                          const Symbol& symbol,
                           std::string_view sender,
                           std::string_view target,
                           std::uint64_t seq_num) {
-    FixMessageBuilder builder;
+    thread_local FixMessageBuilder builder;
     
-    builder.begin(fix_msgtype::NewOrderSingle, sender, target, seq_num)
-           .add_field(fix_tag::ClOrdID, static_cast<std::int64_t>(order.order_id))
-           .add_field(fix_tag::Symbol, symbol_view(order.client_id > 0 ? 
-                      Symbol{} : Symbol{}))  // Would need actual symbol
-           .add_field(fix_tag::Side, side_to_fix(order.side))
-           .add_field(fix_tag::OrderQty, order.quantity)
-           .add_field(fix_tag::OrdType, order_type_to_fix(order.type))
-           .add_field(fix_tag::Price, to_double_price(order.price));
+    builder.begin(fix_msgtype::NewOrderSingle, sender, target, seq_num);
+    encode_new_order(builder, order, symbol);
     
     return builder.build();
 }
 
+std::string_view order_to_fix(FixMessageBuilder& builder,
+                              const FixSessionHeader& session,
+                              const Order& order,
+                              const Symbol& symbol,
+                              std::uint64_t seq_num) {
+    builder.begin(session, fix_msgtype::NewOrderSingle, seq_num);
+    encode_new_order(builder, order, symbol);
+    return builder.finish();
+}
+
+std::string_view execution_report_to_fix(FixMessageBuilder& builder,
+                                         const FixSessionHeader& session,
+                                         const ExecutionReport& report,
+                                         std::uint64_t seq_num) {
+    builder.begin(session, fix_msgtype::ExecutionReport, seq_num)
+           .add_field(fix_tag::OrderID, static_cast<std::int64_t>(report.order_id))
+           .add_field(fix_tag::ExecType, exec_type_to_fix(report.exec_type))
+           .add_field(fix_tag::OrdStatus, order_status_to_fix(report.order_status))
+           .add_field(fix_tag::Side, side_to_fix(report.side))
+           .add_field(fix_tag::LastQty, report.execution_quantity)
+           .add_price(fix_tag::LastPx, report.execution_price)
+           .add_field(fix_tag::LeavesQty, report.leaves_quantity)
+           .add_field(fix_tag::CumQty, report.cumulative_quantity);
+    return builder.finish();
+}
+
 std::optional<ExecutionReport> fix_to_execution_report(const FixMessage& msg) {
     if (msg.msg_type() != fix_msgtype::ExecutionReport) {
         return std::nullopt;
@@ -0,0 +1,416 @@
+/**
+ * @file json_feed_decoder.hpp
+ * @brief Allocation-free decoder for venue JSON market data
+ *
+ * Schema-specialised single-pass scanner for the trade and book messages
+ * WebSocket venues send. Nothing is materialised as std::string or double:
+ * - Decimal strings are parsed straight into fixed-point Price
+ * - Symbols are interned once into a dense SymbolId
+ * - Book levels land in a preallocated, reusable FeedBookUpdate
+ *
+ * Recognised keys: symbol, price, quantity/size, side, bids, asks.
+ * Levels are [price, quantity, ...] arrays, numbers or quoted strings.
+ * Everything else is skipped without being decoded.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+#include "core/types.hpp"
+
+namespace hft {
+
+using SymbolId = std::uint32_t;
+constexpr SymbolId INVALID_SYMBOL_ID = std::numeric_limits<SymbolId>::max();
+
+/**
+ * @brief Fixed-capacity symbol interner (open addressing, no allocation)
+ *
+ * Names longer than a Symbol are truncated, as make_symbol() does.
+ */
+template<std::size_t Capacity = 1024>
+class SymbolTable {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static constexpr std::size_t SLOT_COUNT = Capacity * 2;
+
+public:
+    SymbolTable() { slots_.fill(INVALID_SYMBOL_ID); }
+
+    /**
+     * @brief Id for a name, adding it on first sight
+     * @return INVALID_SYMBOL_ID if the name is empty or the table is full
+     */
+    SymbolId intern(std::string_view name) noexcept {
+        if (name.empty()) return INVALID_SYMBOL_ID;
+        const Symbol sym = make_symbol(name);
+
+        std::size_t slot = SymbolHash{}(sym) & (SLOT_COUNT - 1);
+        while (slots_[slot] != INVALID_SYMBOL_ID) {
+            if (symbols_[slots_[slot]] == sym) return slots_[slot];
+            slot = (slot + 1) & (SLOT_COUNT - 1);
+        }
+
+        if (size_ == Capacity) return INVALID_SYMBOL_ID;
+        const auto id = static_cast<SymbolId>(size_++);
+        symbols_[id] = sym;
+        slots_[slot] = id;
+        return id;
+    }
+
+    /**
+     * @brief Symbol for an id returned by intern()
+     */
+    [[nodiscard]] const Symbol& symbol(SymbolId id) const noexcept { return symbols_[id]; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+private:
+    std::array<Symbol, Capacity> symbols_{};      // id -> symbol
+    std::array<SymbolId, SLOT_COUNT> slots_;      // hash -> id
+    std::size_t size_ = 0;
+};
+
+/**
+ * @brief Parse a JSON decimal into fixed point with Decimals fractional digits
+ *
+ * Accepts an optional sign, fraction and exponent. Digits beyond the
+ * target precision are truncated, matching to_fixed_price().
+ */
+template<int Decimals>
+[[nodiscard]] constexpr std::optional<std::int64_t> parse_fixed(std::string_view s) noexcept {
+    constexpr int MAX_DIGITS = 18;   // Always fits in int64 before scaling
+
+    std::size_t i = 0;
+    const bool negative = i < s.size() && s[i] == '-';
+    if (negative || (i < s.size() && s[i] == '+')) ++i;
+
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int scale = Decimals;            // Power of ten still to apply
+    bool any = false;
+
+    for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i, any = true) {
+        if (digits < MAX_DIGITS) {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(s[i] - '0');
+            digits += mantissa != 0;
+        } else {
+            ++scale;
+        }
+    }
+    if (i < s.size() && s[i] == '.') {
+        for (++i; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i, any = true) {
+            if (digits < MAX_DIGITS) {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(s[i] - '0');
+                digits += mantissa != 0;
+                --scale;
+            }
+        }
+    }
+    if (!any) return std::nullopt;
+
+    if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+        ++i;
+        const bool exp_negative = i < s.size() && s[i] == '-';
+        if (exp_negative || (i < s.size() && s[i] == '+')) ++i;
+        int exponent = 0;
+        bool exp_any = false;
+        for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i, exp_any = true) {
+            if (exponent < 1000) exponent = exponent * 10 + (s[i] - '0');
+        }
+        if (!exp_any) return std::nullopt;
+        scale += exp_negative ? -exponent : exponent;
+    }
+    if (i != s.size()) return std::nullopt;
+
+    for (; scale < 0 && mantissa != 0; ++scale) mantissa /= 10;
+    for (; scale > 0 && mantissa != 0; --scale) {
+        if (mantissa > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) / 10) {
+            return std::nullopt;
+        }
+        mantissa *= 10;
+    }
+
+    const auto value = static_cast<std::int64_t>(mantissa);
+    return negative ? -value : value;
+}
+
+[[nodiscard]] constexpr std::optional<Price> parse_price(std::string_view s) noexcept {
+    return parse_fixed<8>(s);   // PRICE_MULTIPLIER = 1e8
+}
+
+[[nodiscard]] constexpr std::optional<Quantity> parse_quantity(std::string_view s) noexcept {
+    return parse_fixed<0>(s);
+}
+
+/**
+ * @brief Decoded trade
+ */
+struct FeedTrade {
+    Symbol symbol;
+    SymbolId symbol_id;
+    Price price;
+    Quantity quantity;
+    Side side;
+    Timestamp timestamp;
+};
+
+/**
+ * @brief Decoded book update; preallocated and reused across messages
+ */
+struct FeedBookUpdate {
+    static constexpr std::size_t MAX_LEVELS = 64;
+
+    struct Level {
+        Price price;
+        Quantity quantity;
+    };
+
+    Symbol symbol;
+    SymbolId symbol_id;
+    Timestamp timestamp;
+    std::uint32_t bid_count = 0;
+    std::uint32_t ask_count = 0;
+    bool truncated = false;         // More than MAX_LEVELS levels on a side
+    std::array<Level, MAX_LEVELS> bids;
+    std::array<Level, MAX_LEVELS> asks;
+
+    void clear() noexcept {
+        bid_count = 0;
+        ask_count = 0;
+        truncated = false;
+    }
+};
+
+enum class FeedMessageType : std::uint8_t {
+    INVALID,    // Malformed, or no symbol
+    OTHER,      // Well-formed but neither trade nor book (acks, heartbeats)
+    TRADE,
+    BOOK
+};
+
+/**
+ * @brief Single-pass JSON trade/book decoder
+ */
+class JsonFeedDecoder {
+public:
+    /**
+     * @brief Decode a message into the decoder's own trade()/book()
+     */
+    FeedMessageType decode(std::string_view json) noexcept {
+        return decode(json, trade_, book_);
+    }
+
+    /**
+     * @brief Decode a message into caller-owned outputs
+     *
+     * Only the output matching the returned type is meaningful.
+     */
+    FeedMessageType decode(std::string_view json, FeedTrade& trade, FeedBookUpdate& book) noexcept {
+        Cursor c{json.data(), json.data() + json.size()};
+        book.clear();
+
+        std::string_view symbol;
+        std::string_view price;
+        std::string_view quantity;
+        std::string_view side;
+        bool has_book = false;
+
+        c.skip_ws();
+        if (!c.consume('{')) return FeedMessageType::INVALID;
+        c.skip_ws();
+        if (c.consume('}')) return FeedMessageType::INVALID;
+
+        for (;;) {
+            c.skip_ws();
+            std::string_view key;
+            if (!c.read_string(key)) return FeedMessageType::INVALID;
+            c.skip_ws();
+            if (!c.consume(':')) return FeedMessageType::INVALID;
+            c.skip_ws();
+
+            bool ok;
+            if (key == "symbol") {
+                ok = c.read_scalar(symbol);
+            } else if (key == "price") {
+                ok = c.read_scalar(price);
+            } else if (key == "quantity" || key == "size") {
+                ok = c.read_scalar(quantity);
+            } else if (key == "side") {
+                ok = c.read_scalar(side);
+            } else if (key == "bids") {
+                ok = read_levels(c, book.bids, book.bid_count, book.truncated);
+                has_book = true;
+            } else if (key == "asks") {
+                ok = read_levels(c, book.asks, book.ask_count, book.truncated);
+                has_book = true;
+            } else {
+                ok = c.skip_value();
+            }
+            if (!ok) return FeedMessageType::INVALID;
+
+            c.skip_ws();
+            if (c.consume(',')) continue;
+            if (c.consume('}')) break;
+            return FeedMessageType::INVALID;
+        }
+
+        if (symbol.empty()) return FeedMessageType::INVALID;
+        const SymbolId id = symbols_.intern(symbol);
+        const Symbol& sym = id != INVALID_SYMBOL_ID ? symbols_.symbol(id) : (scratch_ = make_symbol(symbol));
+
+        if (has_book) {
+            book.symbol = sym;
+            book.symbol_id = id;
+            book.timestamp = now();
+            return FeedMessageType::BOOK;
+        }
+
+        if (price.empty()) return FeedMessageType::OTHER;
+        auto px = parse_price(price);
+        auto qty = quantity.empty() ? std::optional<Quantity>(0) : parse_quantity(quantity);
+        if (!px || !qty) return FeedMessageType::INVALID;
+
+        trade.symbol = sym;
+        trade.symbol_id = id;
+        trade.price = *px;
+        trade.quantity = *qty;
+        trade.side = (!side.empty() && (side[0] == 'B' || side[0] == 'b')) ? Side::BUY : Side::SELL;
+        trade.timestamp = now();
+        return FeedMessageType::TRADE;
+    }
+
+    [[nodiscard]] const FeedTrade& trade() const noexcept { return trade_; }
+    [[nodiscard]] const FeedBookUpdate& book() const noexcept { return book_; }
+
+    [[nodiscard]] SymbolTable<>& symbols() noexcept { return symbols_; }
+    [[nodiscard]] const SymbolTable<>& symbols() const noexcept { return symbols_; }
+
+private:
+    struct Cursor {
+        const char* p;
+        const char* end;
+
+        void skip_ws() noexcept {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+        }
+
+        bool consume(char ch) noexcept {
+            if (p < end && *p == ch) {
+                ++p;
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Raw contents of a string (escapes are skipped, not decoded)
+         */
+        bool read_string(std::string_view& out) noexcept {
+            if (!consume('"')) return false;
+            const char* start = p;
+            while (p < end && *p != '"') {
+                p += (*p == '\\') ? 2 : 1;
+            }
+            if (p >= end) return false;
+            out = std::string_view(start, static_cast<std::size_t>(p - start));
+            ++p;
+            return true;
+        }
+
+        /**
+         * @brief A string's contents, or a bare number/literal token
+         */
+        bool read_scalar(std::string_view& out) noexcept {
+            if (p < end && *p == '"') return read_string(out);
+            const char* start = p;
+            while (p < end && *p != ',' && *p != '}' && *p != ']' &&
+                   *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') {
+                ++p;
+            }
+            out = std::string_view(start, static_cast<std::size_t>(p - start));
+            return !out.empty() && *start != '{' && *start != '[';
+        }
+
+        bool skip_value() noexcept {
+            if (p >= end) return false;
+            if (*p != '{' && *p != '[') {
+                std::string_view ignored;
+                return read_scalar(ignored);
+            }
+            int depth = 0;
+            while (p < end) {
+                const char ch = *p;
+                if (ch == '"') {
+                    std::string_view ignored;
+                    if (!read_string(ignored)) return false;
+                    continue;
+                }
+                ++p;
+                if (ch == '{' || ch == '[') {
+                    ++depth;
+                } else if ((ch == '}' || ch == ']') && --depth == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    /**
+     * @brief Read [[price, qty, ...], ...] into levels; extras beyond capacity are dropped
+     */
+    static bool read_levels(Cursor& c, std::array<FeedBookUpdate::Level, FeedBookUpdate::MAX_LEVELS>& levels,
+                            std::uint32_t& count, bool& truncated) noexcept {
+        if (!c.consume('[')) return false;
+        c.skip_ws();
+        if (c.consume(']')) return true;
+
+        for (;;) {
+            c.skip_ws();
+            if (!c.consume('[')) return false;
+            c.skip_ws();
+
+            std::string_view price;
+            std::string_view quantity;
+            if (!c.read_scalar(price)) return false;
+            c.skip_ws();
+            if (!c.consume(',')) return false;
+            c.skip_ws();
+            if (!c.read_scalar(quantity)) return false;
+
+            // Venue-specific trailing fields (order count, ...)
+            for (c.skip_ws(); c.consume(','); c.skip_ws()) {
+                c.skip_ws();
+                if (!c.skip_value()) return false;
+            }
+            if (!c.consume(']')) return false;
+
+            auto px = parse_price(price);
+            auto qty = parse_quantity(quantity);
+            if (!px || !qty) return false;
+            if (count < levels.size()) {
+                levels[count++] = {*px, *qty};
+            } else {
+                truncated = true;
+            }
+
+            c.skip_ws();
+            if (c.consume(',')) continue;
+            return c.consume(']');
+        }
+    }
+
+    SymbolTable<> symbols_;
+    Symbol scratch_{};              // Symbol storage when the table is full
+    FeedTrade trade_{};
+    FeedBookUpdate book_{};
+};
+
+} // namespace hft
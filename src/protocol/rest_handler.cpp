@@ -7,7 +7,11 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cerrno>
+#include <charconv>
 #include <cstring>
+#include <iterator>
+#include <limits>
 
 #ifdef __linux__
 #include <sys/socket.h>
@@ -19,58 +23,90 @@
 
 namespace hft {
 
-std::optional<std::string_view> HttpRequest::get_header(std::string_view name) const {
-    std::string lower_name(name);
-    std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
-    
-    for (const auto& [key, value] : headers) {
-        std::string lower_key(key);
-        std::transform(lower_key.begin(), lower_key.end(), lower_key.begin(), ::tolower);
-        if (lower_key == lower_name) {
-            return value;
-        }
+namespace {
+
+constexpr std::size_t METHOD_COUNT = static_cast<std::size_t>(HttpMethod::UNKNOWN) + 1;
+
+/**
+ * @brief Pop the next '/'-separated segment off the front of rest
+ */
+std::string_view next_segment(std::string_view& rest) {
+    if (!rest.empty() && rest.front() == '/') {
+        rest.remove_prefix(1);
     }
-    return std::nullopt;
+    auto end = rest.find('/');
+    std::string_view segment = rest.substr(0, end);
+    rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end);
+    return segment;
 }
 
-std::optional<std::string_view> HttpRequest::get_query_param(std::string_view name) const {
-    std::string name_str(name);
-    auto it = query_params.find(name_str);
-    if (it != query_params.end()) {
-        return it->second;
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
     }
-    return std::nullopt;
+    return value;
+}
+
+void append_number(std::string& out, std::size_t value) {
+    char digits[24];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+    (void)ec;
+    out.append(digits, end);
+}
+
+} // namespace
+
+std::optional<std::string_view> HttpRequest::get_header(std::string_view name) const {
+    return headers.find_icase(name);
+}
+
+std::optional<std::string_view> HttpRequest::get_query_param(std::string_view name) const {
+    return query_params.find(name);
 }
 
 std::optional<std::string_view> HttpRequest::get_path_param(std::string_view name) const {
-    std::string name_str(name);
-    auto it = path_params.find(name_str);
-    if (it != path_params.end()) {
-        return it->second;
-    }
-    return std::nullopt;
+    return path_params.find(name);
 }
 
-std::string HttpResponse::build() const {
-    std::ostringstream ss;
-    ss << "HTTP/1.1 " << static_cast<int>(status_) << " " << status_text(status_) << "\r\n";
+void HttpResponse::write_to(std::string& out, bool keep_alive) const {
+    const std::string_view body = get_body();
+
+    out.append("HTTP/1.1 ");
+    append_number(out, static_cast<std::size_t>(status_));
+    out.push_back(' ');
+    out.append(status_text(status_));
+    out.append("\r\n");
     
     // Default headers
-    ss << "Connection: keep-alive\r\n";
-    ss << "Content-Length: " << body_.size() << "\r\n";
+    out.append(keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n");
+    out.append("Content-Length: ");
+    append_number(out, body.size());
+    out.append("\r\n");
     
     // Custom headers
-    for (const auto& [name, value] : headers_) {
-        ss << name << ": " << value << "\r\n";
+    for (std::size_t i = 0; i < header_count_; ++i) {
+        out.append(headers_[i].name);
+        out.append(": ");
+        out.append(headers_[i].value);
+        out.append("\r\n");
     }
     
-    ss << "\r\n";
-    ss << body_;
-    
-    return ss.str();
+    out.append("\r\n");
+    out.append(body);
+}
+
+std::string HttpResponse::build() const {
+    std::string out;
+    write_to(out);
+    return out;
 }
 
 int HttpParser::parse(std::string_view data, HttpRequest& request) {
+    request.clear();
+
     // Find end of headers
     auto header_end = data.find("\r\n\r\n");
     if (header_end == std::string_view::npos) {
@@ -106,6 +142,11 @@ int HttpParser::parse(std::string_view data, HttpRequest& request) {
     } else {
         request.path = uri;
     }
+
+    // HTTP/1.0 closes by default
+    if (request_line.substr(path_end + 1) == "HTTP/1.0") {
+        request.keep_alive = false;
+    }
     
     // Parse headers
     std::size_t pos = line_end + 2;
@@ -114,35 +155,43 @@ int HttpParser::parse(std::string_view data, HttpRequest& request) {
         std::string_view header_line = data.substr(pos, next_line - pos);
         
         auto colon_pos = header_line.find(':');
-        if (colon_pos != std::string_view::npos) {
-            std::string name(header_line.substr(0, colon_pos));
-            std::string_view value = header_line.substr(colon_pos + 1);
-            
-            // Trim leading whitespace from value
-            while (!value.empty() && value[0] == ' ') {
-                value.remove_prefix(1);
-            }
-            
-            request.headers[name] = value;
+        if (colon_pos != std::string_view::npos &&
+            !request.headers.add(header_line.substr(0, colon_pos),
+                                 trim(header_line.substr(colon_pos + 1)))) {
+            return -1;  // Too many headers
         }
         
         pos = next_line + 2;
     }
+
+    if (auto connection = request.get_header("Connection")) {
+        if (HttpHeaders::iequals(*connection, "close")) {
+            request.keep_alive = false;
+        } else if (HttpHeaders::iequals(*connection, "keep-alive")) {
+            request.keep_alive = true;
+        }
+    }
     
     // Get body if Content-Length specified
     std::size_t content_length = 0;
-    auto cl_it = request.headers.find("Content-Length");
-    if (cl_it != request.headers.end()) {
-        content_length = std::stoul(std::string(cl_it->second));
+    if (auto cl = request.get_header("Content-Length")) {
+        auto [end, ec] = std::from_chars(cl->data(), cl->data() + cl->size(), content_length);
+        if (ec != std::errc{} || end != cl->data() + cl->size()) {
+            return -1;
+        }
     }
     
-    std::size_t total_length = header_end + 4 + content_length;
+    const std::size_t body_start = header_end + 4;
+    if (content_length > static_cast<std::size_t>(std::numeric_limits<int>::max()) - body_start) {
+        return -1;
+    }
+    std::size_t total_length = body_start + content_length;
     if (data.size() < total_length) {
         return 0;  // Need more data
     }
     
     if (content_length > 0) {
-        request.body = data.substr(header_end + 4, content_length);
+        request.body = data.substr(body_start, content_length);
     }
     
     return static_cast<int>(total_length);
@@ -158,10 +207,7 @@ HttpMethod HttpParser::parse_method(std::string_view method) {
     return HttpMethod::UNKNOWN;
 }
 
-void HttpParser::parse_query_string(
-    std::string_view query,
-    std::unordered_map<std::string, std::string_view>& params
-) {
+void HttpParser::parse_query_string(std::string_view query, HttpParams& params) {
     std::size_t pos = 0;
     while (pos < query.size()) {
         auto amp_pos = query.find('&', pos);
@@ -169,10 +215,9 @@ void HttpParser::parse_query_string(
             amp_pos == std::string_view::npos ? std::string_view::npos : amp_pos - pos);
         
         auto eq_pos = pair.find('=');
-        if (eq_pos != std::string_view::npos) {
-            std::string name(pair.substr(0, eq_pos));
-            std::string_view value = pair.substr(eq_pos + 1);
-            params[name] = value;
+        if (eq_pos != std::string_view::npos &&
+            !params.add(pair.substr(0, eq_pos), pair.substr(eq_pos + 1))) {
+            break;  // Extra parameters are dropped
         }
         
         if (amp_pos == std::string_view::npos) break;
@@ -199,8 +244,7 @@ std::string HttpParser::url_decode(std::string_view str) {
     return result;
 }
 
-bool Route::match(HttpMethod m, std::string_view path,
-                  std::unordered_map<std::string, std::string_view>& params) const {
+bool Route::match(HttpMethod m, std::string_view path, HttpParams& params) const {
     if (m != method) return false;
     
     // Simple pattern matching with path parameters
@@ -224,7 +268,7 @@ bool Route::match(HttpMethod m, std::string_view path,
             }
             
             if (param_idx < param_names.size()) {
-                params[param_names[param_idx]] = path.substr(path_pos, value_end - path_pos);
+                params.add(param_names[param_idx], path.substr(path_pos, value_end - path_pos));
             }
             ++param_idx;
             
@@ -241,32 +285,105 @@ bool Route::match(HttpMethod m, std::string_view path,
     return pattern_pos == pattern.size() && path_pos == path.size();
 }
 
+/**
+ * @brief Trie node: one path segment
+ */
+struct HttpRouter::Node {
+    std::string segment;
+    std::vector<std::unique_ptr<Node>> children;    // Literal segments
+    std::unique_ptr<Node> param;                    // ":name" segment
+    std::array<std::int32_t, METHOD_COUNT> routes;  // Index into routes_, -1 if none
+
+    Node() { routes.fill(-1); }
+};
+
+HttpRouter::HttpRouter() : root_(std::make_unique<Node>()) {}
+HttpRouter::~HttpRouter() = default;
+HttpRouter::HttpRouter(HttpRouter&&) noexcept = default;
+HttpRouter& HttpRouter::operator=(HttpRouter&&) noexcept = default;
+
 void HttpRouter::add_route(HttpMethod method, std::string_view pattern, RouteHandler handler) {
     Route route;
     route.method = method;
     route.pattern = std::string(pattern);
     route.handler = std::move(handler);
     
-    // Extract parameter names
-    std::size_t pos = 0;
-    while ((pos = route.pattern.find(':', pos)) != std::string::npos) {
-        auto end = route.pattern.find('/', pos);
-        if (end == std::string::npos) {
-            end = route.pattern.size();
+    // Walk/extend the trie, extracting parameter names
+    Node* node = root_.get();
+    std::string_view rest = pattern;
+    while (!rest.empty()) {
+        std::string_view segment = next_segment(rest);
+        if (!segment.empty() && segment.front() == ':') {
+            route.param_names.emplace_back(segment.substr(1));
+            if (!node->param) {
+                node->param = std::make_unique<Node>();
+            }
+            node = node->param.get();
+            continue;
+        }
+
+        auto it = std::find_if(node->children.begin(), node->children.end(),
+                               [segment](const auto& child) { return child->segment == segment; });
+        if (it == node->children.end()) {
+            node->children.push_back(std::make_unique<Node>());
+            node->children.back()->segment = std::string(segment);
+            it = std::prev(node->children.end());
         }
-        route.param_names.push_back(route.pattern.substr(pos + 1, end - pos - 1));
-        pos = end;
+        node = it->get();
     }
     
-    routes_.push_back(std::move(route));
+    auto& slot = node->routes[static_cast<std::size_t>(method)];
+    if (slot >= 0) {
+        routes_[static_cast<std::size_t>(slot)] = std::move(route);
+    } else {
+        slot = static_cast<std::int32_t>(routes_.size());
+        routes_.push_back(std::move(route));
+    }
 }
 
-HttpResponse HttpRouter::route(HttpRequest& request) const {
-    for (const auto& r : routes_) {
-        if (r.match(request.method, request.path, request.path_params)) {
-            return r.handler(request);
+const Route* HttpRouter::find_in(const Node& node, std::string_view path, HttpMethod method,
+                                 std::size_t depth,
+                                 std::array<std::string_view, MAX_PATH_PARAMS>& values) const {
+    if (path.empty()) {
+        const auto index = node.routes[static_cast<std::size_t>(method)];
+        return index >= 0 ? &routes_[static_cast<std::size_t>(index)] : nullptr;
+    }
+
+    std::string_view rest = path;
+    std::string_view segment = next_segment(rest);
+
+    for (const auto& child : node.children) {
+        if (child->segment == segment) {
+            if (const Route* route = find_in(*child, rest, method, depth, values)) {
+                return route;
+            }
+            break;
         }
     }
+
+    if (node.param && !segment.empty() && depth < MAX_PATH_PARAMS) {
+        values[depth] = segment;
+        return find_in(*node.param, rest, method, depth + 1, values);
+    }
+    return nullptr;
+}
+
+const Route* HttpRouter::find(HttpRequest& request) const {
+    std::array<std::string_view, MAX_PATH_PARAMS> values;
+    const Route* route = find_in(*root_, request.path, request.method, 0, values);
+    if (route) {
+        request.path_params.clear();
+        for (std::size_t i = 0; i < route->param_names.size(); ++i) {
+            request.path_params.add(route->param_names[i], values[i]);
+        }
+    }
+    return route;
+}
+
+HttpResponse HttpRouter::route(HttpRequest& request) const {
+    if (const Route* r = find(request)) {
+        return r->handler(request);
+    }
     
     return HttpResponse(HttpStatus::NOT_FOUND)
         .json(json_response::error("Route not found", "NOT_FOUND"));
@@ -318,12 +435,12 @@ std::string quote(const Quote& q, std::string_view symbol) {
     return ss.str();
 }
 
-std::string depth(const std::vector<std::pair<Price, Quantity>>& bids,
-                  const std::vector<std::pair<Price, Quantity>>& asks,
-                  std::string_view symbol) {
+std::string depth(std::span<const std::pair<Price, Quantity>> bids,
+                  std::span<const std::pair<Price, Quantity>> asks,
+                  std::string_view symbol, std::uint64_t sequence) {
     std::ostringstream ss;
     ss << std::fixed << std::setprecision(8);
-    ss << R"({"symbol":")" << symbol << R"(","bids":[)";
+    ss << R"({"symbol":")" << symbol << R"(","sequence":)" << sequence << R"(,"bids":[)";
     
     for (std::size_t i = 0; i < bids.size(); ++i) {
         if (i > 0) ss << ",";
@@ -402,8 +519,8 @@ std::optional<OrderRequestJson> parse_order_request(std::string_view json) {
 }
 
 // HTTP Server implementation
-HttpServer::HttpServer(std::uint16_t port) 
-    : port_(port), server_fd_(-1), running_(false) {}
+HttpServer::HttpServer(std::uint16_t port, const ReactorConfig& reactor_config) 
+    : port_(port), server_fd_(-1), running_(false), reactor_(reactor_config) {}
 
 HttpServer::~HttpServer() {
     stop();
@@ -434,6 +551,11 @@ bool HttpServer::start() {
         return false;
     }
     
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(server_fd_, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) == 0) {
+        port_ = ntohs(addr.sin_port);
+    }
+    
     // Listen
     if (listen(server_fd_, 128) < 0) {
         close(server_fd_);
@@ -445,6 +567,14 @@ bool HttpServer::start() {
     int flags = fcntl(server_fd_, F_GETFL, 0);
     fcntl(server_fd_, F_SETFL, flags | O_NONBLOCK);
     
+    // Register with the reactor
+    if (!reactor_.init() ||
+        !reactor_.listen(server_fd_, [this](int client_fd) { accept_connection(client_fd); })) {
+        close(server_fd_);
+        server_fd_ = -1;
+        return false;
+    }
+    
     running_ = true;
     return true;
 #else
@@ -455,7 +585,11 @@ bool HttpServer::start() {
 void HttpServer::stop() {
     running_ = false;
 #ifdef __linux__
+    while (!connections_.empty()) {
+        close_connection(connections_.begin()->first);
+    }
     if (server_fd_ >= 0) {
+        reactor_.remove(server_fd_);
         close(server_fd_);
         server_fd_ = -1;
     }
@@ -464,63 +598,157 @@ void HttpServer::stop() {
 
 void HttpServer::poll() {
     if (!running_) return;
-    accept_connection();
+    reactor_.poll(0);
 }
 
 void HttpServer::run() {
-    while (running_) {
-        poll();
-    }
+    reactor_.run(running_);
 }
 
-void HttpServer::accept_connection() {
+void HttpServer::accept_connection(int client_fd) {
 #ifdef __linux__
-    struct sockaddr_in client_addr{};
-    socklen_t client_len = sizeof(client_addr);
-    
-    int client_fd = accept(server_fd_, 
-                           reinterpret_cast<struct sockaddr*>(&client_addr), 
-                           &client_len);
-    
-    if (client_fd >= 0) {
-        // Set TCP_NODELAY
-        int opt = 1;
-        setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
-        
-        handle_connection(client_fd);
+    // Set TCP_NODELAY
+    int opt = 1;
+    setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    
+    Connection& conn = connections_[client_fd];
+    conn.in.resize(READ_CHUNK);
+    if (!reactor_.watch(client_fd, IO_READ | IO_WRITE, [this](int fd, std::uint32_t events) {
+            on_ready(fd, events);
+        })) {
+        connections_.erase(client_fd);
         close(client_fd);
     }
+#else
+    (void)client_fd;
 #endif
 }
 
-void HttpServer::handle_connection(int client_fd) {
-#ifdef __linux__
-    char buffer[8192];
-    ssize_t n = recv(client_fd, buffer, sizeof(buffer) - 1, 0);
+void HttpServer::on_ready(int client_fd, std::uint32_t events) {
+    auto it = connections_.find(client_fd);
+    if (it == connections_.end()) return;
+    Connection& conn = it->second;
     
-    if (n <= 0) return;
-    buffer[n] = '\0';
-    
-    HttpRequest request;
-    int parsed = HttpParser::parse(std::string_view(buffer, n), request);
+    if (events & IO_ERROR) {
+        close_connection(client_fd);
+        return;
+    }
     
-    if (parsed <= 0) {
-        // Invalid or incomplete request
-        HttpResponse response(HttpStatus::BAD_REQUEST);
-        response.json(json_response::error("Invalid request", "BAD_REQUEST"));
-        std::string resp_str = response.build();
-        send(client_fd, resp_str.data(), resp_str.size(), MSG_NOSIGNAL);
+    // Writable again: drain responses held back by a full socket buffer,
+    // then resume reading if that backlog had paused it
+    const bool was_throttled = conn.out.size() - conn.out_sent >= MAX_OUTPUT_BACKLOG;
+    if (!flush(client_fd, conn)) {
+        close_connection(client_fd);
         return;
     }
     
-    // Route and handle
-    HttpResponse response = router_.route(request);
-    std::string resp_str = response.build();
-    send(client_fd, resp_str.data(), resp_str.size(), MSG_NOSIGNAL);
+    if ((events & (IO_READ | IO_CLOSED)) || was_throttled) {
+        if (!read_available(client_fd, conn) || !flush(client_fd, conn)) {
+            close_connection(client_fd);
+            return;
+        }
+    }
+    
+    if (conn.close_after_flush && conn.out_sent == conn.out.size()) {
+        close_connection(client_fd);
+    }
+}
+
+bool HttpServer::read_available(int client_fd, Connection& conn) {
+#ifdef __linux__
+    // Edge-triggered: read until EAGAIN unless the peer is not draining
+    // its responses, in which case stop until the socket is writable
+    while (!conn.close_after_flush && conn.out.size() - conn.out_sent < MAX_OUTPUT_BACKLOG) {
+        if (conn.in.size() - conn.in_len < READ_CHUNK) {
+            conn.in.resize(std::max(conn.in.size() * 2, conn.in_len + READ_CHUNK));
+        }
+        
+        ssize_t n = recv(client_fd, conn.in.data() + conn.in_len, conn.in.size() - conn.in_len, 0);
+        if (n > 0) {
+            conn.in_len += static_cast<std::size_t>(n);
+            process_requests(conn);
+        } else if (n == 0) {
+            conn.close_after_flush = true;  // Peer closed; answer what it sent
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+#else
+    (void)client_fd;
+    (void)conn;
+    return false;
+#endif
+}
+
+void HttpServer::process_requests(Connection& conn) {
+    // Pipelining: answer every complete request in the buffer, in order
+    std::size_t offset = 0;
+    while (!conn.close_after_flush) {
+        std::string_view pending(conn.in.data() + offset, conn.in_len - offset);
+        int parsed = HttpParser::parse(pending, request_);
+        
+        if (parsed == 0 && pending.size() < MAX_REQUEST_SIZE) {
+            break;  // Wait for the rest of the request
+        }
+        
+        if (parsed <= 0) {
+            // Invalid or oversized request
+            HttpResponse(HttpStatus::BAD_REQUEST)
+                .json(json_response::error("Invalid request", "BAD_REQUEST"))
+                .write_to(conn.out, false);
+            conn.close_after_flush = true;
+            break;
+        }
+        
+        // Route and handle
+        router_.route(request_).write_to(conn.out, request_.keep_alive);
+        conn.close_after_flush = !request_.keep_alive;
+        offset += static_cast<std::size_t>(parsed);
+    }
+    
+    // Keep any partial request at the front of the buffer
+    if (conn.close_after_flush) {
+        conn.in_len = 0;
+    } else if (offset > 0) {
+        std::memmove(conn.in.data(), conn.in.data() + offset, conn.in_len - offset);
+        conn.in_len -= offset;
+    }
+}
+
+bool HttpServer::flush(int client_fd, Connection& conn) {
+#ifdef __linux__
+    while (conn.out_sent < conn.out.size()) {
+        ssize_t n = send(client_fd, conn.out.data() + conn.out_sent,
+                         conn.out.size() - conn.out_sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.out_sent += static_cast<std::size_t>(n);
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;    // Resume on IO_WRITE
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    conn.out.clear();       // Keeps capacity for the next responses
+    conn.out_sent = 0;
+    return true;
 #else
     (void)client_fd;
+    (void)conn;
+    return false;
 #endif
 }
 
-} // namespace hft
+void HttpServer::close_connection(int client_fd) {
+#ifdef __linux__
+    reactor_.remove(client_fd);
+    close(client_fd);
+#endif
+    connections_.erase(client_fd);
+}
 
+} // namespace hft
@@ -17,7 +17,12 @@
 #include <unordered_map>
 #include <functional>
 #include <optional>
+#include <array>
+#include <span>
+#include <atomic>
+#include <memory>
 #include <vector>
+#include "core/reactor.hpp"
 #include "core/types.hpp"
 
 namespace hft {
@@ -71,28 +76,121 @@ enum class HttpStatus : int {
     return "Unknown";
 }
 
+/**
+ * @brief Name/value pair viewing into the request buffer
+ */
+struct HttpField {
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * @brief Fixed-capacity field list (no heap allocation per request)
+ */
+template<std::size_t Capacity>
+class HttpFieldList {
+public:
+    /**
+     * @brief Append a field
+     * @return false if the list is full
+     */
+    bool add(std::string_view name, std::string_view value) noexcept {
+        if (count_ == Capacity) return false;
+        fields_[count_++] = {name, value};
+        return true;
+    }
+
+    /**
+     * @brief First field with an exactly matching name
+     */
+    [[nodiscard]] std::optional<std::string_view> find(std::string_view name) const noexcept {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (fields_[i].name == name) return fields_[i].value;
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief First field whose name matches ignoring ASCII case
+     */
+    [[nodiscard]] std::optional<std::string_view> find_icase(std::string_view name) const noexcept {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (iequals(fields_[i].name, name)) return fields_[i].value;
+        }
+        return std::nullopt;
+    }
+
+    void clear() noexcept { count_ = 0; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    [[nodiscard]] const HttpField* begin() const noexcept { return fields_.data(); }
+    [[nodiscard]] const HttpField* end() const noexcept { return fields_.data() + count_; }
+
+    [[nodiscard]] static bool iequals(std::string_view a, std::string_view b) noexcept {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if ((a[i] | 0x20) != (b[i] | 0x20)) return false;
+        }
+        return true;
+    }
+
+private:
+    std::array<HttpField, Capacity> fields_{};
+    std::size_t count_ = 0;
+};
+
+using HttpHeaders = HttpFieldList<32>;
+using HttpParams = HttpFieldList<16>;
+
 /**
  * @brief Parsed HTTP request
+ *
+ * All views point into the connection's receive buffer (and, for path
+ * parameter names, into the router), so a request is only valid while
+ * its handler runs.
  */
 struct HttpRequest {
     HttpMethod method = HttpMethod::UNKNOWN;
     std::string_view path;
     std::string_view query_string;
     std::string_view body;
-    std::unordered_map<std::string, std::string_view> headers;
-    std::unordered_map<std::string, std::string_view> query_params;
-    std::unordered_map<std::string, std::string_view> path_params;
+    HttpHeaders headers;
+    HttpParams query_params;
+    HttpParams path_params;
+    bool keep_alive = true;     // HTTP/1.1 default, cleared by "Connection: close"
     
     [[nodiscard]] std::optional<std::string_view> get_header(std::string_view name) const;
     [[nodiscard]] std::optional<std::string_view> get_query_param(std::string_view name) const;
     [[nodiscard]] std::optional<std::string_view> get_path_param(std::string_view name) const;
+
+    /**
+     * @brief Reset for reuse by the next request on a connection
+     */
+    void clear() noexcept {
+        method = HttpMethod::UNKNOWN;
+        path = {};
+        query_string = {};
+        body = {};
+        headers.clear();
+        query_params.clear();
+        path_params.clear();
+        keep_alive = true;
+    }
 };
 
 /**
  * @brief HTTP response builder
+ *
+ * Bodies passed as string_view must outlive the response; temporaries
+ * (e.g. the json_response helpers) are moved in and owned.
  */
 class HttpResponse {
 public:
+    static constexpr std::size_t MAX_HEADERS = 8;
+
     HttpResponse() : status_(HttpStatus::OK) {}
     explicit HttpResponse(HttpStatus status) : status_(status) {}
 
@@ -102,7 +200,9 @@ public:
     }
 
     HttpResponse& header(std::string_view name, std::string_view value) {
-        headers_.emplace_back(name, value);
+        if (header_count_ < MAX_HEADERS) {
+            headers_[header_count_++] = {name, value};
+        }
         return *this;
     }
 
@@ -111,15 +211,42 @@ public:
     }
 
     HttpResponse& json(std::string_view body) {
-        body_ = body;
-        return content_type("application/json");
+        return this->body(body).content_type("application/json");
+    }
+
+    HttpResponse& json(const char* body) {
+        return json(std::string_view(body));
+    }
+
+    HttpResponse& json(std::string&& body) {
+        return this->body(std::move(body)).content_type("application/json");
     }
 
     HttpResponse& body(std::string_view b) {
         body_ = b;
+        owned_body_.clear();
+        owns_body_ = false;
+        return *this;
+    }
+
+    HttpResponse& body(const char* b) {
+        return body(std::string_view(b));
+    }
+
+    HttpResponse& body(std::string&& b) {
+        owned_body_ = std::move(b);
+        owns_body_ = true;
         return *this;
     }
 
+    /**
+     * @brief Append the serialised response to out
+     *
+     * Reusing out across responses keeps the hot path allocation-free
+     * once its capacity has grown.
+     */
+    void write_to(std::string& out, bool keep_alive = true) const;
+
     /**
      * @brief Build the HTTP response string
      */
@@ -127,10 +254,17 @@ public:
 
     [[nodiscard]] HttpStatus get_status() const { return status_; }
 
+    [[nodiscard]] std::string_view get_body() const {
+        return owns_body_ ? std::string_view(owned_body_) : body_;
+    }
+
 private:
     HttpStatus status_;
-    std::vector<std::pair<std::string_view, std::string_view>> headers_;
+    std::array<HttpField, MAX_HEADERS> headers_{};
+    std::size_t header_count_ = 0;
     std::string_view body_;
+    std::string owned_body_;
+    bool owns_body_ = false;
 };
 
 /**
@@ -143,6 +277,8 @@ public:
      * @param data Raw HTTP data
      * @param request Output request structure
      * @return Number of bytes consumed, 0 if incomplete, -1 if invalid
+     *
+     * request is overwritten; views point into data.
      */
     static int parse(std::string_view data, HttpRequest& request);
 
@@ -154,10 +290,7 @@ public:
     /**
      * @brief Parse query string into key-value pairs
      */
-    static void parse_query_string(
-        std::string_view query,
-        std::unordered_map<std::string, std::string_view>& params
-    );
+    static void parse_query_string(std::string_view query, HttpParams& params);
 
     /**
      * @brief URL decode a string
@@ -179,17 +312,27 @@ struct Route {
     RouteHandler handler;
     std::vector<std::string> param_names;  // Path parameter names
     
-    [[nodiscard]] bool match(HttpMethod m, std::string_view path,
-                             std::unordered_map<std::string, std::string_view>& params) const;
+    [[nodiscard]] bool match(HttpMethod m, std::string_view path, HttpParams& params) const;
 };
 
 /**
  * @brief Minimal HTTP router
+ *
+ * Patterns are compiled into a trie of path segments at registration, so
+ * a lookup walks one node per segment instead of trying every route.
+ * Literal segments take precedence over ":param" segments.
  */
 class HttpRouter {
 public:
+    static constexpr std::size_t MAX_PATH_PARAMS = 8;
+
+    HttpRouter();
+    ~HttpRouter();
+    HttpRouter(HttpRouter&&) noexcept;
+    HttpRouter& operator=(HttpRouter&&) noexcept;
+
     /**
-     * @brief Register a route
+     * @brief Register a route (replaces an identical method + pattern)
      */
     void add_route(HttpMethod method, std::string_view pattern, RouteHandler handler);
 
@@ -210,13 +353,26 @@ public:
         add_route(HttpMethod::DELETE, pattern, std::move(handler));
     }
 
+    /**
+     * @brief Find the route for a request and fill request.path_params
+     * @return nullptr if no route matches
+     */
+    [[nodiscard]] const Route* find(HttpRequest& request) const;
+
     /**
      * @brief Route a request
      */
     [[nodiscard]] HttpResponse route(HttpRequest& request) const;
 
 private:
+    struct Node;
+
+    [[nodiscard]] const Route* find_in(const Node& node, std::string_view path,
+                                       HttpMethod method, std::size_t depth,
+                                       std::array<std::string_view, MAX_PATH_PARAMS>& values) const;
+
     std::vector<Route> routes_;
+    std::unique_ptr<Node> root_;
 };
 
 /**
@@ -231,9 +387,9 @@ namespace json_response {
     std::string order_cancelled(OrderId order_id);
     
     std::string quote(const Quote& quote, std::string_view symbol);
-    std::string depth(const std::vector<std::pair<Price, Quantity>>& bids,
-                      const std::vector<std::pair<Price, Quantity>>& asks,
-                      std::string_view symbol);
+    std::string depth(std::span<const std::pair<Price, Quantity>> bids,
+                      std::span<const std::pair<Price, Quantity>> asks,
+                      std::string_view symbol, std::uint64_t sequence = 0);
 }
 
 /**
@@ -252,10 +408,18 @@ std::optional<OrderRequestJson> parse_order_request(std::string_view json);
 
 /**
  * @brief Minimal HTTP server (single-threaded)
+ *
+ * Connections are multiplexed on a Reactor, so one thread serves any
+ * number of clients without scanning them. Connections are persistent
+ * (HTTP/1.1 keep-alive) and pipelined: every complete request in a read
+ * is parsed in place from the connection's receive buffer, and the
+ * responses are appended to the connection's output buffer and written
+ * with a single send(). Both buffers are reused for the lifetime of the
+ * connection.
  */
 class HttpServer {
 public:
-    explicit HttpServer(std::uint16_t port);
+    explicit HttpServer(std::uint16_t port, const ReactorConfig& reactor_config = {});
     ~HttpServer();
 
     HttpServer(const HttpServer&) = delete;
@@ -277,7 +441,7 @@ public:
     void stop();
 
     /**
-     * @brief Process pending connections (non-blocking)
+     * @brief Process pending connections and requests (non-blocking)
      */
     void poll();
 
@@ -286,17 +450,45 @@ public:
      */
     void run();
 
-    [[nodiscard]] bool is_running() const { return running_; }
+    [[nodiscard]] bool is_running() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Bound port (useful when constructed with port 0)
+     */
+    [[nodiscard]] std::uint16_t port() const { return port_; }
+
+    /**
+     * @brief Number of open client connections
+     */
+    [[nodiscard]] std::size_t connection_count() const { return connections_.size(); }
 
 private:
-    void accept_connection();
-    void handle_connection(int client_fd);
+    struct Connection {
+        std::string in;             // Received bytes; [0, in_len) is valid
+        std::size_t in_len = 0;
+        std::string out;            // Serialised responses; [out_sent, size) unsent
+        std::size_t out_sent = 0;
+        bool close_after_flush = false;
+    };
+
+    void accept_connection(int client_fd);
+    void on_ready(int client_fd, std::uint32_t events);
+    bool read_available(int client_fd, Connection& conn);
+    void process_requests(Connection& conn);
+    bool flush(int client_fd, Connection& conn);
+    void close_connection(int client_fd);
+
+    static constexpr std::size_t MAX_REQUEST_SIZE = 65536;
+    static constexpr std::size_t READ_CHUNK = 4096;
+    static constexpr std::size_t MAX_OUTPUT_BACKLOG = 1 << 20;  // Stop reading past this
 
     std::uint16_t port_;
     int server_fd_;
-    bool running_;
+    std::atomic<bool> running_;
     HttpRouter router_;
+    Reactor reactor_;
+    std::unordered_map<int, Connection> connections_;
+    HttpRequest request_;           // Reused for every parsed request
 };
 
 } // namespace hft
-
@@ -9,8 +9,15 @@
 #include <sstream>
 #include <iomanip>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #ifdef __linux__
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
@@ -24,30 +31,42 @@ namespace hft {
 // WebSocket GUID for handshake
 static constexpr std::string_view WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 
-std::size_t WebSocketParser::parse(std::string_view data, WebSocketFrame& frame) {
-    if (data.size() < 2) {
-        return 0;  // Need more data
+namespace {
+
+struct FrameHeader {
+    WebSocketOpcode opcode;
+    bool fin;
+    bool masked;
+    std::uint8_t mask[4];
+    std::size_t header_len;
+    std::size_t payload_len;
+};
+
+/**
+ * @brief Decode a frame header; false if the frame is not complete yet
+ */
+bool decode_header(const std::uint8_t* bytes, std::size_t size, FrameHeader& header) {
+    if (size < 2) {
+        return false;  // Need more data
     }
     
-    const auto* bytes = reinterpret_cast<const std::uint8_t*>(data.data());
-    
     // Parse first byte
-    frame.fin = (bytes[0] & 0x80) != 0;
-    frame.opcode = static_cast<WebSocketOpcode>(bytes[0] & 0x0F);
+    header.fin = (bytes[0] & 0x80) != 0;
+    header.opcode = static_cast<WebSocketOpcode>(bytes[0] & 0x0F);
     
     // Parse second byte
-    frame.masked = (bytes[1] & 0x80) != 0;
+    header.masked = (bytes[1] & 0x80) != 0;
     std::uint64_t payload_len = bytes[1] & 0x7F;
     
     std::size_t header_len = 2;
     
     // Extended payload length
     if (payload_len == 126) {
-        if (data.size() < 4) return 0;
+        if (size < 4) return false;
         payload_len = (static_cast<std::uint64_t>(bytes[2]) << 8) | bytes[3];
         header_len = 4;
     } else if (payload_len == 127) {
-        if (data.size() < 10) return 0;
+        if (size < 10) return false;
         payload_len = 0;
         for (int i = 0; i < 8; ++i) {
             payload_len = (payload_len << 8) | bytes[2 + i];
@@ -56,86 +75,166 @@ std::size_t WebSocketParser::parse(std::string_view data, WebSocketFrame& frame)
     }
     
     // Masking key
-    std::uint8_t mask[4] = {0, 0, 0, 0};
-    if (frame.masked) {
-        if (data.size() < header_len + 4) return 0;
-        std::memcpy(mask, bytes + header_len, 4);
+    if (header.masked) {
+        if (size < header_len + 4) return false;
+        std::memcpy(header.mask, bytes + header_len, 4);
         header_len += 4;
     }
     
     // Check if we have complete frame
-    if (data.size() < header_len + payload_len) {
+    if (payload_len > size - header_len) {
+        return false;
+    }
+    
+    header.header_len = header_len;
+    header.payload_len = static_cast<std::size_t>(payload_len);
+    return true;
+}
+
+} // namespace
+
+std::size_t WebSocketParser::parse(std::string_view data, WebSocketFrame& frame) {
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(data.data());
+    
+    FrameHeader header;
+    if (!decode_header(bytes, data.size(), header)) {
         return 0;
     }
     
+    frame.fin = header.fin;
+    frame.opcode = header.opcode;
+    frame.masked = header.masked;
+    
     // Extract payload
-    frame.payload.resize(payload_len);
-    std::memcpy(frame.payload.data(), bytes + header_len, payload_len);
+    const auto* payload = bytes + header.header_len;
+    frame.payload.assign(payload, payload + header.payload_len);
     
     // Unmask if needed
     if (frame.masked) {
-        apply_mask(frame.payload, mask);
+        apply_mask(frame.payload.data(), frame.payload.size(), header.mask);
     }
     
-    return header_len + payload_len;
+    return header.header_len + header.payload_len;
 }
 
-std::vector<std::uint8_t> WebSocketParser::encode(
-    WebSocketOpcode opcode,
-    std::string_view payload,
-    bool mask
-) {
-    std::vector<std::uint8_t> frame;
-    frame.reserve(14 + payload.size());  // Max header + payload
+std::size_t WebSocketParser::parse_in_place(std::uint8_t* data, std::size_t size,
+                                            WebSocketFrameView& frame) {
+    FrameHeader header;
+    if (!decode_header(data, size, header)) {
+        return 0;
+    }
+    
+    std::uint8_t* payload = data + header.header_len;
+    if (header.masked) {
+        apply_mask(payload, header.payload_len, header.mask);
+    }
+    
+    frame.fin = header.fin;
+    frame.opcode = header.opcode;
+    frame.masked = header.masked;
+    frame.payload = std::string_view(reinterpret_cast<const char*>(payload), header.payload_len);
+    
+    return header.header_len + header.payload_len;
+}
+
+std::size_t WebSocketParser::encode_header(std::uint8_t* out,
+                                           WebSocketOpcode opcode,
+                                           std::uint64_t payload_size,
+                                           const std::uint8_t* mask_key) {
+    std::size_t len = 0;
     
     // First byte: FIN + opcode
-    frame.push_back(0x80 | static_cast<std::uint8_t>(opcode));
+    out[len++] = 0x80 | static_cast<std::uint8_t>(opcode);
     
     // Second byte: mask flag + payload length
-    std::uint8_t mask_bit = mask ? 0x80 : 0x00;
-    
-    if (payload.size() < 126) {
-        frame.push_back(mask_bit | static_cast<std::uint8_t>(payload.size()));
-    } else if (payload.size() < 65536) {
-        frame.push_back(mask_bit | 126);
-        frame.push_back(static_cast<std::uint8_t>(payload.size() >> 8));
-        frame.push_back(static_cast<std::uint8_t>(payload.size() & 0xFF));
+    const std::uint8_t mask_bit = mask_key ? 0x80 : 0x00;
+    
+    if (payload_size < 126) {
+        out[len++] = mask_bit | static_cast<std::uint8_t>(payload_size);
+    } else if (payload_size < 65536) {
+        out[len++] = mask_bit | 126;
+        out[len++] = static_cast<std::uint8_t>(payload_size >> 8);
+        out[len++] = static_cast<std::uint8_t>(payload_size & 0xFF);
     } else {
-        frame.push_back(mask_bit | 127);
+        out[len++] = mask_bit | 127;
         for (int i = 7; i >= 0; --i) {
-            frame.push_back(static_cast<std::uint8_t>(payload.size() >> (8 * i)));
+            out[len++] = static_cast<std::uint8_t>(payload_size >> (8 * i));
         }
     }
     
     // Masking key (if client)
+    if (mask_key) {
+        std::memcpy(out + len, mask_key, 4);
+        len += 4;
+    }
+    
+    return len;
+}
+
+std::vector<std::uint8_t> WebSocketParser::encode(
+    WebSocketOpcode opcode,
+    std::string_view payload,
+    bool mask
+) {
     std::uint8_t mask_key[4] = {0, 0, 0, 0};
     if (mask) {
         std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, 255);
-        for (int i = 0; i < 4; ++i) {
-            mask_key[i] = static_cast<std::uint8_t>(dis(gen));
-            frame.push_back(mask_key[i]);
-        }
+        const std::uint32_t key = rd();
+        std::memcpy(mask_key, &key, 4);
     }
     
-    // Payload (masked if needed)
-    std::size_t start = frame.size();
-    frame.insert(frame.end(), payload.begin(), payload.end());
+    std::vector<std::uint8_t> frame(MAX_HEADER_SIZE + payload.size());
+    const std::size_t header_len = encode_header(frame.data(), opcode, payload.size(),
+                                                 mask ? mask_key : nullptr);
+    frame.resize(header_len + payload.size());
     
+    // Payload (masked if needed)
+    if (!payload.empty()) {
+        std::memcpy(frame.data() + header_len, payload.data(), payload.size());
+    }
     if (mask) {
-        for (std::size_t i = 0; i < payload.size(); ++i) {
-            frame[start + i] ^= mask_key[i % 4];
-        }
+        apply_mask(frame.data() + header_len, payload.size(), mask_key);
     }
     
     return frame;
 }
 
-void WebSocketParser::apply_mask(std::vector<std::uint8_t>& data,
-                                  const std::uint8_t mask[4]) {
-    for (std::size_t i = 0; i < data.size(); ++i) {
-        data[i] ^= mask[i % 4];
+void WebSocketParser::apply_mask(std::uint8_t* data, std::size_t size,
+                                 const std::uint8_t mask[4]) {
+    // Every vector step is a multiple of 4 bytes, so the key stays in phase
+    std::uint32_t key;
+    std::memcpy(&key, mask, 4);
+    std::size_t i = 0;
+    
+#if defined(__AVX2__)
+    const __m256i key256 = _mm256_set1_epi32(static_cast<int>(key));
+    for (; i + 32 <= size; i += 32) {
+        auto* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), key256));
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i key128 = _mm_set1_epi32(static_cast<int>(key));
+    for (; i + 16 <= size; i += 16) {
+        auto* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), key128));
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t key128 = vreinterpretq_u8_u32(vdupq_n_u32(key));
+    for (; i + 16 <= size; i += 16) {
+        vst1q_u8(data + i, veorq_u8(vld1q_u8(data + i), key128));
+    }
+#endif
+    
+    const std::uint64_t key64 = (static_cast<std::uint64_t>(key) << 32) | key;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        word ^= key64;
+        std::memcpy(data + i, &word, 8);
+    }
+    for (; i < size; ++i) {
+        data[i] ^= mask[i & 3];
     }
 }
 
@@ -253,6 +352,16 @@ bool WebSocketHandler::connect(std::string_view host,
         return false;
     }
     
+    // Keep any frames that arrived in the same segment as the handshake
+    auto header_end = response.find("\r\n\r\n");
+    recv_len_ = 0;
+    if (header_end != std::string_view::npos) {
+        header_end += 4;
+        recv_len_ = response.size() - header_end;
+        std::memmove(recv_buffer_.data(), recv_buffer_.data() + header_end, recv_len_);
+    }
+    mask_frames_ = true;
+    
     // Set non-blocking
     int flags = fcntl(fd_, F_GETFL, 0);
     fcntl(fd_, F_SETFL, flags | O_NONBLOCK);
@@ -270,6 +379,8 @@ bool WebSocketHandler::connect(std::string_view host,
 
 bool WebSocketHandler::accept(int client_fd, std::string_view request) {
     fd_ = client_fd;
+    mask_frames_ = false;  // Server-to-client frames are never masked
+    recv_len_ = 0;
     
     // Find Sec-WebSocket-Key
     auto key_pos = request.find("Sec-WebSocket-Key:");
@@ -318,13 +429,42 @@ bool WebSocketHandler::send_frame(WebSocketOpcode opcode, std::string_view data)
         return false;
     }
     
-    auto frame = WebSocketParser::encode(opcode, data, true);  // Client masks
+    std::uint8_t mask_key[4];
+    if (mask_frames_) {
+        const std::uint32_t key = static_cast<std::uint32_t>(mask_rng_());
+        std::memcpy(mask_key, &key, 4);
+    }
+    
+    const std::size_t header_len = WebSocketParser::encode_header(
+        send_header_, opcode, data.size(), mask_frames_ ? mask_key : nullptr);
+    
+    // Unmasked payloads go straight from the caller's buffer; masked ones
+    // are copied once into reusable scratch
+    const void* payload = data.data();
+    if (mask_frames_ && !data.empty()) {
+        send_payload_.assign(data.begin(), data.end());
+        WebSocketParser::apply_mask(send_payload_.data(), send_payload_.size(), mask_key);
+        payload = send_payload_.data();
+    }
     
 #ifdef __linux__
-    ssize_t sent = ::send(fd_, frame.data(), frame.size(), MSG_NOSIGNAL);
-    return sent == static_cast<ssize_t>(frame.size());
+    // Gather-write header + payload in one syscall (sendmsg rather than
+    // writev so MSG_NOSIGNAL applies)
+    iovec iov[2];
+    iov[0].iov_base = send_header_;
+    iov[0].iov_len = header_len;
+    iov[1].iov_base = const_cast<void*>(payload);
+    iov[1].iov_len = data.size();
+    
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = data.empty() ? 1 : 2;
+    
+    ssize_t sent = ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+    return sent == static_cast<ssize_t>(header_len + data.size());
 #else
-    (void)frame;
+    (void)header_len;
+    (void)payload;
     return false;
 #endif
 }
@@ -339,6 +479,11 @@ void WebSocketHandler::close() {
     // Send close frame
     send_frame(WebSocketOpcode::CLOSE, "");
     
+    if (reactor_) {
+        reactor_->remove(fd_);
+        reactor_ = nullptr;
+    }
+    
 #ifdef __linux__
     if (fd_ >= 0) {
         ::close(fd_);
@@ -354,46 +499,82 @@ void WebSocketHandler::poll() {
         return;
     }
     
-#ifdef __linux__
-    // Receive data
-    recv_buffer_.resize(RECV_BUFFER_SIZE);
-    ssize_t n = ::recv(fd_, recv_buffer_.data(), recv_buffer_.size(), MSG_DONTWAIT);
+    receive_available();
+    flush_send_queue();
+}
+
+bool WebSocketHandler::attach(Reactor& reactor) {
+    if (!is_connected() || reactor_) {
+        return false;
+    }
     
-    if (n > 0) {
-        // Append to partial buffer
-        partial_frame_.insert(partial_frame_.end(), 
-                              recv_buffer_.begin(), 
-                              recv_buffer_.begin() + n);
-        
-        // Try to parse frames
-        WebSocketFrame frame;
-        std::string_view data(reinterpret_cast<char*>(partial_frame_.data()),
-                              partial_frame_.size());
-        
-        while (!data.empty()) {
-            std::size_t consumed = parser_.parse(data, frame);
-            if (consumed == 0) {
-                break;  // Need more data
-            }
-            
-            handle_frame(frame);
-            data.remove_prefix(consumed);
+    if (!reactor.watch(fd_, IO_READ, [this](int, std::uint32_t) {
+            receive_available();
+            flush_send_queue();
+        })) {
+        return false;
+    }
+    reactor_ = &reactor;
+    return true;
+}
+
+void WebSocketHandler::receive_available() {
+#ifdef __linux__
+    // Read until EAGAIN (required for edge-triggered readiness), straight
+    // behind any partial frame; grow only when a single frame is larger
+    // than the whole buffer
+    while (is_connected()) {
+        if (recv_buffer_.size() < RECV_BUFFER_SIZE) {
+            recv_buffer_.resize(RECV_BUFFER_SIZE);
+        } else if (recv_len_ == recv_buffer_.size()) {
+            recv_buffer_.resize(recv_buffer_.size() * 2);
         }
         
-        // Keep unconsumed data
-        if (data.size() < partial_frame_.size()) {
-            partial_frame_.erase(partial_frame_.begin(),
-                                 partial_frame_.begin() + (partial_frame_.size() - data.size()));
+        ssize_t n = ::recv(fd_, recv_buffer_.data() + recv_len_,
+                           recv_buffer_.size() - recv_len_, MSG_DONTWAIT);
+        
+        if (n > 0) {
+            recv_len_ += static_cast<std::size_t>(n);
+            drain_frames();
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            close();
         }
-    } else if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
-        close();
     }
-    
+#endif
+}
+
+void WebSocketHandler::flush_send_queue() {
     // Send queued messages
     while (auto msg = send_queue_.try_pop()) {
         send_frame(msg->type, msg->data);
     }
-#endif
+}
+
+std::size_t WebSocketHandler::drain_frames() {
+    WebSocketFrameView frame;
+    std::size_t offset = 0;
+    
+    while (offset < recv_len_ && is_connected()) {
+        std::size_t consumed = WebSocketParser::parse_in_place(
+            recv_buffer_.data() + offset, recv_len_ - offset, frame);
+        if (consumed == 0) {
+            break;  // Need more data
+        }
+        
+        offset += consumed;
+        handle_frame(frame);
+    }
+    
+    // Keep unconsumed data at the front of the buffer
+    if (offset > 0) {
+        std::memmove(recv_buffer_.data(), recv_buffer_.data() + offset, recv_len_ - offset);
+        recv_len_ -= offset;
+    }
+    return offset;
 }
 
 void WebSocketHandler::set_state(WebSocketState new_state) {
@@ -403,12 +584,18 @@ void WebSocketHandler::set_state(WebSocketState new_state) {
     }
 }
 
-void WebSocketHandler::handle_frame(const WebSocketFrame& frame) {
+void WebSocketHandler::handle_frame(const WebSocketFrameView& frame) {
     switch (frame.opcode) {
         case WebSocketOpcode::TEXT:
         case WebSocketOpcode::BINARY:
-            if (message_callback_) {
-                message_callback_(frame);
+            if (frame_callback_) {
+                frame_callback_(frame);
+            } else if (message_callback_) {
+                frame_.opcode = frame.opcode;
+                frame_.fin = frame.fin;
+                frame_.masked = frame.masked;
+                frame_.payload.assign(frame.payload.begin(), frame.payload.end());
+                message_callback_(frame_);
             }
             break;
             
@@ -529,23 +716,10 @@ std::optional<TradeUpdate> parse_trade(std::string_view json) {
     return trade;
 }
 
-std::optional<BookUpdate> parse_book_update(std::string_view json) {
-    // Simplified - in production use nlohmann/json or similar
-    BookUpdate update;
-    update.timestamp = now();
-    
-    // Find symbol
-    auto sym_pos = json.find("\"symbol\"");
-    if (sym_pos == std::string_view::npos) return std::nullopt;
-    
-    auto sym_start = json.find("\"", sym_pos + 8) + 1;
-    auto sym_end = json.find("\"", sym_start);
-    update.symbol = std::string(json.substr(sym_start, sym_end - sym_start));
-    
-    // Would parse bids/asks arrays here
-    // ...
-    
-    return update;
+bool parse_book_update(std::string_view json, BookUpdate& update) {
+    thread_local JsonFeedDecoder decoder;
+    FeedTrade unused;
+    return decoder.decode(json, unused, update) == FeedMessageType::BOOK;
 }
 
 } // namespace ws_json
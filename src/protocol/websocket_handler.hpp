@@ -20,9 +20,13 @@
 #include <atomic>
 #include <thread>
 #include <cstdint>
+#include <optional>
+#include <random>
 
 #include "core/types.hpp"
 #include "core/lockfree_queue.hpp"
+#include "core/reactor.hpp"
+#include "json_feed_decoder.hpp"
 
 namespace hft {
 
@@ -65,6 +69,22 @@ struct WebSocketFrame {
     }
 };
 
+/**
+ * @brief Parsed WebSocket frame that borrows its payload
+ *
+ * The payload points into the buffer handed to parse_in_place() and is
+ * only valid until that buffer is reused (i.e. for the duration of the
+ * frame callback).
+ */
+struct WebSocketFrameView {
+    WebSocketOpcode opcode;
+    bool fin;
+    bool masked;
+    std::string_view payload;
+
+    [[nodiscard]] std::string_view payload_string() const { return payload; }
+};
+
 /**
  * @brief WebSocket frame parser
  * 
@@ -73,6 +93,8 @@ struct WebSocketFrame {
  */
 class WebSocketParser {
 public:
+    static constexpr std::size_t MAX_HEADER_SIZE = 14;   // 2 + 8 length + 4 mask
+
     /**
      * @brief Parse a WebSocket frame from raw data
      * 
@@ -82,6 +104,17 @@ public:
      */
     std::size_t parse(std::string_view data, WebSocketFrame& frame);
 
+    /**
+     * @brief Parse a frame without copying, unmasking the payload in place
+     *
+     * @param data Mutable input buffer (the payload bytes are rewritten)
+     * @param size Bytes available in data
+     * @param frame Output frame; payload points into data
+     * @return Number of bytes consumed, or 0 if incomplete
+     */
+    static std::size_t parse_in_place(std::uint8_t* data, std::size_t size,
+                                      WebSocketFrameView& frame);
+
     /**
      * @brief Encode a WebSocket frame
      * 
@@ -96,6 +129,26 @@ public:
         bool mask = false
     );
 
+    /**
+     * @brief Encode a frame header (no payload)
+     *
+     * @param out At least MAX_HEADER_SIZE bytes
+     * @param mask_key Masking key to append, or nullptr for an unmasked frame
+     * @return Header length
+     */
+    static std::size_t encode_header(std::uint8_t* out,
+                                     WebSocketOpcode opcode,
+                                     std::uint64_t payload_size,
+                                     const std::uint8_t* mask_key = nullptr);
+
+    /**
+     * @brief XOR data with a 4-byte masking key, in place
+     *
+     * Vectorised 32/16 bytes at a time; the same call masks and unmasks.
+     */
+    static void apply_mask(std::uint8_t* data, std::size_t size,
+                           const std::uint8_t mask[4]);
+
     /**
      * @brief Generate WebSocket handshake request
      */
@@ -114,16 +167,13 @@ public:
      * @brief Compute Sec-WebSocket-Accept header value
      */
     static std::string compute_accept_key(std::string_view client_key);
-
-private:
-    static void apply_mask(std::vector<std::uint8_t>& data, 
-                           const std::uint8_t mask[4]);
 };
 
 /**
  * @brief Message callback types
  */
 using WebSocketMessageCallback = std::function<void(const WebSocketFrame&)>;
+using WebSocketFrameViewCallback = std::function<void(const WebSocketFrameView&)>;
 using WebSocketErrorCallback = std::function<void(const std::string&)>;
 using WebSocketStateCallback = std::function<void(WebSocketState)>;
 
@@ -159,7 +209,9 @@ public:
     static constexpr std::size_t RECV_BUFFER_SIZE = 65536;
     static constexpr std::size_t SEND_QUEUE_SIZE = 4096;
 
-    WebSocketHandler() : state_(WebSocketState::CLOSED), fd_(-1) {}
+    WebSocketHandler()
+        : state_(WebSocketState::CLOSED), fd_(-1), mask_frames_(true),
+          mask_rng_(std::random_device{}()) {}
     virtual ~WebSocketHandler() { close(); }
 
     // Non-copyable
@@ -201,6 +253,14 @@ public:
      */
     void poll();
 
+    /**
+     * @brief Drive this connection from a shared Reactor instead of poll()
+     *
+     * Must be called on the reactor's thread once connected; the
+     * registration is dropped by close().
+     */
+    bool attach(Reactor& reactor);
+
     /**
      * @brief Check if connected
      */
@@ -222,6 +282,17 @@ public:
         message_callback_ = std::move(callback);
     }
 
+    /**
+     * @brief Set zero-copy frame callback
+     *
+     * Takes precedence over on_message(). The payload view points into the
+     * receive buffer and is only valid inside the callback; no per-frame
+     * copy or allocation is made.
+     */
+    void on_frame(WebSocketFrameViewCallback callback) {
+        frame_callback_ = std::move(callback);
+    }
+
     /**
      * @brief Set error callback
      */
@@ -239,17 +310,29 @@ public:
 protected:
     void set_state(WebSocketState new_state);
     bool send_frame(WebSocketOpcode opcode, std::string_view data);
-    void handle_frame(const WebSocketFrame& frame);
+    void handle_frame(const WebSocketFrameView& frame);
+    void receive_available();
+    void flush_send_queue();
+    std::size_t drain_frames();
     void report_error(const std::string& error);
 
     std::atomic<WebSocketState> state_;
     int fd_;
+    Reactor* reactor_ = nullptr;
+    bool mask_frames_;              // Client role: RFC 6455 requires masking
     
+    // Receive buffer: [0, recv_len_) holds unparsed bytes; frames are
+    // unmasked in place and handed out as views
     std::vector<std::uint8_t> recv_buffer_;
-    std::vector<std::uint8_t> partial_frame_;
-    
-    WebSocketParser parser_;
+    std::size_t recv_len_ = 0;
+    WebSocketFrame frame_;          // Reused for the copying on_message() path
+
+    // Send scratch: header is encoded here, masked payloads are copied here
+    std::uint8_t send_header_[WebSocketParser::MAX_HEADER_SIZE] = {};
+    std::vector<std::uint8_t> send_payload_;
+    std::mt19937 mask_rng_;
     
+    WebSocketFrameViewCallback frame_callback_;
     WebSocketMessageCallback message_callback_;
     WebSocketErrorCallback error_callback_;
     WebSocketStateCallback state_callback_;
@@ -294,16 +377,15 @@ namespace ws_json {
     std::optional<TradeUpdate> parse_trade(std::string_view json);
 
     /**
-     * @brief Parse an order book update
+     * @brief Parse an order book update into a reusable buffer
+     *
+     * Fixed-point levels, no allocation; see JsonFeedDecoder for hot paths
+     * that also want interned symbol ids.
+     * @return false if json is not a book update
      */
-    struct BookUpdate {
-        std::string symbol;
-        std::vector<std::pair<double, double>> bids;  // price, quantity
-        std::vector<std::pair<double, double>> asks;
-        Timestamp timestamp;
-    };
+    using BookUpdate = FeedBookUpdate;
 
-    std::optional<BookUpdate> parse_book_update(std::string_view json);
+    bool parse_book_update(std::string_view json, BookUpdate& update);
 }
 
 } // namespace hft
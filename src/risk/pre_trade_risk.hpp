@@ -0,0 +1,294 @@
+/**
+ * @file pre_trade_risk.hpp
+ * @brief Pre-trade risk checks keyed by dense instrument/account ids
+ *
+ * Every order passes through these checks, so they avoid strings, hashing
+ * and locks entirely:
+ * - Positions live in a flat array of cache-line slots indexed by
+ *   (account, instrument); a check touches exactly one slot and one
+ *   account line.
+ * - Counters are single-writer: the gateway thread that checks and books
+ *   orders is the only one that modifies them. They are atomics accessed
+ *   with relaxed loads/stores, so monitoring threads can read them without
+ *   tearing and the writer pays no RMW cost.
+ * - Rate limiting is a token bucket (GCRA) on the raw TSC: one rdtsc(),
+ *   one compare and one CAS per order.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "core/timing.hpp"
+#include "core/types.hpp"
+
+namespace hft {
+
+using AccountId = std::uint32_t;
+
+/**
+ * @brief Token bucket rate limiter driven by rdtsc()
+ *
+ * Implemented as a generic cell rate algorithm: the bucket state is a
+ * single "theoretical arrival time" in TSC ticks, so acquiring is
+ * lock-free and safe from any number of threads.
+ */
+class TokenBucket {
+public:
+    /**
+     * @param rate_per_second Sustained token rate
+     * @param burst Tokens available at once (bucket depth)
+     * @param tsc_hz TSC frequency; calibrated once per process by default
+     */
+    explicit TokenBucket(double rate_per_second, double burst = 0.0,
+                         double tsc_hz = HighPrecisionTimer::instance().frequency()) noexcept
+        : interval_ticks_(static_cast<std::uint64_t>(tsc_hz / std::max(rate_per_second, 1e-9)))
+        , burst_ticks_(static_cast<std::uint64_t>(
+              std::max(burst > 0.0 ? burst : rate_per_second, 1.0) * static_cast<double>(interval_ticks_)))
+        , tat_(rdtsc()) {}
+
+    /**
+     * @brief Take tokens if the bucket holds enough
+     */
+    [[nodiscard]] bool try_acquire(std::uint32_t tokens = 1) noexcept {
+        const std::uint64_t now = rdtsc();
+        std::uint64_t tat = tat_.load(std::memory_order_relaxed);
+        for (;;) {
+            const std::uint64_t next = std::max(tat, now) + tokens * interval_ticks_;
+            if (next - now > burst_ticks_) {
+                return false;
+            }
+            if (tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    [[nodiscard]] std::uint64_t interval_ticks() const noexcept { return interval_ticks_; }
+
+private:
+    std::uint64_t interval_ticks_;      // TSC ticks per token
+    std::uint64_t burst_ticks_;         // Bucket depth in ticks
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> tat_;
+};
+
+/**
+ * @brief Per-instrument limits
+ */
+struct RiskLimits {
+    Quantity max_position = 10000;      // |net + open orders on one side|
+    Quantity max_order_quantity = 10000;
+};
+
+enum class RiskResult : std::uint8_t {
+    ACCEPTED,
+    UNKNOWN_INSTRUMENT,
+    UNKNOWN_ACCOUNT,
+    INVALID_QUANTITY,
+    ORDER_TOO_LARGE,
+    POSITION_LIMIT,
+    NOTIONAL_LIMIT
+};
+
+[[nodiscard]] constexpr std::string_view to_string(RiskResult result) noexcept {
+    switch (result) {
+        case RiskResult::ACCEPTED: return "Accepted";
+        case RiskResult::UNKNOWN_INSTRUMENT: return "Unknown symbol";
+        case RiskResult::UNKNOWN_ACCOUNT: return "Unknown account";
+        case RiskResult::INVALID_QUANTITY: return "Invalid quantity";
+        case RiskResult::ORDER_TOO_LARGE: return "Order quantity limit exceeded";
+        case RiskResult::POSITION_LIMIT: return "Position limit exceeded";
+        case RiskResult::NOTIONAL_LIMIT: return "Notional limit exceeded";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Fill to apply against booked open quantity
+ *
+ * reserved_price is the price the open quantity was booked at (the
+ * order's limit price), so open notional is released exactly.
+ */
+struct RiskFill {
+    AccountId account;
+    InstrumentId instrument;
+    Side side;
+    Price reserved_price;
+    Quantity quantity;
+};
+
+/**
+ * @brief Pre-trade position and notional checks
+ *
+ * Notional is tracked in fixed-point price units (price * quantity).
+ * Market orders carry no price, so they are checked against position
+ * limits only.
+ */
+class PreTradeRisk {
+public:
+    struct Position {
+        Quantity net_position = 0;
+        Quantity open_buy_orders = 0;
+        Quantity open_sell_orders = 0;
+        Quantity max_position = 0;
+    };
+
+    /**
+     * @param max_open_notional Per-account limit on open order notional (0 = none)
+     */
+    PreTradeRisk(std::size_t instrument_count, std::size_t account_count = 1,
+                 const RiskLimits& limits = {}, std::int64_t max_open_notional = 0)
+        : instrument_count_(instrument_count)
+        , account_count_(account_count)
+        , limits_(instrument_count, limits)
+        , positions_(instrument_count * account_count)
+        , accounts_(account_count)
+    {
+        for (auto& account : accounts_) {
+            account.max_open_notional = max_open_notional;
+        }
+    }
+
+    // Non-copyable
+    PreTradeRisk(const PreTradeRisk&) = delete;
+    PreTradeRisk& operator=(const PreTradeRisk&) = delete;
+
+    void set_limits(InstrumentId instrument, const RiskLimits& limits) {
+        if (instrument < instrument_count_) limits_[instrument] = limits;
+    }
+
+    void set_max_open_notional(AccountId account, std::int64_t max_open_notional) {
+        if (account < account_count_) accounts_[account].max_open_notional = max_open_notional;
+    }
+
+    /**
+     * @brief Check an order against position, size and notional limits
+     */
+    [[nodiscard]] RiskResult check(AccountId account, InstrumentId instrument, Side side,
+                                   Price price, Quantity quantity) const noexcept {
+        if (instrument >= instrument_count_) return RiskResult::UNKNOWN_INSTRUMENT;
+        if (account >= account_count_) return RiskResult::UNKNOWN_ACCOUNT;
+        if (quantity <= 0) return RiskResult::INVALID_QUANTITY;
+
+        const RiskLimits& limits = limits_[instrument];
+        if (quantity > limits.max_order_quantity) return RiskResult::ORDER_TOO_LARGE;
+
+        const Slot& pos = slot(account, instrument);
+        const Quantity net = pos.net_position.load(std::memory_order_relaxed);
+        const Quantity potential = side == Side::BUY
+            ? net + quantity + pos.open_buy.load(std::memory_order_relaxed)
+            : net - quantity - pos.open_sell.load(std::memory_order_relaxed);
+        if (std::abs(potential) > limits.max_position) return RiskResult::POSITION_LIMIT;
+
+        const AccountSlot& acct = accounts_[account];
+        if (acct.max_open_notional > 0 &&
+            acct.open_notional.load(std::memory_order_relaxed) + notional(price, quantity) >
+                acct.max_open_notional) {
+            return RiskResult::NOTIONAL_LIMIT;
+        }
+        return RiskResult::ACCEPTED;
+    }
+
+    /**
+     * @brief Book an accepted order's quantity as open
+     */
+    void on_order_accepted(AccountId account, InstrumentId instrument, Side side,
+                           Price price, Quantity quantity) noexcept {
+        Slot& pos = slot(account, instrument);
+        add(side == Side::BUY ? pos.open_buy : pos.open_sell, quantity);
+        add(accounts_[account].open_notional, notional(price, quantity));
+    }
+
+    /**
+     * @brief Release open quantity that will not fill (cancel, reject, expiry)
+     */
+    void on_order_released(AccountId account, InstrumentId instrument, Side side,
+                           Price price, Quantity quantity) noexcept {
+        on_order_accepted(account, instrument, side, price, -quantity);
+    }
+
+    /**
+     * @brief Move filled quantity from open to net position
+     */
+    void on_fill(const RiskFill& fill) noexcept {
+        Slot& pos = slot(fill.account, fill.instrument);
+        if (fill.side == Side::BUY) {
+            add(pos.net_position, fill.quantity);
+            add(pos.open_buy, -fill.quantity);
+        } else {
+            add(pos.net_position, -fill.quantity);
+            add(pos.open_sell, -fill.quantity);
+        }
+        add(accounts_[fill.account].open_notional, -notional(fill.reserved_price, fill.quantity));
+    }
+
+    /**
+     * @brief Apply the fills produced by one matching pass
+     */
+    void apply_fills(std::span<const RiskFill> fills) noexcept {
+        for (const auto& fill : fills) {
+            on_fill(fill);
+        }
+    }
+
+    [[nodiscard]] Position get_position(AccountId account, InstrumentId instrument) const noexcept {
+        if (instrument >= instrument_count_ || account >= account_count_) return {};
+        const Slot& pos = slot(account, instrument);
+        return {pos.net_position.load(std::memory_order_relaxed),
+                pos.open_buy.load(std::memory_order_relaxed),
+                pos.open_sell.load(std::memory_order_relaxed),
+                limits_[instrument].max_position};
+    }
+
+    [[nodiscard]] std::int64_t open_notional(AccountId account) const noexcept {
+        return account < account_count_
+            ? accounts_[account].open_notional.load(std::memory_order_relaxed) : 0;
+    }
+
+    [[nodiscard]] std::size_t instrument_count() const noexcept { return instrument_count_; }
+    [[nodiscard]] std::size_t account_count() const noexcept { return account_count_; }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<Quantity> net_position{0};
+        std::atomic<Quantity> open_buy{0};
+        std::atomic<Quantity> open_sell{0};
+    };
+
+    struct alignas(CACHE_LINE_SIZE) AccountSlot {
+        std::atomic<std::int64_t> open_notional{0};
+        std::int64_t max_open_notional = 0;
+    };
+
+    static_assert(sizeof(Slot) == CACHE_LINE_SIZE);
+
+    [[nodiscard]] static std::int64_t notional(Price price, Quantity quantity) noexcept {
+        return price * quantity;
+    }
+
+    // Single writer: plain load + store, no locked RMW
+    static void add(std::atomic<std::int64_t>& counter, std::int64_t delta) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] Slot& slot(AccountId account, InstrumentId instrument) noexcept {
+        return positions_[static_cast<std::size_t>(account) * instrument_count_ + instrument];
+    }
+
+    [[nodiscard]] const Slot& slot(AccountId account, InstrumentId instrument) const noexcept {
+        return positions_[static_cast<std::size_t>(account) * instrument_count_ + instrument];
+    }
+
+    std::size_t instrument_count_;
+    std::size_t account_count_;
+    std::vector<RiskLimits> limits_;
+    std::vector<Slot> positions_;
+    std::vector<AccountSlot> accounts_;
+};
+
+} // namespace hft
@@ -7,8 +7,9 @@
  * 
  * Timestamp Recording API:
  *   Use record_timestamp("label") at any point in your strategy code to measure
- *   time spent in different phases. The framework will aggregate these timestamps
- *   and report latency breakdowns.
+ *   time spent in different phases. Labels must be string literals (they are
+ *   compile-time StageLabels); a mark is one rdtsc() stored into a local
+ *   buffer, and the stage-to-stage breakdown is computed offline.
  * 
  * Example:
  *   void onTick(const Tick& tick) override {
@@ -29,7 +30,9 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <functional>
 #include <memory>
@@ -38,10 +41,15 @@
 #include <mutex>
 #include <algorithm>
 #include <numeric>
+#include <optional>
+#include <limits>
 #include <cmath>
 #include <iostream>
 #include "core/types.hpp"
 #include "core/timing.hpp"
+#include "core/tsc_clock.hpp"
+#include "core/hdr_histogram.hpp"
+#include "core/timestamp_buffer.hpp"
 
 namespace hft {
 
@@ -50,7 +58,8 @@ namespace hft {
  */
 struct TimestampRecord {
     const char* label;
-    Timestamp timestamp;
+    Timestamp timestamp;            // Raw TSC ticks
+
     uint64_t tick_sequence;
 };
 
@@ -63,25 +72,25 @@ struct TimingStats {
     int64_t total_ns = 0;
     int64_t min_ns = INT64_MAX;
     int64_t max_ns = 0;
-    std::vector<int64_t> samples;  // For percentile calculation
+    HdrHistogram<2> histogram;  // For percentile calculation
     
     void add_sample(int64_t ns) {
         count++;
         total_ns += ns;
         if (ns < min_ns) min_ns = ns;
         if (ns > max_ns) max_ns = ns;
-        samples.push_back(ns);
+        histogram.record(ns);
     }
     
     [[nodiscard]] double average_ns() const {
         return count > 0 ? static_cast<double>(total_ns) / count : 0;
     }
     
-    [[nodiscard]] int64_t percentile(double p) {
-        if (samples.empty()) return 0;
-        std::sort(samples.begin(), samples.end());
-        size_t idx = static_cast<size_t>(samples.size() * p);
-        return samples[std::min(idx, samples.size() - 1)];
+    /**
+     * @brief Value at fraction p (0-1) of the samples, within 1%
+     */
+    [[nodiscard]] int64_t percentile(double p) const {
+        return histogram.value_at_percentile(p * 100.0);
     }
 };
 
@@ -138,7 +147,7 @@ public:
     using OrderCallback = std::function<void(const StrategyOrder&)>;
     using TimestampCallback = std::function<void(const TimestampRecord&)>;
     
-    UserStrategy() = default;
+    UserStrategy() : total_stats_(&timing_stats_["total_tick_processing"]) {}
     virtual ~UserStrategy() = default;
     
     // Non-copyable
@@ -161,8 +170,15 @@ public:
     
     /**
      * @brief Enable/disable timestamp recording
+     * 
+     * Enabling allocates the stage buffer and calibrates the TSC up front,
+     * so neither happens during the run.
      */
     void set_timestamp_recording(bool enabled) {
+        if (enabled && !stage_buffer_) {
+            stage_buffer_ = std::make_unique<StageBuffer>();
+            (void)HighPrecisionTimer::instance();
+        }
         timestamp_recording_enabled_ = enabled;
     }
     
@@ -176,6 +192,18 @@ public:
      */
     virtual void onTick(const Tick& tick) = 0;
     
+    /**
+     * @brief Called with a batch of ticks, any symbols, in arrival order
+     * 
+     * Default: onTick() for each. Multi-symbol strategies evaluate the
+     * whole batch at once.
+     */
+    virtual void on_ticks(std::span<const Tick> ticks) {
+        for (const Tick& tick : ticks) {
+            onTick(tick);
+        }
+    }
+    
     /**
      * @brief Called when order response is received
      * 
@@ -204,13 +232,22 @@ public:
      * @brief Get timing statistics collected during run
      */
     [[nodiscard]] const std::unordered_map<std::string, TimingStats>& get_timing_stats() const {
+        fold_stage_marks();
         return timing_stats_;
     }
     
+    /**
+     * @brief Marks lost because a single tick overflowed the stage buffer
+     */
+    [[nodiscard]] uint64_t stage_marks_dropped() const noexcept {
+        return stage_marks_dropped_;
+    }
+    
     /**
      * @brief Print timing breakdown report
      */
     void print_timing_report() const {
+        fold_stage_marks();
         if (timing_stats_.empty()) {
             return;
         }
@@ -222,6 +259,11 @@ public:
             std::cout << "    Average: " << stats.average_ns() << " ns\n";
             std::cout << "    Min:     " << stats.min_ns << " ns\n";
             std::cout << "    Max:     " << stats.max_ns << " ns\n";
+            std::cout << "    P50:     " << stats.percentile(0.50) << " ns\n";
+            std::cout << "    P99:     " << stats.percentile(0.99) << " ns\n";
+        }
+        if (stage_marks_dropped_ > 0) {
+            std::cout << "  (" << stage_marks_dropped_ << " marks dropped: stage buffer full)\n";
         }
     }
 
@@ -230,12 +272,10 @@ public:
      */
     void begin_tick_processing(uint64_t tick_sequence) {
         current_tick_sequence_ = tick_sequence;
-        tick_start_time_ = now();
-        last_timestamp_ = tick_start_time_;
-        last_label_ = "tick_start";
-        
         if (timestamp_recording_enabled_) {
-            record_timestamp_internal("tick_received");
+            mark("tick_received");
+        } else {
+            tick_start_time_ = fast_now();
         }
     }
     
@@ -244,12 +284,15 @@ public:
      */
     void end_tick_processing() {
         if (timestamp_recording_enabled_) {
-            record_timestamp_internal("tick_done");
+            // Total comes from the tick_received → tick_done chain offline
+            mark("tick_done");
+            if (stage_buffer_->remaining() < STAGE_BUFFER_CAPACITY / 2) {
+                fold_stage_marks();
+            }
+            return;
         }
         
-        Timestamp end_time = now();
-        int64_t total_time = end_time - tick_start_time_;
-        timing_stats_["total_tick_processing"].add_sample(total_time);
+        total_stats_->add_sample(fast_now() - tick_start_time_);
     }
 
 protected:
@@ -260,13 +303,13 @@ protected:
      * in different phases. The framework will aggregate these timestamps
      * and report latency breakdowns.
      * 
-     * @param label A short descriptive label for this checkpoint
+     * @param label A short descriptive string literal for this checkpoint
      * 
      * Example labels: "signal_start", "risk_check", "order_built", etc.
      */
-    void record_timestamp(const char* label) {
+    void record_timestamp(StageLabel label) {
         if (!timestamp_recording_enabled_) return;
-        record_timestamp_internal(label);
+        mark(label);
     }
     
     /**
@@ -274,7 +317,7 @@ protected:
      */
     void submit_order(const StrategyOrder& order) {
         if (timestamp_recording_enabled_) {
-            record_timestamp_internal("order_submitted");
+            mark("order_submitted");
         }
         
         if (order_callback_) {
@@ -283,24 +326,51 @@ protected:
     }
 
 private:
-    void record_timestamp_internal(const char* label) {
-        Timestamp ts = now();
-        
-        // Callback to framework for real-time processing
+    static constexpr std::size_t STAGE_BUFFER_CAPACITY = 65536;
+    using StageBuffer = ThreadLocalTimestampBuffer<STAGE_BUFFER_CAPACITY>;
+    
+    // Hot path: one rdtsc() and four stores
+    void mark(StageLabel label) {
         if (timestamp_callback_) {
-            TimestampRecord record{label, ts, current_tick_sequence_};
-            timestamp_callback_(record);
+            timestamp_callback_(TimestampRecord{label.text, static_cast<Timestamp>(rdtsc()), current_tick_sequence_});
         }
-        
-        // Calculate delta from last timestamp
-        if (last_timestamp_ > 0 && last_label_ != nullptr) {
-            int64_t delta = ts - last_timestamp_;
-            std::string key = std::string(last_label_) + " → " + label;
-            timing_stats_[key].add_sample(delta);
+        if (!stage_buffer_->record_local(EventType::STRATEGY_STAGE, current_tick_sequence_, label.id())) {
+            ++stage_marks_dropped_;
         }
+    }
+    
+    /**
+     * @brief Turn buffered marks into per-stage TimingStats and reset the buffer
+     * 
+     * Runs between ticks (buffer half full) and when stats are read.
+     */
+    void fold_stage_marks() const {
+        if (!stage_buffer_ || stage_buffer_->count() == 0) return;
+        
+        const auto& timer = HighPrecisionTimer::instance();
+        auto to_ns = [&timer](int64_t ticks) {
+            return static_cast<int64_t>(timer.ticks_to_ns(static_cast<uint64_t>(std::max<int64_t>(ticks, 0))));
+        };
         
-        last_timestamp_ = ts;
-        last_label_ = label;
+        // Labels are literals, so address pairs identify links without text compares
+        struct Link { const char* from; const char* to; TimingStats* stats; };
+        std::vector<Link> links;
+        
+        auto on_delta = [&](const char* from, const char* to, int64_t ticks) {
+            auto it = std::find_if(links.begin(), links.end(),
+                [&](const Link& l) { return l.from == from && l.to == to; });
+            if (it == links.end()) {
+                links.push_back({from, to, &timing_stats_[std::string(from) + " → " + to]});
+                it = links.end() - 1;
+            }
+            it->stats->add_sample(to_ns(ticks));
+        };
+        auto on_chain = [&](int64_t ticks) {
+            total_stats_->add_sample(to_ns(ticks));
+        };
+        TimestampAnalyzer::StageDeltaWalker<decltype(on_delta)&, decltype(on_chain)&> walker(on_delta, on_chain);
+        stage_buffer_->drain(walker);
+        walker.finish();
     }
 
 private:
@@ -310,12 +380,232 @@ private:
     
     // Per-tick state
     uint64_t current_tick_sequence_ = 0;
-    Timestamp tick_start_time_ = 0;
-    Timestamp last_timestamp_ = 0;
-    const char* last_label_ = nullptr;
+    Timestamp tick_start_time_ = 0;             // Only when marks are off
+    
+    // Raw marks (folded from const readers too; the buffer is owned, not shared)
+    std::unique_ptr<StageBuffer> stage_buffer_;
+    uint64_t stage_marks_dropped_ = 0;
     
     // Aggregated statistics
     mutable std::unordered_map<std::string, TimingStats> timing_stats_;
+    TimingStats* total_stats_;
+};
+
+/**
+ * @brief Base for strategies that trade many symbols from one instance
+ * 
+ * Each symbol gets a dense id on first sight and its state lives in
+ * structure-of-arrays form indexed by that id: last price, last change,
+ * EMA of the mid, inventory and the strategy's own quote levels.
+ * 
+ * onTick() updates one symbol and calls on_signal(). on_ticks() conflates
+ * the batch to the latest tick per symbol (the change is measured from the
+ * price before the batch), gathers the touched symbols into contiguous
+ * scratch arrays, updates them in one branch-free loop the compiler
+ * vectorizes, scatters the result back and then calls on_signal() per
+ * touched symbol in first-seen order.
+ * 
+ * submit_order(id, order) assigns the client order id and remembers the
+ * symbol and side, so fills in onOrderResponse() land on the right
+ * inventory.
+ */
+class MultiSymbolStrategy : public UserStrategy {
+public:
+    static constexpr double DEFAULT_EMA_ALPHA = 0.05;
+    
+    explicit MultiSymbolStrategy(double ema_alpha = DEFAULT_EMA_ALPHA) : ema_alpha_(ema_alpha) {}
+    
+    /**
+     * @brief Pre-size the per-symbol arrays (setup only; symbols still intern lazily)
+     */
+    void reserve_symbols(std::size_t count) {
+        symbol_ids_.reserve(count);
+        for (auto* array : {&last_price_, &delta_, &bid_quote_, &ask_quote_}) array->reserve(count);
+        ema_.reserve(count);
+        inventory_.reserve(count);
+        batch_slot_.reserve(count);
+    }
+    
+    void onTick(const Tick& tick) final {
+        record_timestamp("signal_start");
+        const InstrumentId id = intern(tick.symbol);
+        update(last_price_[id], ema_[id], delta_[id], tick.last_price, mid_of(tick), ema_alpha_);
+        record_timestamp("signal_calculated");
+        on_signal(id, tick);
+    }
+    
+    void on_ticks(std::span<const Tick> ticks) final {
+        record_timestamp("signal_start");
+        
+        // Conflate: one scratch slot per symbol, holding its latest tick
+        batch_.clear();
+        for (std::size_t i = 0; i < ticks.size(); ++i) {
+            const InstrumentId id = intern(ticks[i].symbol);
+            if (batch_slot_[id] == NO_SLOT) {
+                batch_slot_[id] = static_cast<std::uint32_t>(batch_.ids.size());
+                batch_.ids.push_back(id);
+                batch_.tick.push_back(i);
+            } else {
+                batch_.tick[batch_slot_[id]] = i;
+            }
+        }
+        
+        // Gather
+        const std::size_t n = batch_.ids.size();
+        batch_.resize(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            const InstrumentId id = batch_.ids[k];
+            const Tick& tick = ticks[batch_.tick[k]];
+            batch_.last[k] = last_price_[id];
+            batch_.ema[k] = ema_[id];
+            batch_.price[k] = tick.last_price;
+            batch_.mid[k] = mid_of(tick);
+        }
+        
+        // Evaluate: contiguous, no aliasing, no branches in the body
+        {
+            Price* __restrict last = batch_.last.data();
+            double* __restrict ema = batch_.ema.data();
+            Price* __restrict delta = batch_.delta.data();
+            const Price* __restrict price = batch_.price.data();
+            const double* __restrict mid = batch_.mid.data();
+            const double alpha = ema_alpha_;
+            for (std::size_t k = 0; k < n; ++k) {
+                update(last[k], ema[k], delta[k], price[k], mid[k], alpha);
+            }
+        }
+        
+        // Scatter
+        for (std::size_t k = 0; k < n; ++k) {
+            const InstrumentId id = batch_.ids[k];
+            last_price_[id] = batch_.last[k];
+            ema_[id] = batch_.ema[k];
+            delta_[id] = batch_.delta[k];
+            batch_slot_[id] = NO_SLOT;
+        }
+        record_timestamp("signal_calculated");
+        
+        for (std::size_t k = 0; k < n; ++k) {
+            on_signal(batch_.ids[k], ticks[batch_.tick[k]]);
+        }
+    }
+    
+    void onOrderResponse(const OrderResponse& response) override {
+        const OrderTag& tag = order_tags_[response.client_order_id & (ORDER_TAGS - 1)];
+        if (tag.client_order_id != response.client_order_id || response.fill_quantity <= 0) return;
+        if (response.status == OrderStatus::FILLED || response.status == OrderStatus::PARTIALLY_FILLED) {
+            inventory_[tag.id] += tag.side == Side::BUY ? response.fill_quantity : -response.fill_quantity;
+        }
+    }
+    
+    [[nodiscard]] std::size_t symbol_count() const noexcept { return last_price_.size(); }
+    
+    [[nodiscard]] std::optional<InstrumentId> find_symbol(const Symbol& symbol) const {
+        auto it = symbol_ids_.find(symbol);
+        if (it == symbol_ids_.end()) return std::nullopt;
+        return it->second;
+    }
+    
+    // Per-symbol state, by id
+    [[nodiscard]] Price last_price(InstrumentId id) const noexcept { return last_price_[id]; }
+    [[nodiscard]] Price delta(InstrumentId id) const noexcept { return delta_[id]; }
+    [[nodiscard]] double ema(InstrumentId id) const noexcept { return ema_[id]; }
+    [[nodiscard]] Quantity inventory(InstrumentId id) const noexcept { return inventory_[id]; }
+    [[nodiscard]] Price bid_quote(InstrumentId id) const noexcept { return bid_quote_[id]; }
+    [[nodiscard]] Price ask_quote(InstrumentId id) const noexcept { return ask_quote_[id]; }
+
+protected:
+    /**
+     * @brief Per-symbol decision, after that symbol's state is updated
+     */
+    virtual void on_signal(InstrumentId id, const Tick& tick) = 0;
+    
+    /**
+     * @brief Submit for symbol id, tagging the order for fill attribution
+     */
+    void submit_order(InstrumentId id, StrategyOrder& order) {
+        order.client_order_id = next_client_order_id_++;
+        order_tags_[order.client_order_id & (ORDER_TAGS - 1)] = {order.client_order_id, id, order.side};
+        UserStrategy::submit_order(order);
+    }
+    
+    void set_quotes(InstrumentId id, Price bid, Price ask) noexcept {
+        bid_quote_[id] = bid;
+        ask_quote_[id] = ask;
+    }
+
+private:
+    static constexpr std::uint32_t NO_SLOT = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t ORDER_TAGS = 65536;    // In-flight orders remembered for fills
+    
+    struct OrderTag {
+        std::uint64_t client_order_id = 0;
+        InstrumentId id = 0;
+        Side side = Side::BUY;
+    };
+    
+    // Scratch for one batch, reused (no allocation once warmed up)
+    struct Batch {
+        std::vector<InstrumentId> ids;
+        std::vector<std::size_t> tick;          // Index of the symbol's latest tick
+        std::vector<Price> last;
+        std::vector<Price> delta;
+        std::vector<Price> price;
+        std::vector<double> ema;
+        std::vector<double> mid;
+        
+        void clear() noexcept {
+            ids.clear();
+            tick.clear();
+        }
+        
+        void resize(std::size_t n) {
+            for (auto* array : {&last, &delta, &price}) array->resize(n);
+            ema.resize(n);
+            mid.resize(n);
+        }
+    };
+    
+    static double mid_of(const Tick& tick) noexcept {
+        return 0.5 * static_cast<double>(tick.bid_price + tick.ask_price);
+    }
+    
+    // One symbol's update; the same code is the body of the batch loop
+    static void update(Price& last, double& ema, Price& delta, Price price, double mid, double alpha) noexcept {
+        delta = last > 0 ? price - last : 0;
+        last = price;
+        ema = ema == 0.0 ? mid : ema + alpha * (mid - ema);
+    }
+    
+    InstrumentId intern(const Symbol& symbol) {
+        auto [it, inserted] = symbol_ids_.try_emplace(symbol, static_cast<InstrumentId>(last_price_.size()));
+        if (inserted) {
+            last_price_.push_back(0);
+            delta_.push_back(0);
+            ema_.push_back(0.0);
+            inventory_.push_back(0);
+            bid_quote_.push_back(0);
+            ask_quote_.push_back(0);
+            batch_slot_.push_back(NO_SLOT);
+        }
+        return it->second;
+    }
+    
+    double ema_alpha_;
+    std::unordered_map<Symbol, InstrumentId, SymbolHash> symbol_ids_;
+    
+    // Structure of arrays, one element per symbol id
+    std::vector<Price> last_price_;
+    std::vector<Price> delta_;
+    std::vector<double> ema_;
+    std::vector<Quantity> inventory_;
+    std::vector<Price> bid_quote_;
+    std::vector<Price> ask_quote_;
+    std::vector<std::uint32_t> batch_slot_;     // Symbol's slot in batch_, or NO_SLOT
+    
+    Batch batch_;
+    std::array<OrderTag, ORDER_TAGS> order_tags_{};
+    std::uint64_t next_client_order_id_ = 1;
 };
 
 /**
@@ -342,79 +632,57 @@ public:
 /**
  * @brief Example momentum strategy with timestamp recording
  * 
- * Demonstrates how to use record_timestamp() to profile strategy code.
+ * Follows each symbol's last price change, within a per-symbol inventory
+ * limit. Demonstrates how to use record_timestamp() to profile strategy code.
  */
-class MomentumStrategy : public UserStrategy {
+class MomentumStrategy : public MultiSymbolStrategy {
 public:
-    void onTick(const Tick& tick) override {
-        // Record signal calculation start
-        record_timestamp("signal_start");
-        
-        // Calculate momentum signal
-        Price delta = 0;
-        if (last_price_ > 0) {
-            delta = tick.last_price - last_price_;
-        }
-        last_price_ = tick.last_price;
-        
-        record_timestamp("signal_calculated");
-        
+    const char* name() const override { return "Momentum"; }
+
+protected:
+    void on_signal(InstrumentId id, const Tick& tick) override {
         // Skip if no signal
-        if (delta == 0) return;
+        const Price move = delta(id);
+        if (move == 0) return;
         
         // Risk check
         record_timestamp("risk_check_start");
-        bool can_buy = (delta > 0 && position_ < max_position_);
-        bool can_sell = (delta < 0 && position_ > -max_position_);
+        const Quantity position = inventory(id);
+        bool can_buy = (move > 0 && position < max_position_);
+        bool can_sell = (move < 0 && position > -max_position_);
         record_timestamp("risk_check_done");
         
         // Build and submit order if signal is valid
-        if (can_buy) {
+        if (can_buy || can_sell) {
             record_timestamp("order_build_start");
             StrategyOrder order;
             order.symbol = tick.symbol;
-            order.side = Side::BUY;
+            order.side = can_buy ? Side::BUY : Side::SELL;
             order.type = OrderType::LIMIT;
-            order.price = tick.ask_price;
-            order.quantity = 10;
-            order.client_order_id = tick.sequence;
+            order.price = can_buy ? tick.ask_price : tick.bid_price;
+            order.quantity = order_size_;
             record_timestamp("order_built");
-            submit_order(order);  // This also records "order_submitted"
-        } else if (can_sell) {
-            record_timestamp("order_build_start");
-            StrategyOrder order;
-            order.symbol = tick.symbol;
-            order.side = Side::SELL;
-            order.type = OrderType::LIMIT;
-            order.price = tick.bid_price;
-            order.quantity = 10;
-            order.client_order_id = tick.sequence;
-            record_timestamp("order_built");
-            submit_order(order);  // This also records "order_submitted"
-        }
-    }
-    
-    void onOrderResponse(const OrderResponse& response) override {
-        if (response.status == OrderStatus::FILLED) {
-            // Update position (simplified)
-            position_ += (response.fill_quantity > 0) ? 1 : -1;
+            submit_order(id, order);  // This also records "order_submitted"
         }
     }
-    
-    const char* name() const override { return "Momentum"; }
 
 private:
-    Price last_price_ = 0;
-    int position_ = 0;
-    int max_position_ = 100;
+    static constexpr Quantity order_size_ = 10;
+    static constexpr Quantity max_position_ = 100 * order_size_;
 };
 
 /**
  * @brief Example market making strategy
+ * 
+ * Quotes both sides around each symbol's mid at half the market spread,
+ * and requotes a symbol only when its quotes move.
  */
-class MarketMakingStrategy : public UserStrategy {
+class MarketMakingStrategy : public MultiSymbolStrategy {
 public:
-    void onTick(const Tick& tick) override {
+    const char* name() const override { return "MarketMaking"; }
+
+protected:
+    void on_signal(InstrumentId id, const Tick& tick) override {
         Price mid = (tick.bid_price + tick.ask_price) / 2;
         Price spread = tick.ask_price - tick.bid_price;
         
@@ -422,28 +690,29 @@ public:
         Price my_spread = spread / 2;
         if (my_spread < min_spread_) my_spread = min_spread_;
         
+        const Price bid = mid - my_spread / 2;
+        const Price ask = mid + my_spread / 2;
+        if (bid == bid_quote(id) && ask == ask_quote(id)) return;
+        set_quotes(id, bid, ask);
+        
         // Buy order
         StrategyOrder buy_order;
         buy_order.symbol = tick.symbol;
         buy_order.side = Side::BUY;
         buy_order.type = OrderType::LIMIT;
-        buy_order.price = mid - my_spread / 2;
+        buy_order.price = bid;
         buy_order.quantity = quote_size_;
-        buy_order.client_order_id = tick.sequence * 2;
-        submit_order(buy_order);
+        submit_order(id, buy_order);
         
         // Sell order
         StrategyOrder sell_order;
         sell_order.symbol = tick.symbol;
         sell_order.side = Side::SELL;
         sell_order.type = OrderType::LIMIT;
-        sell_order.price = mid + my_spread / 2;
+        sell_order.price = ask;
         sell_order.quantity = quote_size_;
-        sell_order.client_order_id = tick.sequence * 2 + 1;
-        submit_order(sell_order);
+        submit_order(id, sell_order);
     }
-    
-    const char* name() const override { return "MarketMaking"; }
 
 private:
     Price min_spread_ = 100;  // Minimum spread in price units
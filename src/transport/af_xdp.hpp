@@ -0,0 +1,353 @@
+/**
+ * @file af_xdp.hpp
+ * @brief AF_XDP kernel-bypass receive path for multicast market data
+ *
+ * With an XDP program on the NIC queue redirecting the feed into an
+ * XSKMAP, frames land in a UMEM shared between the kernel and this process
+ * and are picked up from the RX ring by polling, without the kernel UDP
+ * stack, socket buffers or a syscall per batch:
+ * - One UMEM of fixed-size frames, all handed to the kernel via the fill
+ *   ring up front and recycled as soon as a frame is parsed
+ * - XDP_ZEROCOPY where the driver supports it (else XDP_COPY)
+ * - Ethernet / VLAN / IPv4 / UDP headers parsed in-process; only datagrams
+ *   for the configured group and port carrying a MarketDataPacket pass
+ *
+ * The redirect program is loaded out of band (e.g. xdp-loader) with its
+ * XSKMAP pinned in bpffs; XdpSocket only inserts itself at its queue ID.
+ * Joining the multicast group still goes through a regular socket so the
+ * switch keeps forwarding: see UDPMulticastReceiver::enable_xdp().
+ *
+ * The socket is built only with -DHFT_ENABLE_AF_XDP=ON (Linux); the frame
+ * parser is always available.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+
+#if defined(__linux__) && defined(HFT_ENABLE_AF_XDP)
+#include <atomic>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/bpf.h>
+#include <linux/if_xdp.h>
+#endif
+
+namespace hft {
+
+struct MarketDataPacket;
+
+enum class FrameResult : std::uint8_t {
+    PACKET,         // Feed datagram, payload copied out
+    OTHER,          // Not for this feed (other protocol, address or port)
+    MALFORMED       // For this feed, but truncated or the wrong size
+};
+
+/**
+ * @brief Parse one Ethernet frame carrying a MarketDataPacket datagram
+ *
+ * @param group_be Destination IPv4 address, network order (0 = any)
+ * @param port_be Destination UDP port, network order
+ */
+template<typename Packet = MarketDataPacket>
+[[nodiscard]] FrameResult parse_feed_frame(std::span<const std::uint8_t> frame, std::uint32_t group_be,
+                                           std::uint16_t port_be, Packet& out) noexcept {
+    constexpr std::size_t ETH_HEADER = 14;
+    constexpr std::size_t VLAN_TAG = 4;
+    constexpr std::size_t IPV4_MIN_HEADER = 20;
+    constexpr std::size_t UDP_HEADER = 8;
+    auto be16 = [&frame](std::size_t at) {
+        return static_cast<std::uint16_t>((frame[at] << 8) | frame[at + 1]);
+    };
+
+    if (frame.size() < ETH_HEADER + IPV4_MIN_HEADER + UDP_HEADER) return FrameResult::OTHER;
+    std::size_t ip = ETH_HEADER;
+    std::uint16_t ether_type = be16(12);
+    while ((ether_type == 0x8100 || ether_type == 0x88A8) && frame.size() >= ip + VLAN_TAG + IPV4_MIN_HEADER) {
+        ether_type = be16(ip + 2);
+        ip += VLAN_TAG;
+    }
+    if (ether_type != 0x0800 || frame.size() < ip + IPV4_MIN_HEADER) return FrameResult::OTHER;
+
+    const std::size_t ihl = static_cast<std::size_t>(frame[ip] & 0x0F) * 4;
+    if ((frame[ip] >> 4) != 4 || ihl < IPV4_MIN_HEADER || frame[ip + 9] != 17) return FrameResult::OTHER;
+    std::uint32_t dst_be;
+    std::memcpy(&dst_be, &frame[ip + 16], sizeof(dst_be));
+    if (group_be != 0 && dst_be != group_be) return FrameResult::OTHER;
+
+    const std::size_t udp = ip + ihl;
+    if (frame.size() < udp + UDP_HEADER) return FrameResult::MALFORMED;
+    std::uint16_t dst_port_be;
+    std::memcpy(&dst_port_be, &frame[udp + 2], sizeof(dst_port_be));
+    if (dst_port_be != port_be) return FrameResult::OTHER;
+
+    // Fragments and short or oversized datagrams are not a packet
+    if ((be16(ip + 6) & 0x3FFF) != 0) return FrameResult::MALFORMED;
+    const std::size_t ip_length = be16(ip + 2);
+    const std::size_t udp_length = be16(udp + 4);
+    if (udp_length != UDP_HEADER + sizeof(Packet) || ip_length < ihl + udp_length ||
+        frame.size() < ip + ihl + udp_length) {
+        return FrameResult::MALFORMED;
+    }
+    std::memcpy(static_cast<void*>(&out), &frame[udp + UDP_HEADER], sizeof(Packet));
+    return FrameResult::PACKET;
+}
+
+/**
+ * @brief Where and how to attach an XdpSocket
+ */
+struct XdpConfig {
+    std::string interface;              // NIC carrying the feed
+    std::uint32_t queue_id = 0;         // RX queue the feed is steered to
+    std::string xskmap_path;            // Pinned XSKMAP of the redirect program
+    std::uint32_t frame_count = 4096;   // UMEM frames (power of 2)
+    std::uint32_t frame_size = 2048;    // Power of 2, >= 2048
+    bool zero_copy = true;              // Fall back to copy mode if refused
+};
+
+#if defined(__linux__) && defined(HFT_ENABLE_AF_XDP)
+
+/**
+ * @brief One AF_XDP socket on one NIC queue, RX only
+ *
+ * Not thread-safe: open() and poll() belong to the receiving thread,
+ * which should be pinned to a core near the NIC queue.
+ */
+class XdpSocket {
+public:
+    XdpSocket() = default;
+    ~XdpSocket() { close(); }
+
+    // Non-copyable
+    XdpSocket(const XdpSocket&) = delete;
+    XdpSocket& operator=(const XdpSocket&) = delete;
+
+    /**
+     * @brief Create the UMEM and rings, bind to the queue, join the XSKMAP
+     * @return false (with error() set) on any failure
+     */
+    bool open(const XdpConfig& config) {
+        close();
+        config_ = config;
+        if (config.frame_count == 0 || (config.frame_count & (config.frame_count - 1)) != 0 ||
+            config.frame_size < 2048 || (config.frame_size & (config.frame_size - 1)) != 0) {
+            errno = EINVAL;
+            return fail("frame_count and frame_size must be powers of 2, frame_size >= 2048");
+        }
+        const unsigned ifindex = if_nametoindex(config.interface.c_str());
+        if (ifindex == 0) return fail("unknown interface");
+
+        fd_ = ::socket(AF_XDP, SOCK_RAW, 0);
+        if (fd_ < 0) return fail("socket(AF_XDP)");
+
+        umem_size_ = static_cast<std::size_t>(config.frame_count) * config.frame_size;
+        umem_ = ::mmap(nullptr, umem_size_, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (umem_ == MAP_FAILED) {
+            umem_ = nullptr;
+            return fail("mmap(UMEM)");
+        }
+        xdp_umem_reg reg{};
+        reg.addr = reinterpret_cast<std::uint64_t>(umem_);
+        reg.len = umem_size_;
+        reg.chunk_size = config.frame_size;
+        reg.headroom = 0;
+        if (::setsockopt(fd_, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) != 0) return fail("XDP_UMEM_REG");
+
+        // RX only: the completion ring is required but stays minimal
+        const std::uint32_t ring_size = config.frame_count;
+        const std::uint32_t completion_size = 64;
+        if (::setsockopt(fd_, SOL_XDP, XDP_UMEM_FILL_RING, &ring_size, sizeof(ring_size)) != 0 ||
+            ::setsockopt(fd_, SOL_XDP, XDP_UMEM_COMPLETION_RING, &completion_size, sizeof(completion_size)) != 0 ||
+            ::setsockopt(fd_, SOL_XDP, XDP_RX_RING, &ring_size, sizeof(ring_size)) != 0) {
+            return fail("ring sizes");
+        }
+
+        xdp_mmap_offsets offsets{};
+        socklen_t length = sizeof(offsets);
+        if (::getsockopt(fd_, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &length) != 0) return fail("XDP_MMAP_OFFSETS");
+        if (!map_ring(fill_, offsets.fr, ring_size, sizeof(std::uint64_t), XDP_UMEM_PGOFF_FILL_RING) ||
+            !map_ring(completion_, offsets.cr, completion_size, sizeof(std::uint64_t),
+                      XDP_UMEM_PGOFF_COMPLETION_RING) ||
+            !map_ring(rx_, offsets.rx, ring_size, sizeof(xdp_desc), XDP_PGOFF_RX_RING)) {
+            return fail("mmap(rings)");
+        }
+
+        // Every frame starts out owned by the kernel
+        auto* addrs = static_cast<std::uint64_t*>(fill_.desc);
+        for (std::uint32_t i = 0; i < ring_size; ++i) {
+            addrs[i] = static_cast<std::uint64_t>(i) * config.frame_size;
+        }
+        std::atomic_ref<std::uint32_t>(*fill_.producer).store(ring_size, std::memory_order_release);
+
+        sockaddr_xdp addr{};
+        addr.sxdp_family = AF_XDP;
+        addr.sxdp_ifindex = ifindex;
+        addr.sxdp_queue_id = config.queue_id;
+        addr.sxdp_flags = XDP_USE_NEED_WAKEUP | (config.zero_copy ? XDP_ZEROCOPY : XDP_COPY);
+        if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            if (!config.zero_copy) return fail("bind");
+            addr.sxdp_flags = XDP_USE_NEED_WAKEUP | XDP_COPY;
+            if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return fail("bind");
+        }
+        zero_copy_ = (addr.sxdp_flags & XDP_ZEROCOPY) != 0;
+
+        if (!join_xskmap()) return false;
+        error_.clear();
+        return true;
+    }
+
+    void close() noexcept {
+        unmap_ring(fill_);
+        unmap_ring(completion_);
+        unmap_ring(rx_);
+        if (umem_) {
+            ::munmap(umem_, umem_size_);
+            umem_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);       // Also drops it from the XSKMAP
+            fd_ = -1;
+        }
+    }
+
+    /**
+     * @brief Hand up to max_frames received frames to fn(span<const uint8_t>)
+     *
+     * The span is only valid during the call: the frame goes straight back
+     * to the fill ring afterwards. Never blocks.
+     * @return Frames delivered
+     */
+    template<typename Fn>
+    std::size_t poll(Fn&& fn, std::size_t max_frames) {
+        if (fd_ < 0) return 0;
+        const std::uint32_t consumer = *rx_.consumer;
+        const std::uint32_t available =
+            std::atomic_ref<std::uint32_t>(*rx_.producer).load(std::memory_order_acquire) - consumer;
+        const auto n = static_cast<std::uint32_t>(std::min<std::size_t>(available, max_frames));
+        if (n == 0) {
+            kick_if_needed();
+            return 0;
+        }
+
+        const auto* descs = static_cast<const xdp_desc*>(rx_.desc);
+        auto* fill = static_cast<std::uint64_t*>(fill_.desc);
+        const std::uint32_t fill_producer = *fill_.producer;
+        const auto* base = static_cast<const std::uint8_t*>(umem_);
+        for (std::uint32_t i = 0; i < n; ++i) {
+            const xdp_desc& desc = descs[(consumer + i) & rx_.mask];
+            fn(std::span<const std::uint8_t>(base + desc.addr, desc.len));
+            // Aligned mode: the frame is the chunk holding the address
+            fill[(fill_producer + i) & fill_.mask] = desc.addr & ~static_cast<std::uint64_t>(config_.frame_size - 1);
+        }
+        // Release the descriptors, then return their frames to the kernel
+        std::atomic_ref<std::uint32_t>(*rx_.consumer).store(consumer + n, std::memory_order_release);
+        std::atomic_ref<std::uint32_t>(*fill_.producer).store(fill_producer + n, std::memory_order_release);
+        kick_if_needed();
+        return n;
+    }
+
+    /**
+     * @brief Kernel counters: frames dropped for lack of fill or RX ring space
+     */
+    [[nodiscard]] xdp_statistics statistics() const noexcept {
+        xdp_statistics stats{};
+        socklen_t length = sizeof(stats);
+        if (fd_ >= 0) {
+            (void)::getsockopt(fd_, SOL_XDP, XDP_STATISTICS, &stats, &length);
+        }
+        return stats;
+    }
+
+    [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+    [[nodiscard]] bool zero_copy() const noexcept { return zero_copy_; }
+    [[nodiscard]] const std::string& error() const noexcept { return error_; }
+
+private:
+    struct Ring {
+        void* map = nullptr;
+        std::size_t map_size = 0;
+        std::uint32_t* producer = nullptr;
+        std::uint32_t* consumer = nullptr;
+        std::uint32_t* flags = nullptr;
+        void* desc = nullptr;
+        std::uint32_t mask = 0;
+    };
+
+    bool map_ring(Ring& ring, const xdp_ring_offset& offset, std::uint32_t size, std::size_t entry,
+                  off_t pgoff) {
+        ring.map_size = offset.desc + size * entry;
+        void* map = ::mmap(nullptr, ring.map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, pgoff);
+        if (map == MAP_FAILED) return false;
+        auto* bytes = static_cast<std::uint8_t*>(map);
+        ring.map = map;
+        ring.producer = reinterpret_cast<std::uint32_t*>(bytes + offset.producer);
+        ring.consumer = reinterpret_cast<std::uint32_t*>(bytes + offset.consumer);
+        ring.flags = reinterpret_cast<std::uint32_t*>(bytes + offset.flags);
+        ring.desc = bytes + offset.desc;
+        ring.mask = size - 1;
+        return true;
+    }
+
+    static void unmap_ring(Ring& ring) noexcept {
+        if (ring.map) {
+            ::munmap(ring.map, ring.map_size);
+        }
+        ring = Ring{};
+    }
+
+    // With XDP_USE_NEED_WAKEUP the driver only refills from the fill ring when asked
+    void kick_if_needed() noexcept {
+        if (std::atomic_ref<std::uint32_t>(*fill_.flags).load(std::memory_order_relaxed) & XDP_RING_NEED_WAKEUP) {
+            (void)::recvfrom(fd_, nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+        }
+    }
+
+    bool join_xskmap() {
+        union bpf_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.pathname = reinterpret_cast<std::uint64_t>(config_.xskmap_path.c_str());
+        const int map_fd = static_cast<int>(::syscall(__NR_bpf, BPF_OBJ_GET, &attr, sizeof(attr)));
+        if (map_fd < 0) return fail("BPF_OBJ_GET(xskmap_path)");
+
+        const std::uint32_t key = config_.queue_id;
+        const std::uint32_t value = static_cast<std::uint32_t>(fd_);
+        std::memset(&attr, 0, sizeof(attr));
+        attr.map_fd = static_cast<std::uint32_t>(map_fd);
+        attr.key = reinterpret_cast<std::uint64_t>(&key);
+        attr.value = reinterpret_cast<std::uint64_t>(&value);
+        attr.flags = BPF_ANY;
+        const long updated = ::syscall(__NR_bpf, BPF_MAP_UPDATE_ELEM, &attr, sizeof(attr));
+        ::close(map_fd);
+        return updated == 0 || fail("BPF_MAP_UPDATE_ELEM");
+    }
+
+    bool fail(const char* what) {
+        error_ = std::string(what) + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+
+    XdpConfig config_;
+    int fd_ = -1;
+    void* umem_ = nullptr;
+    std::size_t umem_size_ = 0;
+    Ring fill_;
+    Ring completion_;
+    Ring rx_;
+    bool zero_copy_ = false;
+    std::string error_;
+};
+
+#endif // __linux__ && HFT_ENABLE_AF_XDP
+
+} // namespace hft
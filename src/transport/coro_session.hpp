@@ -0,0 +1,611 @@
+/**
+ * @file coro_session.hpp
+ * @brief Coroutine-per-connection sessions on top of the Reactor
+ *
+ * Each client connection runs one C++20 coroutine that reads and writes
+ * as if it were blocking:
+ *
+ *   SessionTask echo(CoroSession& session) {
+ *       while (auto msg = co_await session.read_message<OrderPacket>()) {
+ *           if (!co_await session.write(*msg)) break;
+ *       }
+ *   }
+ *   SessionHost host(reactor);
+ *   host.listen(listen_fd, echo);
+ *   for (;;) { reactor.poll(0); host.flush(); }
+ *
+ * A suspended session costs its coroutine frame and its buffers, not a
+ * thread, so one pinned thread can hold thousands of idle sessions next
+ * to a few busy ones. Nothing allocates per message:
+ * - Frames come from CoroFramePool, a per-thread free list by size class
+ * - Session objects and their byte buffers are recycled by the host, and
+ *   keep the capacity they grew to
+ *
+ * read_message() completes once a whole message is buffered, so stream
+ * fragmentation never reaches session code; all buffered messages are
+ * handed over in one resume. write() sends at once when the socket takes
+ * it, otherwise queues the rest and suspends until flush() drains it.
+ * A session ends when its coroutine returns (the host then closes the fd)
+ * or when the peer closes (pending reads return nullopt, writes false).
+ *
+ * Single thread: the reactor's, which must also call flush().
+ *
+ * Used for the gateway's binary OrderPacket sessions. HttpServer and the
+ * WebSocket server run their own reactor-driven per-connection state
+ * machines and do not use this layer.
+ */
+
+#pragma once
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "core/reactor.hpp"
+
+namespace hft {
+
+/**
+ * @brief Per-thread pool of coroutine frames
+ *
+ * Frames are rounded up to GRANULE bytes and kept on a free list per size
+ * class when released; frames larger than MAX_POOLED go to the heap.
+ * Every frame is FRAME_ALIGNMENT aligned: GCC lays out over-aligned
+ * locals (OrderPacket is alignas(64)) assuming the frame is, but only
+ * passes the size to operator new.
+ */
+class CoroFramePool {
+public:
+    static constexpr std::size_t GRANULE = 128;
+    static constexpr std::size_t CLASSES = 32;
+    static constexpr std::size_t MAX_POOLED = GRANULE * CLASSES;
+    static constexpr std::size_t FRAME_ALIGNMENT = 64;
+
+    struct Stats {
+        std::uint64_t fresh = 0;        // Frames taken from the heap
+        std::uint64_t reused = 0;       // Frames taken from a free list
+    };
+
+    [[nodiscard]] static void* allocate(std::size_t size) {
+        const std::size_t c = size_class(size);
+        if (c >= CLASSES) return ::operator new(size, ALIGN);
+        Lists& lists = local();
+        if (Node* node = lists.free[c]) {
+            lists.free[c] = node->next;
+            ++lists.stats.reused;
+            return node;
+        }
+        ++lists.stats.fresh;
+        return ::operator new((c + 1) * GRANULE, ALIGN);
+    }
+
+    static void deallocate(void* frame, std::size_t size) noexcept {
+        const std::size_t c = size_class(size);
+        if (c >= CLASSES) {
+            ::operator delete(frame, ALIGN);
+            return;
+        }
+        Lists& lists = local();
+        lists.free[c] = ::new (frame) Node{lists.free[c]};
+    }
+
+    /**
+     * @brief Put count frames of size bytes on this thread's free list (setup path)
+     */
+    static void reserve(std::size_t size, std::size_t count) {
+        const std::size_t c = size_class(size);
+        if (c >= CLASSES) return;
+        Lists& lists = local();
+        for (std::size_t i = 0; i < count; ++i) {
+            lists.free[c] = ::new (::operator new((c + 1) * GRANULE, ALIGN)) Node{lists.free[c]};
+        }
+    }
+
+    [[nodiscard]] static Stats stats() noexcept { return local().stats; }
+
+private:
+    static constexpr std::align_val_t ALIGN{FRAME_ALIGNMENT};
+
+    struct Node {
+        Node* next;
+    };
+
+    struct Lists {
+        std::array<Node*, CLASSES> free{};
+        Stats stats;
+
+        ~Lists() {
+            for (Node* head : free) {
+                while (head) {
+                    Node* next = head->next;
+                    ::operator delete(head, ALIGN);
+                    head = next;
+                }
+            }
+        }
+    };
+
+    static std::size_t size_class(std::size_t size) noexcept {
+        return size == 0 ? 0 : (size - 1) / GRANULE;
+    }
+
+    static Lists& local() noexcept {
+        thread_local Lists lists;
+        return lists;
+    }
+};
+
+/**
+ * @brief Coroutine type of a session; started and reaped by SessionHost
+ */
+class SessionTask {
+public:
+    struct promise_type {
+        bool failed = false;            // Ended by an exception
+
+        SessionTask get_return_object() noexcept {
+            return SessionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { failed = true; }
+
+        static void* operator new(std::size_t size) { return CoroFramePool::allocate(size); }
+        static void operator delete(void* frame, std::size_t size) noexcept {
+            CoroFramePool::deallocate(frame, size);
+        }
+    };
+
+    SessionTask() noexcept = default;
+    SessionTask(SessionTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    SessionTask& operator=(SessionTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    ~SessionTask() { reset(); }
+
+    [[nodiscard]] bool valid() const noexcept { return static_cast<bool>(handle_); }
+    [[nodiscard]] bool done() const noexcept { return !handle_ || handle_.done(); }
+    [[nodiscard]] bool failed() const noexcept { return handle_ && handle_.promise().failed; }
+
+    void resume() {
+        if (handle_ && !handle_.done()) handle_.resume();
+    }
+
+    void reset() noexcept {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = {};
+        }
+    }
+
+private:
+    explicit SessionTask(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief One connection as seen from its coroutine
+ */
+class CoroSession {
+public:
+    // Unsent bytes beyond this end the session (the peer is not reading)
+    static constexpr std::size_t MAX_OUTBOX = 1 << 20;
+
+    [[nodiscard]] int fd() const noexcept { return fd_; }
+    [[nodiscard]] bool closed() const noexcept { return closed_; }
+    [[nodiscard]] std::size_t buffered() const noexcept { return in_.size() - in_head_; }
+    [[nodiscard]] std::size_t unsent() const noexcept { return out_.size() - out_head_; }
+
+    /**
+     * @brief Next whole Message, or nullopt once the peer closed
+     *
+     * Messages buffered before the close are still delivered.
+     */
+    template<typename Message>
+    [[nodiscard]] auto read_message() noexcept {
+        static_assert(std::is_trivially_copyable_v<Message>, "Messages are copied bytewise");
+        struct Awaiter {
+            CoroSession& session;
+
+            bool await_ready() const noexcept {
+                return session.closed_ || session.buffered() >= sizeof(Message);
+            }
+            void await_suspend(std::coroutine_handle<> handle) noexcept {
+                session.waiting_ = handle;
+                session.want_ = sizeof(Message);
+            }
+            std::optional<Message> await_resume() noexcept {
+                if (session.buffered() < sizeof(Message)) return std::nullopt;
+                Message message;
+                std::memcpy(&message, session.in_.data() + session.in_head_, sizeof(Message));
+                session.consume(sizeof(Message));
+                return message;
+            }
+        };
+        return Awaiter{*this};
+    }
+
+    /**
+     * @brief Send data, suspending while it does not fit the socket
+     *
+     * @return false if the session closed before everything was sent
+     */
+    [[nodiscard]] auto write(std::span<const char> data) noexcept {
+        struct Awaiter {
+            CoroSession& session;
+            bool queued;
+
+            bool await_ready() const noexcept {
+                return !queued || session.unsent() == 0;
+            }
+            void await_suspend(std::coroutine_handle<> handle) noexcept {
+                session.waiting_ = handle;
+                session.want_ = 0;
+            }
+            bool await_resume() const noexcept {
+                return queued && !session.closed_;
+            }
+        };
+        return Awaiter{*this, send(data)};
+    }
+
+    template<typename Message>
+    [[nodiscard]] auto write(const Message& message) noexcept {
+        static_assert(std::is_trivially_copyable_v<Message>, "Messages are copied bytewise");
+        return write(std::span<const char>(reinterpret_cast<const char*>(&message), sizeof(Message)));
+    }
+
+    /**
+     * @brief Send without waiting (from outside the coroutine, e.g. a response callback)
+     *
+     * What the socket does not take now is queued for flush().
+     * @return false if the session is closed or its outbox is full
+     */
+    bool send(std::span<const char> data) noexcept {
+        if (closed_) return false;
+        if (unsent() == 0) {
+            const std::size_t sent = send_now(data);
+            if (closed_) {
+                queue_flush();
+                return false;
+            }
+            data = data.subspan(sent);
+            if (data.empty()) return true;
+        }
+        if (unsent() + data.size() > MAX_OUTBOX) {
+            mark_closed();
+            queue_flush();              // Lets the host reap it
+            return false;
+        }
+        out_.insert(out_.end(), data.begin(), data.end());
+        queue_flush();
+        return true;
+    }
+
+    template<typename Message>
+    bool send(const Message& message) noexcept {
+        static_assert(std::is_trivially_copyable_v<Message>, "Messages are copied bytewise");
+        return send(std::span<const char>(reinterpret_cast<const char*>(&message), sizeof(Message)));
+    }
+
+private:
+    friend class SessionHost;
+
+    void open(int fd, std::vector<int>* backlog) noexcept {
+        fd_ = fd;
+        backlog_ = backlog;
+        in_backlog_ = false;
+        closed_ = false;
+        in_.clear();
+        in_head_ = 0;
+        out_.clear();
+        out_head_ = 0;
+        waiting_ = {};
+        want_ = 0;
+    }
+
+    void consume(std::size_t n) noexcept {
+        in_head_ += n;
+        if (in_head_ == in_.size()) {
+            in_.clear();
+            in_head_ = 0;
+        }
+    }
+
+    void append(std::span<const char> data) {
+        // Drop consumed bytes before growing
+        if (in_head_ > 0 && in_.size() + data.size() > in_.capacity()) {
+            in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(in_head_));
+            in_head_ = 0;
+        }
+        in_.insert(in_.end(), data.begin(), data.end());
+    }
+
+    std::size_t send_now(std::span<const char> data) noexcept {
+        #ifdef __linux__
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n > 0) {
+                sent += static_cast<std::size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) mark_closed();
+                break;
+            }
+        }
+        return sent;
+        #else
+        (void)data;
+        mark_closed();
+        return 0;
+        #endif
+    }
+
+    /**
+     * @brief Retry queued output; true once it is all sent
+     */
+    bool flush_outbox() noexcept {
+        if (unsent() > 0 && !closed_) {
+            out_head_ += send_now(std::span<const char>(out_.data() + out_head_, unsent()));
+        }
+        if (unsent() == 0) {
+            out_.clear();
+            out_head_ = 0;
+            return true;
+        }
+        return false;
+    }
+
+    void mark_closed() noexcept { closed_ = true; }
+
+    /**
+     * @brief Have the host's next flush() look at this session
+     */
+    void queue_flush() {
+        if (!in_backlog_ && backlog_) {
+            in_backlog_ = true;
+            backlog_->push_back(fd_);
+        }
+    }
+
+    /**
+     * @brief The coroutine waits and what it waits for is there (or never will be)
+     */
+    [[nodiscard]] bool wakeable() const noexcept {
+        if (!waiting_) return false;
+        if (closed_) return true;
+        return want_ > 0 ? buffered() >= want_ : unsent() == 0;
+    }
+
+    int fd_ = -1;
+    bool closed_ = true;
+    std::vector<char> in_;
+    std::size_t in_head_ = 0;
+    std::vector<char> out_;
+    std::size_t out_head_ = 0;
+    std::coroutine_handle<> waiting_;
+    std::size_t want_ = 0;              // Bytes a read waits for; 0 = a write waits for the outbox
+    std::vector<int>* backlog_ = nullptr;
+    bool in_backlog_ = false;
+    std::function<SessionTask(CoroSession&)> factory_;
+    SessionTask task_;
+};
+
+/**
+ * @brief Runs one coroutine per connection on a Reactor
+ */
+class SessionHost {
+public:
+    using Factory = std::function<SessionTask(CoroSession&)>;
+
+    struct Stats {
+        std::uint64_t opened = 0;
+        std::uint64_t finished = 0;
+        std::uint64_t failed = 0;       // Ended by an exception in the coroutine
+    };
+
+    explicit SessionHost(Reactor& reactor) noexcept : reactor_(reactor) {}
+
+    ~SessionHost() { close_all(); }
+
+    // Non-copyable
+    SessionHost(const SessionHost&) = delete;
+    SessionHost& operator=(const SessionHost&) = delete;
+
+    /**
+     * @brief Start factory(session) for every connection accepted on listen_fd
+     *
+     * The caller keeps ownership of listen_fd.
+     */
+    bool listen(int listen_fd, Factory factory) {
+        if (!reactor_.listen(listen_fd, [this, factory = std::move(factory)](int client_fd) {
+                open(client_fd, factory);
+            })) {
+            return false;
+        }
+        listeners_.push_back(listen_fd);
+        return true;
+    }
+
+    /**
+     * @brief Start a session on an already connected socket (the host then owns fd)
+     */
+    bool adopt(int fd, Factory factory) {
+        return open(fd, std::move(factory));
+    }
+
+    /**
+     * @brief Keep count spare sessions (setup path; with CoroFramePool::reserve, no heap at connect)
+     */
+    void reserve(std::size_t count) {
+        while (spare_.size() < count) spare_.push_back(std::make_unique<CoroSession>());
+    }
+
+    /**
+     * @brief Retry queued writes, resume the writers they unblock and reap
+     *        sessions closed by a failed send (call every loop)
+     */
+    void flush() {
+        for (std::size_t i = 0; i < backlog_.size();) {
+            CoroSession* session = find(backlog_[i]);
+            if (session && !session->flush_outbox() && !session->closed()) {
+                ++i;
+                continue;
+            }
+            backlog_[i] = backlog_.back();
+            backlog_.pop_back();
+            if (session) {
+                session->in_backlog_ = false;
+                wake(*session);
+            }
+        }
+    }
+
+    [[nodiscard]] CoroSession* find(int fd) noexcept {
+        if (fd < 0 || static_cast<std::size_t>(fd) >= sessions_.size()) return nullptr;
+        return sessions_[static_cast<std::size_t>(fd)].get();
+    }
+
+    /**
+     * @brief Live sessions
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return live_; }
+    [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+
+    /**
+     * @brief End every session (frames destroyed, fds closed) and stop listening
+     */
+    void close_all() {
+        for (int fd : listeners_) reactor_.remove(fd);
+        listeners_.clear();
+        for (std::size_t fd = 0; fd < sessions_.size(); ++fd) {
+            if (sessions_[fd]) finish(static_cast<int>(fd));
+        }
+        backlog_.clear();
+    }
+
+private:
+    bool open(int fd, Factory factory) {
+        #ifdef __linux__
+        if (fd < 0) return false;
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        if (static_cast<std::size_t>(fd) >= sessions_.size()) sessions_.resize(static_cast<std::size_t>(fd) + 1);
+        std::unique_ptr<CoroSession> session;
+        if (!spare_.empty()) {
+            session = std::move(spare_.back());
+            spare_.pop_back();
+        } else {
+            session = std::make_unique<CoroSession>();
+        }
+        session->open(fd, &backlog_);
+        CoroSession& s = *session;
+        sessions_[static_cast<std::size_t>(fd)] = std::move(session);
+        ++live_;
+        ++stats_.opened;
+        if (!reactor_.receive(fd, [this](int client_fd, std::span<const char> data) {
+                on_data(client_fd, data);
+            })) {
+            finish(fd);
+            return false;
+        }
+        // The session keeps the factory: a lambda coroutine's captures live in it
+        s.factory_ = std::move(factory);
+        s.task_ = s.factory_(s);
+        s.task_.resume();               // Runs to its first co_await
+        settle(s);
+        return true;
+        #else
+        (void)fd;
+        (void)factory;
+        return false;
+        #endif
+    }
+
+    void on_data(int fd, std::span<const char> data) {
+        CoroSession* session = find(fd);
+        if (!session) return;
+        if (data.empty()) {
+            session->mark_closed();
+        } else {
+            session->append(data);
+        }
+        wake(*session);
+    }
+
+    void wake(CoroSession& session) {
+        if (session.wakeable()) {
+            session.waiting_ = {};
+            session.task_.resume();
+        }
+        settle(session);
+    }
+
+    /**
+     * @brief After the coroutine ran: end it, or note pending output
+     */
+    void settle(CoroSession& session) {
+        if (session.task_.done() || session.closed()) {
+            finish(session.fd());
+            return;
+        }
+        if (session.unsent() > 0) session.queue_flush();
+    }
+
+    void finish(int fd) {
+        auto& slot = sessions_[static_cast<std::size_t>(fd)];
+        std::unique_ptr<CoroSession> session = std::move(slot);
+        if (!session) return;
+        // A closed session gets one last resume to see nullopt / false and clean up
+        if (!session->task_.done() && session->closed() && session->waiting_) {
+            session->waiting_ = {};
+            session->task_.resume();
+        }
+        if (session->task_.failed()) ++stats_.failed;
+        ++stats_.finished;
+        session->task_.reset();
+        session->factory_ = nullptr;
+        reactor_.remove(fd);
+        #ifdef __linux__
+        ::close(fd);
+        #endif
+        session->fd_ = -1;
+        session->closed_ = true;
+        --live_;
+        spare_.push_back(std::move(session));
+    }
+
+    Reactor& reactor_;
+    std::vector<std::unique_ptr<CoroSession>> sessions_;   // Indexed by fd
+    std::vector<std::unique_ptr<CoroSession>> spare_;      // Recycled, buffers kept
+    std::vector<int> listeners_;
+    std::vector<int> backlog_;                              // Fds for flush() to look at
+    std::size_t live_ = 0;
+    Stats stats_;
+};
+
+} // namespace hft
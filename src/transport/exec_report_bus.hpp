@@ -0,0 +1,305 @@
+/**
+ * @file exec_report_bus.hpp
+ * @brief Shared-memory broadcast ring of execution reports
+ *
+ * The matching engine has one ExecutionCallback; every consumer chained
+ * inside it (drop copy, post-trade risk, audit log) adds its cost to
+ * matching latency. ExecReportBus takes that cost off the engine thread:
+ * the callback publishes each report into a ring that any number of
+ * readers, in this process or another, follow at their own pace.
+ *
+ *   ExecReportBus bus("/hft_exec");             // Engine process
+ *   bus.init();
+ *   engine.set_execution_callback([&](const ExecutionReport& r) { bus.publish(r); });
+ *
+ *   ExecReportReader reader("/hft_exec");       // Consumer process
+ *   reader.connect();
+ *   for (;;) idle.idle(reader.poll([](const ExecutionReport& r) { ... }));
+ *
+ * The producer never waits: it does not read consumer cursors and
+ * overwrites the oldest slot when the ring is full, so publishing costs
+ * the same with zero readers or twenty. Each slot carries its sequence
+ * number, seqlock style, so a reader that falls more than RING_SIZE
+ * behind (or is overwritten mid-copy) detects it, skips to the oldest
+ * report still in the ring and counts what it missed in lost().
+ * Consumers that must not miss reports size their polling accordingly or
+ * recover the gap from the engine journal.
+ *
+ * An empty name keeps the ring in anonymous memory for in-process readers.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "core/types.hpp"
+#include "matching/order.hpp"
+#include "shm_transport.hpp"
+
+namespace hft {
+
+/**
+ * @brief Layout of the bus segment (constructed in place by the producer)
+ */
+struct ExecReportBusSegment {
+    static constexpr std::uint32_t MAGIC = 0x48465842;  // "HFXB"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t RING_SIZE = 16384;
+    static constexpr std::size_t MASK = RING_SIZE - 1;
+    static_assert((RING_SIZE & MASK) == 0, "RING_SIZE must be a power of two");
+
+    /**
+     * @brief One report; sequence is 2s+1 while report s is written, 2s+2 once it is complete
+     */
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        ExecutionReport report{};
+    };
+
+    std::uint32_t magic = MAGIC;
+    std::uint32_t version = VERSION;
+    std::atomic<std::uint32_t> ready{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head{0};   // Reports published
+    Slot slots[RING_SIZE];
+};
+
+static_assert(std::is_trivially_copyable_v<ExecutionReport>, "Reports are copied bytewise");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared-memory rings need address-free atomics");
+
+/**
+ * @brief Where a new reader starts
+ */
+enum class BusStart : std::uint8_t {
+    LATEST,     // Reports published after it attached
+    OLDEST      // Everything still in the ring
+};
+
+/**
+ * @brief Producer side; publish() from the one thread that owns the engine
+ */
+class ExecReportBus {
+public:
+    explicit ExecReportBus(const std::string& shm_name = {}) : shm_name_(shm_name) {}
+
+    ~ExecReportBus() { close_segment(); }
+
+    // Non-copyable
+    ExecReportBus(const ExecReportBus&) = delete;
+    ExecReportBus& operator=(const ExecReportBus&) = delete;
+
+    /**
+     * @brief Create the segment (a fresh ring; readers of an older one must reconnect)
+     */
+    bool init() {
+        #ifdef __linux__
+        close_segment();
+        if (shm_name_.empty()) {
+            void* addr = mmap(nullptr, sizeof(ExecReportBusSegment), PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+            segment_ = addr == MAP_FAILED ? nullptr : static_cast<ExecReportBusSegment*>(addr);
+        } else {
+            shm_unlink(shm_name_.c_str());
+            segment_ = detail::map_segment<ExecReportBusSegment>(shm_name_, true);
+        }
+        if (!segment_) return false;
+
+        new (segment_) ExecReportBusSegment();
+        next_ = 0;
+        segment_->ready.store(1, std::memory_order_release);
+        return true;
+        #else
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief Append a report, overwriting the oldest one; never blocks
+     */
+    void publish(const ExecutionReport& report) noexcept {
+        const std::uint64_t seq = next_++;
+        auto& slot = segment_->slots[seq & ExecReportBusSegment::MASK];
+        slot.sequence.store(2 * seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(static_cast<void*>(&slot.report), &report, sizeof(ExecutionReport));
+        slot.sequence.store(2 * seq + 2, std::memory_order_release);
+        segment_->head.store(seq + 1, std::memory_order_release);
+    }
+
+    [[nodiscard]] std::uint64_t published() const noexcept { return next_; }
+    [[nodiscard]] bool ready() const noexcept { return segment_ != nullptr; }
+
+private:
+    friend class ExecReportReader;
+
+    void close_segment() {
+        #ifdef __linux__
+        if (segment_) {
+            detail::unmap_segment(segment_);
+            segment_ = nullptr;
+            if (!shm_name_.empty()) shm_unlink(shm_name_.c_str());
+        }
+        #endif
+    }
+
+    std::string shm_name_;
+    ExecReportBusSegment* segment_ = nullptr;
+    std::uint64_t next_ = 0;
+};
+
+/**
+ * @brief One consumer with its own cursor; use from one thread
+ */
+class ExecReportReader {
+public:
+    /**
+     * @brief Follow another process's bus; call connect()
+     */
+    explicit ExecReportReader(const std::string& shm_name, BusStart start = BusStart::LATEST)
+        : shm_name_(shm_name), start_(start) {}
+
+    /**
+     * @brief Follow an in-process bus (initialised, and outliving the reader)
+     */
+    explicit ExecReportReader(const ExecReportBus& bus, BusStart start = BusStart::LATEST) noexcept
+        : start_(start), segment_(bus.segment_) {
+        if (segment_) seek(start_);
+    }
+
+    ~ExecReportReader() { close_segment(); }
+
+    // Non-copyable
+    ExecReportReader(const ExecReportReader&) = delete;
+    ExecReportReader& operator=(const ExecReportReader&) = delete;
+
+    /**
+     * @brief Map the producer's segment read-only
+     */
+    bool connect() {
+        #ifdef __linux__
+        if (segment_) return true;
+        if (shm_name_.empty()) return false;
+        segment_ = detail::map_segment<ExecReportBusSegment>(shm_name_, false, true);
+        if (!segment_) return false;
+        owned_ = true;
+
+        if (segment_->magic != ExecReportBusSegment::MAGIC ||
+            segment_->version != ExecReportBusSegment::VERSION ||
+            segment_->ready.load(std::memory_order_acquire) != 1) {
+            close_segment();
+            return false;
+        }
+        seek(start_);
+        return true;
+        #else
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief Copy out the next report; false if there is none yet
+     *
+     * Reports overwritten before they could be read are skipped and added to lost().
+     */
+    [[nodiscard]] bool try_read(ExecutionReport& out) noexcept {
+        if (!segment_) return false;
+        while (true) {
+            const std::uint64_t head = segment_->head.load(std::memory_order_acquire);
+            if (cursor_ >= head) return false;
+            if (head - cursor_ > ExecReportBusSegment::RING_SIZE) {
+                // Lapped: resume at the oldest report still in the ring
+                const std::uint64_t oldest = head - ExecReportBusSegment::RING_SIZE;
+                lost_ += oldest - cursor_;
+                cursor_ = oldest;
+                ++laps_;
+            }
+
+            const auto& slot = segment_->slots[cursor_ & ExecReportBusSegment::MASK];
+            const std::uint64_t expected = 2 * cursor_ + 2;
+            if (slot.sequence.load(std::memory_order_acquire) == expected) {
+                std::memcpy(static_cast<void*>(&out), &slot.report, sizeof(ExecutionReport));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == expected) {
+                    ++cursor_;
+                    ++read_;
+                    return true;
+                }
+            }
+            // The producer already reused this slot for a later report
+            ++lost_;
+            ++cursor_;
+            ++laps_;
+        }
+    }
+
+    /**
+     * @brief Hand up to max pending reports to fn(const ExecutionReport&)
+     *
+     * @return Number delivered (for IdleStrategy::idle)
+     */
+    template<typename Fn>
+    std::size_t poll(Fn&& fn, std::size_t max = 256) {
+        ExecutionReport report;
+        std::size_t n = 0;
+        while (n < max && try_read(report)) {
+            fn(report);
+            ++n;
+        }
+        return n;
+    }
+
+    [[nodiscard]] bool connected() const noexcept { return segment_ != nullptr; }
+
+    /**
+     * @brief Sequence of the next report to read
+     */
+    [[nodiscard]] std::uint64_t cursor() const noexcept { return cursor_; }
+
+    /**
+     * @brief Reports published but not yet read (may exceed RING_SIZE before a lap is noticed)
+     */
+    [[nodiscard]] std::uint64_t lag() const noexcept {
+        return segment_ ? segment_->head.load(std::memory_order_acquire) - cursor_ : 0;
+    }
+
+    [[nodiscard]] std::uint64_t read() const noexcept { return read_; }
+    [[nodiscard]] std::uint64_t lost() const noexcept { return lost_; }
+    [[nodiscard]] std::uint64_t laps() const noexcept { return laps_; }   // Times lost() grew
+
+private:
+    void seek(BusStart start) noexcept {
+        const std::uint64_t head = segment_->head.load(std::memory_order_acquire);
+        if (start == BusStart::LATEST) {
+            cursor_ = head;
+        } else {
+            cursor_ = head > ExecReportBusSegment::RING_SIZE ? head - ExecReportBusSegment::RING_SIZE : 0;
+        }
+    }
+
+    void close_segment() {
+        #ifdef __linux__
+        if (owned_ && segment_) detail::unmap_segment(const_cast<ExecReportBusSegment*>(segment_));
+        #endif
+        segment_ = nullptr;
+        owned_ = false;
+    }
+
+    std::string shm_name_;
+    BusStart start_;
+    const ExecReportBusSegment* segment_ = nullptr;
+    bool owned_ = false;                // Mapped by connect() (not an in-process bus)
+    std::uint64_t cursor_ = 0;
+    std::uint64_t read_ = 0;
+    std::uint64_t lost_ = 0;
+    std::uint64_t laps_ = 0;
+};
+
+} // namespace hft
@@ -0,0 +1,516 @@
+/**
+ * @file feed_recovery.hpp
+ * @brief Sequence tracking, gap detection and retransmit recovery for
+ *        the UDP multicast market data feed
+ *
+ * Multicast is lossy and may reorder. Each stream (one multicast group /
+ * publisher) gets a FeedSequencer that:
+ * - Delivers packets strictly in sequence order
+ * - Holds early packets in a fixed reorder window (no allocation)
+ * - Requests a retransmit of the missing range once the gap outlives
+ *   the reorder tolerance
+ * - Skips the gap (counting the loss) if recovery times out or the
+ *   window overflows, so the stream never stalls
+ *
+ * The recovery channel is plain UDP unicast: the publisher keeps recent
+ * packets in a RetransmitServer ring and replays requested ranges with
+ * MD_FLAG_RETRANSMIT set; RetransmitClient sends the requests.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#include "udp_multicast.hpp"
+
+namespace hft {
+
+/**
+ * @brief MarketDataPacket::flags bits
+ */
+inline constexpr std::uint32_t MD_FLAG_RETRANSMIT = 1u << 0;
+
+/**
+ * @brief Gap / recovery counters for one stream (snapshot)
+ */
+struct FeedSequenceStats {
+    std::uint64_t delivered = 0;            // Packets handed on in order
+    std::uint64_t gaps_detected = 0;        // Distinct gaps opened
+    std::uint64_t packets_reordered = 0;    // Arrived late, filled from the window
+    std::uint64_t packets_recovered = 0;    // Filled by a retransmit
+    std::uint64_t packets_lost = 0;         // Given up on (timeout / overflow)
+    std::uint64_t duplicates = 0;           // Already delivered or buffered
+    std::uint64_t recovery_requests = 0;    // Retransmit requests issued
+};
+
+/**
+ * @brief What happened to a packet passed to FeedSequencer::on_packet
+ */
+enum class SequenceResult : std::uint8_t {
+    DELIVERED,      // In sequence (plus any buffered successors)
+    BUFFERED,       // Ahead of sequence, held in the reorder window
+    DUPLICATE,      // Already seen; dropped
+    GAP_SKIPPED     // Window overflow: gap abandoned, packet delivered
+};
+
+/**
+ * @brief Per-stream sequencer with a fixed reorder window
+ *
+ * @tparam WindowSize Max packets held ahead of the next expected sequence
+ *
+ * Single-threaded: call everything from the receive thread. Counters are
+ * relaxed atomics so stats() may be read from any thread. Sequence 0 is
+ * reserved; publishers start at 1.
+ */
+template<std::size_t WindowSize = 256>
+class FeedSequencer {
+    static_assert(WindowSize > 0 && (WindowSize & (WindowSize - 1)) == 0,
+                  "WindowSize must be a power of 2");
+    static constexpr std::size_t MASK = WindowSize - 1;
+
+public:
+    using Clock = std::chrono::steady_clock;
+    /// Asked to retransmit [first, last]; return false if it could not be sent
+    using RecoveryFn = std::function<bool(std::uint64_t first, std::uint64_t last)>;
+
+    struct Config {
+        std::size_t reorder_tolerance = 8;      // Packets past a hole before recovery
+        std::chrono::microseconds recovery_timeout{5000};
+    };
+
+    explicit FeedSequencer(RecoveryFn recovery = nullptr, const Config& config = Config())
+        : recovery_(std::move(recovery))
+        , config_(config)
+    {
+        slot_seq_.fill(0);
+    }
+
+    /**
+     * @brief Feed one packet (multicast or retransmit)
+     *
+     * @param deliver Called with each packet that becomes in-sequence
+     */
+    template<typename Deliver>
+    SequenceResult on_packet(const MarketDataPacket& packet, Deliver&& deliver) {
+        const std::uint64_t seq = packet.sequence;
+        if (next_seq_ == 0) {
+            next_seq_ = seq;    // First packet defines the stream start
+        }
+
+        if (seq < next_seq_) {
+            bump(duplicates_);
+            return SequenceResult::DUPLICATE;
+        }
+
+        if (seq == next_seq_) {
+            count_fill(packet);
+            deliver_one(packet, deliver);
+            drain(deliver);
+            if (gap_open() && highest_buffered_ - next_seq_ >= config_.reorder_tolerance) {
+                request_recovery();     // Next hole is already overdue
+            }
+            return SequenceResult::DELIVERED;
+        }
+
+        if (seq - next_seq_ >= WindowSize) {
+            // Cannot hold it: abandon everything up to seq, keep what we have
+            if (!gap_open()) bump(gaps_detected_);
+            skip_to(seq, deliver);
+            count_fill(packet);
+            deliver_one(packet, deliver);
+            drain(deliver);
+            return SequenceResult::GAP_SKIPPED;
+        }
+
+        const std::size_t slot = seq & MASK;
+        if (slot_seq_[slot] == seq) {
+            bump(duplicates_);
+            return SequenceResult::DUPLICATE;
+        }
+        if (highest_buffered_ < next_seq_) {
+            bump(gaps_detected_);
+            gap_opened_ = Clock::now();
+        }
+        window_[slot] = packet;
+        slot_seq_[slot] = seq;
+        ++buffered_;
+        highest_buffered_ = std::max(highest_buffered_, seq);
+
+        if (highest_buffered_ - next_seq_ >= config_.reorder_tolerance) {
+            request_recovery();
+        }
+        return SequenceResult::BUFFERED;
+    }
+
+    /**
+     * @brief Give up on a gap whose recovery has timed out
+     *
+     * Call periodically (e.g. when the socket is idle).
+     * @return true if a gap was skipped
+     */
+    template<typename Deliver>
+    bool poll_timeout(Deliver&& deliver, Clock::time_point now = Clock::now()) {
+        if (!gap_open()) return false;
+
+        if (requested_up_to_ < next_seq_) {
+            // Pure reordering so far; escalate to recovery once it lingers
+            if (now - gap_opened_ >= config_.recovery_timeout) {
+                request_recovery();
+            }
+            return false;
+        }
+        if (now - recovery_sent_ < config_.recovery_timeout) return false;
+
+        skip_to(first_buffered(), deliver);
+        drain(deliver);
+        gap_opened_ = now;      // Any remaining hole starts its own clock
+        return true;
+    }
+
+    [[nodiscard]] bool gap_open() const noexcept { return highest_buffered_ >= next_seq_; }
+    [[nodiscard]] std::uint64_t next_sequence() const noexcept { return next_seq_; }
+    [[nodiscard]] std::size_t buffered() const noexcept { return buffered_; }
+
+    [[nodiscard]] FeedSequenceStats stats() const noexcept {
+        FeedSequenceStats s;
+        s.delivered = delivered_.load(std::memory_order_relaxed);
+        s.gaps_detected = gaps_detected_.load(std::memory_order_relaxed);
+        s.packets_reordered = reordered_.load(std::memory_order_relaxed);
+        s.packets_recovered = recovered_.load(std::memory_order_relaxed);
+        s.packets_lost = lost_.load(std::memory_order_relaxed);
+        s.duplicates = duplicates_.load(std::memory_order_relaxed);
+        s.recovery_requests = recovery_requests_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n = 1) noexcept {
+        // Single writer: a plain load/store avoids a locked RMW
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Classify a packet that fills a hole (or is simply next)
+     */
+    void count_fill(const MarketDataPacket& packet) noexcept {
+        if (!gap_open() && packet.sequence == next_seq_) return;
+        if (packet.flags & MD_FLAG_RETRANSMIT) {
+            bump(recovered_);
+        } else {
+            bump(reordered_);
+        }
+    }
+
+    template<typename Deliver>
+    void deliver_one(const MarketDataPacket& packet, Deliver& deliver) {
+        deliver(packet);
+        bump(delivered_);
+        ++next_seq_;
+    }
+
+    /**
+     * @brief Deliver buffered packets that are now in sequence
+     */
+    template<typename Deliver>
+    void drain(Deliver& deliver) {
+        while (gap_open()) {
+            const std::size_t slot = next_seq_ & MASK;
+            if (slot_seq_[slot] != next_seq_) return;
+            slot_seq_[slot] = 0;
+            --buffered_;
+            deliver_one(window_[slot], deliver);
+        }
+    }
+
+    /**
+     * @brief Abandon sequences before target, delivering buffered ones in order
+     */
+    template<typename Deliver>
+    void skip_to(std::uint64_t target, Deliver& deliver) {
+        while (next_seq_ < target) {
+            const std::size_t slot = next_seq_ & MASK;
+            if (gap_open() && slot_seq_[slot] == next_seq_) {
+                slot_seq_[slot] = 0;
+                --buffered_;
+                deliver_one(window_[slot], deliver);
+            } else if (!gap_open()) {
+                bump(lost_, target - next_seq_);
+                next_seq_ = target;
+            } else {
+                bump(lost_);
+                ++next_seq_;
+            }
+        }
+    }
+
+    [[nodiscard]] std::uint64_t first_buffered() const noexcept {
+        for (std::uint64_t s = next_seq_; s <= highest_buffered_; ++s) {
+            if (slot_seq_[s & MASK] == s) return s;
+        }
+        return highest_buffered_ + 1;
+    }
+
+    void request_recovery() {
+        const std::uint64_t last = first_buffered() - 1;
+        if (last < next_seq_ || last <= requested_up_to_) return;
+
+        requested_up_to_ = last;
+        recovery_sent_ = Clock::now();
+        if (recovery_ && recovery_(next_seq_, last)) {
+            bump(recovery_requests_);
+        }
+    }
+
+    RecoveryFn recovery_;
+    Config config_;
+
+    std::uint64_t next_seq_ = 0;            // 0 = no packet seen yet
+    std::uint64_t highest_buffered_ = 0;
+    std::uint64_t requested_up_to_ = 0;
+    std::size_t buffered_ = 0;
+    Clock::time_point gap_opened_{};
+    Clock::time_point recovery_sent_{};
+
+    std::array<MarketDataPacket, WindowSize> window_;
+    std::array<std::uint64_t, WindowSize> slot_seq_;    // Sequence held per slot, 0 = empty
+
+    std::atomic<std::uint64_t> delivered_{0};
+    std::atomic<std::uint64_t> gaps_detected_{0};
+    std::atomic<std::uint64_t> reordered_{0};
+    std::atomic<std::uint64_t> recovered_{0};
+    std::atomic<std::uint64_t> lost_{0};
+    std::atomic<std::uint64_t> duplicates_{0};
+    std::atomic<std::uint64_t> recovery_requests_{0};
+};
+
+/**
+ * @brief Wire format of a retransmit request
+ */
+struct RetransmitRequest {
+    static constexpr std::uint32_t MAGIC = 0x52545852;  // "RTXR"
+    static constexpr std::uint32_t MAX_COUNT = 1024;    // Packets per request
+
+    std::uint32_t magic = MAGIC;
+    std::uint32_t count = 0;
+    std::uint64_t first_sequence = 0;
+};
+
+/**
+ * @brief Publisher-side retransmit service
+ *
+ * Keeps the last HistorySize published packets and replays requested
+ * ranges by unicast. Sequences that have aged out of the ring are not
+ * answered; the requester's recovery timeout then skips them.
+ *
+ * @tparam HistorySize Packets retained (power of 2)
+ */
+template<std::size_t HistorySize = 65536>
+class RetransmitServer {
+    static_assert((HistorySize & (HistorySize - 1)) == 0, "HistorySize must be a power of 2");
+
+public:
+    explicit RetransmitServer(uint16_t port) : port_(port), socket_fd_(-1) {
+        history_ = std::make_unique<std::array<MarketDataPacket, HistorySize>>();
+        for (auto& packet : *history_) packet.sequence = 0;
+    }
+
+    ~RetransmitServer() {
+        close_socket();
+    }
+
+    RetransmitServer(const RetransmitServer&) = delete;
+    RetransmitServer& operator=(const RetransmitServer&) = delete;
+
+    bool init() {
+        #ifdef __linux__
+        socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (socket_fd_ < 0) return false;
+
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port_);
+        addr.sin_addr.s_addr = INADDR_ANY;
+        if (bind(socket_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close_socket();
+            return false;
+        }
+
+        int flags = fcntl(socket_fd_, F_GETFL, 0);
+        fcntl(socket_fd_, F_SETFL, flags | O_NONBLOCK);
+        return true;
+        #else
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief Remember a packet just published on multicast
+     */
+    void record(const MarketDataPacket& packet) noexcept {
+        (*history_)[packet.sequence & (HistorySize - 1)] = packet;
+    }
+
+    /**
+     * @brief Serve pending requests (non-blocking)
+     * @return Number of packets retransmitted
+     */
+    std::size_t poll() {
+        #ifdef __linux__
+        if (socket_fd_ < 0) return 0;
+
+        std::size_t replayed = 0;
+        RetransmitRequest request;
+        sockaddr_in from;
+        socklen_t from_len = sizeof(from);
+        while (recvfrom(socket_fd_, &request, sizeof(request), MSG_DONTWAIT,
+                        reinterpret_cast<sockaddr*>(&from), &from_len) == sizeof(request)) {
+            if (request.magic == RetransmitRequest::MAGIC) {
+                replayed += replay(request, from);
+                ++requests_served_;
+            }
+            from_len = sizeof(from);
+        }
+        return replayed;
+        #else
+        return 0;
+        #endif
+    }
+
+    [[nodiscard]] std::uint64_t requests_served() const noexcept { return requests_served_; }
+
+    void close_socket() {
+        #ifdef __linux__
+        if (socket_fd_ >= 0) {
+            close(socket_fd_);
+            socket_fd_ = -1;
+        }
+        #endif
+    }
+
+private:
+    #ifdef __linux__
+    std::size_t replay(const RetransmitRequest& request, const sockaddr_in& to) {
+        const std::uint32_t count = std::min(request.count, RetransmitRequest::MAX_COUNT);
+        std::size_t sent = 0;
+        for (std::uint64_t seq = request.first_sequence; seq < request.first_sequence + count; ++seq) {
+            MarketDataPacket packet = (*history_)[seq & (HistorySize - 1)];
+            if (packet.sequence != seq) continue;   // Aged out
+            packet.flags |= MD_FLAG_RETRANSMIT;
+            if (sendto(socket_fd_, &packet, sizeof(packet), 0,
+                       reinterpret_cast<const sockaddr*>(&to), sizeof(to)) == sizeof(packet)) {
+                ++sent;
+            }
+        }
+        return sent;
+    }
+    #endif
+
+    uint16_t port_;
+    int socket_fd_;
+    std::unique_ptr<std::array<MarketDataPacket, HistorySize>> history_;
+    std::uint64_t requests_served_ = 0;
+};
+
+/**
+ * @brief Subscriber-side retransmit channel
+ *
+ * request() fits FeedSequencer::RecoveryFn; retransmitted packets are
+ * read with try_receive() and fed back into the same sequencer.
+ */
+class RetransmitClient {
+public:
+    RetransmitClient(const std::string& server_ip, uint16_t server_port)
+        : server_ip_(server_ip), server_port_(server_port), socket_fd_(-1) {}
+
+    ~RetransmitClient() {
+        close_socket();
+    }
+
+    RetransmitClient(const RetransmitClient&) = delete;
+    RetransmitClient& operator=(const RetransmitClient&) = delete;
+
+    bool init() {
+        #ifdef __linux__
+        socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (socket_fd_ < 0) return false;
+
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(server_port_);
+        if (inet_pton(AF_INET, server_ip_.c_str(), &addr.sin_addr) != 1 ||
+            ::connect(socket_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close_socket();
+            return false;
+        }
+
+        int flags = fcntl(socket_fd_, F_GETFL, 0);
+        fcntl(socket_fd_, F_SETFL, flags | O_NONBLOCK);
+        return true;
+        #else
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief Ask for sequences [first, last]
+     */
+    bool request(std::uint64_t first, std::uint64_t last) {
+        #ifdef __linux__
+        if (socket_fd_ < 0 || last < first) return false;
+
+        RetransmitRequest req;
+        req.first_sequence = first;
+        req.count = static_cast<std::uint32_t>(
+            std::min<std::uint64_t>(last - first + 1, RetransmitRequest::MAX_COUNT));
+        return ::send(socket_fd_, &req, sizeof(req), 0) == sizeof(req);
+        #else
+        (void)first;
+        (void)last;
+        return false;
+        #endif
+    }
+
+    bool try_receive(MarketDataPacket& packet) {
+        #ifdef __linux__
+        if (socket_fd_ < 0) return false;
+        return recv(socket_fd_, &packet, sizeof(packet), MSG_DONTWAIT) == sizeof(packet);
+        #else
+        (void)packet;
+        return false;
+        #endif
+    }
+
+    void close_socket() {
+        #ifdef __linux__
+        if (socket_fd_ >= 0) {
+            close(socket_fd_);
+            socket_fd_ = -1;
+        }
+        #endif
+    }
+
+private:
+    std::string server_ip_;
+    uint16_t server_port_;
+    int socket_fd_;
+};
+
+} // namespace hft
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <string>
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <functional>
@@ -16,6 +17,8 @@
 #include <thread>
 #include <queue>
 #include <mutex>
+#include <span>
+#include <unordered_map>
 
 #ifdef __linux__
 #include <sys/socket.h>
@@ -25,54 +28,71 @@
 #include <poll.h>
 #endif
 
+#include "core/reactor.hpp"
 #include "core/types.hpp"
 #include "strategy/user_strategy.hpp"
+#include "order_packets.hpp"
 
 namespace hft {
 
 /**
- * @brief Wire format for order messages over IPC
+ * @brief Reassembles fixed-size packets from stream reads
  */
-struct alignas(64) OrderPacket {
-    uint64_t client_order_id;
-    int64_t timestamp;
-    char symbol[16];
-    int64_t price;
-    int64_t quantity;
-    uint8_t side;       // 0=BUY, 1=SELL
-    uint8_t order_type; // 0=MARKET, 1=LIMIT
-    uint8_t action;     // 0=NEW, 1=CANCEL, 2=MODIFY
-    uint8_t padding[5];
-    uint32_t checksum;
-};
+template<typename Packet>
+class PacketReassembler {
+public:
+    /**
+     * @brief Feed received bytes, calling on_packet for each complete packet
+     */
+    template<typename OnPacket>
+    void feed(std::span<const char> data, OnPacket&& on_packet) {
+        Packet packet;
+        while (!data.empty()) {
+            if (filled_ == 0 && data.size() >= sizeof(packet)) {
+                std::memcpy(&packet, data.data(), sizeof(packet));
+                data = data.subspan(sizeof(packet));
+                on_packet(packet);
+                continue;
+            }
+            
+            const std::size_t n = std::min(sizeof(packet) - filled_, data.size());
+            std::memcpy(bytes_ + filled_, data.data(), n);
+            filled_ += n;
+            data = data.subspan(n);
+            if (filled_ == sizeof(packet)) {
+                filled_ = 0;
+                std::memcpy(&packet, bytes_, sizeof(packet));
+                on_packet(packet);
+            }
+        }
+    }
 
-/**
- * @brief Wire format for order response messages
- */
-struct alignas(64) OrderResponsePacket {
-    uint64_t client_order_id;
-    uint64_t exchange_order_id;
-    int64_t timestamp;
-    int64_t fill_price;
-    int64_t fill_quantity;
-    int64_t leaves_quantity;
-    uint8_t status;     // 0=NEW, 1=PARTIAL, 2=FILLED, 3=CANCELLED, 4=REJECTED
-    uint8_t padding[7];
-    uint32_t checksum;
+    void reset() noexcept { filled_ = 0; }
+
+private:
+    std::size_t filled_ = 0;
+    alignas(Packet) char bytes_[sizeof(Packet)];
 };
 
 /**
  * @brief IPC Socket Server (Exchange Simulator side)
+ *
+ * All clients are served from one thread through a Reactor; packets are
+ * reassembled across stream reads. start() runs a private reactor on its
+ * own thread; attach() instead serves from a reactor the caller polls,
+ * so the callback runs on the caller's thread.
  */
 class IPCSocketServer {
 public:
     using OrderCallback = std::function<void(const OrderPacket&, int client_fd)>;
+    using DisconnectCallback = std::function<void(int client_fd)>;
     
-    explicit IPCSocketServer(const std::string& socket_path)
-        : socket_path_(socket_path), server_fd_(-1), running_(false) {}
+    explicit IPCSocketServer(const std::string& socket_path, PollMode mode = PollMode::RELAXED)
+        : socket_path_(socket_path), mode_(mode), server_fd_(-1), running_(false) {}
     
     ~IPCSocketServer() {
         stop();
+        detach();
         close_socket();
     }
     
@@ -109,6 +129,11 @@ public:
         #endif
     }
     
+    /**
+     * @brief Listening socket after init() (-1 before), for callers that accept themselves
+     */
+    [[nodiscard]] int listen_fd() const noexcept { return server_fd_; }
+    
     void start(OrderCallback callback) {
         running_ = true;
         server_thread_ = std::thread([this, callback]() {
@@ -123,6 +148,48 @@ public:
         }
     }
     
+    /**
+     * @brief Serve clients from an external reactor (instead of start())
+     */
+    bool attach(Reactor& reactor, OrderCallback callback) {
+        #ifdef __linux__
+        if (reactor_ || server_fd_ < 0) return false;
+        callback_ = std::move(callback);
+        if (!reactor.listen(server_fd_, [this](int client_fd) { accept_client(client_fd); })) {
+            return false;
+        }
+        reactor_ = &reactor;
+        return true;
+        #else
+        (void)reactor;
+        (void)callback;
+        return false;
+        #endif
+    }
+    
+    /**
+     * @brief Close all clients and unregister from the reactor
+     */
+    void detach() {
+        #ifdef __linux__
+        if (!reactor_) return;
+        for (const auto& [fd, partial] : clients_) {
+            reactor_->remove(fd);
+            close(fd);
+        }
+        clients_.clear();
+        reactor_->remove(server_fd_);
+        reactor_ = nullptr;
+        #endif
+    }
+    
+    /**
+     * @brief Called after a client disconnects (its fd is already closed)
+     */
+    void set_disconnect_callback(DisconnectCallback callback) {
+        on_disconnect_ = std::move(callback);
+    }
+    
     bool send_response(int client_fd, const OrderResponsePacket& response) {
         #ifdef __linux__
         ssize_t sent = send(client_fd, &response, sizeof(response), MSG_NOSIGNAL);
@@ -135,47 +202,51 @@ public:
     }
 
 private:
+    void accept_client(int client_fd) {
+        #ifdef __linux__
+        clients_[client_fd];
+        if (!reactor_->receive(client_fd, [this](int fd, std::span<const char> data) {
+                on_data(fd, data);
+            })) {
+            clients_.erase(client_fd);
+            close(client_fd);
+        }
+        #else
+        (void)client_fd;
+        #endif
+    }
+    
+    void on_data(int fd, std::span<const char> data) {
+        #ifdef __linux__
+        if (data.empty()) {
+            // Client disconnected
+            reactor_->remove(fd);
+            close(fd);
+            clients_.erase(fd);
+            if (on_disconnect_) on_disconnect_(fd);
+            return;
+        }
+        
+        auto it = clients_.find(fd);
+        if (it == clients_.end()) return;
+        it->second.feed(data, [&](const OrderPacket& packet) { callback_(packet, fd); });
+        #else
+        (void)fd;
+        (void)data;
+        #endif
+    }
+    
     void run_loop(OrderCallback callback) {
         #ifdef __linux__
-        std::vector<pollfd> fds;
-        fds.push_back({server_fd_, POLLIN, 0});
+        ReactorConfig config;
+        config.mode = mode_;
+        Reactor reactor(config);
+        if (!reactor.init() || !attach(reactor, std::move(callback))) return;
         
-        while (running_) {
-            int ret = poll(fds.data(), fds.size(), 10);  // 10ms timeout
-            if (ret <= 0) continue;
-            
-            // Check for new connections
-            if (fds[0].revents & POLLIN) {
-                int client_fd = accept(server_fd_, nullptr, nullptr);
-                if (client_fd >= 0) {
-                    int flags = fcntl(client_fd, F_GETFL, 0);
-                    fcntl(client_fd, F_SETFL, flags | O_NONBLOCK);
-                    fds.push_back({client_fd, POLLIN, 0});
-                }
-            }
-            
-            // Check client sockets
-            for (size_t i = 1; i < fds.size(); ) {
-                if (fds[i].revents & POLLIN) {
-                    OrderPacket packet;
-                    ssize_t received = recv(fds[i].fd, &packet, sizeof(packet), 0);
-                    if (received == sizeof(packet)) {
-                        callback(packet, fds[i].fd);
-                    } else if (received <= 0) {
-                        // Client disconnected
-                        close(fds[i].fd);
-                        fds.erase(fds.begin() + i);
-                        continue;
-                    }
-                }
-                ++i;
-            }
-        }
+        reactor.run(running_);
         
         // Close all client connections
-        for (size_t i = 1; i < fds.size(); ++i) {
-            close(fds[i].fd);
-        }
+        detach();
         #else
         (void)callback;
         #endif
@@ -192,9 +263,14 @@ private:
     }
 
     std::string socket_path_;
+    PollMode mode_;
     int server_fd_;
     std::atomic<bool> running_;
     std::thread server_thread_;
+    Reactor* reactor_ = nullptr;
+    OrderCallback callback_;
+    DisconnectCallback on_disconnect_;
+    std::unordered_map<int, PacketReassembler<OrderPacket>> clients_;
 };
 
 /**
@@ -0,0 +1,46 @@
+/**
+ * @file order_packets.hpp
+ * @brief Fixed-size order wire formats shared by the IPC transports
+ * 
+ * Used unchanged by the Unix socket transport (ipc_socket.hpp) and the
+ * shared-memory ring transport (shm_transport.hpp).
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace hft {
+
+/**
+ * @brief Wire format for order messages over IPC
+ */
+struct alignas(64) OrderPacket {
+    uint64_t client_order_id;
+    int64_t timestamp;
+    char symbol[16];
+    int64_t price;
+    int64_t quantity;
+    uint8_t side;       // 0=BUY, 1=SELL
+    uint8_t order_type; // 0=MARKET, 1=LIMIT
+    uint8_t action;     // 0=NEW, 1=CANCEL, 2=MODIFY
+    uint8_t padding[5];
+    uint32_t checksum;
+};
+
+/**
+ * @brief Wire format for order response messages
+ */
+struct alignas(64) OrderResponsePacket {
+    uint64_t client_order_id;
+    uint64_t exchange_order_id;
+    int64_t timestamp;
+    int64_t fill_price;
+    int64_t fill_quantity;
+    int64_t leaves_quantity;
+    uint8_t status;     // 0=NEW, 1=PARTIAL, 2=FILLED, 3=CANCELLED, 4=REJECTED
+    uint8_t padding[7];
+    uint32_t checksum;
+};
+
+} // namespace hft
@@ -0,0 +1,427 @@
+/**
+ * @file shard_router.hpp
+ * @brief Gateway fan-out of client order sessions to matching engine shards
+ *
+ * Each matching engine process (shard) owns a disjoint set of symbols and
+ * serves OrderPackets on its own Unix socket (matching_engine --ipc). The
+ * router keeps one connection per shard and multiplexes any number of
+ * client sessions over them:
+ *
+ *   session A ──┐                 ┌──> shard 0 (BTC-USD, ETH-USD)
+ *   session B ──┼──> symbol map ──┤
+ *   session C ──┘                 └──> shard 1 (SOL-USD, ...)
+ *
+ * - A shard answers every packet with exactly one OrderResponsePacket, in
+ *   the order it received them, so each shard connection keeps a FIFO of
+ *   in-flight (session, sequence) pairs and needs no lookup table.
+ * - Shards answer independently, so a session's responses can come back
+ *   out of order. Each session has a fixed reorder window indexed by its
+ *   sequence number and releases responses strictly in submission order.
+ * - Client order ids are only unique per session, so the id sent to a
+ *   shard is (session << SESSION_SHIFT) | low bits of the client's id; a
+ *   cancel maps to the same shard id as the order it names. The client's
+ *   own id is restored on the way back.
+ *
+ * Single-threaded: submit(), the response callback and the reactor that
+ * drives the shard sockets all run on one thread.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#include "core/reactor.hpp"
+#include "core/types.hpp"
+#include "ipc_socket.hpp"
+#include "order_packets.hpp"
+
+namespace hft {
+
+using SessionId = std::uint32_t;
+
+enum class RouteResult : std::uint8_t {
+    ROUTED,             // Sent to its shard
+    REJECTED,           // Answered locally (unknown symbol / shard down)
+    WINDOW_FULL,        // Too many responses outstanding for the session
+    INVALID_SESSION
+};
+
+/**
+ * @brief Symbol-partitioned order router with per-session ordering
+ */
+class ShardedOrderRouter {
+public:
+    static constexpr std::size_t SESSION_WINDOW = 1024;    // Power of two
+    static constexpr int SESSION_SHIFT = 40;
+    static constexpr std::uint64_t CLIENT_ID_MASK = (std::uint64_t{1} << SESSION_SHIFT) - 1;
+    static constexpr std::uint8_t STATUS_REJECTED = 4;
+
+    static_assert((SESSION_WINDOW & (SESSION_WINDOW - 1)) == 0, "Window must be a power of 2");
+
+    using ResponseCallback = std::function<void(SessionId, const OrderResponsePacket&)>;
+
+    struct Stats {
+        std::uint64_t routed = 0;
+        std::uint64_t rejected = 0;
+        std::uint64_t responses = 0;
+        std::uint64_t unexpected = 0;   // Responses with no order in flight
+    };
+
+    explicit ShardedOrderRouter(ResponseCallback callback) : callback_(std::move(callback)) {}
+
+    ~ShardedOrderRouter() {
+        for (std::size_t i = 0; i < shards_.size(); ++i) {
+            drop_shard(i, false);
+        }
+    }
+
+    // Non-copyable
+    ShardedOrderRouter(const ShardedOrderRouter&) = delete;
+    ShardedOrderRouter& operator=(const ShardedOrderRouter&) = delete;
+
+    /**
+     * @brief Register an engine shard by socket path
+     * @return Shard index
+     */
+    std::size_t add_shard(std::string socket_path) {
+        shards_.push_back(Shard{});
+        shards_.back().path = std::move(socket_path);
+        return shards_.size() - 1;
+    }
+
+    /**
+     * @brief Route symbol to shard
+     */
+    bool assign(const Symbol& symbol, std::size_t shard) {
+        if (shard >= shards_.size()) return false;
+        symbols_[symbol] = static_cast<std::uint32_t>(shard);
+        return true;
+    }
+
+    /**
+     * @brief Connect to every shard and serve their responses from reactor
+     * @return false if any shard could not be reached
+     */
+    bool connect(Reactor& reactor) {
+        #ifdef __linux__
+        reactor_ = &reactor;
+        bool all = true;
+        for (std::size_t i = 0; i < shards_.size(); ++i) {
+            all = connect_shard(i) && all;
+        }
+        return all;
+        #else
+        (void)reactor;
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief Close every shard connection; orders in flight are rejected
+     */
+    void disconnect() {
+        for (std::size_t i = 0; i < shards_.size(); ++i) {
+            drop_shard(i);
+        }
+    }
+
+    /**
+     * @brief Start a client session
+     */
+    SessionId open_session() {
+        SessionId id;
+        if (!free_sessions_.empty()) {
+            id = free_sessions_.back();
+            free_sessions_.pop_back();
+        } else {
+            id = static_cast<SessionId>(sessions_.size());
+            sessions_.emplace_back();
+            sessions_.back().window.resize(SESSION_WINDOW);
+        }
+        Session& session = sessions_[id];
+        session.open = true;
+        session.next_seq = 0;
+        session.deliver_seq = 0;
+        return id;
+    }
+
+    /**
+     * @brief End a session; responses still in flight are discarded
+     */
+    void close_session(SessionId id) {
+        if (id >= sessions_.size() || !sessions_[id].open) return;
+        sessions_[id].open = false;
+        release_if_idle(id);
+    }
+
+    /**
+     * @brief Route an order (or cancel) from a session to its symbol's shard
+     */
+    RouteResult submit(SessionId id, const OrderPacket& packet) {
+        if (id >= sessions_.size() || !sessions_[id].open) return RouteResult::INVALID_SESSION;
+        Session& session = sessions_[id];
+        if (session.next_seq - session.deliver_seq >= SESSION_WINDOW) {
+            return RouteResult::WINDOW_FULL;
+        }
+        const std::uint64_t seq = session.next_seq++;
+
+        Symbol symbol{};
+        std::memcpy(symbol.data(), packet.symbol, std::min(sizeof(packet.symbol), symbol.size()));
+        auto it = symbols_.find(symbol);
+        if (it == symbols_.end() || shards_[it->second].fd < 0) {
+            ++stats_.rejected;
+            deliver(id, seq, rejection(packet));
+            return RouteResult::REJECTED;
+        }
+
+        Shard& shard = shards_[it->second];
+        OrderPacket routed = packet;
+        routed.client_order_id = shard_order_id(id, packet.client_order_id);
+        shard.in_flight.push_back({id, seq, packet.client_order_id});
+        shard.out.append(reinterpret_cast<const char*>(&routed), sizeof(routed));
+        ++stats_.routed;
+        flush(shard);
+        return RouteResult::ROUTED;
+    }
+
+    /**
+     * @brief Answer an order locally (e.g. rate limited) in session order
+     */
+    RouteResult reject(SessionId id, const OrderPacket& packet) {
+        if (id >= sessions_.size() || !sessions_[id].open) return RouteResult::INVALID_SESSION;
+        Session& session = sessions_[id];
+        if (session.next_seq - session.deliver_seq >= SESSION_WINDOW) {
+            return RouteResult::WINDOW_FULL;
+        }
+        ++stats_.rejected;
+        deliver(id, session.next_seq++, rejection(packet));
+        return RouteResult::REJECTED;
+    }
+
+    /**
+     * @brief Retry bytes a full socket buffer held back
+     */
+    void flush() {
+        for (auto& shard : shards_) {
+            flush(shard);
+        }
+    }
+
+    [[nodiscard]] std::size_t shard_count() const noexcept { return shards_.size(); }
+
+    [[nodiscard]] bool shard_connected(std::size_t shard) const noexcept {
+        return shard < shards_.size() && shards_[shard].fd >= 0;
+    }
+
+    [[nodiscard]] std::size_t in_flight(SessionId id) const noexcept {
+        if (id >= sessions_.size()) return 0;
+        return static_cast<std::size_t>(sessions_[id].next_seq - sessions_[id].deliver_seq);
+    }
+
+    [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+
+    /**
+     * @brief Id a shard sees for a session's client order id
+     */
+    [[nodiscard]] static constexpr std::uint64_t shard_order_id(SessionId session,
+                                                                std::uint64_t client_order_id) noexcept {
+        return (static_cast<std::uint64_t>(session) << SESSION_SHIFT) | (client_order_id & CLIENT_ID_MASK);
+    }
+
+private:
+    struct PendingResponse {
+        bool ready = false;
+        OrderResponsePacket response;
+    };
+
+    struct Session {
+        bool open = false;
+        std::uint64_t next_seq = 0;         // Sequence of the next order
+        std::uint64_t deliver_seq = 0;      // Sequence of the next response to release
+        std::vector<PendingResponse> window;
+    };
+
+    struct InFlight {
+        SessionId session;
+        std::uint64_t seq;
+        std::uint64_t client_order_id;
+    };
+
+    struct Shard {
+        std::string path;
+        int fd = -1;
+        std::deque<InFlight> in_flight;
+        std::string out;                    // Unsent packets
+        std::size_t out_sent = 0;
+        PacketReassembler<OrderResponsePacket> reassembler;
+    };
+
+    static OrderResponsePacket rejection(const OrderPacket& packet) {
+        OrderResponsePacket response{};
+        response.client_order_id = packet.client_order_id;
+        response.timestamp = now();
+        response.status = STATUS_REJECTED;
+        return response;
+    }
+
+    bool connect_shard(std::size_t index) {
+        #ifdef __linux__
+        Shard& shard = shards_[index];
+        if (shard.fd >= 0) return true;
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return false;
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, shard.path.c_str(), sizeof(addr.sun_path) - 1);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            ::close(fd);
+            return false;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        if (!reactor_->receive(fd, [this, index](int, std::span<const char> data) {
+                on_data(index, data);
+            })) {
+            ::close(fd);
+            return false;
+        }
+        shard.fd = fd;
+        shard.reassembler.reset();
+        return true;
+        #else
+        (void)index;
+        return false;
+        #endif
+    }
+
+    /**
+     * @brief Close a shard connection, rejecting everything it still owed
+     */
+    void drop_shard(std::size_t index, bool notify = true) {
+        Shard& shard = shards_[index];
+        #ifdef __linux__
+        if (shard.fd >= 0) {
+            if (reactor_) reactor_->remove(shard.fd);
+            ::close(shard.fd);
+        }
+        #endif
+        shard.fd = -1;
+        shard.out.clear();
+        shard.out_sent = 0;
+        if (!notify) {
+            shard.in_flight.clear();
+        }
+        while (!shard.in_flight.empty()) {
+            const InFlight pending = shard.in_flight.front();
+            shard.in_flight.pop_front();
+            OrderResponsePacket response{};
+            response.client_order_id = pending.client_order_id;
+            response.timestamp = now();
+            response.status = STATUS_REJECTED;
+            deliver(pending.session, pending.seq, response);
+        }
+    }
+
+    void on_data(std::size_t index, std::span<const char> data) {
+        if (data.empty()) {
+            drop_shard(index);     // Engine went away
+            return;
+        }
+        Shard& shard = shards_[index];
+        shard.reassembler.feed(data, [&](const OrderResponsePacket& packet) {
+            if (shard.in_flight.empty()) {
+                ++stats_.unexpected;
+                return;
+            }
+            const InFlight pending = shard.in_flight.front();
+            shard.in_flight.pop_front();
+            ++stats_.responses;
+
+            OrderResponsePacket response = packet;
+            response.client_order_id = pending.client_order_id;
+            deliver(pending.session, pending.seq, response);
+        });
+    }
+
+    /**
+     * @brief Park a response in its session window and release what is in order
+     */
+    void deliver(SessionId id, std::uint64_t seq, const OrderResponsePacket& response) {
+        Session& session = sessions_[id];
+        PendingResponse& slot = session.window[seq & (SESSION_WINDOW - 1)];
+        slot.response = response;
+        slot.ready = true;
+
+        while (session.deliver_seq < session.next_seq) {
+            PendingResponse& next = session.window[session.deliver_seq & (SESSION_WINDOW - 1)];
+            if (!next.ready) break;
+            next.ready = false;
+            ++session.deliver_seq;
+            if (session.open) {
+                callback_(id, next.response);
+            }
+        }
+        if (!session.open) {
+            release_if_idle(id);
+        }
+    }
+
+    void release_if_idle(SessionId id) {
+        Session& session = sessions_[id];
+        if (session.deliver_seq == session.next_seq && session.next_seq != UINT64_MAX) {
+            session.next_seq = UINT64_MAX;      // Marks the id as free
+            session.deliver_seq = UINT64_MAX;
+            free_sessions_.push_back(id);
+        }
+    }
+
+    void flush(Shard& shard) {
+        #ifdef __linux__
+        while (shard.fd >= 0 && shard.out_sent < shard.out.size()) {
+            ssize_t n = send(shard.fd, shard.out.data() + shard.out_sent,
+                             shard.out.size() - shard.out_sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                shard.out_sent += static_cast<std::size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return;     // Retried by the next submit() or flush()
+            } else {
+                drop_shard(static_cast<std::size_t>(&shard - shards_.data()));
+                return;
+            }
+        }
+        shard.out.clear();
+        shard.out_sent = 0;
+        #else
+        (void)shard;
+        #endif
+    }
+
+    ResponseCallback callback_;
+    Reactor* reactor_ = nullptr;
+    std::vector<Shard> shards_;
+    std::unordered_map<Symbol, std::uint32_t, SymbolHash> symbols_;
+    std::vector<Session> sessions_;
+    std::vector<SessionId> free_sessions_;
+    Stats stats_;
+};
+
+} // namespace hft
@@ -0,0 +1,340 @@
+/**
+ * @file shm_transport.hpp
+ * @brief Shared-memory ring transport for order routing
+ *
+ * Drop-in alternative to ipc_socket.hpp for processes on the same host.
+ * A POSIX shared memory segment (shm_open + mmap) holds, per client slot,
+ * a pair of SPSCQueue rings:
+ * - requests:  client -> server (OrderPacket)
+ * - responses: server -> client (OrderResponsePacket)
+ *
+ * Both sides busy-poll, so a hop is a cache-line handoff with no syscall.
+ * The callback API mirrors IPCSocketServer/IPCSocketClient, with the
+ * client slot index taking the place of the client socket fd.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "core/busy_poll.hpp"
+#include "core/lockfree_queue.hpp"
+#include "core/types.hpp"
+#include "order_packets.hpp"
+
+namespace hft {
+
+/**
+ * @brief Layout of the shared memory segment
+ *
+ * Constructed in place by the server. SPSCQueue keeps only indices and a
+ * flat buffer, so it is valid at any mapping address; each cached index is
+ * touched only by the side that owns it.
+ */
+struct ShmSegment {
+    static constexpr std::uint32_t MAGIC = 0x48465453;  // "HFTS"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t MAX_CLIENTS = 8;
+    static constexpr std::size_t RING_SIZE = 4096;
+
+    enum SlotState : std::uint32_t {
+        SLOT_FREE = 0,
+        SLOT_CONNECTED = 1,
+        SLOT_CLOSING = 2       // Client left; server resets the rings
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ClientSlot {
+        std::atomic<std::uint32_t> state{SLOT_FREE};
+        SPSCQueue<OrderPacket, RING_SIZE> requests;
+        SPSCQueue<OrderResponsePacket, RING_SIZE> responses;
+    };
+
+    std::uint32_t magic = MAGIC;
+    std::uint32_t version = VERSION;
+    std::atomic<std::uint32_t> ready{0};
+    ClientSlot slots[MAX_CLIENTS];
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free &&
+              std::atomic<std::size_t>::is_always_lock_free,
+              "Shared-memory rings need address-free atomics");
+
+namespace detail {
+
+#ifdef __linux__
+/**
+ * @brief Map a shared memory object sized for Segment; returns nullptr on failure
+ *
+ * read_only maps an existing object for a consumer that must not write it.
+ */
+template<typename Segment = ShmSegment>
+inline Segment* map_segment(const std::string& name, bool create, bool read_only = false) {
+    const int flags = create ? (O_CREAT | O_RDWR | O_TRUNC) : (read_only ? O_RDONLY : O_RDWR);
+    const int fd = shm_open(name.c_str(), flags, 0600);
+    if (fd < 0) return nullptr;
+
+    if (create && ftruncate(fd, sizeof(Segment)) != 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    const int prot = read_only && !create ? PROT_READ : PROT_READ | PROT_WRITE;
+    void* addr = mmap(nullptr, sizeof(Segment), prot, MAP_SHARED, fd, 0);
+    close(fd);
+    return addr == MAP_FAILED ? nullptr : static_cast<Segment*>(addr);
+}
+
+template<typename Segment>
+inline void unmap_segment(Segment* segment) {
+    if (segment) munmap(segment, sizeof(Segment));
+}
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Shared-memory transport server (Exchange / matching engine side)
+ */
+class ShmTransportServer {
+public:
+    using OrderCallback = std::function<void(const OrderPacket&, int client_id)>;
+
+    explicit ShmTransportServer(const std::string& shm_name, PollMode mode = PollMode::BALANCED)
+        : shm_name_(shm_name), mode_(mode), segment_(nullptr), running_(false) {}
+
+    ~ShmTransportServer() {
+        stop();
+        close_segment();
+    }
+
+    // Non-copyable
+    ShmTransportServer(const ShmTransportServer&) = delete;
+    ShmTransportServer& operator=(const ShmTransportServer&) = delete;
+
+    /**
+     * @brief Create the shared memory segment
+     */
+    bool init() {
+        #ifdef __linux__
+        shm_unlink(shm_name_.c_str());
+        segment_ = detail::map_segment(shm_name_, true);
+        if (!segment_) return false;
+
+        new (segment_) ShmSegment();
+        segment_->ready.store(1, std::memory_order_release);
+        return true;
+        #else
+        return false;
+        #endif
+    }
+
+    void start(OrderCallback callback) {
+        running_ = true;
+        server_thread_ = std::thread([this, callback]() {
+            run_loop(callback);
+        });
+    }
+
+    void stop() {
+        running_ = false;
+        if (server_thread_.joinable()) {
+            server_thread_.join();
+        }
+    }
+
+    /**
+     * @brief Queue a response to a client
+     *
+     * Must be called from the server thread (i.e. from the order callback):
+     * each response ring has a single producer.
+     * @return false if the client is unknown or its ring is full
+     */
+    bool send_response(int client_id, const OrderResponsePacket& response) {
+        if (!segment_ || client_id < 0 ||
+            static_cast<std::size_t>(client_id) >= ShmSegment::MAX_CLIENTS) {
+            return false;
+        }
+        auto& slot = segment_->slots[client_id];
+        if (slot.state.load(std::memory_order_acquire) != ShmSegment::SLOT_CONNECTED) {
+            return false;
+        }
+        return slot.responses.try_push(response);
+    }
+
+private:
+    void run_loop(const OrderCallback& callback) {
+        if (!segment_) return;
+
+        // Clients are other processes: no WakeSignal, PARK is a timed sleep
+        IdleStrategy idle(mode_);
+        while (running_.load(std::memory_order_relaxed)) {
+            std::size_t processed = 0;
+
+            for (std::size_t i = 0; i < ShmSegment::MAX_CLIENTS; ++i) {
+                auto& slot = segment_->slots[i];
+                const auto state = slot.state.load(std::memory_order_acquire);
+
+                if (state == ShmSegment::SLOT_CONNECTED) {
+                    const int client_id = static_cast<int>(i);
+                    processed += slot.requests.consume_all([&](const OrderPacket& packet) {
+                        callback(packet, client_id);
+                    });
+                } else if (state == ShmSegment::SLOT_CLOSING) {
+                    reset_slot(slot);
+                }
+            }
+
+            idle.idle(processed);
+        }
+    }
+
+    static void reset_slot(ShmSegment::ClientSlot& slot) {
+        slot.requests.~SPSCQueue();
+        slot.responses.~SPSCQueue();
+        new (&slot.requests) SPSCQueue<OrderPacket, ShmSegment::RING_SIZE>();
+        new (&slot.responses) SPSCQueue<OrderResponsePacket, ShmSegment::RING_SIZE>();
+        slot.state.store(ShmSegment::SLOT_FREE, std::memory_order_release);
+    }
+
+    void close_segment() {
+        #ifdef __linux__
+        if (segment_) {
+            detail::unmap_segment(segment_);
+            segment_ = nullptr;
+            shm_unlink(shm_name_.c_str());
+        }
+        #endif
+    }
+
+    std::string shm_name_;
+    PollMode mode_;
+    ShmSegment* segment_;
+    std::atomic<bool> running_;
+    std::thread server_thread_;
+};
+
+/**
+ * @brief Shared-memory transport client (Trading system / gateway side)
+ */
+class ShmTransportClient {
+public:
+    using ResponseCallback = std::function<void(const OrderResponsePacket&)>;
+
+    explicit ShmTransportClient(const std::string& shm_name, PollMode mode = PollMode::BALANCED)
+        : shm_name_(shm_name), mode_(mode), segment_(nullptr), slot_(nullptr), client_id_(-1), running_(false) {}
+
+    ~ShmTransportClient() {
+        stop();
+        close_segment();
+    }
+
+    // Non-copyable
+    ShmTransportClient(const ShmTransportClient&) = delete;
+    ShmTransportClient& operator=(const ShmTransportClient&) = delete;
+
+    /**
+     * @brief Map the server's segment and claim a free client slot
+     */
+    bool connect() {
+        #ifdef __linux__
+        segment_ = detail::map_segment(shm_name_, false);
+        if (!segment_) return false;
+
+        if (segment_->magic != ShmSegment::MAGIC ||
+            segment_->version != ShmSegment::VERSION ||
+            segment_->ready.load(std::memory_order_acquire) != 1) {
+            close_segment();
+            return false;
+        }
+
+        for (std::size_t i = 0; i < ShmSegment::MAX_CLIENTS; ++i) {
+            std::uint32_t expected = ShmSegment::SLOT_FREE;
+            if (segment_->slots[i].state.compare_exchange_strong(
+                    expected, ShmSegment::SLOT_CONNECTED, std::memory_order_acq_rel)) {
+                slot_ = &segment_->slots[i];
+                client_id_ = static_cast<int>(i);
+                return true;
+            }
+        }
+
+        close_segment();  // No free slots
+        return false;
+        #else
+        return false;
+        #endif
+    }
+
+    bool send_order(const OrderPacket& order) {
+        return slot_ && slot_->requests.try_push(order);
+    }
+
+    void start_receiver(ResponseCallback callback) {
+        running_ = true;
+        recv_thread_ = std::thread([this, callback]() {
+            IdleStrategy idle(mode_);
+            while (running_.load(std::memory_order_relaxed) && slot_) {
+                idle.idle(slot_->responses.consume_all(callback));
+            }
+        });
+    }
+
+    void stop() {
+        running_ = false;
+        if (recv_thread_.joinable()) {
+            recv_thread_.join();
+        }
+    }
+
+    // Busy-polling receive (for synchronous use)
+    bool receive_response(OrderResponsePacket& response, int timeout_ms = 1000) {
+        if (!slot_) return false;
+
+        std::optional<OrderResponsePacket> result;
+        const bool got = busy_poll_for([&] { return (result = slot_->responses.try_pop()).has_value(); },
+                                       std::chrono::milliseconds(timeout_ms));
+        if (got) response = *result;
+        return got;
+    }
+
+    [[nodiscard]] int client_id() const noexcept { return client_id_; }
+
+private:
+    void close_segment() {
+        #ifdef __linux__
+        if (slot_) {
+            slot_->state.store(ShmSegment::SLOT_CLOSING, std::memory_order_release);
+            slot_ = nullptr;
+            client_id_ = -1;
+        }
+        if (segment_) {
+            detail::unmap_segment(segment_);
+            segment_ = nullptr;
+        }
+        #endif
+    }
+
+    std::string shm_name_;
+    PollMode mode_;
+    ShmSegment* segment_;
+    ShmSegment::ClientSlot* slot_;
+    int client_id_;
+    std::atomic<bool> running_;
+    std::thread recv_thread_;
+};
+
+} // namespace hft
@@ -3,15 +3,29 @@
  * @brief UDP multicast transport for market data
  * 
  * Low-latency UDP multicast sender/receiver for external mode testing.
+ *
+ * Bursts are moved in batches to amortize syscall cost:
+ * - UDPMulticastSender::send_batch uses sendmmsg
+ * - UDPMulticastReceiver::try_receive_batch uses recvmmsg into a
+ *   preallocated packet array (also used by the receive thread)
+ * - Optional SO_TIMESTAMPING attaches a kernel (software) or NIC
+ *   (hardware) receive timestamp to each packet and records it in
+ *   TimestampBufferManager as EventType::PACKET_RX
+ * - Optional AF_XDP backend (enable_xdp(), -DHFT_ENABLE_AF_XDP=ON) that
+ *   bypasses the kernel UDP stack behind the same receive interface
  */
 
 #pragma once
 
 #include <string>
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <atomic>
+#include <memory>
+#include <span>
 #include <thread>
 
 #ifdef __linux__
@@ -20,8 +34,14 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
 #endif
 
+#include "af_xdp.hpp"
+#include "core/busy_poll.hpp"
+#include "core/cpu_affinity.hpp"
+#include "core/timestamp_buffer.hpp"
 #include "core/types.hpp"
 #include "strategy/user_strategy.hpp"
 
@@ -46,6 +66,20 @@ struct alignas(64) MarketDataPacket {
 
 static_assert(sizeof(MarketDataPacket) <= 128, "Packet too large");
 
+/**
+ * @brief Packets moved per sendmmsg / recvmmsg call
+ */
+inline constexpr std::size_t UDP_MAX_BATCH = 64;
+
+/**
+ * @brief Receive timestamp source for SO_TIMESTAMPING
+ */
+enum class RxTimestamping : std::uint8_t {
+    NONE,
+    SOFTWARE,   // Kernel stamps the packet on arrival (CLOCK_REALTIME)
+    HARDWARE    // NIC stamps the packet (PHC clock); needs driver support
+};
+
 /**
  * @brief UDP Multicast sender for market data
  */
@@ -93,6 +127,56 @@ public:
         #endif
     }
     
+    /**
+     * @brief Send one opaque datagram (e.g. an sbe:: binary message)
+     */
+    bool send_bytes(std::span<const char> bytes) {
+        #ifdef __linux__
+        if (socket_fd_ < 0) return false;
+        
+        ssize_t sent = sendto(socket_fd_, bytes.data(), bytes.size(), 0,
+                              reinterpret_cast<sockaddr*>(&dest_addr_),
+                              sizeof(dest_addr_));
+        return sent == static_cast<ssize_t>(bytes.size());
+        #else
+        (void)bytes;
+        return false;
+        #endif
+    }
+    
+    /**
+     * @brief Send a burst of packets, UDP_MAX_BATCH per sendmmsg call
+     * @return Number of packets handed to the kernel (stops at first error)
+     */
+    std::size_t send_batch(std::span<const MarketDataPacket> packets) {
+        #ifdef __linux__
+        if (socket_fd_ < 0) return 0;
+        
+        std::size_t sent_total = 0;
+        while (sent_total < packets.size()) {
+            const std::size_t n = std::min(packets.size() - sent_total, UDP_MAX_BATCH);
+            for (std::size_t i = 0; i < n; ++i) {
+                iovs_[i].iov_base = const_cast<MarketDataPacket*>(&packets[sent_total + i]);
+                iovs_[i].iov_len = sizeof(MarketDataPacket);
+                std::memset(&msgs_[i], 0, sizeof(msgs_[i]));
+                msgs_[i].msg_hdr.msg_name = &dest_addr_;
+                msgs_[i].msg_hdr.msg_namelen = sizeof(dest_addr_);
+                msgs_[i].msg_hdr.msg_iov = &iovs_[i];
+                msgs_[i].msg_hdr.msg_iovlen = 1;
+            }
+            
+            const int sent = sendmmsg(socket_fd_, msgs_.data(), static_cast<unsigned>(n), 0);
+            if (sent <= 0) break;
+            sent_total += static_cast<std::size_t>(sent);
+            if (static_cast<std::size_t>(sent) < n) break;
+        }
+        return sent_total;
+        #else
+        (void)packets;
+        return 0;
+        #endif
+    }
+    
     void close_socket() {
         #ifdef __linux__
         if (socket_fd_ >= 0) {
@@ -108,6 +192,8 @@ private:
     int socket_fd_;
     #ifdef __linux__
     sockaddr_in dest_addr_;
+    std::array<mmsghdr, UDP_MAX_BATCH> msgs_;
+    std::array<iovec, UDP_MAX_BATCH> iovs_;
     #endif
 };
 
@@ -121,7 +207,8 @@ public:
     UDPMulticastReceiver(const std::string& multicast_ip, uint16_t port,
                          const std::string& interface_ip = "0.0.0.0")
         : multicast_ip_(multicast_ip), port_(port), 
-          interface_ip_(interface_ip), socket_fd_(-1), running_(false) {}
+          interface_ip_(interface_ip), socket_fd_(-1), running_(false),
+          timestamping_(RxTimestamping::NONE) {}
     
     ~UDPMulticastReceiver() {
         stop();
@@ -164,16 +251,93 @@ public:
         int flags = fcntl(socket_fd_, F_GETFL, 0);
         fcntl(socket_fd_, F_SETFL, flags | O_NONBLOCK);
         
+        prepare_batch();
+        return true;
+        #else
+        return false;
+        #endif
+    }
+    
+    /**
+     * @brief Request SO_TIMESTAMPING receive timestamps (call after init)
+     *
+     * HARDWARE also needs the NIC configured via SIOCSHWTSTAMP; packets
+     * without a hardware stamp fall back to the software stamp.
+     * @return false if the kernel rejected the option
+     */
+    bool enable_rx_timestamping(RxTimestamping mode) {
+        #ifdef __linux__
+        if (socket_fd_ < 0) return false;
+        
+        unsigned int flags = 0;
+        if (mode != RxTimestamping::NONE) {
+            flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        }
+        if (mode == RxTimestamping::HARDWARE) {
+            flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+        }
+        if (setsockopt(socket_fd_, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) != 0) {
+            return false;
+        }
+        timestamping_ = mode;
+        return true;
+        #else
+        (void)mode;
+        return false;
+        #endif
+    }
+    
+    /**
+     * @brief Receive on the AF_XDP path instead of the socket (call after init)
+     *
+     * The socket stays open only to hold the group membership. Kernel
+     * receive timestamps do not apply; rx_timestamp() is then 0.
+     * @return false if built without HFT_ENABLE_AF_XDP or the socket failed
+     *         (see xdp_error())
+     */
+    bool enable_xdp(const XdpConfig& config) {
+        #if defined(__linux__) && defined(HFT_ENABLE_AF_XDP)
+        if (socket_fd_ < 0) return false;
+        auto xdp = std::make_unique<XdpSocket>();
+        if (!xdp->open(config)) {
+            xdp_error_ = xdp->error();
+            return false;
+        }
+        in_addr group{};
+        inet_pton(AF_INET, multicast_ip_.c_str(), &group);
+        xdp_group_be_ = group.s_addr;
+        xdp_ = std::move(xdp);
         return true;
         #else
+        (void)config;
+        xdp_error_ = "built without HFT_ENABLE_AF_XDP";
         return false;
         #endif
     }
     
-    void start(PacketCallback callback) {
+    [[nodiscard]] bool xdp_enabled() const noexcept {
+        #if defined(__linux__) && defined(HFT_ENABLE_AF_XDP)
+        return xdp_ != nullptr;
+        #else
+        return false;
+        #endif
+    }
+    
+    [[nodiscard]] const std::string& xdp_error() const noexcept { return xdp_error_; }
+    
+    /**
+     * @brief Receive on a background thread
+     *
+     * @param cpu_core Core to pin the receive thread to, or -1
+     * @param idle How the thread waits while the feed is quiet
+     */
+    void start(PacketCallback callback, int cpu_core = -1, const IdleStrategy::Config& idle = {}) {
         running_ = true;
-        recv_thread_ = std::thread([this, callback]() {
-            run_loop(callback);
+        recv_thread_ = std::thread([this, callback, cpu_core, idle]() {
+            if (cpu_core >= 0) {
+                set_cpu_affinity(cpu_core);
+            }
+            run_loop(callback, idle);
         });
     }
     
@@ -190,28 +354,158 @@ public:
         if (socket_fd_ < 0) return false;
         
         ssize_t received = recv(socket_fd_, &packet, sizeof(packet), MSG_DONTWAIT);
+        if (received > 0 && received != sizeof(packet)) {
+            ++malformed_;
+        }
         return received == sizeof(packet);
         #else
         (void)packet;
         return false;
         #endif
     }
+    
+    /**
+     * @brief Receive up to UDP_MAX_BATCH packets with one recvmmsg call
+     *
+     * Non-blocking. The returned span points into the receiver's batch
+     * array and is valid until the next call. Truncated datagrams are
+     * dropped. With timestamping enabled each packet is recorded as
+     * PACKET_RX (payload = sequence) in the calling thread's buffer.
+     */
+    std::span<const MarketDataPacket> try_receive_batch() {
+        #ifdef __linux__
+        batch_size_ = 0;
+        if (socket_fd_ < 0) return {};
+        #ifdef HFT_ENABLE_AF_XDP
+        if (xdp_) return try_receive_xdp_batch();
+        #endif
+        
+        for (auto& msg : msgs_) {
+            msg.msg_hdr.msg_controllen = timestamping_ != RxTimestamping::NONE ? CONTROL_SIZE : 0;
+            msg.msg_hdr.msg_flags = 0;
+        }
+        
+        const int received = recvmmsg(socket_fd_, msgs_.data(), UDP_MAX_BATCH, MSG_DONTWAIT, nullptr);
+        if (received <= 0) return {};
+        
+        for (int i = 0; i < received; ++i) {
+            const auto& msg = msgs_[i];
+            if (msg.msg_len != sizeof(MarketDataPacket) || (msg.msg_hdr.msg_flags & MSG_TRUNC)) {
+                ++malformed_;
+                continue;
+            }
+            // Compact valid packets to the front of the batch
+            if (batch_size_ != static_cast<std::size_t>(i)) {
+                batch_[batch_size_] = batch_[i];
+            }
+            std::int64_t rx_ns = 0;
+            if (timestamping_ != RxTimestamping::NONE) {
+                rx_ns = parse_rx_timestamp(msg.msg_hdr);
+                if (rx_ns != 0) {
+                    (void)TimestampBufferManager::get_thread_buffer().record_with_timestamp(
+                        EventType::PACKET_RX, rx_ns, batch_[batch_size_].sequence);
+                }
+            }
+            rx_timestamps_[batch_size_] = rx_ns;
+            ++batch_size_;
+        }
+        return {batch_.data(), batch_size_};
+        #else
+        return {};
+        #endif
+    }
+    
+    /**
+     * @brief Receive timestamp (ns) of packet i of the last batch; 0 if none
+     */
+    [[nodiscard]] std::int64_t rx_timestamp(std::size_t i) const noexcept {
+        return i < batch_size_ ? rx_timestamps_[i] : 0;
+    }
+    
+    [[nodiscard]] RxTimestamping timestamping() const noexcept { return timestamping_; }
+    
+    /**
+     * @brief Datagrams dropped for having the wrong size
+     *
+     * Sequence gaps are tracked separately by FeedSequencer (feed_recovery.hpp).
+     */
+    [[nodiscard]] std::uint64_t malformed_packets() const noexcept {
+        return malformed_.load(std::memory_order_relaxed);
+    }
 
 private:
-    void run_loop(PacketCallback callback) {
+    void run_loop(PacketCallback callback, const IdleStrategy::Config& idle_config) {
         #ifdef __linux__
-        MarketDataPacket packet;
+        IdleStrategy idle(idle_config);
         while (running_) {
-            ssize_t received = recv(socket_fd_, &packet, sizeof(packet), 0);
-            if (received == sizeof(packet)) {
+            auto packets = try_receive_batch();
+            for (const auto& packet : packets) {
                 callback(packet);
             }
+            idle.idle(packets.size());
         }
         #else
         (void)callback;
+        (void)idle_config;
         #endif
     }
     
+    #if defined(__linux__) && defined(HFT_ENABLE_AF_XDP)
+    std::span<const MarketDataPacket> try_receive_xdp_batch() {
+        const std::uint16_t port_be = htons(port_);
+        xdp_->poll([this, port_be](std::span<const std::uint8_t> frame) {
+            switch (parse_feed_frame(frame, xdp_group_be_, port_be, batch_[batch_size_])) {
+                case FrameResult::PACKET:
+                    rx_timestamps_[batch_size_++] = 0;
+                    break;
+                case FrameResult::MALFORMED:
+                    ++malformed_;
+                    break;
+                case FrameResult::OTHER:
+                    break;
+            }
+        }, UDP_MAX_BATCH);
+        return {batch_.data(), batch_size_};
+    }
+    #endif
+    
+    #ifdef __linux__
+    static constexpr std::size_t CONTROL_SIZE = CMSG_SPACE(sizeof(scm_timestamping)) + 64;
+    
+    /**
+     * @brief Point each mmsghdr at its slot of the preallocated arrays
+     */
+    void prepare_batch() {
+        for (std::size_t i = 0; i < UDP_MAX_BATCH; ++i) {
+            iovs_[i].iov_base = &batch_[i];
+            iovs_[i].iov_len = sizeof(MarketDataPacket);
+            std::memset(&msgs_[i], 0, sizeof(msgs_[i]));
+            msgs_[i].msg_hdr.msg_iov = &iovs_[i];
+            msgs_[i].msg_hdr.msg_iovlen = 1;
+            msgs_[i].msg_hdr.msg_control = control_[i].data();
+        }
+    }
+    
+    /**
+     * @brief Extract the SCM_TIMESTAMPING stamp, preferring hardware
+     */
+    std::int64_t parse_rx_timestamp(const msghdr& hdr) const noexcept {
+        for (const cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg;
+             cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), const_cast<cmsghdr*>(cmsg))) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) {
+                continue;
+            }
+            scm_timestamping stamps;
+            std::memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+            const timespec& ts = (timestamping_ == RxTimestamping::HARDWARE &&
+                                  (stamps.ts[2].tv_sec || stamps.ts[2].tv_nsec))
+                                     ? stamps.ts[2] : stamps.ts[0];
+            return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000LL + ts.tv_nsec;
+        }
+        return 0;
+    }
+    #endif
+    
     void close_socket() {
         #ifdef __linux__
         if (socket_fd_ >= 0) {
@@ -227,6 +521,23 @@ private:
     int socket_fd_;
     std::atomic<bool> running_;
     std::thread recv_thread_;
+    RxTimestamping timestamping_;
+    
+    // Batch state, owned by whichever thread receives
+    std::array<MarketDataPacket, UDP_MAX_BATCH> batch_;
+    std::array<std::int64_t, UDP_MAX_BATCH> rx_timestamps_{};
+    std::size_t batch_size_ = 0;
+    std::atomic<std::uint64_t> malformed_{0};
+    #ifdef __linux__
+    std::array<mmsghdr, UDP_MAX_BATCH> msgs_;
+    std::array<iovec, UDP_MAX_BATCH> iovs_;
+    alignas(cmsghdr) std::array<std::array<char, CONTROL_SIZE>, UDP_MAX_BATCH> control_;
+    #endif
+    #if defined(__linux__) && defined(HFT_ENABLE_AF_XDP)
+    std::unique_ptr<XdpSocket> xdp_;
+    std::uint32_t xdp_group_be_ = 0;
+    #endif
+    std::string xdp_error_;
 };
 
 } // namespace hft
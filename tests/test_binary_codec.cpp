@@ -0,0 +1,176 @@
+/**
+ * @file test_binary_codec.cpp
+ * @brief Binary (SBE-style) codec unit tests
+ */
+
+#include <array>
+#include <iostream>
+#include "protocol/binary_codec.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_binary_codec_tests() {
+    std::cout << "\n=== Binary Codec Tests ===\n";
+    
+    // Test 1: Compile-time layout
+    {
+        std::cout << "  Schema layout... ";
+        
+        using F = sbe::NewOrderField;
+        static_assert(sbe::NewOrder::offset_of<F::CLIENT_ORDER_ID>() == 0);
+        static_assert(sbe::NewOrder::offset_of<F::SYMBOL>() == 16);
+        static_assert(sbe::NewOrder::offset_of<F::PRICE>() == 36);
+        static_assert(sbe::NewOrder::offset_of<F::ORDER_TYPE>() == 53);
+        static_assert(std::is_same_v<sbe::NewOrder::type_of<F::SIDE>, Side>);
+        static_assert(sbe::Encoder<sbe::NewOrder>::ENCODED_LENGTH == 8 + 54);
+        
+        std::array<char, 64> buf{};
+        sbe::Encoder<sbe::NewOrder> enc(buf);
+        ASSERT(enc.ok());
+        enc.set<F::PRICE>(0x0102030405060708LL);
+        
+        // Little-endian on the wire regardless of host
+        const auto* p = reinterpret_cast<const unsigned char*>(buf.data()) + 8 + 36;
+        ASSERT(p[0] == 0x08 && p[7] == 0x01);
+        
+        auto header = sbe::peek_header(buf);
+        ASSERT(header.has_value());
+        ASSERT(header->block_length == 54);
+        ASSERT(header->template_id == static_cast<std::uint16_t>(sbe::TemplateId::NEW_ORDER));
+        ASSERT(header->version == sbe::SCHEMA_VERSION);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 2: Order round trip through the flyweights
+    {
+        std::cout << "  New order round trip... ";
+        
+        using F = sbe::NewOrderField;
+        std::array<char, 128> buf{};
+        sbe::Encoder<sbe::NewOrder> enc(buf);
+        enc.set<F::CLIENT_ORDER_ID>(42)
+           .set<F::CLIENT_ID>(7)
+           .set<F::SYMBOL>(make_symbol("BTC-USD"))
+           .set<F::INSTRUMENT>(3)
+           .set<F::PRICE>(to_fixed_price(50000.25))
+           .set<F::QUANTITY>(100)
+           .set<F::SIDE>(Side::SELL)
+           .set<F::ORDER_TYPE>(OrderType::LIMIT);
+        
+        sbe::Decoder<sbe::NewOrder> dec(std::span<const char>(buf.data(), enc.size()));
+        ASSERT(dec.ok());
+        ASSERT(dec.size() == enc.size());
+        ASSERT(dec.get<F::CLIENT_ORDER_ID>() == 42);
+        ASSERT(dec.get<F::CLIENT_ID>() == 7);
+        ASSERT(symbol_view(dec.get<F::SYMBOL>()) == "BTC-USD");
+        ASSERT(dec.get<F::INSTRUMENT>() == 3);
+        ASSERT(dec.get<F::PRICE>() == to_fixed_price(50000.25));
+        ASSERT(dec.get<F::QUANTITY>() == 100);
+        ASSERT(dec.get<F::SIDE>() == Side::SELL);
+        ASSERT(dec.get<F::ORDER_TYPE>() == OrderType::LIMIT);
+        ASSERT(sbe::valid_new_order(dec));
+        
+        // Out-of-range enums, non-positive quantity and limit price are rejected
+        auto valid_after = [&](auto&& edit) {
+            std::array<char, 128> copy = buf;
+            sbe::Encoder<sbe::NewOrder> patch(copy);
+            patch.set<F::CLIENT_ORDER_ID>(42)
+                 .set<F::PRICE>(to_fixed_price(50000.25))
+                 .set<F::QUANTITY>(100)
+                 .set<F::SIDE>(Side::SELL)
+                 .set<F::ORDER_TYPE>(OrderType::LIMIT);
+            edit(patch);
+            return sbe::valid_new_order(sbe::Decoder<sbe::NewOrder>(std::span<const char>(copy.data(), patch.size())));
+        };
+        ASSERT(!valid_after([](auto& e) { e.template set<F::SIDE>(static_cast<Side>(2)); }));
+        ASSERT(!valid_after([](auto& e) { e.template set<F::ORDER_TYPE>(static_cast<OrderType>(0xff)); }));
+        ASSERT(!valid_after([](auto& e) { e.template set<F::QUANTITY>(0); }));
+        ASSERT(!valid_after([](auto& e) { e.template set<F::QUANTITY>(-5); }));
+        ASSERT(!valid_after([](auto& e) { e.template set<F::PRICE>(0); }));
+        ASSERT(!valid_after([](auto& e) { e.template set<F::PRICE>(-100); }));
+        ASSERT(valid_after([](auto& e) { e.template set<F::ORDER_TYPE>(OrderType::MARKET).template set<F::PRICE>(0); }));
+        
+        // Types up to POST_ONLY pass; stop types need a stop price the schema lacks
+        auto valid_type = [&](OrderType type) {
+            return valid_after([type](auto& e) { e.template set<F::ORDER_TYPE>(type); });
+        };
+        ASSERT(valid_type(OrderType::IMMEDIATE_OR_CANCEL) && valid_type(OrderType::FILL_OR_KILL));
+        ASSERT(valid_type(OrderType::POST_ONLY));
+        ASSERT(!valid_type(OrderType::STOP_LIMIT) && !valid_type(OrderType::STOP));
+        ASSERT(!valid_type(static_cast<OrderType>(7)));
+        
+        // Wrong template, truncated buffer and too-small encode buffer
+        sbe::Decoder<sbe::CancelOrder> wrong(std::span<const char>(buf.data(), enc.size()));
+        ASSERT(!wrong.ok());
+        sbe::Decoder<sbe::NewOrder> truncated(std::span<const char>(buf.data(), enc.size() - 1));
+        ASSERT(!truncated.ok());
+        std::array<char, 16> small{};
+        ASSERT(!sbe::Encoder<sbe::NewOrder>(small).ok());
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 3: Execution report conversion
+    {
+        std::cout << "  Execution report round trip... ";
+        
+        ExecutionReport report{};
+        report.order_id = 1001;
+        report.contra_order_id = 2002;
+        report.client_id = 9;
+        report.execution_price = to_fixed_price(3000.5);
+        report.execution_quantity = 25;
+        report.leaves_quantity = 75;
+        report.cumulative_quantity = 25;
+        report.timestamp = 1234567890;
+        report.side = Side::BUY;
+        report.exec_type = ExecutionType::TRADE;
+        report.order_status = OrderStatus::PARTIALLY_FILLED;
+        
+        std::array<char, 128> buf{};
+        const auto len = sbe::encode_execution_report(buf, report);
+        ASSERT(len == 8 + 67);
+        
+        auto decoded = sbe::decode_execution_report(std::span<const char>(buf.data(), len));
+        ASSERT(decoded.has_value());
+        ASSERT(decoded->order_id == 1001);
+        ASSERT(decoded->contra_order_id == 2002);
+        ASSERT(decoded->client_id == 9);
+        ASSERT(decoded->execution_price == report.execution_price);
+        ASSERT(decoded->execution_quantity == 25);
+        ASSERT(decoded->leaves_quantity == 75);
+        ASSERT(decoded->cumulative_quantity == 25);
+        ASSERT(decoded->timestamp == 1234567890);
+        ASSERT(decoded->exec_type == ExecutionType::TRADE);
+        ASSERT(decoded->order_status == OrderStatus::PARTIALLY_FILLED);
+        
+        std::array<char, 32> small{};
+        ASSERT(sbe::encode_execution_report(small, report) == 0);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 4: Level update conversion
+    {
+        std::cout << "  Level update round trip... ";
+        
+        const BookDelta delta{42, to_fixed_price(101.25), 300, 4, Side::SELL, {}};
+        std::array<char, 128> buf{};
+        const auto len = sbe::encode_level_update(buf, make_symbol("ETH-USD"), delta, 777);
+        ASSERT(len == sbe::Encoder<sbe::LevelUpdate>::size());
+        
+        auto decoded = sbe::decode_level_update(std::span<const char>(buf.data(), len));
+        ASSERT(decoded.has_value());
+        ASSERT(decoded->sequence == 42 && decoded->price == delta.price);
+        ASSERT(decoded->quantity == 300 && decoded->order_count == 4 && decoded->side == Side::SELL);
+        ASSERT(!sbe::decode_execution_report(std::span<const char>(buf.data(), len)));
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All binary codec tests passed!\n";
+}
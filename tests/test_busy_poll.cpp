@@ -0,0 +1,148 @@
+/**
+ * @file test_busy_poll.cpp
+ * @brief Idle strategy and wake signal unit tests
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "core/busy_poll.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+namespace {
+
+// Time moves only when the test says so
+struct ManualClock {
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+
+    static inline time_point current{};
+    static time_point now() noexcept { return current; }
+    static void advance(duration d) noexcept { current += d; }
+};
+
+} // namespace
+
+void run_busy_poll_tests() {
+    std::cout << "\n=== Busy Poll Tests ===\n";
+
+    // Test 1: IdleStrategy backs off to a park and learns long gaps
+    {
+        std::cout << "  Adaptive idle strategy... ";
+        using namespace std::chrono_literals;
+        using ManualIdle = BasicIdleStrategy<ManualClock>;
+
+        ManualIdle::Config config;
+        config.min_spin = 5us;
+        config.max_spin = 20us;
+        config.max_wake_latency = 1ms;
+        config.spin_polls = 4;
+        ManualIdle idle(config);
+        auto found_work = [] { return true; };     // Park returns without sleeping
+
+        // Work every few polls never leaves SPIN, and gaps that end inside
+        // SPIN count as zero: the budget settles at min_spin
+        for (int i = 0; i < 1000; ++i) {
+            idle.idle(i % 3 == 0 ? 1 : 0, found_work);
+            ASSERT(idle.state() == ManualIdle::State::SPIN);
+        }
+        ASSERT(idle.parks() == 0 && idle.spin_budget() == config.min_spin);
+
+        // Regular 10 us gaps are short enough to spin through: budget ~2x the gap
+        auto quiet_for = [&](std::chrono::nanoseconds gap) {
+            for (std::uint32_t i = 0; i <= config.spin_polls; ++i) {
+                idle.idle(0, found_work);
+            }
+            ManualClock::advance(gap);
+            idle.idle(0, found_work);
+            idle.idle(1, found_work);
+        };
+        for (int i = 0; i < 16; ++i) {
+            quiet_for(10us);
+        }
+        const auto learned = idle.spin_budget();
+        ASSERT(learned > config.min_spin && learned < 20us);
+        ASSERT(idle.average_gap() > 5us && idle.average_gap() < 10us);
+
+        // A quiet feed goes SPIN -> PAUSE -> WAIT -> PARK as the budget runs out
+        const std::uint64_t parks = idle.parks();
+        for (std::uint32_t i = 0; i < config.spin_polls; ++i) {
+            idle.idle(0, found_work);
+            ASSERT(idle.state() == ManualIdle::State::SPIN);
+        }
+        idle.idle(0, found_work);
+        ASSERT(idle.state() == ManualIdle::State::PAUSE);
+        ManualClock::advance(learned);
+        idle.idle(0, found_work);
+        ASSERT(idle.state() == ManualIdle::State::WAIT);
+        ManualClock::advance(learned);
+        idle.idle(0, found_work);
+        ASSERT(idle.state() == ManualIdle::State::PARK && idle.parks() == parks + 1);
+
+        // The 1 ms gap is too long to spin through: the budget drops to min_spin
+        ManualClock::advance(1ms - 2 * learned);
+        idle.idle(1);
+        ASSERT(idle.state() == ManualIdle::State::SPIN);
+        ASSERT(idle.average_gap() > config.max_spin);
+        ASSERT(idle.spin_budget() == config.min_spin);
+
+        // BALANCED pauses however long the gap, and never parks
+        ManualIdle::Config balanced_config = config;
+        balanced_config.mode = PollMode::BALANCED;
+        ManualIdle balanced(balanced_config);
+        for (int i = 0; i < 100; ++i) {
+            balanced.idle(0, found_work);
+            ManualClock::advance(100us);
+        }
+        ASSERT(balanced.state() == ManualIdle::State::PAUSE && balanced.parks() == 0);
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 2: A parked poller is woken by the signal, not its park timeout
+    {
+        std::cout << "  Wake signal... ";
+
+        // A wakeup lost between the poller's last check and its sleep would
+        // hang here for an hour, not merely run slow
+        IdleStrategy::Config config;
+        config.min_spin = std::chrono::microseconds(1);
+        config.max_spin = std::chrono::microseconds(1);
+        config.spin_polls = 1;
+        config.max_wake_latency = std::chrono::hours(1);
+        WakeSignal signal;
+        std::atomic<bool> work{false};
+        std::uint64_t parks = 0;
+        std::thread poller([&]() {
+            IdleStrategy parked(config, &signal);
+            while (!work.load(std::memory_order_acquire)) {
+                parked.idle(0, [&] { return work.load(std::memory_order_acquire); });
+            }
+            parks = parked.parks();
+        });
+        while (signal.parked() == 0) {
+            std::this_thread::yield();
+        }
+        work.store(true, std::memory_order_release);
+        signal.notify();
+        poller.join();
+        ASSERT(parks >= 1 && signal.parked() == 0);
+
+        // Pending work found after announcing the park skips the sleep
+        WakeSignal idle_signal;
+        idle_signal.wait_for(std::chrono::hours(1), [] { return true; });
+        ASSERT(idle_signal.parked() == 0);
+
+        std::cout << "PASSED\n";
+    }
+
+    std::cout << "  All busy poll tests passed!\n";
+}
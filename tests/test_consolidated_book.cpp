@@ -0,0 +1,96 @@
+/**
+ * @file test_consolidated_book.cpp
+ * @brief Consolidated multi-venue book unit tests
+ */
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "marketdata/consolidated_book.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_consolidated_book_tests() {
+    std::cout << "\n=== Consolidated Book Tests ===\n";
+    
+    // Test 1: Consolidated book merges venue tops into NBBO and levels
+    {
+        std::cout << "  Consolidated multi-venue book... ";
+        
+        ConsolidatedBook book;
+        const auto a = book.add_venue("A");
+        const auto b = book.add_venue("B");
+        const auto c = book.add_venue("C");
+        const Symbol sym = make_symbol("BTC-USD");
+        const InstrumentId id = book.subscribe(sym);
+        auto& nbbo = book.add_channel(MarketDataChannel::Mode::QUEUED);
+        
+        ConsolidatedBook::View view;
+        ASSERT(!book.read(id, view));
+        
+        ASSERT(book.push(a, MarketDataUpdate::make_quote(sym, 100, 5, 103, 5)));
+        ASSERT(book.push(b, MarketDataUpdate::make_quote(sym, 101, 7, 103, 2)));
+        ASSERT(book.push(c, MarketDataUpdate::make_quote(sym, 100, 1, 104, 4)));
+        ASSERT(book.push(c, MarketDataUpdate::make_quote(make_symbol("ETH-USD"), 1, 1, 2, 1)));
+        ASSERT(book.poll() == 4);
+        
+        ASSERT(book.read(id, view) && view.has_nbbo());
+        ASSERT(view.bid_levels == 2 && view.ask_levels == 2);
+        ASSERT(view.bids[0].price == 101 && view.bids[0].quantity == 7 && view.bids[0].venues == (1u << b));
+        ASSERT(view.bids[1].price == 100 && view.bids[1].quantity == 6);
+        ASSERT(view.bids[1].venues == ((1u << a) | (1u << c)));
+        ASSERT(view.asks[0].price == 103 && view.asks[0].quantity == 7);
+        ASSERT(view.asks[1].price == 104 && view.asks[1].venues == (1u << c));
+        
+        // B pulls its bid, A improves: venues move within the ranking
+        ASSERT(book.push(b, MarketDataUpdate::make_quote(sym, 0, 0, 103, 2)));
+        ASSERT(book.push(a, MarketDataUpdate::make_quote(sym, 102, 3, 103, 5)));
+        // C repeats its quote: no NBBO change, no channel update
+        ASSERT(book.push(c, MarketDataUpdate::make_quote(sym, 100, 1, 104, 4)));
+        ASSERT(book.push(a, MarketDataUpdate::make_trade(sym, 103, 2, Side::BUY)));
+        ASSERT(book.poll() == 4);
+        ASSERT(book.read(id, view));
+        ASSERT(view.bid_levels == 2 && view.bids[0].price == 102 && view.bids[0].venues == (1u << a));
+        ASSERT(view.bids[1].price == 100 && view.bids[1].quantity == 1);
+        
+        std::vector<MarketDataUpdate> updates;
+        nbbo.poll([&](const MarketDataUpdate& u) { updates.push_back(u); });
+        // Lanes drain venue by venue: A's improvement and trade come before
+        // B's pull, which leaves the NBBO alone, as does C's first quote
+        ASSERT(updates.size() == 4);
+        ASSERT(updates[1].data.quote.bid_price == 101 && updates[1].data.quote.ask_quantity == 7);
+        ASSERT(updates[2].data.quote.bid_price == 102 && updates[2].data.quote.bid_quantity == 3);
+        ASSERT(updates[3].type == MarketDataType::TRADE);
+        
+        // Threaded venue producers with a running consolidator
+        ConsolidatedBook threaded;
+        const auto v0 = threaded.add_venue("X");
+        const auto v1 = threaded.add_venue("Y");
+        const InstrumentId tid = threaded.subscribe(sym);
+        threaded.start();
+        std::thread p0([&]() {
+            for (Price px = 1; px <= 20000; ++px) {
+                while (!threaded.push(v0, MarketDataUpdate::make_quote(sym, px, 1, px + 10, 1))) {}
+            }
+        });
+        std::thread p1([&]() {
+            for (Price px = 1; px <= 20000; ++px) {
+                while (!threaded.push(v1, MarketDataUpdate::make_quote(sym, px - 1, 1, px + 11, 1))) {}
+            }
+        });
+        p0.join();
+        p1.join();
+        threaded.stop();
+        ASSERT(threaded.read(tid, view));
+        ASSERT(view.bids[0].price == 20000 && view.bids[1].price == 19999);
+        ASSERT(view.asks[0].price == 20010 && view.asks[1].price == 20011);
+        ASSERT(threaded.updates_applied() == 40000);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All consolidated book tests passed!\n";
+}
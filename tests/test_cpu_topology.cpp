@@ -0,0 +1,107 @@
+/**
+ * @file test_cpu_topology.cpp
+ * @brief CPU topology and thread placement unit tests
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "core/cpu_topology.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_cpu_topology_tests() {
+    std::cout << "\n=== CPU Topology Tests ===\n";
+    
+    // Test 1: Topology from a fake sysfs tree, hot pairs kept in one L3 off SMT siblings
+    {
+        std::cout << "  CPU topology and placement... ";
+        
+        // 4 cores x 2 threads (cpu k and k+4), L3 {0,1,4,5} and {2,3,6,7},
+        // CPUs 1-3 isolated, 3 tickless, eth0's queue IRQ on CPU 2
+        namespace fs = std::filesystem;
+        const fs::path root = fs::temp_directory_path() / ("hft_topology_" + std::to_string(::getpid()));
+        auto put = [&](const std::string& path, const std::string& text) {
+            fs::create_directories((root / path).parent_path());
+            std::ofstream(root / path) << text << "\n";
+        };
+        put("sys/devices/system/cpu/online", "0-7");
+        put("sys/devices/system/cpu/isolated", "1-3");
+        put("sys/devices/system/cpu/nohz_full", "3");
+        for (int cpu = 0; cpu < 8; ++cpu) {
+            const int core = cpu % 4;
+            const std::string dir = "sys/devices/system/cpu/cpu" + std::to_string(cpu);
+            put(dir + "/topology/core_id", std::to_string(core));
+            put(dir + "/topology/physical_package_id", "0");
+            put(dir + "/topology/thread_siblings_list", std::to_string(core) + "," + std::to_string(core + 4));
+            put(dir + "/cache/index0/level", "1");
+            put(dir + "/cache/index0/type", "Data");
+            put(dir + "/cache/index0/shared_cpu_list", std::to_string(core) + "," + std::to_string(core + 4));
+            put(dir + "/cache/index1/level", "1");
+            put(dir + "/cache/index1/type", "Instruction");
+            put(dir + "/cache/index1/shared_cpu_list", "0-7");
+            put(dir + "/cache/index2/level", "2");
+            put(dir + "/cache/index2/type", "Unified");
+            put(dir + "/cache/index2/shared_cpu_list", std::to_string(core) + "," + std::to_string(core + 4));
+            put(dir + "/cache/index3/level", "3");
+            put(dir + "/cache/index3/type", "Unified");
+            put(dir + "/cache/index3/shared_cpu_list", core < 2 ? "0-1,4-5" : "2-3,6-7");
+            put(dir + "/cpufreq/cpuinfo_max_freq", "3000000");
+            fs::create_directories(root / dir / "node0");
+        }
+        put("sys/class/net/eth0/device/msi_irqs/40", "msix");
+        put("proc/irq/40/smp_affinity_list", "2");
+        
+        const auto topology = CpuTopology::discover(root.string());
+        fs::remove_all(root);
+        ASSERT(topology.cpus().size() == 8);
+        ASSERT(topology.smt_siblings(1, 5) && !topology.smt_siblings(1, 2) && !topology.smt_siblings(3, 3));
+        ASSERT(topology.share_l2(0, 4) && !topology.share_l2(0, 1));
+        ASSERT(topology.share_l3(0, 5) && topology.share_l3(2, 7) && !topology.share_l3(1, 2));
+        ASSERT(topology.find(2)->isolated && !topology.find(4)->isolated && topology.find(3)->nohz_full);
+        ASSERT(topology.nic_irqs().size() == 1 && topology.nic_irqs()[0].interface == "eth0");
+        ASSERT(topology.find(2)->nic_irqs == 1 && topology.find(3)->nic_irqs == 0);
+        ASSERT(topology.info(6).is_hyperthreaded && topology.info(6).frequency_hz == 3'000'000'000ULL);
+        ASSERT(topology.info(9).core_id == -1);
+        ASSERT(detail::parse_cpu_list("(null)").empty());
+        ASSERT((detail::parse_cpu_list("0-2,5") == std::vector<int>{0, 1, 2, 5}));
+        
+        // Both hot threads on the isolated L3 domain, one physical core each;
+        // the tickless IRQ-free core first, the logger on a housekeeping core
+        const std::vector<ThreadSpec> specs{{"feed"}, {"engine", true, 0}, {"logger", false}};
+        const auto plan = plan_placement(topology, specs);
+        const int feed = plan.cpu_of("feed");
+        const int engine = plan.cpu_of("engine");
+        const int logger = plan.cpu_of("logger");
+        ASSERT(feed == 3 && engine == 2);
+        ASSERT(topology.share_l3(feed, engine) && !topology.smt_siblings(feed, engine));
+        ASSERT(logger >= 0 && !topology.find(logger)->isolated);
+        ASSERT(!topology.smt_siblings(logger, feed) && !topology.smt_siblings(logger, engine));
+        ASSERT(plan.warnings.size() == 1 && plan.warnings[0].find("IRQ") != std::string::npos);
+        
+        // Hand-placed on SMT siblings, non-isolated, across L3s: all reported
+        const auto manual = check_placement(topology, specs, {3, 7, 4});
+        auto warned = [&](const char* text) {
+            return std::any_of(manual.warnings.begin(), manual.warnings.end(),
+                               [&](const std::string& w) { return w.find(text) != std::string::npos; });
+        };
+        ASSERT(warned("SMT siblings") && warned("not isolated"));
+        ASSERT(check_placement(topology, specs, {3, 0}).warnings.size() == 2);   // 0: not isolated, other L3
+        
+        // More critical threads than cores: the leftover is unpinned, not doubled up
+        const std::vector<ThreadSpec> crowd{{"a"}, {"b"}, {"c"}, {"d"}, {"e"}};
+        const auto crowded = plan_placement(topology, crowd);
+        ASSERT(crowded.cpu_of("e") == -1 && !crowded.warnings.empty());
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All CPU topology tests passed!\n";
+}
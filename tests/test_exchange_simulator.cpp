@@ -0,0 +1,123 @@
+/**
+ * @file test_exchange_simulator.cpp
+ * @brief Exchange simulator unit tests
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "exchange/exchange_simulator.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_exchange_simulator_tests() {
+    std::cout << "\n=== Exchange Simulator Tests ===\n";
+    
+    // Test 1: Multi-client exchange: fair lanes, matched fills in the acks, wire delay
+    {
+        std::cout << "  Multi-client exchange simulator... ";
+        
+        const Symbol sym = make_symbol("EXCH");
+        auto make_order = [&](uint64_t id, Side side, Price price, Quantity quantity) {
+            const Timestamp t = fast_now();
+            return make_exchange_order(id, 0, t, t, sym, side, OrderType::LIMIT, price, quantity);
+        };
+        
+        // Client 1's buy takes client 0's resting sell and rests the remainder
+        ExchangeConfig matching;
+        matching.match_orders = true;
+        ExchangeSimulator exchange(matching);
+        std::vector<OrderAck> acks0;
+        std::vector<OrderAck> acks1;
+        exchange.set_ack_callback([&](const OrderAck& ack) { acks0.push_back(ack); });
+        const auto client1 = exchange.add_client([&](const OrderAck& ack) { acks1.push_back(ack); });
+        ASSERT(client1 && *client1 == 1 && exchange.client_count() == 2);
+        exchange.process_order_sync(make_order(7, Side::SELL, 100 * PRICE_MULTIPLIER, 100));
+        ASSERT(acks0.size() == 1 && acks0[0].accepted && acks0[0].status == OrderStatus::NEW);
+        ASSERT(acks0[0].leaves_quantity == 100 && acks0[0].filled_quantity == 0);
+        exchange.process_order_sync(make_order(7, Side::BUY, 100 * PRICE_MULTIPLIER, 150), *client1);
+        ASSERT(acks0.size() == 2 && acks0[1].passive && acks0[1].order_id == 7 && acks0[1].client == 0);
+        ASSERT(acks0[1].status == OrderStatus::FILLED && acks0[1].filled_quantity == 100);
+        ASSERT(acks1.size() == 1 && !acks1[0].passive && acks1[0].client == 1);
+        ASSERT(acks1[0].status == OrderStatus::PARTIALLY_FILLED);
+        ASSERT(acks1[0].filled_quantity == 100 && acks1[0].leaves_quantity == 50);
+        ASSERT(acks1[0].fill_price == 100 * PRICE_MULTIPLIER);
+        ASSERT(exchange.engine().get_book(sym)->best_bid() == 100 * PRICE_MULTIPLIER);
+        const auto matched = exchange.stats();
+        ASSERT(matched.orders_partially_filled == 1 && matched.passive_fills == 1);
+        ASSERT(matched.filled_volume == 100 && matched.orders_by_client[1] == 1);
+
+        // Resting orders are told from the aggressor by exchange id, not by
+        // client order id: reused and full 64-bit ids still ack the right owner
+        constexpr uint64_t big_id = (uint64_t{1} << 60) + 3;
+        acks0.clear();
+        acks1.clear();
+        exchange.process_order_sync(make_order(big_id, Side::SELL, 101 * PRICE_MULTIPLIER, 10));
+        exchange.process_order_sync(make_order(7, Side::SELL, 101 * PRICE_MULTIPLIER, 10), *client1);
+        exchange.process_order_sync(make_order(7, Side::SELL, 101 * PRICE_MULTIPLIER, 10));
+        exchange.process_order_sync(make_order(7, Side::BUY, 101 * PRICE_MULTIPLIER, 70));
+        ASSERT(acks0.size() == 5 && acks1.size() == 2);
+        ASSERT(acks0[2].passive && acks0[2].order_id == big_id && acks0[2].filled_quantity == 10);
+        ASSERT(acks1[1].passive && acks1[1].order_id == 7 && acks1[1].filled_quantity == 10);
+        ASSERT(acks1[1].exchange_order_id == acks1[0].exchange_order_id);
+        ASSERT(acks0[3].passive && acks0[3].order_id == 7);
+        ASSERT(acks0[3].exchange_order_id == acks0[1].exchange_order_id);
+        ASSERT(!acks0[4].passive && acks0[4].order_id == 7 && acks0[4].filled_quantity == 30);
+        ASSERT(acks0[4].status == OrderStatus::PARTIALLY_FILLED && acks0[4].leaves_quantity == 40);
+
+        // A flooded lane cannot starve the others: quota 4 per lane per pass
+        ExchangeConfig fair;
+        fair.drain_quota = 4;
+        ExchangeSimulator lanes(fair);
+        std::vector<uint32_t> order_of_acks;
+        lanes.set_ack_callback([&](const OrderAck& ack) { order_of_acks.push_back(ack.client); });
+        const auto quiet1 = lanes.add_client();
+        const auto quiet2 = lanes.add_client();
+        for (int i = 0; i < 1000; ++i) ASSERT(lanes.submit_order(make_order(i, Side::BUY, 100, 1)));
+        for (int i = 0; i < 10; ++i) {
+            ASSERT(lanes.submit_order(*quiet1, make_order(i, Side::BUY, 100, 1)));
+            ASSERT(lanes.submit_order(*quiet2, make_order(i, Side::BUY, 100, 1)));
+        }
+        lanes.start(-1, false);
+        lanes.stop();
+        ASSERT(order_of_acks.size() == 1020);
+        const std::size_t quiet_in_first_passes = static_cast<std::size_t>(std::count_if(
+            order_of_acks.begin(), order_of_acks.begin() + 36, [](uint32_t c) { return c != 0; }));
+        ASSERT(quiet_in_first_passes == 20);
+        ASSERT(lanes.stats().orders_by_client[0] == 1000 && lanes.stats().orders_accepted == 1020);
+        
+        ExchangeSimulator full;
+        for (std::size_t c = 1; c < ExchangeSimulator::MAX_CLIENTS; ++c) ASSERT(full.add_client());
+        ASSERT(!full.add_client() && !full.submit_order(99, make_order(1, Side::BUY, 100, 1)));
+        
+        // Wire delay: received no earlier than sent + 1 ms, ack stamped 1 ms on the way back
+        ExchangeConfig wired;
+        wired.latency.wire_ns = 1'000'000;
+        ExchangeSimulator delayed(wired);
+        OrderAck last{};
+        delayed.set_ack_callback([&](const OrderAck& ack) { last = ack; });
+        delayed.start(-1, false);
+        ASSERT(delayed.submit_order(make_order(1, Side::BUY, 100, 1)));
+        delayed.stop();
+        ASSERT(delayed.stats().orders_received == 1);
+        ASSERT(delayed.stats().tick_to_order.min() >= 1'000'000.0);
+        ASSERT(last.t_ack_arrival - last.t_ack_sent == 1'000'000);
+
+        // Processing time is stamped on the ack, not spent on the exchange thread
+        ExchangeConfig slow;
+        slow.latency.processing_ns = 5'000'000;
+        ExchangeSimulator processing(slow);
+        processing.set_ack_callback([&](const OrderAck& ack) { last = ack; });
+        processing.process_order_sync(make_order(2, Side::BUY, 100, 1));
+        ASSERT(last.t_ack_sent - last.t_order_recv >= 5'000'000);
+        ASSERT(last.t_ack_arrival == last.t_ack_sent);
+
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All exchange simulator tests passed!\n";
+}
@@ -3,7 +3,9 @@
  * @brief FIX protocol parser unit tests
  */
 
+#include <array>
 #include <iostream>
+#include <string>
 #include "protocol/fix_message.hpp"
 
 using namespace hft;
@@ -159,6 +161,208 @@ void run_fix_parser_tests() {
         std::cout << "PASSED\n";
     }
     
+    // Test 9: Checksum and body length validated in the parse pass
+    {
+        std::cout << "  Checksum and body length... ";
+        
+        FixMessageBuilder builder;
+        builder.begin("D", "SENDER", "TARGET", 42)
+               .add_field(fix_tag::ClOrdID, "ORDER-0000000000000001")
+               .add_field(fix_tag::Symbol, "BTC-USD")
+               .add_field(fix_tag::Side, '2')
+               .add_field(fix_tag::OrderQty, static_cast<std::int64_t>(7))
+               .add_field(fix_tag::Price, 50000.25);
+        std::string msg = builder.build();
+        
+        FixMessage fix_msg;
+        ASSERT(fix_msg.parse(msg));
+        ASSERT(fix_msg.verify_checksum());
+        ASSERT(fix_msg.verify_body_length());
+        ASSERT(*fix_msg.get_int(fix_tag::MsgSeqNum) == 42);
+        
+        // Corrupt one body byte: checksum fails, length still holds
+        std::string corrupted = msg;
+        corrupted[corrupted.find("BTC")] = 'X';
+        ASSERT(fix_msg.parse(corrupted));
+        ASSERT(!fix_msg.verify_checksum());
+        ASSERT(fix_msg.verify_body_length());
+        
+        // Drop one body byte: both fail
+        std::string truncated = msg;
+        truncated.erase(truncated.find("BTC"), 1);
+        ASSERT(fix_msg.parse(truncated));
+        ASSERT(!fix_msg.verify_checksum());
+        ASSERT(!fix_msg.verify_body_length());
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 10: Long messages, overflow tags and edge cases
+    {
+        std::cout << "  Overflow tags and edge cases... ";
+        
+        std::string msg = "8=FIX.4.4\x01""35=W\x01""55=ETH-USD\x01""58=a=b=c\x01";
+        for (int i = 0; i < 40; ++i) {
+            msg += "270=" + std::to_string(3000 + i) + "\x01";
+        }
+        msg += "1000=x\x01""44=1\x01""44=2\x01""10=000";  // No trailing SOH
+        
+        FixMessage fix_msg;
+        ASSERT(fix_msg.parse(msg));
+        ASSERT(*fix_msg.get_field(fix_tag::Symbol) == "ETH-USD");
+        ASSERT(*fix_msg.get_field(58) == "a=b=c");             // '=' inside a value
+        ASSERT(*fix_msg.get_int(fix_tag::MDEntryPx) == 3039);  // Last occurrence wins
+        ASSERT(*fix_msg.get_field(1000) == "x");
+        ASSERT(*fix_msg.get_int(fix_tag::Price) == 2);
+        ASSERT(*fix_msg.get_field(fix_tag::CheckSum) == "000");
+        ASSERT(!fix_msg.has_field(999));
+        ASSERT(fix_msg.field_count() == 6 + 41);
+        
+        std::size_t md_entries = 0;
+        fix_msg.for_each_field([&](const FixField& f) {
+            if (f.tag == fix_tag::MDEntryPx) ++md_entries;
+        });
+        ASSERT(md_entries == 40);
+        
+        ASSERT(!fix_msg.parse("8=FIX.4.4\x01""3x=D\x01"));   // Non-numeric tag
+        ASSERT(!fix_msg.parse("8=FIX.4.4\x01""35\x01"));     // SOH inside tag
+        ASSERT(!fix_msg.parse("=D\x01"));                     // Empty tag
+        ASSERT(!fix_msg.parse(""));
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 11: Session header builder in a caller-owned buffer
+    {
+        std::cout << "  Session builder in fixed buffer... ";
+        
+        FixSessionHeader session("GATEWAY", "EXCHANGE");
+        std::array<char, 256> storage;
+        FixMessageBuilder builder(storage);
+        
+        const char* first_data = nullptr;
+        for (std::uint64_t seq = 1; seq <= 3; ++seq) {
+            auto msg = builder.begin(session, fix_msgtype::NewOrderSingle, seq, 1700000000000000000LL)
+                              .add_field(fix_tag::ClOrdID, static_cast<std::int64_t>(seq * 100))
+                              .add_field(fix_tag::Side, '1')
+                              .add_price(fix_tag::Price, to_fixed_price(101.5))
+                              .finish();
+            ASSERT(!msg.empty());
+            ASSERT(msg.data() >= storage.data() && msg.data() + msg.size() <= storage.data() + storage.size());
+            if (!first_data) first_data = msg.data();
+            ASSERT(msg.data() == first_data);   // Same header width, same start
+            ASSERT(msg.substr(0, 10) == "8=FIX.4.4\x01");
+            
+            FixMessage parsed;
+            ASSERT(parsed.parse(msg));
+            ASSERT(parsed.verify_checksum());
+            ASSERT(parsed.verify_body_length());
+            ASSERT(parsed.msg_type() == "D");
+            ASSERT(*parsed.get_field(fix_tag::SenderCompID) == "GATEWAY");
+            ASSERT(*parsed.get_field(fix_tag::TargetCompID) == "EXCHANGE");
+            ASSERT(*parsed.get_int(fix_tag::MsgSeqNum) == static_cast<std::int64_t>(seq));
+            ASSERT(*parsed.get_int(fix_tag::SendingTime) == 1700000000000000000LL);
+            ASSERT(*parsed.get_field(fix_tag::Price) == "101.5");
+        }
+        
+        // Legacy begin() still yields a valid message
+        FixMessageBuilder legacy;
+        legacy.begin("D", "GATEWAY", "EXCHANGE", 9);
+        std::string legacy_msg = legacy.add_field(fix_tag::ClOrdID, "X").build();
+        FixMessage parsed;
+        ASSERT(parsed.parse(legacy_msg));
+        ASSERT(parsed.verify_checksum());
+        ASSERT(parsed.verify_body_length());
+        
+        // Too small a buffer overflows cleanly
+        std::array<char, 48> tiny;
+        FixMessageBuilder small(tiny);
+        small.begin(session, "D", 1).add_field(fix_tag::Text, "does not fit in forty-eight bytes");
+        ASSERT(small.overflowed());
+        ASSERT(small.finish().empty());
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 12: Number formatting and execution report round trip
+    {
+        std::cout << "  Number formatting and exec reports... ";
+        
+        FixMessageBuilder builder;
+        auto field = [&](auto&& add) {
+            builder.clear();
+            add();
+            auto body = builder.buffer();
+            return std::string(body.substr(body.find('=') + 1, body.size() - body.find('=') - 2));
+        };
+        ASSERT(field([&] { builder.add_price(44, to_fixed_price(50000.25)); }) == "50000.25");
+        ASSERT(field([&] { builder.add_price(44, -150000000); }) == "-1.5");
+        ASSERT(field([&] { builder.add_price(44, 0); }) == "0");
+        ASSERT(field([&] { builder.add_price(44, 1); }) == "0.00000001");
+        ASSERT(field([&] { builder.add_field(38, static_cast<std::int64_t>(-9876543210)); }) == "-9876543210");
+        ASSERT(field([&] { builder.add_field(38, static_cast<std::int64_t>(0)); }) == "0");
+        ASSERT(field([&] { builder.add_field(44, 123.456, 2); }) == "123.46");
+        ASSERT(field([&] { builder.add_field(44, -0.25, 4); }) == "-0.2500");
+        ASSERT(field([&] { builder.add_field(44, 7.0, 0); }) == "7");
+        
+        ExecutionReport report{};
+        report.order_id = 555;
+        report.exec_type = ExecutionType::TRADE;
+        report.order_status = OrderStatus::PARTIALLY_FILLED;
+        report.side = Side::SELL;
+        report.execution_quantity = 40;
+        report.execution_price = to_fixed_price(2999.5);
+        report.leaves_quantity = 60;
+        report.cumulative_quantity = 40;
+        
+        FixSessionHeader session("EXCHANGE", "GATEWAY");
+        auto wire = execution_report_to_fix(builder, session, report, 77);
+        FixMessage parsed;
+        ASSERT(parsed.parse(wire));
+        ASSERT(parsed.verify_checksum());
+        ASSERT(parsed.verify_body_length());
+        ASSERT(*parsed.get_field(fix_tag::OrdStatus) == "1");
+        
+        auto decoded = fix_to_execution_report(parsed);
+        ASSERT(decoded.has_value());
+        ASSERT(decoded->order_id == 555);
+        ASSERT(decoded->exec_type == ExecutionType::TRADE);
+        ASSERT(decoded->side == Side::SELL);
+        ASSERT(decoded->execution_quantity == 40);
+        ASSERT(decoded->execution_price == report.execution_price);
+        ASSERT(decoded->leaves_quantity == 60);
+        ASSERT(decoded->cumulative_quantity == 40);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 13: NewOrderSingle round trip carries the symbol
+    {
+        std::cout << "  NewOrderSingle round trip... ";
+        
+        const Order order(42, Side::BUY, OrderType::LIMIT, to_fixed_price(101.25), 300);
+        const Symbol symbol = make_symbol("ETH-USD");
+        
+        FixMessage parsed;
+        const std::string owned = order_to_fix(order, symbol, "GATEWAY", "EXCHANGE", 3);
+        ASSERT(parsed.parse(owned));
+        ASSERT(parsed.verify_checksum());
+        ASSERT(*parsed.get_field(fix_tag::Symbol) == "ETH-USD");
+        
+        std::array<char, 512> storage;
+        FixMessageBuilder builder(storage);
+        FixSessionHeader session("GATEWAY", "EXCHANGE");
+        ASSERT(parsed.parse(order_to_fix(builder, session, order, symbol, 4)));
+        ASSERT(parsed.verify_checksum() && parsed.verify_body_length());
+        ASSERT(parsed.msg_type() == fix_msgtype::NewOrderSingle);
+        ASSERT(*parsed.get_field(fix_tag::Symbol) == "ETH-USD");
+        ASSERT(parsed.get_int(fix_tag::ClOrdID) == 42);
+        ASSERT(parsed.get_int(fix_tag::OrderQty) == 300);
+        ASSERT(*parsed.get_field(fix_tag::Side) == "1");
+        
+        std::cout << "PASSED\n";
+    }
+    
     std::cout << "  All FIX parser tests passed!\n";
 }
 
@@ -0,0 +1,52 @@
+/**
+ * @file test_hdr_histogram.cpp
+ * @brief HDR histogram unit tests
+ */
+
+#include <cstdint>
+#include <iostream>
+#include "core/hdr_histogram.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_hdr_histogram_tests() {
+    std::cout << "\n=== HDR Histogram Tests ===\n";
+    
+    // Test 1: HDR histogram percentiles and merge
+    {
+        std::cout << "  HDR histogram... ";
+        
+        HdrHistogram<2> low, high;
+        for (std::int64_t v = 1; v <= 1000; ++v) low.record(v);
+        for (std::int64_t v = 1001; v <= 2000; ++v) high.record(v * 1000);
+        low.record(-5);                                  // clamps to 0
+        
+        ASSERT(low.count() == 1001);
+        ASSERT(low.min() == 0);
+        ASSERT(low.max() == 1000);
+        // Within 1% and never below the exact value
+        const auto p50 = low.value_at_percentile(50.0);
+        ASSERT(p50 >= 500 && p50 <= 505);
+        ASSERT(low.value_at_percentile(100.0) == 1000);
+        
+        low.merge(high);
+        ASSERT(low.count() == 2001);
+        ASSERT(low.max() == 2'000'000);
+        const auto p99 = low.value_at_percentile(99.0);
+        ASSERT(p99 >= 1'980'000 && p99 <= 1'980'000 + HdrHistogram<2>::bucket_width(1'980'000));
+        
+        std::uint64_t total = 0;
+        low.for_each_bucket([&](std::int64_t, std::uint64_t count) { total += count; });
+        ASSERT(total == 2001);
+        
+        low.reset();
+        ASSERT(low.empty() && low.value_at_percentile(50.0) == 0);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All HDR histogram tests passed!\n";
+}
@@ -0,0 +1,283 @@
+/**
+ * @file test_journal.cpp
+ * @brief Engine journal, snapshot and recovery unit tests
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "matching/engine_journal.hpp"
+
+#ifdef __linux__
+#include <csignal>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+namespace {
+
+void add_instruments(MatchingEngine& engine) {
+    engine.add_instrument(make_symbol("BTC-USD"));
+    engine.add_instrument(make_symbol("ETH-USD"));
+}
+
+/**
+ * @brief Resting orders of every book, in priority order
+ */
+std::vector<std::pair<OrderId, Quantity>> resting(const MatchingEngine& engine) {
+    std::vector<std::pair<OrderId, Quantity>> orders;
+    for (InstrumentId id = 0; id < engine.instrument_count(); ++id) {
+        engine.get_book(id)->for_each_order([&](const Order& order) {
+            orders.emplace_back(order.order_id, order.remaining_quantity());
+        });
+    }
+    return orders;
+}
+
+JournalConfig small_journal(const std::string& path) {
+    JournalConfig config;
+    config.path = path;
+    config.initial_size = 64 * sizeof(JournalRecord);    // Forces the file to grow
+    return config;
+}
+
+} // namespace
+
+void run_journal_tests() {
+    std::cout << "\n=== Engine Journal Tests ===\n";
+
+    #ifdef __linux__
+    const std::string base = "/tmp/hft_journal_test_" + std::to_string(getpid());
+    const std::string journal_path = base + ".journal";
+    const std::string snapshot_path = base + ".snapshot";
+    std::remove(journal_path.c_str());
+    std::remove(snapshot_path.c_str());
+
+    const Price px = to_fixed_price(100.0);
+    std::vector<std::pair<OrderId, Quantity>> expected;
+    OrderId expected_next = 0;
+
+    // Test 1: Journal replay rebuilds books and order IDs
+    {
+        std::cout << "  Journal replay... ";
+
+        MatchingEngine engine;
+        add_instruments(engine);
+        EngineJournal journal;
+        ASSERT(journal.open(small_journal(journal_path)));
+        journal.start();
+
+        const auto btc = make_symbol("BTC-USD");
+        for (int i = 0; i < 100; ++i) {
+            ASSERT(journal.process(engine, OrderRequest::make_new(btc, Side::BUY, OrderType::LIMIT,
+                                                                  px - i % 5, 10)) != INVALID_ORDER_ID);
+        }
+        ASSERT(journal.process(engine, OrderRequest::make_new(InstrumentId{1}, Side::SELL,
+                                                              OrderType::LIMIT, px, 7)) != INVALID_ORDER_ID);
+        ASSERT(journal.process(engine, OrderRequest::make_new(btc, Side::SELL, OrderType::MARKET,
+                                                              0, 25)) != INVALID_ORDER_ID);
+        ASSERT(journal.process(engine, OrderRequest::make_cancel(btc, 10)) == 10);
+        ASSERT(journal.last_sequence() == 103);
+
+        journal.stop();
+        ASSERT(journal.durable_sequence() == 103);
+        ASSERT(journal.stats().syncs > 0 && journal.stats().write_errors == 0);
+        journal.close();
+
+        expected = resting(engine);
+        expected_next = engine.next_order_id();
+
+        MatchingEngine restarted;
+        add_instruments(restarted);
+        EngineJournal reopened;
+        ASSERT(reopened.open(small_journal(journal_path)));
+        ASSERT(reopened.last_sequence() == 103);
+        auto result = reopened.recover(restarted, snapshot_path);
+        ASSERT(result && !result->snapshot_loaded && result->records_replayed == 103);
+        ASSERT(resting(restarted) == expected);
+        ASSERT(restarted.next_order_id() == expected_next);
+        const OrderBook* book = restarted.get_book(InstrumentId{0});
+        ASSERT(!book->get_order(1) && !book->get_order(10));      // Filled, cancelled
+        ASSERT(book->get_order(11)->remaining_quantity() == 5);
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 2: Snapshot plus journal tail, with time priority kept
+    {
+        std::cout << "  Snapshot and tail... ";
+
+        MatchingEngine engine;
+        add_instruments(engine);
+        EngineJournal journal;
+        ASSERT(journal.open(small_journal(journal_path)));
+        ASSERT(journal.recover(engine, snapshot_path));
+        journal.start();
+
+        journal.snapshot(engine, snapshot_path);
+        const auto eth = make_symbol("ETH-USD");
+        OrderId first = journal.process(engine, OrderRequest::make_new(eth, Side::SELL,
+                                                                       OrderType::LIMIT, px, 5));
+        OrderId second = journal.process(engine, OrderRequest::make_new(eth, Side::SELL,
+                                                                        OrderType::LIMIT, px, 6));
+        ASSERT(first != INVALID_ORDER_ID && second != INVALID_ORDER_ID);
+        journal.stop();
+        ASSERT(journal.snapshots_written() == 1);
+        journal.close();
+        expected = resting(engine);
+        expected_next = engine.next_order_id();
+
+        MatchingEngine restarted;
+        add_instruments(restarted);
+        EngineJournal reopened;
+        ASSERT(reopened.open(small_journal(journal_path)));
+        auto result = reopened.recover(restarted, snapshot_path);
+        ASSERT(result && result->snapshot_loaded);
+        ASSERT(result->snapshot_sequence == 103 && result->records_replayed == 2);
+        ASSERT(result->orders_restored == expected.size() - 2);
+        ASSERT(resting(restarted) == expected);
+        ASSERT(restarted.next_order_id() == expected_next);
+
+        // The restored queue at the ask fills oldest first
+        std::vector<OrderId> filled;
+        restarted.submit_order(eth, Side::BUY, OrderType::LIMIT, px, 8, 0,
+                               [&](const ExecutionReport& r) {
+                                   if (r.exec_type == ExecutionType::TRADE && r.side == Side::SELL) {
+                                       filled.push_back(r.order_id);
+                                   }
+                               });
+        ASSERT(filled.size() == 2 && filled[1] == first);
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 3: A torn tail record ends the journal; a bad snapshot is refused
+    {
+        std::cout << "  Torn tail... ";
+
+        const off_t last = 4096 + 104 * static_cast<off_t>(sizeof(JournalRecord));
+        int fd = ::open(journal_path.c_str(), O_RDWR);
+        ASSERT(fd >= 0);
+        const char junk[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+        ASSERT(pwrite(fd, junk, sizeof(junk), last + 40) == static_cast<ssize_t>(sizeof(junk)));
+        ::close(fd);
+
+        EngineJournal journal;
+        ASSERT(journal.open(small_journal(journal_path)));
+        ASSERT(journal.last_sequence() == 104);
+        journal.close();
+
+        fd = ::open(snapshot_path.c_str(), O_RDWR);
+        ASSERT(fd >= 0);
+        ASSERT(pwrite(fd, junk, sizeof(junk), 64) == static_cast<ssize_t>(sizeof(junk)));
+        ::close(fd);
+
+        MatchingEngine engine;
+        add_instruments(engine);
+        ASSERT(journal.open(small_journal(journal_path)));
+        ASSERT(!journal.recover(engine, snapshot_path));
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 4: A snapshot requested with records still queued waits for them
+    {
+        std::cout << "  Snapshot with queued records... ";
+        std::remove(journal_path.c_str());
+        std::remove(snapshot_path.c_str());
+
+        // Nothing drains before start(): the journal thread finds the
+        // snapshot pending ahead of all 100 records
+        MatchingEngine engine;
+        add_instruments(engine);
+        EngineJournal journal;
+        ASSERT(journal.open(small_journal(journal_path)));
+        const auto btc = make_symbol("BTC-USD");
+        for (int i = 0; i < 100; ++i) {
+            ASSERT(journal.process(engine, OrderRequest::make_new(btc, Side::BUY, OrderType::LIMIT,
+                                                                  px - i, 1)) != INVALID_ORDER_ID);
+        }
+        journal.snapshot(engine, snapshot_path);
+        journal.start();
+        journal.stop();
+        ASSERT(journal.snapshots_written() == 1 && journal.stats().snapshots_skipped == 0);
+        journal.close();
+
+        MatchingEngine restarted;
+        add_instruments(restarted);
+        EngineJournal reopened;
+        ASSERT(reopened.open(small_journal(journal_path)));
+        auto result = reopened.recover(restarted, snapshot_path);
+        ASSERT(result && result->snapshot_sequence == 100 && result->records_replayed == 0);
+        ASSERT(resting(restarted) == resting(engine));
+        reopened.close();
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 5: A record that cannot be stored fails the journal
+    {
+        std::cout << "  Write failure... ";
+        std::remove(journal_path.c_str());
+        std::remove(snapshot_path.c_str());
+
+        MatchingEngine engine;
+        add_instruments(engine);
+        EngineJournal journal;
+        ASSERT(journal.open(small_journal(journal_path)));
+
+        // Cap the file size so the journal cannot grow past 64 records
+        rlimit saved{};
+        ASSERT(getrlimit(RLIMIT_FSIZE, &saved) == 0);
+        auto saved_handler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit capped = saved;
+        capped.rlim_cur = 4096 + 64 * sizeof(JournalRecord);
+        ASSERT(setrlimit(RLIMIT_FSIZE, &capped) == 0);
+
+        const auto btc = make_symbol("BTC-USD");
+        for (int i = 0; i < 70; ++i) {
+            ASSERT(journal.process(engine, OrderRequest::make_new(btc, Side::BUY, OrderType::LIMIT,
+                                                                  px - i, 1)) != INVALID_ORDER_ID);
+        }
+        journal.snapshot(engine, snapshot_path);
+        journal.start();
+        journal.stop();
+        setrlimit(RLIMIT_FSIZE, &saved);
+        std::signal(SIGXFSZ, saved_handler);
+
+        // Nothing past the gap is stored, and nothing new is accepted
+        ASSERT(journal.failed() && journal.durable_sequence() == 64);
+        ASSERT(journal.stats().records_lost == 6 && journal.stats().snapshots_skipped == 1);
+        ASSERT(journal.snapshots_written() == 0);
+        ASSERT(journal.process(engine, OrderRequest::make_cancel(btc, 1)) == INVALID_ORDER_ID);
+        ASSERT(journal.stats().rejected_failed == 1);
+        journal.close();
+
+        MatchingEngine restarted;
+        add_instruments(restarted);
+        EngineJournal reopened;
+        ASSERT(reopened.open(small_journal(journal_path)));
+        ASSERT(reopened.last_sequence() == 64 && !reopened.failed());
+        auto result = reopened.recover(restarted, snapshot_path);
+        ASSERT(result && !result->snapshot_loaded && result->records_replayed == 64);
+        reopened.close();
+
+        std::cout << "PASSED\n";
+    }
+
+    std::remove(journal_path.c_str());
+    std::remove(snapshot_path.c_str());
+    std::remove((snapshot_path + ".tmp").c_str());
+    #else
+    std::cout << "  Journal... SKIPPED\n";
+    #endif
+
+    std::cout << "  All journal tests passed!\n";
+}
@@ -0,0 +1,70 @@
+/**
+ * @file test_load_generator.cpp
+ * @brief Open-loop load generator unit tests
+ */
+
+#include <algorithm>
+#include <iostream>
+#include "core/load_generator.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_load_generator_tests() {
+    std::cout << "\n=== Load Generator Tests ===\n";
+    
+    // Test 1: Open-loop schedules, latency charged from the intended time
+    {
+        std::cout << "  Open-loop load driver... ";
+        
+        auto constant = ArrivalSchedule::constant(1'000'000.0);
+        ASSERT(constant.next() == 0 && constant.next() == 1000 && constant.next() == 2000);
+        
+        auto poisson = ArrivalSchedule::poisson(1'000'000.0, 7);
+        Duration last = poisson.next();
+        ASSERT(last == 0);
+        for (int i = 1; i < 100000; ++i) {
+            const Duration offset = poisson.next();
+            ASSERT(offset >= last);
+            last = offset;
+        }
+        // Mean gap 1 us: within a few percent over 100k arrivals
+        ASSERT(last > 95'000'000 && last < 105'000'000);
+        
+        auto replay = ArrivalSchedule::replay({5000, 5100, 7000}, 2.0);
+        ASSERT(replay.next() == 0 && replay.next() == 50 && replay.next() == 1000);
+        ASSERT(replay.next() == ArrivalSchedule::END);
+        ASSERT(replay.pattern() == ArrivalPattern::REPLAY);
+        
+        // Ten 100 us sends from a schedule anchored 1 s ago: each is due at
+        // once, stamped with its intended slot and counted late
+        OpenLoopDriver driver(ArrivalSchedule::constant(10'000.0));
+        const Timestamp origin = fast_now() - 1'000'000'000;
+        driver.start(origin);
+        
+        // A 2 ms stall on the first send on a 1 us server: the closed-loop
+        // (service) number sees it once, the corrected one on every send queued behind it
+        Timestamp busy_until = 0;
+        for (int i = 0; i < 10; ++i) {
+            const Timestamp intended = driver.wait_next();
+            ASSERT(intended == origin + i * 100'000);
+            const Timestamp sent = std::max(intended, busy_until);
+            busy_until = sent + (i == 0 ? 2'000'000 : 1'000);
+            driver.record(intended, sent, busy_until);
+        }
+        ASSERT(driver.late() == 10 && driver.max_lag_ns() >= 1'000'000'000 - 900'000);
+        ASSERT(driver.corrected().count() == 10 && driver.service().count() == 10);
+        ASSERT(driver.service().max() >= 2'000'000.0 && driver.service().median() < 1'100.0);
+        ASSERT(driver.corrected().min() >= 1'100'000.0);     // Last send: 2.009 ms - 900 us
+        
+        OpenLoopDriver finite(ArrivalSchedule::replay({0}));
+        finite.start();
+        ASSERT(finite.wait_next() != 0 && finite.wait_next() == 0);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All load generator tests passed!\n";
+}
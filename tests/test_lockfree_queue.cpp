@@ -3,7 +3,10 @@
  * @brief Lock-free queue unit tests
  */
 
+#include <atomic>
 #include <iostream>
+#include <span>
+#include <string>
 #include <thread>
 #include <vector>
 #include "core/lockfree_queue.hpp"
@@ -126,6 +129,149 @@ void run_lockfree_queue_tests() {
         std::cout << "PASSED\n";
     }
     
+    // Test 6: SPSC bulk push/pop and consume_all
+    {
+        std::cout << "  SPSC bulk operations... ";
+        SPSCQueue<int, 8> queue;  // 7 usable slots
+        
+        int in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        ASSERT(queue.try_push_bulk(std::span<const int>(in, 10)) == 7);
+        ASSERT(queue.try_push_bulk(std::span<const int>(in, 1)) == 0);
+        
+        int out[4] = {};
+        ASSERT(queue.try_pop_bulk(std::span<int>(out, 4)) == 4);
+        ASSERT(out[0] == 0 && out[3] == 3);
+        
+        // Wrap around the ring
+        ASSERT(queue.try_push_bulk(std::span<const int>(in + 7, 3)) == 3);
+        ASSERT(queue.size() == 6);
+        
+        std::vector<int> seen;
+        ASSERT(queue.consume_all([&](int& v) { seen.push_back(v); }) == 6);
+        ASSERT(seen.size() == 6 && seen[0] == 4 && seen[5] == 9);
+        ASSERT(queue.empty());
+        ASSERT(queue.consume_all([&](int&) { ASSERT(false); }) == 0);
+        ASSERT(queue.try_pop_bulk(std::span<int>(out, 4)) == 0);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 7: SPSC bulk multi-threaded ordering
+    {
+        std::cout << "  SPSC bulk multi-threaded... ";
+        constexpr std::uint64_t N = 50'000;
+        SPSCQueue<std::uint64_t, 1024> queue;
+        
+        std::thread producer([&]() {
+            std::uint64_t batch[16];
+            for (std::uint64_t i = 0; i < N; ) {
+                std::size_t n = 0;
+                while (n < 16 && i + n < N) { batch[n] = i + n; ++n; }
+                std::size_t done = 0;
+                while (done < n) {
+                    done += queue.try_push_bulk(std::span<const std::uint64_t>(batch + done, n - done));
+                }
+                i += n;
+            }
+        });
+        
+        std::uint64_t expected = 0;
+        bool ordered = true;
+        while (expected < N) {
+            queue.consume_all([&](std::uint64_t& v) {
+                if (v != expected) ordered = false;
+                ++expected;
+            });
+        }
+        producer.join();
+        
+        ASSERT(ordered);
+        ASSERT(queue.empty());
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 8: MPMC basic and batch operations
+    {
+        std::cout << "  MPMC batch operations... ";
+        MPMCQueue<int, 8> queue;
+        
+        ASSERT(queue.empty());
+        ASSERT(queue.try_push(1));
+        ASSERT(queue.try_pop() == 1);
+        ASSERT(!queue.try_pop().has_value());
+        
+        int in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        ASSERT(queue.try_push_n(in, 10) == 8);  // Clipped to capacity
+        ASSERT(!queue.try_push(99));
+        ASSERT(queue.try_push_n(in, 1) == 0);
+        
+        int out[8] = {};
+        ASSERT(queue.try_pop_n(out, 3) == 3);
+        ASSERT(out[0] == 0 && out[2] == 2);
+        ASSERT(queue.try_push_n(in + 8, 2) == 2);  // Wraps around the ring
+        ASSERT(queue.try_pop_n(out, 8) == 7);
+        ASSERT(out[0] == 3 && out[4] == 7 && out[6] == 9);
+        ASSERT(queue.try_pop_n(out, 8) == 0);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 9: MPMC multi-producer/multi-consumer
+    {
+        std::cout << "  MPMC multi-threaded... ";
+        constexpr int PRODUCERS = 3;
+        constexpr int CONSUMERS = 2;
+        constexpr std::uint64_t PER_PRODUCER = 50'000;
+        
+        MPMCQueue<std::uint64_t, 1024> queue;
+        std::atomic<std::uint64_t> sum{0};
+        std::atomic<std::uint64_t> popped{0};
+        
+        std::vector<std::thread> threads;
+        for (int p = 0; p < PRODUCERS; ++p) {
+            threads.emplace_back([&, p]() {
+                std::uint64_t batch[4];
+                for (std::uint64_t i = 1; i <= PER_PRODUCER; ) {
+                    if (p == 0) {
+                        queue.push(i++);
+                        continue;
+                    }
+                    // Other producers push in batches
+                    std::size_t n = 0;
+                    while (n < 4 && i + n <= PER_PRODUCER) { batch[n] = i + n; ++n; }
+                    std::size_t done = 0;
+                    while (done < n) done += queue.try_push_n(batch + done, n - done);
+                    i += n;
+                }
+            });
+        }
+        for (int c = 0; c < CONSUMERS; ++c) {
+            threads.emplace_back([&, c]() {
+                std::uint64_t batch[8];
+                while (popped.load() < PRODUCERS * PER_PRODUCER) {
+                    if (c == 0) {
+                        if (auto v = queue.try_pop()) {
+                            sum += *v;
+                            ++popped;
+                        }
+                    } else {
+                        std::size_t n = queue.try_pop_n(batch, 8);
+                        for (std::size_t k = 0; k < n; ++k) sum += batch[k];
+                        popped += n;
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        
+        ASSERT(popped.load() == PRODUCERS * PER_PRODUCER);
+        ASSERT(sum.load() == PRODUCERS * (PER_PRODUCER * (PER_PRODUCER + 1) / 2));
+        ASSERT(queue.empty());
+        
+        std::cout << "PASSED\n";
+    }
+    
     std::cout << "  All lock-free queue tests passed!\n";
 }
 
@@ -29,9 +29,31 @@
 // Forward declarations
 void run_lockfree_queue_tests();
 void run_memory_pool_tests();
+void run_reactor_tests();
 void run_order_book_tests();
 void run_matching_engine_tests();
+void run_journal_tests();
 void run_fix_parser_tests();
+void run_binary_codec_tests();
+void run_risk_tests();
+void run_rest_handler_tests();
+void run_websocket_tests();
+void run_transport_tests();
+void run_seqlock_tests();
+void run_hdr_histogram_tests();
+void run_timing_tests();
+void run_market_data_tests();
+void run_busy_poll_tests();
+void run_pipeline_tests();
+void run_perf_counters_tests();
+void run_load_generator_tests();
+void run_strategy_tests();
+void run_cpu_topology_tests();
+void run_exchange_simulator_tests();
+void run_rcu_tests();
+void run_consolidated_book_tests();
+void run_market_data_capture_tests();
+void run_tsc_clock_tests();
 
 int main() {
     std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
@@ -41,9 +63,31 @@ int main() {
     try {
         run_lockfree_queue_tests();
         run_memory_pool_tests();
+        run_reactor_tests();
         run_order_book_tests();
         run_matching_engine_tests();
+        run_journal_tests();
         run_fix_parser_tests();
+        run_binary_codec_tests();
+        run_risk_tests();
+        run_rest_handler_tests();
+        run_websocket_tests();
+        run_transport_tests();
+        run_seqlock_tests();
+        run_hdr_histogram_tests();
+        run_timing_tests();
+        run_market_data_tests();
+        run_busy_poll_tests();
+        run_pipeline_tests();
+        run_perf_counters_tests();
+        run_load_generator_tests();
+        run_strategy_tests();
+        run_cpu_topology_tests();
+        run_exchange_simulator_tests();
+        run_rcu_tests();
+        run_consolidated_book_tests();
+        run_market_data_capture_tests();
+        run_tsc_clock_tests();
     } catch (const std::exception& e) {
         std::cerr << "Test suite error: " << e.what() << "\n";
         return 1;
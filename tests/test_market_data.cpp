@@ -0,0 +1,142 @@
+/**
+ * @file test_market_data.cpp
+ * @brief Market data handler unit tests
+ */
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "marketdata/market_data_handler.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_market_data_tests() {
+    std::cout << "\n=== Market Data Tests ===\n";
+    
+    // Test 1: Conflated channel keeps the latest quote, every trade
+    {
+        std::cout << "  Conflated market data channel... ";
+        
+        MarketDataHandler handler;
+        const Symbol btc = make_symbol("BTC-USD");
+        const Symbol eth = make_symbol("ETH-USD");
+        handler.subscribe(btc);
+        handler.subscribe(eth);
+        auto& queued = handler.add_channel(MarketDataChannel::Mode::QUEUED);
+        auto& conflated = handler.add_channel(MarketDataChannel::Mode::CONFLATED);
+        
+        for (Price px = 1; px <= 100; ++px) {
+            handler.on_update(MarketDataUpdate::make_quote(btc, px, 10, px + 1, 10));
+            handler.on_update(MarketDataUpdate::make_quote(eth, px * 2, 5, px * 2 + 1, 5));
+        }
+        handler.on_update(MarketDataUpdate::make_trade(btc, 100, 3, Side::BUY));
+        handler.on_update(MarketDataUpdate::make_trade(btc, 101, 4, Side::SELL));
+        
+        ASSERT(queued.poll([](const MarketDataUpdate&) {}) == 202);
+        
+        std::vector<MarketDataUpdate> seen;
+        ASSERT(conflated.poll([&](const MarketDataUpdate& u) { seen.push_back(u); }) == 4);
+        ASSERT(seen[0].type == MarketDataType::TRADE && seen[0].data.trade.quantity == 3);
+        ASSERT(seen[1].type == MarketDataType::TRADE && seen[1].data.trade.quantity == 4);
+        ASSERT(seen[2].symbol == btc && seen[2].data.quote.bid_price == 100);
+        ASSERT(seen[3].symbol == eth && seen[3].data.quote.bid_price == 200);
+        ASSERT(conflated.conflated() == 198 && conflated.dropped() == 0);
+        ASSERT(conflated.poll([](const MarketDataUpdate&) {}) == 0);
+        
+        // Threaded: every quote delivered is consistent and never older than the last
+        constexpr Price LAST = 200000;
+        std::atomic<bool> done{false};
+        bool consistent = true;
+        Price newest = 0;
+        std::thread consumer([&]() {
+            auto check = [&](const MarketDataUpdate& u) {
+                consistent &= u.data.quote.ask_price == u.data.quote.bid_price + 1 &&
+                              u.data.quote.bid_price >= newest;
+                newest = u.data.quote.bid_price;
+            };
+            while (!done.load(std::memory_order_acquire)) {
+                conflated.poll(check);
+            }
+            conflated.poll(check);
+        });
+        for (Price px = 101; px <= LAST; ++px) {
+            handler.on_update(MarketDataUpdate::make_quote(btc, px, 10, px + 1, 10));
+        }
+        done.store(true, std::memory_order_release);
+        consumer.join();
+        ASSERT(consistent);
+        ASSERT(newest == LAST);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 2: Quote cache by interned ID, read while the feed writes it
+    {
+        std::cout << "  Seqlock quote cache... ";
+        
+        MarketDataHandler handler;
+        const Symbol btc = make_symbol("BTC-USD");
+        const Symbol eth = make_symbol("ETH-USD");
+        const InstrumentId btc_id = handler.subscribe(btc);
+        const InstrumentId eth_id = handler.subscribe(eth);
+        ASSERT(btc_id != eth_id && handler.find_symbol(btc) == btc_id);
+        ASSERT(!handler.find_symbol(make_symbol("SOL-USD")));
+        
+        // Nothing to read before the first quote, or past the table
+        Quote quote;
+        ASSERT(!handler.read_quote(btc_id, quote) && !handler.get_quote(btc));
+        ASSERT(!handler.read_quote(MarketDataHandler::MAX_SYMBOLS, quote));
+        handler.on_update(MarketDataUpdate::make_quote(btc, 100, 3, 101, 4));
+        ASSERT(handler.read_quote(btc_id, quote) && quote.bid_price == 100 && quote.ask_quantity == 4);
+        ASSERT(!handler.read_quote(eth_id, quote));
+        
+        // The ID survives unsubscribe / resubscribe; the last quote stays readable
+        handler.unsubscribe(btc);
+        ASSERT(handler.subscription_count() == 1);
+        handler.on_update(MarketDataUpdate::make_quote(btc, 200, 3, 201, 4));
+        ASSERT(handler.read_quote(btc_id, quote) && quote.bid_price == 100);
+        ASSERT(handler.subscribe(btc) == btc_id && handler.subscription_count() == 2);
+        
+        // MAX_SYMBOLS distinct symbols fill the table; known ones still resolve
+        for (std::size_t i = 2; i < MarketDataHandler::MAX_SYMBOLS; ++i) {
+            ASSERT(handler.subscribe(make_symbol("SYM-" + std::to_string(i))) == i);
+        }
+        ASSERT(handler.subscribe(make_symbol("ONE-MORE")) == INVALID_INSTRUMENT_ID);
+        ASSERT(!handler.find_symbol(make_symbol("ONE-MORE")));
+        ASSERT(handler.subscribe(eth) == eth_id);
+        
+        // Threaded: a slot read mid-rewrite is retried, never torn, never older
+        constexpr Price LAST = 200000;
+        std::atomic<bool> done{false};
+        std::atomic<std::uint64_t> reads{0};
+        bool consistent = true;
+        Price newest = 0;
+        std::thread reader([&]() {
+            Quote q;
+            while (!done.load(std::memory_order_acquire)) {
+                if (!handler.read_quote(btc_id, q)) continue;
+                consistent &= q.ask_price == q.bid_price + 1 && q.bid_quantity == q.bid_price * 2 &&
+                              q.ask_quantity == q.bid_price * 3 && q.bid_price >= newest;
+                newest = q.bid_price;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        Price px = 101;
+        for (; px <= LAST || reads.load(std::memory_order_relaxed) < 1000; ++px) {
+            handler.on_update(MarketDataUpdate::make_quote(btc, px, px * 2, px + 1, px * 3));
+        }
+        done.store(true, std::memory_order_release);
+        reader.join();
+        ASSERT(consistent);
+        ASSERT(handler.read_quote(btc_id, quote) && quote.bid_price == px - 1);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All market data tests passed!\n";
+}
@@ -0,0 +1,87 @@
+/**
+ * @file test_market_data_capture.cpp
+ * @brief Market data capture and replay unit tests
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "marketdata/market_data_capture.hpp"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_market_data_capture_tests() {
+    std::cout << "\n=== Market Data Capture Tests ===\n";
+
+    #ifdef __linux__
+    // Test 1: Captured ticks and orders replay in order, in place and paced
+    {
+        std::cout << "  Capture replay... ";
+
+        const std::string capture_path = "/tmp/hft_capture_test_" + std::to_string(getpid()) + ".capture";
+        const Price px = to_fixed_price(100.0);
+        MarketDataCapture capture;
+        ASSERT(capture.open(capture_path, 16));
+        capture.start();
+        const Timestamp t0 = 1'000'000'000;
+        for (std::uint64_t i = 0; i < 100; ++i) {
+            Tick tick{};
+            tick.symbol = make_symbol(i % 2 ? "ETH-USD" : "BTC-USD");
+            tick.bid_price = px + static_cast<Price>(i);
+            tick.ask_price = tick.bid_price + 1;
+            tick.bid_size = 10;
+            tick.ask_size = 20;
+            tick.sequence = i;
+            ASSERT(capture.log(capture_tick(tick, t0 + static_cast<Timestamp>(i) * 20'000)));   // 2 ms in all
+            if (i % 10 == 0) {
+                ASSERT(capture.log(capture_order(i, tick.symbol, Side::BUY, OrderType::LIMIT, px, 5,
+                                                 t0 + static_cast<Timestamp>(i) * 20'000)));
+            }
+        }
+        capture.close();
+        ASSERT(capture.records_written() == 110 && capture.records_dropped() == 0);
+
+        CaptureReplay replay;
+        ASSERT(replay.open(capture_path));
+        ASSERT(replay.size() == 110);
+        ASSERT(replay.symbols().size() == 2);
+
+        // Unpaced: every tick in order, pointing into the mapping
+        replay.start(0.0);
+        std::uint64_t next = 0;
+        while (const CaptureRecord* record = replay.next({CaptureKind::TICK})) {
+            ASSERT(record >= replay.records().data() && record < replay.records().data() + replay.size());
+            const Tick tick = to_tick(*record);
+            ASSERT(tick.sequence == next && tick.bid_price == px + static_cast<Price>(next));
+            ASSERT(tick.ask_size == 20);
+            ++next;
+        }
+        ASSERT(next == 100);
+
+        // Recorded pacing at 2x: orders only, 1.8 ms of gaps take at least 0.9 ms
+        const Timestamp started = fast_now();
+        replay.start(2.0);
+        std::size_t orders = 0;
+        while (const CaptureRecord* record = replay.next({CaptureKind::ORDER})) {
+            ASSERT(record->side == Side::BUY && record->bid_size == 5);
+            ++orders;
+        }
+        ASSERT(orders == 10);
+        ASSERT(fast_now() - started >= 900'000);
+
+        std::remove(capture_path.c_str());
+        std::cout << "PASSED\n";
+    }
+    #else
+    std::cout << "  Capture replay... SKIPPED\n";
+    #endif
+
+    std::cout << "  All market data capture tests passed!\n";
+}
@@ -3,8 +3,13 @@
  * @brief Matching engine unit tests
  */
 
+#include <array>
 #include <iostream>
+#include <span>
+#include <thread>
+#include <vector>
 #include "matching/matching_engine.hpp"
+#include "matching/sharded_matching_engine.hpp"
 
 using namespace hft;
 
@@ -186,6 +191,190 @@ void run_matching_engine_tests() {
         std::cout << "PASSED\n";
     }
     
+    // Test 8: Per-call sink bypasses engine callback
+    {
+        std::cout << "  Per-call execution sink... ";
+        MatchingEngine engine;
+        auto symbol = make_symbol("BTC-USD");
+        engine.add_instrument(symbol);
+        
+        int callback_reports = 0;
+        engine.set_execution_callback([&](const ExecutionReport&) { ++callback_reports; });
+        
+        int sink_trades = 0;
+        auto sink = [&](const ExecutionReport& r) {
+            if (r.exec_type == ExecutionType::TRADE) ++sink_trades;
+        };
+        
+        engine.submit_order(symbol, Side::BUY, OrderType::LIMIT, to_fixed_price(100.0), 10);
+        ASSERT(callback_reports == 1);
+        
+        auto sell_id = engine.submit_order(symbol, Side::SELL, OrderType::LIMIT,
+                                           to_fixed_price(100.0), 10, 0, sink);
+        ASSERT(sell_id != INVALID_ORDER_ID);
+        ASSERT(sink_trades == 2);
+        ASSERT(callback_reports == 1);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 9: Instrument handles
+    {
+        std::cout << "  Instrument handles... ";
+        MatchingEngine engine;
+        auto btc = make_symbol("BTC-USD");
+        auto eth = make_symbol("ETH-USD");
+        
+        auto btc_id = engine.add_instrument(btc);
+        auto eth_id = engine.add_instrument(eth);
+        ASSERT(btc_id.has_value() && eth_id.has_value());
+        ASSERT(*btc_id != *eth_id);
+        ASSERT(engine.find_instrument(eth) == eth_id);
+        ASSERT(!engine.find_instrument(make_symbol("INVALID")).has_value());
+        ASSERT(engine.get_book(*btc_id) == engine.get_book(btc));
+        ASSERT(engine.get_book(INVALID_INSTRUMENT_ID) == nullptr);
+        
+        auto bid_id = engine.submit_order(*eth_id, Side::BUY, OrderType::LIMIT,
+                                          to_fixed_price(3000.0), 10);
+        ASSERT(bid_id != INVALID_ORDER_ID);
+        ASSERT(engine.get_book(eth)->best_bid() == to_fixed_price(3000.0));
+        ASSERT(engine.get_book(btc)->empty());
+        ASSERT(engine.submit_order(INVALID_INSTRUMENT_ID, Side::BUY, OrderType::LIMIT,
+                                   to_fixed_price(1.0), 1) == INVALID_ORDER_ID);
+        
+        // Requests carrying a handle skip the symbol lookup
+        auto ask = OrderRequest::make_new(*eth_id, Side::SELL, OrderType::LIMIT,
+                                          to_fixed_price(3001.0), 5);
+        ASSERT(engine.process_request(ask) != INVALID_ORDER_ID);
+        ASSERT(engine.get_quote(*eth_id)->ask_price == to_fixed_price(3001.0));
+        
+        ASSERT(engine.process_request(OrderRequest::make_cancel(*eth_id, bid_id)) == bid_id);
+        ASSERT(!engine.get_book(eth)->best_bid().has_value());
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 10: Sharded engine routes instruments to worker shards
+    {
+        std::cout << "  Sharded engine... ";
+        ShardedEngineConfig config;
+        config.num_shards = 2;
+        config.num_producers = 2;
+        ShardedMatchingEngine sharded(config);
+        
+        auto btc = sharded.add_instrument(make_symbol("BTC-USD"));
+        auto eth = sharded.add_instrument(make_symbol("ETH-USD"));
+        ASSERT(btc && eth);
+        ASSERT(btc->shard != eth->shard);
+        ASSERT(!sharded.add_instrument(make_symbol("BTC-USD")));
+        
+        sharded.start();
+        
+        // Producer 0 trades BTC, producer 1 trades ETH
+        for (int i = 0; i < 100; ++i) {
+            ASSERT(sharded.submit(0, *btc, OrderRequest::make_new(
+                make_symbol("BTC-USD"), Side::BUY, OrderType::LIMIT, to_fixed_price(100.0), 10)));
+            ASSERT(sharded.submit(1, OrderRequest::make_new(
+                make_symbol("ETH-USD"), Side::SELL, OrderType::LIMIT, to_fixed_price(50.0), 10)));
+        }
+        ASSERT(sharded.submit(1, *eth, OrderRequest::make_new(
+            Symbol{}, Side::BUY, OrderType::LIMIT, to_fixed_price(50.0), 250)));
+        ASSERT(!sharded.submit(0, OrderRequest::make_new(
+            make_symbol("UNKNOWN"), Side::BUY, OrderType::LIMIT, 1, 1)));
+        
+        std::size_t reports = 0;
+        std::size_t trades = 0;
+        bool eth_ids_ok = true;
+        const auto eth_first = (static_cast<OrderId>(eth->shard) << ShardedMatchingEngine::ORDER_ID_SHARD_SHIFT) + 1;
+        auto count = [&](const ExecutionReport& r) {
+            ++reports;
+            if (r.exec_type == ExecutionType::TRADE) ++trades;
+            if (r.exec_type == ExecutionType::NEW && r.side == Side::SELL &&
+                r.order_id < eth_first) {
+                eth_ids_ok = false;
+            }
+        };
+        
+        // 201 NEW reports + 25 fills x 2 sides
+        for (int spin = 0; spin < 1'000'000 && reports < 251; ++spin) {
+            sharded.drain_reports(count);
+            std::this_thread::yield();
+        }
+        sharded.stop();
+        sharded.drain_reports(count);
+        
+        ASSERT(reports == 251);
+        ASSERT(trades == 50);
+        ASSERT(eth_ids_ok);
+        ASSERT(sharded.processed(btc->shard) == 100);
+        ASSERT(sharded.processed(eth->shard) == 101);
+        ASSERT(sharded.engine(btc->shard).get_book(btc->instrument)->order_count() == 100);
+        ASSERT(sharded.engine(eth->shard).get_book(eth->instrument)->order_count() == 75);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 11: Batched requests match one at a time and flush once
+    {
+        std::cout << "  Batch processing... ";
+        MatchingEngine engine;
+        const auto btc = make_symbol("BTC-USD");
+        const auto eth = make_symbol("ETH-USD");
+        engine.add_instrument(btc);
+        const auto eth_id = *engine.add_instrument(eth);
+        const Price px = to_fixed_price(100.0);
+        
+        // Interleaved books: BTC requests stay in order, ETH ones by handle
+        std::vector<OrderRequest> batch;
+        for (int i = 0; i < 40; ++i) {
+            batch.push_back(OrderRequest::make_new(btc, Side::SELL, OrderType::LIMIT, px + i, 10));
+            batch.push_back(OrderRequest::make_new(eth_id, Side::BUY, OrderType::LIMIT, px - i, 5));
+        }
+        batch.push_back(OrderRequest::make_new(btc, Side::BUY, OrderType::LIMIT, px + 1, 15));
+        batch.push_back(OrderRequest::make_cancel(btc, 999'999));
+        batch.push_back(OrderRequest::make_new(make_symbol("NOPE"), Side::BUY, OrderType::LIMIT, px, 1));
+        
+        std::vector<OrderId> results(batch.size());
+        std::array<ExecutionReport, 16> buffer;
+        std::size_t flushes = 0;
+        std::size_t reports = 0;
+        BatchingExecutionSink sink(std::span<ExecutionReport>(buffer),
+            [&](std::span<const ExecutionReport> batch_reports) {
+                ++flushes;
+                reports += batch_reports.size();
+            });
+        
+        ASSERT(engine.process_batch(batch, results, sink) == 81);
+        ASSERT(results[0] != INVALID_ORDER_ID && results[2] > results[0]);
+        ASSERT(results[62] < results[1]);   // Books run in handle order: BTC's group first
+        ASSERT(results[81] == INVALID_ORDER_ID && results[82] == INVALID_ORDER_ID);
+        
+        // 81 NEWs, two fills of the crossing buy (x2 sides); a full buffer
+        // flushes early, the rest once at the end
+        ASSERT(reports == 81 + 4);
+        ASSERT(flushes == (reports + buffer.size() - 1) / buffer.size());
+        ASSERT(engine.get_book(btc)->order_count() == 39);
+        ASSERT(engine.get_book(btc)->get_order(results[2])->remaining_quantity() == 5);
+        ASSERT(engine.get_book(eth_id)->order_count() == 40);
+        ASSERT(engine.stats().orders_received == 82 && engine.stats().orders_rejected == 1);
+        ASSERT(engine.latency_stats().count() == 81);       // One sample per accepted order
+        
+        // The async engine drains its queue in bursts
+        AsyncMatchingEngine async_engine;
+        async_engine.engine().add_instrument(btc);
+        std::vector<OrderRequest> quotes;
+        for (int i = 0; i < 200; ++i) {
+            quotes.push_back(OrderRequest::make_new(btc, i % 2 ? Side::BUY : Side::SELL,
+                                                    OrderType::LIMIT, i % 2 ? px - 1 - i : px + i, 1));
+        }
+        async_engine.start();
+        ASSERT(async_engine.submit_batch(quotes) == quotes.size());
+        async_engine.stop();
+        ASSERT(async_engine.engine().get_book(btc)->order_count() == 200);
+        
+        std::cout << "PASSED\n";
+    }
+    
     std::cout << "  All matching engine tests passed!\n";
 }
 
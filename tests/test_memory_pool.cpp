@@ -3,9 +3,14 @@
  * @brief Memory pool unit tests
  */
 
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <thread>
 #include <vector>
+#include "core/lockfree_queue.hpp"
 #include "core/memory_pool.hpp"
+#include "core/slab_allocator.hpp"
 
 using namespace hft;
 
@@ -136,6 +141,142 @@ void run_memory_pool_tests() {
         std::cout << "PASSED\n";
     }
     
+    // Test 6: Slots are handed out in order, freed slots first
+    {
+        std::cout << "  Lazy free list... ";
+        MemoryPool<TestObject, 4> pool(MemoryPolicy{PageSize::SMALL});
+        
+        auto* p1 = pool.create(1, 1.0);
+        auto* p2 = pool.create(2, 2.0);
+        ASSERT(reinterpret_cast<std::uint8_t*>(p2) - reinterpret_cast<std::uint8_t*>(p1) == 64);
+        
+        pool.destroy(p1);
+        pool.destroy(p2);
+        ASSERT(pool.create(3, 3.0) == p2);     // Most recently freed
+        ASSERT(pool.create(4, 4.0) == p1);
+        auto* p5 = pool.create(5, 5.0);        // Untouched slots after reuse
+        auto* p6 = pool.create(6, 6.0);
+        ASSERT(pool.owns(p5) && pool.owns(p6) && pool.full());
+        ASSERT(pool.create(7, 7.0) == nullptr);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 7: Policies that cannot be honoured still give usable memory
+    {
+        std::cout << "  Memory policy fallback... ";
+        
+        MemoryPolicy policy = MemoryPolicy::resident();
+        MemoryRegion region(3 * MemoryRegion::HUGE_PAGE_SIZE + 1, policy);
+        ASSERT(region && region.size() >= 3 * MemoryRegion::HUGE_PAGE_SIZE + 1);
+        ASSERT(reinterpret_cast<std::uintptr_t>(region.data()) % MemoryRegion::HUGE_PAGE_SIZE == 0);
+        ASSERT(region.numa_node() == MemoryPolicy::NUMA_ANY || region.numa_node() >= 0);
+        region.data()[region.size() - 1] = 1;
+        
+        MemoryRegion moved(std::move(region));
+        ASSERT(!region && moved && moved.data()[moved.size() - 1] == 1);
+        
+        MemoryRegion small(100, policy);                // Base pages, still zeroed
+        ASSERT(small && !small.huge_pages() && small.data()[99] == 0);
+        
+        policy.numa_node = 63;                          // Most likely not a real node
+        MemoryPool<int, 1'000'000> pool(policy);
+        std::vector<int*> ptrs;
+        for (int i = 0; i < 1'000'000; ++i) {
+            ptrs.push_back(pool.create(i));
+        }
+        ASSERT(pool.full() && *ptrs.back() == 999'999);
+        
+        auto queue = make_in_region<std::array<int, 4096>>(MemoryPolicy{});
+        ASSERT(queue && (*queue)[4095] == 0);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 8: Slab grows by whole chunks and reuses freed blocks
+    {
+        std::cout << "  Slab growth... ";
+        using Slab = SlabAllocator<TestObject>;
+        Slab slab;
+        auto cache = slab.attach();
+        
+        std::vector<TestObject*> objs;
+        for (std::size_t i = 0; i < 2 * Slab::BLOCKS_PER_CHUNK + 1; ++i) {
+            objs.push_back(cache.create(static_cast<int>(i), 0.0));
+            ASSERT(objs.back() != nullptr);
+        }
+        ASSERT(slab.chunk_count() == 3);
+        ASSERT(reinterpret_cast<std::uintptr_t>(objs[0]) % CACHE_LINE_SIZE == 0);
+        ASSERT(objs.back()->x == static_cast<int>(2 * Slab::BLOCKS_PER_CHUNK));
+        
+        for (auto* obj : objs) cache.destroy(obj);
+        for (std::size_t i = 0; i < objs.size(); ++i) {
+            ASSERT(cache.create(1, 1.0) != nullptr);
+        }
+        ASSERT(slab.chunk_count() == 3);               // No growth on reuse
+        
+        SlabConfig config;
+        config.max_chunks = 1;
+        Slab bounded(config);
+        auto small = bounded.attach();
+        for (std::size_t i = 0; i < Slab::BLOCKS_PER_CHUNK; ++i) {
+            ASSERT(small.allocate() != nullptr);
+        }
+        ASSERT(small.allocate() == nullptr);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 9: Blocks freed on another thread go back to their owner
+    {
+        std::cout << "  Slab remote free... ";
+        using Slab = SlabAllocator<std::uint64_t>;
+        SlabConfig config;
+        config.max_chunks = 1;                          // Growth would hide lost blocks
+        Slab slab(config);
+        SPSCQueue<std::uint64_t*, 1024> handoff;
+        constexpr std::uint64_t N = 4 * Slab::BLOCKS_PER_CHUNK;
+        
+        std::thread consumer([&] {
+            auto cache = slab.attach();
+            std::uint64_t expected = 0;
+            while (expected < N) {
+                if (auto block = handoff.try_pop()) {
+                    if (**block != expected++) return;
+                    cache.destroy(*block);
+                } else {
+                    cache.flush();                      // Idle: return partial batches
+                    std::this_thread::yield();
+                }
+            }
+        });
+        
+        auto cache = slab.attach();
+        for (std::uint64_t i = 0; i < N; ++i) {
+            std::uint64_t* block;
+            while ((block = cache.create(i)) == nullptr) {
+                std::this_thread::yield();
+            }
+            while (!handoff.try_push(block)) {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+        ASSERT(slab.chunk_count() == 1);
+        
+        // Every block came back: a full chunk can be allocated again
+        std::size_t count = 0;
+        while (cache.allocate()) ++count;
+        ASSERT(count == Slab::BLOCKS_PER_CHUNK);
+        
+        // A detached heap is adopted, not leaked
+        cache.detach();
+        auto adopted = slab.attach();
+        ASSERT(adopted.allocate() == nullptr);
+        
+        std::cout << "PASSED\n";
+    }
+    
     std::cout << "  All memory pool tests passed!\n";
 }
 
@@ -4,7 +4,11 @@
  */
 
 #include <iostream>
+#include <array>
+#include <span>
+#include <vector>
 #include "matching/order_book.hpp"
+#include "marketdata/l2_book.hpp"
 
 using namespace hft;
 
@@ -65,6 +69,7 @@ void run_order_book_tests() {
         auto callback = [&trades](const ExecutionReport& report) {
             if (report.exec_type == ExecutionType::TRADE) {
                 ++trades;
+                ASSERT(report.leaves_quantity == 0 && report.cumulative_quantity == 10);
             }
         };
         
@@ -174,6 +179,467 @@ void run_order_book_tests() {
         std::cout << "PASSED\n";
     }
     
+    // Test 8: Ladder backend matching across levels
+    {
+        std::cout << "  Ladder matching... ";
+        auto symbol = make_symbol("TEST");
+        OrderBook book(symbol, OrderBookConfig::ladder(
+            to_fixed_price(90.0), to_fixed_price(110.0), to_fixed_price(0.01)));
+        
+        book.add_order(Order(1, Side::SELL, OrderType::LIMIT, to_fixed_price(100.00), 10));
+        book.add_order(Order(2, Side::SELL, OrderType::LIMIT, to_fixed_price(100.05), 10));
+        book.add_order(Order(3, Side::BUY, OrderType::LIMIT, to_fixed_price(99.99), 10));
+        ASSERT(book.best_ask() == to_fixed_price(100.00));
+        ASSERT(book.best_bid() == to_fixed_price(99.99));
+        
+        // Sweep the first ask level, partially fill the second
+        int trades = 0;
+        book.add_order(Order(4, Side::BUY, OrderType::LIMIT, to_fixed_price(100.05), 15),
+            [&](const ExecutionReport& r) {
+                if (r.exec_type == ExecutionType::TRADE) trades++;
+            });
+        
+        ASSERT(trades == 4);
+        ASSERT(book.best_ask() == to_fixed_price(100.05));
+        ASSERT(book.get_order(2)->remaining_quantity() == 5);
+        ASSERT(book.get_stats().ask_levels == 1);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 9: Ladder best price cursor after cancels
+    {
+        std::cout << "  Ladder cursor advance... ";
+        auto symbol = make_symbol("TEST");
+        OrderBook book(symbol, OrderBookConfig::ladder(
+            to_fixed_price(0.0), to_fixed_price(500.0), to_fixed_price(0.5)));
+        
+        book.add_order(Order(1, Side::BUY, OrderType::LIMIT, to_fixed_price(400.0), 10));
+        book.add_order(Order(2, Side::BUY, OrderType::LIMIT, to_fixed_price(10.0), 10));
+        book.add_order(Order(3, Side::SELL, OrderType::LIMIT, to_fixed_price(410.0), 10));
+        book.add_order(Order(4, Side::SELL, OrderType::LIMIT, to_fixed_price(499.5), 10));
+        
+        // Next level is many bitmap words away on both sides
+        book.cancel_order(1);
+        book.cancel_order(3);
+        ASSERT(book.best_bid() == to_fixed_price(10.0));
+        ASSERT(book.best_ask() == to_fixed_price(499.5));
+        
+        book.cancel_order(2);
+        book.cancel_order(4);
+        ASSERT(!book.best_bid().has_value());
+        ASSERT(!book.best_ask().has_value());
+        ASSERT(book.empty());
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 10: Ladder rejects off-grid prices
+    {
+        std::cout << "  Ladder price rejection... ";
+        auto symbol = make_symbol("TEST");
+        OrderBook book(symbol, OrderBookConfig::ladder(
+            to_fixed_price(90.0), to_fixed_price(110.0), to_fixed_price(0.01)));
+        
+        ExecutionType last = ExecutionType::NEW;
+        auto callback = [&](const ExecutionReport& r) { last = r.exec_type; };
+        
+        ASSERT(!book.add_order(Order(1, Side::BUY, OrderType::LIMIT, to_fixed_price(89.99), 10), callback));
+        ASSERT(last == ExecutionType::CANCELLED);
+        ASSERT(!book.add_order(Order(2, Side::SELL, OrderType::LIMIT, to_fixed_price(110.01), 10)));
+        ASSERT(!book.add_order(Order(3, Side::SELL, OrderType::LIMIT, to_fixed_price(100.005), 10)));
+        ASSERT(book.add_order(Order(4, Side::SELL, OrderType::LIMIT, to_fixed_price(110.0), 10)));
+        ASSERT(book.order_count() == 1);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 11: Ladder depth and clear
+    {
+        std::cout << "  Ladder depth... ";
+        auto symbol = make_symbol("TEST");
+        OrderBook book(symbol, OrderBookConfig::ladder(
+            to_fixed_price(50.0), to_fixed_price(150.0), to_fixed_price(1.0)));
+        
+        for (int i = 0; i < 10; ++i) {
+            book.add_order(Order(i + 1, Side::BUY, OrderType::LIMIT,
+                                to_fixed_price(100.0 - i), 10 * (i + 1)));
+            book.add_order(Order(i + 101, Side::SELL, OrderType::LIMIT,
+                                to_fixed_price(101.0 + i), 10));
+        }
+        
+        auto depth = book.get_depth(5);
+        ASSERT(depth.bids.size() == 5);
+        ASSERT(depth.asks.size() == 5);
+        ASSERT(depth.bids[0].price == to_fixed_price(100.0));
+        ASSERT(depth.bids[4].price == to_fixed_price(96.0));
+        ASSERT(depth.bids[4].quantity == 50);
+        ASSERT(depth.asks[0].price == to_fixed_price(101.0));
+        ASSERT(depth.asks[4].price == to_fixed_price(105.0));
+        
+        auto stats = book.get_stats();
+        ASSERT(stats.bid_levels == 10);
+        ASSERT(stats.total_bid_quantity == 550);
+        
+        book.clear();
+        ASSERT(!book.get_quote().has_value());
+        book.add_order(Order(200, Side::BUY, OrderType::LIMIT, to_fixed_price(60.0), 10));
+        ASSERT(book.best_bid() == to_fixed_price(60.0));
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 12: Order index probing and backward-shift erase
+    {
+        std::cout << "  Order index... ";
+        OrderIndex<8> index;  // 16 slots, forces probe runs to wrap
+        
+        ASSERT(!index.insert(INVALID_ORDER_ID, 0));
+        
+        // Churn through many IDs, keeping at most 8 live
+        for (OrderId id = 1; id <= 1000; ++id) {
+            if (id > 8) {
+                ASSERT(index.erase(id - 8));
+                ASSERT(index.find(id - 8) == NO_ORDER_SLOT);
+            }
+            ASSERT(index.insert(id, static_cast<OrderSlot>(id % 8)));
+            for (OrderId live = (id > 8 ? id - 7 : 1); live <= id; ++live) {
+                ASSERT(index.find(live) == live % 8);
+            }
+        }
+        ASSERT(index.size() == 8);
+        ASSERT(!index.insert(5000, 0));  // Full
+        ASSERT(!index.erase(5000));
+        
+        std::size_t visited = 0;
+        index.for_each([&](OrderId, OrderSlot) { ++visited; });
+        ASSERT(visited == 8);
+        
+        index.clear();
+        ASSERT(index.empty());
+        ASSERT(index.find(1000) == NO_ORDER_SLOT);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 13: Cancel-heavy flow keeps index consistent
+    {
+        std::cout << "  Cancel-heavy flow... ";
+        auto symbol = make_symbol("TEST");
+        OrderBook book(symbol);
+        
+        for (OrderId id = 1; id <= 10000; ++id) {
+            ASSERT(book.add_order(Order(id, Side::BUY, OrderType::LIMIT,
+                                       to_fixed_price(100.0 - static_cast<double>(id % 50)), 10)));
+            if (id % 4 != 0) {
+                ASSERT(book.cancel_order(id));
+            }
+        }
+        
+        ASSERT(book.order_count() == 2500);
+        ASSERT(book.get_order(4).has_value());
+        ASSERT(!book.get_order(5).has_value());
+        ASSERT(!book.add_order(Order(INVALID_ORDER_ID, Side::BUY, OrderType::LIMIT,
+                                     to_fixed_price(100.0), 10)));
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 14: Batched execution sink flushes once per order
+    {
+        std::cout << "  Batched execution sink... ";
+        auto symbol = make_symbol("TEST");
+        OrderBook book(symbol);
+        
+        for (OrderId id = 1; id <= 5; ++id) {
+            book.add_order(Order(id, Side::SELL, OrderType::LIMIT,
+                                to_fixed_price(100.0 + static_cast<double>(id)), 10));
+        }
+        
+        std::array<ExecutionReport, 4> buffer{};
+        int flushes = 0;
+        std::size_t reports = 0;
+        int trades = 0;
+        BatchingExecutionSink sink(std::span<ExecutionReport>(buffer),
+            [&](std::span<const ExecutionReport> batch) {
+                ++flushes;
+                reports += batch.size();
+                for (const auto& r : batch) {
+                    if (r.exec_type == ExecutionType::TRADE) ++trades;
+                }
+            });
+        
+        // NEW + 2 reports per fill across 3 levels = 7, buffer holds 4
+        ASSERT(book.add_order(Order(10, Side::BUY, OrderType::LIMIT, to_fixed_price(103.0), 30), sink));
+        ASSERT(sink.pending() == 0);
+        ASSERT(reports == 7);
+        ASSERT(trades == 6);
+        ASSERT(flushes == 2);
+        
+        ASSERT(book.cancel_order(4, sink));
+        ASSERT(reports == 8);
+        ASSERT(flushes == 3);
+        
+        // Null sink and plain lambdas still work
+        ASSERT(book.cancel_order(5, NullExecutionSink{}));
+        ASSERT(book.empty());
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 15: Compact resting orders keep cold fields and slot reuse
+    {
+        std::cout << "  Hot/cold order store... ";
+        static_assert(sizeof(RestingOrder) * 2 == CACHE_LINE_SIZE);
+        
+        OrderStore store(2, MemoryPolicy{PageSize::SMALL});
+        Order order(7, Side::SELL, OrderType::LIMIT, to_fixed_price(10.0), 40, 99);
+        const OrderSlot a = store.allocate(order);
+        const OrderSlot b = store.allocate(order);
+        ASSERT(a == 0 && b == 1 && store.full());
+        ASSERT(store.allocate(order) == NO_ORDER_SLOT);
+        store[b].filled_quantity = 15;
+        const Order copy = store.to_order(b);
+        ASSERT(copy.price == order.price && copy.client_id == 99 && copy.side == Side::SELL);
+        ASSERT(copy.status == OrderStatus::PARTIALLY_FILLED && copy.remaining_quantity() == 25);
+        store.release(a);
+        ASSERT(store.allocate(order) == a);
+        
+        // Deep queue: FIFO fills with passive reports built from the cold side
+        auto symbol = make_symbol("TEST");
+        OrderBook book(symbol);
+        const Price px = to_fixed_price(50.0);
+        for (OrderId id = 1; id <= 100; ++id) {
+            book.add_order(Order(id, Side::SELL, OrderType::LIMIT, px, 10, 1000 + id));
+        }
+        std::vector<ExecutionReport> passive;
+        book.add_order(Order(500, Side::BUY, OrderType::LIMIT, px, 255),
+            [&](const ExecutionReport& r) {
+                if (r.exec_type == ExecutionType::TRADE && r.side == Side::SELL) passive.push_back(r);
+            });
+        ASSERT(passive.size() == 26);
+        ASSERT(passive.front().order_id == 1 && passive.front().client_id == 1001);
+        ASSERT(passive.front().order_status == OrderStatus::FILLED && passive.front().leaves_quantity == 0);
+        ASSERT(passive.back().order_id == 26 && passive.back().execution_price == px);
+        ASSERT(passive.back().order_status == OrderStatus::PARTIALLY_FILLED);
+        ASSERT(passive.back().leaves_quantity == 5 && passive.back().cumulative_quantity == 5);
+        ASSERT(book.get_order(26)->status == OrderStatus::PARTIALLY_FILLED);
+        ASSERT(book.get_order(27)->client_id == 1027 && book.get_order(27)->price == px);
+        ASSERT(!book.get_order(500));                   // Aggressor never rested
+        ASSERT(book.get_depth(1).asks[0].quantity == 745);
+        
+        // Cancels in the middle of the queue relink the neighbours
+        ASSERT(book.cancel_order(50) && book.cancel_order(27));
+        std::vector<OrderId> queue;
+        book.for_each_order([&](const Order& o) { queue.push_back(o.order_id); });
+        ASSERT(queue.size() == 73 && queue[0] == 26 && queue[1] == 28 && queue[22] == 49 && queue[23] == 51);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 16: Level deltas keep an L2 replica and the stats in step
+    {
+        std::cout << "  L2 deltas... ";
+        auto symbol = make_symbol("TEST");
+        OrderBook book(symbol);
+        auto ring = RegionPtr<BookDeltaRing>::make(MemoryPolicy{PageSize::SMALL});
+        auto drain = [&] {
+            std::vector<BookDelta> out;
+            while (auto d = ring->try_pop()) out.push_back(*d);
+            return out;
+        };
+        
+        book.add_order(Order(1, Side::BUY, OrderType::LIMIT, to_fixed_price(99.0), 10));
+        ASSERT(book.delta_sequence() == 0);             // Off until a ring is attached
+        
+        L2Book replica;
+        std::array<OrderBook::Level, 8> levels;
+        replica.reset(std::span(levels).first(book.copy_depth(Side::BUY, levels)), {},
+                      book.delta_sequence());
+        book.set_delta_ring(ring.get());
+        
+        for (OrderId id = 2; id <= 4; ++id) {
+            book.add_order(Order(id, Side::SELL, OrderType::LIMIT, to_fixed_price(101.0), 10));
+        }
+        book.add_order(Order(5, Side::SELL, OrderType::LIMIT, to_fixed_price(102.0), 10));
+        auto deltas = drain();
+        ASSERT(deltas.size() == 4);
+        ASSERT(deltas[2].sequence == 3 && deltas[2].quantity == 30 && deltas[2].order_count == 3);
+        for (const auto& d : deltas) ASSERT(replica.apply(d) == L2Book::ApplyResult::APPLIED);
+        
+        // A sweep emits one delta per level it touches, with the final total
+        book.add_order(Order(6, Side::BUY, OrderType::LIMIT, to_fixed_price(102.0), 35));
+        deltas = drain();
+        ASSERT(deltas.size() == 2);
+        ASSERT(deltas[0].side == Side::SELL && deltas[0].price == to_fixed_price(101.0));
+        ASSERT(deltas[0].quantity == 0 && deltas[0].order_count == 0);
+        ASSERT(deltas[1].quantity == 5 && deltas[1].order_count == 1 && deltas[1].sequence == 6);
+        for (const auto& d : deltas) ASSERT(replica.apply(d) == L2Book::ApplyResult::APPLIED);
+        
+        book.cancel_order(1);
+        book.add_order(Order(7, Side::BUY, OrderType::LIMIT, to_fixed_price(98.0), 4));
+        for (const auto& d : drain()) ASSERT(replica.apply(d) == L2Book::ApplyResult::APPLIED);
+        
+        auto depth = book.get_depth(8);
+        ASSERT(replica.bids().size() == depth.bids.size() && replica.asks().size() == depth.asks.size());
+        for (std::size_t i = 0; i < depth.asks.size(); ++i) {
+            ASSERT(replica.asks()[i].price == depth.asks[i].price);
+            ASSERT(replica.asks()[i].quantity == depth.asks[i].quantity);
+        }
+        ASSERT(replica.bids()[0].price == to_fixed_price(98.0) && replica.bids()[0].quantity == 4);
+        ASSERT(replica.sequence() == book.delta_sequence());
+        
+        auto stats = book.get_stats();
+        ASSERT(stats.total_bid_quantity == 4 && stats.total_ask_quantity == 5);
+        
+        // Replays and gaps are refused without touching the replica
+        BookDelta late{1, to_fixed_price(101.0), 30, 3, Side::SELL, {}};
+        ASSERT(replica.apply(late) == L2Book::ApplyResult::STALE);
+        BookDelta ahead{replica.sequence() + 2, to_fixed_price(97.0), 1, 1, Side::BUY, {}};
+        ASSERT(replica.apply(ahead) == L2Book::ApplyResult::GAP);
+        ASSERT(replica.bids().size() == 1);
+        
+        book.set_delta_ring(nullptr);
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 17: Amends keep the node, fix level totals and report once
+    {
+        std::cout << "  Amend in place... ";
+        auto symbol = make_symbol("TEST");
+        OrderBook book(symbol);
+        const Price px = to_fixed_price(100.0);
+        for (OrderId id = 1; id <= 3; ++id) {
+            book.add_order(Order(id, Side::BUY, OrderType::LIMIT, px, 10));
+        }
+        auto queue = [&] {
+            std::vector<OrderId> ids;
+            book.for_each_order([&](const Order& o) { ids.push_back(o.order_id); });
+            return ids;
+        };
+        std::vector<ExecutionReport> reports;
+        auto record = [&](const ExecutionReport& r) { reports.push_back(r); };
+        
+        // Quantity down keeps priority and the level total
+        ASSERT(book.modify_order(1, px, 4, record));
+        ASSERT(reports.size() == 1 && reports[0].exec_type == ExecutionType::REPLACED);
+        ASSERT(reports[0].leaves_quantity == 4);
+        ASSERT(queue() == (std::vector<OrderId>{1, 2, 3}));
+        ASSERT(book.get_depth(1).bids[0].quantity == 24);
+        ASSERT(book.get_stats().total_bid_quantity == 24);
+        
+        // Quantity up goes to the back
+        reports.clear();
+        ASSERT(book.modify_order(1, px, 12, record));
+        ASSERT(reports.size() == 1 && queue() == (std::vector<OrderId>{2, 3, 1}));
+        ASSERT(book.get_depth(1).bids[0].quantity == 32);
+        
+        // Reprice moves the same slot to a new level
+        const std::size_t stored = book.order_count();
+        ASSERT(book.modify_order(2, to_fixed_price(101.0), 10));
+        auto depth = book.get_depth(4);
+        ASSERT(depth.bids.size() == 2 && depth.bids[0].price == to_fixed_price(101.0));
+        ASSERT(depth.bids[1].quantity == 22 && depth.bids[1].order_count == 2);
+        ASSERT(book.order_count() == stored);
+        
+        // Repricing through the spread trades first, then rests the remainder
+        book.add_order(Order(10, Side::SELL, OrderType::LIMIT, to_fixed_price(102.0), 6));
+        reports.clear();
+        ASSERT(book.modify_order(3, to_fixed_price(102.0), 10, record));
+        ASSERT(reports.size() == 3 && reports[0].exec_type == ExecutionType::REPLACED);
+        ASSERT(reports[1].exec_type == ExecutionType::TRADE && reports[1].order_id == 3);
+        ASSERT(book.get_order(3)->remaining_quantity() == 4);
+        ASSERT(book.get_order(3)->status == OrderStatus::PARTIALLY_FILLED);
+        ASSERT(book.best_bid() == to_fixed_price(102.0) && !book.best_ask());
+        
+        // Zero cancels; unknown orders are refused
+        ASSERT(book.modify_order(3, to_fixed_price(102.0), 0));
+        ASSERT(!book.get_order(3) && !book.modify_order(3, px, 5));
+        ASSERT(book.get_stats().total_bid_quantity == 22);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 18: IOC, FOK, stops and icebergs in the book
+    {
+        std::cout << "  Time in force and conditional orders... ";
+        auto symbol = make_symbol("TEST");
+        OrderBook book(symbol);
+        auto ask = [&](OrderId id, double px, Quantity qty) {
+            return book.add_order(Order(id, Side::SELL, OrderType::LIMIT, to_fixed_price(px), qty));
+        };
+        ask(1, 100.0, 10);
+        ask(2, 101.0, 10);
+        
+        // IOC trades what crosses and cancels the rest
+        std::vector<ExecutionReport> reports;
+        auto record = [&](const ExecutionReport& r) { reports.push_back(r); };
+        ASSERT(book.add_order(Order(10, Side::BUY, OrderType::IMMEDIATE_OR_CANCEL,
+                                    to_fixed_price(100.0), 15), record));
+        ASSERT(reports.back().exec_type == ExecutionType::CANCELLED);
+        ASSERT(reports.back().cumulative_quantity == 10 && !book.get_order(10));
+        ASSERT(book.best_ask() == to_fixed_price(101.0));
+        
+        // FOK is killed untouched when the levels cannot fill it
+        reports.clear();
+        ASSERT(book.add_order(Order(11, Side::BUY, OrderType::FILL_OR_KILL,
+                                    to_fixed_price(101.0), 11), record));
+        ASSERT(reports.size() == 2 && reports[1].exec_type == ExecutionType::CANCELLED);
+        ASSERT(book.get_depth(1).asks[0].quantity == 10);
+        ASSERT(book.add_order(Order(12, Side::BUY, OrderType::FILL_OR_KILL,
+                                    to_fixed_price(101.0), 10)));
+        ASSERT(!book.best_ask());
+        
+        // Stops wait off the book until a trade prints through the trigger
+        Order stop(20, Side::BUY, OrderType::STOP, 0, 5);
+        stop.stop_price = to_fixed_price(103.0);
+        Order stop_limit(21, Side::BUY, OrderType::STOP_LIMIT, to_fixed_price(104.0), 5);
+        stop_limit.stop_price = to_fixed_price(104.0);
+        ASSERT(book.add_order(stop) && book.add_order(stop_limit));
+        ASSERT(book.stop_count() == 2 && book.get_order(20)->stop_price == to_fixed_price(103.0));
+        ASSERT(book.order_count() == 0);
+        ask(3, 103.0, 1);
+        ask(4, 104.0, 8);
+        ASSERT(book.add_order(Order(13, Side::BUY, OrderType::LIMIT, to_fixed_price(102.0), 1)));
+        ASSERT(book.stop_count() == 2);
+        
+        // Trade at 103 fires the stop-market, whose fill at 104 fires the stop-limit
+        ASSERT(book.add_order(Order(14, Side::BUY, OrderType::LIMIT, to_fixed_price(103.0), 1)));
+        ASSERT(book.stop_count() == 0 && !book.get_order(20));
+        ASSERT(book.get_order(21)->remaining_quantity() == 2);
+        ASSERT(!book.best_ask() && book.best_bid() == to_fixed_price(104.0));
+        ASSERT(book.get_depth(1).bids[0].quantity == 2);
+        
+        // Cancelling a pending stop
+        Order sell_stop(22, Side::SELL, OrderType::STOP, 0, 5);
+        sell_stop.stop_price = to_fixed_price(90.0);
+        ASSERT(book.add_order(sell_stop) && book.cancel_order(22) && book.stop_count() == 0);
+        
+        // Iceberg: only the slice is visible and each refill goes to the back
+        book.clear();
+        Order iceberg(30, Side::SELL, OrderType::LIMIT, to_fixed_price(100.0), 25);
+        iceberg.display_quantity = 10;
+        ASSERT(book.add_order(iceberg));
+        ask(31, 100.0, 5);
+        ASSERT(book.get_depth(1).asks[0].quantity == 15);
+        ASSERT(book.get_order(30)->remaining_quantity() == 25);
+        reports.clear();
+        ASSERT(book.add_order(Order(40, Side::BUY, OrderType::LIMIT, to_fixed_price(100.0), 12), record));
+        // 10 from the slice, then order 31 is ahead of the refill
+        ASSERT(reports[1].order_id == 40 && reports[1].contra_order_id == 30);
+        ASSERT(reports[3].contra_order_id == 31 && reports[3].execution_quantity == 2);
+        ASSERT(book.get_depth(1).asks[0].quantity == 13);
+        ASSERT(book.get_stats().total_ask_quantity == 13);
+        ASSERT(book.get_order(30)->remaining_quantity() == 15);
+        
+        // Amend down trims the hidden reserve first
+        ASSERT(book.modify_order(30, to_fixed_price(100.0), 8));
+        ASSERT(book.get_order(30)->remaining_quantity() == 8);
+        ASSERT(book.get_depth(1).asks[0].quantity == 11);
+        
+        std::cout << "PASSED\n";
+    }
+    
     std::cout << "  All order book tests passed!\n";
 }
 
@@ -0,0 +1,79 @@
+/**
+ * @file test_pipeline.cpp
+ * @brief Pipeline unit tests
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <vector>
+#include "core/pipeline.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_pipeline_tests() {
+    std::cout << "\n=== Pipeline Tests ===\n";
+    
+    // Test 1: Typed pipeline, source -> stage -> sink, drained on stop
+    {
+        std::cout << "  Multi-stage pipeline... ";
+        
+        struct Order {
+            std::uint64_t id;
+            Price price;
+        };
+        
+        Pipeline pipeline;
+        auto* feed = pipeline.source<std::uint64_t>("feed");
+        // Odd ticks are filtered out, even ones become two orders
+        auto* strategy = pipeline.stage<Order>("strategy", *feed,
+            [](const std::uint64_t& tick, Emitter<Order>& out) {
+                if (tick % 2 == 1) return;
+                out.emit({tick, 100});
+                out.emit({tick + 1, 101});
+            });
+        std::uint64_t orders = 0;
+        std::uint64_t id_sum = 0;
+        auto* exchange = pipeline.sink("exchange", *strategy, [&](const Order& order) {
+            ++orders;
+            id_sum += order.id;
+        });
+        ASSERT(feed && strategy && exchange);
+        ASSERT(pipeline.sink("second", *strategy, [](const Order&) {}) == nullptr);
+        ASSERT(pipeline.size() == 3 && exchange->is_sink() && !strategy->is_sink());
+        
+        constexpr std::uint64_t TICKS = 100000;
+        pipeline.start();
+        for (std::uint64_t t = 0; t < TICKS / 2; ++t) {
+            feed->publish(t);
+        }
+        std::vector<std::uint64_t> burst(TICKS / 2);
+        for (std::uint64_t t = 0; t < burst.size(); ++t) {
+            burst[t] = TICKS / 2 + t;
+        }
+        feed->publish(std::span<const std::uint64_t>(burst));
+        pipeline.stop();
+        
+        // Sum over even t of (t + t + 1)
+        std::uint64_t expected = 0;
+        for (std::uint64_t t = 0; t < TICKS; t += 2) {
+            expected += 2 * t + 1;
+        }
+        ASSERT(orders == TICKS && id_sum == expected);
+        ASSERT(feed->stats().emitted.load() == TICKS);
+        ASSERT(strategy->stats().processed.load() == TICKS);
+        ASSERT(strategy->stats().emitted.load() == TICKS);
+        ASSERT(exchange->stats().processed.load() == TICKS);
+        ASSERT(exchange->stats().end_to_end.count() == TICKS);
+        ASSERT(strategy->stats().end_to_end.empty());
+        ASSERT(strategy->stats().queue_delay.count() == TICKS);
+        ASSERT(exchange->stats().max_backlog > 0);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All pipeline tests passed!\n";
+}
@@ -0,0 +1,105 @@
+/**
+ * @file test_rcu.cpp
+ * @brief RCU pointer unit tests
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "core/rcu.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_rcu_tests() {
+    std::cout << "\n=== RCU Tests ===\n";
+    
+    // Test 1: RCU pointer: readers see whole values, old ones freed after their readers leave
+    {
+        std::cout << "  RCU pointer... ";
+        
+        struct Table {
+            std::uint64_t version;
+            std::uint64_t entries[64];
+        };
+        auto make_table = [](std::uint64_t version) {
+            auto table = std::make_unique<Table>();
+            table->version = version;
+            for (auto& e : table->entries) e = version;
+            return table;
+        };
+        
+        RcuDomain domain;
+        RcuPtr<Table> table(domain, make_table(0));
+        
+        // A reader inside its section holds up update() until it leaves
+        std::atomic<bool> inside{false};
+        std::atomic<bool> release{false};
+        std::atomic<std::uint64_t> held_version{99};
+        std::thread holder([&] {
+            RcuReader reader(domain);
+            RcuReadGuard guard(reader);
+            const Table* seen = table.load();
+            inside = true;
+            while (!release) cpu_pause();
+            held_version = seen->entries[63];       // Still valid: not freed yet
+        });
+        while (!inside) cpu_pause();
+        std::atomic<bool> updated{false};
+        std::thread writer([&] {
+            table.update(make_table(1));
+            updated = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ASSERT(!updated && table.load()->version == 1);
+        release = true;
+        holder.join();
+        writer.join();
+        ASSERT(updated && held_version == 0 && domain.epoch() >= 1);
+        
+        // Concurrent readers never see a torn table while it is replaced
+        std::atomic<bool> stop{false};
+        std::atomic<std::uint64_t> torn{0};
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&] {
+                RcuReader reader(domain);
+                if (!reader.valid()) {
+                    ++torn;
+                    return;
+                }
+                while (!stop) {
+                    RcuReadGuard guard(reader);
+                    const Table* t = table.load();
+                    for (auto e : t->entries) torn += e != t->version;
+                }
+            });
+        }
+        for (std::uint64_t v = 2; v < 200; ++v) {
+            table.modify([v](Table& t) {
+                t.version = v;
+                for (auto& e : t.entries) e = v;
+            });
+        }
+        stop = true;
+        for (auto& t : readers) t.join();
+        ASSERT(torn == 0 && table.load()->version == 199);
+        
+        std::vector<std::unique_ptr<RcuReader>> slots;
+        for (std::size_t i = 0; i < RcuDomain::MAX_READERS; ++i) {
+            slots.push_back(std::make_unique<RcuReader>(domain));
+            ASSERT(slots.back()->valid());
+        }
+        ASSERT(!RcuReader(domain).valid());
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All RCU tests passed!\n";
+}
@@ -0,0 +1,296 @@
+/**
+ * @file test_reactor.cpp
+ * @brief I/O reactor unit tests (epoll and io_uring backends)
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "core/reactor.hpp"
+#include "transport/coro_session.hpp"
+#include "transport/order_packets.hpp"
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+namespace {
+
+#ifdef __linux__
+template<typename Pred>
+bool poll_until(Reactor& reactor, Pred done, int max_polls = 200) {
+    for (int i = 0; i < max_polls && !done(); ++i) {
+        reactor.poll(5);
+    }
+    return done();
+}
+
+void test_backend(ReactorBackend backend) {
+    ReactorConfig config;
+    config.backend = backend;
+    config.buffer_count = 8;
+    config.buffer_size = 64;
+    Reactor reactor(config);
+    ASSERT(reactor.init());
+
+    // Receive: chunks arrive in order, EOF is an empty span
+    int fds[2];
+    ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+
+    std::string received;
+    bool closed = false;
+    ASSERT(reactor.receive(fds[0], [&](int fd, std::span<const char> data) {
+        if (data.empty()) {
+            closed = true;
+            reactor.remove(fd);     // Removing from inside the handler is allowed
+            return;
+        }
+        received.append(data.data(), data.size());
+    }));
+    ASSERT(!reactor.receive(fds[0], [](int, std::span<const char>) {}));   // Already registered
+
+    const std::string payload(300, 'q');    // Spans several 64-byte buffers
+    ASSERT(send(fds[1], payload.data(), payload.size(), 0) == static_cast<ssize_t>(payload.size()));
+    ASSERT(poll_until(reactor, [&] { return received.size() == payload.size(); }));
+    ASSERT(received == payload);
+
+    close(fds[1]);
+    ASSERT(poll_until(reactor, [&] { return closed; }));
+    ASSERT(reactor.size() == 0);
+    close(fds[0]);
+
+    // Listen + watch: accepted clients are non-blocking and readable
+    int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    ASSERT(listener >= 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT(bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    socklen_t len = sizeof(addr);
+    ASSERT(getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+    ASSERT(::listen(listener, 16) == 0);
+
+    std::vector<int> accepted;
+    int readable = 0;
+    ASSERT(reactor.listen(listener, [&](int client) {
+        accepted.push_back(client);
+        reactor.watch(client, IO_READ, [&](int fd, std::uint32_t events) {
+            if (events & IO_READ) {
+                char buf[16];
+                while (recv(fd, buf, sizeof(buf), 0) > 0) {}
+                ++readable;
+            }
+        });
+    }));
+
+    int clients[3];
+    for (int& c : clients) {
+        c = socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT(connect(c, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    }
+    ASSERT(poll_until(reactor, [&] { return accepted.size() == 3; }));
+    ASSERT(reactor.size() == 4);
+
+    ASSERT(send(clients[1], "x", 1, 0) == 1);
+    ASSERT(poll_until(reactor, [&] { return readable >= 1; }));
+
+    for (int fd : accepted) {
+        reactor.remove(fd);
+        close(fd);
+    }
+    for (int c : clients) close(c);
+    reactor.remove(listener);
+    close(listener);
+    ASSERT(reactor.size() == 0);
+}
+#endif
+
+} // namespace
+
+void run_reactor_tests() {
+    std::cout << "\n=== Reactor Tests ===\n";
+
+    // Test 1: epoll backend
+    {
+        std::cout << "  epoll receive/listen/watch... ";
+        #ifdef __linux__
+        test_backend(ReactorBackend::EPOLL);
+        std::cout << "PASSED\n";
+        #else
+        std::cout << "SKIPPED\n";
+        #endif
+    }
+
+    // Test 2: io_uring backend (falls back to epoll where unsupported)
+    {
+        std::cout << "  io_uring multishot accept/recv... ";
+        #ifdef __linux__
+        ReactorConfig config;
+        config.backend = ReactorBackend::IO_URING;
+        Reactor probe(config);
+        ASSERT(probe.init());
+        test_backend(ReactorBackend::IO_URING);
+        std::cout << (probe.backend() == ReactorBackend::IO_URING ? "PASSED\n" : "PASSED (epoll fallback)\n");
+        #else
+        std::cout << "SKIPPED\n";
+        #endif
+    }
+
+    // Test 3: run() exits when the flag clears
+    {
+        std::cout << "  Run loop... ";
+        #ifdef __linux__
+        ReactorConfig config;
+        config.mode = PollMode::BALANCED;
+        Reactor reactor(config);
+        ASSERT(reactor.init());
+
+        int fds[2];
+        ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+        std::atomic<bool> running{true};
+        ASSERT(reactor.receive(fds[0], [&](int, std::span<const char> data) {
+            if (!data.empty() && data[0] == 'q') running.store(false, std::memory_order_release);
+        }));
+        ASSERT(send(fds[1], "q", 1, 0) == 1);
+        reactor.run(running);
+        ASSERT(!running.load());
+
+        reactor.remove(fds[0]);
+        close(fds[0]);
+        close(fds[1]);
+        std::cout << "PASSED\n";
+        #else
+        std::cout << "SKIPPED\n";
+        #endif
+    }
+
+    // Test 4: coroutine sessions - split messages, echo, backpressure, close, frame reuse
+    {
+        std::cout << "  Coroutine sessions... ";
+        #ifdef __linux__
+        Reactor reactor;
+        ASSERT(reactor.init());
+        SessionHost host(reactor);
+
+        struct Msg {
+            std::uint64_t seq;
+            std::uint64_t value;
+        };
+        std::size_t ended = 0;
+        auto echo = [&ended](CoroSession& session) -> SessionTask {
+            while (auto msg = co_await session.read_message<Msg>()) {
+                if (msg->seq == ~0ULL) {
+                    // Far more than a socket buffer: write() has to wait for flush()
+                    const std::vector<char> chunk(64 * 1024, 'b');
+                    for (int i = 0; i < 16; ++i) {
+                        if (!co_await session.write(std::span<const char>(chunk))) break;
+                    }
+                    continue;
+                }
+                Msg reply{msg->seq, msg->value * 2};
+                if (!co_await session.write(reply)) break;
+            }
+            ++ended;
+        };
+        auto pump = [&](auto done) {
+            for (int i = 0; i < 400 && !done(); ++i) {
+                reactor.poll(1);
+                host.flush();
+            }
+            return done();
+        };
+
+        constexpr std::size_t SESSIONS = 200;
+        auto wave = [&](std::vector<int>& clients) {
+            clients.clear();
+            for (std::size_t i = 0; i < SESSIONS; ++i) {
+                int fds[2];
+                ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+                ASSERT(host.adopt(fds[0], echo));
+                clients.push_back(fds[1]);
+            }
+            ASSERT(host.size() == SESSIONS);
+
+            // Each message arrives in two pieces; the coroutine sees it whole
+            std::vector<Msg> replies(SESSIONS);
+            for (std::size_t i = 0; i < SESSIONS; ++i) {
+                const Msg msg{i, 100 + i};
+                const char* bytes = reinterpret_cast<const char*>(&msg);
+                ASSERT(send(clients[i], bytes, 5, 0) == 5);
+                reactor.poll(0);
+                ASSERT(send(clients[i], bytes + 5, sizeof(msg) - 5, 0) == sizeof(msg) - 5);
+            }
+            std::size_t got = 0;
+            ASSERT(pump([&] {
+                for (std::size_t i = 0; i < SESSIONS; ++i) {
+                    if (recv(clients[i], &replies[i], sizeof(Msg), 0) == sizeof(Msg)) ++got;
+                }
+                return got == SESSIONS;
+            }));
+            for (std::size_t i = 0; i < SESSIONS; ++i) {
+                ASSERT(replies[i].seq == i && replies[i].value == 2 * (100 + i));
+            }
+        };
+
+        std::vector<int> clients;
+        wave(clients);
+
+        // Backpressure: 1 MiB through one session, drained as the client reads
+        const Msg big{~0ULL, 0};
+        ASSERT(send(clients[0], &big, sizeof(big), 0) == sizeof(big));
+        std::size_t drained = 0;
+        ASSERT(pump([&] {
+            char buf[65536];
+            ssize_t n;
+            while ((n = recv(clients[0], buf, sizeof(buf), 0)) > 0) drained += static_cast<std::size_t>(n);
+            return drained == 16 * 64 * 1024;
+        }));
+
+        // Peer close: the coroutine sees nullopt, returns, and its fd is reaped
+        for (int c : clients) close(c);
+        ASSERT(pump([&] { return host.size() == 0; }));
+        ASSERT(ended == SESSIONS);
+        ASSERT(reactor.size() == 0);
+
+        // A second wave reuses the first wave's frames
+        const auto before = CoroFramePool::stats();
+        wave(clients);
+        const auto after = CoroFramePool::stats();
+        ASSERT(after.fresh == before.fresh);
+        ASSERT(after.reused >= before.reused + SESSIONS);
+
+        // Pooled and heap frames both hold alignas(64) locals such as OrderPacket
+        for (const std::size_t size : {std::size_t{40}, CoroFramePool::MAX_POOLED + 1}) {
+            void* frame = CoroFramePool::allocate(size);
+            ASSERT(reinterpret_cast<std::uintptr_t>(frame) % alignof(OrderPacket) == 0);
+            CoroFramePool::deallocate(frame, size);
+        }
+
+        // close_all() ends live sessions without resuming them
+        host.close_all();
+        ASSERT(host.size() == 0 && reactor.size() == 0);
+        ASSERT(ended == SESSIONS);
+        ASSERT(host.stats().opened == 2 * SESSIONS && host.stats().finished == 2 * SESSIONS);
+        for (int c : clients) {
+            char byte;
+            ASSERT(recv(c, &byte, 1, 0) == 0);      // Server side was closed
+            close(c);
+        }
+        std::cout << "PASSED\n";
+        #else
+        std::cout << "SKIPPED\n";
+        #endif
+    }
+
+    std::cout << "  All reactor tests passed!\n";
+}
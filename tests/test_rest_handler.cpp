@@ -0,0 +1,217 @@
+/**
+ * @file test_rest_handler.cpp
+ * @brief HTTP parser, router and keep-alive server unit tests
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include "protocol/rest_handler.hpp"
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+namespace {
+
+std::size_t count_of(std::string_view haystack, std::string_view needle) {
+    std::size_t count = 0;
+    for (auto pos = haystack.find(needle); pos != std::string_view::npos;
+         pos = haystack.find(needle, pos + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+void run_rest_handler_tests() {
+    std::cout << "\n=== REST Handler Tests ===\n";
+
+    // Test 1: Parser fills fixed header/query arrays and detects keep-alive
+    {
+        std::cout << "  Request parsing... ";
+
+        std::string_view raw =
+            "POST /api/v1/order?venue=X&tif=IOC HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "content-length: 4\r\n"
+            "Connection:  Close \r\n"
+            "\r\n"
+            "bodyGET / HTTP/1.1\r\n\r\n";
+
+        HttpRequest request;
+        int consumed = HttpParser::parse(raw, request);
+        ASSERT(consumed == static_cast<int>(raw.find("GET")));
+        ASSERT(request.method == HttpMethod::POST);
+        ASSERT(request.path == "/api/v1/order");
+        ASSERT(request.body == "body");
+        ASSERT(request.headers.size() == 3);
+        ASSERT(request.get_header("CONTENT-LENGTH") == "4");
+        ASSERT(request.get_query_param("tif") == "IOC");
+        ASSERT(!request.keep_alive);
+
+        // Second pipelined request; the same object is reused
+        consumed = HttpParser::parse(raw.substr(consumed), request);
+        ASSERT(consumed == static_cast<int>(std::string_view("GET / HTTP/1.1\r\n\r\n").size()));
+        ASSERT(request.method == HttpMethod::GET && request.headers.empty() && request.keep_alive);
+
+        ASSERT(HttpParser::parse("GET / HTTP/1.0\r\n\r\n", request) > 0 && !request.keep_alive);
+        ASSERT(HttpParser::parse("GET / HTTP/1.1\r\nHost: x\r\n", request) == 0);
+        ASSERT(HttpParser::parse("POST / HTTP/1.1\r\nContent-Length: 9\r\n\r\nabc", request) == 0);
+        ASSERT(HttpParser::parse("POST / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n", request) == -1);
+
+        std::string many = "GET / HTTP/1.1\r\n";
+        for (std::size_t i = 0; i <= HttpHeaders::capacity(); ++i) {
+            many += "X-H: v\r\n";
+        }
+        many += "\r\n";
+        ASSERT(HttpParser::parse(many, request) == -1);
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 2: Trie router prefers literals and binds parameters
+    {
+        std::cout << "  Router... ";
+
+        HttpRouter router;
+        router.get("/health", [](const HttpRequest&) { return HttpResponse().body("health"); });
+        router.get("/api/v1/depth/:symbol", [](const HttpRequest&) { return HttpResponse().body("depth"); });
+        router.get("/api/v1/depth/all", [](const HttpRequest&) { return HttpResponse().body("all"); });
+        router.del("/api/v1/order/:symbol/:orderId", [](const HttpRequest&) { return HttpResponse().body("del"); });
+        router.get("/", [](const HttpRequest&) { return HttpResponse().body("root"); });
+
+        auto call = [&](HttpMethod method, std::string_view path, HttpRequest& request) {
+            request.clear();
+            request.method = method;
+            request.path = path;
+            return std::string(router.route(request).get_body());
+        };
+
+        HttpRequest request;
+        ASSERT(call(HttpMethod::GET, "/health", request) == "health");
+        ASSERT(call(HttpMethod::GET, "/", request) == "root");
+        ASSERT(call(HttpMethod::GET, "/api/v1/depth/all", request) == "all");
+        ASSERT(call(HttpMethod::GET, "/api/v1/depth/BTC-USD", request) == "depth");
+        ASSERT(request.get_path_param("symbol") == "BTC-USD");
+
+        ASSERT(call(HttpMethod::DELETE, "/api/v1/order/ETH-USD/42", request) == "del");
+        ASSERT(request.get_path_param("symbol") == "ETH-USD");
+        ASSERT(request.get_path_param("orderId") == "42");
+
+        HttpResponse missing = [&] {
+            request.clear();
+            request.method = HttpMethod::POST;
+            request.path = "/health";
+            return router.route(request);
+        }();
+        ASSERT(missing.get_status() == HttpStatus::NOT_FOUND);
+        ASSERT(missing.get_body().find("NOT_FOUND") != std::string_view::npos);    // Owned body survives the copy
+        ASSERT(call(HttpMethod::GET, "/api/v1/depth", request).find("NOT_FOUND") != std::string::npos);
+        ASSERT(call(HttpMethod::GET, "/api/v1/depth/BTC-USD/extra", request).find("NOT_FOUND") != std::string::npos);
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 3: Responses append into a reused buffer
+    {
+        std::cout << "  Response writer... ";
+
+        std::string out;
+        HttpResponse(HttpStatus::CREATED).json(R"({"ok":true})").write_to(out);
+        ASSERT(out == "HTTP/1.1 201 Created\r\nConnection: keep-alive\r\nContent-Length: 11\r\n"
+                      "Content-Type: application/json\r\n\r\n{\"ok\":true}");
+
+        const auto first = out.size();
+        HttpResponse(HttpStatus::NOT_FOUND).write_to(out, false);
+        ASSERT(std::string_view(out).substr(first) ==
+               "HTTP/1.1 404 Not Found\r\nConnection: close\r\nContent-Length: 0\r\n\r\n");
+        ASSERT(HttpResponse().body("x").build() == "HTTP/1.1 200 OK\r\nConnection: keep-alive\r\n"
+                                                   "Content-Length: 1\r\n\r\nx");
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 4: Keep-alive connection with pipelined requests
+    {
+        std::cout << "  Keep-alive pipelining... ";
+
+        #ifdef __linux__
+        for (ReactorBackend backend : {ReactorBackend::EPOLL, ReactorBackend::IO_URING}) {
+            ReactorConfig config;
+            config.backend = backend;
+            HttpServer server(0, config);
+            int hits = 0;
+            server.router().get("/ping", [&](const HttpRequest&) {
+                ++hits;
+                return HttpResponse().body("pong");
+            });
+            ASSERT(server.start());
+
+            int client = socket(AF_INET, SOCK_STREAM, 0);
+            ASSERT(client >= 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = htons(server.port());
+            ASSERT(connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+
+            auto read_responses = [&](std::string& received, std::size_t expected) {
+                for (int i = 0; i < 200 && count_of(received, "pong") < expected; ++i) {
+                    server.poll();
+                    char buf[4096];
+                    ssize_t n = recv(client, buf, sizeof(buf), MSG_DONTWAIT);
+                    if (n > 0) {
+                        received.append(buf, static_cast<std::size_t>(n));
+                    } else {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                }
+            };
+
+            // Three requests in one write, the third split across writes
+            std::string batch =
+                "GET /ping HTTP/1.1\r\n\r\n"
+                "GET /ping HTTP/1.1\r\nHost: x\r\n\r\n"
+                "GET /pi";
+            ASSERT(send(client, batch.data(), batch.size(), 0) == static_cast<ssize_t>(batch.size()));
+            std::string received;
+            read_responses(received, 2);
+            ASSERT(count_of(received, "pong") == 2);
+
+            std::string tail = "ng HTTP/1.1\r\n\r\n";
+            ASSERT(send(client, tail.data(), tail.size(), 0) == static_cast<ssize_t>(tail.size()));
+            read_responses(received, 3);
+            ASSERT(count_of(received, "Connection: keep-alive") == 3);
+            ASSERT(hits == 3 && server.connection_count() == 1);
+
+            // Connection: close is honoured after the response
+            std::string last = "GET /ping HTTP/1.1\r\nConnection: close\r\n\r\n";
+            ASSERT(send(client, last.data(), last.size(), 0) == static_cast<ssize_t>(last.size()));
+            read_responses(received, 4);
+            ASSERT(count_of(received, "Connection: close") == 1);
+            for (int i = 0; i < 100 && server.connection_count() > 0; ++i) {
+                server.poll();
+            }
+            ASSERT(server.connection_count() == 0);
+
+            close(client);
+            server.stop();
+        }
+        std::cout << "PASSED\n";
+        #else
+        std::cout << "SKIPPED\n";
+        #endif
+    }
+
+    std::cout << "  All REST handler tests passed!\n";
+}
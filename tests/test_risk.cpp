@@ -0,0 +1,109 @@
+/**
+ * @file test_risk.cpp
+ * @brief Pre-trade risk and token bucket unit tests
+ */
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "risk/pre_trade_risk.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_risk_tests() {
+    std::cout << "\n=== Pre-Trade Risk Tests ===\n";
+
+    // Test 1: Token bucket bursts, then refills at the configured rate
+    {
+        std::cout << "  Token bucket... ";
+
+        TokenBucket slow(1.0, 5.0);     // Refills one token per second
+        int granted = 0;
+        for (int i = 0; i < 10; ++i) {
+            granted += slow.try_acquire() ? 1 : 0;
+        }
+        ASSERT(granted == 5);
+
+        TokenBucket fast(1000.0, 1.0);  // One token per millisecond
+        ASSERT(fast.try_acquire());
+        ASSERT(!fast.try_acquire());
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ASSERT(fast.try_acquire());
+
+        TokenBucket batch(1.0, 4.0);
+        ASSERT(batch.try_acquire(3));
+        ASSERT(!batch.try_acquire(2));
+        ASSERT(batch.try_acquire(1));
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 2: Position and size limits include open orders
+    {
+        std::cout << "  Position limits... ";
+
+        RiskLimits limits;
+        limits.max_position = 100;
+        limits.max_order_quantity = 60;
+        PreTradeRisk risk(2, 2, limits);
+
+        ASSERT(risk.check(0, 0, Side::BUY, 0, 60) == RiskResult::ACCEPTED);
+        ASSERT(risk.check(0, 0, Side::BUY, 0, 61) == RiskResult::ORDER_TOO_LARGE);
+        ASSERT(risk.check(0, 0, Side::BUY, 0, 0) == RiskResult::INVALID_QUANTITY);
+        ASSERT(risk.check(0, 2, Side::BUY, 0, 1) == RiskResult::UNKNOWN_INSTRUMENT);
+        ASSERT(risk.check(2, 0, Side::BUY, 0, 1) == RiskResult::UNKNOWN_ACCOUNT);
+
+        risk.on_order_accepted(0, 0, Side::BUY, 0, 60);
+        ASSERT(risk.check(0, 0, Side::BUY, 0, 41) == RiskResult::POSITION_LIMIT);
+        ASSERT(risk.check(0, 0, Side::BUY, 0, 40) == RiskResult::ACCEPTED);
+        ASSERT(risk.check(1, 0, Side::BUY, 0, 60) == RiskResult::ACCEPTED);    // Other account
+        ASSERT(risk.check(0, 1, Side::BUY, 0, 60) == RiskResult::ACCEPTED);    // Other instrument
+
+        // Fills move open quantity into the net position
+        RiskFill fills[] = {{0, 0, Side::BUY, 0, 25}, {0, 0, Side::BUY, 0, 15}};
+        risk.apply_fills(fills);
+        auto pos = risk.get_position(0, 0);
+        ASSERT(pos.net_position == 40 && pos.open_buy_orders == 20 && pos.max_position == 100);
+
+        risk.on_order_released(0, 0, Side::BUY, 0, 20);
+        pos = risk.get_position(0, 0);
+        ASSERT(pos.open_buy_orders == 0);
+        ASSERT(risk.check(0, 0, Side::SELL, 0, 60) == RiskResult::ACCEPTED);
+        ASSERT(risk.check(0, 0, Side::BUY, 0, 60) == RiskResult::ACCEPTED);    // Exactly at the limit
+
+        risk.set_limits(0, RiskLimits{50, 100});
+        ASSERT(risk.check(0, 0, Side::BUY, 0, 11) == RiskResult::POSITION_LIMIT);
+        ASSERT(risk.check(0, 0, Side::SELL, 0, 90) == RiskResult::ACCEPTED);
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 3: Account notional uses the booked price and releases exactly
+    {
+        std::cout << "  Notional limits... ";
+
+        const Price price = to_fixed_price(100.0);
+        PreTradeRisk risk(1, 1, {}, price * 50);
+
+        ASSERT(risk.check(0, 0, Side::BUY, price, 50) == RiskResult::ACCEPTED);
+        ASSERT(risk.check(0, 0, Side::BUY, price, 51) == RiskResult::NOTIONAL_LIMIT);
+
+        risk.on_order_accepted(0, 0, Side::SELL, price, 30);
+        ASSERT(risk.open_notional(0) == price * 30);
+        ASSERT(risk.check(0, 0, Side::BUY, price, 21) == RiskResult::NOTIONAL_LIMIT);
+
+        risk.on_fill({0, 0, Side::SELL, price, 30});
+        ASSERT(risk.open_notional(0) == 0);
+        ASSERT(risk.get_position(0, 0).net_position == -30);
+
+        risk.set_max_open_notional(0, 0);   // Unlimited
+        ASSERT(risk.check(0, 0, Side::BUY, price, 1000) == RiskResult::ACCEPTED);
+
+        std::cout << "PASSED\n";
+    }
+
+    std::cout << "  All risk tests passed!\n";
+}
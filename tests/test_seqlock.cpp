@@ -0,0 +1,53 @@
+/**
+ * @file test_seqlock.cpp
+ * @brief SeqLock unit tests
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include "core/seqlock.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_seqlock_tests() {
+    std::cout << "\n=== SeqLock Tests ===\n";
+    
+    // Test 1: SeqLock readers never see a torn value
+    {
+        std::cout << "  SeqLock publication... ";
+        
+        struct Pair { std::uint64_t a; std::uint64_t b; std::uint64_t pad[6]; };
+        SeqLock<Pair> lock(Pair{0, ~std::uint64_t{0}, {}});
+        constexpr std::uint64_t STORES = 200000;
+        std::atomic<bool> done{false};
+        std::atomic<bool> torn{false};
+        
+        std::thread writer([&]() {
+            for (std::uint64_t i = 1; i <= STORES; ++i) {
+                lock.store(Pair{i, ~i, {}});
+            }
+            done = true;
+        });
+        std::uint64_t last = 0;
+        while (!done.load()) {
+            Pair p;
+            lock.load(p);
+            if (p.b != ~p.a || p.a < last) torn = true;
+            last = p.a;
+        }
+        writer.join();
+        
+        ASSERT(!torn.load());
+        ASSERT(lock.version() == STORES);
+        ASSERT(lock.load().a == STORES);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All SeqLock tests passed!\n";
+}
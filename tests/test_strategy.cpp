@@ -0,0 +1,110 @@
+/**
+ * @file test_strategy.cpp
+ * @brief Trading strategy unit tests
+ */
+
+#include <cmath>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+#include "strategy/user_strategy.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_strategy_tests() {
+    std::cout << "\n=== Strategy Tests ===\n";
+    
+    // Test 1: Per-symbol strategy state, batch path matches the scalar one
+    {
+        std::cout << "  Multi-symbol strategy state... ";
+        
+        auto make_tick = [](const char* name, Price last, std::uint64_t seq) {
+            Tick tick{};
+            tick.symbol = make_symbol(name);
+            tick.bid_price = last - 50;
+            tick.ask_price = last + 50;
+            tick.last_price = last;
+            tick.sequence = seq;
+            return tick;
+        };
+        
+        // Interleaved symbols: each sees only its own previous price
+        MomentumStrategy scalar;
+        std::vector<StrategyOrder> sent;
+        scalar.set_order_callback([&](const StrategyOrder& order) { sent.push_back(order); });
+        scalar.onTick(make_tick("AAA", 10000, 0));
+        scalar.onTick(make_tick("BBB", 50000, 1));
+        scalar.onTick(make_tick("AAA", 10100, 2));     // AAA up: buy
+        scalar.onTick(make_tick("BBB", 49900, 3));     // BBB down: sell
+        ASSERT(scalar.symbol_count() == 2 && sent.size() == 2);
+        ASSERT(sent[0].symbol == make_symbol("AAA") && sent[0].side == Side::BUY);
+        ASSERT(sent[1].symbol == make_symbol("BBB") && sent[1].side == Side::SELL);
+        const InstrumentId aaa = *scalar.find_symbol(make_symbol("AAA"));
+        const InstrumentId bbb = *scalar.find_symbol(make_symbol("BBB"));
+        ASSERT(scalar.delta(aaa) == 100 && scalar.delta(bbb) == -100);
+        
+        // Fills are attributed by client order id
+        OrderResponse fill{};
+        fill.client_order_id = sent[1].client_order_id;
+        fill.status = OrderStatus::FILLED;
+        fill.fill_quantity = sent[1].quantity;
+        scalar.onOrderResponse(fill);
+        ASSERT(scalar.inventory(bbb) == -sent[1].quantity && scalar.inventory(aaa) == 0);
+        
+        // Same ticks one symbol per batch slot: identical state
+        constexpr int SYMBOLS = 300;
+        std::vector<std::string> names;
+        for (int s = 0; s < SYMBOLS; ++s) names.push_back("S" + std::to_string(s));
+        std::vector<Tick> ticks;
+        for (int round = 0; round < 4; ++round) {
+            for (int s = 0; s < SYMBOLS; ++s) {
+                ticks.push_back(make_tick(names[s].c_str(), 10000 + ((s * 7 + round * 13) % 21) * 100,
+                                          ticks.size()));
+            }
+        }
+        MomentumStrategy one_by_one;
+        MomentumStrategy batched;
+        std::size_t one_orders = 0;
+        std::size_t batch_orders = 0;
+        one_by_one.set_order_callback([&](const StrategyOrder&) { ++one_orders; });
+        batched.set_order_callback([&](const StrategyOrder&) { ++batch_orders; });
+        for (const auto& tick : ticks) {
+            one_by_one.onTick(tick);
+        }
+        for (std::size_t i = 0; i < ticks.size(); i += SYMBOLS) {
+            batched.on_ticks(std::span<const Tick>(ticks).subspan(i, SYMBOLS));
+        }
+        ASSERT(batched.symbol_count() == SYMBOLS && one_orders == batch_orders && one_orders > 0);
+        for (InstrumentId id = 0; id < SYMBOLS; ++id) {
+            ASSERT(batched.last_price(id) == one_by_one.last_price(id));
+            ASSERT(batched.delta(id) == one_by_one.delta(id));
+            ASSERT(std::abs(batched.ema(id) - one_by_one.ema(id)) < 1e-6);
+        }
+        
+        // A symbol twice in one batch: its latest tick, change from before the batch
+        MomentumStrategy conflated;
+        conflated.onTick(make_tick("AAA", 10000, 0));
+        const std::vector<Tick> repeat{make_tick("AAA", 10100, 1), make_tick("BBB", 500, 2),
+                                       make_tick("AAA", 10300, 3)};
+        conflated.on_ticks(repeat);
+        ASSERT(conflated.symbol_count() == 2);
+        ASSERT(conflated.last_price(0) == 10300 && conflated.delta(0) == 300);
+        
+        // Market maker requotes a symbol only when its quotes move
+        MarketMakingStrategy maker;
+        std::size_t quotes = 0;
+        maker.set_order_callback([&](const StrategyOrder&) { ++quotes; });
+        maker.onTick(make_tick("AAA", 10000, 0));
+        maker.onTick(make_tick("BBB", 10000, 1));
+        maker.onTick(make_tick("AAA", 10000, 2));
+        ASSERT(quotes == 4);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All strategy tests passed!\n";
+}
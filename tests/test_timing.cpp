@@ -0,0 +1,43 @@
+/**
+ * @file test_timing.cpp
+ * @brief Timing and latency statistics unit tests
+ */
+
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include "core/timing.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_timing_tests() {
+    std::cout << "\n=== Timing Tests ===\n";
+    
+    // Test 1: LatencyStats merged across threads
+    {
+        std::cout << "  LatencyStats merge... ";
+        
+        LatencyStats per_thread[2];
+        std::thread t0([&]() { for (int i = 0; i < 50000; ++i) per_thread[0].add_sample(100); });
+        std::thread t1([&]() { for (int i = 0; i < 50000; ++i) per_thread[1].add_sample(300); });
+        t0.join();
+        t1.join();
+        
+        LatencyStats total;
+        total.merge(per_thread[0]);
+        total.merge(per_thread[1]);
+        ASSERT(total.count() == 100000);
+        ASSERT(total.min() == 100.0 && total.max() == 300.0);
+        ASSERT(std::abs(total.mean() - 200.0) < 1e-6);
+        ASSERT(total.median() >= 100.0 && total.median() <= 101.0);
+        ASSERT(total.percentile(99.0) >= 300.0 && total.percentile(99.0) <= 303.0);
+        ASSERT(std::abs(total.stddev() - 100.0) < 0.01);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All timing tests passed!\n";
+}
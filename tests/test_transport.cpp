@@ -0,0 +1,593 @@
+/**
+ * @file test_transport.cpp
+ * @brief Transport unit tests
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "transport/exec_report_bus.hpp"
+#include "transport/ipc_socket.hpp"
+#include "transport/shm_transport.hpp"
+#include "transport/udp_multicast.hpp"
+#include "transport/feed_recovery.hpp"
+#include "transport/shard_router.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_transport_tests() {
+    std::cout << "\n=== Transport Tests ===\n";
+    
+    const std::string shm_name = "/hft_test_" + std::to_string(getpid());
+    
+    // Test 1: Shared-memory order round trip
+    {
+        std::cout << "  Shared-memory round trip... ";
+        ShmTransportServer server(shm_name);
+        ASSERT(server.init());
+        
+        std::atomic<int> orders{0};
+        server.start([&](const OrderPacket& order, int client_id) {
+            OrderResponsePacket response{};
+            response.client_order_id = order.client_order_id;
+            response.fill_quantity = order.quantity;
+            response.status = 2;
+            server.send_response(client_id, response);
+            ++orders;
+        });
+        
+        ShmTransportClient client(shm_name);
+        ASSERT(client.connect());
+        ASSERT(client.client_id() == 0);
+        
+        for (std::uint64_t id = 1; id <= 100; ++id) {
+            OrderPacket order{};
+            order.client_order_id = id;
+            order.quantity = static_cast<int64_t>(id * 10);
+            std::memcpy(order.symbol, "BTC-USD", 8);
+            ASSERT(client.send_order(order));
+        }
+        
+        for (std::uint64_t id = 1; id <= 100; ++id) {
+            OrderResponsePacket response{};
+            ASSERT(client.receive_response(response, 5000));
+            ASSERT(response.client_order_id == id);
+            ASSERT(response.fill_quantity == static_cast<int64_t>(id * 10));
+        }
+        ASSERT(orders.load() == 100);
+        
+        OrderResponsePacket none{};
+        ASSERT(!client.receive_response(none, 1));
+        
+        server.stop();
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 2: Client slots
+    {
+        std::cout << "  Shared-memory client slots... ";
+        ShmTransportClient orphan(shm_name);
+        ASSERT(!orphan.connect());  // No server segment
+        
+        ShmTransportServer server(shm_name);
+        ASSERT(server.init());
+        server.start([](const OrderPacket&, int) {});
+        
+        ShmTransportClient a(shm_name);
+        ShmTransportClient b(shm_name);
+        ASSERT(a.connect());
+        ASSERT(b.connect());
+        ASSERT(a.client_id() != b.client_id());
+        
+        OrderResponsePacket response{};
+        ASSERT(!server.send_response(7, response));    // Slot not connected
+        ASSERT(!server.send_response(-1, response));
+        
+        server.stop();
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 3: Multicast batch send / receive with kernel timestamps
+    {
+        std::cout << "  Multicast recvmmsg/sendmmsg batch... ";
+        const auto port = static_cast<uint16_t>(20000 + getpid() % 20000);
+        UDPMulticastReceiver receiver("239.255.42.99", port);
+        UDPMulticastSender sender("239.255.42.99", port);
+        
+        if (!receiver.init() || !sender.init()) {
+            std::cout << "SKIPPED (no multicast)\n";
+        } else {
+            const bool stamped = receiver.enable_rx_timestamping(RxTimestamping::SOFTWARE);
+            if (stamped) {
+                // The kernel switches RX stamping on asynchronously; probe
+                // (sequence 0) until stamps appear
+                MarketDataPacket probe{};
+                bool live = false;
+                const auto warmup = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+                while (!live && std::chrono::steady_clock::now() < warmup) {
+                    sender.send(probe);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    auto packets = receiver.try_receive_batch();
+                    for (std::size_t i = 0; i < packets.size(); ++i) {
+                        live |= receiver.rx_timestamp(i) > 0;
+                    }
+                }
+                ASSERT(live);
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                while (!receiver.try_receive_batch().empty()) {}
+            }
+            auto& ts_buffer = TimestampBufferManager::get_thread_buffer();
+            const std::size_t events_before = ts_buffer.count();
+            
+            std::vector<MarketDataPacket> burst(100);
+            for (std::size_t i = 0; i < burst.size(); ++i) {
+                std::memset(&burst[i], 0, sizeof(MarketDataPacket));
+                burst[i].sequence = i + 1;
+            }
+            ASSERT(sender.send_batch(burst) == burst.size());
+            
+            std::uint64_t expected = 1;
+            std::size_t batches = 0;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+            while (expected <= burst.size() && std::chrono::steady_clock::now() < deadline) {
+                auto packets = receiver.try_receive_batch();
+                if (packets.empty()) continue;
+                ASSERT(packets.size() <= UDP_MAX_BATCH);
+                for (std::size_t i = 0; i < packets.size(); ++i) {
+                    ASSERT(packets[i].sequence == expected++);
+                    if (stamped) ASSERT(receiver.rx_timestamp(i) > 0);
+                }
+                ++batches;
+            }
+            ASSERT(expected == burst.size() + 1);
+            ASSERT(batches < burst.size());     // Bursts were coalesced
+            if (stamped) {
+                ASSERT(ts_buffer.count() - events_before == burst.size());
+                std::vector<TimestampEvent> events;
+                ts_buffer.peek_all([&](const TimestampEvent& event) { events.push_back(event); });
+                ASSERT(events[events_before].type == EventType::PACKET_RX);
+                ASSERT(events[events_before].payload == 1);
+            }
+            ASSERT(receiver.try_receive_batch().empty());
+            
+            std::cout << "PASSED\n";
+        }
+    }
+    
+    // Test 4: Sequencer reorder, recovery and loss accounting
+    {
+        std::cout << "  Feed sequencer gaps... ";
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> requests;
+        FeedSequencer<64>::Config config;
+        config.reorder_tolerance = 2;
+        config.recovery_timeout = std::chrono::milliseconds(10);
+        FeedSequencer<64> seq([&](std::uint64_t first, std::uint64_t last) {
+            requests.emplace_back(first, last);
+            return true;
+        }, config);
+        
+        std::vector<std::uint64_t> out;
+        auto deliver = [&](const MarketDataPacket& p) { out.push_back(p.sequence); };
+        auto feed = [&](std::uint64_t s, std::uint32_t flags = 0) {
+            MarketDataPacket p{};
+            p.sequence = s;
+            p.flags = flags;
+            return seq.on_packet(p, deliver);
+        };
+        
+        // Simple reorder within tolerance: no recovery
+        ASSERT(feed(1) == SequenceResult::DELIVERED);
+        ASSERT(feed(3) == SequenceResult::BUFFERED);
+        ASSERT(seq.gap_open());
+        ASSERT(feed(2) == SequenceResult::DELIVERED);
+        ASSERT(!seq.gap_open());
+        ASSERT((out == std::vector<std::uint64_t>{1, 2, 3}));
+        ASSERT(requests.empty());
+        ASSERT(feed(2) == SequenceResult::DUPLICATE);
+        
+        // Hole at 4 outlives the tolerance: recover by retransmit
+        feed(5);
+        feed(6);
+        ASSERT(requests.size() == 1);
+        ASSERT(requests[0].first == 4 && requests[0].second == 4);
+        ASSERT(feed(4, MD_FLAG_RETRANSMIT) == SequenceResult::DELIVERED);
+        ASSERT(seq.next_sequence() == 7);
+        
+        // Hole at 7 never filled: escalate, then skip on timeout
+        feed(8);
+        auto now = FeedSequencer<64>::Clock::now();
+        ASSERT(!seq.poll_timeout(deliver, now + std::chrono::milliseconds(20)));
+        ASSERT(requests.size() == 2);
+        ASSERT(seq.poll_timeout(deliver, now + std::chrono::seconds(1)));
+        ASSERT(out.back() == 8);
+        ASSERT(seq.next_sequence() == 9);
+        
+        // Jump past the window: skip instead of stalling
+        ASSERT(feed(200) == SequenceResult::GAP_SKIPPED);
+        ASSERT(seq.next_sequence() == 201);
+        
+        auto stats = seq.stats();
+        ASSERT(stats.delivered == 8);
+        ASSERT(stats.gaps_detected == 4);
+        ASSERT(stats.packets_reordered == 1);
+        ASSERT(stats.packets_recovered == 1);
+        ASSERT(stats.packets_lost == 1 + 191);
+        ASSERT(stats.duplicates == 1);
+        ASSERT(stats.recovery_requests == 2);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 5: Retransmit channel over loopback
+    {
+        std::cout << "  Retransmit server/client... ";
+        const auto port = static_cast<uint16_t>(40000 + getpid() % 20000);
+        RetransmitServer<1024> server(port);
+        RetransmitClient client("127.0.0.1", port);
+        ASSERT(server.init());
+        ASSERT(client.init());
+        
+        for (std::uint64_t s = 1; s <= 10; ++s) {
+            MarketDataPacket p{};
+            p.sequence = s;
+            server.record(p);
+        }
+        
+        FeedSequencer<64> seq([&](std::uint64_t first, std::uint64_t last) {
+            return client.request(first, last);
+        });
+        std::vector<std::uint64_t> out;
+        auto deliver = [&](const MarketDataPacket& p) { out.push_back(p.sequence); };
+        
+        MarketDataPacket p{};
+        for (std::uint64_t s : {1, 2, 6, 7, 8, 9, 10, 11, 12, 13, 14}) {
+            p.sequence = s;
+            seq.on_packet(p, deliver);
+        }
+        ASSERT(seq.stats().recovery_requests == 1);
+        
+        std::size_t replayed = 0;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (replayed < 3 && std::chrono::steady_clock::now() < deadline) {
+            replayed += server.poll();
+        }
+        ASSERT(replayed == 3);
+        ASSERT(server.requests_served() == 1);
+        
+        std::size_t received = 0;
+        while (received < 3 && std::chrono::steady_clock::now() < deadline) {
+            if (client.try_receive(p)) {
+                ASSERT(p.flags & MD_FLAG_RETRANSMIT);
+                seq.on_packet(p, deliver);
+                ++received;
+            }
+        }
+        ASSERT(received == 3);
+        ASSERT(out.size() == 14);
+        for (std::size_t i = 0; i < out.size(); ++i) ASSERT(out[i] == i + 1);
+        ASSERT(seq.stats().packets_recovered == 3);
+        ASSERT(!seq.gap_open());
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 6: Unix socket server on the reactor, packets split across writes
+    {
+        std::cout << "  IPC socket reactor... ";
+        const std::string path = "/tmp/hft_ipc_test_" + std::to_string(getpid());
+        IPCSocketServer server(path);
+        ASSERT(server.init());
+        
+        std::atomic<int> orders{0};
+        server.start([&](const OrderPacket& order, int client_fd) {
+            OrderResponsePacket response{};
+            response.client_order_id = order.client_order_id;
+            response.fill_quantity = order.quantity;
+            ++orders;
+            server.send_response(client_fd, response);
+        });
+        
+        IPCSocketClient client(path);
+        ASSERT(client.connect());
+        for (std::uint64_t id = 1; id <= 50; ++id) {
+            OrderPacket order{};
+            order.client_order_id = id;
+            order.quantity = static_cast<int64_t>(id);
+            ASSERT(client.send_order(order));
+        }
+        for (std::uint64_t id = 1; id <= 50; ++id) {
+            OrderResponsePacket response{};
+            ASSERT(client.receive_response(response, 5000));
+            ASSERT(response.client_order_id == id);
+        }
+        
+        // A second client whose packet arrives in two pieces
+        int raw = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        ASSERT(::connect(raw, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+        
+        OrderPacket order{};
+        order.client_order_id = 777;
+        const char* bytes = reinterpret_cast<const char*>(&order);
+        ASSERT(send(raw, bytes, 10, 0) == 10);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ASSERT(orders.load() == 50);
+        ASSERT(send(raw, bytes + 10, sizeof(order) - 10, 0) == static_cast<ssize_t>(sizeof(order) - 10));
+        
+        OrderResponsePacket response{};
+        ASSERT(recv(raw, &response, sizeof(response), MSG_WAITALL) == sizeof(response));
+        ASSERT(response.client_order_id == 777);
+        ASSERT(orders.load() == 51);
+        
+        close(raw);
+        client.stop();
+        server.stop();
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 7: Sessions fanned out to two shards, answered out of order
+    {
+        std::cout << "  Shard router ordering... ";
+        Reactor reactor;
+        ASSERT(reactor.init());
+        
+        // Fake engine shards that hold packets until told to answer
+        struct FakeShard {
+            std::string path;
+            IPCSocketServer server;
+            std::vector<std::pair<OrderPacket, int>> pending;
+            explicit FakeShard(std::string p) : path(p), server(p) {}
+            void answer() {
+                for (auto& [order, fd] : pending) {
+                    OrderResponsePacket response{};
+                    response.client_order_id = order.client_order_id;
+                    response.fill_quantity = order.quantity;
+                    server.send_response(fd, response);
+                }
+                pending.clear();
+            }
+        };
+        const std::string base = "/tmp/hft_shard_test_" + std::to_string(getpid());
+        FakeShard btc(base + "_0"), sol(base + "_1");
+        for (FakeShard* shard : {&btc, &sol}) {
+            ASSERT(shard->server.init());
+            ASSERT(shard->server.attach(reactor, [shard](const OrderPacket& order, int fd) {
+                shard->pending.emplace_back(order, fd);
+            }));
+        }
+        
+        std::vector<std::pair<SessionId, OrderResponsePacket>> responses;
+        ShardedOrderRouter router([&](SessionId session, const OrderResponsePacket& response) {
+            responses.emplace_back(session, response);
+        });
+        router.assign(make_symbol("BTC-USD"), router.add_shard(btc.path));
+        router.assign(make_symbol("SOL-USD"), router.add_shard(sol.path));
+        ASSERT(router.connect(reactor));
+        
+        auto order = [](std::uint64_t id, const char* symbol) {
+            OrderPacket packet{};
+            packet.client_order_id = id;
+            packet.quantity = static_cast<int64_t>(id);
+            std::strncpy(packet.symbol, symbol, sizeof(packet.symbol));
+            return packet;
+        };
+        auto pump = [&](std::size_t btc_count, std::size_t sol_count) {
+            for (int i = 0; i < 200 && (btc.pending.size() < btc_count ||
+                                        sol.pending.size() < sol_count); ++i) {
+                reactor.poll(5);
+            }
+        };
+        
+        // Both sessions reuse client id 1; the shards must see distinct ids
+        const SessionId a = router.open_session();
+        const SessionId b = router.open_session();
+        ASSERT(router.submit(a, order(1, "BTC-USD")) == RouteResult::ROUTED);
+        ASSERT(router.submit(a, order(2, "SOL-USD")) == RouteResult::ROUTED);
+        ASSERT(router.submit(a, order(3, "XRP-USD")) == RouteResult::REJECTED);
+        ASSERT(router.submit(a, order(4, "BTC-USD")) == RouteResult::ROUTED);
+        ASSERT(router.submit(b, order(1, "SOL-USD")) == RouteResult::ROUTED);
+        pump(2, 2);
+        ASSERT(btc.pending.size() == 2 && sol.pending.size() == 2);
+        ASSERT(sol.pending[0].first.client_order_id == ShardedOrderRouter::shard_order_id(a, 2));
+        ASSERT(sol.pending[1].first.client_order_id == ShardedOrderRouter::shard_order_id(b, 1));
+        ASSERT(responses.empty());      // The locally rejected order waits its turn
+        
+        // SOL answers first: only session B's response can be released
+        sol.answer();
+        for (int i = 0; i < 200 && responses.size() < 1; ++i) reactor.poll(5);
+        ASSERT(responses.size() == 1 && responses[0].first == b);
+        ASSERT(responses[0].second.client_order_id == 1 && responses[0].second.fill_quantity == 1);
+        ASSERT(router.in_flight(a) == 4);
+        
+        btc.answer();
+        for (int i = 0; i < 200 && responses.size() < 5; ++i) reactor.poll(5);
+        ASSERT(responses.size() == 5);
+        for (std::uint64_t id = 1; id <= 4; ++id) {
+            ASSERT(responses[id].first == a);
+            ASSERT(responses[id].second.client_order_id == id);
+        }
+        ASSERT(responses[3].second.status == ShardedOrderRouter::STATUS_REJECTED);
+        ASSERT(router.in_flight(a) == 0);
+        
+        // A shard that goes away rejects what it still owed
+        ASSERT(router.submit(b, order(7, "SOL-USD")) == RouteResult::ROUTED);
+        pump(0, 1);
+        sol.server.detach();
+        for (int i = 0; i < 200 && responses.size() < 6; ++i) reactor.poll(5);
+        ASSERT(responses.size() == 6 && responses[5].first == b);
+        ASSERT(responses[5].second.client_order_id == 7);
+        ASSERT(responses[5].second.status == ShardedOrderRouter::STATUS_REJECTED);
+        ASSERT(!router.shard_connected(1) && router.shard_connected(0));
+        ASSERT(router.submit(b, order(8, "SOL-USD")) == RouteResult::REJECTED);
+        ASSERT(router.stats().routed == 5 && router.stats().responses == 4);
+        
+        router.close_session(a);
+        ASSERT(router.open_session() == a);     // Idle ids are reused
+        btc.server.detach();
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 8: AF_XDP frame parser picks feed datagrams out of raw frames
+    {
+        std::cout << "  Feed frame parsing... ";
+        
+        MarketDataPacket sent{};
+        sent.sequence = 77;
+        sent.bid_price = 123;
+        std::memcpy(sent.symbol, "BTC-USD", 7);
+        
+        // Ethernet (optionally VLAN-tagged) + IPv4 + UDP to 239.1.2.3:30001
+        auto make_frame = [&](bool vlan, std::size_t payload) {
+            std::vector<std::uint8_t> frame(14 + (vlan ? 4 : 0));
+            frame[12] = vlan ? 0x81 : 0x08;
+            if (vlan) {
+                frame[16] = 0x08;
+            }
+            const std::size_t ip = frame.size();
+            const std::size_t udp_length = 8 + payload;
+            const std::size_t ip_length = 20 + udp_length;
+            frame.resize(ip + ip_length);
+            frame[ip] = 0x45;
+            frame[ip + 2] = static_cast<std::uint8_t>(ip_length >> 8);
+            frame[ip + 3] = static_cast<std::uint8_t>(ip_length);
+            frame[ip + 6] = 0x40;                   // Don't fragment
+            frame[ip + 9] = 17;
+            const std::uint8_t group[4] = {239, 1, 2, 3};
+            std::memcpy(&frame[ip + 16], group, 4);
+            frame[ip + 22] = 30001 >> 8;
+            frame[ip + 23] = 30001 & 0xFF;
+            frame[ip + 24] = static_cast<std::uint8_t>(udp_length >> 8);
+            frame[ip + 25] = static_cast<std::uint8_t>(udp_length);
+            std::memcpy(&frame[ip + 28], &sent, std::min(payload, sizeof(sent)));
+            return frame;
+        };
+        in_addr group{};
+        inet_pton(AF_INET, "239.1.2.3", &group);
+        const std::uint16_t port_be = htons(30001);
+        
+        MarketDataPacket got{};
+        ASSERT(parse_feed_frame(make_frame(false, sizeof(sent)), group.s_addr, port_be, got) == FrameResult::PACKET);
+        ASSERT(got.sequence == 77 && got.bid_price == 123 && std::memcmp(got.symbol, "BTC-USD", 7) == 0);
+        got = {};
+        ASSERT(parse_feed_frame(make_frame(true, sizeof(sent)), group.s_addr, port_be, got) == FrameResult::PACKET);
+        ASSERT(got.sequence == 77);
+        
+        ASSERT(parse_feed_frame(make_frame(false, sizeof(sent)), group.s_addr, htons(30002), got) == FrameResult::OTHER);
+        in_addr other{};
+        inet_pton(AF_INET, "239.1.2.4", &other);
+        ASSERT(parse_feed_frame(make_frame(false, sizeof(sent)), other.s_addr, port_be, got) == FrameResult::OTHER);
+        ASSERT(parse_feed_frame(make_frame(false, 16), group.s_addr, port_be, got) == FrameResult::MALFORMED);
+        auto truncated = make_frame(false, sizeof(sent));
+        truncated.resize(truncated.size() - 1);
+        ASSERT(parse_feed_frame(truncated, group.s_addr, port_be, got) == FrameResult::MALFORMED);
+        auto arp = make_frame(false, sizeof(sent));
+        arp[12] = 0x08;
+        arp[13] = 0x06;
+        ASSERT(parse_feed_frame(arp, group.s_addr, port_be, got) == FrameResult::OTHER);
+        
+        UDPMulticastReceiver receiver("239.1.2.3", 30001);
+        if (receiver.init()) {
+            // Without a redirect program (or the build option) this must fail cleanly
+            XdpConfig config;
+            config.interface = "lo";
+            config.xskmap_path = "/sys/fs/bpf/hft_test_missing_xskmap";
+            ASSERT(!receiver.enable_xdp(config) && !receiver.xdp_enabled());
+            ASSERT(!receiver.xdp_error().empty());
+        }
+        
+        std::cout << "PASSED\n";
+    }
+    
+    // Test 9: Execution report bus - independent cursors, laps, cross-process mapping
+    {
+        std::cout << "  Execution report bus... ";
+        constexpr std::uint64_t RING = ExecReportBusSegment::RING_SIZE;
+        auto report_of = [](std::uint64_t i) {
+            ExecutionReport report{};
+            report.order_id = i;
+            report.execution_quantity = static_cast<Quantity>(i % 1000);
+            report.exec_type = ExecutionType::TRADE;
+            return report;
+        };
+        
+        ExecReportReader orphan(shm_name + "_exec");
+        ASSERT(!orphan.connect());                      // No producer yet
+        
+        ExecReportBus bus(shm_name + "_exec");
+        ASSERT(bus.init());
+        ExecReportReader fast(bus);
+        ExecReportReader slow(bus);
+        ExecReportReader mapped(shm_name + "_exec");    // As another process would
+        ASSERT(mapped.connect());
+        
+        ExecutionReport got{};
+        ASSERT(!fast.try_read(got));
+        for (std::uint64_t i = 0; i < 10; ++i) bus.publish(report_of(i));
+        
+        // Every reader sees every report, in order, at its own pace
+        std::uint64_t expect = 0;
+        ASSERT(fast.poll([&](const ExecutionReport& r) { ASSERT(r.order_id == expect++); }) == 10);
+        ASSERT(mapped.poll([](const ExecutionReport&) {}, 4) == 4);
+        ASSERT(mapped.try_read(got) && got.order_id == 4);
+        ASSERT(slow.lag() == 10 && fast.lag() == 0 && mapped.lag() == 5);
+        
+        // A late joiner starts at the head, or at the oldest report kept
+        ExecReportReader latest(bus);
+        ExecReportReader oldest(bus, BusStart::OLDEST);
+        ASSERT(latest.cursor() == 10 && oldest.cursor() == 0);
+        
+        // Lap: the producer overwrites without waiting; slow skips to the oldest kept report
+        for (std::uint64_t i = 10; i < RING + 110; ++i) bus.publish(report_of(i));
+        ASSERT(slow.try_read(got));
+        ASSERT(got.order_id == 110 && slow.lost() == 110 && slow.laps() == 1);
+        expect = 111;
+        bool ordered = true;
+        slow.poll([&](const ExecutionReport& r) { ordered &= r.order_id == expect++; }, RING);
+        ASSERT(ordered && expect == RING + 110 && slow.lag() == 0);
+        ASSERT(slow.read() + slow.lost() == bus.published());
+        ASSERT(fast.poll([](const ExecutionReport&) {}, RING) == RING && fast.lost() == 100);
+        
+        // Concurrent producer: a reader never sees a torn or out-of-order report
+        std::atomic<bool> done{false};
+        ExecReportReader live(bus);
+        const std::uint64_t first = bus.published();
+        constexpr std::uint64_t TOTAL = 500'000;
+        std::uint64_t last = first - 1;
+        bool consistent = true;
+        std::thread reader([&]() {
+            auto check = [&](const ExecutionReport& r) {
+                consistent &= r.order_id > last;
+                consistent &= r.execution_quantity == static_cast<Quantity>(r.order_id % 1000);
+                last = r.order_id;
+            };
+            while (!done.load(std::memory_order_acquire)) live.poll(check);
+            live.poll(check, RING);
+        });
+        for (std::uint64_t i = 0; i < TOTAL; ++i) bus.publish(report_of(first + i));
+        done.store(true, std::memory_order_release);
+        reader.join();
+        ASSERT(consistent && last == first + TOTAL - 1);
+        ASSERT(live.read() + live.lost() == TOTAL);
+        
+        std::cout << "PASSED\n";
+    }
+    
+    std::cout << "  All transport tests passed!\n";
+}
@@ -0,0 +1,178 @@
+/**
+ * @file test_tsc_clock.cpp
+ * @brief TSC wall clock unit tests
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "core/tsc_clock.hpp"
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+namespace {
+
+// A 2 GHz counter and a system clock that move only when the test says so
+struct FakeTsc {
+    static inline std::atomic<std::uint64_t> tsc{0};
+    static inline std::atomic<Timestamp> system{0};
+    static inline bool invariant_counter = true;
+    static inline bool consistent_cores = true;
+
+    static std::uint64_t read() noexcept { return tsc.load(); }
+    static std::uint64_t read_ordered() noexcept { return tsc.load(); }
+    static Timestamp system_now() noexcept { return system.load(); }
+    static double ticks_per_second() { return 2e9; }
+    static bool invariant() noexcept { return invariant_counter; }
+    static TscCrossCoreCheck cross_core() {
+        return {consistent_cores, 2, consistent_cores ? 0 : 40};
+    }
+
+    static void reset(std::uint64_t ticks, Timestamp ns) {
+        tsc = ticks;
+        system = ns;
+        invariant_counter = true;
+        consistent_cores = true;
+    }
+    static void advance(std::uint64_t ticks, Duration ns) {
+        tsc += ticks;
+        system += ns;
+    }
+};
+
+using FakeClock = BasicTscClock<FakeTsc>;
+
+constexpr Timestamp EPOCH_2023 = 1'700'000'000'000'000'000;
+
+} // namespace
+
+void run_tsc_clock_tests() {
+    std::cout << "\n=== TSC Clock Tests ===\n";
+
+    // Test 1: Ticks convert to epoch nanoseconds from the calibration anchor
+    {
+        std::cout << "  Tick conversion... ";
+        FakeTsc::reset(1'000'000, EPOCH_2023);
+        FakeClock clock;
+        ASSERT(clock.tsc_usable() && !clock.refresher_running());
+        ASSERT(clock.params().mult == std::uint64_t{1} << 31);     // 0.5 ns per tick
+        ASSERT(clock.now() == EPOCH_2023);
+
+        FakeTsc::tsc += 2'000'000'000;
+        ASSERT(clock.now() == EPOCH_2023 + 1'000'000'000);
+        FakeTsc::tsc = 1'000'000 - 200;                             // Before the anchor
+        ASSERT(clock.now() == EPOCH_2023 - 100);
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 2: Small offsets are slewed out, large ones stepped
+    {
+        std::cout << "  Slew and step... ";
+        using namespace std::chrono_literals;
+        FakeTsc::reset(1'000'000, EPOCH_2023);
+        FakeClock clock;
+
+        // In step with the system clock: nothing to correct
+        FakeTsc::advance(2'000'000'000, 1'000'000'000);
+        clock.refresh(100ms);
+        ASSERT(clock.steps() == 0 && clock.now() == FakeTsc::system_now());
+
+        // 20 us behind: no jump now, caught up by the end of the interval
+        FakeTsc::advance(2'000'000'000, 1'000'020'000);
+        const Timestamp before = clock.now();
+        clock.refresh(100ms);
+        ASSERT(clock.steps() == 0 && clock.now() == before);
+        FakeTsc::advance(200'000'000, 100'001'000);
+        ASSERT(std::abs(clock.now() - FakeTsc::system_now()) < 2'000);
+
+        // 900 us ahead: slowed by at most MAX_SLEW_RATE against the rate
+        // measured since start-up, never run backwards
+        FakeTsc::system -= 900'000;
+        const double rate = static_cast<double>(FakeTsc::system_now() - EPOCH_2023) /
+                            static_cast<double>(FakeTsc::read() - 1'000'000);
+        const Timestamp ahead = clock.now();
+        clock.refresh(100ms);
+        ASSERT(clock.steps() == 0 && clock.now() == ahead);
+        FakeTsc::advance(200'000'000, 100'000'000);
+        const double elapsed = static_cast<double>(clock.now() - ahead);
+        ASSERT(elapsed > 0 && elapsed >= 2e8 * rate * (1.0 - FakeClock::MAX_SLEW_RATE) - 1.0);
+        ASSERT(elapsed < 2e8 * rate);
+
+        // The system clock was set: step to it, in either direction
+        FakeTsc::system += 5'000'000;
+        clock.refresh(100ms);
+        ASSERT(clock.steps() == 1 && clock.now() == FakeTsc::system_now());
+        FakeTsc::system -= 5'000'000;
+        clock.refresh(100ms);
+        ASSERT(clock.steps() == 2 && clock.now() == FakeTsc::system_now());
+
+        // No interval to slew over
+        FakeTsc::system += 1'000;
+        clock.refresh(0ns);
+        ASSERT(clock.steps() == 3 && clock.now() == FakeTsc::system_now());
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 3: Without an invariant, consistent TSC the clock is the system clock
+    {
+        std::cout << "  Non-invariant fallback... ";
+        FakeTsc::reset(1'000'000, EPOCH_2023);
+        FakeTsc::invariant_counter = false;
+        FakeClock variable(FakeClock::Refresh::BACKGROUND);
+        ASSERT(!variable.tsc_usable() && !variable.invariant_tsc());
+        ASSERT(variable.cross_core_check().cores_checked == 0);
+        ASSERT(!variable.refresher_running());
+        FakeTsc::advance(2'000'000'000, 7);
+        ASSERT(variable.now() == EPOCH_2023 + 7);
+        variable.refresh();
+        ASSERT(variable.steps() == 0 && variable.now() == EPOCH_2023 + 7);
+
+        // Invariant, but a core read behind another
+        FakeTsc::invariant_counter = true;
+        FakeTsc::consistent_cores = false;
+        FakeClock skewed;
+        ASSERT(skewed.invariant_tsc() && !skewed.tsc_usable());
+        ASSERT(skewed.cross_core_check().max_backwards_ticks == 40);
+        ASSERT(skewed.now() == FakeTsc::system_now());
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 4: The background refresher re-anchors and stops promptly
+    {
+        std::cout << "  Background refresher... ";
+        using namespace std::chrono_literals;
+        FakeTsc::reset(1'000'000, EPOCH_2023);
+        FakeClock clock(FakeClock::Refresh::BACKGROUND);
+        ASSERT(clock.refresher_running());
+
+        clock.start_refresher(1ms);             // Restarts with the new interval
+        FakeTsc::system += 5'000'000;
+        for (int i = 0; i < 1000 && clock.steps() == 0; ++i) {
+            std::this_thread::sleep_for(1ms);
+        }
+        ASSERT(clock.steps() >= 1 && clock.now() == FakeTsc::system_now());
+
+        // A sleeping refresher is woken to stop, not waited out
+        clock.start_refresher(std::chrono::hours(1));
+        const auto start = std::chrono::steady_clock::now();
+        clock.stop_refresher();
+        ASSERT(!clock.refresher_running());
+        ASSERT(std::chrono::steady_clock::now() - start < 1s);
+
+        // The process clock refreshes itself wherever the TSC is used
+        ASSERT(TscClock::instance().refresher_running() == TscClock::instance().tsc_usable());
+
+        std::cout << "PASSED\n";
+    }
+
+    std::cout << "  All TSC clock tests passed!\n";
+}
@@ -0,0 +1,226 @@
+/**
+ * @file test_websocket.cpp
+ * @brief WebSocket framing, handler and JSON feed decoder unit tests
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "protocol/websocket_handler.hpp"
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace hft;
+
+#define ASSERT(cond) \
+    if (!(cond)) throw std::runtime_error("Assertion failed: " #cond)
+
+void run_websocket_tests() {
+    std::cout << "\n=== WebSocket Tests ===\n";
+
+    // Test 1: Vectorised masking matches the byte-wise definition
+    {
+        std::cout << "  Mask XOR... ";
+
+        const std::uint8_t mask[4] = {0x37, 0xFA, 0x21, 0x3D};
+        for (std::size_t len : {0u, 1u, 3u, 7u, 15u, 16u, 31u, 33u, 100u, 1027u}) {
+            std::vector<std::uint8_t> data(len);
+            for (std::size_t i = 0; i < len; ++i) {
+                data[i] = static_cast<std::uint8_t>(i * 7 + 1);
+            }
+            auto masked = data;
+            WebSocketParser::apply_mask(masked.data(), masked.size(), mask);
+            for (std::size_t i = 0; i < len; ++i) {
+                ASSERT(masked[i] == (data[i] ^ mask[i % 4]));
+            }
+            WebSocketParser::apply_mask(masked.data(), masked.size(), mask);
+            ASSERT(masked == data);
+        }
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 2: In-place parse of masked frames across length encodings
+    {
+        std::cout << "  In-place parse... ";
+
+        for (std::size_t len : {5u, 200u, 70000u}) {
+            std::string payload(len, 'x');
+            for (std::size_t i = 0; i < len; ++i) {
+                payload[i] = static_cast<char>('a' + i % 26);
+            }
+
+            auto wire = WebSocketParser::encode(WebSocketOpcode::TEXT, payload, true);
+            auto copy = wire;
+
+            WebSocketFrameView view;
+            std::size_t consumed = WebSocketParser::parse_in_place(wire.data(), wire.size(), view);
+            ASSERT(consumed == wire.size());
+            ASSERT(view.opcode == WebSocketOpcode::TEXT);
+            ASSERT(view.fin && view.masked);
+            ASSERT(view.payload == payload);
+            ASSERT(view.payload.data() >= reinterpret_cast<const char*>(wire.data()));
+
+            // Copying parser agrees; truncated input is incomplete
+            WebSocketParser parser;
+            WebSocketFrame frame;
+            std::string_view copy_view(reinterpret_cast<const char*>(copy.data()), copy.size());
+            ASSERT(parser.parse(copy_view, frame) == copy.size());
+            ASSERT(frame.payload_string() == payload);
+            ASSERT(WebSocketParser::parse_in_place(copy.data(), copy.size() - 1, view) == 0);
+        }
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 3: Handler delivers views and gather-writes replies
+    {
+        std::cout << "  Handler loopback... ";
+
+        #ifdef __linux__
+        int fds[2];
+        ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+        WebSocketHandler server;
+        std::vector<std::string> received;
+        server.on_frame([&](const WebSocketFrameView& frame) {
+            received.emplace_back(frame.payload);
+        });
+
+        ASSERT(server.accept(fds[0], "GET / HTTP/1.1\r\nSec-WebSocket-Key: abc\r\n\r\n"));
+        char buf[4096];
+        ssize_t n = recv(fds[1], buf, sizeof(buf), 0);
+        ASSERT(n > 0 && std::string_view(buf, n).find("101") != std::string_view::npos);
+
+        // Two masked client frames in one write, the second split across writes
+        auto f1 = WebSocketParser::encode(WebSocketOpcode::TEXT, "hello", true);
+        auto f2 = WebSocketParser::encode(WebSocketOpcode::BINARY, std::string(300, 'z'), true);
+        std::vector<std::uint8_t> wire(f1);
+        wire.insert(wire.end(), f2.begin(), f2.begin() + 10);
+        ASSERT(send(fds[1], wire.data(), wire.size(), 0) == static_cast<ssize_t>(wire.size()));
+        server.poll();
+        ASSERT(received.size() == 1 && received[0] == "hello");
+
+        ASSERT(send(fds[1], f2.data() + 10, f2.size() - 10, 0) ==
+               static_cast<ssize_t>(f2.size() - 10));
+        server.poll();
+        ASSERT(received.size() == 2 && received[1] == std::string(300, 'z'));
+
+        // Server replies are unmasked
+        ASSERT(server.send_text("world"));
+        n = recv(fds[1], buf, sizeof(buf), 0);
+        ASSERT(n == 7);
+        WebSocketParser parser;
+        WebSocketFrame frame;
+        ASSERT(parser.parse(std::string_view(buf, n), frame) == 7);
+        ASSERT(!frame.masked && frame.payload_string() == "world");
+
+        server.close();
+        ::close(fds[1]);
+        std::cout << "PASSED\n";
+        #else
+        std::cout << "SKIPPED\n";
+        #endif
+    }
+
+    // Test 4: Decimal strings straight to fixed point
+    {
+        std::cout << "  Fixed-point decimals... ";
+
+        ASSERT(parse_price("50000.5") == 5000050000000LL);
+        ASSERT(parse_price("-0.00000001") == -1);
+        ASSERT(parse_price("0.123456789") == 12345678);     // Truncated like to_fixed_price
+        ASSERT(parse_price("1.5e3") == 150000000000LL);
+        ASSERT(parse_price("42") == 4200000000LL);
+        ASSERT(parse_quantity("7.9") == 7);
+        ASSERT(!parse_price(""));
+        ASSERT(!parse_price("1.2.3"));
+        ASSERT(!parse_price("abc"));
+        ASSERT(!parse_price("1e30"));
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 5: Trade and book messages in one pass
+    {
+        std::cout << "  JSON feed decoder... ";
+
+        JsonFeedDecoder decoder;
+        ASSERT(decoder.decode(R"({"type":"trade","symbol":"BTC-USD","price":"50000.25",)"
+                              R"("size":3,"side":"buy","meta":{"ids":[1,2,"]"]}})") ==
+               FeedMessageType::TRADE);
+        const auto& trade = decoder.trade();
+        ASSERT(symbol_view(trade.symbol) == "BTC-USD");
+        ASSERT(trade.price == to_fixed_price(50000.25));
+        ASSERT(trade.quantity == 3);
+        ASSERT(trade.side == Side::BUY);
+
+        ASSERT(decoder.decode(R"({"symbol":"BTC-USD","bids":[["49999.5","2"],[49999,1,7]],)"
+                              R"( "asks":[["50001","4"]]})") == FeedMessageType::BOOK);
+        const auto& book = decoder.book();
+        ASSERT(book.symbol_id == trade.symbol_id);      // Interned once
+        ASSERT(book.bid_count == 2 && book.ask_count == 1);
+        ASSERT(book.bids[0].price == to_fixed_price(49999.5) && book.bids[0].quantity == 2);
+        ASSERT(book.bids[1].price == to_fixed_price(49999.0) && book.bids[1].quantity == 1);
+        ASSERT(book.asks[0].price == to_fixed_price(50001.0) && book.asks[0].quantity == 4);
+
+        ASSERT(decoder.decode(R"({"symbol":"ETH-USD","bids":[]})") == FeedMessageType::BOOK);
+        ASSERT(decoder.book().bid_count == 0);
+        ASSERT(decoder.symbols().size() == 2);
+
+        ASSERT(decoder.decode(R"({"type":"subscribed","symbol":"BTC-USD"})") == FeedMessageType::OTHER);
+        ASSERT(decoder.decode(R"({"price":1})") == FeedMessageType::INVALID);
+        ASSERT(decoder.decode(R"({"symbol":"BTC-USD","bids":[["1"]]})") == FeedMessageType::INVALID);
+        ASSERT(decoder.decode(R"({"symbol":"BTC-USD")") == FeedMessageType::INVALID);
+
+        ws_json::BookUpdate update;
+        ASSERT(ws_json::parse_book_update(R"({"symbol":"SOL-USD","asks":[[10.5,3]]})", update));
+        ASSERT(symbol_view(update.symbol) == "SOL-USD" && update.ask_count == 1);
+
+        std::cout << "PASSED\n";
+    }
+
+    // Test 6: Connection driven by a shared reactor
+    {
+        std::cout << "  Reactor attach... ";
+
+        #ifdef __linux__
+        int fds[2];
+        ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+        Reactor reactor;
+        ASSERT(reactor.init());
+        WebSocketHandler server;
+        std::vector<std::string> received;
+        server.on_frame([&](const WebSocketFrameView& frame) {
+            received.emplace_back(frame.payload);
+        });
+        ASSERT(!server.attach(reactor));    // Not connected yet
+        ASSERT(server.accept(fds[0], "GET / HTTP/1.1\r\nSec-WebSocket-Key: abc\r\n\r\n"));
+        ASSERT(server.attach(reactor));
+        char buf[256];
+        ASSERT(recv(fds[1], buf, sizeof(buf), 0) > 0);
+
+        for (const char* text : {"one", "two", "three"}) {
+            auto wire = WebSocketParser::encode(WebSocketOpcode::TEXT, text, true);
+            ASSERT(send(fds[1], wire.data(), wire.size(), 0) == static_cast<ssize_t>(wire.size()));
+        }
+        for (int i = 0; i < 100 && received.size() < 3; ++i) {
+            reactor.poll(5);
+        }
+        ASSERT(received.size() == 3 && received[2] == "three");
+
+        server.close();
+        ASSERT(reactor.size() == 0);
+        ::close(fds[1]);
+        std::cout << "PASSED\n";
+        #else
+        std::cout << "SKIPPED\n";
+        #endif
+    }
+
+    std::cout << "  All WebSocket tests passed!\n";
+}